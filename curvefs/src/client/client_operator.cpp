@@ -66,7 +66,8 @@ RenameOperator::RenameOperator(uint32_t fsId,
       mdsClient_(mdsClient),
       enableParallel_(enableParallel),
       uuid_(),
-      sequence_(0) {}
+      sequence_(0),
+      renamed_(false) {}
 
 std::string RenameOperator::DebugString() {
     std::ostringstream os;
@@ -84,7 +85,8 @@ std::string RenameOperator::DebugString() {
        << ", prepare new dentry = [" << newDentry_.ShortDebugString() << "]"
        << ", enableParallel = " << enableParallel_
        << ", uuid = " << uuid_
-       << ", sequence = " << sequence_ << ")";
+       << ", sequence = " << sequence_
+       << ", renamedInCopyset = " << renamed_ << ")";
     return os.str();
 }
 
@@ -208,6 +210,36 @@ CURVEFS_ERROR RenameOperator::PrepareRenameTx(
     return ToFSError(rc);
 }
 
+// If the partitions of source and destination are in the same copyset,
+// the rename can be done by one raft op of metaserver without transaction.
+// NOTE: it's skipped if rename with parallel, because the txids should be
+// refreshed under the lock of mds in that case.
+CURVEFS_ERROR RenameOperator::RenameInCopyset() {
+    if (enableParallel_ ||
+        !metaClient_->IsSameCopyset(fsId_, parentId_, newParentId_)) {
+        return CURVEFS_ERROR::OK;
+    }
+
+    dentry_ = Dentry(srcDentry_);
+    newDentry_ = Dentry(srcDentry_);
+    newDentry_.set_parentinodeid(newParentId_);
+    newDentry_.set_name(newname_);
+
+    auto rc = metaClient_->RenameDentry(dentry_, newDentry_);
+    if (rc == MetaStatusCode::HANDLE_PENDING_TX_FAILED) {
+        // the dentrys are touched by pending transaction, which will be
+        // handled by the next transaction
+        VLOG(3) << "Rename in copyset conflicts with pending tx, "
+                << "fallback to transaction: " << DebugString();
+        return CURVEFS_ERROR::OK;
+    } else if (rc != MetaStatusCode::OK) {
+        LOG_ERROR("RenameDentry", rc);
+        return ToFSError(rc);
+    }
+    renamed_ = true;
+    return CURVEFS_ERROR::OK;
+}
+
 CURVEFS_ERROR RenameOperator::PrepareTx() {
     dentry_ = Dentry(srcDentry_);
     dentry_.set_txid(srcTxId_ + 1);
@@ -419,6 +451,10 @@ CURVEFS_ERROR RenameOperator::UpdateInodeCtime() {
 }
 
 void RenameOperator::UpdateCache() {
+    // txids are unchanged without transaction
+    if (renamed_) {
+        return;
+    }
     SetTxId(srcPartitionId_, srcTxId_ + 1);
     SetTxId(dstPartitionId_, dstTxId_ + 1);
 }
@@ -54,6 +54,7 @@ class RenameOperator {
     CURVEFS_ERROR Precheck();
     CURVEFS_ERROR RecordOldInodeInfo();
     CURVEFS_ERROR LinkDestParentInode();
+    CURVEFS_ERROR RenameInCopyset();
     CURVEFS_ERROR PrepareTx();
     CURVEFS_ERROR CommitTx();
     CURVEFS_ERROR UnlinkSrcParentInode();
@@ -69,6 +70,10 @@ class RenameOperator {
         *oldInodeType = oldInodeType_;
     }
 
+    // whether the rename is done by RenameInCopyset(),
+    // the transaction is unnecessary if so
+    bool IsRenamedInCopyset() const { return renamed_; }
+
     std::string DebugString();
 
  private:
@@ -121,6 +126,7 @@ class RenameOperator {
     bool enableParallel_;
     std::string uuid_;
     uint64_t sequence_;
+    bool renamed_;
 };
 
 }  // namespace client
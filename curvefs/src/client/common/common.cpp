@@ -45,6 +45,9 @@ std::ostream &operator<<(std::ostream &os, MetaServerOpType optype) {
     case MetaServerOpType::PrepareRenameTx:
         os << "PrepareRenameTx";
         break;
+    case MetaServerOpType::RenameDentry:
+        os << "RenameDentry";
+        break;
     case MetaServerOpType::GetInode:
         os << "GetInode";
         break;
@@ -72,6 +75,9 @@ std::ostream &operator<<(std::ostream &os, MetaServerOpType optype) {
     case MetaServerOpType::UpdateVolumeExtent:
         os << "UpdateVolumeExtent";
         break;
+    case MetaServerOpType::BatchUpdateInode:
+        os << "BatchUpdateInode";
+        break;
     default:
         os << "Unknow opType";
     }
@@ -50,6 +50,7 @@ enum class MetaServerOpType {
     CreateDentry,
     DeleteDentry,
     PrepareRenameTx,
+    RenameDentry,
     GetInode,
     BatchGetInodeAttr,
     BatchGetXAttr,
@@ -61,6 +62,7 @@ enum class MetaServerOpType {
     UpdateVolumeExtent,
     CreateManageInode,
     UpdateDeallocatableBlockGroup,
+    BatchUpdateInode,
 };
 
 std::ostream &operator<<(std::ostream &os, MetaServerOpType optype);
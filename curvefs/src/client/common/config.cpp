@@ -55,6 +55,14 @@ DEFINE_bool(useFakeS3, false,
 DEFINE_bool(supportKVcache, false, "use kvcache to speed up sharing");
 DEFINE_bool(access_logging, true, "enable access log");
 DEFINE_validator(access_logging, &pass_bool);
+static bool pass_uint32(const char*, uint32_t) { return true; }
+DEFINE_uint32(access_log_sample_rate, 1,
+              "log one of every N operations of each thread, "
+              "0 or 1 means logging all");
+DEFINE_validator(access_log_sample_rate, &pass_uint32);
+DEFINE_string(access_log_ops, "",
+              "operations to log, separated by comma (e.g. lookup,getattr), "
+              "empty means logging all");
 
 /**
  * use curl -L fuseclient:port/flags/fuseClientAvgWriteBytes?setvalue=true
@@ -250,6 +258,11 @@ void InitS3Option(Configuration *conf, S3Option *s3Opt) {
         &s3Opt->s3ClientAdaptorOpt.maxReadRetryIntervalMs);
     conf->GetValueFatalIfFail("s3.readRetryIntervalMs",
                               &s3Opt->s3ClientAdaptorOpt.readRetryIntervalMs);
+    LOG_IF(WARNING, !conf->GetStringValue(
+                        "s3.cacheEvictPolicy",
+                        &s3Opt->s3ClientAdaptorOpt.cacheEvictPolicy))
+        << "Not found `s3.cacheEvictPolicy` in conf, use default value `"
+        << s3Opt->s3ClientAdaptorOpt.cacheEvictPolicy << '`';
     ::curve::common::InitS3AdaptorOptionExceptS3InfoOption(conf,
                                                            &s3Opt->s3AdaptrOpt);
 
@@ -266,6 +279,10 @@ void InitVolumeOption(Configuration *conf, VolumeOption *volumeOpt) {
                               &volumeOpt->threshold);
     conf->GetValueFatalIfFail("volume.space.releaseInterSec",
                               &volumeOpt->releaseInterSec);
+    LOG_IF(WARNING, !conf->GetDoubleValue("volume.space.prefetchWatermark",
+                                          &volumeOpt->prefetchWatermark))
+        << "Not found `volume.space.prefetchWatermark` in conf, "
+        << "use default value `" << volumeOpt->prefetchWatermark << '`';
 
     conf->GetValueFatalIfFail(
         "volume.blockGroup.allocateOnce",
@@ -312,6 +329,11 @@ void InitKVClientManagerOpt(Configuration *conf,
                               &config->setThreadPooln);
     conf->GetValueFatalIfFail("fuseClient.getThreadPool",
                               &config->getThreadPooln);
+    LOG_IF(WARNING, !conf->GetUInt64Value("fuseClient.kvCacheSubBlockSize",
+                                          &config->subBlockSize))
+        << "Not found `fuseClient.kvCacheSubBlockSize` in conf, "
+           "use default value `"
+        << config->subBlockSize << '`';
 }
 
 void GetGids(
@@ -354,6 +376,15 @@ void InitFileSystemOption(Configuration* c, FileSystemOption* option) {
     c->GetValueFatalIfFail("fs.disableXAttr", &option->disableXAttr);
     c->GetValueFatalIfFail("fs.maxNameLength", &option->maxNameLength);
     c->GetValueFatalIfFail("fs.accessLogging", &FLAGS_access_logging);
+    LOG_IF(WARNING, !c->GetUInt32Value("fs.accessLogging.sampleRate",
+                                       &FLAGS_access_log_sample_rate))
+        << "Not found `fs.accessLogging.sampleRate` in conf, "
+           "use default value `"
+        << FLAGS_access_log_sample_rate << '`';
+    LOG_IF(WARNING, !c->GetStringValue("fs.accessLogging.ops",
+                                       &FLAGS_access_log_ops))
+        << "Not found `fs.accessLogging.ops` in conf, use default value `"
+        << FLAGS_access_log_ops << '`';
     {  // kernel cache option
         auto o = &option->kernelCacheOption;
         c->GetValueFatalIfFail("fs.kernelCache.attrTimeoutSec",
@@ -377,6 +408,12 @@ void InitFileSystemOption(Configuration* c, FileSystemOption* option) {
     {  // dir cache option
         auto o = &option->dirCacheOption;
         c->GetValueFatalIfFail("fs.dirCache.lruSize", &o->lruSize);
+        o->timeoutSec = 0;
+        LOG_IF(WARNING, !c->GetUInt32Value("fs.dirCache.timeoutSec",
+                                           &o->timeoutSec))
+            << "Not found `fs.dirCache.timeoutSec` in conf, "
+               "use default value `"
+            << o->timeoutSec << '`';
     }
     {  // open file option
         auto o = &option->openFilesOption;
@@ -394,6 +431,24 @@ void InitFileSystemOption(Configuration* c, FileSystemOption* option) {
         auto o = &option->deferSyncOption;
         c->GetValueFatalIfFail("fs.deferSync.delay", &o->delay);
         c->GetValueFatalIfFail("fs.deferSync.deferDirMtime", &o->deferDirMtime);
+        LOG_IF(WARNING, !c->GetBoolValue("fs.deferSync.batchFlush",
+                                         &o->batchFlush))
+            << "Not found `fs.deferSync.batchFlush` in conf, "
+            << "use default value `" << std::boolalpha << o->batchFlush << '`';
+        LOG_IF(WARNING, !c->GetUInt32Value("fs.deferSync.batchFlushSize",
+                                           &o->batchFlushSize))
+            << "Not found `fs.deferSync.batchFlushSize` in conf, "
+            << "use default value `" << o->batchFlushSize << '`';
+    }
+    {  // meta lease option
+        auto o = &option->metaLeaseOption;
+        LOG_IF(WARNING, !c->GetBoolValue("fs.metaLease.enable", &o->enable))
+            << "Not found `fs.metaLease.enable` in conf, use default value `"
+            << std::boolalpha << o->enable << '`';
+        LOG_IF(WARNING, !c->GetUInt64Value("fs.metaLease.lruSize",
+                                           &o->lruSize))
+            << "Not found `fs.metaLease.lruSize` in conf, use default value `"
+            << o->lruSize << '`';
     }
 }
 
@@ -428,10 +483,34 @@ void InitFuseClientOption(Configuration *conf, FuseClientOption *clientOption) {
                               &clientOption->dummyServerStartPort);
     conf->GetValueFatalIfFail("fuseClient.enableMultiMountPointRename",
                               &clientOption->enableMultiMountPointRename);
+    LOG_IF(WARNING, !conf->GetBoolValue(
+                        "fuseClient.enableRenameInCopyset",
+                        &clientOption->enableRenameInCopyset))
+        << "Not found `fuseClient.enableRenameInCopyset` in conf, "
+           "use default value `"
+        << clientOption->enableRenameInCopyset << '`';
     conf->GetValueFatalIfFail("fuseClient.downloadMaxRetryTimes",
                               &clientOption->downloadMaxRetryTimes);
     conf->GetValueFatalIfFail("fuseClient.warmupThreadsNum",
                               &clientOption->warmupThreadsNum);
+    LOG_IF(WARNING, !conf->GetUInt32Value(
+                        "fuseClient.warmupChunkInfoThreadsNum",
+                        &clientOption->warmupChunkInfoThreadsNum))
+        << "Not found `fuseClient.warmupChunkInfoThreadsNum` in conf, "
+           "use default value `"
+        << clientOption->warmupChunkInfoThreadsNum << '`';
+    LOG_IF(WARNING, !conf->GetUInt32Value(
+                        "fuseClient.warmupMaxInflightObjects",
+                        &clientOption->warmupMaxInflightObjects))
+        << "Not found `fuseClient.warmupMaxInflightObjects` in conf, "
+           "use default value `"
+        << clientOption->warmupMaxInflightObjects << '`';
+    LOG_IF(WARNING, !conf->GetUInt64Value(
+                        "fuseClient.warmupMaxBytesPerSec",
+                        &clientOption->warmupMaxBytesPerSec))
+        << "Not found `fuseClient.warmupMaxBytesPerSec` in conf, "
+           "use default value `"
+        << clientOption->warmupMaxBytesPerSec << '`';
     LOG_IF(WARNING, conf->GetBoolValue("fuseClient.enableSplice",
                                        &clientOption->enableFuseSplice))
         << "Not found `fuseClient.enableSplice` in conf, use default value `"
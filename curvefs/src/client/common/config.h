@@ -77,6 +77,9 @@ struct LeaseOpt {
 struct KVClientManagerOpt {
     int setThreadPooln = 4;
     int getThreadPooln = 4;
+    // if not 0, values are stored in kv cache by sub-blocks of this size,
+    // so ranged reads only fetch the sub-blocks they need
+    uint64_t subBlockSize = 0;
 };
 
 struct DiskCacheOption {
@@ -139,6 +142,8 @@ struct S3ClientAdaptorOption {
     uint32_t maxReadRetryIntervalMs;
     uint32_t readRetryIntervalMs;
     uint32_t objectPrefix;
+    // the evict policy of read cache in memory and disk: lru or arc
+    std::string cacheEvictPolicy = "lru";
     DiskCacheOption diskCacheOpt;
 };
 
@@ -170,6 +175,7 @@ struct VolumeOption {
 
     double threshold{1.0};
     uint64_t releaseInterSec{300};
+    double prefetchWatermark{0};
 };
 
 struct ExtentManagerOption {
@@ -234,6 +240,16 @@ struct RPCOption {
 struct DeferSyncOption {
     uint32_t delay;
     bool deferDirMtime;
+    // flush s3 inodes of the same partition in one rpc
+    bool batchFlush = true;
+    // ship pending inodes once data flush has uploaded chunks of this many
+    // inodes, rather than waiting for the end of window, 0 means never
+    uint32_t batchFlushSize = 128;
+};
+
+struct MetaLeaseOption {
+    bool enable = false;
+    uint64_t lruSize = 10000;
 };
 
 struct FileSystemOption {
@@ -248,6 +264,7 @@ struct FileSystemOption {
     AttrWatcherOption attrWatcherOption;
     RPCOption rpcOption;
     DeferSyncOption deferSyncOption;
+    MetaLeaseOption metaLeaseOption;
 };
 // }
 
@@ -270,9 +287,13 @@ struct FuseClientOption {
     uint32_t listDentryThreads;
     uint32_t dummyServerStartPort;
     bool enableMultiMountPointRename = false;
+    bool enableRenameInCopyset = false;
     bool enableFuseSplice = false;
     uint32_t downloadMaxRetryTimes;
     uint32_t warmupThreadsNum = 10;
+    uint32_t warmupChunkInfoThreadsNum = 10;
+    uint32_t warmupMaxInflightObjects = 256;
+    uint64_t warmupMaxBytesPerSec = 0;
 };
 
 void InitFuseClientOption(Configuration *conf, FuseClientOption *clientOption);
@@ -68,12 +68,14 @@ using ::curvefs::client::filesystem::EntryOut;
 using ::curvefs::client::filesystem::FileOut;
 using ::curvefs::client::filesystem::IsListWarmupXAttr;
 using ::curvefs::client::filesystem::IsWarmupXAttr;
-using ::curvefs::client::filesystem::StrAttr;
-using ::curvefs::client::filesystem::StrEntry;
-using ::curvefs::client::filesystem::StrMode;
+using ::curvefs::client::filesystem::ReadBuffer;
+using ::curvefs::client::filesystem::LogAttr;
+using ::curvefs::client::filesystem::LogEntry;
+using ::curvefs::client::filesystem::LogMode;
 using ::curvefs::client::logger::AccessLogGuard;
+using ::curvefs::client::logger::AccessLogRecord;
 using ::curvefs::client::logger::InitAccessLog;
-using ::curvefs::client::logger::StrFormat;
+using ::curvefs::client::logger::ShutdownAccessLog;
 using ::curvefs::client::metric::ClientOpMetric;
 using ::curvefs::client::metric::InflightGuard;
 using ::curvefs::client::rpcclient::MDSBaseClient;
@@ -232,6 +234,7 @@ void UnInitFuseClient() {
     delete g_ClientInstance;
     delete g_fuseClientOption;
     delete g_clientOpMetric;
+    ShutdownAccessLog();
 }
 
 int AddWarmupTask(curvefs::client::common::WarmupType type, fuse_ino_t key,
@@ -470,8 +473,8 @@ void WriteThrottleAdd(size_t size) { Client()->Add(false, size); }
 void FuseOpInit(void *userdata, struct fuse_conn_info *conn) {
     CURVEFS_ERROR rc;
     auto client = Client();
-    AccessLogGuard log([&](){
-        return StrFormat("init : %s", StrErr(rc));
+    AccessLogGuard log("init", [&](AccessLogRecord* record) {
+        record->Encode("init : %s", LogErr(rc));
     });
 
     rc = client->FuseOpInit(userdata, conn);
@@ -485,8 +488,8 @@ void FuseOpInit(void *userdata, struct fuse_conn_info *conn) {
 
 void FuseOpDestroy(void *userdata) {
     auto client = Client();
-    AccessLogGuard log([&](){
-        return StrFormat("destory : OK");
+    AccessLogGuard log("destory", [&](AccessLogRecord* record) {
+        record->Encode("destory : OK");
     });
     client->FuseOpDestroy(userdata);
 }
@@ -497,9 +500,9 @@ void FuseOpLookup(fuse_req_t req, fuse_ino_t parent, const char* name) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Lookup);
-    AccessLogGuard log([&](){
-        return StrFormat("lookup (%d,%s): %s%s",
-                         parent, name, StrErr(rc), StrEntry(entryOut));
+    AccessLogGuard log("lookup", [&](AccessLogRecord* record) {
+        record->Encode("lookup (%d,%s): %s%s",
+                       parent, name, LogErr(rc), LogEntry(entryOut));
     });
 
     rc = client->FuseOpLookup(req, parent, name, &entryOut);
@@ -515,9 +518,9 @@ void FuseOpGetAttr(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(GetAttr);
-    AccessLogGuard log([&](){
-        return StrFormat("getattr (%d): %s%s",
-                         ino, StrErr(rc), StrAttr(attrOut));
+    AccessLogGuard log("getattr", [&](AccessLogRecord* record) {
+        record->Encode("getattr (%d): %s%s",
+                       ino, LogErr(rc), LogAttr(attrOut));
     });
 
     rc = client->FuseOpGetAttr(req, ino, fi, &attrOut);
@@ -537,9 +540,9 @@ void FuseOpSetAttr(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(SetAttr);
-    AccessLogGuard log([&](){
-        return StrFormat("setattr (%d,0x%X): %s%s",
-                         ino, to_set, StrErr(rc), StrAttr(attrOut));
+    AccessLogGuard log("setattr", [&](AccessLogRecord* record) {
+        record->Encode("setattr (%d,0x%X): %s%s",
+                       ino, to_set, LogErr(rc), LogAttr(attrOut));
     });
 
     rc = client->FuseOpSetAttr(req, ino, attr, to_set, fi, &attrOut);
@@ -555,8 +558,8 @@ void FuseOpReadLink(fuse_req_t req, fuse_ino_t ino) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(ReadLink);
-    AccessLogGuard log([&](){
-        return StrFormat("readlink (%d): %s %s", ino, StrErr(rc), link.c_str());
+    AccessLogGuard log("readlink", [&](AccessLogRecord* record) {
+        record->Encode("readlink (%d): %s %s", ino, LogErr(rc), link);
     });
 
     rc = client->FuseOpReadLink(req, ino, &link);
@@ -576,10 +579,10 @@ void FuseOpMkNod(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(MkNod);
-    AccessLogGuard log([&](){
-        return StrFormat("mknod (%d,%s,%s:0%04o): %s%s",
-                         parent, name, StrMode(mode), mode,
-                         StrErr(rc), StrEntry(entryOut));
+    AccessLogGuard log("mknod", [&](AccessLogRecord* record) {
+        record->Encode("mknod (%d,%s,%s:0%04o): %s%s",
+                       parent, name, LogMode(mode), mode,
+                       LogErr(rc), LogEntry(entryOut));
     });
 
     rc = client->FuseOpMkNod(req, parent, name, mode, rdev, &entryOut);
@@ -598,10 +601,10 @@ void FuseOpMkDir(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(MkDir);
-    AccessLogGuard log([&](){
-        return StrFormat("mkdir (%d,%s,%s:0%04o): %s%s",
-                         parent, name, StrMode(mode), mode,
-                         StrErr(rc), StrEntry(entryOut));
+    AccessLogGuard log("mkdir", [&](AccessLogRecord* record) {
+        record->Encode("mkdir (%d,%s,%s:0%04o): %s%s",
+                       parent, name, LogMode(mode), mode,
+                       LogErr(rc), LogEntry(entryOut));
     });
 
     rc = client->FuseOpMkDir(req, parent, name, mode, &entryOut);
@@ -616,8 +619,8 @@ void FuseOpUnlink(fuse_req_t req, fuse_ino_t parent, const char *name) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Unlink);
-    AccessLogGuard log([&](){
-        return StrFormat("unlink (%d,%s): %s", parent, name, StrErr(rc));
+    AccessLogGuard log("unlink", [&](AccessLogRecord* record) {
+        record->Encode("unlink (%d,%s): %s", parent, name, LogErr(rc));
     });
 
     rc = client->FuseOpUnlink(req, parent, name);
@@ -629,8 +632,8 @@ void FuseOpRmDir(fuse_req_t req, fuse_ino_t parent, const char *name) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(RmDir);
-    AccessLogGuard log([&](){
-        return StrFormat("rmdir (%d,%s): %s", parent, name, StrErr(rc));
+    AccessLogGuard log("rmdir", [&](AccessLogRecord* record) {
+        record->Encode("rmdir (%d,%s): %s", parent, name, LogErr(rc));
     });
 
     rc = client->FuseOpRmDir(req, parent, name);
@@ -646,9 +649,9 @@ void FuseOpSymlink(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Symlink);
-    AccessLogGuard log([&](){
-        return StrFormat("symlink (%d,%s,%s): %s%s",
-                         parent, name, link, StrErr(rc), StrEntry(entryOut));
+    AccessLogGuard log("symlink", [&](AccessLogRecord* record) {
+        record->Encode("symlink (%d,%s,%s): %s%s",
+                       parent, name, link, LogErr(rc), LogEntry(entryOut));
     });
 
     rc = client->FuseOpSymlink(req, link, parent, name, &entryOut);
@@ -668,9 +671,9 @@ void FuseOpRename(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Rename);
-    AccessLogGuard log([&](){
-        return StrFormat("rename (%d,%s,%d,%s,%d): %s",
-                         parent, name, newparent, newname, flags, StrErr(rc));
+    AccessLogGuard log("rename", [&](AccessLogRecord* record) {
+        record->Encode("rename (%d,%s,%d,%s,%d): %s",
+                       parent, name, newparent, newname, flags, LogErr(rc));
     });
 
     rc = client->FuseOpRename(req, parent, name, newparent, newname, flags);
@@ -686,10 +689,10 @@ void FuseOpLink(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Link);
-    AccessLogGuard log([&](){
-        return StrFormat(
+    AccessLogGuard log("link", [&](AccessLogRecord* record) {
+        record->Encode(
             "link (%d,%d,%s): %s%s",
-            ino, newparent, newname, StrErr(rc), StrEntry(entryOut));
+            ino, newparent, newname, LogErr(rc), LogEntry(entryOut));
     });
 
     rc = client->FuseOpLink(req, ino, newparent, newname, &entryOut);
@@ -705,8 +708,8 @@ void FuseOpOpen(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Open);
-    AccessLogGuard log([&](){
-        return StrFormat("open (%d): %s [fh:%d]", ino, StrErr(rc), fi->fh);
+    AccessLogGuard log("open", [&](AccessLogRecord* record) {
+        record->Encode("open (%d): %s [fh:%d]", ino, LogErr(rc), fi->fh);
     });
 
     rc = client->FuseOpOpen(req, ino, fi, &fileOut);
@@ -724,23 +727,22 @@ void FuseOpRead(fuse_req_t req,
                 struct fuse_file_info* fi) {
     CURVEFS_ERROR rc;
     size_t rSize = 0;
-    std::unique_ptr<char[]> buffer(new char[size]);
+    ReadBuffer buffer;
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Read);
-    AccessLogGuard log([&](){
-        return StrFormat("read (%d,%d,%d,%d): %s (%d)",
-                         ino, size, off, fi->fh, StrErr(rc), rSize);
+    AccessLogGuard log("read", [&](AccessLogRecord* record) {
+        record->Encode("read (%d,%d,%d,%d): %s (%d)",
+                       ino, size, off, fi->fh, LogErr(rc), rSize);
     });
 
     ReadThrottleAdd(size);
-    rc = client->FuseOpRead(req, ino, size, off, fi, buffer.get(), &rSize);
+    rc = client->FuseOpReadZeroCopy(req, ino, size, off, fi, &buffer);
     if (rc != CURVEFS_ERROR::OK) {
         return fs->ReplyError(req, rc);
     }
-    struct fuse_bufvec bufvec = FUSE_BUFVEC_INIT(rSize);
-    bufvec.buf[0].mem = buffer.get();
-    return fs->ReplyData(req, &bufvec, FUSE_BUF_SPLICE_MOVE);
+    rSize = buffer.Size();
+    return fs->ReplyData(req, buffer.ToBufvec(), FUSE_BUF_SPLICE_MOVE);
 }
 
 void FuseOpWrite(fuse_req_t req,
@@ -754,9 +756,9 @@ void FuseOpWrite(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Write);
-    AccessLogGuard log([&](){
-        return StrFormat("write (%d,%d,%d,%d): %s (%d)",
-                         ino, size, off, fi->fh, StrErr(rc), fileOut.nwritten);
+    AccessLogGuard log("write", [&](AccessLogRecord* record) {
+        record->Encode("write (%d,%d,%d,%d): %s (%d)",
+                       ino, size, off, fi->fh, LogErr(rc), fileOut.nwritten);
     });
 
     WriteThrottleAdd(size);
@@ -774,8 +776,8 @@ void FuseOpFlush(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Flush);
-    AccessLogGuard log([&](){
-        return StrFormat("flush (%d,%d): %s", ino, fi->fh, StrErr(rc));
+    AccessLogGuard log("flush", [&](AccessLogRecord* record) {
+        record->Encode("flush (%d,%d): %s", ino, fi->fh, LogErr(rc));
     });
 
     rc = client->FuseOpFlush(req, ino, fi);
@@ -787,8 +789,8 @@ void FuseOpRelease(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Release);
-    AccessLogGuard log([&](){
-        return StrFormat("release (%d,%d): %s", ino, fi->fh, StrErr(rc));
+    AccessLogGuard log("release", [&](AccessLogRecord* record) {
+        record->Encode("release (%d,%d): %s", ino, fi->fh, LogErr(rc));
     });
 
     rc = client->FuseOpRelease(req, ino, fi);
@@ -803,8 +805,8 @@ void FuseOpFsync(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Fsync);
-    AccessLogGuard log([&](){
-        return StrFormat("fsync (%d,%d): %s", ino, datasync, StrErr(rc));
+    AccessLogGuard log("fsync", [&](AccessLogRecord* record) {
+        record->Encode("fsync (%d,%d): %s", ino, datasync, LogErr(rc));
     });
 
     rc = client->FuseOpFsync(req, ino, datasync, fi);
@@ -816,8 +818,8 @@ void FuseOpOpenDir(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(OpenDir);
-    AccessLogGuard log([&](){
-        return StrFormat("opendir (%d): %s [fh:%d]", ino, StrErr(rc), fi->fh);
+    AccessLogGuard log("opendir", [&](AccessLogRecord* record) {
+        record->Encode("opendir (%d): %s [fh:%d]", ino, LogErr(rc), fi->fh);
     });
 
     rc = client->FuseOpOpenDir(req, ino, fi);
@@ -838,9 +840,9 @@ void FuseOpReadDir(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(ReadDir);
-    AccessLogGuard log([&](){
-        return StrFormat("readdir (%d,%d,%d): %s (%d)",
-                         ino, size, off, StrErr(rc), rSize);
+    AccessLogGuard log("readdir", [&](AccessLogRecord* record) {
+        record->Encode("readdir (%d,%d,%d): %s (%d)",
+                       ino, size, off, LogErr(rc), rSize);
     });
 
     rc = client->FuseOpReadDir(req, ino, size, off, fi, &buffer, &rSize, false);
@@ -861,9 +863,9 @@ void FuseOpReadDirPlus(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(ReadDir);
-    AccessLogGuard log([&](){
-        return StrFormat("readdirplus (%d,%d,%d): %s (%d)",
-                         ino, size, off, StrErr(rc), rSize);
+    AccessLogGuard log("readdirplus", [&](AccessLogRecord* record) {
+        record->Encode("readdirplus (%d,%d,%d): %s (%d)",
+                       ino, size, off, LogErr(rc), rSize);
     });
 
     rc = client->FuseOpReadDir(req, ino, size, off, fi, &buffer, &rSize, true);
@@ -881,8 +883,8 @@ void FuseOpReleaseDir(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(ReleaseDir);
-    AccessLogGuard log([&](){
-        return StrFormat("releasedir (%d,%d): %s", ino, fi->fh, StrErr(rc));
+    AccessLogGuard log("releasedir", [&](AccessLogRecord* record) {
+        record->Encode("releasedir (%d,%d): %s", ino, fi->fh, LogErr(rc));
     });
 
     rc = client->FuseOpReleaseDir(req, ino, fi);
@@ -894,8 +896,8 @@ void FuseOpStatFs(fuse_req_t req, fuse_ino_t ino) {
     struct statvfs stbuf;
     auto client = Client();
     auto fs = client->GetFileSystem();
-    AccessLogGuard log([&](){
-        return StrFormat("statfs (%d): %s", ino, StrErr(rc));
+    AccessLogGuard log("statfs", [&](AccessLogRecord* record) {
+        record->Encode("statfs (%d): %s", ino, LogErr(rc));
     });
 
     rc = client->FuseOpStatFs(req, ino, &stbuf);
@@ -914,9 +916,9 @@ void FuseOpSetXattr(fuse_req_t req,
     CURVEFS_ERROR rc;
     auto client = Client();
     auto fs = client->GetFileSystem();
-    AccessLogGuard log([&](){
-        return StrFormat("setxattr (%d,%s,%d,%d): %s",
-                         ino, name, size, flags, StrErr(rc));
+    AccessLogGuard log("setxattr", [&](AccessLogRecord* record) {
+        record->Encode("setxattr (%d,%s,%d,%d): %s",
+                       ino, name, size, flags, LogErr(rc));
     });
 
     if (IsWarmupXAttr(name)) {
@@ -935,9 +937,9 @@ void FuseOpGetXattr(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(GetXattr);
-    AccessLogGuard log([&](){
-        return StrFormat("getxattr (%d,%s,%d): %s (%d)",
-                         ino, name, size, StrErr(rc), value.size());
+    AccessLogGuard log("getxattr", [&](AccessLogRecord* record) {
+        record->Encode("getxattr (%d,%s,%d): %s (%d)",
+                       ino, name, size, LogErr(rc), value.size());
     });
 
     if (IsListWarmupXAttr(name)) {
@@ -963,9 +965,9 @@ void FuseOpListXattr(fuse_req_t req, fuse_ino_t ino, size_t size) {
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(ListXattr);
-    AccessLogGuard log([&](){
-        return StrFormat("listxattr (%d,%s): %s (%d)",
-                         ino, size, StrErr(rc), xattrSize);
+    AccessLogGuard log("listxattr", [&](AccessLogRecord* record) {
+        record->Encode("listxattr (%d,%d): %s (%d)",
+                       ino, size, LogErr(rc), xattrSize);
     });
 
     rc = Client()->FuseOpListXattr(req, ino, buf.get(), size, &xattrSize);
@@ -987,9 +989,9 @@ void FuseOpCreate(fuse_req_t req,
     auto client = Client();
     auto fs = client->GetFileSystem();
     MetricGuard(Create);
-    AccessLogGuard log([&](){
-        return StrFormat("create (%d,%s): %s%s [fh:%d]",
-                         parent, name, StrErr(rc), StrEntry(entryOut), fi->fh);
+    AccessLogGuard log("create", [&](AccessLogRecord* record) {
+        record->Encode("create (%d,%s): %s%s [fh:%d]",
+                       parent, name, LogErr(rc), LogEntry(entryOut), fi->fh);
     });
 
     rc = client->FuseOpCreate(req, parent, name, mode, fi, &entryOut);
@@ -117,7 +117,9 @@ DeferSync::DeferSync(bool cto, DeferSyncOption option)
       thread_(),
       sleeper_(),
       pending_(),
-      inodes_(std::make_shared<DeferInodes>(cto)) {}
+      pendingSet_(),
+      inodes_(std::make_shared<DeferInodes>(cto)),
+      metric_() {}
 
 void DeferSync::Start() {
     if (!running_.exchange(true)) {
@@ -154,13 +156,9 @@ void DeferSync::SyncTask() {
         {
             LockGuard lk(mutex_);
             syncing.swap(pending_);
+            pendingSet_.clear();
         }
-        for (const auto& inode : syncing) {
-            auto closure = NewSyncInodeClosure(inode);
-            UniqueLock lk(inode->GetUniqueLock());
-            inode->Async(closure, true);
-        }
-        syncing.clear();
+        DoSync(&syncing);
 
         if (!running) {
             break;
@@ -168,9 +166,54 @@ void DeferSync::SyncTask() {
     }
 }
 
+void DeferSync::DoSync(std::vector<std::shared_ptr<InodeWrapper>>* syncing) {
+    std::vector<MetaServerClientDone*> closures;
+    closures.reserve(syncing->size());
+    for (const auto& inode : *syncing) {
+        closures.emplace_back(NewSyncInodeClosure(inode));
+    }
+
+    if (option_.batchFlush) {
+        // ship inodes of the same partition in one rpc
+        InodeWrapper::AsyncBatch(*syncing, closures);
+    } else {
+        for (size_t i = 0; i < syncing->size(); i++) {
+            UniqueLock lk((*syncing)[i]->GetUniqueLock());
+            (*syncing)[i]->Async(closures[i], true);
+        }
+    }
+    syncing->clear();
+}
+
+void DeferSync::SyncPending(bool force) {
+    if (!option_.batchFlush) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<InodeWrapper>> syncing;
+    {
+        LockGuard lk(mutex_);
+        if (pending_.empty()) {
+            return;
+        } else if (!force && (option_.batchFlushSize == 0 ||
+                              pending_.size() < option_.batchFlushSize)) {
+            return;
+        }
+        syncing.swap(pending_);
+        pendingSet_.clear();
+    }
+    DoSync(&syncing);
+}
+
 void DeferSync::Push(const std::shared_ptr<InodeWrapper>& inode) {
     LockGuard lk(mutex_);
-    pending_.emplace_back(inode);
+    // an inode is usually shipped many times in one window (e.g. by every
+    // write), the single sync at the end of window carries all its changes
+    if (pendingSet_.insert(inode.get()).second) {
+        pending_.emplace_back(inode);
+    } else {
+        metric_.AddCoalesced(1);
+    }
     inodes_->Add(inode);
 }
 
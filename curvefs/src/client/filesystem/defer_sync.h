@@ -26,12 +26,14 @@
 #include <atomic>
 #include <vector>
 #include <memory>
+#include <unordered_set>
 
 #include "absl/container/btree_map.h"
 #include "src/common/interruptible_sleeper.h"
 #include "curvefs/src/client/common/config.h"
 #include "curvefs/src/client/rpcclient/task_excutor.h"
 #include "curvefs/src/client/filesystem/meta.h"
+#include "curvefs/src/client/filesystem/metric.h"
 
 namespace curvefs {
 namespace client {
@@ -84,12 +86,19 @@ class DeferSync {
 
     void Push(const std::shared_ptr<InodeWrapper>& inode);
 
+    // Ship pending inodes before the window ends, so that chunks uploaded by
+    // data flush are batched to metaserver right behind the uploads. Only
+    // ships a full batch (see batchFlushSize) unless |force|.
+    void SyncPending(bool force);
+
     bool IsDefered(Ino ino, std::shared_ptr<InodeWrapper>* inode);
 
  private:
     SyncInodeClosure* NewSyncInodeClosure(
         const std::shared_ptr<InodeWrapper>& inode);
 
+    void DoSync(std::vector<std::shared_ptr<InodeWrapper>>* syncing);
+
     void SyncTask();
 
  private:
@@ -103,7 +112,10 @@ class DeferSync {
     std::thread thread_;
     InterruptibleSleeper sleeper_;
     std::vector<std::shared_ptr<InodeWrapper>> pending_;
+    // inodes in |pending_|, an inode is synced only once per window
+    std::unordered_set<InodeWrapper*> pendingSet_;
     std::shared_ptr<DeferInodes> inodes_;
+    DeferSyncMetric metric_;
 };
 
 }  // namespace filesystem
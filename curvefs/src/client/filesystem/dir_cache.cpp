@@ -32,8 +32,11 @@ namespace filesystem {
 DirEntryList::DirEntryList()
     : rwlock_(),
       mtime_(),
+      expireTime_(),
       entries_(),
-      index_() {}
+      index_(),
+      nameIndexed_(false),
+      nameIndex_() {}
 
 size_t DirEntryList::Size() {
     ReadLockGuard lk(rwlock_);
@@ -44,6 +47,9 @@ void DirEntryList::Add(const DirEntry& dirEntry) {
     WriteLockGuard lk(rwlock_);
     entries_.push_back(std::move(dirEntry));
     index_[dirEntry.ino] = entries_.size() - 1;
+    if (nameIndexed_) {
+        nameIndex_[dirEntry.name] = entries_.size() - 1;
+    }
 }
 
 bool DirEntryList::Get(Ino ino, DirEntry* dirEntry) {
@@ -57,6 +63,36 @@ bool DirEntryList::Get(Ino ino, DirEntry* dirEntry) {
     return true;
 }
 
+bool DirEntryList::LookupLocked(const std::string& name,
+                                DirEntry* dirEntry) {
+    auto iter = nameIndex_.find(name);
+    if (iter == nameIndex_.end()) {
+        return false;
+    }
+
+    *dirEntry = entries_[iter->second];
+    return true;
+}
+
+bool DirEntryList::Lookup(const std::string& name, DirEntry* dirEntry) {
+    {
+        ReadLockGuard lk(rwlock_);
+        if (nameIndexed_) {
+            return LookupLocked(name, dirEntry);
+        }
+    }
+
+    WriteLockGuard lk(rwlock_);
+    if (!nameIndexed_) {
+        nameIndex_.reserve(entries_.size());
+        for (uint32_t i = 0; i < entries_.size(); i++) {
+            nameIndex_[entries_[i].name] = i;
+        }
+        nameIndexed_ = true;
+    }
+    return LookupLocked(name, dirEntry);
+}
+
 bool DirEntryList::At(uint32_t index, DirEntry* dirEntry) {
     ReadLockGuard lk(rwlock_);
     if (index >= entries_.size()) {
@@ -108,6 +144,8 @@ void DirEntryList::Clear() {
     WriteLockGuard lk(rwlock_);
     entries_.clear();
     index_.clear();
+    nameIndex_.clear();
+    nameIndexed_ = false;
 }
 
 void DirEntryList::SetMtime(TimeSpec mtime) {
@@ -120,6 +158,16 @@ TimeSpec DirEntryList::GetMtime() {
     return mtime_;
 }
 
+void DirEntryList::SetExpireTime(TimeSpec expireTime) {
+    WriteLockGuard lk(rwlock_);
+    expireTime_ = expireTime;
+}
+
+TimeSpec DirEntryList::GetExpireTime() {
+    ReadLockGuard lk(rwlock_);
+    return expireTime_;
+}
+
 DirCache::DirCache(DirCacheOption option)
     : rwlock_(),
       nentries_(0),
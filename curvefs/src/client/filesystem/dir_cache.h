@@ -25,10 +25,12 @@
 
 #include <map>
 #include <list>
+#include <string>
 #include <vector>
 #include <memory>
 
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "src/common/lru_cache.h"
 #include "src/common/concurrent/concurrent.h"
 #include "curvefs/src/client/common/config.h"
@@ -61,6 +63,9 @@ class DirEntryList {
 
     bool Get(Ino ino, DirEntry* dirEntry);
 
+    // find entry by name, the name index is built at the first call
+    bool Lookup(const std::string& name, DirEntry* dirEntry);
+
     bool At(uint32_t index, DirEntry* dirEntry);
 
     bool UpdateAttr(Ino ino, const InodeAttr& attr);
@@ -73,11 +78,22 @@ class DirEntryList {
 
     TimeSpec GetMtime();
 
+    // the entries can serve lookup request before expired
+    void SetExpireTime(TimeSpec expireTime);
+
+    TimeSpec GetExpireTime();
+
+ private:
+    bool LookupLocked(const std::string& name, DirEntry* dirEntry);
+
  private:
     RWLock rwlock_;
     TimeSpec mtime_;
+    TimeSpec expireTime_;
     std::vector<DirEntry> entries_;
     absl::btree_map<Ino, uint32_t> index_;
+    bool nameIndexed_;
+    absl::flat_hash_map<std::string, uint32_t> nameIndex_;
 };
 
 class DirCache {
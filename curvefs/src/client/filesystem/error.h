@@ -25,6 +25,7 @@
 #include <iostream>
 
 #include "curvefs/proto/metaserver.pb.h"
+#include "curvefs/src/client/logger/access_log.h"
 
 #ifndef CURVEFS_SRC_CLIENT_FILESYSTEM_ERROR_H_
 #define CURVEFS_SRC_CLIENT_FILESYSTEM_ERROR_H_
@@ -63,6 +64,11 @@ enum class CURVEFS_ERROR {
 
 std::string StrErr(CURVEFS_ERROR code);
 
+// the error code which is formatted by StrErr() in the access log writer
+inline logger::DeferredArg<CURVEFS_ERROR> LogErr(CURVEFS_ERROR code) {
+    return { code, &StrErr };
+}
+
 int SysErr(CURVEFS_ERROR code);
 
 std::ostream &operator<<(std::ostream &os, CURVEFS_ERROR code);
@@ -39,6 +39,11 @@ FileSystem::FileSystem(FileSystemOption option, ExternalMember member)
                                              deferSync_);
     attrWatcher_ = std::make_shared<AttrWatcher>(option_.attrWatcherOption,
                                                  openFiles_, dirCache_);
+    metaLease_ = std::make_shared<MetaLease>(option_.metaLeaseOption);
+    metaLease_->SetRevokeHandler([this](Ino ino) {
+        dirCache_->Drop(ino);
+        negative_->Drop(ino);
+    });
     handlerManager_ = std::make_shared<HandlerManager>();
     rpc_ = std::make_shared<RPCClient>(option.rpcOption, member);
 }
@@ -46,12 +51,14 @@ FileSystem::FileSystem(FileSystemOption option, ExternalMember member)
 void FileSystem::Run() {
     deferSync_->Start();
     dirCache_->Start();
+    metaLease_->Start();
 }
 
 void FileSystem::Destory() {
     openFiles_->CloseAll();
     deferSync_->Stop();
     dirCache_->Stop();
+    metaLease_->Stop();
 }
 
 void FileSystem::Attr2Stat(InodeAttr* attr, struct stat* stat) {
@@ -231,10 +238,50 @@ void FileSystem::ReleaseHandler(uint64_t fh) {
 }
 
 FileSystemMember FileSystem::BorrowMember() {
-    return FileSystemMember(deferSync_, openFiles_, attrWatcher_);
+    return FileSystemMember(deferSync_, openFiles_, attrWatcher_,
+                            metaLease_);
 }
 
 // fuse request*
+bool FileSystem::LookupDirCache(Ino parent,
+                                const std::string& name,
+                                TimeSpec mtime,
+                                bool leased,
+                                EntryOut* entryOut,
+                                CURVEFS_ERROR* rc) {
+    std::shared_ptr<DirEntryList> entries;
+    bool yes = dirCache_->Get(parent, &entries);
+    if (!yes) {
+        return false;
+    }
+
+    bool fresh = entries->GetMtime() == mtime &&  // dir not modified
+                 entries->GetExpireTime() >= Now();
+    if (!fresh && !leased) {
+        return false;
+    }
+
+    // the entries of directory are complete, so the entry not exist
+    // if we can't find it in the entries.
+    DirEntry dirEntry;
+    yes = entries->Lookup(name, &dirEntry);
+    if (!yes) {
+        *rc = CURVEFS_ERROR::NOT_EXIST;
+    } else if (fresh) {
+        *entryOut = EntryOut(dirEntry.attr);
+        *rc = CURVEFS_ERROR::OK;
+    } else {
+        // the lease of parent only protects the names, the modifications
+        // of child don't revoke it, so its attribute need to be fetched
+        InodeAttr attr;
+        *rc = rpc_->GetAttr(dirEntry.ino, &attr);
+        if (*rc == CURVEFS_ERROR::OK) {
+            *entryOut = EntryOut(attr);
+        }
+    }
+    return true;
+}
+
 CURVEFS_ERROR FileSystem::Lookup(Ino parent,
                                  const std::string& name,
                                  EntryOut* entryOut) {
@@ -242,16 +289,27 @@ CURVEFS_ERROR FileSystem::Lookup(Ino parent,
         return CURVEFS_ERROR::NAME_TOO_LONG;
     }
 
-    bool yes = negative_->Get(parent, name);
+    // the modified time of parent which we replied to kernel lastly,
+    // zero means unknown and only the negative cache with timeout works.
+    TimeSpec mtime;
+    CURVEFS_ERROR rc;
+    bool yes = attrWatcher_->GetMtime(parent, &mtime);
+    bool leased = metaLease_->Hold(parent);
+    if ((yes || leased) &&
+        LookupDirCache(parent, name, mtime, leased, entryOut, &rc)) {
+        return rc;
+    }
+
+    yes = negative_->Get(parent, name, mtime);
     if (yes) {
         return CURVEFS_ERROR::NOT_EXIST;
     }
 
-    auto rc = rpc_->Lookup(parent, name, entryOut);
+    rc = rpc_->Lookup(parent, name, entryOut);
     if (rc == CURVEFS_ERROR::OK) {
         negative_->Delete(parent, name);
     } else if (rc == CURVEFS_ERROR::NOT_EXIST) {
-        negative_->Put(parent, name);
+        negative_->Put(parent, name, mtime);
     }
     return rc;
 }
@@ -266,6 +324,21 @@ CURVEFS_ERROR FileSystem::GetAttr(Ino ino, AttrOut* attrOut) {
 }
 
 CURVEFS_ERROR FileSystem::OpenDir(Ino ino, FileInfo* fi) {
+    // the names of cached entries are fresh while we hold the lease, but
+    // the attributes of them are trusted only within the cache timeout
+    std::shared_ptr<DirEntryList> entries;
+    bool yes = dirCache_->Get(ino, &entries);
+    if (yes && metaLease_->Hold(ino)) {
+        if (entries->GetExpireTime() >= Now()) {
+            auto handler = NewHandler();
+            handler->mtime = entries->GetMtime();
+            fi->fh = handler->fh;
+            return CURVEFS_ERROR::OK;
+        }
+        dirCache_->Drop(ino);
+        yes = false;
+    }
+
     InodeAttr attr;
     CURVEFS_ERROR rc = rpc_->GetAttr(ino, &attr);
     if (rc != CURVEFS_ERROR::OK) {
@@ -273,8 +346,6 @@ CURVEFS_ERROR FileSystem::OpenDir(Ino ino, FileInfo* fi) {
     }
 
     // revalidate directory cache
-    std::shared_ptr<DirEntryList> entries;
-    bool yes = dirCache_->Get(ino, &entries);
     if (yes) {
         if (entries->GetMtime() != AttrMtime(attr)) {
             dirCache_->Drop(ino);
@@ -295,13 +366,18 @@ CURVEFS_ERROR FileSystem::ReadDir(Ino ino,
         return CURVEFS_ERROR::OK;
     }
 
+    // the modifications after it will deny our lease
+    uint64_t sequence = metaLease_->Sequence();
     CURVEFS_ERROR rc = rpc_->ReadDir(ino, entries);
     if (rc != CURVEFS_ERROR::OK) {
         return rc;
     }
 
+    auto timeout = TimeSpec(option_.dirCacheOption.timeoutSec, 0);
     (*entries)->SetMtime(FindHandler(fi->fh)->mtime);
+    (*entries)->SetExpireTime(Now() + timeout);
     dirCache_->Put(ino, *entries);
+    metaLease_->Acquire(ino, sequence);
     return CURVEFS_ERROR::OK;
 }
 
@@ -347,6 +423,12 @@ CURVEFS_ERROR FileSystem::Release(Ino ino) {
     return CURVEFS_ERROR::OK;
 }
 
+void FileSystem::InvalidateDir(Ino parent) {
+    dirCache_->Drop(parent);
+    negative_->Drop(parent);
+    metaLease_->Modified(parent);
+}
+
 }  // namespace filesystem
 }  // namespace client
 }  // namespace curvefs
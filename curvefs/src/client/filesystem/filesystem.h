@@ -38,24 +38,29 @@
 #include "curvefs/src/client/filesystem/attr_watcher.h"
 #include "curvefs/src/client/filesystem/rpc_client.h"
 #include "curvefs/src/client/filesystem/defer_sync.h"
+#include "curvefs/src/client/lease/meta_lease.h"
 
 namespace curvefs {
 namespace client {
 namespace filesystem {
 
+using ::curvefs::client::MetaLease;
 using ::curvefs::client::common::FileSystemOption;
 
 struct FileSystemMember {
     FileSystemMember(std::shared_ptr<DeferSync> deferSync,
                      std::shared_ptr<OpenFiles> openFiles,
-                     std::shared_ptr<AttrWatcher> attrWatcher)
+                     std::shared_ptr<AttrWatcher> attrWatcher,
+                     std::shared_ptr<MetaLease> metaLease)
         : deferSync(deferSync),
           openFiles(openFiles),
-          attrWatcher(attrWatcher) {}
+          attrWatcher(attrWatcher),
+          metaLease(metaLease) {}
 
     std::shared_ptr<DeferSync> deferSync;
     std::shared_ptr<OpenFiles> openFiles;
     std::shared_ptr<AttrWatcher> attrWatcher;
+    std::shared_ptr<MetaLease> metaLease;
 };
 
 class FileSystem {
@@ -85,6 +90,11 @@ class FileSystem {
 
     CURVEFS_ERROR Release(Ino ino);
 
+    // drop all cached entries of the directory, it should be invoked
+    // when the directory is modified by ourself. If meta lease is enabled,
+    // it blocks until the leases of the directory held by others expire.
+    void InvalidateDir(Ino parent);
+
     // fuse reply: we control all replies to vfs layer in same entrance.
     void ReplyError(Request req, CURVEFS_ERROR code);
 
@@ -140,6 +150,17 @@ class FileSystem {
     // utility: others
     FileSystemMember BorrowMember();
 
+ private:
+    // lookup entry in the directory cache, return false if the cached
+    // entries of parent are absent or not fresh. If we hold the lease of
+    // parent, the names are trusted but the stale attribute is refetched.
+    bool LookupDirCache(Ino parent,
+                        const std::string& name,
+                        TimeSpec mtime,
+                        bool leased,
+                        EntryOut* entryOut,
+                        CURVEFS_ERROR* rc);
+
  private:
     FileSystemOption option_;
     ExternalMember member;
@@ -148,6 +169,7 @@ class FileSystem {
     std::shared_ptr<DirCache> dirCache_;
     std::shared_ptr<OpenFiles> openFiles_;
     std::shared_ptr<AttrWatcher> attrWatcher_;
+    std::shared_ptr<MetaLease> metaLease_;
     std::shared_ptr<HandlerManager> handlerManager_;
     std::shared_ptr<RPCClient> rpc_;
 };
@@ -43,8 +43,9 @@ namespace filesystem {
 LookupCache::LookupCache(LookupCacheOption option)
     : enable_(option.negativeTimeoutSec > 0),
       rwlock_(),
+      nentries_(0),
       option_(option) {
-    lru_ = std::make_shared<LRUType>(option.lruSize);
+    lru_ = std::make_shared<LRUType>(0);  // control size by ourself
     if (enable_) {
         LOG(INFO) << "Using lookup negative lru cache"
                   << ", timeout = " << option.negativeTimeoutSec
@@ -52,50 +53,94 @@ LookupCache::LookupCache(LookupCacheOption option)
     }
 }
 
-std::string LookupCache::CacheKey(Ino parent, const std::string& name) {
-    return absl::StrFormat("%d:%s", parent, name);
+void LookupCache::Delete(Ino parent, const std::shared_ptr<DirEntries>& dir) {
+    nentries_ -= dir->entries.size();
+    lru_->Remove(parent);
 }
 
-bool LookupCache::Get(Ino parent, const std::string& name) {
+void LookupCache::Evit(size_t size) {
+    Ino parent;
+    std::shared_ptr<DirEntries> dir;
+    while (nentries_ + size > option_.lruSize) {
+        bool yes = lru_->GetLast(&parent, &dir);
+        if (!yes) {
+            break;
+        }
+        Delete(parent, dir);
+    }
+}
+
+bool LookupCache::Get(Ino parent, const std::string& name, TimeSpec mtime) {
     RETURN_FALSE_IF_DISABLED();
     ReadLockGuard lk(rwlock_);
-    CacheEntry entry;
-    auto key = CacheKey(parent, name);
-    bool yes = lru_->Get(key, &entry);
+    std::shared_ptr<DirEntries> dir;
+    bool yes = lru_->Get(parent, &dir);
     if (!yes) {
         VLOG(1) << absl::StrFormat("Lookup cache not found: key(%d,%s)",
                                    parent, name);
         return false;
-    } else if (entry.uses < option_.minUses) {
+    } else if (dir->mtime != mtime) {  // directory modified
         return false;
-    } else if (entry.expireTime < Now()) {
+    }
+
+    auto iter = dir->entries.find(name);
+    if (iter == dir->entries.end()) {
+        return false;
+    } else if (iter->second.uses < option_.minUses) {
+        return false;
+    } else if (iter->second.expireTime < Now()) {
         return false;
     }
     return true;
 }
 
-bool LookupCache::Put(Ino parent, const std::string& name) {
+bool LookupCache::Put(Ino parent, const std::string& name, TimeSpec mtime) {
     RETURN_FALSE_IF_DISABLED();
     WriteLockGuard lk(rwlock_);
-    CacheEntry entry;
-    auto key = CacheKey(parent, name);
-    bool yes = lru_->Get(key, &entry);
-    if (yes) {
-        entry.uses++;
-    } else {
-        entry.uses = 1;
+    std::shared_ptr<DirEntries> dir;
+    bool yes = lru_->Get(parent, &dir);
+    if (yes && dir->mtime != mtime) {
+        Delete(parent, dir);
+        yes = false;
+    }
+
+    if (!yes || dir->entries.find(name) == dir->entries.end()) {
+        Evit(1);  // it maybe evit the directory itself
+        yes = lru_->Get(parent, &dir);
+        if (!yes) {
+            dir = std::make_shared<DirEntries>();
+            dir->mtime = mtime;
+            lru_->Put(parent, dir);
+        }
+        dir->entries[name].uses = 0;
+        nentries_++;
     }
 
-    entry.expireTime = Now() + TimeSpec(option_.negativeTimeoutSec, 0);
-    lru_->Put(key, entry);
+    CacheEntry* entry = &dir->entries[name];
+    entry->uses++;
+    entry->expireTime = Now() + TimeSpec(option_.negativeTimeoutSec, 0);
     return true;
 }
 
 bool LookupCache::Delete(Ino parent, const std::string& name) {
     RETURN_FALSE_IF_DISABLED();
     WriteLockGuard lk(rwlock_);
-    auto key = CacheKey(parent, name);
-    lru_->Remove(key);
+    std::shared_ptr<DirEntries> dir;
+    bool yes = lru_->Get(parent, &dir);
+    if (yes && dir->entries.erase(name) > 0) {
+        nentries_--;
+    }
+    return true;
+}
+
+bool LookupCache::Drop(Ino parent) {
+    RETURN_FALSE_IF_DISABLED();
+    WriteLockGuard lk(rwlock_);
+    std::shared_ptr<DirEntries> dir;
+    bool yes = lru_->Get(parent, &dir);
+    if (yes) {
+        Delete(parent, dir);
+    }
     return true;
 }
 
@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "src/common/lru_cache.h"
 #include "curvefs/src/client/common/config.h"
@@ -42,6 +43,9 @@ using ::curvefs::client::common::LookupCacheOption;
 
 // memory cache for lookup result, now we only support cache negative result,
 // and other positive entry will be cached in kernel.
+//
+// the negative entries are grouped by directory, and all entries of
+// a directory will be dropped once its modified time changed.
 class LookupCache {
  public:
     struct CacheEntry {
@@ -49,23 +53,35 @@ class LookupCache {
         TimeSpec expireTime;
     };
 
-    using LRUType = LRUCache<std::string, CacheEntry>;
+    struct DirEntries {
+        TimeSpec mtime;
+        std::unordered_map<std::string, CacheEntry> entries;
+    };
+
+    using LRUType = LRUCache<Ino, std::shared_ptr<DirEntries>>;
 
  public:
     explicit LookupCache(LookupCacheOption option);
 
-    bool Get(Ino parent, const std::string& name);
+    // |mtime| is the modified time of parent which we known currently
+    bool Get(Ino parent, const std::string& name, TimeSpec mtime);
 
-    bool Put(Ino parent, const std::string& name);
+    bool Put(Ino parent, const std::string& name, TimeSpec mtime);
 
     bool Delete(Ino parent, const std::string& name);
 
+    // drop all negative entries of the directory
+    bool Drop(Ino parent);
+
  private:
-    std::string CacheKey(Ino parent, const std::string& name);
+    void Delete(Ino parent, const std::shared_ptr<DirEntries>& dir);
+
+    void Evit(size_t size);
 
  private:
     bool enable_;
     RWLock rwlock_;
+    size_t nentries_;
     LookupCacheOption option_;
     std::shared_ptr<LRUType> lru_;
 };
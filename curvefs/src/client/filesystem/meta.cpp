@@ -101,16 +101,39 @@ std::string StrMode(uint16_t mode) {
 
 namespace {
 
-std::string Attr2Str(const InodeAttr& attr) {
-    if (!attr.IsInitialized()) {
+AttrSummary Summarize(const InodeAttr& attr) {
+    AttrSummary summary{};
+    summary.valid = attr.IsInitialized();
+    if (!summary.valid) {
+        return summary;
+    }
+
+    summary.ino = attr.inodeid();
+    summary.mode = attr.mode();
+    summary.nlink = attr.nlink();
+    summary.uid = attr.uid();
+    summary.gid = attr.gid();
+    summary.atime = attr.atime();
+    summary.mtime = attr.mtime();
+    summary.ctime = attr.ctime();
+    summary.length = attr.length();
+    return summary;
+}
+
+std::string Summary2Str(AttrSummary attr) {
+    if (!attr.valid) {
         return "";
     }
 
     return absl::StrFormat(" (%d,[%s:0%06o,%d,%d,%d,%d,%d,%d,%d])",
-        attr.inodeid(), StrMode(attr.mode()).c_str(), attr.mode(), attr.nlink(),
-        attr.uid(), attr.gid(),
-        attr.atime(), attr.mtime(), attr.ctime(),
-        attr.length());
+        attr.ino, StrMode(attr.mode).c_str(), attr.mode, attr.nlink,
+        attr.uid, attr.gid,
+        attr.atime, attr.mtime, attr.ctime,
+        attr.length);
+}
+
+std::string Attr2Str(const InodeAttr& attr) {
+    return Summary2Str(Summarize(attr));
 }
 
 }  // namespace
@@ -127,6 +150,18 @@ std::string StrAttr(InodeAttr attr) {
     return Attr2Str(attr);
 }
 
+logger::DeferredArg<AttrSummary> LogEntry(const EntryOut& entryOut) {
+    return LogAttr(entryOut.attr);
+}
+
+logger::DeferredArg<AttrSummary> LogAttr(const AttrOut& attrOut) {
+    return LogAttr(attrOut.attr);
+}
+
+logger::DeferredArg<AttrSummary> LogAttr(const InodeAttr& attr) {
+    return { Summarize(attr), &Summary2Str };
+}
+
 }  // namespace filesystem
 }  // namespace client
 }  // namespace curvefs
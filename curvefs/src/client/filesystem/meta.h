@@ -33,6 +33,7 @@
 #include "curvefs/src/client/fuse_common.h"
 #include "curvefs/src/client/dir_buffer.h"
 #include "curvefs/src/client/inode_wrapper.h"
+#include "curvefs/src/client/logger/access_log.h"
 
 namespace curvefs {
 namespace client {
@@ -173,6 +174,32 @@ std::string StrAttr(AttrOut attrOut);
 
 std::string StrAttr(InodeAttr attr);
 
+// The attribute printed by access log, it's copied on the operation
+// thread and formatted by the access log writer.
+struct AttrSummary {
+    bool valid;
+    uint64_t ino;
+    uint32_t mode;
+    uint32_t nlink;
+    uint32_t uid;
+    uint32_t gid;
+    uint64_t atime;
+    uint64_t mtime;
+    uint64_t ctime;
+    uint64_t length;
+};
+
+// the mode which is formatted by StrMode() in the access log writer
+inline logger::DeferredArg<uint16_t> LogMode(uint16_t mode) {
+    return { mode, &StrMode };
+}
+
+logger::DeferredArg<AttrSummary> LogEntry(const EntryOut& entryOut);
+
+logger::DeferredArg<AttrSummary> LogAttr(const AttrOut& attrOut);
+
+logger::DeferredArg<AttrSummary> LogAttr(const InodeAttr& attr);
+
 }  // namespace filesystem
 }  // namespace client
 }  // namespace curvefs
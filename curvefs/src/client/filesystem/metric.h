@@ -65,6 +65,23 @@ class OpenfilesMetric {
     Metric metric_;
 };
 
+class DeferSyncMetric {
+ public:
+    DeferSyncMetric() = default;
+
+    void AddCoalesced(int64_t n) {
+        metric_.ncoalesced << n;
+    }
+
+ private:
+    struct Metric {
+        Metric() : ncoalesced("filesystem_defersync", "ncoalesced") {}
+        bvar::Adder<int64_t> ncoalesced;
+    };
+
+    Metric metric_;
+};
+
 }  // namespace filesystem
 }  // namespace client
 }  // namespace curvefs
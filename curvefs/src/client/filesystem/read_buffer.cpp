@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "curvefs/src/client/filesystem/read_buffer.h"
+
+namespace curvefs {
+namespace client {
+namespace filesystem {
+
+ReadBuffer::ReadBuffer()
+    : size_(0),
+      data_(nullptr),
+      ranges_(),
+      bufvec_(nullptr) {}
+
+ReadBuffer::~ReadBuffer() {
+    DropRanges();
+}
+
+char* ReadBuffer::Allocate(size_t size) {
+    DropRanges();
+    data_.reset(new char[size]);
+    size_ = size;
+    return data_.get();
+}
+
+void ReadBuffer::AddFile(size_t offset, int fd, off_t pos, size_t length) {
+    ranges_.emplace_back(Range{ offset, length, fd, pos, nullptr, nullptr });
+}
+
+void ReadBuffer::AddMemory(size_t offset, const char* mem, size_t length,
+                           std::shared_ptr<void> holder) {
+    ranges_.emplace_back(
+        Range{ offset, length, -1, 0, mem, std::move(holder) });
+}
+
+void ReadBuffer::DropRanges() {
+    for (const auto& range : ranges_) {
+        if (range.fd >= 0) {
+            ::close(range.fd);
+        }
+    }
+    ranges_.clear();
+}
+
+struct fuse_bufvec* ReadBuffer::ToBufvec() {
+    std::sort(ranges_.begin(), ranges_.end(),
+              [](const Range& lhs, const Range& rhs) {
+                  return lhs.offset < rhs.offset;
+              });
+
+    // at most one memory range before every range, plus the tail
+    size_t count = ranges_.size() * 2 + 1;
+    bufvec_.reset(new char[sizeof(struct fuse_bufvec) +
+                           (count - 1) * sizeof(struct fuse_buf)]);
+    auto bufvec = reinterpret_cast<struct fuse_bufvec*>(bufvec_.get());
+    *bufvec = FUSE_BUFVEC_INIT(0);
+    bufvec->count = 0;
+
+    auto addMemory = [&](const char* mem, size_t length) {
+        if (length == 0) {
+            return;
+        }
+        struct fuse_buf* buf = &bufvec->buf[bufvec->count++];
+        buf->size = length;
+        buf->flags = static_cast<enum fuse_buf_flags>(0);
+        buf->mem = const_cast<char*>(mem);
+        buf->fd = -1;
+        buf->pos = 0;
+    };
+
+    size_t offset = 0;
+    for (const auto& range : ranges_) {
+        if (range.offset >= size_) {
+            break;
+        }
+        CHECK(range.offset >= offset);
+        addMemory(data_.get() + offset, range.offset - offset);
+
+        size_t length = std::min(range.length, size_ - range.offset);
+        if (range.fd < 0) {
+            addMemory(range.mem, length);
+        } else {
+            struct fuse_buf* buf = &bufvec->buf[bufvec->count++];
+            buf->size = length;
+            buf->flags = static_cast<enum fuse_buf_flags>(
+                FUSE_BUF_IS_FD | FUSE_BUF_FD_SEEK);
+            buf->mem = nullptr;
+            buf->fd = range.fd;
+            buf->pos = range.pos;
+        }
+        offset = range.offset + length;
+    }
+    addMemory(data_.get() + offset, size_ - offset);
+
+    if (bufvec->count == 0) {  // empty reply
+        *bufvec = FUSE_BUFVEC_INIT(0);
+        bufvec->buf[0].mem = data_.get();
+    }
+    return bufvec;
+}
+
+}  // namespace filesystem
+}  // namespace client
+}  // namespace curvefs
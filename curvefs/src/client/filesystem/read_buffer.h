@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_FILESYSTEM_READ_BUFFER_H_
+#define CURVEFS_SRC_CLIENT_FILESYSTEM_READ_BUFFER_H_
+
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "curvefs/src/client/fuse_common.h"
+
+namespace curvefs {
+namespace client {
+namespace filesystem {
+
+// ReadBuffer holds the data which will be replied to a fuse read request.
+//
+// The data is laid out in a memory buffer, but some ranges of it can be
+// served by local cache files or by memory owned by others instead.
+// File ranges are replied with file descriptors so that the kernel can
+// splice the page cache into the fuse device, and shared memory ranges
+// are replied in place, neither of them is copied into the buffer.
+class ReadBuffer {
+ public:
+    ReadBuffer();
+
+    ~ReadBuffer();
+
+    ReadBuffer(const ReadBuffer&) = delete;
+
+    ReadBuffer& operator=(const ReadBuffer&) = delete;
+
+    // allocate the memory buffer, the previous one will be discarded
+    char* Allocate(size_t size);
+
+    char* Data() const { return data_.get(); }
+
+    // the range [offset, offset + length) of buffer is served by |fd|
+    // from position |pos|, the |fd| will be closed by ReadBuffer.
+    void AddFile(size_t offset, int fd, off_t pos, size_t length);
+
+    // the range [offset, offset + length) of buffer is served by |mem|,
+    // which is kept alive by |holder| until the ReadBuffer is destroyed.
+    void AddMemory(size_t offset, const char* mem, size_t length,
+                   std::shared_ptr<void> holder);
+
+    // drop all ranges served by files or shared memory,
+    // the memory buffer is used only
+    void DropRanges();
+
+    size_t NumRanges() const { return ranges_.size(); }
+
+    void SetSize(size_t size) { size_ = size; }
+
+    size_t Size() const { return size_; }
+
+    // the returned bufvec is valid until the ReadBuffer is destroyed
+    struct fuse_bufvec* ToBufvec();
+
+ private:
+    struct Range {
+        size_t offset;
+        size_t length;
+        int fd;  // -1 if served by |mem|
+        off_t pos;
+        const char* mem;
+        std::shared_ptr<void> holder;
+    };
+
+    size_t size_;
+    std::unique_ptr<char[]> data_;
+    std::vector<Range> ranges_;
+    std::unique_ptr<char[]> bufvec_;
+};
+
+}  // namespace filesystem
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_FILESYSTEM_READ_BUFFER_H_
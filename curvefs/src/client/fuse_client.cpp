@@ -282,6 +282,19 @@ void FuseClient::FuseOpDestroy(void *userdata) {
               << " success!";
 }
 
+CURVEFS_ERROR FuseClient::FuseOpReadZeroCopy(fuse_req_t req,
+                                             fuse_ino_t ino,
+                                             size_t size,
+                                             off_t off,
+                                             struct fuse_file_info* fi,
+                                             ReadBuffer* buffer) {
+    size_t rSize = 0;
+    char* data = buffer->Allocate(size);
+    CURVEFS_ERROR rc = FuseOpRead(req, ino, size, off, fi, data, &rSize);
+    buffer->SetSize(rSize);
+    return rc;
+}
+
 CURVEFS_ERROR FuseClient::FuseOpLookup(fuse_req_t req,
                                        fuse_ino_t parent,
                                        const char* name,
@@ -432,6 +445,7 @@ CURVEFS_ERROR FuseClient::MakeNode(
         dentry.set_flag(DentryFlag::TYPE_FILE_FLAG);
     }
     ret = dentryManager_->CreateDentry(dentry);
+    fs_->InvalidateDir(parent);
     if (ret != CURVEFS_ERROR::OK) {
         LOG(ERROR) << "dentryManager_ CreateDentry fail, ret = " << ret
                    << ", parent = " << parent << ", name = " << name
@@ -500,6 +514,7 @@ CURVEFS_ERROR FuseClient::FuseOpRmDir(fuse_req_t req, fuse_ino_t parent,
 CURVEFS_ERROR FuseClient::DeleteNode(uint64_t ino, fuse_ino_t parent,
                              const char* name, FsFileType type) {
     CURVEFS_ERROR ret = dentryManager_->DeleteDentry(parent, name, type);
+    fs_->InvalidateDir(parent);
     if (ret != CURVEFS_ERROR::OK) {
         LOG(ERROR) << "dentryManager_ DeleteDentry fail, ret = " << ret
                    << ", parent = " << parent << ", name = " << name;
@@ -593,6 +608,7 @@ CURVEFS_ERROR FuseClient::CreateManageNode(fuse_req_t req,
         dentry.set_flag(DentryFlag::TYPE_FILE_FLAG);
     }
     ret = dentryManager_->CreateDentry(dentry);
+    fs_->InvalidateDir(parent);
     if (ret != CURVEFS_ERROR::OK) {
         LOG(ERROR) << "dentryManager_ CreateDentry fail, ret = " << ret
                    << ", parent = " << parent << ", name = " << name
@@ -910,8 +926,15 @@ CURVEFS_ERROR FuseClient::FuseOpRename(fuse_req_t req, fuse_ino_t parent,
     // Do not move LinkDestParentInode behind CommitTx.
     // If so, the nlink will be lost when the machine goes down
     RETURN_IF_UNSUCCESS(LinkDestParentInode);
-    RETURN_IF_UNSUCCESS(PrepareTx);
-    RETURN_IF_UNSUCCESS(CommitTx);
+    if (option_.enableRenameInCopyset) {
+        RETURN_IF_UNSUCCESS(RenameInCopyset);
+    }
+    if (!renameOp.IsRenamedInCopyset()) {
+        RETURN_IF_UNSUCCESS(PrepareTx);
+        RETURN_IF_UNSUCCESS(CommitTx);
+    }
+    fs_->InvalidateDir(parent);
+    fs_->InvalidateDir(newparent);
     VLOG(3) << "FuseOpRename [success]: " << renameOp.DebugString();
     // Do not check UnlinkSrcParentInode, beause rename is already success
     renameOp.UnlinkSrcParentInode();
@@ -1206,6 +1229,7 @@ CURVEFS_ERROR FuseClient::FuseOpSymlink(fuse_req_t req,
     dentry.set_name(name);
     dentry.set_type(inodeWrapper->GetType());
     ret = dentryManager_->CreateDentry(dentry);
+    fs_->InvalidateDir(parent);
     if (ret != CURVEFS_ERROR::OK) {
         LOG(ERROR) << "dentryManager_ CreateDentry fail, ret = " << ret
                    << ", parent = " << parent << ", name = " << name
@@ -1269,6 +1293,7 @@ CURVEFS_ERROR FuseClient::FuseOpLink(fuse_req_t req,
     dentry.set_name(newname);
     dentry.set_type(inodeWrapper->GetType());
     ret = dentryManager_->CreateDentry(dentry);
+    fs_->InvalidateDir(newparent);
     if (ret != CURVEFS_ERROR::OK) {
         LOG(ERROR) << "dentryManager_ CreateDentry fail, ret = " << ret
                    << ", parent = " << newparent << ", name = " << newname;
@@ -1371,6 +1396,7 @@ FuseClient::SetMountStatus(const struct MountOption *mountOption) {
     // init fsname and mountpoint
     leaseExecutor_->SetFsName(fsName);
     leaseExecutor_->SetMountPoint(mountpoint_);
+    leaseExecutor_->SetMetaLease(fs_->BorrowMember().metaLease);
     if (!leaseExecutor_->Start()) {
         return CURVEFS_ERROR::INTERNAL;
     }
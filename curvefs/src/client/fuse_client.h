@@ -46,6 +46,7 @@
 #include "curvefs/src/client/filesystem/error.h"
 #include "curvefs/src/client/filesystem/filesystem.h"
 #include "curvefs/src/client/filesystem/meta.h"
+#include "curvefs/src/client/filesystem/read_buffer.h"
 #include "curvefs/src/client/fuse_common.h"
 #include "curvefs/src/client/inode_cache_manager.h"
 #include "curvefs/src/client/lease/lease_excutor.h"
@@ -87,6 +88,7 @@ using ::curvefs::client::filesystem::AttrOut;
 using ::curvefs::client::filesystem::EntryOut;
 using ::curvefs::client::filesystem::FileOut;
 using ::curvefs::client::filesystem::FileSystem;
+using ::curvefs::client::filesystem::ReadBuffer;
 using rpcclient::MDSBaseClient;
 using rpcclient::MdsClient;
 using rpcclient::MdsClientImpl;
@@ -157,6 +159,14 @@ class FuseClient {
                                      struct fuse_file_info* fi, char* buffer,
                                      size_t* rSize) = 0;
 
+    // Read data into |buffer| which will be replied by fuse_reply_data,
+    // implementation can reference the local cache files instead of
+    // copying them, default is the same as FuseOpRead.
+    virtual CURVEFS_ERROR FuseOpReadZeroCopy(fuse_req_t req, fuse_ino_t ino,
+                                             size_t size, off_t off,
+                                             struct fuse_file_info* fi,
+                                             ReadBuffer* buffer);
+
     virtual CURVEFS_ERROR FuseOpLookup(fuse_req_t req,
                                        fuse_ino_t parent,
                                        const char* name,
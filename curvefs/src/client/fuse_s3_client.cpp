@@ -85,7 +85,8 @@ CURVEFS_ERROR FuseS3Client::Init(const FuseClientOption &option) {
     auto fsCacheManager = std::make_shared<FsCacheManager>(
         dynamic_cast<S3ClientAdaptorImpl *>(s3Adaptor_.get()),
         opt.s3Opt.s3ClientAdaptorOpt.readCacheMaxByte, writeCacheMaxByte,
-        opt.s3Opt.s3ClientAdaptorOpt.readCacheThreads, kvClientManager_);
+        opt.s3Opt.s3ClientAdaptorOpt.readCacheThreads, kvClientManager_,
+        opt.s3Opt.s3ClientAdaptorOpt.cacheEvictPolicy == "arc");
     if (opt.s3Opt.s3ClientAdaptorOpt.diskCacheOpt.diskCacheType !=
         DiskCacheType::Disable) {
         auto s3DiskCacheClient = std::make_shared<S3ClientImpl>();
@@ -243,6 +244,35 @@ CURVEFS_ERROR FuseS3Client::FuseOpRead(fuse_req_t req, fuse_ino_t ino,
                                        struct fuse_file_info *fi, char *buffer,
                                        size_t *rSize) {
     (void)req;
+    auto read = [&](off_t offset, size_t len) {
+        return s3Adaptor_->Read(ino, offset, len, buffer);
+    };
+    return DoRead(ino, size, off, fi, read, rSize);
+}
+
+CURVEFS_ERROR FuseS3Client::FuseOpReadZeroCopy(fuse_req_t req, fuse_ino_t ino,
+                                               size_t size, off_t off,
+                                               struct fuse_file_info *fi,
+                                               ReadBuffer *buffer) {
+    // the fd can only be spliced into fuse device if splice is enabled,
+    // otherwise libfuse will read it into memory which is no better.
+    if (!option_.enableFuseSplice) {
+        return FuseClient::FuseOpReadZeroCopy(req, ino, size, off, fi, buffer);
+    }
+
+    size_t rSize = 0;
+    buffer->Allocate(size);
+    auto read = [&](off_t offset, size_t len) {
+        return s3Adaptor_->ReadZeroCopy(ino, offset, len, buffer);
+    };
+    CURVEFS_ERROR rc = DoRead(ino, size, off, fi, read, &rSize);
+    buffer->SetSize(rSize);
+    return rc;
+}
+
+CURVEFS_ERROR FuseS3Client::DoRead(fuse_ino_t ino, size_t size, off_t off,
+                                   struct fuse_file_info *fi,
+                                   const ReadFunc &read, size_t *rSize) {
     // check align
     if (fi->flags & O_DIRECT) {
         if (!(is_aligned(off, DirectIOAlignment) &&
@@ -273,7 +303,7 @@ CURVEFS_ERROR FuseS3Client::FuseOpRead(fuse_req_t req, fuse_ino_t ino,
     }
 
     // Read do not change inode. so we do not get lock here.
-    int rRet = s3Adaptor_->Read(ino, off, len, buffer);
+    int rRet = read(off, len);
     if (rRet < 0) {
         LOG(ERROR) << "s3Adaptor_ read failed, ret = " << rRet;
         return CURVEFS_ERROR::INTERNAL;
@@ -24,6 +24,7 @@
 #ifndef CURVEFS_SRC_CLIENT_FUSE_S3_CLIENT_H_
 #define CURVEFS_SRC_CLIENT_FUSE_S3_CLIENT_H_
 
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
@@ -94,6 +95,11 @@ class FuseS3Client : public FuseClient {
         char *buffer,
         size_t *rSize) override;
 
+    CURVEFS_ERROR FuseOpReadZeroCopy(fuse_req_t req,
+        fuse_ino_t ino, size_t size, off_t off,
+        struct fuse_file_info *fi,
+        ReadBuffer *buffer) override;
+
     CURVEFS_ERROR FuseOpCreate(fuse_req_t req,
                                fuse_ino_t parent,
                                const char* name,
@@ -128,6 +134,14 @@ class FuseS3Client : public FuseClient {
  private:
     bool InitKVCache(const KVClientManagerOpt &opt);
 
+    // read |len| bytes at |off| from s3 adaptor, return read size or
+    // error code (< 0)
+    using ReadFunc = std::function<int(off_t offset, size_t len)>;
+
+    CURVEFS_ERROR DoRead(fuse_ino_t ino, size_t size, off_t off,
+                         struct fuse_file_info *fi, const ReadFunc &read,
+                         size_t *rSize);
+
     void FlushData() override;
 
  private:
@@ -118,6 +118,7 @@ CURVEFS_ERROR FuseVolumeClient::FuseOpInit(void *userdata,
         volOpts_.allocatorOption.bitmapAllocatorOption.smallAllocProportion;
     option.threshold = volOpts_.threshold;
     option.releaseInterSec = volOpts_.releaseInterSec;
+    option.prefetchWatermark = volOpts_.prefetchWatermark;
 
     spaceManager_ = absl::make_unique<SpaceManagerImpl>(option, mdsClient_,
                                                         blockDeviceClient_);
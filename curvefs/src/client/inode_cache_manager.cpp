@@ -323,6 +323,10 @@ void InodeCacheManagerImpl::ShipToFlush(
     deferSync_->Push(inode);
 }
 
+void InodeCacheManagerImpl::SyncPending(bool force) {
+    deferSync_->SyncPending(force);
+}
+
 CURVEFS_ERROR
 InodeCacheManagerImpl::RefreshData(std::shared_ptr<InodeWrapper> &inode,
                                    bool streaming) {
@@ -114,6 +114,10 @@ class InodeCacheManager {
     virtual void ShipToFlush(
         const std::shared_ptr<InodeWrapper> &inodeWrapper) = 0;
 
+    // Ship inodes flushed by data flush without waiting for defer sync
+    // window, see DeferSync::SyncPending()
+    virtual void SyncPending(bool force) = 0;
+
  protected:
     uint32_t fsId_;
 };
@@ -183,6 +187,8 @@ class InodeCacheManagerImpl : public InodeCacheManager,
     void ShipToFlush(
         const std::shared_ptr<InodeWrapper> &inodeWrapper) override;
 
+    void SyncPending(bool force) override;
+
  private:
     CURVEFS_ERROR RefreshData(std::shared_ptr<InodeWrapper> &inode,  // NOLINT
                               bool streaming = true);
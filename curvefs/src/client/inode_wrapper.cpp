@@ -222,19 +222,34 @@ CURVEFS_ERROR InodeWrapper::SyncS3ChunkInfo(bool internal) {
 
 void InodeWrapper::AsyncFlushAttr(MetaServerClientDone* done,
                                   bool /*internal*/) {
+    InodeUpdate update;
+    if (PrepareAsyncAttr(done, &update)) {
+        AsyncUpdate(std::move(update));
+    }
+}
+
+bool InodeWrapper::PrepareAsyncAttr(MetaServerClientDone* done,
+                                    InodeUpdate* update) {
     if (dirty_) {
         LockSyncingInode();
-        metaClient_->UpdateInodeWithOutNlinkAsync(
-            inode_.fsid(), inode_.inodeid(), dirtyAttr_,
-            new UpdateInodeAsyncDone(shared_from_this(), done));
+        update->inodeId = inode_.inodeid();
+        update->attr = dirtyAttr_;
+        update->done = new UpdateInodeAsyncDone(shared_from_this(), done);
         dirtyAttr_.Clear();
-        return;
+        return true;
     }
 
     if (done != nullptr) {
         done->SetMetaStatusCode(MetaStatusCode::OK);
         done->Run();
     }
+    return false;
+}
+
+void InodeWrapper::AsyncUpdate(InodeUpdate&& update) {
+    metaClient_->UpdateInodeWithOutNlinkAsync(
+        inode_.fsid(), update.inodeId, update.attr, update.done,
+        std::move(update.indices));
 }
 
 void InodeWrapper::FlushS3ChunkInfoAsync() {
@@ -478,27 +493,33 @@ void InodeWrapper::Async(MetaServerClientDone *done, bool internal) {
 
 void InodeWrapper::AsyncFlushAttrAndExtents(MetaServerClientDone *done,
                                             bool /*internal*/) {
+    InodeUpdate update;
+    if (PrepareAsyncAttrAndExtents(done, &update)) {
+        AsyncUpdate(std::move(update));
+    }
+}
+
+bool InodeWrapper::PrepareAsyncAttrAndExtents(MetaServerClientDone *done,
+                                              InodeUpdate *update) {
     VLOG(9) << "async inode: " << inode_.ShortDebugString()
             << ", is dirty: " << dirty_
             << ", has dirty extents: " << extentCache_.HasDirtyExtents();
     if (dirty_ || extentCache_.HasDirtyExtents()) {
         LockSyncingInode();
         syncingVolumeExtentsMtx_.lock();
-        DataIndices indices;
         if (extentCache_.HasDirtyExtents()) {
-            indices.volumeExtents = extentCache_.GetDirtyExtents();
+            update->indices.volumeExtents = extentCache_.GetDirtyExtents();
             VLOG(9) << "aync inode: " << inode_.ShortDebugString()
                     << ", volume extents: "
-                    << indices.volumeExtents->ShortDebugString();
+                    << update->indices.volumeExtents->ShortDebugString();
         }
 
-        metaClient_->UpdateInodeWithOutNlinkAsync(
-            inode_.fsid(), inode_.inodeid(), dirtyAttr_,
-            new UpdateInodeAttrAndExtentClosure{shared_from_this(), done},
-            std::move(indices));
-
+        update->inodeId = inode_.inodeid();
+        update->attr = dirtyAttr_;
+        update->done =
+            new UpdateInodeAttrAndExtentClosure{shared_from_this(), done};
         dirtyAttr_.Clear();
-        return;
+        return true;
     }
 
     // nothing to update
@@ -506,6 +527,7 @@ void InodeWrapper::AsyncFlushAttrAndExtents(MetaServerClientDone *done,
         done->SetMetaStatusCode(MetaStatusCode::OK);
         done->Run();
     }
+    return false;
 }
 
 CURVEFS_ERROR InodeWrapper::SyncS3(bool internal) {
@@ -568,26 +590,78 @@ class UpdateInodeAsyncS3Done : public MetaServerClientDone {
 
 void InodeWrapper::AsyncS3(MetaServerClientDone *done, bool internal) {
     (void)internal;
+    InodeUpdate update;
+    if (PrepareAsyncS3(done, &update)) {
+        AsyncUpdate(std::move(update));
+    }
+}
+
+bool InodeWrapper::PrepareAsyncS3(MetaServerClientDone *done,
+                                  InodeUpdate *update) {
     if (dirty_ || !s3ChunkInfoAdd_.empty()) {
         LockSyncingInode();
         LockSyncingS3ChunkInfo();
-        DataIndices indices;
+        update->inodeId = inode_.inodeid();
+        update->attr = dirtyAttr_;
         if (!s3ChunkInfoAdd_.empty()) {
-            indices.s3ChunkInfoMap = std::move(s3ChunkInfoAdd_);
+            update->indices.s3ChunkInfoMap = std::move(s3ChunkInfoAdd_);
         }
-        metaClient_->UpdateInodeWithOutNlinkAsync(
-            inode_.fsid(), inode_.inodeid(), dirtyAttr_,
-            new UpdateInodeAsyncS3Done{shared_from_this(), done},
-            std::move(indices));
+        update->done = new UpdateInodeAsyncS3Done{shared_from_this(), done};
         dirtyAttr_.Clear();
         ClearS3ChunkInfoAdd();
-        return;
+        return true;
     }
 
     if (done != nullptr) {
         done->SetMetaStatusCode(MetaStatusCode::OK);
         done->Run();
     }
+    return false;
+}
+
+bool InodeWrapper::PrepareAsync(MetaServerClientDone *done,
+                                InodeUpdate *update) {
+    switch (inode_.type()) {
+        case FsFileType::TYPE_S3:
+            return PrepareAsyncS3(done, update);
+        case FsFileType::TYPE_FILE:
+            return PrepareAsyncAttrAndExtents(done, update);
+        case FsFileType::TYPE_DIRECTORY:
+            FALLTHROUGH_INTENDED;
+        case FsFileType::TYPE_SYM_LINK:
+            return PrepareAsyncAttr(done, update);
+    }
+
+    CHECK(false) << "Unexpected inode type: " << inode_.type() << ", "
+                 << inode_.ShortDebugString();
+    return false;
+}
+
+void InodeWrapper::AsyncBatch(
+    const std::vector<std::shared_ptr<InodeWrapper>> &inodes,
+    const std::vector<MetaServerClientDone *> &dones) {
+    CHECK_EQ(inodes.size(), dones.size());
+    if (inodes.empty()) {
+        return;
+    }
+
+    std::vector<InodeUpdate> updates;
+    updates.reserve(inodes.size());
+    for (size_t i = 0; i < inodes.size(); i++) {
+        const auto &inode = inodes[i];
+        curve::common::UniqueLock lk(inode->mtx_);
+        VLOG(9) << "async inode in batch: " << inode->inode_.ShortDebugString();
+        InodeUpdate update;
+        if (inode->PrepareAsync(dones[i], &update)) {
+            updates.emplace_back(std::move(update));
+        }
+    }
+
+    if (!updates.empty()) {
+        const auto &inode = inodes.front();
+        inode->metaClient_->BatchUpdateInodeWithOutNlinkAsync(
+            inode->GetFsId(), std::move(updates));
+    }
 }
 
 CURVEFS_ERROR InodeWrapper::RefreshVolumeExtent() {
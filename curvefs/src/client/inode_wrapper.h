@@ -31,6 +31,7 @@
 #include <utility>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "curvefs/src/common/define.h"
 #include "curvefs/proto/metaserver.pb.h"
@@ -64,6 +65,7 @@ enum class InodeStatus {
 using rpcclient::MetaServerClient;
 using rpcclient::MetaServerClientImpl;
 using rpcclient::MetaServerClientDone;
+using rpcclient::InodeUpdate;
 using metric::S3ChunkInfoMetric;
 using common::NlinkChange;
 using curve::common::TimeUtility;
@@ -231,6 +233,15 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
 
     void AsyncS3(MetaServerClientDone *done, bool internal = false);
 
+    // Flush a group of inodes asynchronously, dirty attributes and pending
+    // data indices (s3chunkinfos or volume extents) of inodes in the same
+    // partition are shipped in one rpc instead of one rpc per inode.
+    // |dones[i]| is the closure of |inodes[i]|, and can be nullptr.
+    // REQUIRES: |mtx_| of each inode is NOT held
+    static void AsyncBatch(
+        const std::vector<std::shared_ptr<InodeWrapper>> &inodes,
+        const std::vector<MetaServerClientDone *> &dones);
+
     CURVEFS_ERROR SyncAttr(bool internal = false);
 
     void AsyncFlushAttr(MetaServerClientDone *done, bool internal);
@@ -383,6 +394,27 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
     // REQUIRES: |mtx_| is held
     void AsyncFlushAttrAndExtents(MetaServerClientDone *done, bool internal);
 
+    // Detach dirty attributes and pending data indices into |update| by
+    // inode type, returns false and runs |done| if there is nothing to flush.
+    // REQUIRES: |mtx_| is held
+    bool PrepareAsync(MetaServerClientDone *done, InodeUpdate *update);
+
+    // Detach dirty attributes and pending s3chunkinfos into |update|.
+    // REQUIRES: |mtx_| is held
+    bool PrepareAsyncS3(MetaServerClientDone *done, InodeUpdate *update);
+
+    // Detach dirty attributes and volume extents into |update|.
+    // REQUIRES: |mtx_| is held
+    bool PrepareAsyncAttrAndExtents(MetaServerClientDone *done,
+                                    InodeUpdate *update);
+
+    // Detach dirty attributes into |update|.
+    // REQUIRES: |mtx_| is held
+    bool PrepareAsyncAttr(MetaServerClientDone *done, InodeUpdate *update);
+
+    // Ship a prepared update with its own rpc.
+    void AsyncUpdate(InodeUpdate &&update);
+
  private:
     friend class UpdateVolumeExtentClosure;
     friend class UpdateInodeAttrAndExtentClosure;
@@ -25,11 +25,32 @@
 #include <libmemcached-1.0/types/return.h>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace curvefs {
 
 namespace client {
 
+/**
+ * A get request of batch, value in [offset, offset + length) of the key
+ * will be copied to |value| if success.
+ */
+struct KVGetRequest {
+    std::string key;
+    char* value = nullptr;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+
+    bool res = false;
+    // actual length of value
+    uint64_t actLength = 0;
+    memcached_return_t retCode = MEMCACHED_NOTFOUND;
+
+    KVGetRequest(std::string k, char* v, uint64_t off, uint64_t len)
+        : key(std::move(k)), value(v), offset(off), length(len) {}
+};
+
 /**
  * Single client to kv interface.
  */
@@ -54,6 +75,18 @@ class KVClient {
     virtual bool Get(const std::string& key, char* value, uint64_t offset,
                      uint64_t length, std::string* errorlog,
                      uint64_t* actLength, memcached_return_t* retCod) = 0;
+
+    /**
+     * @brief: get a batch of keys, the result is filled in each request.
+     *         the default one gets them one by one.
+     */
+    virtual void MGet(std::vector<KVGetRequest>* requests) {
+        std::string errorlog;
+        for (auto& req : *requests) {
+            req.res = Get(req.key, req.value, req.offset, req.length,
+                          &errorlog, &req.actLength, &req.retCode);
+        }
+    }
 };
 
 }  // namespace client
@@ -22,9 +22,12 @@
 
 #include "curvefs/src/client/kvclient/kvclient_manager.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "curvefs/src/client/metric/client_metric.h"
 #include "src/client/client_metric.h"
 #include "src/common/concurrent/count_down_event.h"
@@ -52,21 +55,41 @@ bool KVClientManager::Init(const KVClientManagerOpt& config,
                            const std::shared_ptr<KVClient>& kvclient,
                            const std::string& fsName) {
     client_ = kvclient;
+    subBlockSize_ = config.subBlockSize;
     kvClientManagerMetric_ = absl::make_unique<KVClientManagerMetric>(fsName);
-    return threadPool_.Start(config.setThreadPooln) == 0;
+    return threadPool_.Start(config.setThreadPooln) == 0 &&
+           getThreadPool_.Start(config.getThreadPooln) == 0;
 }
 
 void KVClientManager::Uninit() {
     client_->UnInit();
     threadPool_.Stop();
+    getThreadPool_.Stop();
+}
+
+std::string KVClientManager::SubBlockKey(const std::string& key,
+                                         uint64_t index) const {
+    return absl::StrCat(key, "@", index);
 }
 
 void KVClientManager::Set(std::shared_ptr<SetKVCacheTask> task) {
     kvClientManagerMetric_->setQueueSize << 1;
     threadPool_.Enqueue([task, this]() {
         std::string error_log;
-        task->res =
-            client_->Set(task->key, task->value, task->length, &error_log);
+        if (subBlockSize_ == 0) {
+            task->res =
+                client_->Set(task->key, task->value, task->length, &error_log);
+        } else {
+            uint64_t index = 0;
+            uint64_t pos = 0;
+            do {
+                uint64_t len = std::min(subBlockSize_, task->length - pos);
+                task->res = client_->Set(SubBlockKey(task->key, index),
+                                         task->value + pos, len, &error_log);
+                pos += len;
+                index++;
+            } while (task->res && pos < task->length);
+        }
         kvClientManagerMetric_->setQueueSize << -1;
         if (task->res) {
             kvClientManagerMetric_->count << 1;
@@ -97,34 +120,108 @@ void UpdateHitMissMetric(memcached_return_t retCode,
     }
 }
 
+void KVClientManager::AddGetRequest(
+    const std::string& key, char* value, uint64_t offset, uint64_t length,
+    std::vector<KVGetRequest>* requests) const {
+    if (subBlockSize_ == 0) {
+        requests->emplace_back(key, value, offset, length);
+        return;
+    }
+
+    const uint64_t end = offset + length;
+    uint64_t index = offset / subBlockSize_;
+    uint64_t pos = offset;
+    do {
+        const uint64_t subBlockStart = index * subBlockSize_;
+        const uint64_t len =
+            std::min(end, subBlockStart + subBlockSize_) - pos;
+        requests->emplace_back(SubBlockKey(key, index), value + (pos - offset),
+                               pos - subBlockStart, len);
+        pos += len;
+        index++;
+    } while (pos < end);
+}
+
+bool KVClientManager::MergeGetResult(const KVGetRequest* begin,
+                                     const KVGetRequest* end, uint64_t offset,
+                                     uint64_t length, uint64_t* actLength,
+                                     memcached_return_t* retCode) const {
+    for (const auto* req = begin; req != end; ++req) {
+        if (!req->res) {
+            *actLength = subBlockSize_ == 0 ? req->actLength : 0;
+            *retCode = req->retCode;
+            return false;
+        }
+    }
+
+    *retCode = MEMCACHED_SUCCESS;
+    if (subBlockSize_ == 0) {
+        *actLength = begin->actLength;
+    } else {
+        // length of the value is known up to the last sub-block
+        const uint64_t last =
+            (length == 0 ? offset : offset + length - 1) / subBlockSize_;
+        *actLength = last * subBlockSize_ + (end - 1)->actLength;
+    }
+    return true;
+}
+
 void KVClientManager::Get(std::shared_ptr<GetKVCacheTask> task) {
-    kvClientManagerMetric_->getQueueSize << 1;
-    threadPool_.Enqueue([task, this]() {
-        std::string error_log;
-        memcached_return_t retCode;
-        task->res = client_->Get(task->key, task->value, task->offset,
-                                 task->valueLength, &error_log, &task->length,
-                                 &retCode);
-        kvClientManagerMetric_->getQueueSize << -1;
-        UpdateHitMissMetric(retCode, kvClientManagerMetric_.get());
-        OnReturn(&kvClientManagerMetric_->get, task);
+    MGet({std::move(task)});
+}
+
+void KVClientManager::MGet(std::vector<std::shared_ptr<GetKVCacheTask>> tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+
+    kvClientManagerMetric_->getQueueSize << tasks.size();
+    getThreadPool_.Enqueue([tasks, this]() {
+        std::vector<KVGetRequest> requests;
+        std::vector<size_t> ends;
+        ends.reserve(tasks.size());
+        for (const auto& task : tasks) {
+            AddGetRequest(task->key, task->value, task->offset,
+                          task->valueLength, &requests);
+            ends.push_back(requests.size());
+        }
+
+        client_->MGet(&requests);
+        kvClientManagerMetric_->getQueueSize
+            << -static_cast<int64_t>(tasks.size());
+
+        size_t begin = 0;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            const auto& task = tasks[i];
+            memcached_return_t retCode;
+            task->res = MergeGetResult(
+                requests.data() + begin, requests.data() + ends[i],
+                task->offset, task->valueLength, &task->length, &retCode);
+            begin = ends[i];
+            UpdateHitMissMetric(retCode, kvClientManagerMetric_.get());
+            OnReturn(&kvClientManagerMetric_->get, task);
+        }
     });
 }
 
 void KVClientManager::Enqueue(std::shared_ptr<GetObjectAsyncContext> context) {
     auto task = [this, context]() { this->GetKvCache(context); };
-    threadPool_.Enqueue(task);
+    getThreadPool_.Enqueue(task);
 }
 
 int KVClientManager::GetKvCache(
     std::shared_ptr<GetObjectAsyncContext> context) {
     VLOG(9) << "GetKvCache start: " << context->key;
-    std::string error_log;
+    std::vector<KVGetRequest> requests;
+    AddGetRequest(context->key, context->buf, context->offset, context->len,
+                  &requests);
+    client_->MGet(&requests);
+
     memcached_return_t retCode;
     uint64_t actLength = 0;
     context->retCode =
-        !client_->Get(context->key, context->buf, context->offset, context->len,
-                      &error_log, &actLength, &retCode);
+        !MergeGetResult(requests.data(), requests.data() + requests.size(),
+                        context->offset, context->len, &actLength, &retCode);
     context->actualLen = actLength;
     context->cb(nullptr, context);
     VLOG(9) << "GetKvCache end: " << context->key << ", " << context->retCode
@@ -30,6 +30,7 @@
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "curvefs/src/client/common/config.h"
@@ -146,6 +147,12 @@ class KVClientManager {
 
     void Get(std::shared_ptr<GetKVCacheTask> task);
 
+    /**
+     * Get a batch of keys by one request to kv client asynchronously,
+     * the done of each task is called after the whole batch finished.
+     */
+    void MGet(std::vector<std::shared_ptr<GetKVCacheTask>> tasks);
+
     KVClientManagerMetric* GetMetricForTesting() {
         return kvClientManagerMetric_.get();
     }
@@ -156,8 +163,26 @@ class KVClientManager {
     void Uninit();
     int GetKvCache(std::shared_ptr<GetObjectAsyncContext> context);
 
+    // add request(s) for [offset, offset + length) of key,
+    // one for each sub-block if value is stored by sub-blocks
+    void AddGetRequest(const std::string& key, char* value, uint64_t offset,
+                       uint64_t length,
+                       std::vector<KVGetRequest>* requests) const;
+
+    // merge result of requests in [begin, end), which are added
+    // by one AddGetRequest
+    bool MergeGetResult(const KVGetRequest* begin, const KVGetRequest* end,
+                        uint64_t offset, uint64_t length, uint64_t* actLength,
+                        memcached_return_t* retCode) const;
+
+    std::string SubBlockKey(const std::string& key, uint64_t index) const;
+
  private:
+    // thread pool for set
     TaskThreadPool<bthread::Mutex, bthread::ConditionVariable> threadPool_;
+    // thread pool for get, so reads are not queued behind writes
+    TaskThreadPool<bthread::Mutex, bthread::ConditionVariable> getThreadPool_;
+    uint64_t subBlockSize_ = 0;
     std::shared_ptr<KVClient> client_;
     std::unique_ptr<KVClientManagerMetric> kvClientManagerMetric_;
 };
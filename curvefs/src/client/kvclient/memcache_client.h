@@ -29,7 +29,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "curvefs/proto/topology.pb.h"
@@ -42,12 +45,6 @@ namespace client {
 
 using curvefs::mds::topology::MemcacheClusterInfo;
 
-/**
- * only the threadpool will operate the kvclient,
- * for threadsafe and fast, we can make every thread has a client.
- */
-extern thread_local memcached_st *tcli;
-
 /**
  * MemCachedClient is a client to memcached cluster. You'd better
  * don't use it directly.
@@ -84,7 +81,8 @@ class MemCachedClient : public KVClient {
     MemCachedClient() : server_(nullptr) {
         client_ = memcached_create(nullptr);
     }
-    explicit MemCachedClient(memcached_st *cli) : client_(cli) {}
+    explicit MemCachedClient(memcached_st *cli)
+        : server_(nullptr), client_(cli) {}
     ~MemCachedClient() { UnInit(); }
 
     bool Init(const MemcacheClusterInfo& kvcachecluster,
@@ -106,6 +104,13 @@ class MemCachedClient : public KVClient {
     }
 
     void UnInit() override {
+        {
+            std::lock_guard<std::mutex> lk(poolMtx_);
+            for (auto* conn : idleConns_) {
+                memcached_free(conn);
+            }
+            idleConns_.clear();
+        }
         if (client_) {
             memcached_free(client_);
             client_ = nullptr;
@@ -115,11 +120,10 @@ class MemCachedClient : public KVClient {
     bool Set(const std::string& key, const char* value,
              const uint64_t value_len, std::string* errorlog) override {
         uint64_t start = butil::cpuwide_time_us();
-        if (nullptr == tcli) {
-            tcli = memcached_clone(nullptr, client_);
-        }
-        auto res = memcached_set(tcli, key.c_str(), key.length(), value,
+        memcached_st* conn = AcquireConn();
+        auto res = memcached_set(conn, key.c_str(), key.length(), value,
                                  value_len, 0, 0);
+        ReleaseConn(conn, res);
         if (MEMCACHED_SUCCESS == res) {
             VLOG(9) << "Set key = " << key << " OK";
             curve::client::CollectMetrics(&metric_->set, value_len,
@@ -127,8 +131,6 @@ class MemCachedClient : public KVClient {
             return true;
         }
         *errorlog = ResError(res);
-        memcached_free(tcli);
-        tcli = nullptr;
         LOG(ERROR) << "Set key = " << key << " error = " << *errorlog;
         metric_->set.eps.count << 1;
         return false;
@@ -138,16 +140,13 @@ class MemCachedClient : public KVClient {
              uint64_t length, std::string* errorlog, uint64_t* actLength,
              memcached_return_t* retCode) override {
         uint64_t start = butil::cpuwide_time_us();
-        if (nullptr == tcli) {
-            // multi thread use a memcached_st* client is unsafe.
-            // should clone it or use memcached_st_pool.
-            tcli = memcached_clone(nullptr, client_);
-        }
+        memcached_st* conn = AcquireConn();
         uint32_t flags = 0;
         size_t value_length = 0;
         memcached_return_t ue;
-        char *res = memcached_get(tcli, key.c_str(), key.length(),
+        char *res = memcached_get(conn, key.c_str(), key.length(),
                                   &value_length, &flags, &ue);
+        ReleaseConn(conn, ue);
         if (actLength != nullptr) {
             (*actLength) = value_length;
         }
@@ -155,7 +154,7 @@ class MemCachedClient : public KVClient {
             (*retCode) = ue;
         }
         if (MEMCACHED_SUCCESS == ue && res != nullptr && value &&
-            value_length >= length) {
+            value_length >= offset + length) {
             VLOG(9) << "Get key = " << key << " OK";
             memcpy(value, res + offset, length);
             free(res);
@@ -169,15 +168,96 @@ class MemCachedClient : public KVClient {
           LOG_EVERY_N(WARNING, 1000) << "Get key = " << key
             << " error = " << *errorlog << ", get_value_len = "
             << value_length << ", expect_value_len = " << length;
-          free(res);
-          memcached_free(tcli);
-          tcli = nullptr;
         }
+        free(res);
 
         metric_->get.eps.count << 1;
         return false;
     }
 
+    /**
+     * @brief: get all keys in one round trip of each server by
+     *         memcached_mget, instead of getting them one by one.
+     */
+    void MGet(std::vector<KVGetRequest>* requests) override {
+        if (requests->empty()) {
+            return;
+        }
+
+        uint64_t start = butil::cpuwide_time_us();
+        std::vector<const char*> keys;
+        std::vector<size_t> keyLengths;
+        // the same key may be requested more than once
+        std::unordered_map<std::string, std::vector<KVGetRequest*>> pending;
+        keys.reserve(requests->size());
+        keyLengths.reserve(requests->size());
+        for (auto& req : *requests) {
+            req.res = false;
+            req.actLength = 0;
+            req.retCode = MEMCACHED_NOTFOUND;
+            auto& reqs = pending[req.key];
+            if (reqs.empty()) {
+                keys.push_back(req.key.c_str());
+                keyLengths.push_back(req.key.length());
+            }
+            reqs.push_back(&req);
+        }
+
+        memcached_st* conn = AcquireConn();
+        memcached_return_t ue =
+            memcached_mget(conn, keys.data(), keyLengths.data(), keys.size());
+        uint64_t bytes = 0;
+        if (MEMCACHED_SUCCESS == ue) {
+            memcached_result_st result;
+            memcached_result_create(conn, &result);
+            while (memcached_fetch_result(conn, &result, &ue) != nullptr) {
+                auto iter = pending.find(
+                    std::string(memcached_result_key_value(&result),
+                                memcached_result_key_length(&result)));
+                if (iter == pending.end()) {
+                    continue;
+                }
+                const char* value = memcached_result_value(&result);
+                const size_t valueLength = memcached_result_length(&result);
+                for (auto* req : iter->second) {
+                    req->actLength = valueLength;
+                    if (valueLength >= req->offset + req->length) {
+                        memcpy(req->value, value + req->offset, req->length);
+                        req->res = true;
+                        req->retCode = MEMCACHED_SUCCESS;
+                        bytes += req->length;
+                    } else {
+                        req->retCode = MEMCACHED_FAILURE;
+                    }
+                }
+            }
+            memcached_result_free(&result);
+            // MEMCACHED_END or MEMCACHED_NOTFOUND means all results fetched
+            if (MEMCACHED_END == ue || MEMCACHED_NOTFOUND == ue) {
+                ue = MEMCACHED_SUCCESS;
+            }
+        }
+        ReleaseConn(conn, ue);
+
+        if (MEMCACHED_SUCCESS != ue) {
+            LOG_EVERY_N(WARNING, 1000) << "MGet " << requests->size()
+                                       << " keys error = " << ResError(ue);
+            for (auto& req : *requests) {
+                if (!req.res) {
+                    req.retCode = ue;
+                }
+            }
+        }
+
+        for (const auto& req : *requests) {
+            if (!req.res) {
+                metric_->get.eps.count << 1;
+            }
+        }
+        curve::client::CollectMetrics(&metric_->get, bytes,
+                                      butil::cpuwide_time_us() - start);
+    }
+
     // transform the res to a error string
     const std::string ResError(const memcached_return_t res) {
         return memcached_strerror(nullptr, res);
@@ -218,9 +298,38 @@ class MemCachedClient : public KVClient {
         return static_cast<int>(memcached_server_count(client_));
     }
 
+ private:
+    // multi thread use a memcached_st* client is unsafe, so every
+    // operation takes a cloned one from the pool and gives it back after.
+    memcached_st* AcquireConn() {
+        {
+            std::lock_guard<std::mutex> lk(poolMtx_);
+            if (!idleConns_.empty()) {
+                memcached_st* conn = idleConns_.back();
+                idleConns_.pop_back();
+                return conn;
+            }
+        }
+        return memcached_clone(nullptr, client_);
+    }
+
+    // the connection may be left in an unknown state by these errors,
+    // drop it instead of putting it back to pool
+    void ReleaseConn(memcached_st* conn, memcached_return_t ret) {
+        if (MEMCACHED_TIMEOUT == ret || MEMCACHED_PROTOCOL_ERROR == ret ||
+            MEMCACHED_UNKNOWN_READ_FAILURE == ret) {
+            memcached_free(conn);
+            return;
+        }
+        std::lock_guard<std::mutex> lk(poolMtx_);
+        idleConns_.push_back(conn);
+    }
+
  private:
     memcached_server_st *server_;
     memcached_st* client_;
+    std::mutex poolMtx_;
+    std::vector<memcached_st*> idleConns_;
     std::unique_ptr<metric::MemcacheClientMetric> metric_;
 };
 
@@ -25,7 +25,10 @@
 #include <vector>
 
 #include "curvefs/src/client/lease/lease_excutor.h"
+#include "src/common/timeutility.h"
 
+using curve::common::LockGuard;
+using curve::common::TimeUtility;
 using curvefs::mds::topology::PartitionTxId;
 
 namespace curvefs {
@@ -71,15 +74,32 @@ void LeaseExecutor::Stop() {
 }
 
 bool LeaseExecutor::RefreshLease() {
+    // the responses of meta lease must be handled in order
+    LockGuard lk(refreshMutex_);
+
     // get partition txid list
     std::vector<PartitionTxId> txIds;
     metaCache_->GetAllTxIds(&txIds);
 
+    // exchange the messages of meta lease
+    MetaLeaseRequest leaseRequest;
+    MetaLeaseResponse leaseResponse;
+    bool leaseEnabled = metaLease_ != nullptr && metaLease_->Enabled();
+    if (leaseEnabled) {
+        metaLease_->PrepareRefresh(&leaseRequest);
+    }
+
     // refresh from mds
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
     std::vector<PartitionTxId> latestTxIdList;
-    FSStatusCode ret = mdsCli_->RefreshSession(txIds, &latestTxIdList,
-                                               fsName_, mountpoint_,
-                                               enableSumInDir_);
+    FSStatusCode ret = mdsCli_->RefreshSession(
+        txIds, &latestTxIdList, fsName_, mountpoint_, enableSumInDir_,
+        leaseEnabled ? &leaseRequest : nullptr,
+        leaseEnabled ? &leaseResponse : nullptr);
+    if (leaseEnabled) {
+        metaLease_->OnRefreshed(ret == FSStatusCode::OK, leaseRequest,
+                                leaseResponse, startUs);
+    }
     if (ret != FSStatusCode::OK) {
         LOG(ERROR) << "LeaseExecutor refresh session fail, ret = " << ret
                    << ", errorName = " << FSStatusCode_Name(ret);
@@ -30,6 +30,7 @@
 #include "curvefs/src/client/rpcclient/metacache.h"
 #include "curvefs/src/client/rpcclient/mds_client.h"
 #include "curvefs/src/client/common/config.h"
+#include "curvefs/src/client/lease/meta_lease.h"
 #include "src/client/lease_executor.h"
 
 using curve::client::LeaseExecutorBase;
@@ -69,6 +70,11 @@ class LeaseExecutor : public LeaseExecutorBase {
        mountpoint_ = mp;
     }
 
+    void SetMetaLease(std::shared_ptr<MetaLease> metaLease) {
+       metaLease_ = metaLease;
+       metaLease_->SetRefresher([this]() { RefreshLease(); });
+    }
+
  private:
     LeaseOpt opt_;
     std::shared_ptr<MetaCache> metaCache_;
@@ -77,6 +83,8 @@ class LeaseExecutor : public LeaseExecutorBase {
     std::string fsName_;
     Mountpoint mountpoint_;
     std::atomic<bool>* enableSumInDir_;
+    std::shared_ptr<MetaLease> metaLease_;
+    curve::common::Mutex refreshMutex_;
 };
 
 }  // namespace client
@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/client/lease/meta_lease.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "src/common/timeutility.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curve::common::LockGuard;
+using ::curve::common::TimeUtility;
+using ::curve::common::UniqueLock;
+
+MetaLease::MetaLease(MetaLeaseOption option)
+    : option_(option),
+      epoch_(0),
+      sequence_(0),
+      validUntilUs_(0),
+      held_(new LRUType(option.lruSize)),
+      acquireSequence_(UINT64_MAX),
+      modifiedCount_(0),
+      preparedCount_(0),
+      running_(false) {}
+
+void MetaLease::Start() {
+    LockGuard lk(mutex_);
+    if (option_.enable && !running_) {
+        running_ = true;
+        thread_ = std::thread(&MetaLease::ReportTask, this);
+        LOG(INFO) << "Meta lease report thread start success";
+    }
+}
+
+void MetaLease::Stop() {
+    {
+        LockGuard lk(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        cond_.notify_all();
+    }
+    thread_.join();
+    LOG(INFO) << "Meta lease report thread stopped";
+}
+
+void MetaLease::SetRefresher(Refresher refresher) {
+    LockGuard lk(mutex_);
+    refresher_ = refresher;
+    cond_.notify_all();
+}
+
+uint64_t MetaLease::Sequence() {
+    LockGuard lk(mutex_);
+    return sequence_;
+}
+
+void MetaLease::Acquire(uint64_t ino, uint64_t sequence) {
+    if (!option_.enable) {
+        return;
+    }
+
+    LockGuard lk(mutex_);
+    uint64_t value;
+    if (held_->Get(ino, &value) || acquire_.size() >= option_.lruSize) {
+        return;
+    }
+    acquire_.push_back(ino);
+    acquireSequence_ = std::min(acquireSequence_, sequence);
+}
+
+void MetaLease::Modified(uint64_t ino) {
+    if (!option_.enable) {
+        return;
+    }
+
+    // others keep trusting their leases until the revocation arrives,
+    // so wake up the reporter rather than wait for the periodic refresh
+    LockGuard lk(mutex_);
+    modified_.push_back(ino);
+    modifiedCount_++;
+    cond_.notify_all();
+}
+
+bool MetaLease::Hold(uint64_t ino) {
+    if (!option_.enable) {
+        return false;
+    }
+
+    LockGuard lk(mutex_);
+    uint64_t value;
+    return TimeUtility::GetTimeofDayUs() < validUntilUs_ &&
+           held_->Get(ino, &value);
+}
+
+void MetaLease::PrepareRefresh(MetaLeaseRequest* request) {
+    LockGuard lk(mutex_);
+    request->set_epoch(epoch_);
+    request->set_sequence(acquire_.empty() ? sequence_ : acquireSequence_);
+    *request->mutable_acquire() = {acquire_.begin(), acquire_.end()};
+    *request->mutable_release() = {release_.begin(), release_.end()};
+    *request->mutable_modified() = {modified_.begin(), modified_.end()};
+    preparedCount_ = modifiedCount_;
+    acquire_.clear();
+    release_.clear();
+    modified_.clear();
+    acquireSequence_ = UINT64_MAX;
+}
+
+void MetaLease::OnRefreshed(bool ok,
+                            const MetaLeaseRequest& request,
+                            const MetaLeaseResponse& response,
+                            uint64_t startUs) {
+    std::vector<uint64_t> revoked;
+    {
+        LockGuard lk(mutex_);
+        if (!ok) {
+            // the revocations in the lost response are unknown,
+            // so we can't trust any lease anymore. The modifications
+            // are sent again at the next periodic refresh.
+            modified_.insert(modified_.end(), request.modified().begin(),
+                             request.modified().end());
+            release_.insert(release_.end(), request.release().begin(),
+                            request.release().end());
+            revoked = RevokeAll();
+            release_.insert(release_.end(), revoked.begin(), revoked.end());
+            epoch_ = 0;
+        } else if (response.epoch() != epoch_) {
+            // mds restarted, all leases granted before are gone
+            revoked = RevokeAll();
+            epoch_ = response.epoch();
+            sequence_ = response.sequence();
+        } else {
+            uint64_t eliminated;
+            for (const auto& ino : response.granted()) {
+                if (held_->Put(ino, ino, &eliminated)) {
+                    revoked.push_back(eliminated);
+                    release_.push_back(eliminated);
+                }
+            }
+            for (const auto& ino : response.revoked()) {
+                held_->Remove(ino);
+                revoked.push_back(ino);
+            }
+            sequence_ = response.sequence();
+            validUntilUs_ = startUs + response.leasetimeus();
+        }
+    }
+
+    InvokeHandler(revoked);
+}
+
+std::vector<uint64_t> MetaLease::RevokeAll() {
+    std::vector<uint64_t> inodes;
+    uint64_t ino, value;
+    while (held_->GetLast(&ino, &value)) {
+        held_->Remove(ino);
+        inodes.push_back(ino);
+    }
+    validUntilUs_ = 0;
+    return inodes;
+}
+
+void MetaLease::InvokeHandler(const std::vector<uint64_t>& inodes) {
+    if (handler_ == nullptr) {
+        return;
+    }
+    for (const auto& ino : inodes) {
+        handler_(ino);
+    }
+}
+
+void MetaLease::ReportTask() {
+    for ( ;; ) {
+        Refresher refresher;
+        {
+            UniqueLock lk(mutex_);
+            cond_.wait(lk, [this]() {
+                return !running_ || (refresher_ != nullptr &&
+                                     modifiedCount_ > preparedCount_);
+            });
+            if (!running_) {
+                break;
+            }
+            refresher = refresher_;
+        }
+
+        // the modifications queued meanwhile are sent by the next round
+        refresher();
+    }
+}
+
+}  // namespace client
+}  // namespace curvefs
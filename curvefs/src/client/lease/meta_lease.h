@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_LEASE_META_LEASE_H_
+#define CURVEFS_SRC_CLIENT_LEASE_META_LEASE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "curvefs/proto/mds.pb.h"
+#include "curvefs/src/client/common/config.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/lru_cache.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curvefs::client::common::MetaLeaseOption;
+using ::curvefs::mds::MetaLeaseRequest;
+using ::curvefs::mds::MetaLeaseResponse;
+
+/**
+ * Read leases of directories which granted by mds.
+ *
+ * While holding the lease of a directory, the cached entries of it can be
+ * trusted without revalidation, because any modification from other clients
+ * will revoke the lease. All messages are exchanged by refresh session, the
+ * modifier reports in background without waiting, and the revocation arrives
+ * at the holder's next refresh. A holder which can't refresh drops to the
+ * normal timeout of cache once its leases expire.
+ */
+class MetaLease {
+ public:
+    // invoked when the lease of inode lost, the cache of it should be dropped
+    using RevokeHandler = std::function<void(uint64_t ino)>;
+
+    // refresh session at once, the refreshes must be serialized
+    using Refresher = std::function<void()>;
+
+ public:
+    explicit MetaLease(MetaLeaseOption option);
+
+    ~MetaLease() { Stop(); }
+
+    // start the thread which reports modifications in background
+    void Start();
+
+    void Stop();
+
+    bool Enabled() const { return option_.enable; }
+
+    void SetRevokeHandler(RevokeHandler handler) { handler_ = handler; }
+
+    void SetRefresher(Refresher refresher);
+
+    // the sequence of mds we known, it should be fetched before reading
+    // the metadata which will be cached with lease.
+    uint64_t Sequence();
+
+    // acquire the lease for metadata which read at |sequence|
+    void Acquire(uint64_t ino, uint64_t sequence);
+
+    // report the inode which modified by ourself, it's sent to mds in
+    // background and never blocks
+    void Modified(uint64_t ino);
+
+    // return true if we hold the valid lease of the inode
+    bool Hold(uint64_t ino);
+
+    // fill the pending messages into request
+    void PrepareRefresh(MetaLeaseRequest* request);
+
+    // |startUs| is the time before the request was sent, the leases keep
+    // valid for the lease time since then
+    void OnRefreshed(bool ok,
+                     const MetaLeaseRequest& request,
+                     const MetaLeaseResponse& response,
+                     uint64_t startUs);
+
+ private:
+    // drop all leases we hold, return the inodes of them
+    std::vector<uint64_t> RevokeAll();
+
+    void InvokeHandler(const std::vector<uint64_t>& inodes);
+
+    void ReportTask();
+
+ private:
+    using LRUType = ::curve::common::LRUCache<uint64_t, uint64_t>;
+
+    MetaLeaseOption option_;
+    ::curve::common::Mutex mutex_;
+    uint64_t epoch_;
+    uint64_t sequence_;
+    uint64_t validUntilUs_;
+    std::unique_ptr<LRUType> held_;
+    std::vector<uint64_t> acquire_;
+    std::vector<uint64_t> release_;
+    std::vector<uint64_t> modified_;
+    // the minimum sequence of pending acquires
+    uint64_t acquireSequence_;
+    // number of modifications queued and prepared to report
+    uint64_t modifiedCount_;
+    uint64_t preparedCount_;
+    bool running_;
+    std::thread thread_;
+    ::curve::common::ConditionVariable cond_;
+    RevokeHandler handler_;
+    Refresher refresher_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_LEASE_META_LEASE_H_
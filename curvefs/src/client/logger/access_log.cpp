@@ -22,6 +22,20 @@
 
 #include "curvefs/src/client/logger/access_log.h"
 
+#include <bvar/bvar.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
 namespace curvefs {
 namespace client {
 namespace logger {
@@ -29,6 +43,280 @@ namespace logger {
 std::shared_ptr<spdlog::logger> Logger;
 bool inited = false;
 
+namespace {
+
+// capacity of the ring buffer of each thread, must be power of 2
+constexpr size_t kRingCapacity = 4096;
+
+// interval for background writer to wait when there is no pending log
+constexpr auto kWriterIdleInterval = std::chrono::milliseconds(10);
+
+using OpFilter = std::unordered_set<std::string>;
+
+// Background writer which drains ring buffers of all threads,
+// and formats and writes the logs to file.
+class AccessLogWriter {
+ public:
+    static AccessLogWriter& GetInstance() {
+        static AccessLogWriter writer;
+        return writer;
+    }
+
+    void Start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        RefreshFilter();
+        thread_ = std::thread(&AccessLogWriter::Run, this);
+    }
+
+    void Stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        thread_.join();
+        Drain();
+    }
+
+    std::shared_ptr<AccessLogRing> NewRing() {
+        auto ring = std::make_shared<AccessLogRing>(kRingCapacity);
+        std::lock_guard<std::mutex> lk(mutex_);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    uint64_t FilterVersion() const {
+        return filterVersion_.load(std::memory_order_acquire);
+    }
+
+    // return nullptr if no filter
+    std::shared_ptr<const OpFilter> GetFilter(uint64_t* version) {
+        std::lock_guard<std::mutex> lk(filterMutex_);
+        *version = filterVersion_.load(std::memory_order_relaxed);
+        return filter_;
+    }
+
+    void AddDropped() { dropped_ << 1; }
+
+ private:
+    AccessLogWriter() : dropped_("curvefs_client_access_log_dropped") {}
+
+    ~AccessLogWriter() { Stop(); }
+
+    void Run() {
+        while (running_.load(std::memory_order_relaxed)) {
+            RefreshFilter();
+            if (Drain() == 0) {
+                std::this_thread::sleep_for(kWriterIdleInterval);
+            }
+        }
+    }
+
+    // the rings are drained outside the lock, so the threads creating
+    // their rings are never blocked by the file writing
+    size_t Drain() {
+        // the owner thread has exited if the ring is only referenced
+        // by us, it's drained below for the last time
+        auto exited = [](const std::shared_ptr<AccessLogRing>& ring) {
+            return ring.use_count() == 2;
+        };
+
+        std::vector<std::shared_ptr<AccessLogRing>> rings;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            rings = rings_;
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(), exited),
+                         rings_.end());
+        }
+
+        size_t count = 0;
+        for (const auto& ring : rings) {
+            const AccessLogRecord* record;
+            while ((record = ring->Front()) != nullptr) {
+                if (!record->FormatTo(&message_)) {
+                    message_.append(" <bad format>");
+                }
+                Logger->info("{0} <{1:.6f}>", message_, record->elapsed);
+                ring->Pop();
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // the flag may be modified at runtime, e.g. by brpc /flags service
+    void RefreshFilter() {
+        std::string ops;
+        if (!google::GetCommandLineOption("access_log_ops", &ops) ||
+            ops == filterOps_) {
+            return;
+        }
+
+        std::shared_ptr<OpFilter> filter;
+        for (absl::string_view op : absl::StrSplit(ops, ',')) {
+            op = absl::StripAsciiWhitespace(op);
+            if (op.empty()) {
+                continue;
+            }
+            if (filter == nullptr) {
+                filter = std::make_shared<OpFilter>();
+            }
+            filter->emplace(op.data(), op.size());
+        }
+
+        filterOps_ = std::move(ops);
+        std::lock_guard<std::mutex> lk(filterMutex_);
+        filter_ = std::move(filter);
+        filterVersion_.fetch_add(1, std::memory_order_release);
+    }
+
+ private:
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<AccessLogRing>> rings_;
+    // only used by Drain(), its capacity is reused
+    std::string message_;
+
+    std::string filterOps_;
+    std::mutex filterMutex_;
+    std::shared_ptr<const OpFilter> filter_;
+    std::atomic<uint64_t> filterVersion_{0};
+
+    bvar::Adder<uint64_t> dropped_;
+};
+
+struct ThreadLocalState {
+    std::shared_ptr<AccessLogRing> ring;
+    uint64_t sampled = 0;
+    uint64_t filterVersion = 0;
+    std::shared_ptr<const OpFilter> filter;
+};
+
+thread_local ThreadLocalState tls;
+
+}  // namespace
+
+AccessLogRing::AccessLogRing(size_t capacity)
+    : records_(capacity), mask_(capacity - 1), head_(0), tail_(0) {
+    CHECK((capacity & mask_) == 0) << "capacity must be power of 2";
+}
+
+AccessLogRecord* AccessLogRing::Reserve() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) > mask_) {
+        return nullptr;
+    }
+    return &records_[tail & mask_];
+}
+
+void AccessLogRing::Commit() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+}
+
+const AccessLogRecord* AccessLogRing::Front() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &records_[head & mask_];
+}
+
+void AccessLogRing::Pop() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+}
+
+bool AccessLogRecord::FormatTo(std::string* message) const {
+    struct Value {
+        int64_t i = 0;
+        uint64_t u = 0;
+        double d = 0;
+        std::string s;
+    };
+
+    // the values must not be moved, the format arguments refer to them
+    std::vector<Value> values(nargs_);
+    std::vector<absl::FormatArg> args;
+    args.reserve(nargs_);
+    const char* pos = data_.data();
+    for (size_t i = 0; i < nargs_; i++) {
+        auto& value = values[i];
+        auto type = static_cast<ArgType>(*pos++);
+        switch (type) {
+            case ArgType::kInt:
+                std::memcpy(&value.i, pos, sizeof(value.i));
+                pos += sizeof(value.i);
+                args.emplace_back(value.i);
+                break;
+            case ArgType::kUint:
+                std::memcpy(&value.u, pos, sizeof(value.u));
+                pos += sizeof(value.u);
+                args.emplace_back(value.u);
+                break;
+            case ArgType::kDouble:
+                std::memcpy(&value.d, pos, sizeof(value.d));
+                pos += sizeof(value.d);
+                args.emplace_back(value.d);
+                break;
+            case ArgType::kString: {
+                uint32_t length;
+                std::memcpy(&length, pos, sizeof(length));
+                pos += sizeof(length);
+                value.s.assign(pos, length);
+                pos += length;
+                args.emplace_back(value.s);
+                break;
+            }
+            case ArgType::kDeferred: {
+                Decoder decoder;
+                std::memcpy(&decoder, pos, sizeof(decoder));
+                pos += sizeof(decoder);
+                pos += decoder(pos, &value.s);
+                args.emplace_back(value.s);
+                break;
+            }
+        }
+    }
+
+    message->clear();
+    return absl::FormatUntyped(message, absl::UntypedFormatSpec(format_),
+                               args);
+}
+
+bool ShouldLog(const char* op) {
+    auto& state = tls;
+    auto& writer = AccessLogWriter::GetInstance();
+    if (state.filterVersion != writer.FilterVersion()) {
+        state.filter = writer.GetFilter(&state.filterVersion);
+    }
+    if (state.filter != nullptr && state.filter->count(op) == 0) {
+        return false;
+    }
+
+    uint32_t rate = common::FLAGS_access_log_sample_rate;
+    return rate <= 1 || state.sampled++ % rate == 0;
+}
+
+void PushAccessLog(const MessageHandler& handler, double elapsed) {
+    auto& state = tls;
+    auto& writer = AccessLogWriter::GetInstance();
+    if (state.ring == nullptr) {
+        state.ring = writer.NewRing();
+    }
+
+    AccessLogRecord* record = state.ring->Reserve();
+    if (record == nullptr) {
+        writer.AddDropped();
+        return;
+    }
+    handler(record);
+    record->elapsed = elapsed;
+    state.ring->Commit();
+}
+
 bool InitAccessLog(const std::string& prefix) {
     if (inited) {
         return true;
@@ -37,10 +325,20 @@ bool InitAccessLog(const std::string& prefix) {
     std::string filename = StrFormat("%s/access.%d.log", prefix, getpid());
     Logger = spdlog::daily_logger_mt("fuse_access", filename, 0, 0);
     spdlog::flush_every(std::chrono::seconds(1));
+    AccessLogWriter::GetInstance().Start();
     inited = true;
     return true;
 }
 
+void ShutdownAccessLog() {
+    if (!inited) {
+        return;
+    }
+
+    AccessLogWriter::GetInstance().Stop();
+    Logger->flush();
+}
+
 }  // namespace logger
 }  // namespace client
 }  // namespace curvefs
@@ -28,8 +28,12 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
 
+#include <atomic>
+#include <cstring>
 #include <string>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "absl/strings/str_format.h"
 #include "curvefs/src/client/common/config.h"
@@ -42,23 +46,194 @@ namespace client {
 namespace common {
 
 DECLARE_bool(access_logging);
+DECLARE_uint32(access_log_sample_rate);
+DECLARE_string(access_log_ops);
 
 }
 namespace logger {
 
 using ::absl::StrFormat;
 using ::curvefs::client::common::FLAGS_access_logging;
-using MessageHandler = std::function<std::string()>;
 
 extern std::shared_ptr<spdlog::logger> Logger;
 extern bool inited;
 
 bool InitAccessLog(const std::string& prefix);
 
+// stop the background writer after all pending logs are written
+void ShutdownAccessLog();
+
+// Argument which is converted to string by |fn| in the background writer,
+// |T| must be trivially copyable, e.g. the error code and its StrErr().
+template <typename T>
+struct DeferredArg {
+    T value;
+    std::string (*fn)(T value);
+
+    // it's formatted as string, so it matches "%s" in the format
+    friend absl::FormatConvertResult<absl::FormatConversionCharSet::kString>
+    AbslFormatConvert(const DeferredArg& arg,
+                      const absl::FormatConversionSpec& spec,
+                      absl::FormatSink* sink) {
+        (void)spec;
+        sink->Append(arg.fn(arg.value));
+        return { true };
+    }
+};
+
+// Compact record of an access log, the operation thread only copies the
+// format and arguments into it, and the background writer formats them.
+class AccessLogRecord {
+ public:
+    // |format| is checked against the arguments like StrFormat(),
+    // and it must outlive the record, e.g. a string literal
+    template <typename... Args>
+    void Encode(const absl::FormatSpec<Args...>& format,
+                const Args&... args) {
+        format_ = absl::str_format_internal::UntypedFormatSpecImpl::Extract(
+                      format).str();
+        nargs_ = 0;
+        data_.clear();
+        EncodeArgs(args...);
+    }
+
+    // format the record into |message|, return false if the format
+    // doesn't match the arguments
+    bool FormatTo(std::string* message) const;
+
+    double elapsed = 0;  // seconds
+
+ private:
+    enum class ArgType : char {
+        kInt,
+        kUint,
+        kDouble,
+        kString,
+        kDeferred,
+    };
+
+    // decode the deferred argument at |data| into |out|,
+    // return the number of bytes it occupies
+    using Decoder = size_t (*)(const char* data, std::string* out);
+
+    void EncodeArgs() {}
+
+    template <typename T, typename... Args>
+    void EncodeArgs(const T& arg, const Args&... args) {
+        nargs_++;
+        EncodeArg(arg);
+        EncodeArgs(args...);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value &&
+                            std::is_signed<T>::value>::type
+    EncodeArg(T value) {
+        Append(ArgType::kInt, static_cast<int64_t>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value &&
+                            std::is_unsigned<T>::value>::type
+    EncodeArg(T value) {
+        Append(ArgType::kUint, static_cast<uint64_t>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    EncodeArg(T value) {
+        Append(ArgType::kDouble, static_cast<double>(value));
+    }
+
+    void EncodeArg(const char* value) {
+        EncodeString(value == nullptr ? "(null)" : value,
+                     value == nullptr ? 6 : std::strlen(value));
+    }
+
+    void EncodeArg(const std::string& value) {
+        EncodeString(value.data(), value.size());
+    }
+
+    template <typename T>
+    void EncodeArg(const DeferredArg<T>& value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "deferred argument must be trivially copyable");
+        Decoder decoder = &DecodeDeferred<T>;
+        data_.push_back(static_cast<char>(ArgType::kDeferred));
+        data_.append(reinterpret_cast<const char*>(&decoder), sizeof(decoder));
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void EncodeString(const char* value, size_t size) {
+        auto length = static_cast<uint32_t>(size);
+        Append(ArgType::kString, length);
+        data_.append(value, length);
+    }
+
+    template <typename T>
+    void Append(ArgType type, T value) {
+        data_.push_back(static_cast<char>(type));
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    static size_t DecodeDeferred(const char* data, std::string* out) {
+        DeferredArg<T> arg;
+        std::memcpy(&arg, data, sizeof(arg));
+        *out = arg.fn(arg.value);
+        return sizeof(arg);
+    }
+
+ private:
+    absl::string_view format_;
+    size_t nargs_ = 0;
+    // the encoded arguments, its capacity is reused by later records
+    std::string data_;
+};
+
+// Ring buffer of access logs for one thread, the owner thread pushes
+// and the background writer pops, both without lock. The records are
+// encoded and formatted in place, so their buffers are reused.
+class AccessLogRing {
+ public:
+    explicit AccessLogRing(size_t capacity);
+
+    // return the record to fill, or nullptr if the ring is full,
+    // the record is visible to consumer after Commit()
+    AccessLogRecord* Reserve();
+
+    void Commit();
+
+    // return the oldest record, or nullptr if the ring is empty,
+    // the record is released by Pop()
+    const AccessLogRecord* Front();
+
+    void Pop();
+
+ private:
+    std::vector<AccessLogRecord> records_;
+    const uint64_t mask_;
+    // next position to pop, only updated by consumer
+    alignas(64) std::atomic<uint64_t> head_;
+    // next position to push, only updated by producer
+    alignas(64) std::atomic<uint64_t> tail_;
+};
+
+// fill the record by AccessLogRecord::Encode()
+using MessageHandler = std::function<void(AccessLogRecord* record)>;
+
+// whether the operation should be logged by sampling and filter,
+// |op| is the name of operation, e.g. "lookup"
+bool ShouldLog(const char* op);
+
+// encode the log by |handler| into ring buffer of current thread, it will
+// be formatted and written to file by the background writer
+void PushAccessLog(const MessageHandler& handler, double elapsed);
+
 struct AccessLogGuard {
-    explicit AccessLogGuard(MessageHandler handler)
-        : enable(FLAGS_access_logging && inited),
-          handler(handler) {
+    AccessLogGuard(const char* op, MessageHandler handler)
+        : enable(FLAGS_access_logging && inited && ShouldLog(op)),
+          handler(std::move(handler)) {
         if (!enable) {
             return;
         }
@@ -72,7 +247,7 @@ struct AccessLogGuard {
         }
 
         timer.stop();
-        Logger->info("{0} <{1:.6f}>", handler(), timer.u_elapsed() / 1e6);
+        PushAccessLog(handler, timer.u_elapsed() / 1e6);
     }
 
     bool enable;
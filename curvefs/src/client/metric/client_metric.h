@@ -81,6 +81,7 @@ struct MetaServerClientMetric {
     InterfaceMetric listDentry;
     InterfaceMetric createDentry;
     InterfaceMetric deleteDentry;
+    InterfaceMetric renameDentry;
 
     // inode
     InterfaceMetric getInode;
@@ -88,8 +89,13 @@ struct MetaServerClientMetric {
     InterfaceMetric batchGetXattr;
     InterfaceMetric createInode;
     InterfaceMetric updateInode;
+    InterfaceMetric batchUpdateInode;
     InterfaceMetric deleteInode;
     InterfaceMetric appendS3ChunkInfo;
+    // number of inodes in one batch update rpc
+    bvar::IntRecorder batchUpdateInodeSize;
+    // number of update inode rpcs saved by batch update
+    bvar::Adder<uint64_t> batchUpdateInodeSavedRpc;
 
     // tnx
     InterfaceMetric prepareRenameTx;
@@ -102,13 +108,17 @@ struct MetaServerClientMetric {
     MetaServerClientMetric()
         : getDentry(prefix, "getDentry"), listDentry(prefix, "listDentry"),
           createDentry(prefix, "createDentry"),
-          deleteDentry(prefix, "deleteDentry"), getInode(prefix, "getInode"),
+          deleteDentry(prefix, "deleteDentry"),
+          renameDentry(prefix, "renameDentry"), getInode(prefix, "getInode"),
           batchGetInodeAttr(prefix, "batchGetInodeAttr"),
           batchGetXattr(prefix, "batchGetXattr"),
           createInode(prefix, "createInode"),
           updateInode(prefix, "updateInode"),
+          batchUpdateInode(prefix, "batchUpdateInode"),
           deleteInode(prefix, "deleteInode"),
           appendS3ChunkInfo(prefix, "appendS3ChunkInfo"),
+          batchUpdateInodeSize(prefix, "batchUpdateInode_size"),
+          batchUpdateInodeSavedRpc(prefix, "batchUpdateInode_saved_rpc"),
           prepareRenameTx(prefix, "prepareRenameTx"),
           updateVolumeExtent(prefix, "updateVolumeExtent"),
           getVolumeExtent(prefix, "getVolumeExtent"),
@@ -59,6 +59,8 @@ using curvefs::metaserver::ListDentryRequest;
 using curvefs::metaserver::ListDentryResponse;
 using curvefs::metaserver::PrepareRenameTxRequest;
 using curvefs::metaserver::PrepareRenameTxResponse;
+using curvefs::metaserver::RenameDentryRequest;
+using curvefs::metaserver::RenameDentryResponse;
 using curvefs::metaserver::UpdateInodeRequest;
 using curvefs::metaserver::UpdateInodeResponse;
 using curvefs::metaserver::ManageInodeType;
@@ -82,6 +84,8 @@ using curvefs::mds::GetLatestTxIdRequest;
 using curvefs::mds::GetLatestTxIdResponse;
 using curvefs::mds::CommitTxRequest;
 using curvefs::mds::CommitTxResponse;
+using curvefs::mds::MetaLeaseRequest;
+using curvefs::mds::MetaLeaseResponse;
 using curvefs::mds::RefreshSessionRequest;
 using curvefs::mds::RefreshSessionResponse;
 using curvefs::mds::UmountFsRequest;
@@ -505,7 +505,9 @@ MdsClientImpl::RefreshSession(const std::vector<PartitionTxId> &txIds,
                               std::vector<PartitionTxId> *latestTxIdList,
                               const std::string& fsName,
                               const Mountpoint& mountpoint,
-                              std::atomic<bool>* enableSumInDir) {
+                              std::atomic<bool>* enableSumInDir,
+                              const MetaLeaseRequest* leaseRequest,
+                              MetaLeaseResponse* leaseResponse) {
     auto task = RPCTask {
         (void)addrindex;
         (void)rpctimeoutMS;
@@ -520,6 +522,9 @@ MdsClientImpl::RefreshSession(const std::vector<PartitionTxId> &txIds,
         fsDelta.set_bytes(
             FsDeltaUpdater::GetInstance().GetDeltaBytesAndReset());
         *request.mutable_fsdelta() = std::move(fsDelta);
+        if (leaseRequest != nullptr) {
+            *request.mutable_metalease() = *leaseRequest;
+        }
 
         mdsbasecli_->RefreshSession(request, &response, cntl, channel);
         if (cntl->Failed()) {
@@ -550,6 +555,9 @@ MdsClientImpl::RefreshSession(const std::vector<PartitionTxId> &txIds,
             FsQuotaChecker::GetInstance().UpdateQuotaCache(
                 response.fscapacity(), response.fsusedbytes());
         }
+        if (ret == FSStatusCode::OK && leaseResponse != nullptr) {
+            *leaseResponse = response.metalease();
+        }
 
         return ret;
     };
@@ -117,7 +117,9 @@ class MdsClient {
                    std::vector<PartitionTxId> *latestTxIdList,
                    const std::string& fsName,
                    const Mountpoint& mountpoint,
-                   std::atomic<bool>* enableSumInDir) = 0;
+                   std::atomic<bool>* enableSumInDir,
+                   const MetaLeaseRequest* leaseRequest,
+                   MetaLeaseResponse* leaseResponse) = 0;
 
     virtual FSStatusCode GetLatestTxId(uint32_t fsId,
                                        std::vector<PartitionTxId>* txIds) = 0;
@@ -205,7 +207,9 @@ class MdsClientImpl : public MdsClient {
                                 std::vector<PartitionTxId> *latestTxIdList,
                                 const std::string& fsName,
                                 const Mountpoint& mountpoint,
-                                std::atomic<bool>* enableSumInDir) override;
+                                std::atomic<bool>* enableSumInDir,
+                                const MetaLeaseRequest* leaseRequest,
+                                MetaLeaseResponse* leaseResponse) override;
 
     FSStatusCode GetLatestTxId(uint32_t fsId,
                                std::vector<PartitionTxId>* txIds) override;
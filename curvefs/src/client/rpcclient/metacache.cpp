@@ -39,29 +39,26 @@ namespace rpcclient {
 void MetaCache::SetTxId(uint32_t partitionId, uint64_t txId) {
     WriteLockGuard w(txIdLock_);
     partitionTxId_[partitionId] = txId;
-}
-
-// partitionTxId_: cache for partition's txid
-void MetaCache::GetTxId(uint32_t partitionId, uint64_t *txId) {
-    ReadLockGuard r(txIdLock_);
-    auto iter = partitionTxId_.find(partitionId);
-    if (iter != partitionTxId_.end()) {
-        *txId = iter->second;
+    auto iter = partitionRoutes_.find(partitionId);
+    if (iter != partitionRoutes_.end()) {
+        iter->second->txId.store(txId, std::memory_order_relaxed);
     }
 }
 
 bool MetaCache::GetTxId(uint32_t fsId, uint64_t inodeId, uint32_t *partitionId,
                         uint64_t *txId) {
-    for (const auto &partition : partitionInfos_) {
-        if (fsId == partition.fsid() && inodeId >= partition.start() &&
-            inodeId <= partition.end()) {
-            *partitionId = partition.partitionid();
-            *txId = partition.txid();
-            GetTxId(*partitionId, txId);
-            return true;
-        }
+    butil::DoublyBufferedData<PartitionIndex>::ScopedPtr index;
+    if (partitionIndex_.Read(&index) != 0) {
+        return false;
     }
-    return false;
+
+    const auto *route = index->Find(inodeId);
+    if (route == nullptr || route->fsID != fsId) {
+        return false;
+    }
+    *partitionId = route->partitionID;
+    *txId = route->txId.load(std::memory_order_relaxed);
+    return true;
 }
 
 void MetaCache::GetAllTxIds(std::vector<PartitionTxId> *txIds) {
@@ -92,8 +89,8 @@ bool MetaCache::RefreshTxId() {
 bool MetaCache::GetTarget(uint32_t fsID, uint64_t inodeID,
                           CopysetTarget *target, bool refresh) {
     // get copysetID with inodeID
-    if (!GetCopysetIDwithInodeID(inodeID, &target->groupID,
-                                 &target->partitionID, &target->txId)) {
+    bool hasLeader = false;
+    if (!GetCopysetIDwithInodeID(inodeID, target, &hasLeader)) {
         // list infos from mds
         if (!ListPartitions(fsID)) {
             LOG(ERROR) << "get target for {fsid:" << fsID
@@ -101,14 +98,17 @@ bool MetaCache::GetTarget(uint32_t fsID, uint64_t inodeID,
             return false;
         }
 
-        if (!GetCopysetIDwithInodeID(inodeID, &target->groupID,
-                                     &target->partitionID, &target->txId)) {
+        if (!GetCopysetIDwithInodeID(inodeID, target, &hasLeader)) {
             LOG(ERROR) << "{fsid:" << fsID << ", inodeid:" << inodeID
                        << "} do not find partition";
             return false;
         }
     }
 
+    if (hasLeader && !refresh) {
+        return true;
+    }
+
     // get target copyset leader with (poolID, copysetID)
     return GetTargetLeader(target, refresh);
 }
@@ -155,6 +155,7 @@ void MetaCache::UpdateCopysetInfo(const CopysetGroupID &groupID,
 
     WriteLockGuard wl(rwlock4copysetInfoMap_);
     copysetInfoMap_[key] = csinfo;
+    UpdateLeaderCache(key, csinfo);
 }
 
 bool MetaCache::GetTargetLeader(CopysetTarget *target, bool refresh) {
@@ -348,6 +349,7 @@ void MetaCache::DoAddOrResetPartitionAndCopyset(
     if (reset) {
         partitionInfos_.clear();
         copysetInfoMap_.clear();
+        leaderCaches_.clear();
     }
 
     LOG(INFO) << "add partition and copyset infos for {fsid:" << fsID_
@@ -364,8 +366,70 @@ void MetaCache::DoAddOrResetPartitionAndCopyset(
                            std::make_move_iterator(partitionInfos.begin()),
                            std::make_move_iterator(partitionInfos.end()));
     // add copysetInfo
-    copysetInfoMap_.insert(std::make_move_iterator(copysetMap.begin()),
-                           std::make_move_iterator(copysetMap.end()));
+    for (auto &item : copysetMap) {
+        auto ret = copysetInfoMap_.emplace(item.first, std::move(item.second));
+        if (ret.second) {
+            UpdateLeaderCache(item.first, ret.first->second);
+        }
+    }
+
+    RebuildPartitionIndex();
+}
+
+void MetaCache::RebuildPartitionIndex() {
+    PartitionIndex::RouteList routes;
+    std::unordered_map<PartitionID, std::shared_ptr<PartitionRoute>>
+        partitionRoutes;
+    routes.reserve(partitionInfos_.size());
+
+    // hold the lock until the index is published, so SetTxId is either
+    // done before the rebuild or applied to the new routes
+    WriteLockGuard w(txIdLock_);
+    for (const auto &info : partitionInfos_) {
+        auto route = std::make_shared<PartitionRoute>();
+        route->fsID = info.fsid();
+        route->partitionID = info.partitionid();
+        route->poolID = info.poolid();
+        route->copysetID = info.copysetid();
+        route->start = info.start();
+        route->end = info.end();
+        auto iter = partitionTxId_.find(info.partitionid());
+        route->txId.store(
+            iter != partitionTxId_.end() ? iter->second : info.txid(),
+            std::memory_order_relaxed);
+        route->leader = GetOrCreateLeaderCache(CalcLogicPoolCopysetID(
+            CopysetGroupID(info.poolid(), info.copysetid())));
+        partitionRoutes[route->partitionID] = route;
+        routes.emplace_back(std::move(route));
+    }
+    partitionRoutes_.swap(partitionRoutes);
+
+    const PartitionIndex index(std::move(routes));
+    auto publish = [&index](PartitionIndex &bg) -> size_t {
+        bg = index;
+        return 1;
+    };
+    partitionIndex_.Modify(publish);
+}
+
+std::shared_ptr<LeaderCache>
+MetaCache::GetOrCreateLeaderCache(PoolIDCopysetID key) {
+    auto &leader = leaderCaches_[key];
+    if (leader == nullptr) {
+        leader = std::make_shared<LeaderCache>();
+    }
+    return leader;
+}
+
+void MetaCache::UpdateLeaderCache(PoolIDCopysetID key,
+                                  const CopysetInfo<MetaserverID> &csinfo) {
+    auto leader = GetOrCreateLeaderCache(key);
+    if (csinfo.HasValidLeader()) {
+        const auto &peer = csinfo.csinfos_[csinfo.GetCurrentLeaderIndex()];
+        leader->Set(peer.peerID, peer.externalAddr.addr_);
+    } else {
+        leader->Invalidate();
+    }
 }
 
 bool MetaCache::UpdateCopysetInfoFromMDS(
@@ -496,21 +560,22 @@ bool MetaCache::SelectPartition(CopysetTarget *target) {
 }
 
 bool MetaCache::GetCopysetIDwithInodeID(uint64_t inodeID,
-                                        CopysetGroupID *groupID,
-                                        PartitionID *partitionID,
-                                        uint64_t *txId) {
-    ReadLockGuard rl(rwlock4Partitions_);
-    for (auto iter = partitionInfos_.begin(); iter != partitionInfos_.end();
-         ++iter) {
-        if (iter->start() <= inodeID && iter->end() >= inodeID) {
-            *groupID = CopysetGroupID(iter->poolid(), iter->copysetid());
-            *partitionID = iter->partitionid();
-            *txId = iter->txid();
-            GetTxId(*partitionID, txId);
-            return true;
-        }
+                                        CopysetTarget *target,
+                                        bool *hasLeader) {
+    butil::DoublyBufferedData<PartitionIndex>::ScopedPtr index;
+    if (partitionIndex_.Read(&index) != 0) {
+        return false;
     }
-    return false;
+
+    const auto *route = index->Find(inodeID);
+    if (route == nullptr) {
+        return false;
+    }
+    target->groupID = CopysetGroupID(route->poolID, route->copysetID);
+    target->partitionID = route->partitionID;
+    target->txId = route->txId.load(std::memory_order_relaxed);
+    *hasLeader = route->leader->Get(&target->metaServerID, &target->endPoint);
+    return true;
 }
 
 bool MetaCache::GetCopysetInfowithCopySetID(
@@ -526,32 +591,22 @@ bool MetaCache::GetCopysetInfowithCopySetID(
     return true;
 }
 
-bool TryGetPartitionIdByInodeId(const std::vector<PartitionInfo> &plist,
-                                RWLock *lock, uint64_t inodeID,
-                                PartitionID *pid) {
-    ReadLockGuard rl(*lock);
-    for (const auto &it : plist) {
-        if (it.start() <= inodeID && it.end() >= inodeID) {
-            *pid = it.partitionid();
-            return true;
-        }
-    }
-    return false;
-}
-
 bool MetaCache::GetPartitionIdByInodeId(uint32_t fsID, uint64_t inodeID,
                                         PartitionID *pid) {
-    if (!TryGetPartitionIdByInodeId(partitionInfos_, &rwlock4Partitions_,
-                                    inodeID, pid)) {
+    CopysetTarget target;
+    bool hasLeader = false;
+    if (!GetCopysetIDwithInodeID(inodeID, &target, &hasLeader)) {
         // list form mds
         if (!ListPartitions(fsID)) {
             LOG(ERROR) << "ListPartitions for {fsid:" << fsID
                        << "} fail, partition list not exist";
             return false;
         }
-        return TryGetPartitionIdByInodeId(partitionInfos_, &rwlock4Partitions_,
-                                          inodeID, pid);
+        if (!GetCopysetIDwithInodeID(inodeID, &target, &hasLeader)) {
+            return false;
+        }
     }
+    *pid = target.partitionID;
     return true;
 }
 
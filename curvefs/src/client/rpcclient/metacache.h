@@ -25,6 +25,7 @@
 
 #include <brpc/channel.h>
 #include <brpc/controller.h>
+#include <butil/containers/doubly_buffered_data.h>
 
 #include <map>
 #include <memory>
@@ -39,6 +40,7 @@
 #include "curvefs/src/client/rpcclient/cli2_client.h"
 #include "curvefs/src/client/rpcclient/mds_client.h"
 #include "curvefs/src/client/common/config.h"
+#include "curvefs/src/client/rpcclient/partition_index.h"
 
 using ::curve::client::CopysetID;
 using ::curve::client::CopysetInfo;
@@ -153,7 +155,6 @@ class MetaCache {
     bool ListPartitions(uint32_t fsID);
 
  private:
-    void GetTxId(uint32_t partitionId, uint64_t *txId);
     bool CreatePartitions(int currentNum, PartitionInfoList *newPartitions);
     bool DoListOrCreatePartitions(
         bool list, PartitionInfoList *partitionInfos,
@@ -178,9 +179,19 @@ class MetaCache {
     // more policies
     bool SelectPartition(CopysetTarget *target);
 
-    // get info from partitionMap or copysetMap
-    bool GetCopysetIDwithInodeID(uint64_t inodeID, CopysetGroupID *groupID,
-                                 PartitionID *patitionID, uint64_t *txId);
+    // get info from partition index, the leader is also filled
+    // if it's cached and |hasLeader| will be set to true
+    bool GetCopysetIDwithInodeID(uint64_t inodeID, CopysetTarget *target,
+                                 bool *hasLeader);
+
+    // rebuild partition index from partitionInfos_ and publish it,
+    // caller must hold write lock of partitions and copysets
+    void RebuildPartitionIndex();
+
+    // caller must hold write lock of copysets
+    std::shared_ptr<LeaderCache> GetOrCreateLeaderCache(PoolIDCopysetID key);
+    void UpdateLeaderCache(PoolIDCopysetID key,
+                           const CopysetInfo<MetaserverID> &csinfo);
 
     bool GetCopysetInfowithCopySetID(const CopysetGroupID &groupID,
                                      CopysetInfo<MetaserverID> *targetInfo);
@@ -196,11 +207,20 @@ class MetaCache {
  private:
     RWLock txIdLock_;
     std::unordered_map<uint32_t, uint64_t> partitionTxId_;
+    // routes of partitions in current index, protected by txIdLock_
+    std::unordered_map<PartitionID, std::shared_ptr<PartitionRoute>>
+        partitionRoutes_;
+
+    // lookup of inode's partition and copyset goes here without lock
+    butil::DoublyBufferedData<PartitionIndex> partitionIndex_;
 
     RWLock rwlock4Partitions_;
     PartitionInfoList partitionInfos_;
     RWLock rwlock4copysetInfoMap_;
     CopysetInfoMap copysetInfoMap_;
+    // leader of copysets, protected by rwlock4copysetInfoMap_
+    std::unordered_map<PoolIDCopysetID, std::shared_ptr<LeaderCache>>
+        leaderCaches_;
 
     Mutex createMutex_;
 
@@ -47,6 +47,8 @@ using curvefs::metaserver::BatchGetXAttrRequest;
 using curvefs::metaserver::BatchGetXAttrResponse;
 using curvefs::metaserver::GetOrModifyS3ChunkInfoRequest;
 using curvefs::metaserver::GetOrModifyS3ChunkInfoResponse;
+using curvefs::metaserver::BatchUpdateInodeRequest;
+using curvefs::metaserver::BatchUpdateInodeResponse;
 
 namespace curvefs {
 namespace client {
@@ -56,8 +58,10 @@ using GetDentryExcutor = TaskExecutor;
 using ListDentryExcutor = TaskExecutor;
 using DeleteDentryExcutor = TaskExecutor;
 using PrepareRenameTxExcutor = TaskExecutor;
+using RenameDentryExcutor = TaskExecutor;
 using DeleteInodeExcutor = TaskExecutor;
 using UpdateInodeExcutor = TaskExecutor;
+using BatchUpdateInodeExcutor = TaskExecutor;
 using GetInodeExcutor = TaskExecutor;
 using BatchGetInodeAttrExcutor = TaskExecutor;
 using BatchGetXAttrExcutor = TaskExecutor;
@@ -395,6 +399,73 @@ MetaServerClientImpl::PrepareRenameTx(const std::vector<Dentry> &dentrys) {
     return ConvertToMetaStatusCode(excutor.DoRPCTask());
 }
 
+bool MetaServerClientImpl::IsSameCopyset(uint32_t fsId, uint64_t inodeId,
+                                         uint64_t otherInodeId) {
+    CopysetTarget target;
+    CopysetTarget otherTarget;
+    if (!metaCache_->GetTarget(fsId, inodeId, &target) ||
+        !metaCache_->GetTarget(fsId, otherInodeId, &otherTarget)) {
+        return false;
+    }
+    return target.groupID.poolID == otherTarget.groupID.poolID &&
+           target.groupID.copysetID == otherTarget.groupID.copysetID;
+}
+
+MetaStatusCode MetaServerClientImpl::RenameDentry(const Dentry &srcDentry,
+                                                  const Dentry &dstDentry) {
+    auto task = RPCTask {
+        (void)taskExecutorDone;
+        metric_.renameDentry.qps.count << 1;
+        LatencyUpdater updater(&metric_.renameDentry.latency);
+        uint32_t dstPartitionID = 0;
+        uint64_t dstTxId = 0;
+        if (!metaCache_->GetTxId(dstDentry.fsid(), dstDentry.parentinodeid(),
+                                 &dstPartitionID, &dstTxId)) {
+            return MetaStatusCode::NOT_FOUND;
+        }
+
+        RenameDentryRequest request;
+        RenameDentryResponse response;
+        request.set_poolid(poolID);
+        request.set_copysetid(copysetID);
+        request.set_partitionid(partitionID);
+        request.set_dstpartitionid(dstPartitionID);
+        *request.mutable_srcdentry() = srcDentry;
+        request.mutable_srcdentry()->set_txid(txId);
+        *request.mutable_dstdentry() = dstDentry;
+        request.mutable_dstdentry()->set_txid(dstTxId);
+
+        curvefs::metaserver::MetaServerService_Stub stub(channel);
+        stub.RenameDentry(cntl, &request, &response, nullptr);
+
+        if (cntl->Failed()) {
+            metric_.renameDentry.eps.count << 1;
+            LOG(WARNING) << "RenameDentry failed"
+                         << ", errorCode = " << cntl->ErrorCode()
+                         << ", errorText = " << cntl->ErrorText()
+                         << ", logId = " << cntl->log_id();
+            return -cntl->ErrorCode();
+        }
+
+        auto rc = response.statuscode();
+        if (rc != MetaStatusCode::OK) {
+            LOG(WARNING) << "RenameDentry: retCode = " << rc
+                         << ", message = " << MetaStatusCode_Name(rc);
+        }
+
+        VLOG(6) << "RenameDentry done, request: " << request.DebugString()
+                << "response: " << response.DebugString();
+        return rc;
+    };
+
+    auto taskCtx = std::make_shared<TaskContext>(
+        MetaServerOpType::RenameDentry, task, srcDentry.fsid(),
+        srcDentry.parentinodeid());
+    RenameDentryExcutor excutor(opt_, metaCache_, channelManager_,
+                                std::move(taskCtx));
+    return ConvertToMetaStatusCode(excutor.DoRPCTask());
+}
+
 MetaStatusCode MetaServerClientImpl::GetInode(uint32_t fsId, uint64_t inodeid,
                                               Inode *out, bool *streaming) {
     auto task = RPCTask {
@@ -912,6 +983,165 @@ void MetaServerClientImpl::UpdateInodeWithOutNlinkAsync(
     UpdateInodeAsync(request, done);
 }
 
+namespace {
+
+// Closure of a batch update rpc, it dispatches the status of each update
+// to its own closure.
+class BatchUpdateInodeDone : public MetaServerClientDone {
+ public:
+    explicit BatchUpdateInodeDone(std::vector<MetaServerClientDone *> dones)
+        : dones_(std::move(dones)) {}
+
+    void SetStatuses(
+        const google::protobuf::RepeatedField<int> &statuses) {
+        statuses_.clear();
+        for (const auto &status : statuses) {
+            statuses_.push_back(static_cast<MetaStatusCode>(status));
+        }
+    }
+
+    void Run() override {
+        std::unique_ptr<BatchUpdateInodeDone> self_guard(this);
+        MetaStatusCode ret = GetStatusCode();
+        for (size_t i = 0; i < dones_.size(); i++) {
+            MetaStatusCode rc = ret;
+            if (ret == MetaStatusCode::OK) {
+                rc = i < statuses_.size() ? statuses_[i]
+                                          : MetaStatusCode::UNKNOWN_ERROR;
+            }
+            if (dones_[i] != nullptr) {
+                dones_[i]->SetMetaStatusCode(rc);
+                dones_[i]->Run();
+            }
+        }
+    }
+
+ private:
+    std::vector<MetaServerClientDone *> dones_;
+    std::vector<MetaStatusCode> statuses_;
+};
+
+}  // namespace
+
+class BatchUpdateInodeRpcDone : public MetaServerClientRpcDoneBase {
+ public:
+    using MetaServerClientRpcDoneBase::MetaServerClientRpcDoneBase;
+
+    void Run() override;
+    BatchUpdateInodeResponse response;
+};
+
+void BatchUpdateInodeRpcDone::Run() {
+    std::unique_ptr<BatchUpdateInodeRpcDone> self_guard(this);
+    brpc::ClosureGuard done_guard(done_);
+    auto taskCtx = done_->GetTaskExcutor()->GetTaskCxt();
+    auto &cntl = taskCtx->cntl_;
+    if (cntl.Failed()) {
+        metric_->batchUpdateInode.eps.count << 1;
+        LOG(WARNING) << "BatchUpdateInode Failed, errorcode = "
+                     << cntl.ErrorCode()
+                     << ", error content: " << cntl.ErrorText()
+                     << ", log id: " << cntl.log_id();
+        done_->SetRetCode(-cntl.ErrorCode());
+        return;
+    }
+
+    MetaStatusCode ret = response.statuscode();
+    if (ret != MetaStatusCode::OK) {
+        LOG(WARNING) << "BatchUpdateInode: first inodeid = "
+                     << taskCtx->inodeID << ", errcode = " << ret
+                     << ", errmsg = " << MetaStatusCode_Name(ret);
+    } else {
+        static_cast<BatchUpdateInodeDone *>(done_->GetDone())
+            ->SetStatuses(response.statuses());
+    }
+
+    VLOG(6) << "BatchUpdateInode done, "
+            << "response: " << response.ShortDebugString();
+    done_->SetRetCode(ret);
+}
+
+void MetaServerClientImpl::BatchUpdateInodeAsync(
+    uint32_t fsId, std::shared_ptr<BatchUpdateInodeRequest> request,
+    std::vector<MetaServerClientDone *> &&dones) {
+    auto task = AsyncRPCTask {
+        (void)txId;
+        metric_.batchUpdateInode.qps.count << 1;
+
+        request->set_poolid(poolID);
+        request->set_copysetid(copysetID);
+        request->set_partitionid(partitionID);
+        for (auto &update : *request->mutable_updates()) {
+            update.set_poolid(poolID);
+            update.set_copysetid(copysetID);
+            update.set_partitionid(partitionID);
+        }
+        VLOG(9) << "batch update inode async, partitionid: " << partitionID
+                << ", size: " << request->updates_size();
+
+        auto *rpcDone = new BatchUpdateInodeRpcDone(taskExecutorDone, &metric_);
+        curvefs::metaserver::MetaServerService_Stub stub(channel);
+        stub.BatchUpdateInode(cntl, request.get(), &rpcDone->response,
+                              rpcDone);
+        return MetaStatusCode::OK;
+    };
+
+    metric_.batchUpdateInodeSize << request->updates_size();
+    metric_.batchUpdateInodeSavedRpc << request->updates_size() - 1;
+
+    auto taskCtx = std::make_shared<TaskContext>(
+        MetaServerOpType::BatchUpdateInode, task, fsId,
+        request->updates(0).inodeid());
+    auto excutor = std::make_shared<BatchUpdateInodeExcutor>(
+        opt_, metaCache_, channelManager_, std::move(taskCtx));
+    TaskExecutorDone *taskDone =
+        new TaskExecutorDone(excutor, new BatchUpdateInodeDone(dones));
+    excutor->DoAsyncRPCTask(taskDone);
+}
+
+void MetaServerClientImpl::BatchUpdateInodeWithOutNlinkAsync(
+    uint32_t fsId, std::vector<InodeUpdate> &&updates) {
+    struct Batch {
+        std::shared_ptr<BatchUpdateInodeRequest> request;
+        std::vector<MetaServerClientDone *> dones;
+    };
+
+    std::unordered_map<uint32_t, Batch> batches;
+    for (auto &update : updates) {
+        uint32_t partitionId = 0;
+        if (!metaCache_->GetPartitionIdByInodeId(fsId, update.inodeId,
+                                                 &partitionId)) {
+            // let the normal update path to retry and refresh partitions
+            UpdateInodeWithOutNlinkAsync(fsId, update.inodeId, update.attr,
+                                         update.done,
+                                         std::move(update.indices));
+            continue;
+        }
+
+        auto &batch = batches[partitionId];
+        if (batch.request == nullptr) {
+            batch.request = std::make_shared<BatchUpdateInodeRequest>();
+            batch.request->set_fsid(fsId);
+        }
+        auto *request = batch.request->add_updates();
+        FillInodeAttr(fsId, update.inodeId, update.attr, /*nlink=*/false,
+                      request);
+        FillDataIndices(std::move(update.indices), request);
+        batch.dones.push_back(update.done);
+
+        if (batch.dones.size() >= opt_.batchInodeAttrLimit) {
+            BatchUpdateInodeAsync(fsId, std::move(batch.request),
+                                  std::move(batch.dones));
+            batches.erase(partitionId);
+        }
+    }
+
+    for (auto &item : batches) {
+        BatchUpdateInodeAsync(fsId, std::move(item.second.request),
+                              std::move(item.second.dones));
+    }
+}
+
 bool MetaServerClientImpl::ParseS3MetaStreamBuffer(butil::IOBuf *buffer,
                                                    uint64_t *chunkIndex,
                                                    S3ChunkInfoList *list) {
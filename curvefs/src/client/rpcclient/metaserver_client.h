@@ -72,6 +72,16 @@ struct DataIndices {
     absl::optional<VolumeExtentSliceList> volumeExtents;
 };
 
+// An inode update which will be shipped together with other updates
+// belonging to the same partition, see BatchUpdateInodeWithOutNlinkAsync().
+struct InodeUpdate {
+    uint64_t inodeId = 0;
+    InodeAttr attr;
+    DataIndices indices;
+    // invoked with the status of this update, can be nullptr
+    MetaServerClientDone* done = nullptr;
+};
+
 inline void SetCreateTime(Time* tm) {
     struct timespec now;
     clock_gettime(CLOCK_REALTIME, &now);
@@ -110,6 +120,15 @@ class MetaServerClient {
     virtual MetaStatusCode
     PrepareRenameTx(const std::vector<Dentry> &dentrys) = 0;
 
+    // whether the partitions of the two inodes are in the same copyset
+    virtual bool IsSameCopyset(uint32_t fsId, uint64_t inodeId,
+                               uint64_t otherInodeId) = 0;
+
+    // rename |srcDentry| to |dstDentry| by one raft op, the txid of them
+    // are filled by the partition they belong to
+    virtual MetaStatusCode RenameDentry(const Dentry &srcDentry,
+                                        const Dentry &dstDentry) = 0;
+
     virtual MetaStatusCode GetInode(uint32_t fsId, uint64_t inodeid,
                                     Inode *out, bool* streaming) = 0;
 
@@ -146,6 +165,12 @@ class MetaServerClient {
         MetaServerClientDone* done,
         DataIndices&& indices = {}) = 0;
 
+    // Update a set of inodes asynchronously, updates are grouped by
+    // partition and each group is sent in one rpc.
+    virtual void BatchUpdateInodeWithOutNlinkAsync(
+        uint32_t fsId,
+        std::vector<InodeUpdate>&& updates) = 0;
+
     virtual MetaStatusCode GetOrModifyS3ChunkInfo(
         uint32_t fsId, uint64_t inodeId,
         const google::protobuf::Map<
@@ -217,6 +242,12 @@ class MetaServerClientImpl : public MetaServerClient {
 
     MetaStatusCode PrepareRenameTx(const std::vector<Dentry> &dentrys) override;
 
+    bool IsSameCopyset(uint32_t fsId, uint64_t inodeId,
+                       uint64_t otherInodeId) override;
+
+    MetaStatusCode RenameDentry(const Dentry &srcDentry,
+                                const Dentry &dstDentry) override;
+
     MetaStatusCode GetInode(uint32_t fsId, uint64_t inodeid,
                             Inode *out, bool* streaming) override;
 
@@ -254,6 +285,10 @@ class MetaServerClientImpl : public MetaServerClient {
         MetaServerClientDone* done,
         DataIndices&& indices = {}) override;
 
+    void BatchUpdateInodeWithOutNlinkAsync(
+        uint32_t fsId,
+        std::vector<InodeUpdate>&& updates) override;
+
     MetaStatusCode GetOrModifyS3ChunkInfo(
         uint32_t fsId, uint64_t inodeId,
         const google::protobuf::Map<
@@ -301,6 +336,11 @@ class MetaServerClientImpl : public MetaServerClient {
     void UpdateInodeAsync(const UpdateInodeRequest &request,
                           MetaServerClientDone *done);
 
+    void BatchUpdateInodeAsync(
+        uint32_t fsId,
+        std::shared_ptr<metaserver::BatchUpdateInodeRequest> request,
+        std::vector<MetaServerClientDone *> &&dones);
+
     bool ParseS3MetaStreamBuffer(butil::IOBuf* buffer,
                                  uint64_t* chunkIndex,
                                  S3ChunkInfoList* list);
@@ -1,5 +1,5 @@
 /*
- *  Copyright (c) 2022 NetEase Inc.
+ *  Copyright (c) 2026 NetEase Inc.
  *
  *  Licensed under the Apache License, Version 2.0 (the "License");
  *  you may not use this file except in compliance with the License.
@@ -15,17 +15,32 @@
  */
 
 /*
- * Project: curve
- * Created Date: 2022-10-08
- * Author: YangFan (fansehep)
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
  */
 
-#include "curvefs/src/client/kvclient/memcache_client.h"
+#include "curvefs/src/client/rpcclient/partition_index.h"
+
+#include <utility>
 
 namespace curvefs {
 namespace client {
+namespace rpcclient {
+
+PartitionIndex::PartitionIndex(RouteList routes) : routes_(std::move(routes)) {
+    std::sort(routes_.begin(), routes_.end(),
+              [](const std::shared_ptr<PartitionRoute>& lhs,
+                 const std::shared_ptr<PartitionRoute>& rhs) {
+                  return lhs->start < rhs->start;
+              });
 
-thread_local memcached_st* tcli = nullptr;
+    starts_.reserve(routes_.size());
+    for (const auto& route : routes_) {
+        starts_.push_back(route->start);
+    }
+}
 
+}  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_RPCCLIENT_PARTITION_INDEX_H_
+#define CURVEFS_SRC_CLIENT_RPCCLIENT_PARTITION_INDEX_H_
+
+#include <butil/endpoint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "curvefs/src/client/common/common.h"
+#include "src/client/client_common.h"
+
+namespace curvefs {
+namespace client {
+namespace rpcclient {
+
+using ::curve::client::CopysetID;
+using ::curve::client::LogicPoolID;
+using ::curvefs::client::common::MetaserverID;
+using ::curvefs::client::common::PartitionID;
+
+// Cached leader of a copyset, it's shared by all routes of the copyset.
+// Writers are serialized by the caller, readers never block (seqlock).
+class LeaderCache {
+ public:
+    void Set(MetaserverID metaServerID, const butil::EndPoint& endPoint) {
+        Store(true, metaServerID, butil::ip2int(endPoint.ip), endPoint.port);
+    }
+
+    void Invalidate() { Store(false, 0, 0, 0); }
+
+    // return false if the leader is unknown or may change
+    bool Get(MetaserverID* metaServerID, butil::EndPoint* endPoint) const {
+        bool valid;
+        MetaserverID id;
+        uint32_t ip;
+        int port;
+        uint64_t seq;
+        do {
+            seq = seq_.load(std::memory_order_acquire);
+            valid = valid_.load(std::memory_order_relaxed);
+            id = metaServerID_.load(std::memory_order_relaxed);
+            ip = ip_.load(std::memory_order_relaxed);
+            port = port_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) != 0 || seq != seq_.load(std::memory_order_relaxed));
+
+        if (!valid) {
+            return false;
+        }
+        *metaServerID = id;
+        *endPoint = butil::EndPoint(butil::int2ip(ip), port);
+        return true;
+    }
+
+ private:
+    void Store(bool valid, MetaserverID id, uint32_t ip, int port) {
+        const uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        valid_.store(valid, std::memory_order_relaxed);
+        metaServerID_.store(id, std::memory_order_relaxed);
+        ip_.store(ip, std::memory_order_relaxed);
+        port_.store(port, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+ private:
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<bool> valid_{false};
+    std::atomic<MetaserverID> metaServerID_{0};
+    std::atomic<uint32_t> ip_{0};
+    std::atomic<int> port_{0};
+};
+
+// Everything needed to send a request to the partition, except the leader
+// is kept in the shared LeaderCache of its copyset.
+struct PartitionRoute {
+    uint32_t fsID = 0;
+    PartitionID partitionID = 0;
+    LogicPoolID poolID = 0;
+    CopysetID copysetID = 0;
+    // inode range [start, end]
+    uint64_t start = 0;
+    uint64_t end = 0;
+    std::atomic<uint64_t> txId{0};
+    std::shared_ptr<LeaderCache> leader;
+};
+
+// Immutable index of partitions sorted by the start of their inode range,
+// it's rebuilt and republished whenever partitions are added or reset.
+class PartitionIndex {
+ public:
+    using RouteList = std::vector<std::shared_ptr<PartitionRoute>>;
+
+    PartitionIndex() = default;
+
+    // the inode ranges of |routes| must not overlap
+    explicit PartitionIndex(RouteList routes);
+
+    // find the partition which contains |inodeID| by binary search,
+    // return nullptr if not found
+    const PartitionRoute* Find(uint64_t inodeID) const {
+        auto iter = std::upper_bound(starts_.begin(), starts_.end(), inodeID);
+        if (iter == starts_.begin()) {
+            return nullptr;
+        }
+        const auto* route = routes_[iter - starts_.begin() - 1].get();
+        return route->end >= inodeID ? route : nullptr;
+    }
+
+    size_t Size() const { return routes_.size(); }
+
+ private:
+    std::vector<uint64_t> starts_;
+    RouteList routes_;
+};
+
+}  // namespace rpcclient
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_RPCCLIENT_PARTITION_INDEX_H_
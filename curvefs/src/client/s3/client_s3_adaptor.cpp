@@ -212,6 +212,28 @@ int S3ClientAdaptorImpl::Read(uint64_t inodeId, uint64_t offset,
     return ret;
 }
 
+int S3ClientAdaptorImpl::ReadZeroCopy(uint64_t inodeId, uint64_t offset,
+                                      uint64_t length, ReadBuffer *buffer) {
+    VLOG(6) << "read zero copy start offset:" << offset << ", len:" << length
+            << ", fsId:" << fsId_ << ", inodeId:" << inodeId;
+    uint64_t start = butil::cpuwide_time_us();
+    FileCacheManagerPtr fileCacheManager =
+        fsCacheManager_->FindOrCreateFileCacheManager(fsId_, inodeId);
+
+    int ret = fileCacheManager->ReadZeroCopy(inodeId, offset, length, buffer);
+    VLOG(6) << "read zero copy end inodeId:" << inodeId << ",ret:" << ret
+            << ", ranges:" << buffer->NumRanges();
+    if (ret < 0) {
+        return ret;
+    }
+    if (s3Metric_.get() != nullptr) {
+        curve::client::CollectMetrics(&s3Metric_->adaptorRead, ret,
+                                      butil::cpuwide_time_us() - start);
+        s3Metric_->readSize.set_value(length);
+    }
+    return ret;
+}
+
 CURVEFS_ERROR S3ClientAdaptorImpl::Truncate(InodeWrapper *inodeWrapper,
                                             uint64_t size) {
     const auto *inode = inodeWrapper->GetInodeLocked();
@@ -81,6 +81,8 @@ class S3ClientAdaptor {
                       const char *buf) = 0;
     virtual int Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                      char *buf) = 0;
+    virtual int ReadZeroCopy(uint64_t inodeId, uint64_t offset,
+                             uint64_t length, ReadBuffer *buffer) = 0;
     virtual CURVEFS_ERROR Truncate(InodeWrapper *inodeWrapper,
                                    uint64_t size) = 0;
     virtual void ReleaseCache(uint64_t inodeId) = 0;
@@ -137,6 +139,8 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     int Write(uint64_t inodeId, uint64_t offset, uint64_t length,
               const char *buf);
     int Read(uint64_t inodeId, uint64_t offset, uint64_t length, char *buf);
+    int ReadZeroCopy(uint64_t inodeId, uint64_t offset, uint64_t length,
+                     ReadBuffer *buffer);
     CURVEFS_ERROR Truncate(InodeWrapper *inodeWrapper, uint64_t size);
     void ReleaseCache(uint64_t inodeId);
     CURVEFS_ERROR Flush(uint64_t inodeId);
@@ -24,6 +24,7 @@
 
 #include <bvar/bvar.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <utility>
 
@@ -143,6 +144,9 @@ bool FsCacheManager::Set(DataCachePtr dataCache,
     if (readCacheMaxByte_ == 0) {
         return false;
     }
+    if (arcReadCache_) {
+        return ArcSet(std::move(dataCache), outIter);
+    }
     // trim cache without consider dataCache's size, because its size is
     // expected to be very smaller than `readCacheMaxByte_`
     if (lruByte_ >= readCacheMaxByte_) {
@@ -181,6 +185,21 @@ void FsCacheManager::Get(std::list<DataCachePtr>::iterator iter) {
         return;
     }
 
+    if ((*iter)->InFrequentList()) {
+        frequentReadDataCacheList_.splice(frequentReadDataCacheList_.begin(),
+                                          frequentReadDataCacheList_, iter);
+        return;
+    }
+
+    if (arcReadCache_) {
+        // read again, move it to frequent list
+        (*iter)->SetFrequentList(true);
+        recentByte_ -= (*iter)->GetActualLen();
+        frequentReadDataCacheList_.splice(frequentReadDataCacheList_.begin(),
+                                          lruReadDataCacheList_, iter);
+        return;
+    }
+
     lruReadDataCacheList_.splice(lruReadDataCacheList_.begin(),
                                  lruReadDataCacheList_, iter);
 }
@@ -194,10 +213,139 @@ bool FsCacheManager::Delete(std::list<DataCachePtr>::iterator iter) {
 
     (*iter)->SetReadCacheState(false);
     lruByte_ -= (*iter)->GetActualLen();
+    if ((*iter)->InFrequentList()) {
+        frequentReadDataCacheList_.erase(iter);
+        return true;
+    }
+    if (arcReadCache_) {
+        recentByte_ -= (*iter)->GetActualLen();
+    }
     lruReadDataCacheList_.erase(iter);
     return true;
 }
 
+bool FsCacheManager::ArcSet(DataCachePtr dataCache,
+                            std::list<DataCachePtr>::iterator *outIter) {
+    uint64_t len = dataCache->GetActualLen();
+    GhostKey key = GhostKeyOf(dataCache);
+    bool frequent = false;
+    bool hitFrequentGhost = false;
+
+    // the data cache was evicted recently, it is read repeatedly, adapt
+    // the target size of recent list to the ghost list which it hits
+    if (recentGhost_.Contains(key)) {
+        uint64_t ratio = std::max<uint64_t>(
+            1, frequentGhost_.Bytes() / recentGhost_.Bytes());
+        recentTargetByte_ =
+            std::min(readCacheMaxByte_, recentTargetByte_ + ratio * len);
+        recentGhost_.Erase(key);
+        frequent = true;
+    } else if (frequentGhost_.Contains(key)) {
+        uint64_t ratio = std::max<uint64_t>(
+            1, recentGhost_.Bytes() / frequentGhost_.Bytes());
+        recentTargetByte_ -= std::min(recentTargetByte_, ratio * len);
+        frequentGhost_.Erase(key);
+        frequent = true;
+        hitFrequentGhost = true;
+    }
+
+    if (lruByte_ >= readCacheMaxByte_) {
+        std::list<DataCachePtr> retired;
+        ArcReplace(hitFrequentGhost, &retired);
+        VLOG(3) << "arc release " << retired.size() << " data cache"
+                << ", recent byte: " << recentByte_
+                << ", recent target byte: " << recentTargetByte_;
+        releaseReadCache_.Release(&retired);
+    }
+
+    lruByte_ += len;
+    dataCache->SetReadCacheState(true);
+    dataCache->SetFrequentList(frequent);
+    if (frequent) {
+        frequentReadDataCacheList_.push_front(std::move(dataCache));
+        *outIter = frequentReadDataCacheList_.begin();
+    } else {
+        recentByte_ += len;
+        lruReadDataCacheList_.push_front(std::move(dataCache));
+        *outIter = lruReadDataCacheList_.begin();
+    }
+    ArcTrimGhost();
+    return true;
+}
+
+void FsCacheManager::ArcReplace(bool hitFrequentGhost,
+                                std::list<DataCachePtr> *retired) {
+    while (lruByte_ >= readCacheMaxByte_) {
+        bool fromRecent =
+            !lruReadDataCacheList_.empty() &&
+            (frequentReadDataCacheList_.empty() ||
+             recentByte_ > recentTargetByte_ ||
+             (hitFrequentGhost && recentByte_ == recentTargetByte_));
+        auto &list =
+            fromRecent ? lruReadDataCacheList_ : frequentReadDataCacheList_;
+        auto &ghost = fromRecent ? recentGhost_ : frequentGhost_;
+
+        auto iter = std::prev(list.end());
+        auto &trim = *iter;
+        uint64_t len = trim->GetActualLen();
+        trim->SetReadCacheState(false);
+        // data read repeatedly is kept in disk cache preferentially
+        trim->SetDemoted(!fromRecent);
+        ghost.PushFront(GhostKeyOf(trim), len);
+        lruByte_ -= len;
+        if (fromRecent) {
+            recentByte_ -= len;
+        }
+        retired->splice(retired->end(), list, iter);
+    }
+}
+
+void FsCacheManager::ArcTrimGhost() {
+    while (!recentGhost_.Empty() &&
+           recentByte_ + recentGhost_.Bytes() > readCacheMaxByte_) {
+        recentGhost_.PopBack();
+    }
+    while (!frequentGhost_.Empty() &&
+           lruByte_ + recentGhost_.Bytes() + frequentGhost_.Bytes() >
+               2 * readCacheMaxByte_) {
+        frequentGhost_.PopBack();
+    }
+}
+
+FsCacheManager::GhostKey FsCacheManager::GhostKeyOf(
+    const DataCachePtr &dataCache) {
+    auto *chunk = dataCache->GetChunkCacheManager();
+    return GhostKey{chunk->GetInodeId(), chunk->GetIndex(),
+                    dataCache->GetChunkPos()};
+}
+
+size_t FsCacheManager::GhostKeyHash::operator()(const GhostKey &key) const {
+    uint64_t hash = key.inodeId * 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ key.chunkIndex) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ key.chunkPos;
+}
+
+void FsCacheManager::GhostList::PushFront(const GhostKey &key, uint64_t len) {
+    Erase(key);
+    list_.emplace_front(key, len);
+    map_[key] = list_.begin();
+    bytes_ += len;
+}
+
+void FsCacheManager::GhostList::Erase(const GhostKey &key) {
+    auto iter = map_.find(key);
+    if (iter == map_.end()) {
+        return;
+    }
+    bytes_ -= iter->second->second;
+    list_.erase(iter->second);
+    map_.erase(iter);
+}
+
+void FsCacheManager::GhostList::PopBack() {
+    Erase(list_.back().first);
+}
+
 CURVEFS_ERROR FsCacheManager::FsSync(bool force) {
     CURVEFS_ERROR ret;
     std::unordered_map<uint64_t, FileCacheManagerPtr> tmp;
@@ -206,10 +354,14 @@ CURVEFS_ERROR FsCacheManager::FsSync(bool force) {
         tmp = fileCacheManagerMap_;
     }
 
+    // chunks uploaded by each file are shipped to metaserver in batches
+    // while the following files are still uploading
+    auto inodeManager = s3ClientAdaptor_->GetInodeCacheManager();
     auto iter = tmp.begin();
     for (; iter != tmp.end(); iter++) {
         ret = iter->second->Flush(force);
         if (ret == CURVEFS_ERROR::OK) {
+            inodeManager->SyncPending(false);
             WriteLockGuard writeLockGuard(rwLock_);
             auto iter1 = fileCacheManagerMap_.find(iter->first);
             if (iter1 == fileCacheManagerMap_.end()) {
@@ -248,6 +400,7 @@ CURVEFS_ERROR FsCacheManager::FsSync(bool force) {
         }
     }
 
+    inodeManager->SyncPending(force);
     return CURVEFS_ERROR::OK;
 }
 
@@ -307,7 +460,7 @@ FileCacheManager::FindOrCreateChunkCacheManager(uint64_t index) {
 
     ChunkCacheManagerPtr chunkCacheManager =
         std::make_shared<ChunkCacheManager>(index, s3ClientAdaptor_,
-                                            kvClientManager_);
+                                            kvClientManager_, inode_);
     auto ret = chunkCacheMap_.emplace(index, chunkCacheManager);
     g_s3MultiManagerMetric->chunkManagerNum << 1;
     assert(ret.second);
@@ -335,7 +488,7 @@ void FileCacheManager::GetBlockLoc(uint64_t offset, uint64_t *chunkIndex,
 
 void FileCacheManager::ReadFromMemCache(
     uint64_t offset, uint64_t length, char *dataBuf, uint64_t *actualReadLen,
-    std::vector<ReadRequest> *memCacheMissRequest) {
+    std::vector<ReadRequest> *memCacheMissRequest, ReadBuffer *buffer) {
 
     uint64_t index = 0, chunkPos = 0, chunkSize = 0;
     GetChunkLoc(offset, &index, &chunkPos, &chunkSize);
@@ -359,7 +512,8 @@ void FileCacheManager::ReadFromMemCache(
             FindOrCreateChunkCacheManager(index);
         std::vector<ReadRequest> tmpMissRequests;
         chunkCacheManager->ReadChunk(index, chunkPos, currentReadLen, dataBuf,
-                                     dataBufferOffset, &tmpMissRequests);
+                                     dataBufferOffset, &tmpMissRequests,
+                                     buffer);
         memCacheMissRequest->insert(memCacheMissRequest->end(),
                                     tmpMissRequests.begin(),
                                     tmpMissRequests.end());
@@ -486,6 +640,158 @@ int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
     return actualReadLen;
 }
 
+int FileCacheManager::ReadZeroCopy(uint64_t inodeId, uint64_t offset,
+                                   uint64_t length, ReadBuffer *buffer) {
+    char *dataBuf = buffer->Data();
+
+    // 1. reference the pages of memory read cache, copy the others
+    uint64_t actualReadLen = 0;
+    std::vector<ReadRequest> memCacheMissRequest;
+    ReadFromMemCache(offset, length, dataBuf, &actualReadLen,
+                     &memCacheMissRequest, buffer);
+    if (memCacheMissRequest.empty()) {
+        return actualReadLen;
+    }
+
+    // 2. reference the blocks in localcache, read the others from
+    //    remote cluster
+    std::shared_ptr<InodeWrapper> inodeWrapper;
+    auto inodeManager = s3ClientAdaptor_->GetInodeCacheManager();
+    if (CURVEFS_ERROR::OK != inodeManager->GetInode(inodeId, inodeWrapper)) {
+        LOG(ERROR) << "get inode = " << inodeId << " fail";
+        return -1;
+    }
+
+    std::vector<S3ReadRequest> kvRequests;
+    GenerateKVRequest(inodeWrapper, memCacheMissRequest, dataBuf,
+                      &kvRequests);
+
+    std::vector<S3ReadRequest> missRequests;
+    for (const auto &req : kvRequests) {
+        if (!s3ClientAdaptor_->HasDiskCache() ||
+            !ReadKVRequestZeroCopy(req, buffer)) {
+            missRequests.emplace_back(req);
+        }
+    }
+    if (missRequests.empty()) {
+        return actualReadLen;
+    }
+
+    ReadStatus ret =
+        ReadKVRequest(missRequests, dataBuf, inodeWrapper->GetLength());
+    if (ret == ReadStatus::OK) {
+        return actualReadLen;
+    } else if (ret == ReadStatus::S3_NOT_EXIST) {
+        // the s3chunkinfo maybe compacted, let normal read path
+        // to refresh it and retry
+        buffer->DropRanges();
+        return Read(inodeId, offset, length, dataBuf);
+    }
+
+    LOG(INFO) << "read inode = " << inodeId
+              << " from s3 failed, ret = " << static_cast<int>(ret);
+    return static_cast<int>(ret);
+}
+
+bool FileCacheManager::ForEachBlock(const S3ReadRequest &req,
+                                    const BlockFunc &func) {
+    uint64_t chunkIndex = 0;
+    uint64_t chunkPos = 0;
+    uint64_t blockIndex = 0;
+    uint64_t blockPos = 0;
+    const uint64_t blockSize = s3ClientAdaptor_->GetBlockSize();
+    const uint32_t objectPrefix = s3ClientAdaptor_->GetObjectPrefix();
+    GetBlockLoc(req.offset, &chunkIndex, &chunkPos, &blockIndex, &blockPos);
+
+    // read request
+    // |--------------------------------|----------------------------------|
+    // 0                             blockSize                   2*blockSize
+    //                blockPos                   length + blockPos
+    //                   |-------------------------|
+    //                   |--------------|
+    //                    currentReadLen
+    uint64_t length = req.len;
+    uint64_t currentReadLen = 0;
+    uint64_t readBufOffset = 0;
+    uint64_t objectOffset = req.objectOffset;
+    while (length > 0) {
+        currentReadLen =
+            length + blockPos > blockSize ? blockSize - blockPos : length;
+        assert(blockPos >= objectOffset);
+        std::string name = curvefs::common::s3util::GenObjName(
+            req.chunkId, blockIndex, req.compaction, req.fsId, req.inodeId,
+            objectPrefix);
+        if (!func(std::move(name), req.readOffset + readBufOffset,
+                  blockPos - objectOffset, currentReadLen)) {
+            return false;
+        }
+
+        // update param
+        {
+            length -= currentReadLen;         // Remaining read data length
+            readBufOffset += currentReadLen;  // next read offset
+            blockIndex++;
+            blockPos = (blockPos + currentReadLen) % blockSize;
+            objectOffset = 0;
+        }
+    }
+    return true;
+}
+
+bool FileCacheManager::ReadKVRequestZeroCopy(const S3ReadRequest &req,
+                                             ReadBuffer *buffer) {
+    struct FileRange {
+        uint64_t offset;
+        int fd;
+        uint64_t pos;
+        uint64_t length;
+    };
+
+    uint64_t start = butil::cpuwide_time_us();
+    std::vector<FileRange> ranges;
+    auto defer = absl::MakeCleanup([&]() {
+        for (const auto &range : ranges) {
+            ::close(range.fd);
+        }
+    });
+
+    bool ok = ForEachBlock(req, [&](std::string &&name, uint64_t bufOffset,
+                                    uint64_t pos, uint64_t len) {
+        if (!IsCachedInLocal(name)) {
+            VLOG(9) << "not cachd in disk, " << name;
+            return false;
+        }
+
+        int fd = -1;
+        if (s3ClientAdaptor_->GetDiskCacheManager()->Open(name, pos, len,
+                                                          &fd) < 0) {
+            LOG(WARNING) << "object " << name << " not cached in disk";
+            return false;
+        }
+        ranges.emplace_back(FileRange{bufOffset, fd, pos, len});
+        return true;
+    });
+    if (!ok) {
+        return false;
+    }
+
+    // the fds are owned by buffer now
+    for (const auto &range : ranges) {
+        buffer->AddFile(range.offset, range.fd, range.pos, range.length);
+    }
+    ranges.clear();
+
+    if (s3ClientAdaptor_->s3Metric_) {
+        curve::client::CollectMetrics(
+            &s3ClientAdaptor_->s3Metric_->adaptorReadS3, req.len,
+            butil::cpuwide_time_us() - start);
+        curve::client::CollectMetrics(
+            &s3ClientAdaptor_->s3Metric_->readFromDiskCache, req.len,
+            butil::cpuwide_time_us() - start);
+    }
+    return true;
+}
+
 bool FileCacheManager::ReadKVRequestFromLocalCache(const std::string& name,
                                                    char* databuf,
                                                    uint64_t offset,
@@ -529,31 +835,33 @@ bool FileCacheManager::ReadKVRequestFromLocalCache(const std::string& name,
     return true;
 }
 
-bool FileCacheManager::ReadKVRequestFromRemoteCache(const std::string &name,
-                                                    char *databuf,
-                                                    uint64_t offset,
-                                                    uint64_t length) {
-    if (!kvClientManager_) {
-        return false;
+void FileCacheManager::ReadKVRequestFromRemoteCache(
+    std::vector<KVGetRequest> *requests) {
+    if (!kvClientManager_ || requests->empty()) {
+        return;
     }
 
-    CountDownEvent event(1);
-    GetKVCacheDone cb = [&](const std::shared_ptr<GetKVCacheTask>& task) {
-        if (task->res && s3ClientAdaptor_->s3Metric_ != nullptr) {
-            curve::client::CollectMetrics(
-                &s3ClientAdaptor_->s3Metric_->readFromKVCache, task->length,
-                task->timer.u_elapsed());
-        }
-        event.Signal();
-        return;
-    };
+    CountDownEvent event(requests->size());
+    std::vector<std::shared_ptr<GetKVCacheTask>> tasks;
+    tasks.reserve(requests->size());
+    for (auto &req : *requests) {
+        KVGetRequest *request = &req;
+        GetKVCacheDone cb = [this, request, &event](
+                                const std::shared_ptr<GetKVCacheTask> &task) {
+            request->res = task->res;
+            if (task->res && s3ClientAdaptor_->s3Metric_ != nullptr) {
+                curve::client::CollectMetrics(
+                    &s3ClientAdaptor_->s3Metric_->readFromKVCache,
+                    task->length, task->timer.u_elapsed());
+            }
+            event.Signal();
+        };
+        tasks.emplace_back(std::make_shared<GetKVCacheTask>(
+            req.key, req.value, req.offset, req.length, std::move(cb)));
+    }
 
-    auto task =
-        std::make_shared<GetKVCacheTask>(name, databuf, offset, length, cb);
-    kvClientManager_->Get(task);
+    kvClientManager_->MGet(std::move(tasks));
     event.Wait();
-
-    return task->res;
 }
 
 bool FileCacheManager::ReadKVRequestFromS3(const std::string &name,
@@ -648,67 +956,49 @@ void FileCacheManager::ProcessKVRequest(const S3ReadRequest &req, char *dataBuf,
         PrefetchForBlock(req, fileLen, blockSize, chunkSize, blockIndex);
     }
 
-    // read request
-    // |--------------------------------|----------------------------------|
-    // 0                             blockSize                   2*blockSize
-    //                blockPos                   length + blockPos
-    //                   |-------------------------|
-    //                   |--------------|
-    //                    currentReadLen
-    uint64_t length = req.len;
-    uint64_t currentReadLen = 0;
-    uint64_t readBufOffset = 0;
-    uint64_t objectOffset = req.objectOffset;
+    std::vector<std::string> objNames;
+    // blocks missed in local cache
+    std::vector<KVGetRequest> missRequests;
 
-    while (length > 0) {
-        currentReadLen =
-            length + blockPos > blockSize ? blockSize - blockPos : length;
-        assert(blockPos >= objectOffset);
-        std::string name = curvefs::common::s3util::GenObjName(
-            req.chunkId, blockIndex, req.compaction, req.fsId, req.inodeId,
-            objectPrefix);
-        char *currentBuf = dataBuf + req.readOffset + readBufOffset;
+    ForEachBlock(req, [&](std::string &&name, uint64_t bufOffset,
+                          uint64_t pos, uint64_t len) {
+        if (s3ClientAdaptor_->HasDiskCache()) {
+            objNames.emplace_back(name);
+        }
+        char *currentBuf = dataBuf + bufOffset;
 
         // read from localcache -> remotecache -> s3
-        do {
-            if (ReadKVRequestFromLocalCache(name, currentBuf,
-                                            blockPos - objectOffset,
-                                            currentReadLen)) {
-                VLOG(9) << "read " << name << " from local cache ok";
-                break;
-            }
-
-            if (ReadKVRequestFromRemoteCache(name, currentBuf,
-                                             blockPos - objectOffset,
-                                             currentReadLen)) {
-                VLOG(9) << "read " << name << " from remote cache ok";
-                break;
-            }
-
-            int ret = 0;
-            if (ReadKVRequestFromS3(name, currentBuf, blockPos - objectOffset,
-                                    currentReadLen, &ret)) {
-                VLOG(9) << "read " << name << " from s3 ok";
-                break;
-            }
-
-            LOG(ERROR) << "read " << name << " fail";
-            // make sure variable is set only once
-            std::call_once(cancelFlag, [&]() {
-                isCanceled.store(true);
-                retCode.store(ret);
-            });
-            return;
-        } while (false);
+        if (ReadKVRequestFromLocalCache(name, currentBuf, pos, len)) {
+            VLOG(9) << "read " << name << " from local cache ok";
+        } else {
+            missRequests.emplace_back(std::move(name), currentBuf, pos, len);
+        }
+        return true;
+    });
+
+    // read blocks missed in local cache from remote cache by one batch,
+    // and then from s3 for the rest
+    ReadKVRequestFromRemoteCache(&missRequests);
+    for (const auto &missReq : missRequests) {
+        if (missReq.res) {
+            VLOG(9) << "read " << missReq.key << " from remote cache ok";
+            continue;
+        }
 
-        // update param
-        {
-            length -= currentReadLen;         // Remaining read data length
-            readBufOffset += currentReadLen;  // next read offset
-            blockIndex++;
-            blockPos = (blockPos + currentReadLen) % blockSize;
-            objectOffset = 0;
+        int ret = 0;
+        if (ReadKVRequestFromS3(missReq.key, missReq.value, missReq.offset,
+                                missReq.length, &ret)) {
+            VLOG(9) << "read " << missReq.key << " from s3 ok";
+            continue;
         }
+
+        LOG(ERROR) << "read " << missReq.key << " fail";
+        // make sure variable is set only once
+        std::call_once(cancelFlag, [&]() {
+            isCanceled.store(true);
+            retCode.store(ret);
+        });
+        return;
     }
 
     // add data to memory read cache
@@ -718,6 +1008,7 @@ void FileCacheManager::ProcessKVRequest(const S3ReadRequest &req, char *dataBuf,
         DataCachePtr dataCache = std::make_shared<DataCache>(
             s3ClientAdaptor_, chunkCacheManager, chunkPos, req.len,
             dataBuf + req.readOffset, kvClientManager_);
+        dataCache->SetObjectNames(std::move(objNames));
         chunkCacheManager->AddReadDataCache(dataCache);
     }
 }
@@ -1227,10 +1518,23 @@ bool FileCacheManager::IsCachedInLocal(const std::string name) {
 void ChunkCacheManager::ReadChunk(uint64_t index, uint64_t chunkPos,
                                   uint64_t readLen, char *dataBuf,
                                   uint64_t dataBufOffset,
-                                  std::vector<ReadRequest> *requests) {
+                                  std::vector<ReadRequest> *requests,
+                                  ReadBuffer *buffer) {
     (void)index;
     ReadLockGuard readLockGuard(rwLockChunk_);
     std::vector<ReadRequest> cacheMissWriteRequests, cacheMissFlushDataRequest;
+    // write caches and flushing data are modified in place, so only the
+    // pages of read caches can be shared
+    auto readByReadCache = [&](const ReadRequest &request,
+                               std::vector<ReadRequest> *tmpRequests) {
+        if (buffer != nullptr) {
+            ReadByReadCacheZeroCopy(request.chunkPos, request.len,
+                                    request.bufOffset, buffer, tmpRequests);
+        } else {
+            ReadByReadCache(request.chunkPos, request.len, dataBuf,
+                            request.bufOffset, tmpRequests);
+        }
+    };
     // read by write cache
     ReadByWriteCache(chunkPos, readLen, dataBuf, dataBufOffset,
                      &cacheMissWriteRequests);
@@ -1252,8 +1556,7 @@ void ChunkCacheManager::ReadChunk(uint64_t index, uint64_t chunkPos,
         // read by read cache
         for (auto request : cacheMissFlushDataRequest) {
             std::vector<ReadRequest> tmpRequests;
-            ReadByReadCache(request.chunkPos, request.len, dataBuf,
-                            request.bufOffset, &tmpRequests);
+            readByReadCache(request, &tmpRequests);
             requests->insert(requests->end(), tmpRequests.begin(),
                              tmpRequests.end());
         }
@@ -1264,8 +1567,7 @@ void ChunkCacheManager::ReadChunk(uint64_t index, uint64_t chunkPos,
     // read by read cache
     for (auto request : cacheMissWriteRequests) {
         std::vector<ReadRequest> tmpRequests;
-        ReadByReadCache(request.chunkPos, request.len, dataBuf,
-                        request.bufOffset, &tmpRequests);
+        readByReadCache(request, &tmpRequests);
         requests->insert(requests->end(), tmpRequests.begin(),
                          tmpRequests.end());
     }
@@ -1378,6 +1680,30 @@ void ChunkCacheManager::ReadByWriteCache(uint64_t chunkPos, uint64_t readLen,
 void ChunkCacheManager::ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
                                         char *dataBuf, uint64_t dataBufOffset,
                                         std::vector<ReadRequest> *requests) {
+    ForEachReadCacheHit(
+        chunkPos, readLen, dataBufOffset, requests,
+        [&](const DataCachePtr &dataCache, uint64_t offset, uint64_t len,
+            uint64_t bufOffset) {
+            dataCache->CopyDataCacheToBuf(offset, len, dataBuf + bufOffset);
+        });
+}
+
+void ChunkCacheManager::ReadByReadCacheZeroCopy(
+    uint64_t chunkPos, uint64_t readLen, uint64_t dataBufOffset,
+    ReadBuffer *buffer, std::vector<ReadRequest> *requests) {
+    ForEachReadCacheHit(
+        chunkPos, readLen, dataBufOffset, requests,
+        [&](const DataCachePtr &dataCache, uint64_t offset, uint64_t len,
+            uint64_t bufOffset) {
+            dataCache->ShareDataCacheToBuf(offset, len, buffer, bufOffset);
+        });
+}
+
+void ChunkCacheManager::ForEachReadCacheHit(
+    uint64_t chunkPos, uint64_t readLen, uint64_t dataBufOffset,
+    std::vector<ReadRequest> *requests,
+    const std::function<void(const DataCachePtr &, uint64_t, uint64_t,
+                             uint64_t)> &readHit) {
     ReadLockGuard readLockGuard(rwLockRead_);
 
     VLOG(9) << "ReadByReadCache chunkPos:" << chunkPos << ",readLen:" << readLen
@@ -1424,9 +1750,8 @@ void ChunkCacheManager::ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
                     ------           DataCache
             */
             if (chunkPos + readLen <= dcChunkPos + dcLen) {
-                dataCache->CopyDataCacheToBuf(
-                    0, chunkPos + readLen - dcChunkPos,
-                    dataBuf + request.len + dataBufOffset);
+                readHit(dataCache, 0, chunkPos + readLen - dcChunkPos,
+                        request.len + dataBufOffset);
                 readLen = 0;
                 break;
                 /*
@@ -1434,8 +1759,7 @@ void ChunkCacheManager::ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
                         ------           DataCache
                 */
             } else {
-                dataCache->CopyDataCacheToBuf(
-                    0, dcLen, dataBuf + request.len + dataBufOffset);
+                readHit(dataCache, 0, dcLen, request.len + dataBufOffset);
                 readLen = chunkPos + readLen - (dcChunkPos + dcLen);
                 dataBufOffset = dcChunkPos + dcLen - chunkPos + dataBufOffset;
                 chunkPos = dcChunkPos + dcLen;
@@ -1448,8 +1772,8 @@ void ChunkCacheManager::ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
                    ---------           DataCache
             */
             if (chunkPos + readLen <= dcChunkPos + dcLen) {
-                dataCache->CopyDataCacheToBuf(chunkPos - dcChunkPos, readLen,
-                                              dataBuf + dataBufOffset);
+                readHit(dataCache, chunkPos - dcChunkPos, readLen,
+                        dataBufOffset);
                 readLen = 0;
                 break;
                 /*
@@ -1457,9 +1781,8 @@ void ChunkCacheManager::ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
                        ---------                DataCache
                 */
             } else {
-                dataCache->CopyDataCacheToBuf(chunkPos - dcChunkPos,
-                                              dcChunkPos + dcLen - chunkPos,
-                                              dataBuf + dataBufOffset);
+                readHit(dataCache, chunkPos - dcChunkPos,
+                        dcChunkPos + dcLen - chunkPos, dataBufOffset);
                 readLen = chunkPos + readLen - dcChunkPos - dcLen;
                 dataBufOffset = dcChunkPos + dcLen - chunkPos + dataBufOffset;
                 chunkPos = dcChunkPos + dcLen;
@@ -1874,7 +2197,7 @@ DataCache::DataCache(S3ClientAdaptorImpl *s3ClientAdaptor,
                      std::shared_ptr<KVClientManager> kvClientManager)
     : s3ClientAdaptor_(std::move(s3ClientAdaptor)),
       chunkCacheManager_(chunkCacheManager), status_(DataCacheStatus::Dirty),
-      inReadCache_(false) {
+      inReadCache_(false), inFrequentList_(false), demoted_(false) {
     uint64_t blockSize = s3ClientAdaptor->GetBlockSize();
     uint32_t pageSize = s3ClientAdaptor->GetPageSize();
     chunkPos_ = chunkPos;
@@ -2316,6 +2639,13 @@ void DataCache::Truncate(uint64_t size) {
 }
 
 void DataCache::Release() {
+    if (demoted_ && s3ClientAdaptor_->HasDiskCache()) {
+        // touch the objects in disk cache, so they are regarded as
+        // frequently used and survive the trim of disk cache longer
+        for (const auto &name : objNames_) {
+            s3ClientAdaptor_->GetDiskCacheManager()->Touch(name);
+        }
+    }
     chunkCacheManager_->ReleaseReadDataCache(chunkPos_);
 }
 
@@ -2368,6 +2698,52 @@ void DataCache::CopyDataCacheToBuf(uint64_t offset, uint64_t len, char *data) {
     return;
 }
 
+void DataCache::ShareDataCacheToBuf(uint64_t offset, uint64_t len,
+                                    ReadBuffer *buffer, uint64_t bufOffset) {
+    assert(offset + len <= len_);
+    uint64_t blockSize = s3ClientAdaptor_->GetBlockSize();
+    uint32_t pageSize = s3ClientAdaptor_->GetPageSize();
+    uint64_t newChunkPos = chunkPos_ + offset;
+    uint64_t blockIndex = newChunkPos / blockSize;
+    uint64_t blockPos = newChunkPos % blockSize;
+    uint64_t pagePos, pageIndex;
+    uint64_t n, m, blockLen;
+    uint64_t dataOffset = 0;
+    // the pages are freed with the data cache
+    std::shared_ptr<DataCache> holder = shared_from_this();
+
+    while (len > 0) {
+        if (blockPos + len > blockSize) {
+            n = blockSize - blockPos;
+        } else {
+            n = len;
+        }
+        blockLen = n;
+        PageDataMap &pdMap = dataMap_[blockIndex];
+        pageIndex = blockPos / pageSize;
+        pagePos = blockPos % pageSize;
+        while (blockLen > 0) {
+            if (pagePos + blockLen > pageSize) {
+                m = pageSize - pagePos;
+            } else {
+                m = blockLen;
+            }
+
+            assert(pdMap.count(pageIndex));
+            buffer->AddMemory(bufOffset + dataOffset,
+                              pdMap[pageIndex]->data + pagePos, m, holder);
+            pageIndex++;
+            blockLen -= m;
+            dataOffset += m;
+            pagePos = (pagePos + m) % pageSize;
+        }
+
+        blockIndex++;
+        len -= n;
+        blockPos = (blockPos + n) % blockSize;
+    }
+}
+
 CURVEFS_ERROR DataCache::Flush(uint64_t inodeId, bool toS3) {
     VLOG(9) << "DataCache Flush. chunkPos=" << chunkPos_ << ", len=" << len_
             << ", chunkIndex=" << chunkCacheManager_->GetIndex()
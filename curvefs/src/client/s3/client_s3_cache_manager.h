@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -35,6 +36,7 @@
 
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/filesystem/error.h"
+#include "curvefs/src/client/filesystem/read_buffer.h"
 #include "curvefs/src/client/inode_wrapper.h"
 #include "curvefs/src/client/kvclient/kvclient_manager.h"
 #include "curvefs/src/client/s3/client_s3.h"
@@ -64,6 +66,7 @@ using curve::common::S3Adapter;
 using curvefs::metaserver::Inode;
 using curvefs::metaserver::S3ChunkInfo;
 using curvefs::metaserver::S3ChunkInfoList;
+using curvefs::client::filesystem::ReadBuffer;
 
 enum CacheType { Write = 1, Read = 2 };
 
@@ -153,6 +156,9 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
                const std::vector<DataCachePtr> &mergeDataCacheVer);
     virtual void Truncate(uint64_t size);
     uint64_t GetChunkPos() { return chunkPos_; }
+    ChunkCacheManager *GetChunkCacheManager() {
+        return chunkCacheManager_.get();
+    }
     uint64_t GetLen() { return len_; }
     PageData *GetPageData(uint64_t blockIndex, uint64_t pageIndex) {
         PageDataMap &pdMap = dataMap_[blockIndex];
@@ -191,6 +197,18 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
         inReadCache_.store(inCache, std::memory_order_release);
     }
 
+    // the following are protected by lruMtx_ of FsCacheManager
+    bool InFrequentList() const { return inFrequentList_; }
+
+    void SetFrequentList(bool frequent) { inFrequentList_ = frequent; }
+
+    void SetDemoted(bool demoted) { demoted_ = demoted; }
+
+    // objects in disk cache which this data cache is read from
+    void SetObjectNames(std::vector<std::string> names) {
+        objNames_ = std::move(names);
+    }
+
     void Lock() {
         mtx_.lock();
     }
@@ -199,6 +217,10 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
         mtx_.unlock();
     }
     void CopyDataCacheToBuf(uint64_t offset, uint64_t len, char *data);
+    // reference the pages of [offset, offset + len) at |bufOffset| of
+    // |buffer|, only for read cache whose pages are never modified
+    void ShareDataCacheToBuf(uint64_t offset, uint64_t len,
+                             ReadBuffer *buffer, uint64_t bufOffset);
     void MergeDataCacheToDataCache(DataCachePtr mergeDataCache,
                                    uint64_t dataOffset, uint64_t len);
 
@@ -233,6 +255,10 @@ class DataCache : public std::enable_shared_from_this<DataCache> {
     uint64_t createTime_;
     std::atomic<int> status_;
     std::atomic<bool> inReadCache_;
+    bool inFrequentList_;
+    // evicted from memory while it is still frequently used
+    bool demoted_;
+    std::vector<std::string> objNames_;
     std::map<uint64_t, PageDataMap> dataMap_;  // first is block index
 
     std::shared_ptr<KVClientManager> kvClientManager_;
@@ -256,14 +282,18 @@ class ChunkCacheManager
     : public std::enable_shared_from_this<ChunkCacheManager> {
  public:
     ChunkCacheManager(uint64_t index, S3ClientAdaptorImpl *s3ClientAdaptor,
-                      std::shared_ptr<KVClientManager> kvClientManager)
-        : index_(index), s3ClientAdaptor_(s3ClientAdaptor),
+                      std::shared_ptr<KVClientManager> kvClientManager,
+                      uint64_t inodeId = 0)
+        : index_(index), inodeId_(inodeId), s3ClientAdaptor_(s3ClientAdaptor),
           flushingDataCache_(nullptr),
           kvClientManager_(std::move(kvClientManager)) {}
     virtual ~ChunkCacheManager() = default;
+    // if |buffer| is not null, the read cache hits are shared into it
+    // instead of being copied into |dataBuf|
     void ReadChunk(uint64_t index, uint64_t chunkPos, uint64_t readLen,
                    char *dataBuf, uint64_t dataBufOffset,
-                   std::vector<ReadRequest> *requests);
+                   std::vector<ReadRequest> *requests,
+                   ReadBuffer *buffer = nullptr);
     virtual void WriteNewDataCache(S3ClientAdaptorImpl *s3ClientAdaptor,
                                    uint32_t chunkPos, uint32_t len,
                                    const char *data);
@@ -278,12 +308,16 @@ class ChunkCacheManager
     virtual void ReadByReadCache(uint64_t chunkPos, uint64_t readLen,
                                  char *dataBuf, uint64_t dataBufOffset,
                                  std::vector<ReadRequest> *requests);
+    void ReadByReadCacheZeroCopy(uint64_t chunkPos, uint64_t readLen,
+                                 uint64_t dataBufOffset, ReadBuffer *buffer,
+                                 std::vector<ReadRequest> *requests);
     virtual void ReadByFlushData(uint64_t chunkPos, uint64_t readLen,
                                  char *dataBuf, uint64_t dataBufOffset,
                                  std::vector<ReadRequest> *requests);
     virtual CURVEFS_ERROR Flush(uint64_t inodeId, bool force,
                                 bool toS3 = false);
     uint64_t GetIndex() { return index_; }
+    uint64_t GetInodeId() const { return inodeId_; }
     bool IsEmpty() {
         ReadLockGuard writeCacheLock(rwLockChunk_);
         return (dataWCacheMap_.empty() && dataRCacheMap_.empty());
@@ -313,8 +347,17 @@ class ChunkCacheManager
     bool IsFlushDataEmpty() {
         return flushingDataCache_ == nullptr;
     }
+    // walk the read caches overlapped with [chunkPos, chunkPos + readLen),
+    // |readHit| is called with the data cache, the offset in it, the length
+    // and the offset in data buffer of every hit
+    void ForEachReadCacheHit(
+        uint64_t chunkPos, uint64_t readLen, uint64_t dataBufOffset,
+        std::vector<ReadRequest> *requests,
+        const std::function<void(const DataCachePtr &, uint64_t, uint64_t,
+                                 uint64_t)> &readHit);
  private:
     uint64_t index_;
+    uint64_t inodeId_;
     std::map<uint64_t, DataCachePtr> dataWCacheMap_;  // first is pos in chunk
     std::map<uint64_t, std::list<DataCachePtr>::iterator>
         dataRCacheMap_;  // first is pos in chunk
@@ -353,6 +396,11 @@ class FileCacheManager {
     virtual int Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                      char *dataBuf);
 
+    // same as Read, but the blocks cached in local disk are referenced
+    // by fd in |buffer| instead of being copied into its memory
+    virtual int ReadZeroCopy(uint64_t inodeId, uint64_t offset,
+                             uint64_t length, ReadBuffer *buffer);
+
     bool IsEmpty() { return chunkCacheMap_.empty(); }
 
     uint64_t GetInodeId() const { return inode_; }
@@ -397,10 +445,12 @@ class FileCacheManager {
     void GetBlockLoc(uint64_t offset, uint64_t *chunkIndex, uint64_t *chunkPos,
                      uint64_t *blockIndex, uint64_t *blockPos);
 
-    // read data from memory read/write cache
+    // read data from memory read/write cache, the read cache hits are
+    // shared into |buffer| if it is not null
     void ReadFromMemCache(uint64_t offset, uint64_t length, char *dataBuf,
                           uint64_t *actualReadLen,
-                          std::vector<ReadRequest> *memCacheMissRequest);
+                          std::vector<ReadRequest> *memCacheMissRequest,
+                          ReadBuffer *buffer = nullptr);
 
     // miss read from memory read/write cache, need read from
     // kv(localdisk/remote cache/s3)
@@ -440,9 +490,22 @@ class FileCacheManager {
     bool ReadKVRequestFromLocalCache(const std::string &name, char *databuf,
                                      uint64_t offset, uint64_t len);
 
-    // read kv request from remote cache like memcached
-    bool ReadKVRequestFromRemoteCache(const std::string &name, char *databuf,
-                                      uint64_t offset, uint64_t length);
+    // called with the object name, the offset in read buffer, the position
+    // in object and the length of every block of a kv request
+    using BlockFunc = std::function<bool(std::string &&name,
+                                         uint64_t bufOffset, uint64_t pos,
+                                         uint64_t len)>;
+
+    // split kv request by block, stop if |func| returns false
+    bool ForEachBlock(const S3ReadRequest &req, const BlockFunc &func);
+
+    // reference kv request by fd of local disk cache files,
+    // only succeed if all blocks of the request are cached
+    bool ReadKVRequestZeroCopy(const S3ReadRequest &req, ReadBuffer *buffer);
+
+    // read kv requests from remote cache like memcached by one batch,
+    // res of each request is set if it's read successfully
+    void ReadKVRequestFromRemoteCache(std::vector<KVGetRequest> *requests);
 
     // read kv request from s3
     bool ReadKVRequestFromS3(const std::string &name, char *databuf,
@@ -478,8 +541,10 @@ class FsCacheManager {
     FsCacheManager(S3ClientAdaptorImpl *s3ClientAdaptor,
                    uint64_t readCacheMaxByte, uint64_t writeCacheMaxByte,
                    uint32_t readCacheThreads,
-                   std::shared_ptr<KVClientManager> kvClientManager)
-        : lruByte_(0), wDataCacheNum_(0), wDataCacheByte_(0),
+                   std::shared_ptr<KVClientManager> kvClientManager,
+                   bool arcReadCache = false)
+        : lruByte_(0), recentByte_(0), recentTargetByte_(0),
+          arcReadCache_(arcReadCache), wDataCacheNum_(0), wDataCacheByte_(0),
           readCacheMaxByte_(readCacheMaxByte),
           writeCacheMaxByte_(writeCacheMaxByte),
           s3ClientAdaptor_(s3ClientAdaptor), isWaiting_(false),
@@ -576,14 +641,79 @@ class FsCacheManager {
         std::thread t_;
     };
 
+    // a data cache is identified by its inode, chunk and position in chunk,
+    // which stay the same after the data cache and its chunk are released
+    struct GhostKey {
+        uint64_t inodeId;
+        uint64_t chunkIndex;
+        uint64_t chunkPos;
+
+        bool operator==(const GhostKey &other) const {
+            return inodeId == other.inodeId &&
+                   chunkIndex == other.chunkIndex &&
+                   chunkPos == other.chunkPos;
+        }
+    };
+
+    struct GhostKeyHash {
+        size_t operator()(const GhostKey &key) const;
+    };
+
+    // GhostList remembers the keys of data caches evicted from memory,
+    // only their length is kept and the data is released.
+    class GhostList {
+     public:
+        GhostList() : bytes_(0) {}
+
+        bool Contains(const GhostKey &key) const {
+            return map_.count(key) != 0;
+        }
+
+        void PushFront(const GhostKey &key, uint64_t len);
+
+        void Erase(const GhostKey &key);
+
+        void PopBack();
+
+        bool Empty() const { return list_.empty(); }
+
+        uint64_t Bytes() const { return bytes_; }
+
+     private:
+        using Entry = std::pair<GhostKey, uint64_t>;  // key, len
+        std::list<Entry> list_;
+        std::unordered_map<GhostKey, std::list<Entry>::iterator, GhostKeyHash>
+            map_;
+        uint64_t bytes_;
+    };
+
+ private:
+    // adaptive replacement of read cache, separating data caches read once
+    // from those read repeatedly, so that a large scan only evicts the
+    // former. the following are called with lruMtx_ held.
+    bool ArcSet(DataCachePtr dataCache,
+                std::list<DataCachePtr>::iterator *outIter);
+    void ArcReplace(bool hitFrequentGhost, std::list<DataCachePtr> *retired);
+    void ArcTrimGhost();
+    static GhostKey GhostKeyOf(const DataCachePtr &dataCache);
+
  private:
     std::unordered_map<uint64_t, FileCacheManagerPtr>
         fileCacheManagerMap_;  // first is inodeid
     RWLock rwLock_;
     std::mutex lruMtx_;
 
+    // when arc is enabled, lruReadDataCacheList_ holds the data caches
+    // read once recently, and frequentReadDataCacheList_ holds the others
     std::list<DataCachePtr> lruReadDataCacheList_;
+    std::list<DataCachePtr> frequentReadDataCacheList_;
+    GhostList recentGhost_;
+    GhostList frequentGhost_;
     uint64_t lruByte_;
+    uint64_t recentByte_;
+    // the adaptive target bytes of lruReadDataCacheList_
+    uint64_t recentTargetByte_;
+    bool arcReadCache_;
     std::atomic<uint64_t> wDataCacheNum_;
     std::atomic<uint64_t> wDataCacheByte_;
     uint64_t readCacheMaxByte_;
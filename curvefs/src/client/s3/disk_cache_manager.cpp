@@ -107,6 +107,12 @@ int DiskCacheManager::Init(std::shared_ptr<S3Client> client,
     FLAGS_diskMaxFileNums = option.diskCacheOpt.maxFileNums;
     cmdTimeoutSec_ = option.diskCacheOpt.cmdTimeoutSec;
     objectPrefix_ = option.objectPrefix;
+    if (option.cacheEvictPolicy == "arc") {
+        // keep the objects read repeatedly on disk when a large
+        // sequential scan passes through the cache
+        cachedObjName_ = std::make_shared<SglARCCache<std::string>>(0,
+            std::make_shared<CacheMetrics>("diskcache"));
+    }
     cacheWrite_->Init(client_, posixWrapper_, cacheDir_, objectPrefix_,
         option.diskCacheOpt.asyncLoadPeriodMs, cachedObjName_);
     cacheRead_->Init(posixWrapper_, cacheDir_, objectPrefix_);
@@ -192,6 +198,10 @@ bool DiskCacheManager::IsCached(const std::string &name) {
     return true;
 }
 
+void DiskCacheManager::Touch(const std::string &name) {
+    cachedObjName_->Touch(name);
+}
+
 bool DiskCacheManager::IsCacheClean() {
     return cacheWrite_->IsCacheClean();
 }
@@ -264,6 +274,13 @@ int DiskCacheManager::ReadDiskFile(const std::string name, char *buf,
     return cacheRead_->ReadDiskFile(name, buf, offset, length);
 }
 
+int DiskCacheManager::OpenDiskFile(const std::string name, uint64_t offset,
+                                   uint64_t length, int *fd) {
+    // read throttle
+    diskCacheThrottle_.Add(true, length);
+    return cacheRead_->OpenDiskFile(name, offset, length, fd);
+}
+
 int DiskCacheManager::WriteReadDirect(const std::string fileName,
                                       const char *buf, uint64_t length) {
     // write hrottle
@@ -48,7 +48,9 @@ namespace client {
 
 using ::curve::common::LRUCache;
 using curve::common::ReadWriteThrottleParams;
+using ::curve::common::SglARCCache;
 using ::curve::common::SglLRUCache;
+using ::curve::common::SglLRUCacheInterface;
 using curve::common::Throttle;
 using curve::common::ThrottleParams;
 using curvefs::client::common::S3ClientAdaptorOption;
@@ -71,6 +73,13 @@ class DiskCacheManager {
     virtual int UmountDiskCache();
     virtual bool IsCached(const std::string &name);
 
+    /**
+     * @brief mark the cached obj as used again, so it survives the trim
+     *        longer, cache hits aren't counted
+     * @param[in] name obj name
+     */
+    virtual void Touch(const std::string &name);
+
     /**
      * @brief add obj to cachedObjName
      * @param[in] name obj name
@@ -90,6 +99,8 @@ class DiskCacheManager {
                                 uint64_t length);
     int ReadDiskFile(const std::string name, char *buf, uint64_t offset,
                      uint64_t length);
+    int OpenDiskFile(const std::string name, uint64_t offset, uint64_t length,
+                     int *fd);
     int LinkWriteToRead(const std::string fileName,
                         const std::string fullWriteDir,
                         const std::string fullReadDir);
@@ -189,7 +200,7 @@ class DiskCacheManager {
     std::shared_ptr<DiskCacheWrite> cacheWrite_;
     std::shared_ptr<DiskCacheRead> cacheRead_;
 
-    std::shared_ptr<SglLRUCache<std::string>> cachedObjName_;
+    std::shared_ptr<SglLRUCacheInterface<std::string>> cachedObjName_;
 
     std::shared_ptr<S3Client> client_;
     std::shared_ptr<PosixWrapper> posixWrapper_;
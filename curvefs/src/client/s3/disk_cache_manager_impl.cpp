@@ -191,10 +191,23 @@ int DiskCacheManagerImpl::Read(const std::string name, char *buf,
     return ret;
 }
 
+int DiskCacheManagerImpl::Open(const std::string name, uint64_t offset,
+                               uint64_t length, int *fd) {
+    VLOG(9) << "open name = " << name << ", offset = " << offset
+            << ", length = " << length;
+    // unlike Read, we don't fallback to s3 here,
+    // caller should read it from other places
+    return diskCacheManager_->OpenDiskFile(name, offset, length, fd);
+}
+
 bool DiskCacheManagerImpl::IsCached(const std::string name) {
     return diskCacheManager_->IsCached(name);
 }
 
+void DiskCacheManagerImpl::Touch(const std::string &name) {
+    diskCacheManager_->Touch(name);
+}
+
 bool DiskCacheManagerImpl::IsDiskCacheFull() {
     return diskCacheManager_->IsDiskCacheFull();
 }
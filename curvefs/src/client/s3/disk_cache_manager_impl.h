@@ -94,6 +94,11 @@ class DiskCacheManagerImpl {
      * @return cached: true, not cached : < 0
      */
     virtual bool IsCached(const std::string name);
+    /**
+     * @brief mark the cached obj as used again without counting a hit
+     * @param[in] name obj name
+     */
+    virtual void Touch(const std::string &name);
     /**
      * @brief read obj
      * @param[in] name obj name
@@ -104,6 +109,16 @@ class DiskCacheManagerImpl {
      */
     virtual int Read(const std::string name, char* buf, uint64_t offset,
                      uint64_t length);
+    /**
+     * @brief open obj for reading without copying data to userspace
+     * @param[in] name obj name
+     * @param[in] offset offset in this object will start read
+     * @param[in] length read length
+     * @param[out] fd the opened fd, should be closed by caller
+     * @return success: 0, fail : < 0
+     */
+    virtual int Open(const std::string name, uint64_t offset, uint64_t length,
+                     int* fd);
     /**
      * @brief umount disk cache
      * @return success: 0, fail : < 0
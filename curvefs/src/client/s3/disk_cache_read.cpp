@@ -81,6 +81,35 @@ int DiskCacheRead::ReadDiskFile(const std::string name, char *buf,
     return readLen;
 }
 
+int DiskCacheRead::OpenDiskFile(const std::string name, uint64_t offset,
+                                uint64_t length, int *fd) {
+    VLOG(6) << "OpenDiskFile start. name = " << name << ", offset = " << offset
+            << ", length = " << length;
+    std::string fileFullPath = GetCacheIoFullDir() + "/" + name;
+    int ret = posixWrapper_->open(fileFullPath.c_str(), O_RDONLY, MODE);
+    if (ret < 0) {
+        LOG(ERROR) << "open disk file error. file = " << name
+                   << ", errno = " << errno;
+        return ret;
+    }
+
+    // the fd will be read by kernel directly, make sure the file is
+    // large enough so that the reply is not truncated
+    struct stat statFile;
+    if (posixWrapper_->fstat(ret, &statFile) < 0 ||
+        static_cast<uint64_t>(statFile.st_size) < offset + length) {
+        LOG(ERROR) << "disk file is not entirely. file = " << name
+                   << ", want len = " << offset + length
+                   << ", errno = " << errno;
+        posixWrapper_->close(ret);
+        return -1;
+    }
+
+    *fd = ret;
+    VLOG(6) << "OpenDiskFile success. name = " << name << ", fd = " << ret;
+    return 0;
+}
+
 int DiskCacheRead::LinkWriteToRead(const std::string fileName,
                                    const std::string fullWriteDir,
                                    const std::string fullReadDir) {
@@ -117,7 +146,7 @@ int DiskCacheRead::LinkWriteToRead(const std::string fileName,
 }
 
 int DiskCacheRead::LoadAllCacheReadFile(
-    std::shared_ptr<SglLRUCache<std::string>> cachedObj) {
+    std::shared_ptr<SglLRUCacheInterface<std::string>> cachedObj) {
     std::set<std::string> tmp;
     int ret = LoadAllCacheFile(&tmp);
     if (ret < 0) {
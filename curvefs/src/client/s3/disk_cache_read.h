@@ -38,6 +38,7 @@ namespace curvefs {
 namespace client {
 
 using curve::common::SglLRUCache;
+using curve::common::SglLRUCacheInterface;
 using curvefs::common::PosixWrapper;
 
 class DiskCacheRead : public DiskCacheBase {
@@ -48,6 +49,13 @@ class DiskCacheRead : public DiskCacheBase {
                       const std::string cacheDir, uint32_t objectPrefix);
     virtual int ReadDiskFile(const std::string name, char *buf, uint64_t offset,
                              uint64_t length);
+    /**
+     * @brief open the cache file for reading range [offset, offset + length)
+     *        directly, the caller should close the returned fd.
+     * @return success: 0, fail : < 0
+     */
+    virtual int OpenDiskFile(const std::string name, uint64_t offset,
+                             uint64_t length, int *fd);
     virtual int WriteDiskFile(const std::string fileName, const char *buf,
                               uint64_t length);
     virtual int LinkWriteToRead(const std::string fileName,
@@ -58,7 +66,7 @@ class DiskCacheRead : public DiskCacheBase {
      * @brief after reboot，load all files that store in read cache.
      */
     virtual int
-    LoadAllCacheReadFile(std::shared_ptr<SglLRUCache<
+    LoadAllCacheReadFile(std::shared_ptr<SglLRUCacheInterface<
       std::string>> cachedObj);
     virtual int ClearReadCache(const std::list<std::string> &files);
     virtual void InitMetrics(std::shared_ptr<DiskCacheMetric> metric) {
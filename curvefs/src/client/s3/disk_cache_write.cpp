@@ -42,7 +42,7 @@ void DiskCacheWrite::Init(std::shared_ptr<S3Client> client,
                           const std::string cacheDir,
                           uint32_t objectPrefix,
                           uint64_t asyncLoadPeriodMs,
-                          std::shared_ptr<SglLRUCache<
+                          std::shared_ptr<SglLRUCacheInterface<
                             std::string>> cachedObjName) {
     client_ = client;
     posixWrapper_ = posixWrapper;
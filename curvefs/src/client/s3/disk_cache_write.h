@@ -49,6 +49,7 @@ namespace client {
 using curve::common::InterruptibleSleeper;
 using curve::common::PutObjectAsyncCallBack;
 using ::curve::common::SglLRUCache;
+using ::curve::common::SglLRUCacheInterface;
 using curvefs::client::metric::S3Metric;
 using curvefs::common::PosixWrapper;
 
@@ -85,7 +86,8 @@ class DiskCacheWrite : public DiskCacheBase {
               std::shared_ptr<PosixWrapper> posixWrapper,
               const std::string cacheDir, uint32_t objectPrefix,
               uint64_t asyncLoadPeriodMs,
-              std::shared_ptr<SglLRUCache<std::string>> cachedObjName);
+              std::shared_ptr<SglLRUCacheInterface<
+                std::string>> cachedObjName);
     /**
      * @brief write obj to write cache disk
      * @param[in] client S3Client
@@ -165,7 +167,7 @@ class DiskCacheWrite : public DiskCacheBase {
     std::shared_ptr<DiskCacheMetric> metric_;
     std::shared_ptr<S3Metric> s3Metric_;
 
-    std::shared_ptr<SglLRUCache<std::string>> cachedObjName_;
+    std::shared_ptr<SglLRUCacheInterface<std::string>> cachedObjName_;
 };
 
 }  // namespace client
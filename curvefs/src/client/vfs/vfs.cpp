@@ -45,12 +45,12 @@ namespace vfs {
 
 using ::curvefs::client::SDKHelper;
 using ::curvefs::client::logger::AccessLogGuard;
-using ::curvefs::client::logger::StrFormat;
+using ::curvefs::client::logger::AccessLogRecord;
 using ::curvefs::client::filesystem::IsDir;
 using ::curvefs::client::filesystem::IsSymlink;
-using ::curvefs::client::filesystem::StrErr;
-using ::curvefs::client::filesystem::StrMode;
-using ::curvefs::client::filesystem::StrAttr;
+using ::curvefs::client::filesystem::LogErr;
+using ::curvefs::client::filesystem::LogMode;
+using ::curvefs::client::filesystem::LogAttr;
 
 Configuration VFS::Convert(std::shared_ptr<Configure> cfg) {
     Configuration conf;
@@ -80,8 +80,8 @@ VFS::VFS(std::shared_ptr<Configure> cfg) {
 CURVEFS_ERROR VFS::Mount(const std::string& fsname,
                          const std::string& mountpoint) {
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&]() {
-        return StrFormat("mount (%s,%s): %s", fsname, mountpoint, StrErr(rc));
+    AccessLogGuard log("mount", [&](AccessLogRecord* record) {
+        record->Encode("mount (%s,%s): %s", fsname, mountpoint, LogErr(rc));
     });
 
     rc = op_->Mount(fsname, mountpoint, option_);
@@ -91,8 +91,8 @@ CURVEFS_ERROR VFS::Mount(const std::string& fsname,
 CURVEFS_ERROR VFS::Umount(const std::string& fsname,
                           const std::string& mountpoint) {
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&]() {
-        return StrFormat("umount: %s", StrErr(rc));
+    AccessLogGuard log("umount", [&](AccessLogRecord* record) {
+        record->Encode("umount: %s", LogErr(rc));
     });
 
     rc = op_->Umount(fsname, mountpoint);
@@ -104,10 +104,10 @@ CURVEFS_ERROR VFS::DoMkDir(const std::string& path,
                            EntryOut* entryOut) {
     Entry entry, parent;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&]() {
-        return StrFormat("mkdir (%s,%s:0%04o): %s%s",
-                         path, StrMode(mode), mode,
-                         StrErr(rc), StrEntry(*entryOut));
+    AccessLogGuard log("mkdir", [&](AccessLogRecord* record) {
+        record->Encode("mkdir (%s,%s:0%04o): %s%s",
+                       path, LogMode(mode), mode,
+                       LogErr(rc), LogEntry(*entryOut));
     });
 
     rc = Lookup(path, true, &entry);
@@ -164,8 +164,8 @@ CURVEFS_ERROR VFS::MkDirs(const std::string& path, uint16_t mode) {
 CURVEFS_ERROR VFS::RmDir(const std::string& path) {
     Entry parent, entry;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("rmdir (%s): %s", path, StrErr(rc));
+    AccessLogGuard log("rmdir", [&](AccessLogRecord* record) {
+        record->Encode("rmdir (%s): %s", path, LogErr(rc));
     });
 
     rc = Lookup(filepath::ParentDir(path), true, &parent);
@@ -188,9 +188,9 @@ CURVEFS_ERROR VFS::RmDir(const std::string& path) {
 CURVEFS_ERROR VFS::OpenDir(const std::string& path, DirStream* stream) {
     Entry entry;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("opendir (%s): %s [fh:%d]",
-                         path, StrErr(rc), stream->fh);
+    AccessLogGuard log("opendir", [&](AccessLogRecord* record) {
+        record->Encode("opendir (%s): %s [fh:%d]",
+                       path, LogErr(rc), stream->fh);
     });
 
     rc = Lookup(path, true, &entry);
@@ -212,9 +212,9 @@ CURVEFS_ERROR VFS::OpenDir(const std::string& path, DirStream* stream) {
 CURVEFS_ERROR VFS::ReadDir(DirStream* stream, DirEntry* dirEntry) {
     uint64_t nread = 0;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("readdir (%d,%d): %s (%d)",
-                         stream->fh, stream->offset, StrErr(rc), nread);
+    AccessLogGuard log("readdir", [&](AccessLogRecord* record) {
+        record->Encode("readdir (%d,%d): %s (%d)",
+                       stream->fh, stream->offset, LogErr(rc), nread);
     });
 
     auto entries = std::make_shared<DirEntryList>();
@@ -237,9 +237,9 @@ CURVEFS_ERROR VFS::ReadDir(DirStream* stream, DirEntry* dirEntry) {
 
 CURVEFS_ERROR VFS::CloseDir(DirStream* stream) {
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("closedir (%d): %s",
-                         stream->fh, StrErr(rc));
+    AccessLogGuard log("closedir", [&](AccessLogRecord* record) {
+        record->Encode("closedir (%d): %s",
+                       stream->fh, LogErr(rc));
     });
 
     rc = op_->CloseDir(stream->ino);
@@ -250,10 +250,10 @@ CURVEFS_ERROR VFS::Create(const std::string& path, uint16_t mode) {
     Entry parent;
     EntryOut entryOut;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("create (%s,%s:0%04o): %s%s",
-                         path, StrMode(mode), mode,
-                         StrErr(rc), StrEntry(entryOut));
+    AccessLogGuard log("create", [&](AccessLogRecord* record) {
+        record->Encode("create (%s,%s:0%04o): %s%s",
+                       path, LogMode(mode), mode,
+                       LogErr(rc), LogEntry(entryOut));
     });
 
     rc = Lookup(filepath::ParentDir(path), true, &parent);
@@ -280,8 +280,8 @@ CURVEFS_ERROR VFS::Open(const std::string& path,
                         uint64_t* fd) {
     Entry entry;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("open (%s): %s [fh:%d]", path, StrErr(rc), *fd);
+    AccessLogGuard log("open", [&](AccessLogRecord* record) {
+        record->Encode("open (%s): %s [fh:%d]", path, LogErr(rc), *fd);
     });
 
     rc = Lookup(path, true, &entry);
@@ -312,9 +312,9 @@ CURVEFS_ERROR VFS::LSeek(uint64_t fd, uint64_t offset, int whence) {
     AttrOut attrOut;
     CURVEFS_ERROR rc;
     std::shared_ptr<FileHandler> fh;
-    AccessLogGuard log([&](){
-        return StrFormat("lseek (%d,%d,%d): %s (%d)",
-                         fd, offset, whence, StrErr(rc), fh->offset);
+    AccessLogGuard log("lseek", [&](AccessLogRecord* record) {
+        record->Encode("lseek (%d,%d,%d): %s (%d)",
+                       fd, offset, whence, LogErr(rc), fh->offset);
     });
 
     bool yes = handlers_->GetHandler(fd, &fh);
@@ -362,9 +362,9 @@ CURVEFS_ERROR VFS::Read(uint64_t fd,
     std::shared_ptr<FileHandler> fh;
     CURVEFS_ERROR rc;
     uint64_t offset = 0;
-    AccessLogGuard log([&](){
-        return StrFormat("read (%d,%d,%d): %s (%d)",
-                         fd, count, offset, StrErr(rc), *nread);
+    AccessLogGuard log("read", [&](AccessLogRecord* record) {
+        record->Encode("read (%d,%d,%d): %s (%d)",
+                       fd, count, offset, LogErr(rc), *nread);
     });
 
     bool yes = handlers_->GetHandler(fd, &fh);
@@ -394,9 +394,9 @@ CURVEFS_ERROR VFS::Write(uint64_t fd,
     AttrOut attrOut;
     CURVEFS_ERROR rc;
     uint64_t offset = 0;
-    AccessLogGuard log([&](){
-        return StrFormat("write (%d,%d,%d): %s (%d)",
-                         fd, count, offset, StrErr(rc), *nwritten);
+    AccessLogGuard log("write", [&](AccessLogRecord* record) {
+        record->Encode("write (%d,%d,%d): %s (%d)",
+                       fd, count, offset, LogErr(rc), *nwritten);
     });
 
     bool yes = handlers_->GetHandler(fd, &fh);
@@ -423,8 +423,8 @@ CURVEFS_ERROR VFS::FSync(uint64_t fd) {
     std::shared_ptr<FileHandler> fh;
     AttrOut attrOut;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("fsync (%d): %s", fd, StrErr(rc));
+    AccessLogGuard log("fsync", [&](AccessLogRecord* record) {
+        record->Encode("fsync (%d): %s", fd, LogErr(rc));
     });
 
     bool yes = handlers_->GetHandler(fd, &fh);
@@ -445,8 +445,8 @@ CURVEFS_ERROR VFS::FSync(uint64_t fd) {
 CURVEFS_ERROR VFS::Close(uint64_t fd) {
     std::shared_ptr<FileHandler> fh;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("close (%d): %s", fd, StrErr(rc));
+    AccessLogGuard log("close", [&](AccessLogRecord* record) {
+        record->Encode("close (%d): %s", fd, LogErr(rc));
     });
 
     bool yes = handlers_->GetHandler(fd, &fh);
@@ -470,8 +470,8 @@ CURVEFS_ERROR VFS::Close(uint64_t fd) {
 CURVEFS_ERROR VFS::Unlink(const std::string& path) {
     Entry parent;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("unlink (%s): %s", path, StrErr(rc));
+    AccessLogGuard log("unlink", [&](AccessLogRecord* record) {
+        record->Encode("unlink (%s): %s", path, LogErr(rc));
     });
 
     rc = Lookup(filepath::ParentDir(path), true, &parent);
@@ -493,8 +493,8 @@ CURVEFS_ERROR VFS::Unlink(const std::string& path) {
 
 CURVEFS_ERROR VFS::StatFs(struct statvfs* statvfs) {
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("statfs : %s", StrErr(rc));
+    AccessLogGuard log("statfs", [&](AccessLogRecord* record) {
+        record->Encode("statfs : %s", LogErr(rc));
     });
 
     rc = op_->StatFs(ROOT_INO, statvfs);
@@ -504,9 +504,9 @@ CURVEFS_ERROR VFS::StatFs(struct statvfs* statvfs) {
 CURVEFS_ERROR VFS::LStat(const std::string& path, struct stat* stat) {
     CURVEFS_ERROR rc;
     Entry entry;
-    AccessLogGuard log([&](){
-        return StrFormat("lstat (%s): %s%s",
-                         path, StrErr(rc), StrAttr(entry.attr));
+    AccessLogGuard log("lstat", [&](AccessLogRecord* record) {
+        record->Encode("lstat (%s): %s%s",
+                       path, LogErr(rc), LogAttr(entry.attr));
     });
 
     rc = Lookup(path, false, &entry);
@@ -522,8 +522,8 @@ CURVEFS_ERROR VFS::FStat(uint64_t fd, struct stat* stat) {
     std::shared_ptr<FileHandler> fh;
     AttrOut attrOut;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("fstat (%d): %s%s", fd, StrErr(rc), StrAttr(attrOut));
+    AccessLogGuard log("fstat", [&](AccessLogRecord* record) {
+        record->Encode("fstat (%d): %s%s", fd, LogErr(rc), LogAttr(attrOut));
     });
 
     bool yes = handlers_->GetHandler(fd, &fh);
@@ -546,8 +546,8 @@ CURVEFS_ERROR VFS::SetAttr(const std::string& path,
                            int toSet) {
     Entry entry;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&]() {
-        return StrFormat("setattr (%s,0x%X): %s", path, toSet, StrErr(rc));
+    AccessLogGuard log("setattr", [&](AccessLogRecord* record) {
+        record->Encode("setattr (%s,0x%X): %s", path, toSet, LogErr(rc));
     });
 
     rc = Lookup(path, true, &entry);
@@ -573,9 +573,9 @@ CURVEFS_ERROR VFS::Chmod(const std::string& path, uint16_t mode) {
     Entry entry;
     struct stat stat;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&]() {
-        return StrFormat("chmod (%s,%s:0%04o): %s",
-                         path, StrMode(mode), mode, StrErr(rc));
+    AccessLogGuard log("chmod", [&](AccessLogRecord* record) {
+        record->Encode("chmod (%s,%s:0%04o): %s",
+                       path, LogMode(mode), mode, LogErr(rc));
     });
 
     rc = Lookup(path, true, &entry);
@@ -601,8 +601,8 @@ CURVEFS_ERROR VFS::Chmod(const std::string& path, uint16_t mode) {
 CURVEFS_ERROR VFS::Chown(const std::string &path, uint32_t uid, uint32_t gid) {
     Entry entry;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("chown (%s,%d,%d): %s", path, uid, gid, StrErr(rc));
+    AccessLogGuard log("chown", [&](AccessLogRecord* record) {
+        record->Encode("chown (%s,%d,%d): %s", path, uid, gid, LogErr(rc));
     });
 
     rc = Lookup(path, true, &entry);
@@ -645,8 +645,8 @@ CURVEFS_ERROR VFS::Rename(const std::string& oldpath,
                           const std::string& newpath) {
     Entry oldParent, newParent;
     CURVEFS_ERROR rc;
-    AccessLogGuard log([&](){
-        return StrFormat("rename (%s, %s): %s", oldpath, newpath, StrErr(rc));
+    AccessLogGuard log("rename", [&](AccessLogRecord* record) {
+        record->Encode("rename (%s, %s): %s", oldpath, newpath, LogErr(rc));
     });
 
     rc = Lookup(filepath::ParentDir(oldpath), true, &oldParent);
@@ -266,8 +266,9 @@ void ExtentCache::Build(const VolumeExtentSliceList &extents) {
 VolumeExtentSliceList ExtentCache::GetDirtyExtents() {
     VolumeExtentSliceList result;
     WriteLockGuard lk(lock_);
+    result.mutable_slices()->Reserve(dirties_.size());
     for (const auto* slice : dirties_) {
-        *result.add_slices() = slice->ToVolumeExtentSlice();
+        slice->ToVolumeExtentSlice(result.add_slices());
     }
 
     dirties_.clear();
@@ -23,6 +23,7 @@
 #include "curvefs/src/client/volume/extent_slice.h"
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "absl/types/optional.h"
@@ -44,17 +45,23 @@ ExtentSlice::ExtentSlice(uint64_t offset) : offset_(offset) {}
 ExtentSlice::ExtentSlice(const VolumeExtentSlice& slice) {
     assert(slice.IsInitialized());
     offset_ = slice.offset();
+    // extents are sorted by fsoffset, so always insert at the end
     for (const auto& pext : slice.extents()) {
-        extents_.emplace(
-            pext.fsoffset(),
+        extents_.emplace_hint(
+            extents_.end(), pext.fsoffset(),
             PExtent{pext.length(), pext.volumeoffset(), !pext.isused()});
     }
 }
 
 VolumeExtentSlice ExtentSlice::ToVolumeExtentSlice() const {
     VolumeExtentSlice slice;
+    ToVolumeExtentSlice(&slice);
+    return slice;
+}
 
-    slice.set_offset(offset_);
+void ExtentSlice::ToVolumeExtentSlice(VolumeExtentSlice* slice) const {
+    slice->set_offset(offset_);
+    slice->mutable_extents()->Reserve(extents_.size());
 
     auto mergable = [](const VolumeExtent* prev,
                        const std::pair<const uint64_t, PExtent>& ext) {
@@ -74,15 +81,13 @@ VolumeExtentSlice ExtentSlice::ToVolumeExtentSlice() const {
             continue;
         }
 
-        auto* pext = slice.add_extents();
+        auto* pext = slice->add_extents();
         pext->set_fsoffset(ext.first);
         pext->set_volumeoffset(ext.second.pOffset);
         pext->set_length(ext.second.len);
         pext->set_isused(!ext.second.UnWritten);
         prev = pext;
     }
-
-    return slice;
 }
 
 void ExtentSlice::DivideForWrite(uint64_t offset,
@@ -397,7 +402,6 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
     const uint64_t curEnd = offset + len;
 
     auto curr = extents_.lower_bound(curOff);
-    const auto upper = extents_.upper_bound(curEnd);
     auto prev = extents_.end();
 
     if (curr != extents_.begin()) {
@@ -412,7 +416,7 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
     // merge written extents
     auto mergeable =
         [this, &prev](
-            std::map<uint64_t, curvefs::client::PExtent>::iterator current) {
+            absl::btree_map<uint64_t, PExtent>::iterator current) {
             return prev != extents_.end() &&
                    !prev->second.UnWritten &&
                    !current->second.UnWritten &&
@@ -423,7 +427,11 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
                        current->second.pOffset;
         };
 
-    while (curOff < curEnd && curr != upper) {
+    // insertion and erasure invalidate iterators of b-tree, so compare with
+    // the end offset instead of `upper_bound(curEnd)`, and re-position `prev`
+    // after erasing `curr` which is always next to `prev`
+    while (curOff < curEnd && curr != extents_.end() &&
+           curr->first <= curEnd) {
         if (nonoverlap(curOff, curEnd - curOff, curr->first,
                        curr->second.len)) {
             prev = curr;
@@ -435,6 +443,7 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
             if (mergeable(curr)) {
                 prev->second.len += curr->second.len;
                 curr = extents_.erase(curr);
+                prev = std::prev(curr);
                 changed = true;
             } else {
                 prev = curr;
@@ -456,6 +465,7 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
                 if (mergeable(curr)) {
                     prev->second.len += curr->second.len;
                     curr = extents_.erase(curr);
+                    prev = std::prev(curr);
                 } else {
                     prev = curr;
                     ++curr;
@@ -489,6 +499,7 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
                 if (mergeable(curr)) {
                     prev->second.len += curr->second.len;
                     curr = extents_.erase(curr);
+                    prev = std::prev(curr);
                 } else {
                     prev = curr;
                     ++curr;
@@ -566,12 +577,11 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
 
                 curr->second.len -= overlap;
 
-                extents_.emplace(curOff, sep);
+                curr = extents_.emplace(curOff, sep).first;
+                prev = std::prev(curr);
                 changed = true;
 
                 curOff = extEnd;
-                prev = curr;
-                ++curr;
             }
         }
     }
@@ -580,7 +590,7 @@ bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
 }
 
 std::map<uint64_t, PExtent> ExtentSlice::GetExtentsForTesting() const {
-    return extents_;
+    return {extents_.begin(), extents_.end()};
 }
 
 }  // namespace client
@@ -26,6 +26,7 @@
 #include <map>
 #include <vector>
 
+#include "absl/container/btree_map.h"
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/volume/extent.h"
 #include "curvefs/src/volume/common.h"
@@ -37,6 +38,9 @@ using ::curvefs::metaserver::VolumeExtentSlice;
 using ::curvefs::volume::ReadPart;
 using ::curvefs::volume::WritePart;
 
+// Extents within a slice are kept in a b-tree, which is much more compact and
+// cache friendly than `std::map` for heavily fragmented files. Note that
+// unlike `std::map`, insertion and erasure invalidate other iterators.
 class ExtentSlice {
  public:
     explicit ExtentSlice(uint64_t offset);
@@ -62,11 +66,13 @@ class ExtentSlice {
 
     VolumeExtentSlice ToVolumeExtentSlice() const;
 
+    void ToVolumeExtentSlice(VolumeExtentSlice* slice) const;
+
     std::map<uint64_t, PExtent> GetExtentsForTesting() const;
 
  private:
     uint64_t offset_;
-    std::map<uint64_t, PExtent> extents_;
+    absl::btree_map<uint64_t, PExtent> extents_;
 };
 
 }  // namespace client
@@ -55,6 +55,16 @@ using curve::common::WriteLockGuard;
 
 #define ROOT_PATH_NAME "/"
 
+namespace {
+
+// the buffer of a download is freed once it's cached or dropped
+void ReleaseBuffer(const std::shared_ptr<GetObjectAsyncContext>& context) {
+    delete[] context->buf;
+    context->buf = nullptr;
+}
+
+}  // namespace
+
 static bool pass_uint32(const char*, uint32_t) { return true; }
 DEFINE_uint32(warmupMaxSymLink, 1 << 2,
               "The maximum number of times to parse sym link");
@@ -146,16 +156,6 @@ bool WarmupManagerS3Impl::CancelWarmupDependentQueue(fuse_ino_t key) {
         inode2FetchDentryPool_.erase(key);
     }
 
-    WriteLockGuard lockInodes(warmupInodesDequeMutex_);
-    for (auto it = warmupInodesDeque_.begin();
-         it != warmupInodesDeque_.end();) {
-        if (it->GetKey() == key) {
-            it = warmupInodesDeque_.erase(it);
-        } else {
-            ++it;
-        }
-    }
-
     auto fetchS3ObjIt = inode2FetchS3ObjectsPool_.find(key);
     if (fetchS3ObjIt != inode2FetchS3ObjectsPool_.end()) {
         inode2FetchS3ObjectsPool_[key]->Stop();
@@ -184,8 +184,12 @@ void WarmupManagerS3Impl::UnInit() {
     WriteLockGuard lockS3Objects(inode2FetchS3ObjectsPoolMutex_);
     inode2FetchS3ObjectsPool_.clear();
 
-    WriteLockGuard lockInodes(warmupInodesDequeMutex_);
-    warmupInodesDeque_.clear();
+    // the callbacks of downloading objects refer to us
+    {
+        std::unique_lock<std::mutex> lk(inflightMutex_);
+        inflightCond_.wait(lk, [this]() { return inflightObjs_ == 0; });
+    }
+    downloadThrottle_.Stop();
 
     WriteLockGuard lockFileList(warmupFilelistDequeMutex_);
     warmupFilelistDeque_.clear();
@@ -195,6 +199,10 @@ void WarmupManagerS3Impl::UnInit() {
 
 void WarmupManagerS3Impl::Init(const FuseClientOption& option) {
     WarmupManager::Init(option);
+    curve::common::ReadWriteThrottleParams params;
+    params.bpsRead =
+        curve::common::ThrottleParams(option.warmupMaxBytesPerSec, 0, 0);
+    downloadThrottle_.UpdateThrottleParams(params);
     bgFetchStop_.store(false, std::memory_order_release);
     bgFetchThread_ = Thread(&WarmupManagerS3Impl::BackGroundFetch, this);
     initbgFetchThread_ = true;
@@ -204,7 +212,6 @@ void WarmupManagerS3Impl::BackGroundFetch() {
     while (!bgFetchStop_.load(std::memory_order_acquire)) {
         usleep(WARMUP_CHECKINTERVAL_US);
         ScanWarmupFilelist();
-        ScanWarmupInodes();
         ScanCleanFetchS3ObjectsPool();
         ScanCleanFetchDentryPool();
         ScanCleanWarmupProgress();
@@ -308,14 +315,8 @@ void WarmupManagerS3Impl::FetchDentry(fuse_ino_t key, fuse_ino_t ino,
         return;
     }
     if (FsFileType::TYPE_S3 == dentry.type()) {
-        WriteLockGuard lock(warmupInodesDequeMutex_);
-        auto iterDeque = FindWarmupInodesByKeyLocked(key);
-        if (iterDeque == warmupInodesDeque_.end()) {
-            warmupInodesDeque_.emplace_back(
-                key, std::set<fuse_ino_t>{dentry.inodeid()});
-        } else {
-            iterDeque->AddFileInode(dentry.inodeid());
-        }
+        // hand over to the next stage immediately
+        FetchDataEnqueue(key, dentry.inodeid());
         return;
     } else if (FsFileType::TYPE_DIRECTORY == dentry.type()) {
         auto task = [this, key, dentry, symlink_depth]() {
@@ -376,28 +377,39 @@ void WarmupManagerS3Impl::FetchChildDentry(fuse_ino_t key, fuse_ino_t ino,
 
 void WarmupManagerS3Impl::FetchDataEnqueue(fuse_ino_t key, fuse_ino_t ino) {
     VLOG(9) << "FetchDataEnqueue start: key:" << key << " inode: " << ino;
+    // the stage is pending from now on, otherwise the progress may be
+    // considered done once the s3 objects pool is cleaned, before the
+    // task issues its downloads
+    AddPending(key, 1);
     auto task = [key, ino, this]() {
-        std::shared_ptr<InodeWrapper> inodeWrapper;
-        CURVEFS_ERROR ret = inodeManager_->GetInode(ino, inodeWrapper);
-        if (ret != CURVEFS_ERROR::OK) {
-            LOG(ERROR) << "inodeManager get inode fail, ret = " << ret
-                       << ", inodeid = " << ino;
-            return;
-        }
-        S3ChunkInfoMapType s3ChunkInfoMap;
-        {
-            ::curve::common::UniqueLock lgGuard = inodeWrapper->GetUniqueLock();
-            s3ChunkInfoMap = *inodeWrapper->GetChunkInfoMap();
-        }
-        if (s3ChunkInfoMap.empty()) {
-            return;
-        }
-        TravelChunks(key, ino, s3ChunkInfoMap);
+        FetchData(key, ino);
+        AddPending(key, -1);
     };
-    AddFetchS3objectsTask(key, task);
+    if (!AddFetchS3objectsTask(key, task)) {
+        AddPending(key, -1);
+    }
     VLOG(9) << "FetchDataEnqueue end: key:" << key << " inode: " << ino;
 }
 
+void WarmupManagerS3Impl::FetchData(fuse_ino_t key, fuse_ino_t ino) {
+    std::shared_ptr<InodeWrapper> inodeWrapper;
+    CURVEFS_ERROR ret = inodeManager_->GetInode(ino, inodeWrapper);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "inodeManager get inode fail, ret = " << ret
+                   << ", inodeid = " << ino;
+        return;
+    }
+    S3ChunkInfoMapType s3ChunkInfoMap;
+    {
+        ::curve::common::UniqueLock lgGuard = inodeWrapper->GetUniqueLock();
+        s3ChunkInfoMap = *inodeWrapper->GetChunkInfoMap();
+    }
+    if (s3ChunkInfoMap.empty()) {
+        return;
+    }
+    TravelChunks(key, ino, s3ChunkInfoMap);
+}
+
 void WarmupManagerS3Impl::TravelChunks(
     fuse_ino_t key, fuse_ino_t ino, const S3ChunkInfoMapType& s3ChunkInfoMap) {
     VLOG(9) << "travel chunk start: " << ino
@@ -415,10 +427,7 @@ void WarmupManagerS3Impl::TravelChunks(
                 LOG(ERROR) << "no such warmup progress: " << key;
             }
         }
-        auto task = [this, key, prefetchObjs]() {
-            WarmUpAllObjs(key, prefetchObjs);
-        };
-        AddFetchS3objectsTask(key, task);
+        WarmUpAllObjs(key, prefetchObjs);
     }
     VLOG(9) << "travel chunks end";
 }
@@ -522,17 +531,17 @@ void WarmupManagerS3Impl::TravelChunk(fuse_ino_t ino,
 void WarmupManagerS3Impl::WarmUpAllObjs(
     fuse_ino_t key,
     const std::list<std::pair<std::string, uint64_t>>& prefetchObjs) {
-    std::atomic<uint64_t> pendingReq(0);
-    curve::common::CountDownEvent cond(1);
     uint64_t start = butil::cpuwide_time_us();
     // callback function
     GetObjectAsyncCallBack cb =
-        [&](const S3Adapter* adapter,
+        [this, key, start](
+            const S3Adapter* adapter,
             const std::shared_ptr<GetObjectAsyncContext>& context) {
             (void)adapter;
             if (bgFetchStop_.load(std::memory_order_acquire)) {
                 VLOG(9) << "need stop warmup";
-                cond.Signal();
+                ReleaseBuffer(context);
+                OnObjectDone(key);
                 return;
             }
             if (context->retCode >= 0) {
@@ -542,21 +551,15 @@ void WarmupManagerS3Impl::WarmUpAllObjs(
                                               context->len,
                                               butil::cpuwide_time_us() - start);
                 warmupS3Metric_.warmupS3CacheSize << context->len;
-                if (pendingReq.fetch_sub(1, std::memory_order_seq_cst) == 1) {
-                    VLOG(6) << "pendingReq is over";
-                    cond.Signal();
-                }
+                OnObjectDone(key);
                 return;
             }
             warmupS3Metric_.warmupS3Cached.eps.count << 1;
             if (++context->retry >= option_.downloadMaxRetryTimes) {
-                if (pendingReq.fetch_sub(1, std::memory_order_seq_cst) == 1) {
-                    VLOG(6) << "pendingReq is over";
-                    cond.Signal();
-                }
                 VLOG(9) << "Up to max retry times, "
                         << "download object failed, key: " << context->key;
-                delete[] context->buf;
+                ReleaseBuffer(context);
+                OnObjectDone(key);
                 return;
             }
 
@@ -565,38 +568,62 @@ void WarmupManagerS3Impl::WarmUpAllObjs(
             s3Adaptor_->GetS3Client()->DownloadAsync(context);
         };
 
-    pendingReq.fetch_add(prefetchObjs.size(), std::memory_order_seq_cst);
-    if (pendingReq.load(std::memory_order_seq_cst)) {
-        VLOG(9) << "wait for pendingReq";
-        for (auto iter : prefetchObjs) {
-            VLOG(9) << "download start: " << iter.first;
-            std::string name = iter.first;
-            uint64_t readLen = iter.second;
-            {
-                ReadLockGuard lock(inode2ProgressMutex_);
-                auto iterProgress = FindWarmupProgressByKeyLocked(key);
-                if (iterProgress != inode2Progress_.end() &&
-                    iterProgress->second.GetStorageType() ==
-                        curvefs::client::common::WarmupStorageType::
-                            kWarmupStorageTypeDisk &&
-                    s3Adaptor_->GetDiskCacheManager()->IsCached(name)) {
-                    iterProgress->second.FinishedPlusOne();
-                    // storage in disk and has cached
-                    pendingReq.fetch_sub(1);
-                    continue;
-                }
+    for (const auto& iter : prefetchObjs) {
+        VLOG(9) << "download start: " << iter.first;
+        const std::string& name = iter.first;
+        uint64_t readLen = iter.second;
+        {
+            ReadLockGuard lock(inode2ProgressMutex_);
+            auto iterProgress = FindWarmupProgressByKeyLocked(key);
+            if (iterProgress == inode2Progress_.end()) {
+                VLOG(9) << "warmup task canceled: " << key;
+                return;
+            } else if (iterProgress->second.GetStorageType() ==
+                           curvefs::client::common::WarmupStorageType::
+                               kWarmupStorageTypeDisk &&
+                       s3Adaptor_->GetDiskCacheManager()->IsCached(name)) {
+                // storage in disk and has cached
+                iterProgress->second.FinishedPlusOne();
+                continue;
             }
-            char* cacheS3 = new char[readLen];
-            memset(cacheS3, 0, readLen);
-            auto context = std::make_shared<GetObjectAsyncContext>(
-                name, cacheS3, 0, readLen, cb);
-            context->retry = 0;
-            s3Adaptor_->GetS3Client()->DownloadAsync(context);
+            iterProgress->second.AddPending(1);
+        }
+
+        // wait for a free slot, then the bandwidth
+        {
+            std::unique_lock<std::mutex> lk(inflightMutex_);
+            inflightCond_.wait(lk, [this]() {
+                return inflightObjs_ < option_.warmupMaxInflightObjects;
+            });
+            inflightObjs_++;
         }
-        if (pendingReq.load()) cond.Wait();
+        downloadThrottle_.Add(true, readLen);
+
+        char* cacheS3 = new char[readLen];
+        memset(cacheS3, 0, readLen);
+        auto context = std::make_shared<GetObjectAsyncContext>(
+            name, cacheS3, 0, readLen, cb);
+        context->retry = 0;
+        s3Adaptor_->GetS3Client()->DownloadAsync(context);
+    }
+}
+
+void WarmupManagerS3Impl::AddPending(fuse_ino_t key, int64_t add) {
+    ReadLockGuard lock(inode2ProgressMutex_);
+    auto iter = FindWarmupProgressByKeyLocked(key);
+    if (iter != inode2Progress_.end()) {
+        iter->second.AddPending(add);
     }
 }
 
+void WarmupManagerS3Impl::OnObjectDone(fuse_ino_t key) {
+    AddPending(key, -1);
+
+    std::lock_guard<std::mutex> lk(inflightMutex_);
+    inflightObjs_--;
+    inflightCond_.notify_all();
+}
+
 bool WarmupManagerS3Impl::ProgressDone(fuse_ino_t key) {
     bool ret;
     {
@@ -610,12 +637,6 @@ bool WarmupManagerS3Impl::ProgressDone(fuse_ino_t key) {
                       inode2FetchDentryPool_.end());
     }
 
-    {
-        ReadLockGuard lockInodes(warmupInodesDequeMutex_);
-        ret = ret &&
-              (FindWarmupInodesByKeyLocked(key) == warmupInodesDeque_.end());
-    }
-
     {
         ReadLockGuard lockS3Objects(inode2FetchS3ObjectsPoolMutex_);
         ret = ret && (FindFetchS3ObjectsPoolByKeyLocked(key) ==
@@ -656,9 +677,9 @@ void WarmupManagerS3Impl::ScanCleanFetchS3ObjectsPool() {
 
 void WarmupManagerS3Impl::ScanCleanWarmupProgress() {
     // clean done warmupProgress
-    ReadLockGuard lock(inode2ProgressMutex_);
+    WriteLockGuard lock(inode2ProgressMutex_);
     for (auto iter = inode2Progress_.begin(); iter != inode2Progress_.end();) {
-        if (ProgressDone(iter->first)) {
+        if (iter->second.GetPending() == 0 && ProgressDone(iter->first)) {
             LOG(INFO) << "warmup task: " << iter->first << " done!";
             iter = inode2Progress_.erase(iter);
         } else {
@@ -667,20 +688,6 @@ void WarmupManagerS3Impl::ScanCleanWarmupProgress() {
     }
 }
 
-void WarmupManagerS3Impl::ScanWarmupInodes() {
-    // file need warmup
-    WriteLockGuard lock(warmupInodesDequeMutex_);
-    if (!warmupInodesDeque_.empty()) {
-        WarmupInodes inodes = warmupInodesDeque_.front();
-        for (auto const& iter : inodes.GetReadAheadFiles()) {
-            VLOG(9) << "BackGroundFetch: key: " << inodes.GetKey()
-                    << " inode:" << iter;
-            FetchDataEnqueue(inodes.GetKey(), iter);
-        }
-        warmupInodesDeque_.pop_front();
-    }
-}
-
 void WarmupManagerS3Impl::AlignFilelistPathsToCurveFs(
     const WarmupFilelist& filelist, std::vector<std::string>* list) {
     for (auto filePathIt = list->begin(); filePathIt != list->end();) {
@@ -743,23 +750,27 @@ void WarmupManagerS3Impl::AddFetchDentryTask(fuse_ino_t key,
     }
 }
 
-void WarmupManagerS3Impl::AddFetchS3objectsTask(fuse_ino_t key,
+bool WarmupManagerS3Impl::AddFetchS3objectsTask(fuse_ino_t key,
                                                 std::function<void()> task) {
     VLOG(9) << "add fetchS3Objects task: " << key;
-    if (!bgFetchStop_.load(std::memory_order_acquire)) {
-        WriteLockGuard lock(inode2FetchS3ObjectsPoolMutex_);
-        auto iter = inode2FetchS3ObjectsPool_.find(key);
-        if (iter == inode2FetchS3ObjectsPool_.end()) {
-            std::unique_ptr<ThreadPool> tp = absl::make_unique<ThreadPool>();
-            tp->Start(option_.warmupThreadsNum);
-            iter = inode2FetchS3ObjectsPool_.emplace(key, std::move(tp)).first;
-        }
-        if (!iter->second->Enqueue(task)) {
-            LOG(ERROR) << "key:" << key
-                       << " fetch s3 objects thread pool has been stoped!";
-        }
-        VLOG(9) << "add fetchS3Objects task: " << key << " finished";
+    if (bgFetchStop_.load(std::memory_order_acquire)) {
+        return false;
     }
+
+    WriteLockGuard lock(inode2FetchS3ObjectsPoolMutex_);
+    auto iter = inode2FetchS3ObjectsPool_.find(key);
+    if (iter == inode2FetchS3ObjectsPool_.end()) {
+        std::unique_ptr<ThreadPool> tp = absl::make_unique<ThreadPool>();
+        tp->Start(option_.warmupChunkInfoThreadsNum);
+        iter = inode2FetchS3ObjectsPool_.emplace(key, std::move(tp)).first;
+    }
+    if (!iter->second->Enqueue(task)) {
+        LOG(ERROR) << "key:" << key
+                   << " fetch s3 objects thread pool has been stoped!";
+        return false;
+    }
+    VLOG(9) << "add fetchS3Objects task: " << key << " finished";
+    return true;
 }
 
 void WarmupManagerS3Impl::PutObjectToCache(
@@ -768,6 +779,7 @@ void WarmupManagerS3Impl::PutObjectToCache(
     auto iter = FindWarmupProgressByKeyLocked(key);
     if (iter == inode2Progress_.end()) {
         VLOG(9) << "no this warmup task progress: " << key;
+        ReleaseBuffer(context);
         return;
     }
     int ret;
@@ -781,20 +793,23 @@ void WarmupManagerS3Impl::PutObjectToCache(
                 LOG_EVERY_SECOND(INFO)
                     << "write read directly failed, key: " << context->key;
             }
-            delete[] context->buf;
+            ReleaseBuffer(context);
             break;
         case curvefs::client::common::WarmupStorageType::
             kWarmupStorageTypeKvClient:
-            if (kvClientManager_ != nullptr) {
-                kvClientManager_->Set(std::make_shared<SetKVCacheTask>(
-                    context->key, context->buf, context->len,
-                    [context](const std::shared_ptr<SetKVCacheTask>&) {
-                        delete[] context->buf;
-                    }));
+            if (kvClientManager_ == nullptr) {
+                ReleaseBuffer(context);
+                break;
             }
+            kvClientManager_->Set(std::make_shared<SetKVCacheTask>(
+                context->key, context->buf, context->len,
+                [context](const std::shared_ptr<SetKVCacheTask>&) {
+                    ReleaseBuffer(context);
+                }));
             break;
         default:
             LOG_EVERY_N(ERROR, 1000) << "unsupported warmup storage type";
+            ReleaseBuffer(context);
     }
 }
 
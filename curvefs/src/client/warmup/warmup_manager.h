@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <functional>
@@ -33,7 +34,6 @@
 #include <map>
 #include <memory>
 #include <mutex>
-#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -51,6 +51,7 @@
 #include "curvefs/src/common/task_thread_pool.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/concurrent/rw_lock.h"
+#include "src/common/throttle.h"
 
 namespace curvefs {
 namespace client {
@@ -95,24 +96,8 @@ class WarmupFilelist : public WarmupFile {
     std::string root_;
 };
 
-class WarmupInodes {
- public:
-    explicit WarmupInodes(fuse_ino_t key = 0,
-                          std::set<fuse_ino_t> list = std::set<fuse_ino_t>())
-        : key_(key), readAheadFiles_(std::move(list)) {}
-
-    fuse_ino_t GetKey() const { return key_; }
-    const std::set<fuse_ino_t>& GetReadAheadFiles() const {
-        return readAheadFiles_;
-    }
-
-    void AddFileInode(fuse_ino_t file) { readAheadFiles_.emplace(file); }
-
- private:
-    fuse_ino_t key_;
-    std::set<fuse_ino_t> readAheadFiles_;
-};
-
+// All counters are updated by the stages of warmup concurrently,
+// so they are lock-free.
 class WarmupProgress {
  public:
     explicit WarmupProgress(WarmupStorageType type = curvefs::client::common::
@@ -120,46 +105,49 @@ class WarmupProgress {
                             std::string filePath = "")
         : total_(0),
           finished_(0),
+          pending_(0),
           storageType_(type),
           filePathInClient_(filePath) {}
 
     WarmupProgress(const WarmupProgress& wp)
-        : total_(wp.total_),
-          finished_(wp.finished_),
+        : total_(wp.total_.load(std::memory_order_relaxed)),
+          finished_(wp.finished_.load(std::memory_order_relaxed)),
+          pending_(wp.pending_.load(std::memory_order_relaxed)),
           storageType_(wp.storageType_),
           filePathInClient_(wp.filePathInClient_) {}
 
     void AddTotal(uint64_t add) {
-        std::lock_guard<std::mutex> lock(totalMutex_);
-        total_ += add;
+        total_.fetch_add(add, std::memory_order_relaxed);
     }
 
     WarmupProgress& operator=(const WarmupProgress& wp) {
-        total_ = wp.total_;
-        finished_ = wp.finished_;
+        total_.store(wp.total_.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+        finished_.store(wp.finished_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
         return *this;
     }
 
     void FinishedPlusOne() {
-        std::lock_guard<std::mutex> lock(finishedMutex_);
-        ++finished_;
+        finished_.fetch_add(1, std::memory_order_relaxed);
     }
 
-    uint64_t GetTotal() {
-        std::lock_guard<std::mutex> lock(totalMutex_);
-        return total_;
-    }
+    uint64_t GetTotal() { return total_.load(std::memory_order_relaxed); }
 
     uint64_t GetFinished() {
-        std::lock_guard<std::mutex> lock(finishedMutex_);
-        return finished_;
+        return finished_.load(std::memory_order_relaxed);
     }
 
+    // chunk info fetches and objects which are in progress
+    void AddPending(int64_t add) {
+        pending_.fetch_add(add, std::memory_order_acq_rel);
+    }
+
+    int64_t GetPending() { return pending_.load(std::memory_order_acquire); }
+
     std::string ToString() {
-        std::lock_guard<std::mutex> lockT(totalMutex_);
-        std::lock_guard<std::mutex> lockF(finishedMutex_);
-        return "total:" + std::to_string(total_) +
-               ",finished:" + std::to_string(finished_);
+        return "total:" + std::to_string(GetTotal()) +
+               ",finished:" + std::to_string(GetFinished());
     }
 
     std::string GetFilePathInClient() { return filePathInClient_; }
@@ -167,10 +155,9 @@ class WarmupProgress {
     WarmupStorageType GetStorageType() { return storageType_; }
 
  private:
-    uint64_t total_;
-    std::mutex totalMutex_;
-    uint64_t finished_;
-    std::mutex finishedMutex_;
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> finished_;
+    std::atomic<int64_t> pending_;
     WarmupStorageType storageType_;
     std::string filePathInClient_;
 };
@@ -418,21 +405,6 @@ class WarmupManagerS3Impl : public WarmupManager {
     void FetchChildDentry(fuse_ino_t key, fuse_ino_t ino,
                           uint32_t symlink_depth);
 
-    /**
-     * @brief
-     * Please use it with the lock warmupInodesDequeMutex_
-     * @param key
-     * @return std::deque<WarmupInodes>::iterator
-     */
-    std::deque<WarmupInodes>::iterator FindWarmupInodesByKeyLocked(
-        fuse_ino_t key) {
-        return std::find_if(warmupInodesDeque_.begin(),
-                            warmupInodesDeque_.end(),
-                            [key](const WarmupInodes& inodes) {
-                                return key == inodes.GetKey();
-                            });
-    }
-
     /**
      * @brief
      * Please use it with the lock warmupFilelistDequeMutex_
@@ -472,11 +444,15 @@ class WarmupManagerS3Impl : public WarmupManager {
         return inode2FetchS3ObjectsPool_.find(key);
     }
 
+    // the fetch is counted as pending until it has issued all downloads
     void FetchDataEnqueue(fuse_ino_t key, fuse_ino_t ino);
 
+    // fetch s3chunkinfo of the inode and issue downloads of its objects
+    void FetchData(fuse_ino_t key, fuse_ino_t ino);
+
     using S3ChunkInfoMapType = google::protobuf::Map<uint64_t, S3ChunkInfoList>;
 
-    // travel all chunks
+    // travel all chunks and download their objects
     void TravelChunks(fuse_ino_t key, fuse_ino_t ino,
                       const S3ChunkInfoMapType& s3ChunkInfoMap);
 
@@ -485,11 +461,16 @@ class WarmupManagerS3Impl : public WarmupManager {
     void TravelChunk(fuse_ino_t ino, const S3ChunkInfoList& chunkInfo,
                      ObjectListType* prefetchObjs);
 
-    // warmup all the prefetchObjs
+    // issue downloads of all the prefetchObjs, it returns once they are
+    // issued, and blocks if too many objects are downloading.
     void WarmUpAllObjs(
         fuse_ino_t key,
         const std::list<std::pair<std::string, uint64_t>>& prefetchObjs);
 
+    void AddPending(fuse_ino_t key, int64_t add);
+
+    void OnObjectDone(fuse_ino_t key);
+
     /**
      * @brief Whether the warmup task[key] is completed (or terminated)
      *
@@ -504,13 +485,12 @@ class WarmupManagerS3Impl : public WarmupManager {
 
     void ScanCleanWarmupProgress();
 
-    void ScanWarmupInodes();
-
     void ScanWarmupFilelist();
 
     void AddFetchDentryTask(fuse_ino_t key, std::function<void()> task);
 
-    void AddFetchS3objectsTask(fuse_ino_t key, std::function<void()> task);
+    // return false if the task isn't queued, e.g. warmup is stopped
+    bool AddFetchS3objectsTask(fuse_ino_t key, std::function<void()> task);
 
     void PutObjectToCache(
         fuse_ino_t key, const std::shared_ptr<GetObjectAsyncContext>& context);
@@ -528,17 +508,20 @@ class WarmupManagerS3Impl : public WarmupManager {
         inode2FetchDentryPool_;
     mutable RWLock inode2FetchDentryPoolMutex_;
 
-    std::deque<WarmupInodes> warmupInodesDeque_;
-    mutable RWLock warmupInodesDequeMutex_;
-
     // s3 adaptor
     std::shared_ptr<S3ClientAdaptor> s3Adaptor_;
 
-    // TODO(chengyi01): limit thread nums
+    // fetch s3chunkinfo and issue downloads, the downloads are asynchronous
+    // and limited by |inflightObjs_| and |downloadThrottle_|.
     std::unordered_map<fuse_ino_t, std::unique_ptr<ThreadPool>>
         inode2FetchS3ObjectsPool_;
     mutable RWLock inode2FetchS3ObjectsPoolMutex_;
 
+    uint32_t inflightObjs_ = 0;
+    std::mutex inflightMutex_;
+    std::condition_variable inflightCond_;
+    curve::common::Throttle downloadThrottle_;
+
     curvefs::client::metric::WarmupManagerS3Metric warmupS3Metric_;
 };
 
@@ -219,6 +219,8 @@ void FsManager::CheckMountPoint() {
         std::string fsName = iter->second.first;
         std::string mountpath = iter->first;
         if (now - iter->second.second > option_.clientTimeoutSec) {
+            // the leases are released even if umount fails below
+            metaLeaseManager_.RemoveMountpoint(fsName, mountpath);
             Mountpoint mountpoint;
             if (!Str2MountPoint(mountpath, &mountpoint)) {
                 LOG(ERROR) << "mountpath to mountpoint failed, mountpath = "
@@ -714,6 +716,7 @@ FSStatusCode FsManager::UmountFs(const std::string& fsName,
     std::string mountpath;
     MountPoint2Str(mountpoint, &mountpath);
     DeleteClientAliveTime(mountpath);
+    metaLeaseManager_.RemoveMountpoint(fsName, mountpath);
 
     // 3. if no mount point exist, release all block groups
     if (wrapper.GetFsType() == FSType::TYPE_VOLUME) {
@@ -964,6 +967,16 @@ void FsManager::RefreshSession(const RefreshSessionRequest* request,
 
     // update this client's alive time
     UpdateClientAliveTime(request->mountpoint(), request->fsname());
+
+    // exchange meta leases, e.g. grant, revoke
+    if (request->has_metalease()) {
+        std::string mountpath;
+        MountPoint2Str(request->mountpoint(), &mountpath);
+        metaLeaseManager_.Refresh(request->fsname(), mountpath,
+                                  request->metalease(),
+                                  response->mutable_metalease());
+    }
+
     FsInfoWrapper wrapper;
     FSStatusCode ret = fsStorage_->Get(request->fsname(), &wrapper);
     if (ret != FSStatusCode::OK) {
@@ -1239,15 +1252,16 @@ void FsManager::UpdateClientAliveTime(const Mountpoint& mountpoint,
     std::string mountpath;
     MountPoint2Str(mountpoint, &mountpath);
     WriteLockGuard wlock(recorderMutex_);
-    if (addMountPoint) {
-        auto iter = mpTimeRecorder_.find(mountpath);
+    auto iter = mpTimeRecorder_.find(mountpath);
+    if (iter == mpTimeRecorder_.end()) {
         // client hang timeout and recover later
         // need add mountpoint to fsInfo
-        if (iter == mpTimeRecorder_.end()) {
-            if (AddMountPoint(mountpoint, fsName) != FSStatusCode::OK) {
-                return;
-            }
+        if (addMountPoint &&
+            AddMountPoint(mountpoint, fsName) != FSStatusCode::OK) {
+            return;
         }
+        // no lease is granted until we know it reports modifications
+        metaLeaseManager_.AddMountpoint(fsName, mountpath);
     }
     mpTimeRecorder_[mountpath] = std::make_pair(
         fsName, ::curve::common::TimeUtility::GetTimeofDaySec());
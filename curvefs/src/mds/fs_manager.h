@@ -37,6 +37,7 @@
 #include "curvefs/src/mds/common/types.h"
 #include "curvefs/src/mds/fs_info_wrapper.h"
 #include "curvefs/src/mds/fs_storage.h"
+#include "curvefs/src/mds/meta_lease_manager.h"
 #include "curvefs/src/mds/metaserverclient/metaserver_client.h"
 #include "curvefs/src/mds/space/manager.h"
 #include "curvefs/src/mds/topology/topology.h"
@@ -74,6 +75,7 @@ struct FsManagerOption {
     uint32_t spaceReloadConcurrency = 10;
     uint32_t clientTimeoutSec = 20;
     curve::common::S3AdapterOption s3AdapterOption;
+    MetaLeaseOption metaLeaseOption;
 };
 
 class FsManager {
@@ -93,7 +95,8 @@ class FsManager {
           s3Adapter_(s3Adapter),
           dlock_(dlock),
           isStop_(true),
-          option_(option) {}
+          option_(option),
+          metaLeaseManager_(option.metaLeaseOption) {}
 
     bool Init();
     void Run();
@@ -277,6 +280,9 @@ class FsManager {
     // <mountpoint, <fsname,last update time>>
     std::map<std::string, std::pair<std::string, uint64_t>> mpTimeRecorder_;
     mutable RWLock recorderMutex_;
+
+    // read leases of metadata granted to mountpoints
+    MetaLeaseManager metaLeaseManager_;
     // fsuage update lock
     mutable RWLock fsUsageMutex_;
 };
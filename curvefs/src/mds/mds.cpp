@@ -163,6 +163,36 @@ void MDS::InitFsManagerOptions(FsManagerOption* fsManagerOption) {
            "default value: "
         << fsManagerOption->spaceReloadConcurrency;
 
+    auto* leaseOption = &fsManagerOption->metaLeaseOption;
+    LOG_IF(ERROR, !conf_->GetUInt32Value(
+                      "mds.fsmanager.metaLease.maxLeasesPerClient",
+                      &leaseOption->maxLeasesPerClient))
+        << "Get `mds.fsmanager.metaLease.maxLeasesPerClient` from conf error, "
+           "use default value: "
+        << leaseOption->maxLeasesPerClient;
+
+    LOG_IF(ERROR, !conf_->GetUInt32Value(
+                      "mds.fsmanager.metaLease.maxModifiedRecords",
+                      &leaseOption->maxModifiedRecords))
+        << "Get `mds.fsmanager.metaLease.maxModifiedRecords` from conf error, "
+           "use default value: "
+        << leaseOption->maxModifiedRecords;
+
+    LOG_IF(ERROR, !conf_->GetUInt32Value("mds.fsmanager.metaLease.leaseTimeMs",
+                                         &leaseOption->leaseTimeMs))
+        << "Get `mds.fsmanager.metaLease.leaseTimeMs` from conf error, "
+           "use default value: "
+        << leaseOption->leaseTimeMs;
+
+    // the leases must expire before the state of a timeout client is dropped
+    uint32_t maxLeaseTimeMs = fsManagerOption->clientTimeoutSec * 1000;
+    if (leaseOption->leaseTimeMs > maxLeaseTimeMs) {
+        LOG(WARNING) << "`mds.fsmanager.metaLease.leaseTimeMs` is larger "
+                        "than client timeout, use "
+                     << maxLeaseTimeMs << " instead";
+        leaseOption->leaseTimeMs = maxLeaseTimeMs;
+    }
+
     ::curve::common::InitS3AdaptorOptionExceptS3InfoOption(
         conf_.get(), &fsManagerOption->s3AdapterOption);
 }
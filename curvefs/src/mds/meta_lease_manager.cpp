@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/mds/meta_lease_manager.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/common/timeutility.h"
+
+namespace curvefs {
+namespace mds {
+
+using ::curve::common::LockGuard;
+using ::curve::common::TimeUtility;
+
+MetaLeaseManager::MetaLeaseManager(const MetaLeaseOption& option)
+    : option_(option),
+      epoch_(0),
+      sequence_(0) {}
+
+void MetaLeaseManager::Release(FsLeases* fs,
+                               const std::string& mountpoint,
+                               uint64_t ino) {
+    auto iter = fs->holders.find(ino);
+    if (iter == fs->holders.end()) {
+        return;
+    }
+
+    iter->second.erase(mountpoint);
+    if (iter->second.empty()) {
+        fs->holders.erase(iter);
+    }
+}
+
+void MetaLeaseManager::Modify(FsLeases* fs,
+                              const std::string& mountpoint,
+                              uint64_t ino) {
+    fs->modified[ino] = sequence_;
+
+    auto iter = fs->holders.find(ino);
+    if (iter == fs->holders.end()) {
+        return;
+    }
+
+    // the modifier has dropped its cache already
+    for (const auto& holder : iter->second) {
+        if (holder == mountpoint) {
+            continue;
+        }
+        auto& client = fs->clients[holder];
+        client.held.erase(ino);
+        client.revoked.push_back(ino);
+    }
+
+    bool held = iter->second.count(mountpoint) != 0;
+    iter->second.clear();
+    if (held) {
+        iter->second.insert(mountpoint);
+    } else {
+        fs->holders.erase(iter);
+    }
+}
+
+void MetaLeaseManager::RevokeAll(FsLeases* fs) {
+    for (auto& item : fs->clients) {
+        auto& client = item.second;
+        client.revoked.insert(client.revoked.end(), client.held.begin(),
+                              client.held.end());
+        client.held.clear();
+    }
+    fs->holders.clear();
+
+    // the metadata fetched before may be modified by unreported ones
+    sequence_++;
+    fs->modified.clear();
+    fs->minSequence = sequence_;
+}
+
+bool MetaLeaseManager::Grant(FsLeases* fs,
+                             const std::string& mountpoint,
+                             uint64_t ino,
+                             uint64_t sequence) {
+    // the metadata which client fetched may be modified after that
+    auto iter = fs->modified.find(ino);
+    if (!fs->unleased.empty() || sequence < fs->minSequence ||
+        (iter != fs->modified.end() && iter->second > sequence)) {
+        return false;
+    }
+
+    auto& client = fs->clients[mountpoint];
+    if (client.held.size() >= option_.maxLeasesPerClient) {
+        return false;
+    }
+
+    client.held.insert(ino);
+    fs->holders[ino].insert(mountpoint);
+    return true;
+}
+
+void MetaLeaseManager::Refresh(const std::string& fsName,
+                               const std::string& mountpoint,
+                               const MetaLeaseRequest& request,
+                               MetaLeaseResponse* response) {
+    LockGuard lk(mutex_);
+    auto& fs = fsLeases_[fsName];
+    auto& client = fs.clients[mountpoint];
+    if (client.epoch == 0) {
+        // the client may still hold leases of which we know nothing,
+        // the new epoch makes it drop them
+        epoch_ = std::max(TimeUtility::GetTimeofDayUs(), epoch_ + 1);
+        client.epoch = epoch_;
+    }
+    fs.unleased.erase(mountpoint);
+
+    for (const auto& ino : request.release()) {
+        client.held.erase(ino);
+        Release(&fs, mountpoint, ino);
+    }
+
+    if (request.modified_size() > 0) {
+        sequence_++;
+        for (const auto& ino : request.modified()) {
+            Modify(&fs, mountpoint, ino);
+        }
+
+        if (fs.modified.size() > option_.maxModifiedRecords) {
+            fs.modified.clear();
+            fs.minSequence = sequence_;
+        }
+    }
+
+    // the sequence is meaningless if it comes from another epoch
+    if (request.epoch() == client.epoch) {
+        for (const auto& ino : request.acquire()) {
+            if (Grant(&fs, mountpoint, ino, request.sequence())) {
+                response->add_granted(ino);
+            }
+        }
+    }
+
+    *response->mutable_revoked() = {client.revoked.begin(),
+                                    client.revoked.end()};
+    client.revoked.clear();
+    response->set_epoch(client.epoch);
+    response->set_sequence(sequence_);
+    // the client counts the lease time from the moment it sent the request
+    response->set_leasetimeus(option_.leaseTimeMs * 1000ULL);
+
+    VLOG(6) << "Refresh meta lease, fsName = " << fsName
+            << ", mountpoint = " << mountpoint
+            << ", request = " << request.ShortDebugString()
+            << ", response = " << response->ShortDebugString();
+}
+
+void MetaLeaseManager::AddMountpoint(const std::string& fsName,
+                                     const std::string& mountpoint) {
+    LockGuard lk(mutex_);
+    auto& fs = fsLeases_[fsName];
+    if (fs.clients.count(mountpoint) != 0 ||
+        !fs.unleased.insert(mountpoint).second) {
+        return;
+    }
+
+    // it may modify without reporting, e.g. the lease is disabled
+    RevokeAll(&fs);
+}
+
+void MetaLeaseManager::RemoveMountpoint(const std::string& fsName,
+                                        const std::string& mountpoint) {
+    LockGuard lk(mutex_);
+    auto iter = fsLeases_.find(fsName);
+    if (iter == fsLeases_.end()) {
+        return;
+    }
+
+    auto& fs = iter->second;
+    auto client = fs.clients.find(mountpoint);
+    if (client != fs.clients.end()) {
+        fs.clients.erase(client);
+    } else if (fs.unleased.erase(mountpoint) == 0) {
+        return;
+    }
+
+    // the modifications of it may be lost or unreported
+    RevokeAll(&fs);
+    if (fs.clients.empty() && fs.unleased.empty()) {
+        fsLeases_.erase(iter);
+    }
+}
+
+}  // namespace mds
+}  // namespace curvefs
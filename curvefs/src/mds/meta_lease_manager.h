@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_MDS_META_LEASE_MANAGER_H_
+#define CURVEFS_SRC_MDS_META_LEASE_MANAGER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "curvefs/proto/mds.pb.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curvefs {
+namespace mds {
+
+struct MetaLeaseOption {
+    // max number of leases held by one mountpoint
+    uint32_t maxLeasesPerClient = 100000;
+    // max number of modified inodes remembered for each fs, the leases
+    // acquired before the oldest record will be denied
+    uint32_t maxModifiedRecords = 100000;
+    // leases keep valid for it after each refresh of client, it should be
+    // larger than the refresh interval and less than the client timeout
+    uint32_t leaseTimeMs = 10000;
+};
+
+/**
+ * Manage the read leases of directory or inode which granted to mountpoints.
+ *
+ * All messages are exchanged by refresh session: mountpoint reports the
+ * inodes it modified, and the leases of them held by other mountpoints will
+ * be revoked at their next refresh.
+ *
+ * Only the mountpoints which exchange leases report their modifications, so
+ * no lease is granted while any other mountpoint of the fs is alive, and all
+ * leases of the fs are revoked once a mountpoint is removed, because its
+ * last modifications may not be reported, e.g. the client crashed.
+ *
+ * The state lives in memory only, every mountpoint gets a new epoch once its
+ * state is created, e.g. mds restarted or the mountpoint has been removed,
+ * and then the client drops all its leases.
+ */
+class MetaLeaseManager {
+ public:
+    explicit MetaLeaseManager(const MetaLeaseOption& option);
+
+    void Refresh(const std::string& fsName,
+                 const std::string& mountpoint,
+                 const MetaLeaseRequest& request,
+                 MetaLeaseResponse* response);
+
+    // the mountpoint is mounted or found after restart, it doesn't exchange
+    // leases until its first refresh with lease
+    void AddMountpoint(const std::string& fsName,
+                       const std::string& mountpoint);
+
+    // release all leases of the mountpoint, e.g. client umounted or timeout
+    void RemoveMountpoint(const std::string& fsName,
+                          const std::string& mountpoint);
+
+ private:
+    struct ClientLeases {
+        uint64_t epoch = 0;
+        std::unordered_set<uint64_t> held;
+        std::vector<uint64_t> revoked;
+    };
+
+    struct FsLeases {
+        // <inode, mountpoints which hold the lease>
+        std::unordered_map<uint64_t, std::unordered_set<std::string>> holders;
+        std::unordered_map<std::string, ClientLeases> clients;
+        // <inode, sequence when it's modified lastly>
+        std::unordered_map<uint64_t, uint64_t> modified;
+        // modified records before it have been discarded
+        uint64_t minSequence = 0;
+        // mountpoints which don't report their modifications
+        std::unordered_set<std::string> unleased;
+    };
+
+    void Release(FsLeases* fs, const std::string& mountpoint, uint64_t ino);
+
+    void Modify(FsLeases* fs, const std::string& mountpoint, uint64_t ino);
+
+    // revoke all leases of the fs and deny the acquires in flight
+    void RevokeAll(FsLeases* fs);
+
+    bool Grant(FsLeases* fs,
+               const std::string& mountpoint,
+               uint64_t ino,
+               uint64_t sequence);
+
+ private:
+    MetaLeaseOption option_;
+    uint64_t epoch_;
+    uint64_t sequence_;
+    ::curve::common::Mutex mutex_;
+    std::unordered_map<std::string, FsLeases> fsLeases_;
+};
+
+}  // namespace mds
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_MDS_META_LEASE_MANAGER_H_
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_COMMON_STRIPED_LOCK_H_
+#define CURVEFS_SRC_METASERVER_COMMON_STRIPED_LOCK_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "src/common/concurrent/rw_lock.h"
+#include "src/common/uncopyable.h"
+
+namespace curvefs {
+namespace metaserver {
+
+// A fixed set of reader-writer locks, the lock of an object (parent inode
+// of dentry, inode itself, ...) is selected by its key, so operations on
+// different objects rarely contend with each other.
+class StripedRWLock : public ::curve::common::Uncopyable {
+ public:
+    static constexpr size_t kDefaultStripes = 64;
+
+    explicit StripedRWLock(size_t stripes = kDefaultStripes)
+        : locks_(std::max<size_t>(stripes, 1)) {}
+
+    size_t Stripes() const { return locks_.size(); }
+
+    size_t StripeOf(uint64_t key) const { return key % locks_.size(); }
+
+    ::curve::common::RWLock* At(size_t stripe) { return &locks_[stripe]; }
+
+ private:
+    std::vector<::curve::common::RWLock> locks_;
+};
+
+// Lock the stripes of one or more keys, stripes are always locked in
+// ascending order and only once, so guards never deadlock each other.
+class StripedLockGuard : public ::curve::common::Uncopyable {
+ public:
+    // lock all stripes, e.g: for clearing the whole table
+    StripedLockGuard(StripedRWLock* lock, bool exclusive)
+        : lock_(lock), exclusive_(exclusive) {
+        for (size_t i = 0; i < lock_->Stripes(); i++) {
+            stripes_.push_back(i);
+        }
+        Lock();
+    }
+
+    StripedLockGuard(StripedRWLock* lock, uint64_t key, bool exclusive)
+        : lock_(lock), stripes_{lock->StripeOf(key)}, exclusive_(exclusive) {
+        Lock();
+    }
+
+    StripedLockGuard(StripedRWLock* lock, const std::vector<uint64_t>& keys,
+                     bool exclusive)
+        : lock_(lock), exclusive_(exclusive) {
+        for (const auto& key : keys) {
+            stripes_.push_back(lock_->StripeOf(key));
+        }
+        std::sort(stripes_.begin(), stripes_.end());
+        stripes_.erase(std::unique(stripes_.begin(), stripes_.end()),
+                       stripes_.end());
+        Lock();
+    }
+
+    ~StripedLockGuard() { Unlock(); }
+
+    // release the locks before the guard goes out of scope
+    void Unlock() {
+        for (auto iter = stripes_.rbegin(); iter != stripes_.rend(); iter++) {
+            lock_->At(*iter)->Unlock();
+        }
+        stripes_.clear();
+    }
+
+ private:
+    void Lock() {
+        for (const auto& stripe : stripes_) {
+            if (exclusive_) {
+                lock_->At(stripe)->WRLock();
+            } else {
+                lock_->At(stripe)->RDLock();
+            }
+        }
+    }
+
+ private:
+    StripedRWLock* lock_;
+    std::vector<size_t> stripes_;
+    bool exclusive_;
+};
+
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_COMMON_STRIPED_LOCK_H_
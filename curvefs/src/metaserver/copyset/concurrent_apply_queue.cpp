@@ -23,11 +23,18 @@
 
 #include "curvefs/src/metaserver/copyset/concurrent_apply_queue.h"
 
+#include <bvar/bvar.h>
+
 #include <algorithm>
+#include <mutex>
 
 namespace curvefs {
 namespace metaserver {
 namespace copyset {
+
+static bvar::Adder<uint64_t> g_apply_read_conflict_count(
+    "concurrent_apply_read_conflict_count");
+
 bool ApplyQueue::Init(const ApplyOption &opt) {
     if (start_) {
         LOG(WARNING) << "concurrent module already start!";
@@ -193,6 +200,95 @@ ThreadPoolType ApplyQueue::Schedule(OperatorType optype) {
         return ThreadPoolType::WRITE;
     }
 }
+
+bool ApplyQueue::IsBarrier(OperatorType optype) {
+    return optype == OperatorType::RenameDentry;
+}
+
+int ApplyQueue::Route(uint64_t key, uint64_t conflictKey, bool write) {
+    std::unique_lock<bthread::Mutex> lk(pendingMtx_);
+    int index = -1;
+    auto iter = pending_.find(key);
+    // the task which touches the whole partition conflicts with all pending
+    // writes of the partition, it waits until they are queued to one thread.
+    // As a write of the whole partition is queued after all pending writes
+    // of the partition, and all writes of the partition are queued after
+    // it until it finished, it never waits for a write of another object.
+    while (conflictKey == 0 && iter != pending_.end() &&
+           iter->second.threads.size() > 1) {
+        pendingCond_.wait(lk);
+        iter = pending_.find(key);
+    }
+
+    if (iter != pending_.end()) {
+        const auto& pending = iter->second;
+        const auto& conflictKeys = pending.conflictKeys;
+        auto all = conflictKeys.find(0);
+        auto object = conflictKeys.find(conflictKey);
+        if (conflictKey == 0) {
+            index = pending.threads.begin()->first;
+        } else if (all != conflictKeys.end()) {
+            index = all->second.index;
+        } else if (object != conflictKeys.end()) {
+            index = object->second.index;
+        }
+    }
+
+    if (!write) {
+        if (index >= 0) {
+            g_apply_read_conflict_count << 1;
+        }
+        return index;
+    }
+
+    if (index < 0) {
+        index = Hash(key + conflictKey, wconcurrentsize_);
+    }
+    auto& pending = pending_[key];
+    pending.total++;
+    auto& object = pending.conflictKeys[conflictKey];
+    object.count++;
+    object.index = index;
+    pending.threads[index]++;
+    return index;
+}
+
+void ApplyQueue::RemovePending(uint64_t key, uint64_t conflictKey,
+                               int index) {
+    bool drained = false;
+    {
+        std::lock_guard<bthread::Mutex> lk(pendingMtx_);
+        auto iter = pending_.find(key);
+        CHECK(iter != pending_.end());
+        auto& pending = iter->second;
+        auto object = pending.conflictKeys.find(conflictKey);
+        CHECK(object != pending.conflictKeys.end());
+        if (--object->second.count == 0) {
+            pending.conflictKeys.erase(object);
+        }
+
+        auto thread = pending.threads.find(index);
+        CHECK(thread != pending.threads.end());
+        if (--thread->second == 0) {
+            pending.threads.erase(thread);
+            drained = true;
+        }
+
+        if (--pending.total == 0) {
+            pending_.erase(iter);
+        }
+    }
+
+    if (drained) {
+        pendingCond_.notify_all();
+    }
+}
+
+void ApplyQueue::RunWrite(uint64_t key, uint64_t conflictKey, int index,
+                          const std::function<void()>& task) {
+    task();
+    RemovePending(key, conflictKey, index);
+}
 }   // namespace copyset
 }   // namespace metaserver
 }   // namespace curvefs
@@ -28,6 +28,7 @@
 #include <glog/logging.h>
 
 #include <atomic>
+#include <functional>
 #include <thread>
 #include <unordered_map>
 #include <utility>
@@ -94,14 +95,57 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
      */
     template <class F, class... Args>
     bool Push(uint64_t key, OperatorType optype, F&& f, Args&&... args) {
+        return Push(key, 0, optype, std::forward<F>(f),
+                    std::forward<Args>(args)...);
+    }
+
+    /**
+     * Push: apply task will be push to ApplyQueue
+     * @param[in] key: used to hash task to specified queue
+     * @param[in] conflictKey: the object which task touches under |key|,
+     *                         0 means all objects under |key|, writes of
+     *                         the same object are executed in log order
+     * @param[in] optype: operation type defined in proto
+     * @param[in] f: task
+     * @param[in] args: param to excute task
+     */
+    template <class F, class... Args>
+    bool Push(uint64_t key, uint64_t conflictKey, OperatorType optype,
+              F&& f, Args&&... args) {
+        // operator which touches multiple partitions can't be hashed to
+        // one queue, we wait for all previous writes and run it in place,
+        // so it's ordered with writes of all partitions
+        if (IsBarrier(optype)) {
+            Flush();
+            std::forward<F>(f)(std::forward<Args>(args)...);
+            return true;
+        }
+
+        int index = -1;
         switch (Schedule(optype)) {
             case ThreadPoolType::READ:
-                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(
-                        std::forward<F>(f), std::forward<Args>(args)...);
+                // read which conflicts with pending writes is queued after
+                // them, others are spread to read threads by object
+                index = Route(key, conflictKey, false);
+                if (index >= 0) {
+                    wapplyMap_[index]->tq.Push(std::forward<F>(f),
+                                               std::forward<Args>(args)...);
+                } else {
+                    rapplyMap_[Hash(key + conflictKey, rconcurrentsize_)]
+                        ->tq.Push(std::forward<F>(f),
+                                  std::forward<Args>(args)...);
+                }
                 break;
             case ThreadPoolType::WRITE:
-                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(
-                        std::forward<F>(f), std::forward<Args>(args)...);
+                // writes of one partition are spread by |conflictKey|,
+                // a write is queued after the pending writes it conflicts
+                // with, so writes of one object are applied in log order,
+                // see Route() for details
+                index = Route(key, conflictKey, true);
+                wapplyMap_[index]->tq.Push(
+                    &ApplyQueue::RunWrite, this, key, conflictKey, index,
+                    std::function<void()>(std::bind(
+                        std::forward<F>(f), std::forward<Args>(args)...)));
                 break;
         }
 
@@ -123,6 +167,24 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
 
     static ThreadPoolType Schedule(OperatorType optype);
 
+    static bool IsBarrier(OperatorType optype);
+
+    /**
+     * Route: pick the write thread which the task is queued to
+     * @param[in] key: partition of the task
+     * @param[in] conflictKey: the object which task touches under |key|
+     * @param[in] write: whether the task is a write, it will be pending
+     *                   on the returned thread until it finished
+     * @return index of the write thread, or -1 if the read doesn't
+     *         conflict with any pending write
+     */
+    int Route(uint64_t key, uint64_t conflictKey, bool write);
+
+    void RemovePending(uint64_t key, uint64_t conflictKey, int index);
+
+    void RunWrite(uint64_t key, uint64_t conflictKey, int index,
+                  const std::function<void()>& task);
+
     void InitThreadPool(ThreadPoolType type, int concorrent, int depth);
 
     static int Hash(uint64_t key, int concurrent) {
@@ -136,6 +198,20 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
         explicit TaskThread(size_t capacity) : tq(capacity) {}
     };
 
+    // writes pushed but not finished yet under one key
+    struct PendingWrites {
+        struct Object {
+            uint64_t count = 0;
+            int index = 0;
+        };
+
+        uint64_t total = 0;
+        // conflict key -> pending writes and the thread they are queued to
+        std::unordered_map<uint64_t, Object> conflictKeys;
+        // write thread -> pending writes
+        std::unordered_map<int, uint64_t> threads;
+    };
+
     std::atomic<bool> start_;
     int rconcurrentsize_;
     int rqueuedepth_;
@@ -144,6 +220,9 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
     CountDownEvent cond_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<int, TaskThread*> wapplyMap_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<int, TaskThread*> rapplyMap_;
+    bthread::Mutex pendingMtx_;
+    bthread::ConditionVariable pendingCond_;
+    std::unordered_map<uint64_t, PendingWrites> pending_;
 };
 }   // namespace copyset
 }   // namespace metaserver
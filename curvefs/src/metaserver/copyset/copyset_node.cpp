@@ -27,6 +27,7 @@
 #include <brpc/channel.h>
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <utility>
@@ -237,6 +238,37 @@ void CopysetNode::UpdateAppliedIndex(uint64_t index) {
     }
 }
 
+void CopysetNode::StartApply(uint64_t index) {
+    std::lock_guard<Mutex> lk(applyingMtx_);
+    applying_.emplace_back(index, false);
+}
+
+void CopysetNode::RunApplyTask(uint64_t index,
+                               const std::function<void()>& task) {
+    task();
+
+    uint64_t applied = 0;
+    {
+        std::lock_guard<Mutex> lk(applyingMtx_);
+        auto iter = std::lower_bound(
+            applying_.begin(), applying_.end(), index,
+            [](const std::pair<uint64_t, bool>& entry, uint64_t value) {
+                return entry.first < value;
+            });
+        CHECK(iter != applying_.end() && iter->first == index)
+            << "Log entry is not applying, index = " << index;
+        iter->second = true;
+        while (!applying_.empty() && applying_.front().second) {
+            applied = applying_.front().first;
+            applying_.pop_front();
+        }
+    }
+
+    if (applied != 0) {
+        UpdateAppliedIndex(applied);
+    }
+}
+
 bool CopysetNode::IsLeaseLeader(const braft::LeaderLeaseStatus &lease_status) const {  // NOLINT
     /*
      * Why not use lease_status.state==LEASE_VALID directly to judge?
@@ -285,18 +317,22 @@ void CopysetNode::on_apply(braft::Iterator& iter) {
             MetaOperatorClosure* metaClosure =
                 dynamic_cast<MetaOperatorClosure*>(iter.done());
             CHECK(metaClosure != nullptr) << "dynamic cast failed";
-            metaClosure->GetOperator()->timerPropose.stop();
-            g_oprequest_propose_latency
-                << metaClosure->GetOperator()->timerPropose.u_elapsed();
+            auto* op = metaClosure->GetOperator();
+            op->timerPropose.stop();
+            g_oprequest_propose_latency << op->timerPropose.u_elapsed();
+            metric_->ProposeLatency(op->GetOperatorType(),
+                                    op->timerPropose.u_elapsed());
             butil::Timer timer;
             timer.start();
             auto task =
-                std::bind(&MetaOperator::OnApply, metaClosure->GetOperator(),
-                          iter.index(), doneGuard.release(),
-                          TimeUtility::GetTimeofDayUs());
-            applyQueue_->Push(metaClosure->GetOperator()->HashCode(),
-                              metaClosure->GetOperator()->GetOperatorType(),
-                              std::move(task));
+                std::bind(&MetaOperator::OnApply, op, iter.index(),
+                          doneGuard.release(), TimeUtility::GetTimeofDayUs());
+            StartApply(iter.index());
+            applyQueue_->Push(op->HashCode(), op->ConflictKey(),
+                              op->GetOperatorType(),
+                              std::bind(&CopysetNode::RunApplyTask, this,
+                                        iter.index(),
+                                        std::function<void()>(task)));
             timer.stop();
             g_concurrent_apply_wait_latency << timer.u_elapsed();
         } else {
@@ -306,11 +342,16 @@ void CopysetNode::on_apply(braft::Iterator& iter) {
             butil::Timer timer;
             timer.start();
             auto hashcode = metaOperator->HashCode();
+            auto conflictKey = metaOperator->ConflictKey();
             auto type = metaOperator->GetOperatorType();
             auto task =
                 std::bind(&MetaOperator::OnApplyFromLog, metaOperator.release(),
                           iter.index(), TimeUtility::GetTimeofDayUs());
-            applyQueue_->Push(hashcode, type, std::move(task));
+            StartApply(iter.index());
+            applyQueue_->Push(hashcode, conflictKey, type,
+                              std::bind(&CopysetNode::RunApplyTask, this,
+                                        iter.index(),
+                                        std::function<void()>(task)));
             timer.stop();
             g_concurrent_apply_from_log_wait_latency << timer.u_elapsed();
         }
@@ -368,7 +409,8 @@ class OnSnapshotSaveDoneClosureImpl : public OnSnapshotSaveDoneClosure {
 void CopysetNode::DoSnapshot(OnSnapshotSaveDoneClosure* done) {
     // NOTE: save metadata cannot be asynchronous
     // we need maintain the consistency with
-    // raft snapshot metadata
+    // raft snapshot metadata, but it only captures the partitions and
+    // a point-in-time view of storage, which are serialized by `SaveData()`
     std::vector<std::string> files;
     brpc::ClosureGuard doneGuard(done);
     auto* writer = done->GetSnapshotWriter();
@@ -27,10 +27,13 @@
 #include <gtest/gtest_prod.h>
 
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "curvefs/proto/heartbeat.pb.h"
@@ -112,6 +115,13 @@ class CopysetNode : public braft::StateMachine {
 
     uint64_t GetAppliedIndex() const;
 
+    /**
+     * @brief Run the task of log entry at |index| pushed by on_apply(),
+     *        the applied index is advanced when all entries up to it
+     *        are finished
+     */
+    void RunApplyTask(uint64_t index, const std::function<void()>& task);
+
     /**
      * @brief Get current copyset node's leader status
      * @return true if success, otherwise return false
@@ -211,6 +221,9 @@ class CopysetNode : public braft::StateMachine {
  private:
     void InitRaftNodeOptions();
 
+    // record the log entry at |index| is pushed to apply queue
+    void StartApply(uint64_t index);
+
     bool FetchLeaderStatus(const braft::PeerId& peerId,
                            braft::NodeStatus* leaderStatus);
 
@@ -220,6 +233,7 @@ class CopysetNode : public braft::StateMachine {
         uint32_t *blockGroupNum);
 
     FRIEND_TEST(CopysetNodeBlockGroupTest, Test_AggregateBlockStatInfo);
+    FRIEND_TEST(CopysetNodeTest, AppliedIndexWatermarkTest);
 
  private:
     // for snapshot
@@ -257,9 +271,15 @@ class CopysetNode : public braft::StateMachine {
 
     std::unique_ptr<MetaStore> metaStore_;
 
-    // applied log index
+    // applied log index, all log entries not above it are applied
     std::atomic<uint64_t> appliedIndex_;
 
+    // log entries which are applying in log order, and whether it's
+    // finished, writes of different objects are applied in parallel
+    // and may finish out of order
+    Mutex applyingMtx_;
+    std::deque<std::pair<uint64_t, bool>> applying_;
+
     std::unique_ptr<ConfEpochFile> epochFile_;
 
     std::unique_ptr<ApplyQueue> applyQueue_;
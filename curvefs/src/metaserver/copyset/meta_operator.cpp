@@ -123,7 +123,7 @@ void MetaOperator::FastApplyTask() {
     auto task =
         std::bind(&MetaOperator::OnApply, this, node_->GetAppliedIndex(),
                   new MetaOperatorClosure(this), TimeUtility::GetTimeofDayUs());
-    node_->GetApplyQueue()->Push(HashCode(), GetOperatorType(),
+    node_->GetApplyQueue()->Push(HashCode(), ConflictKey(), GetOperatorType(),
                                  std::move(task));
     timer.stop();
     g_concurrent_fast_apply_wait_latency << timer.u_elapsed();
@@ -156,7 +156,6 @@ OPERATOR_CAN_BY_PASS_PROPOSE(GetVolumeExtent);
         uint64_t executeTime = TimeUtility::GetTimeofDayUs() - timeUs;       \
         node_->GetMetric()->ExecuteLatency(OperatorType::TYPE, executeTime); \
         if (status == MetaStatusCode::OK) {                                  \
-            node_->UpdateAppliedIndex(index);                                \
             static_cast<TYPE##Response*>(response_)->set_appliedindex(       \
                 std::max<uint64_t>(index, node_->GetAppliedIndex()));        \
             node_->GetMetric()->OnOperatorComplete(                          \
@@ -178,12 +177,14 @@ OPERATOR_ON_APPLY(BatchGetInodeAttr);
 OPERATOR_ON_APPLY(BatchGetXAttr);
 OPERATOR_ON_APPLY(CreateInode);
 OPERATOR_ON_APPLY(UpdateInode);
+OPERATOR_ON_APPLY(BatchUpdateInode);
 OPERATOR_ON_APPLY(DeleteInode);
 OPERATOR_ON_APPLY(CreateRootInode);
 OPERATOR_ON_APPLY(CreateManageInode);
 OPERATOR_ON_APPLY(CreatePartition);
 OPERATOR_ON_APPLY(DeletePartition);
 OPERATOR_ON_APPLY(PrepareRenameTx);
+OPERATOR_ON_APPLY(RenameDentry);
 OPERATOR_ON_APPLY(UpdateVolumeExtent);
 OPERATOR_ON_APPLY(UpdateDeallocatableBlockGroup);
 
@@ -209,7 +210,6 @@ void GetOrModifyS3ChunkInfoOperator::OnApply(int64_t index,
         rc = metastore->GetOrModifyS3ChunkInfo(request, response, &iterator,
                                                index);
         if (rc == MetaStatusCode::OK) {
-            node_->UpdateAppliedIndex(index);
             response->set_appliedindex(
                 std::max<uint64_t>(index, node_->GetAppliedIndex()));
             node_->GetMetric()->OnOperatorComplete(
@@ -293,9 +293,14 @@ void GetVolumeExtentOperator::OnApply(int64_t index,
 #define OPERATOR_ON_APPLY_FROM_LOG(TYPE)                                       \
     void TYPE##Operator::OnApplyFromLog(int64_t index, uint64_t startTimeUs) { \
         std::unique_ptr<TYPE##Operator> selfGuard(this);                       \
+        uint64_t timeUs = TimeUtility::GetTimeofDayUs();                       \
+        node_->GetMetric()->WaitInQueueLatencyFromLog(OperatorType::TYPE,      \
+                                                      timeUs - startTimeUs);   \
         TYPE##Response response;                                               \
         auto status = node_->GetMetaStore()->TYPE(                             \
             static_cast<const TYPE##Request*>(request_), &response, index);    \
+        node_->GetMetric()->ExecuteLatencyFromLog(                             \
+            OperatorType::TYPE, TimeUtility::GetTimeofDayUs() - timeUs);       \
         node_->GetMetric()->OnOperatorCompleteFromLog(                         \
             OperatorType::TYPE, TimeUtility::GetTimeofDayUs() - startTimeUs,   \
             status == MetaStatusCode::OK);                                     \
@@ -305,12 +310,14 @@ OPERATOR_ON_APPLY_FROM_LOG(CreateDentry);
 OPERATOR_ON_APPLY_FROM_LOG(DeleteDentry);
 OPERATOR_ON_APPLY_FROM_LOG(CreateInode);
 OPERATOR_ON_APPLY_FROM_LOG(UpdateInode);
+OPERATOR_ON_APPLY_FROM_LOG(BatchUpdateInode);
 OPERATOR_ON_APPLY_FROM_LOG(DeleteInode);
 OPERATOR_ON_APPLY_FROM_LOG(CreateRootInode);
 OPERATOR_ON_APPLY_FROM_LOG(CreateManageInode);
 OPERATOR_ON_APPLY_FROM_LOG(CreatePartition);
 OPERATOR_ON_APPLY_FROM_LOG(DeletePartition);
 OPERATOR_ON_APPLY_FROM_LOG(PrepareRenameTx);
+OPERATOR_ON_APPLY_FROM_LOG(RenameDentry);
 OPERATOR_ON_APPLY_FROM_LOG(UpdateVolumeExtent);
 OPERATOR_ON_APPLY_FROM_LOG(UpdateDeallocatableBlockGroup);
 
@@ -364,6 +371,7 @@ OPERATOR_REDIRECT(BatchGetInodeAttr);
 OPERATOR_REDIRECT(BatchGetXAttr);
 OPERATOR_REDIRECT(CreateInode);
 OPERATOR_REDIRECT(UpdateInode);
+OPERATOR_REDIRECT(BatchUpdateInode);
 OPERATOR_REDIRECT(GetOrModifyS3ChunkInfo);
 OPERATOR_REDIRECT(DeleteInode);
 OPERATOR_REDIRECT(CreateRootInode);
@@ -371,6 +379,7 @@ OPERATOR_REDIRECT(CreateManageInode);
 OPERATOR_REDIRECT(CreatePartition);
 OPERATOR_REDIRECT(DeletePartition);
 OPERATOR_REDIRECT(PrepareRenameTx);
+OPERATOR_REDIRECT(RenameDentry);
 OPERATOR_REDIRECT(GetVolumeExtent);
 OPERATOR_REDIRECT(UpdateVolumeExtent);
 OPERATOR_REDIRECT(UpdateDeallocatableBlockGroup);
@@ -391,6 +400,7 @@ OPERATOR_ON_FAILED(BatchGetInodeAttr);
 OPERATOR_ON_FAILED(BatchGetXAttr);
 OPERATOR_ON_FAILED(CreateInode);
 OPERATOR_ON_FAILED(UpdateInode);
+OPERATOR_ON_FAILED(BatchUpdateInode);
 OPERATOR_ON_FAILED(GetOrModifyS3ChunkInfo);
 OPERATOR_ON_FAILED(DeleteInode);
 OPERATOR_ON_FAILED(CreateRootInode);
@@ -398,6 +408,7 @@ OPERATOR_ON_FAILED(CreateManageInode);
 OPERATOR_ON_FAILED(CreatePartition);
 OPERATOR_ON_FAILED(DeletePartition);
 OPERATOR_ON_FAILED(PrepareRenameTx);
+OPERATOR_ON_FAILED(RenameDentry);
 OPERATOR_ON_FAILED(GetVolumeExtent);
 OPERATOR_ON_FAILED(UpdateVolumeExtent);
 OPERATOR_ON_FAILED(UpdateDeallocatableBlockGroup);
@@ -418,11 +429,13 @@ OPERATOR_HASH_CODE(BatchGetInodeAttr);
 OPERATOR_HASH_CODE(BatchGetXAttr);
 OPERATOR_HASH_CODE(CreateInode);
 OPERATOR_HASH_CODE(UpdateInode);
+OPERATOR_HASH_CODE(BatchUpdateInode);
 OPERATOR_HASH_CODE(GetOrModifyS3ChunkInfo);
 OPERATOR_HASH_CODE(DeleteInode);
 OPERATOR_HASH_CODE(CreateRootInode);
 OPERATOR_HASH_CODE(CreateManageInode);
 OPERATOR_HASH_CODE(PrepareRenameTx);
+OPERATOR_HASH_CODE(RenameDentry);
 OPERATOR_HASH_CODE(DeletePartition);
 OPERATOR_HASH_CODE(GetVolumeExtent);
 OPERATOR_HASH_CODE(UpdateVolumeExtent);
@@ -442,6 +455,24 @@ PARTITION_OPERATOR_HASH_CODE(CreatePartition);
 
 #undef PARTITION_OPERATOR_HASH_CODE
 
+#define OPERATOR_CONFLICT_KEY(TYPE, FIELD)                                     \
+    uint64_t TYPE##Operator::ConflictKey() const {                             \
+        return static_cast<const TYPE##Request *>(request_)->FIELD;            \
+    }
+
+OPERATOR_CONFLICT_KEY(GetDentry, parentinodeid());
+OPERATOR_CONFLICT_KEY(ListDentry, dirinodeid());
+OPERATOR_CONFLICT_KEY(CreateDentry, dentry().parentinodeid());
+OPERATOR_CONFLICT_KEY(DeleteDentry, parentinodeid());
+OPERATOR_CONFLICT_KEY(GetInode, inodeid());
+OPERATOR_CONFLICT_KEY(UpdateInode, inodeid());
+OPERATOR_CONFLICT_KEY(GetOrModifyS3ChunkInfo, inodeid());
+OPERATOR_CONFLICT_KEY(DeleteInode, inodeid());
+OPERATOR_CONFLICT_KEY(GetVolumeExtent, inodeid());
+OPERATOR_CONFLICT_KEY(UpdateVolumeExtent, inodeid());
+
+#undef OPERATOR_CONFLICT_KEY
+
 #define OPERATOR_TYPE(TYPE)                                                    \
     OperatorType TYPE##Operator::GetOperatorType() const {                     \
         return OperatorType::TYPE;                                             \
@@ -456,11 +487,13 @@ OPERATOR_TYPE(BatchGetInodeAttr);
 OPERATOR_TYPE(BatchGetXAttr);
 OPERATOR_TYPE(CreateInode);
 OPERATOR_TYPE(UpdateInode);
+OPERATOR_TYPE(BatchUpdateInode);
 OPERATOR_TYPE(GetOrModifyS3ChunkInfo);
 OPERATOR_TYPE(DeleteInode);
 OPERATOR_TYPE(CreateRootInode);
 OPERATOR_TYPE(CreateManageInode);
 OPERATOR_TYPE(PrepareRenameTx);
+OPERATOR_TYPE(RenameDentry);
 OPERATOR_TYPE(CreatePartition);
 OPERATOR_TYPE(DeletePartition);
 OPERATOR_TYPE(GetVolumeExtent);
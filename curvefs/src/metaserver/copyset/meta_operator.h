@@ -81,26 +81,20 @@ class MetaOperator {
     virtual void OnApplyFromLog(int64_t index, uint64_t startTimeUs) = 0;
 
     // Get hash code of current operator which is used to push current operator
-    // task to apply queue, and apply queue will guarantee that operators with
-    // the same hash code are executed serially.
-    // Current, all operators' hash code is request's PARTITION-ID
-    // TODO(wuhanqing): Finer grained hash code
-    // e.g.,
-    // For dentry-related operator hash code is `parent-inode-id`
-    // For inode-related operator hash code is `inode-id`
-    // For partition-related operator hash code is `partition-id`
-    // but above hash policy has BUG
-    // scenario:
-    // two operators: create partition and create inode in this partition
-    // if leader crashed after second operator is executed, the new elected
-    // leader must apply those two operators, BUT those two operators are hashed
-    // by different ID, so they can be executed in parallel, and this can lead
-    // to create inode operator is executed prior to create partition operator
-    // Possible solution:
-    // 1. create a partition if crate inode found partition not exist
-    // 2. create inode wait partition create when found partition not exist
+    // task to apply queue.
+    // Current, all operators' hash code is request's PARTITION-ID.
     virtual uint64_t HashCode() const = 0;
 
+    // Get the inode which current operator touches in its partition,
+    // for dentry-related operator it's `parent-inode-id`, and for
+    // inode-related operator it's `inode-id`, 0 means the whole partition.
+    // Operators of different keys are executed in parallel, and an operator
+    // is executed after the pending writes it conflicts with, so writes of
+    // one key are executed in log order. Operator which allocates ids or
+    // touches more than one inode must return 0, it's ordered with all
+    // writes of the partition.
+    virtual uint64_t ConflictKey() const { return 0; }
+
     virtual OperatorType GetOperatorType() const = 0;
 
  private:
@@ -167,6 +161,8 @@ class GetDentryOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -188,6 +184,8 @@ class ListDentryOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -209,6 +207,8 @@ class CreateDentryOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -228,6 +228,8 @@ class DeleteDentryOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -247,6 +249,8 @@ class GetInodeOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -319,6 +323,27 @@ class CreateInodeOperator : public MetaOperator {
 };
 
 class UpdateInodeOperator : public MetaOperator {
+ public:
+    using MetaOperator::MetaOperator;
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(int64_t index, uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    uint64_t ConflictKey() const override;
+
+    OperatorType GetOperatorType() const override;
+
+ private:
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+};
+
+class BatchUpdateInodeOperator : public MetaOperator {
  public:
     using MetaOperator::MetaOperator;
 
@@ -348,6 +373,8 @@ class GetOrModifyS3ChunkInfoOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -367,6 +394,8 @@ class DeleteInodeOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -489,6 +518,27 @@ class PrepareRenameTxOperator : public MetaOperator {
     void OnFailed(MetaStatusCode code) override;
 };
 
+// NOTE: it may touch two partitions, so it's applied as a barrier
+// of the apply queue, see `ApplyQueue::Push()`
+class RenameDentryOperator : public MetaOperator {
+ public:
+    using MetaOperator::MetaOperator;
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(int64_t index, uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    OperatorType GetOperatorType() const override;
+
+ private:
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+};
+
 class GetVolumeExtentOperator : public MetaOperator {
  public:
     using MetaOperator::MetaOperator;
@@ -500,6 +550,8 @@ class GetVolumeExtentOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -521,6 +573,8 @@ class UpdateVolumeExtentOperator : public MetaOperator {
 
     uint64_t HashCode() const override;
 
+    uint64_t ConflictKey() const override;
+
     OperatorType GetOperatorType() const override;
 
  private:
@@ -82,6 +82,29 @@ void OperatorMetric::ExecuteLatency(OperatorType type,
     }
 }
 
+void OperatorMetric::WaitInQueueLatencyFromLog(OperatorType type,
+                                               uint64_t latencyUs) {
+    auto index = static_cast<uint32_t>(type);
+    if (index < kTotalOperatorNum) {
+        opMetricsFromLog_[index]->waitInQueueLatency << latencyUs;
+    }
+}
+
+void OperatorMetric::ExecuteLatencyFromLog(OperatorType type,
+                                           uint64_t latencyUs) {
+    auto index = static_cast<uint32_t>(type);
+    if (index < kTotalOperatorNum) {
+        opMetricsFromLog_[index]->executeLatency << latencyUs;
+    }
+}
+
+void OperatorMetric::ProposeLatency(OperatorType type, uint64_t latencyUs) {
+    auto index = static_cast<uint32_t>(type);
+    if (index < kTotalOperatorNum) {
+        opMetrics_[index]->proposeLatency << latencyUs;
+    }
+}
+
 void OperatorMetric::NewArrival(OperatorType type) {
     auto index = static_cast<uint32_t>(type);
     if (index < kTotalOperatorNum) {
@@ -54,6 +54,12 @@ class OperatorMetric {
 
     void ExecuteLatency(OperatorType type, uint64_t latencyUs);
 
+    void WaitInQueueLatencyFromLog(OperatorType type, uint64_t latencyUs);
+
+    void ExecuteLatencyFromLog(OperatorType type, uint64_t latencyUs);
+
+    void ProposeLatency(OperatorType type, uint64_t latencyUs);
+
     void NewArrival(OperatorType type);
 
     OperatorMetric(const OperatorMetric&) = delete;
@@ -68,7 +74,8 @@ class OperatorMetric {
               rcount(prefix, "_rcount"),
               rps(prefix, "_rps", &rcount, 1),
               executeLatency(prefix, "_execute_latency"),
-              waitInQueueLatency(prefix, "_wait_in_queue_latency") {}
+              waitInQueueLatency(prefix, "_wait_in_queue_latency"),
+              proposeLatency(prefix, "_propose_latency") {}
 
         // latency recorder support latency/qps/count
         bvar::LatencyRecorder latRecorder;
@@ -88,6 +95,9 @@ class OperatorMetric {
 
         // latency of request wait in queue
         bvar::LatencyRecorder waitInQueueLatency;
+
+        // latency from propose to apply, including raft replication
+        bvar::LatencyRecorder proposeLatency;
     };
 
  private:
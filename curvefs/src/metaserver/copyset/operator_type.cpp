@@ -68,6 +68,10 @@ const char* OperatorTypeName(OperatorType type) {
             return "UpdateVolumeExtent";
         case OperatorType::UpdateDeallocatableBlockGroup:
             return "UpdateDeallocatableBlockGroup";
+        case OperatorType::BatchUpdateInode:
+            return "BatchUpdateInode";
+        case OperatorType::RenameDentry:
+            return "RenameDentry";
         // Add new case before `OperatorType::OperatorTypeMax`
         case OperatorType::OperatorTypeMax:
             break;
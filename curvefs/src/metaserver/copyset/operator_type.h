@@ -53,6 +53,8 @@ enum class OperatorType : uint32_t {
     UpdateVolumeExtent = 16,
     CreateManageInode = 17,
     UpdateDeallocatableBlockGroup = 18,
+    BatchUpdateInode = 19,
+    RenameDentry = 20,
 
     // NOTE:
     //   Add new operator before `OperatorTypeMax`
@@ -169,6 +169,12 @@ std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
             return ParseFromRaftLog<UpdateDeallocatableBlockGroupOperator,
                                     UpdateDeallocatableBlockGroupRequest>(
                 node, type, meta);
+        case OperatorType::BatchUpdateInode:
+            return ParseFromRaftLog<BatchUpdateInodeOperator,
+                                    BatchUpdateInodeRequest>(node, type, meta);
+        case OperatorType::RenameDentry:
+            return ParseFromRaftLog<RenameDentryOperator,
+                                    RenameDentryRequest>(node, type, meta);
         // Add new case before `OperatorType::OperatorTypeMax`
         case OperatorType::OperatorTypeMax:
             break;
@@ -134,5 +134,18 @@ MetaStatusCode DentryManager::HandleRenameTx(const std::vector<Dentry>& dentrys,
     return rc;
 }
 
+MetaStatusCode DentryManager::RenameDentry(const Dentry& srcDentry,
+                                           DentryManager* dstManager,
+                                           const Dentry& dstDentry,
+                                           int64_t logIndex) {
+    CHECK_APPLIED();
+    Log4Dentry("RenameDentry", srcDentry);
+    Log4Dentry("RenameDentry", dstDentry);
+    MetaStatusCode rc = dentryStorage_->Rename(
+        srcDentry, dstManager->dentryStorage_.get(), dstDentry, logIndex);
+    Log4Code("RenameDentry", rc);
+    return rc;
+}
+
 }  // namespace metaserver
 }  // namespace curvefs
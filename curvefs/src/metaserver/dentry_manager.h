@@ -61,6 +61,10 @@ class DentryManager {
     MetaStatusCode HandleRenameTx(const std::vector<Dentry>& dentrys,
                                   int64_t logIndex);
 
+    MetaStatusCode RenameDentry(const Dentry& srcDentry,
+                                DentryManager* dstManager,
+                                const Dentry& dstDentry, int64_t logIndex);
+
  private:
     void Log4Dentry(const std::string& request, const Dentry& dentry);
     void Log4Code(const std::string& request, MetaStatusCode rc);
@@ -27,21 +27,24 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "curvefs/src/metaserver/storage/key_migration.h"
 #include "curvefs/src/metaserver/storage/status.h"
 #include "curvefs/src/metaserver/storage/storage.h"
+#include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/src/metaserver/transaction.h"
 #include "src/common/string_util.h"
 
 namespace curvefs {
 namespace metaserver {
 
-using ::curve::common::ReadLockGuard;
+using ::curve::common::LockGuard;
 using ::curve::common::StringStartWith;
-using ::curve::common::WriteLockGuard;
 using ::curvefs::metaserver::storage::Key4Dentry;
+using ::curvefs::metaserver::storage::LockStripes;
 using ::curvefs::metaserver::storage::Prefix4AllDentry;
 using ::curvefs::metaserver::storage::Prefix4SameParentDentry;
 using ::curvefs::metaserver::storage::Status;
@@ -162,18 +165,81 @@ const char* DentryStorage::kHandleTxKey("handleTx");
 const char* DentryStorage::kPendingTxKey("pendingTx");
 
 bool DentryStorage::Init() {
-    auto s = GetDentryCount(&nDentry_);
-    if (s.ok() || s.IsNotFound()) {
+    if (!MigrateKeyFormat()) {
+        return false;
+    }
+    uint64_t count = 0;
+    auto s = GetDentryCount(&count);
+    if (s.IsNotFound()) {
+        s = RecoverDentryCount(&count);
+    }
+    if (s.ok()) {
+        nDentry_ = count;
         s = GetHandleTxIndex(&handleTxIndex_);
         return s.ok() || s.IsNotFound();
     }
+    LOG(ERROR) << "Get dentry count failed, status = " << s.ToString();
     return false;
 }
 
+// NOTE: the dentry count isn't persisted by older versions, we count
+// the dentry table only once and persist it, it's maintained with the
+// dentry table in the same transaction since then
+Status DentryStorage::RecoverDentryCount(uint64_t* count) {
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, true);
+    auto iterator = kvStorage_->SGetAll(table4Dentry_);
+    if (iterator->Status() != 0) {
+        return Status::InternalError();
+    }
+    *count = 0;
+    DentryVec vec;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        if (!iterator->ParseFromValue(&vec)) {
+            return Status::ParsedFailed();
+        }
+        *count += vec.dentrys_size();
+    }
+
+    auto txn = kvStorage_->BeginTransaction();
+    if (txn == nullptr) {
+        return Status::InternalError();
+    }
+    Status s = SetDentryCount(txn.get(), *count);
+    s = s.ok() ? txn->Commit() : s;
+    if (!s.ok()) {
+        if (!txn->Rollback().ok()) {
+            LOG(ERROR) << "Rollback transaction failed";
+        }
+        return s;
+    }
+    LOG(INFO) << "Recover dentry count success, count = " << *count;
+    return s;
+}
+
+bool DentryStorage::MigrateKeyFormat() {
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, true);
+    uint64_t migrated = 0;
+    auto s = storage::MigrateKeyFormat<Key4Dentry, DentryVec>(
+        kvStorage_.get(), table4Dentry_, true, &migrated);
+    if (!s.ok()) {
+        LOG(ERROR) << "Migrate dentry key format failed, status = "
+                   << s.ToString();
+        return false;
+    }
+    LOG_IF(INFO, migrated > 0)
+        << "Migrate dentry key format success, dentrys = " << migrated;
+    return true;
+}
+
 DentryStorage::DentryStorage(std::shared_ptr<KVStorage> kvStorage,
                              std::shared_ptr<NameGenerator> nameGenerator,
                              uint64_t nDentry)
-    : kvStorage_(kvStorage),
+    : stripedLock_(LockStripes(kvStorage.get())),
+      snapshotIterator_(kvStorage->Type() ==
+                        KVStorage::STORAGE_TYPE::ROCKSDB_STORAGE),
+      kvStorage_(kvStorage),
       table4Dentry_(nameGenerator->GetDentryTableName()),
       table4AppliedIndex_(nameGenerator->GetAppliedIndexTableName()),
       table4Transaction_(nameGenerator->GetTransactionTableName()),
@@ -187,6 +253,16 @@ DentryStorage::DentryStorage(std::shared_ptr<KVStorage> kvStorage,
     // if we got it, replace old value
 }
 
+std::vector<uint64_t> DentryStorage::ParentsOf(
+    const std::vector<Dentry>& dentrys) {
+    std::vector<uint64_t> parents;
+    parents.reserve(dentrys.size());
+    for (const auto& dentry : dentrys) {
+        parents.push_back(dentry.parentinodeid());
+    }
+    return parents;
+}
+
 std::string DentryStorage::DentryKey(const Dentry& dentry) {
     Key4Dentry key(dentry.fsid(), dentry.parentinodeid(), dentry.name());
     return conv_.SerializeToString(key);
@@ -407,7 +483,8 @@ storage::Status DentryStorage::GetHandleTxIndex(int64_t* index) {
 }
 
 MetaStatusCode DentryStorage::Insert(const Dentry& dentry, int64_t logIndex) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, dentry.parentinodeid(), true);
 
     Dentry out;
     DentryVec vec;
@@ -479,7 +556,8 @@ MetaStatusCode DentryStorage::Insert(const Dentry& dentry, int64_t logIndex) {
 
 MetaStatusCode DentryStorage::Insert(const DentryVec& vec, bool merge,
                                      int64_t logIndex) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, vec.dentrys(0).parentinodeid(), true);
 
     Status s;
     DentryVec oldVec;
@@ -536,7 +614,8 @@ MetaStatusCode DentryStorage::Insert(const DentryVec& vec, bool merge,
 }
 
 MetaStatusCode DentryStorage::Delete(const Dentry& dentry, int64_t logIndex) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, dentry.parentinodeid(), true);
 
     Dentry out;
     DentryVec vec;
@@ -606,8 +685,159 @@ MetaStatusCode DentryStorage::Delete(const Dentry& dentry, int64_t logIndex) {
     return MetaStatusCode::STORAGE_INTERNAL_ERROR;
 }
 
+MetaStatusCode DentryStorage::Rename(const Dentry& srcDentry,
+                                     DentryStorage* dstStorage,
+                                     const Dentry& dstDentry,
+                                     int64_t logIndex) {
+    const bool sameStorage = (dstStorage == this);
+    // NOTE: lock the storages in address order to avoid deadlock
+    DentryStorage* first = std::min(this, dstStorage);
+    DentryStorage* second = std::max(this, dstStorage);
+    LockGuard lg(first->writeLock_);
+    std::unique_lock<Mutex> dlg(second->writeLock_, std::defer_lock);
+    if (!sameStorage) {
+        dlg.lock();
+    }
+    std::vector<uint64_t> parents{srcDentry.parentinodeid()};
+    if (sameStorage) {
+        parents.push_back(dstDentry.parentinodeid());
+    }
+    StripedLockGuard slg(&stripedLock_, parents, true);
+    std::unique_ptr<StripedLockGuard> dslg;
+    if (!sameStorage) {
+        dslg.reset(new StripedLockGuard(&dstStorage->stripedLock_,
+                                        dstDentry.parentinodeid(), true));
+    }
+
+    Dentry out;
+    Dentry old;
+    DentryVec srcVec;
+    DentryVec dstVec;
+    uint64_t srcCount = nDentry_;
+    uint64_t dstCount = dstStorage->nDentry_;
+    uint64_t* dstCountPtr = sameStorage ? &srcCount : &dstCount;
+    std::string srcKey = DentryKey(srcDentry);
+    std::string dstKey = dstStorage->DentryKey(dstDentry);
+    std::shared_ptr<storage::StorageTransaction> txn;
+    storage::Status s;
+    const char* step = "Begin transaction";
+    do {
+        txn = kvStorage_->BeginTransaction();
+        if (txn == nullptr) {
+            break;
+        }
+        s = SetAppliedIndex(txn.get(), logIndex);
+        if (s.ok() && !sameStorage) {
+            s = dstStorage->SetAppliedIndex(txn.get(), logIndex);
+        }
+        if (!s.ok()) {
+            step = "Insert applied index to transaction";
+            break;
+        }
+
+        // rename to itself, nothing changed except the applied index
+        if (sameStorage && srcKey == dstKey) {
+            MetaStatusCode rc = Find(txn.get(), srcDentry, &out, &srcVec,
+                                     &srcCount);
+            if (rc != MetaStatusCode::OK && rc != MetaStatusCode::NOT_FOUND) {
+                step = "Find source dentry";
+                break;
+            }
+            s = txn->Commit();
+            if (!s.ok()) {
+                step = "Commit transaction";
+                break;
+            }
+            nDentry_ = srcCount;
+            return rc;
+        }
+
+        // 1. remove the source dentry
+        MetaStatusCode rc = Find(txn.get(), srcDentry, &out, &srcVec,
+                                 &srcCount);
+        if (rc == MetaStatusCode::NOT_FOUND) {
+            // the rename may be already applied, e.g. retried by client
+            rc = dstStorage->Find(txn.get(), dstDentry, &old, &dstVec,
+                                  dstCountPtr);
+            if (rc != MetaStatusCode::OK && rc != MetaStatusCode::NOT_FOUND) {
+                step = "Find destination dentry";
+                break;
+            }
+            bool applied = (rc == MetaStatusCode::OK &&
+                            old.inodeid() == srcDentry.inodeid());
+            // NOTE: we should commit transaction because `Find()` may
+            // compress dentrys and write dentry count
+            s = txn->Commit();
+            if (!s.ok()) {
+                step = "Commit transaction";
+                break;
+            }
+            nDentry_ = srcCount;
+            dstStorage->nDentry_ = *dstCountPtr;
+            return applied ? MetaStatusCode::IDEMPOTENCE_OK
+                           : MetaStatusCode::NOT_FOUND;
+        } else if (rc != MetaStatusCode::OK) {
+            step = "Find source dentry";
+            break;
+        }
+        DentryVector srcVector(&srcVec);
+        srcVector.Delete(out);
+        if (srcVec.dentrys_size() == 0) {
+            s = txn->SDel(table4Dentry_, srcKey);
+        } else {
+            s = txn->SSet(table4Dentry_, srcKey, srcVec);
+        }
+        if (!s.ok()) {
+            step = "Delete source dentry from transaction";
+            break;
+        }
+        srcVector.Confirm(&srcCount);
+
+        // 2. overwrite the destination dentry
+        rc = dstStorage->Find(txn.get(), dstDentry, &old, &dstVec,
+                              dstCountPtr);
+        if (rc != MetaStatusCode::OK && rc != MetaStatusCode::NOT_FOUND) {
+            step = "Find destination dentry";
+            break;
+        }
+        DentryVector dstVector(&dstVec);
+        if (rc == MetaStatusCode::OK) {
+            dstVector.Delete(old);
+        }
+        dstVector.Insert(dstDentry);
+        s = txn->SSet(dstStorage->table4Dentry_, dstKey, dstVec);
+        if (!s.ok()) {
+            step = "Insert destination dentry to transaction";
+            break;
+        }
+        dstVector.Confirm(dstCountPtr);
+
+        s = SetDentryCount(txn.get(), srcCount);
+        if (s.ok() && !sameStorage) {
+            s = dstStorage->SetDentryCount(txn.get(), dstCount);
+        }
+        if (!s.ok()) {
+            step = "Insert dentry count to transaction";
+            break;
+        }
+        s = txn->Commit();
+        if (!s.ok()) {
+            step = "Rename dentry";
+            break;
+        }
+        nDentry_ = srcCount;
+        dstStorage->nDentry_ = *dstCountPtr;
+        return MetaStatusCode::OK;
+    } while (false);
+    LOG(ERROR) << step << " failed, status = " << s.ToString();
+    if (txn != nullptr && !txn->Rollback().ok()) {
+        LOG(ERROR) << "Rollback transaction failed";
+    }
+    return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+}
+
 MetaStatusCode DentryStorage::Get(Dentry* dentry) {
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, dentry->parentinodeid(), false);
 
     Dentry out;
     DentryVec vec;
@@ -627,7 +857,7 @@ MetaStatusCode DentryStorage::List(const Dentry& dentry,
                                    std::vector<Dentry>* dentrys, uint32_t limit,
                                    bool onlyDir) {
     // TODO(all): consider store dir dentry and file dentry separately
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, dentry.parentinodeid(), false);
 
     // 1. precheck for dentry vector
     // NOTE: we should gurantee the vector is empty
@@ -651,6 +881,11 @@ MetaStatusCode DentryStorage::List(const Dentry& dentry,
     if (iterator->Status() < 0) {
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
+    // NOTE: the iterator which reads from a snapshot sees a consistent
+    // view of the directory, so we needn't block writers during the scan
+    if (snapshotIterator_) {
+        slg.Unlock();
+    }
 
     DentryVec current;
     DentryList list(dentrys, limit, name, dentry.txid(), onlyDir);
@@ -685,7 +920,8 @@ MetaStatusCode DentryStorage::List(const Dentry& dentry,
 MetaStatusCode DentryStorage::PrepareTx(
     const std::vector<Dentry>& dentrys,
     const metaserver::TransactionRequest& txRequest, int64_t logIndex) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, ParentsOf(dentrys), true);
     uint64_t count = nDentry_;
     Status s;
     const char* step = "Begin transaction";
@@ -758,7 +994,8 @@ MetaStatusCode DentryStorage::CommitTx(const std::vector<Dentry>& dentrys,
                   << " handle tx index = " << handleTxIndex_;
         return MetaStatusCode::IDEMPOTENCE_OK;
     }
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, ParentsOf(dentrys), true);
     Status s;
     const char* step = "Begin transaction";
     std::shared_ptr<storage::StorageTransaction> txn;
@@ -823,7 +1060,8 @@ MetaStatusCode DentryStorage::RollbackTx(const std::vector<Dentry>& dentrys,
                   << " handle tx index = " << handleTxIndex_;
         return MetaStatusCode::IDEMPOTENCE_OK;
     }
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, ParentsOf(dentrys), true);
     Status s;
     const char* step = "Begin transaction";
     std::shared_ptr<storage::StorageTransaction> txn;
@@ -892,17 +1130,22 @@ MetaStatusCode DentryStorage::RollbackTx(const std::vector<Dentry>& dentrys,
 }
 
 std::shared_ptr<Iterator> DentryStorage::GetAll() {
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, false);
     return kvStorage_->SGetAll(table4Dentry_);
 }
 
 size_t DentryStorage::Size() {
-    ReadLockGuard lg(rwLock_);
     return nDentry_;
 }
 
 bool DentryStorage::Empty() {
-    ReadLockGuard lg(rwLock_);
+    // NOTE: the dentry count is maintained with the dentry table, so we
+    // needn't seek the table unless it says the table is empty
+    if (nDentry_ > 0) {
+        return false;
+    }
+
+    StripedLockGuard slg(&stripedLock_, false);
 
     std::string sprefix = conv_.SerializeToString(Prefix4AllDentry());
     auto iterator = kvStorage_->SSeek(table4Dentry_, sprefix);
@@ -926,7 +1169,8 @@ MetaStatusCode DentryStorage::Clear() {
     // NOTE: clear operations non-atomic is acceptable
     // because if we fail stop, we will replay
     // raft logs and clear it again
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, true);
     Status s = kvStorage_->SClear(table4Dentry_);
     if (!s.ok()) {
         LOG(ERROR) << "Clear dentry table failed, status = " << s.ToString();
@@ -23,6 +23,7 @@
 #ifndef CURVEFS_SRC_METASERVER_DENTRY_STORAGE_H_
 #define CURVEFS_SRC_METASERVER_DENTRY_STORAGE_H_
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <memory>
@@ -31,14 +32,17 @@
 
 #include "absl/container/btree_set.h"
 #include "curvefs/proto/metaserver.pb.h"
+#include "curvefs/src/metaserver/common/striped_lock.h"
 #include "curvefs/src/metaserver/storage/converter.h"
 #include "curvefs/src/metaserver/storage/status.h"
 #include "curvefs/src/metaserver/storage/storage.h"
+#include "src/common/concurrent/concurrent.h"
 #include "src/common/concurrent/rw_lock.h"
 
 namespace curvefs {
 namespace metaserver {
 
+using ::curve::common::Mutex;
 using ::curve::common::RWLock;
 using ::curvefs::metaserver::storage::Converter;
 using ::curvefs::metaserver::storage::Iterator;
@@ -111,6 +115,12 @@ class DentryStorage {
 
     MetaStatusCode Delete(const Dentry& dentry, int64_t logIndex);
 
+    // move |srcDentry| to |dstDentry| of |dstStorage| in one transaction,
+    // the existing |dstDentry| will be overwritten, |dstStorage| may be
+    // this storage or another one which shares the same kv storage.
+    MetaStatusCode Rename(const Dentry& srcDentry, DentryStorage* dstStorage,
+                          const Dentry& dstDentry, int64_t logIndex);
+
     MetaStatusCode Get(Dentry* dentry);
 
     MetaStatusCode List(const Dentry& dentry, std::vector<Dentry>* dentrys,
@@ -174,17 +184,33 @@ class DentryStorage {
 
     storage::Status GetDentryCount(uint64_t* count);
 
+    storage::Status RecoverDentryCount(uint64_t* count);
+
     storage::Status GetHandleTxIndex(int64_t* count);
 
+    // rewrite dentry keys which aren't in current key format
+    bool MigrateKeyFormat();
+
+    static std::vector<uint64_t> ParentsOf(const std::vector<Dentry>& dentrys);
+
  private:
-    RWLock rwLock_;
+    // NOTE: all mutations share the dentry count and applied index,
+    // so they are serialized by `writeLock_`, readers never take it.
+    // So creates of different directories are only serialized during
+    // the transaction here, although they are applied in parallel.
+    // dentrys of the same parent are protected by the striped lock
+    // between readers and writers.
+    Mutex writeLock_;
+    StripedRWLock stripedLock_;
+    // whether the iterator of storage reads from a snapshot
+    bool snapshotIterator_;
     std::shared_ptr<KVStorage> kvStorage_;
     std::string table4Dentry_;
     std::string table4AppliedIndex_;
     std::string table4Transaction_;
     std::string table4DentryCount_;
     int64_t handleTxIndex_;
-    uint64_t nDentry_;
+    std::atomic<uint64_t> nDentry_;
     Converter conv_;
 
     static const char* kDentryCountKey;
@@ -27,9 +27,13 @@
 
 #include <ctime>
 #include <list>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/filesystem/xattr.h"
@@ -331,13 +335,124 @@ MetaStatusCode InodeManager::UpdateInode(const UpdateInodeRequest& request,
         return ret;
     }
 
-    bool needUpdate = false;
     bool needAddTrash = false;
+    std::shared_ptr<storage::StorageTransaction> txn;
+    ret = UpdateInodeInTransaction(&txn, request, &old, &needAddTrash,
+                                   logIndex);
+    if (ret != MetaStatusCode::OK) {
+        if (txn != nullptr && !txn->Rollback().ok()) {
+            LOG(ERROR) << "Rollback transaction failed";
+        }
+        return ret;
+    }
+
+    if (txn != nullptr) {
+        auto s = txn->Commit();
+        if (!s.ok()) {
+            LOG(ERROR) << "Commit transaction failed, status = "
+                       << s.ToString();
+            if (!txn->Rollback().ok()) {
+                LOG(ERROR) << "Rollback transaction failed";
+            }
+            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        }
+    }
+
+    if (needAddTrash) {
+        trash_->Add(old.inodeid(), old.dtime());
+        --(*type2InodeNum_)[old.type()];
+    }
+    VLOG(9) << "UpdateInode success, " << request.ShortDebugString();
+    return MetaStatusCode::OK;
+}
 
-#define UPDATE_INODE(param)               \
-    if (request.has_##param()) {          \
-        old.set_##param(request.param()); \
-        needUpdate = true;                \
+MetaStatusCode InodeManager::BatchUpdateInode(
+    const std::vector<const UpdateInodeRequest*>& requests,
+    std::vector<MetaStatusCode>* statuses, int64_t logIndex) {
+    CHECK_APPLIED();
+    VLOG(9) << "batch update inode, size: " << requests.size();
+
+    // lock in order, so that two batches never wait for each other
+    std::set<std::string> lockNames;
+    for (const auto* request : requests) {
+        lockNames.insert(
+            GetInodeLockName(request->fsid(), request->inodeid()));
+    }
+    std::vector<std::unique_ptr<NameLockGuard>> guards;
+    for (const auto& name : lockNames) {
+        guards.emplace_back(new NameLockGuard(inodeLock_, name));
+    }
+
+    // inodes updated in this batch, a later update of the same inode
+    // must start from the copy which is not committed yet
+    std::map<std::pair<uint32_t, uint64_t>, Inode> updated;
+    std::vector<Inode> trashed;
+    std::shared_ptr<storage::StorageTransaction> txn;
+    statuses->clear();
+    for (const auto* request : requests) {
+        auto key = std::make_pair(request->fsid(), request->inodeid());
+        auto iter = updated.find(key);
+        if (iter == updated.end()) {
+            Inode old;
+            MetaStatusCode rc = inodeStorage_->Get(
+                Key4Inode(request->fsid(), request->inodeid()), &old);
+            if (rc != MetaStatusCode::OK) {
+                // e.g. the inode has been deleted, skip it only
+                LOG(ERROR) << "GetInode fail, " << request->ShortDebugString()
+                           << ", ret: " << MetaStatusCode_Name(rc);
+                statuses->push_back(rc);
+                continue;
+            }
+            iter = updated.emplace(key, std::move(old)).first;
+        }
+
+        bool needAddTrash = false;
+        MetaStatusCode rc = UpdateInodeInTransaction(
+            &txn, *request, &iter->second, &needAddTrash, logIndex);
+        if (rc != MetaStatusCode::OK) {
+            if (txn != nullptr && !txn->Rollback().ok()) {
+                LOG(ERROR) << "Rollback transaction failed";
+            }
+            statuses->clear();
+            return rc;
+        }
+        if (needAddTrash) {
+            trashed.push_back(iter->second);
+        }
+        statuses->push_back(MetaStatusCode::OK);
+    }
+
+    if (txn != nullptr) {
+        auto s = txn->Commit();
+        if (!s.ok()) {
+            LOG(ERROR) << "Commit transaction failed, status = "
+                       << s.ToString();
+            if (!txn->Rollback().ok()) {
+                LOG(ERROR) << "Rollback transaction failed";
+            }
+            statuses->clear();
+            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        }
+    }
+
+    for (const auto& inode : trashed) {
+        trash_->Add(inode.inodeid(), inode.dtime());
+        --(*type2InodeNum_)[inode.type()];
+    }
+    VLOG(9) << "BatchUpdateInode success, size: " << requests.size();
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeManager::UpdateInodeInTransaction(
+    std::shared_ptr<storage::StorageTransaction>* txn,
+    const UpdateInodeRequest& request, Inode* old, bool* needAddTrash,
+    int64_t logIndex) {
+    bool needUpdate = false;
+
+#define UPDATE_INODE(param)                \
+    if (request.has_##param()) {           \
+        old->set_##param(request.param()); \
+        needUpdate = true;                 \
     }
 
     UPDATE_INODE(length)
@@ -352,108 +467,83 @@ MetaStatusCode InodeManager::UpdateInode(const UpdateInodeRequest& request,
     UPDATE_INODE(mode)
 
     if (request.parent_size() > 0) {
-        *(old.mutable_parent()) = request.parent();
+        *(old->mutable_parent()) = request.parent();
         needUpdate = true;
     }
 
     if (request.has_nlink()) {
-        if (old.nlink() != 0 && request.nlink() == 0) {
-            old.set_dtime(TimeUtility::GetTimeofDaySec());
-            needAddTrash = true;
+        if (old->nlink() != 0 && request.nlink() == 0) {
+            old->set_dtime(TimeUtility::GetTimeofDaySec());
+            *needAddTrash = true;
         }
-        VLOG(9) << "update inode nlink, from " << old.nlink() << " to "
+        VLOG(9) << "update inode nlink, from " << old->nlink() << " to "
                 << request.nlink() << ", fsid: " << request.fsid()
                 << ", inodeid: " << request.inodeid();
-        old.set_nlink(request.nlink());
+        old->set_nlink(request.nlink());
         needUpdate = true;
     }
 
     if (!request.xattr().empty()) {
         VLOG(6) << "update inode has xattr, fsid: " << request.fsid()
                 << ", inodeid: " << request.inodeid();
-        *(old.mutable_xattr()) = request.xattr();
+        *(old->mutable_xattr()) = request.xattr();
         needUpdate = true;
     }
 
     bool fileNeedDeallocate =
-        (needAddTrash && (FsFileType::TYPE_FILE == old.type()));
+        (*needAddTrash && (FsFileType::TYPE_FILE == old->type()));
 
-    std::shared_ptr<storage::StorageTransaction> txn;
     if (needUpdate) {
-        ret = inodeStorage_->Update(&txn, old, logIndex, fileNeedDeallocate);
+        MetaStatusCode ret =
+            inodeStorage_->Update(txn, *old, logIndex, fileNeedDeallocate);
         if (ret != MetaStatusCode::OK) {
             LOG(ERROR) << "UpdateInode fail, " << request.ShortDebugString()
                        << ", ret: " << MetaStatusCode_Name(ret);
-            if (txn != nullptr && !txn->Rollback().ok()) {
-                LOG(ERROR) << "Rollback transaction failed";
-            }
             return ret;
         }
     }
 
-    if (needAddTrash) {
-        trash_->Add(old.inodeid(), old.dtime());
-        --(*type2InodeNum_)[old.type()];
-    }
-
     const S3ChunkInfoMap &map2add = request.s3chunkinfoadd();
     const S3ChunkInfoList *list2add;
-    VLOG(9) << "UpdateInode inode " << old.inodeid() << " map2add size "
+    VLOG(9) << "UpdateInode inode " << old->inodeid() << " map2add size "
             << map2add.size();
     for (const auto &item : map2add) {
         uint64_t chunkIndex = item.first;
         list2add = &item.second;
         MetaStatusCode rc = inodeStorage_->ModifyInodeS3ChunkInfoList(
-            &txn, old.fsid(), old.inodeid(), chunkIndex, list2add, nullptr,
+            txn, old->fsid(), old->inodeid(), chunkIndex, list2add, nullptr,
             logIndex);
         if (rc != MetaStatusCode::OK) {
             LOG(ERROR) << "Modify inode s3chunkinfo list failed, fsId="
-                       << old.fsid() << ", inodeId=" << old.inodeid()
+                       << old->fsid() << ", inodeId=" << old->inodeid()
                        << ", retCode=" << rc;
-            if (txn != nullptr && !txn->Rollback().ok()) {
-                LOG(ERROR) << "Rollback transaction failed";
-            }
             return rc;
         }
     }
 
     // update extent in request
     if (request.has_volumeextents()) {
-        const auto fsId = old.fsid();
-        const auto inodeId = old.inodeid();
+        const auto fsId = old->fsid();
+        const auto inodeId = old->inodeid();
         for (const auto &slice : request.volumeextents().slices()) {
-            auto rc = UpdateVolumeExtentSliceLocked(&txn, fsId, inodeId, slice,
+            auto rc = UpdateVolumeExtentSliceLocked(txn, fsId, inodeId, slice,
                                                     logIndex);
             if (rc != MetaStatusCode::OK) {
                 LOG(ERROR) << "UpdateVolumeExtent failed, err: "
                            << MetaStatusCode_Name(rc) << ", fsId: " << fsId
                            << ", inodeId: " << inodeId;
-                if (txn != nullptr && !txn->Rollback().ok()) {
-                    LOG(ERROR) << "Rollback transaction failed";
-                }
                 return rc;
             }
         }
     }
-    if (txn != nullptr) {
-        auto s = txn->Commit();
-        if (!s.ok()) {
-            LOG(ERROR) << "Commit transaction failed, status = "
-                       << s.ToString();
-            if (!txn->Rollback().ok()) {
-                LOG(ERROR) << "Rollback transaction failed";
-            }
-            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
-        }
-    }
-    VLOG(9) << "UpdateInode success, " << request.ShortDebugString();
     return MetaStatusCode::OK;
 }
 
 MetaStatusCode InodeManager::GetOrModifyS3ChunkInfo(
     uint32_t fsId, uint64_t inodeId, const S3ChunkInfoMap& map2add,
     const S3ChunkInfoMap& map2del, bool returnS3ChunkInfoMap,
-    std::shared_ptr<Iterator>* iterator4InodeS3Meta, int64_t logIndex) {
+    std::shared_ptr<Iterator>* iterator4InodeS3Meta, int64_t logIndex,
+    uint64_t offset, uint64_t length) {
     VLOG(6) << "GetOrModifyS3ChunkInfo, fsId: " << fsId
             << ", inodeId: " << inodeId;
 
@@ -523,7 +613,9 @@ MetaStatusCode InodeManager::GetOrModifyS3ChunkInfo(
     // return if needed
     if (returnS3ChunkInfoMap) {
         *iterator4InodeS3Meta =
-            inodeStorage_->GetInodeS3ChunkInfoList(fsId, inodeId);
+            length == 0 ? inodeStorage_->GetInodeS3ChunkInfoList(fsId, inodeId)
+                        : inodeStorage_->GetInodeS3ChunkInfoList(
+                              fsId, inodeId, offset, length);
         if ((*iterator4InodeS3Meta)->Status() != 0) {
             return MetaStatusCode::STORAGE_INTERNAL_ERROR;
         }
@@ -537,10 +629,13 @@ MetaStatusCode InodeManager::GetOrModifyS3ChunkInfo(
 MetaStatusCode InodeManager::PaddingInodeS3ChunkInfo(int32_t fsId,
                                                      uint64_t inodeId,
                                                      S3ChunkInfoMap* m,
-                                                     uint64_t limit) {
+                                                     uint64_t limit,
+                                                     uint64_t offset,
+                                                     uint64_t length) {
     VLOG(6) << "PaddingInodeS3ChunkInfo, fsId: " << fsId
             << ", inodeId: " << inodeId;
-    return inodeStorage_->PaddingInodeS3ChunkInfo(fsId, inodeId, m, limit);
+    return inodeStorage_->PaddingInodeS3ChunkInfo(fsId, inodeId, m, limit,
+                                                  offset, length);
 }
 
 MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
@@ -559,57 +654,35 @@ MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
                   << " applied index = " << appliedIndex_;
         return MetaStatusCode::IDEMPOTENCE_OK;
     }
-    NameLockGuard lg(inodeLock_, GetInodeLockName(fsId, parentInodeId));
-
-    Inode parentInode;
-    ret = inodeStorage_->Get(
-        Key4Inode(fsId, parentInodeId), &parentInode);
-    if (ret != MetaStatusCode::OK) {
-        LOG(ERROR) << "GetInode fail, " << parentInode.ShortDebugString()
-                   << ", ret = " << MetaStatusCode_Name(ret);
-        return ret;
-    }
-
-    uint32_t oldNlink = parentInode.nlink();
-    if (oldNlink == 0) {
-        LOG(ERROR)
-            << "UpdateInodeWhenCreateOrRemoveSubNode already be deleted!"
-            << " fsId: " << fsId
-            << ", inodeId: " << parentInodeId
-            << ", type: " << type
-            << ", isCreate: " << isCreate;
-        // already be deleted
-        return MetaStatusCode::OK;
-    }
-
+    // NOTE: the parent inode isn't locked or rewritten here, the change is
+    // appended as a delta, so creating files in a hot directory neither
+    // rewrites it nor waits for each other. Updating inode, which reads the
+    // inode with pending deltas and overwrites them, is never applied with
+    // it at the same time, because they are writes of the same inode in
+    // the apply queue. A missing parent still fails with NOT_FOUND
+    InodeDelta delta;
     if (FsFileType::TYPE_DIRECTORY == type) {
-        if (isCreate) {
-            parentInode.set_nlink(++oldNlink);
-        } else {
-            parentInode.set_nlink(--oldNlink);
-        }
+        delta.set_nlink(isCreate ? 1 : -1);
     }
 
     // update mctime and changetime
     if (now != 0) {
-        parentInode.set_mtime(now);
-        parentInode.set_ctime(now);
-    }
-
-    if (now_ns != 0) {
-        parentInode.set_mtime_ns(now_ns);
-        parentInode.set_ctime_ns(now_ns);
+        delta.set_time(now);
+        delta.set_time_ns(now_ns);
     }
 
-    ret = inodeStorage_->Update(parentInode, logIndex);
+    ret = inodeStorage_->AppendInodeDelta(fsId, parentInodeId, delta,
+                                          logIndex);
     if (ret != MetaStatusCode::OK) {
-        LOG(ERROR) << "UpdateInode fail, " << parentInode.ShortDebugString()
+        LOG(ERROR) << "Append inode delta fail, fsId = " << fsId
+                   << ", inodeId = " << parentInodeId
+                   << ", delta = " << delta.ShortDebugString()
                    << ", ret = " << MetaStatusCode_Name(ret);
         return ret;
     }
 
-    VLOG(9) << "UpdateInodeWhenCreateOrRemoveSubNode success, "
-            << parentInode.ShortDebugString();
+    VLOG(9) << "UpdateInodeWhenCreateOrRemoveSubNode success, inodeId = "
+            << parentInodeId << ", delta = " << delta.ShortDebugString();
     return MetaStatusCode::OK;
 }
 
@@ -617,6 +690,10 @@ bool InodeManager::GetInodeIdList(std::list<uint64_t>* inodeIdList) {
     return inodeStorage_->GetAllInodeId(inodeIdList);
 }
 
+uint64_t InodeManager::GetInodeS3MetaSize(uint32_t fsId, uint64_t inodeId) {
+    return inodeStorage_->GetInodeS3MetaSize(fsId, inodeId);
+}
+
 MetaStatusCode InodeManager::UpdateVolumeExtentSliceLocked(
     uint32_t fsId, uint64_t inodeId, const VolumeExtentSlice& slice,
     int64_t logIndex) {
@@ -96,20 +96,34 @@ class InodeManager {
     MetaStatusCode UpdateInode(const UpdateInodeRequest& request,
                                int64_t logIndex);
 
+    // Apply all |requests| in one transaction, so they are persisted and
+    // replayed as a whole under |logIndex|. On success |statuses| holds the
+    // result of each request in order, a missing inode only fails itself.
+    MetaStatusCode BatchUpdateInode(
+        const std::vector<const UpdateInodeRequest*>& requests,
+        std::vector<MetaStatusCode>* statuses, int64_t logIndex);
+
+    // the returned chunk infos are limited to [offset, offset + length)
+    // if |length| isn't 0
     MetaStatusCode GetOrModifyS3ChunkInfo(
         uint32_t fsId, uint64_t inodeId, const S3ChunkInfoMap& map2add,
         const S3ChunkInfoMap& map2del, bool returnS3ChunkInfoMap,
-        std::shared_ptr<Iterator>* iterator4InodeS3Meta, int64_t logIndex);
+        std::shared_ptr<Iterator>* iterator4InodeS3Meta, int64_t logIndex,
+        uint64_t offset = 0, uint64_t length = 0);
 
     MetaStatusCode PaddingInodeS3ChunkInfo(int32_t fsId, uint64_t inodeId,
                                            S3ChunkInfoMap* m,
-                                           uint64_t limit = 0);
+                                           uint64_t limit = 0,
+                                           uint64_t offset = 0,
+                                           uint64_t length = 0);
 
     MetaStatusCode UpdateInodeWhenCreateOrRemoveSubNode(
         const Dentry& dentry, const Time& tm, bool isCreate, int64_t logIndex);
 
     bool GetInodeIdList(std::list<uint64_t>* inodeIdList);
 
+    uint64_t GetInodeS3MetaSize(uint32_t fsId, uint64_t inodeId);
+
     // Update one or more volume extent slice
     MetaStatusCode UpdateVolumeExtent(uint32_t fsId, uint64_t inodeId,
                                       const VolumeExtentSliceList& extents,
@@ -131,6 +145,13 @@ class InodeManager {
     void GenerateInodeInternal(uint64_t inodeId, const InodeParam &param,
                                Inode *inode);
 
+    // Apply |request| on |old| and put the changes into |txn| without
+    // committing it
+    MetaStatusCode UpdateInodeInTransaction(
+        std::shared_ptr<storage::StorageTransaction>* txn,
+        const UpdateInodeRequest& request, Inode* old, bool* needAddTrash,
+        int64_t logIndex);
+
     bool AppendS3ChunkInfo(uint32_t fsId, uint64_t inodeId,
                            S3ChunkInfoMap added);
 
@@ -25,38 +25,60 @@
 #include <google/protobuf/empty.pb.h>
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "curvefs/proto/common.pb.h"
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/metaserver/common/types.h"
+#include "curvefs/src/metaserver/s3chunkinfo_codec.h"
 #include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/storage/key_migration.h"
 #include "curvefs/src/metaserver/storage/status.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "src/common/concurrent/rw_lock.h"
 #include "src/common/string_util.h"
 
+static bool pass_uint32(const char*, uint32_t) { return true; }
+
+DEFINE_uint32(s3chunkinfo_merge_lists, 64,
+              "merge the s3chunkinfo lists of a chunk index into one once "
+              "their number reaches it, 0 means never merge, it only "
+              "works with s3chunkinfo_packed");
+DEFINE_validator(s3chunkinfo_merge_lists, &pass_uint32);
+
+DEFINE_uint32(inode_delta_merge_count, 64,
+              "merge the pending deltas of a directory inode into it once "
+              "their number reaches it, 0 or 1 means merge on every change");
+DEFINE_validator(inode_delta_merge_count, &pass_uint32);
+
 namespace curvefs {
 namespace metaserver {
 
+using ::curve::common::LockGuard;
 using ::curve::common::ReadLockGuard;
 using ::curve::common::StringStartWith;
 using ::curve::common::WriteLockGuard;
 using ::curvefs::metaserver::storage::Key4DeallocatableBlockGroup;
 using ::curvefs::metaserver::storage::Key4InodeAuxInfo;
+using ::curvefs::metaserver::storage::Key4InodeDelta;
 using ::curvefs::metaserver::storage::Key4S3ChunkInfoList;
 using ::curvefs::metaserver::storage::Key4VolumeExtentSlice;
 using ::curvefs::metaserver::storage::KVStorage;
+using ::curvefs::metaserver::storage::LockStripes;
 using ::curvefs::metaserver::storage::Prefix4AllDeallocatableBlockGroup;
 using ::curvefs::metaserver::storage::Prefix4AllInode;
 using ::curvefs::metaserver::storage::Prefix4ChunkIndexS3ChunkInfoList;
+using ::curvefs::metaserver::storage::Prefix4InodeDelta;
 using ::curvefs::metaserver::storage::Prefix4InodeS3ChunkInfoList;
 using ::curvefs::metaserver::storage::Prefix4InodeVolumeExtent;
 using ::curvefs::metaserver::storage::Status;
+using ::curvefs::metaserver::storage::ValueType;
 
 const char* InodeStorage::kInodeCountKey("count");
 
@@ -65,7 +87,12 @@ const char* InodeStorage::kInodeAppliedKey("inode");
 InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
                            std::shared_ptr<NameGenerator> nameGenerator,
                            uint64_t nInode)
-    : kvStorage_(std::move(kvStorage)),
+    : stripedLock_(LockStripes(kvStorage.get())),
+      snapshotIterator_(kvStorage->Type() ==
+                        KVStorage::STORAGE_TYPE::ROCKSDB_STORAGE),
+      concurrentWrite_(kvStorage->Type() ==
+                       KVStorage::STORAGE_TYPE::ROCKSDB_STORAGE),
+      kvStorage_(std::move(kvStorage)),
       table4Inode_(nameGenerator->GetInodeTableName()),
       table4S3ChunkInfo_(nameGenerator->GetS3ChunkInfoTableName()),
       table4VolumeExtent_(nameGenerator->GetVolumeExtentTableName()),
@@ -76,6 +103,7 @@ InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
           nameGenerator->GetDeallocatableBlockGroupTableName()),
       table4AppliedIndex_(nameGenerator->GetAppliedIndexTableName()),
       table4InodeCount_(nameGenerator->GetInodeCountTableName()),
+      table4InodeDelta_(nameGenerator->GetInodeDeltaTableName()),
       nInode_(nInode),
       conv_() {
     // NOTE: for compatibility with older versions
@@ -83,10 +111,112 @@ InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
 }
 
 bool InodeStorage::Init() {
+    if (!MigrateKeyFormat()) {
+        return false;
+    }
     // try get inode count for rocksdb
     // if we got it, replace old value
-    auto s = GetInodeCount(&nInode_);
-    return s.ok() || s.IsNotFound();
+    size_t count = 0;
+    auto s = GetInodeCount(&count);
+    if (s.IsNotFound()) {
+        s = RecoverInodeCount(&count);
+    }
+    if (!s.ok()) {
+        LOG(ERROR) << "Get inode count failed, status = " << s.ToString();
+        return false;
+    }
+    nInode_ = count;
+    return LoadDeltaInodes();
+}
+
+// NOTE: the inode count isn't persisted by older versions, we count
+// the inode table only once and persist it, it's maintained with the
+// inode table in the same transaction since then
+storage::Status InodeStorage::RecoverInodeCount(std::size_t* count) {
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, true);
+    auto iterator = kvStorage_->HGetAll(table4Inode_);
+    if (iterator->Status() != 0) {
+        return Status::InternalError();
+    }
+    *count = 0;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        (*count)++;
+    }
+
+    auto txn = kvStorage_->BeginTransaction();
+    if (txn == nullptr) {
+        return Status::InternalError();
+    }
+    Status s = SetInodeCount(txn.get(), *count);
+    s = s.ok() ? txn->Commit() : s;
+    if (!s.ok()) {
+        if (!txn->Rollback().ok()) {
+            LOG(ERROR) << "Rollback transaction failed";
+        }
+        return s;
+    }
+    LOG(INFO) << "Recover inode count success, count = " << *count;
+    return s;
+}
+
+bool InodeStorage::MigrateKeyFormat() {
+    using ::curvefs::metaserver::storage::MigrateKeyFormat;
+
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, true);
+    KVStorage* kv = kvStorage_.get();
+    uint64_t inodes = 0;
+    uint64_t deallocatableInodes = 0;
+    uint64_t s3ChunkInfos = 0;
+    uint64_t volumeExtents = 0;
+    uint64_t auxInfos = 0;
+    uint64_t blockGroups = 0;
+    uint64_t deltas = 0;
+    Status s = MigrateKeyFormat<Key4Inode, Inode>(kv, table4Inode_, false,
+                                                  &inodes);
+    if (s.ok()) {
+        s = MigrateKeyFormat<Key4Inode, google::protobuf::Empty>(
+            kv, table4DeallocatableInode_, false, &deallocatableInodes);
+    }
+    if (s.ok()) {
+        s = MigrateKeyFormat<Key4S3ChunkInfoList, PackedS3ChunkInfoList>(
+            kv, table4S3ChunkInfo_, true, &s3ChunkInfos);
+    }
+    if (s.ok()) {
+        s = MigrateKeyFormat<Key4VolumeExtentSlice, VolumeExtentSlice>(
+            kv, table4VolumeExtent_, true, &volumeExtents);
+    }
+    if (s.ok()) {
+        s = MigrateKeyFormat<Key4InodeAuxInfo, InodeAuxInfo>(
+            kv, table4InodeAuxInfo_, false, &auxInfos);
+    }
+    if (s.ok()) {
+        s = MigrateKeyFormat<Key4DeallocatableBlockGroup,
+                             DeallocatableBlockGroup>(
+            kv, table4DeallocatableBlockGroup_, false, &blockGroups);
+    }
+    if (s.ok()) {
+        s = MigrateKeyFormat<Key4InodeDelta, InodeDelta>(
+            kv, table4InodeDelta_, true, &deltas);
+    }
+    if (!s.ok()) {
+        LOG(ERROR) << "Migrate inode storage key format failed, status = "
+                   << s.ToString();
+        return false;
+    }
+
+    LOG_IF(INFO, inodes + deallocatableInodes + s3ChunkInfos + volumeExtents +
+                         auxInfos + blockGroups + deltas >
+                     0)
+        << "Migrate inode storage key format success, inodes = " << inodes
+        << ", deallocatable inodes = " << deallocatableInodes
+        << ", s3chunkinfo lists = " << s3ChunkInfos
+        << ", volume extents = " << volumeExtents
+        << ", aux infos = " << auxInfos
+        << ", deallocatable block groups = " << blockGroups
+        << ", inode deltas = " << deltas;
+    return true;
 }
 
 storage::Status InodeStorage::GetInodeCount(std::size_t* count) {
@@ -135,7 +265,8 @@ MetaStatusCode InodeStorage::GetAppliedIndex(int64_t* index) {
 }
 
 MetaStatusCode InodeStorage::Insert(const Inode& inode, int64_t logIndex) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, inode.inodeid(), true);
     Key4Inode key(inode.fsid(), inode.inodeid());
     std::string skey = conv_.SerializeToString(key);
     // NOTE: HGet() is cheap, because the key not found in most cases,
@@ -186,11 +317,11 @@ MetaStatusCode InodeStorage::Insert(const Inode& inode, int64_t logIndex) {
 }
 
 MetaStatusCode InodeStorage::Get(const Key4Inode& key, Inode* inode) {
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, key.inodeId, false);
     std::string skey = conv_.SerializeToString(key);
     Status s = kvStorage_->HGet(table4Inode_, skey, inode);
     if (s.ok()) {
-        return MetaStatusCode::OK;
+        return ApplyInodeDelta(kvStorage_.get(), key, inode);
     } else if (s.IsNotFound()) {
         return MetaStatusCode::NOT_FOUND;
     } else if (s.IsDBClosed()) {
@@ -202,7 +333,7 @@ MetaStatusCode InodeStorage::Get(const Key4Inode& key, Inode* inode) {
 }
 
 MetaStatusCode InodeStorage::GetAttr(const Key4Inode& key, InodeAttr* attr) {
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, key.inodeId, false);
     Inode inode;
     std::string skey = conv_.SerializeToString(key);
     Status s = kvStorage_->HGet(table4Inode_, skey, &inode);
@@ -211,6 +342,10 @@ MetaStatusCode InodeStorage::GetAttr(const Key4Inode& key, InodeAttr* attr) {
     } else if (!s.ok()) {
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
+    MetaStatusCode rc = ApplyInodeDelta(kvStorage_.get(), key, &inode);
+    if (rc != MetaStatusCode::OK) {
+        return rc;
+    }
 
     // get attr from inode
     attr->set_inodeid(inode.inodeid());
@@ -244,7 +379,7 @@ MetaStatusCode InodeStorage::GetAttr(const Key4Inode& key, InodeAttr* attr) {
 }
 
 MetaStatusCode InodeStorage::GetXAttr(const Key4Inode& key, XAttr* xattr) {
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, key.inodeId, false);
     Inode inode;
     std::string skey = conv_.SerializeToString(key);
     Status s = kvStorage_->HGet(table4Inode_, skey, &inode);
@@ -267,17 +402,32 @@ storage::Status InodeStorage::DeleteInternal(
     storage::StorageTransaction* transaction, const Key4Inode& key) {
     std::string skey = conv_.SerializeToString(key);
     Status s;
-    const char* step = "Delete inode from transaction";
+    const char* step = "Get inode from transaction";
     do {
-        s = transaction->HDel(table4Inode_, skey);
-        if (!s.ok()) {
+        // NOTE: for rocksdb storage, it will never check whether
+        // the key exist in delete(), so we check it here to keep
+        // the inode count exact, even if the client delete the
+        // non-exist inode in some abnormal cases.
+        Inode out;
+        s = transaction->HGet(table4Inode_, skey, &out);
+        if (!s.ok() && !s.IsNotFound()) {
             break;
         }
-        // NOTE: for rocksdb storage, it will never check whether
-        // the key exist in delete(), so if the client delete the
-        // non-exist inode in some abnormal cases, it will cause the
-        // nInode less then the real value.
-        if (nInode_ > 0) {
+        bool exist = s.ok();
+        if (exist) {
+            s = transaction->HDel(table4Inode_, skey);
+            if (!s.ok()) {
+                step = "Delete inode from transaction";
+                break;
+            }
+        }
+        if (exist && out.type() == FsFileType::TYPE_DIRECTORY &&
+            DelInodeDelta(transaction, key) != MetaStatusCode::OK) {
+            s = Status::InternalError();
+            step = "Delete inode deltas from transaction";
+            break;
+        }
+        if (exist && nInode_ > 0) {
             s = SetInodeCount(transaction, nInode_ - 1);
             if (!s.ok()) {
                 step = "Insert inode count to transaction";
@@ -289,13 +439,11 @@ storage::Status InodeStorage::DeleteInternal(
             step = "Delete inode";
             break;
         }
-        // NOTE: for rocksdb storage, it will never check whether
-        // the key exist in delete(), so if the client delete the
-        // non-exist inode in some abnormal cases, it will cause the
-        // nInode less then the real value.
-        if (nInode_ > 0) {
+        if (exist && nInode_ > 0) {
             nInode_--;
         }
+        WriteLockGuard lg(deltaInodesLock_);
+        deltaInodes_.erase(key.inodeId);
         return s;
     } while (false);
     LOG(ERROR) << step << " failed, status = " << s.ToString();
@@ -303,7 +451,8 @@ storage::Status InodeStorage::DeleteInternal(
 }
 
 MetaStatusCode InodeStorage::Delete(const Key4Inode& key, int64_t logIndex) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, key.inodeId, true);
     std::shared_ptr<storage::StorageTransaction> txn;
     Status s;
     const char* step = "Begin transaction";
@@ -333,7 +482,8 @@ MetaStatusCode InodeStorage::Delete(const Key4Inode& key, int64_t logIndex) {
 }
 
 MetaStatusCode InodeStorage::ForceDelete(const Key4Inode& key) {
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, key.inodeId, true);
     std::shared_ptr<storage::StorageTransaction> txn = nullptr;
     Status s;
     const char* step = "Begin transaction";
@@ -367,7 +517,7 @@ MetaStatusCode InodeStorage::Update(
             return MetaStatusCode::STORAGE_INTERNAL_ERROR;
         }
     }
-    WriteLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, inode.inodeid(), true);
     Key4Inode key(inode.fsid(), inode.inodeid());
     std::string skey = conv_.SerializeToString(key);
     storage::Status s;
@@ -377,6 +527,14 @@ MetaStatusCode InodeStorage::Update(
                    << s.ToString();
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
+    // the inode is read with pending deltas applied before updating,
+    // it's removed from |deltaInodes_| lazily on next read
+    if (inode.type() == FsFileType::TYPE_DIRECTORY) {
+        MetaStatusCode rc = DelInodeDelta(txn->get(), key);
+        if (rc != MetaStatusCode::OK) {
+            return rc;
+        }
+    }
     if (!inodeDeallocate) {
         s = (*txn)->HSet(table4Inode_, skey, inode);
         if (s.ok()) {
@@ -418,15 +576,368 @@ MetaStatusCode InodeStorage::Update(const Inode& inode, int64_t logIndex,
     return MetaStatusCode::STORAGE_INTERNAL_ERROR;
 }
 
+namespace {
+
+void AccumulateInodeDelta(const InodeDelta& delta, InodeDelta* sum) {
+    sum->set_nlink(sum->nlink() + delta.nlink());
+    // the latest time wins, so deltas can be accumulated in any order
+    if (delta.has_time() &&
+        std::make_pair(delta.time(), delta.time_ns()) >
+            std::make_pair(sum->time(), sum->time_ns())) {
+        sum->set_time(delta.time());
+        sum->set_time_ns(delta.time_ns());
+    }
+}
+
+void ApplyDeltaToInode(const InodeDelta& delta, Inode* inode) {
+    if (inode->nlink() == 0) {
+        // already be deleted
+        return;
+    }
+    inode->set_nlink(inode->nlink() + delta.nlink());
+    if (delta.has_time()) {
+        inode->set_mtime(delta.time());
+        inode->set_mtime_ns(delta.time_ns());
+        inode->set_ctime(delta.time());
+        inode->set_ctime_ns(delta.time_ns());
+    }
+}
+
+}  // namespace
+
+MetaStatusCode InodeStorage::GetInodeDelta(storage::BaseStorage* storage,
+                                           const Key4Inode& key,
+                                           InodeDelta* delta,
+                                           std::vector<std::string>* keys) {
+    Prefix4InodeDelta prefix(key.fsId, key.inodeId);
+    std::string sprefix = conv_.SerializeToString(prefix);
+    auto iterator = storage->SSeek(table4InodeDelta_, sprefix);
+    if (iterator->Status() != 0) {
+        LOG(ERROR) << "Get iterator failed, prefix=" << sprefix;
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    InodeDelta out;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        std::string skey = iterator->Key();
+        if (!StringStartWith(skey, sprefix)) {
+            break;
+        } else if (!iterator->ParseFromValue(&out)) {
+            return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+        }
+        AccumulateInodeDelta(out, delta);
+        if (keys != nullptr) {
+            keys->emplace_back(std::move(skey));
+        }
+    }
+    return MetaStatusCode::OK;
+}
+
+bool InodeStorage::HasInodeDelta(uint64_t inodeId) {
+    ReadLockGuard lg(deltaInodesLock_);
+    return deltaInodes_.count(inodeId) != 0;
+}
+
+bool InodeStorage::LoadDeltaInodes() {
+    auto iterator = kvStorage_->SGetAll(table4InodeDelta_);
+    if (iterator->Status() != 0) {
+        LOG(ERROR) << "Get inode delta iterator failed";
+        return false;
+    }
+
+    Key4InodeDelta key;
+    WriteLockGuard lg(deltaInodesLock_);
+    deltaInodes_.clear();
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        if (!conv_.ParseFromString(iterator->Key(), &key)) {
+            LOG(ERROR) << "Parse inode delta key failed, key = "
+                       << iterator->Key();
+            return false;
+        }
+        deltaInodes_[key.inodeId]++;
+    }
+    return true;
+}
+
+MetaStatusCode InodeStorage::ApplyInodeDelta(storage::BaseStorage* storage,
+                                             const Key4Inode& key,
+                                             Inode* inode) {
+    // only the parent inodes have deltas
+    if (inode->type() != FsFileType::TYPE_DIRECTORY ||
+        !HasInodeDelta(key.inodeId)) {
+        return MetaStatusCode::OK;
+    }
+    InodeDelta delta;
+    std::vector<std::string> keys;
+    MetaStatusCode rc = GetInodeDelta(storage, key, &delta, &keys);
+    if (rc != MetaStatusCode::OK) {
+        return rc;
+    } else if (keys.empty()) {
+        // the deltas were dropped by updating the inode, as the stripe of
+        // inode is locked, no delta can be appended meanwhile
+        WriteLockGuard lg(deltaInodesLock_);
+        deltaInodes_.erase(key.inodeId);
+        return MetaStatusCode::OK;
+    }
+    ApplyDeltaToInode(delta, inode);
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeStorage::MergeInodeDelta(const Key4Inode& key) {
+    StripedLockGuard slg(&stripedLock_, key.inodeId, true);
+    std::string skey = conv_.SerializeToString(key);
+    std::shared_ptr<storage::StorageTransaction> txn;
+    MetaStatusCode rc = MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    const char* step = "Begin transaction";
+    do {
+        txn = kvStorage_->BeginTransaction();
+        if (txn == nullptr) {
+            break;
+        }
+
+        Inode inode;
+        Status s = txn->HGet(table4Inode_, skey, &inode);
+        if (s.IsNotFound()) {
+            // the deltas were dropped by deleting the inode
+            if (!txn->Rollback().ok()) {
+                LOG(ERROR) << "Rollback transaction failed";
+            }
+            WriteLockGuard lg(deltaInodesLock_);
+            deltaInodes_.erase(key.inodeId);
+            return MetaStatusCode::OK;
+        } else if (!s.ok()) {
+            step = "Get inode from transaction";
+            break;
+        }
+
+        // the deltas are counted by the scan, no delta can be appended
+        // meanwhile as the stripe of inode is locked exclusively
+        InodeDelta sum;
+        std::vector<std::string> keys;
+        rc = GetInodeDelta(txn.get(), key, &sum, &keys);
+        if (rc != MetaStatusCode::OK) {
+            step = "Get inode deltas from transaction";
+            break;
+        }
+        rc = MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        ApplyDeltaToInode(sum, &inode);
+        s = txn->HSet(table4Inode_, skey, inode);
+        for (auto iter = keys.begin(); s.ok() && iter != keys.end(); iter++) {
+            s = txn->SDel(table4InodeDelta_, *iter);
+        }
+        if (!s.ok()) {
+            step = "Merge deltas into inode";
+            break;
+        }
+        if (!txn->Commit().ok()) {
+            step = "Commit merge inode delta transaction";
+            break;
+        }
+        VLOG(6) << "Merge " << keys.size() << " deltas into inode, fsId="
+                << key.fsId << ", inodeId=" << key.inodeId;
+        WriteLockGuard lg(deltaInodesLock_);
+        deltaInodes_.erase(key.inodeId);
+        return MetaStatusCode::OK;
+    } while (false);
+    LOG(ERROR) << step << " failed, fsId = " << key.fsId
+               << ", inodeId = " << key.inodeId
+               << ", rc = " << MetaStatusCode_Name(rc);
+    if (txn != nullptr && !txn->Rollback().ok()) {
+        LOG(ERROR) << "Rollback transaction failed";
+    }
+    return rc;
+}
+
+MetaStatusCode InodeStorage::DelInodeDelta(StorageTransaction* transaction,
+                                           const Key4Inode& key) {
+    if (!HasInodeDelta(key.inodeId)) {
+        return MetaStatusCode::OK;
+    }
+    InodeDelta sum;
+    std::vector<std::string> keys;
+    MetaStatusCode rc = GetInodeDelta(transaction, key, &sum, &keys);
+    if (rc != MetaStatusCode::OK) {
+        return rc;
+    }
+    for (const auto& key2del : keys) {
+        if (!transaction->SDel(table4InodeDelta_, key2del).ok()) {
+            LOG(ERROR) << "Delete key failed, skey=" << key2del;
+            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        }
+    }
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeStorage::AppendInodeDelta(uint32_t fsId, uint64_t inodeId,
+                                              const InodeDelta& delta,
+                                              int64_t logIndex) {
+    Key4Inode key(fsId, inodeId);
+    std::string skey = conv_.SerializeToString(key);
+    MetaStatusCode rc = MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    std::shared_ptr<storage::StorageTransaction> txn;
+    uint32_t count = 0;
+    const char* step = "Get inode";
+    do {
+        // NOTE: deltas are commutative, and the key of delta contains the
+        // log index, so appending neither reads nor writes anything shared
+        // with other appends of the inode. It only takes the stripe shared
+        // to exclude merging and overwriting the inode.
+        StripedLockGuard slg(&stripedLock_, inodeId, !concurrentWrite_);
+
+        // the inode is read outside the transaction to check whether it
+        // exists, so it isn't locked by the transaction
+        Inode inode;
+        Status s = kvStorage_->HGet(table4Inode_, skey, &inode);
+        if (s.IsNotFound()) {
+            rc = MetaStatusCode::NOT_FOUND;
+            break;
+        } else if (!s.ok()) {
+            break;
+        } else if (inode.nlink() == 0) {
+            // already be deleted
+            return MetaStatusCode::OK;
+        }
+
+        step = "Begin transaction";
+        txn = kvStorage_->BeginTransaction();
+        if (txn == nullptr) {
+            break;
+        }
+        // appending is idempotent when the log is replayed
+        Key4InodeDelta dkey(fsId, inodeId, logIndex);
+        s = txn->SSet(table4InodeDelta_, conv_.SerializeToString(dkey),
+                      delta);
+        if (!s.ok()) {
+            step = "Append inode delta to transaction";
+            break;
+        }
+        if (!SetAppliedIndex(txn.get(), logIndex).ok()) {
+            step = "Insert applied index to transaction";
+            break;
+        }
+        if (!txn->Commit().ok()) {
+            step = "Commit append inode delta transaction";
+            break;
+        }
+
+        // the number of pending deltas is only kept in memory, it's rebuilt
+        // from the delta table on init
+        WriteLockGuard lg(deltaInodesLock_);
+        count = ++deltaInodes_[inodeId];
+        rc = MetaStatusCode::OK;
+    } while (false);
+
+    if (rc != MetaStatusCode::OK) {
+        LOG(ERROR) << step << " failed, fsId = " << fsId
+                   << ", inodeId = " << inodeId
+                   << ", rc = " << MetaStatusCode_Name(rc);
+        if (txn != nullptr && !txn->Rollback().ok()) {
+            LOG(ERROR) << "Rollback transaction failed";
+        }
+        return rc;
+    } else if (count < FLAGS_inode_delta_merge_count) {
+        return MetaStatusCode::OK;
+    }
+
+    // the delta has been persisted, merging is only to keep reading cheap,
+    // so it needn't be in the same transaction with appending, and if it
+    // fails, the deltas are merged by the next appending
+    MergeInodeDelta(key);
+    return MetaStatusCode::OK;
+}
+
+namespace {
+
+// Iterate the inodes with pending deltas of directory inodes applied
+class InodeDeltaIterator : public Iterator {
+ public:
+    using ApplyFunc = std::function<MetaStatusCode(const Key4Inode&, Inode*)>;
+
+    InodeDeltaIterator(std::shared_ptr<Iterator> iterator, ApplyFunc apply)
+        : iterator_(std::move(iterator)), apply_(std::move(apply)),
+          status_(0) {}
+
+    uint64_t Size() override { return iterator_->Size(); }
+
+    bool Valid() override { return status_ == 0 && iterator_->Valid(); }
+
+    void SeekToFirst() override {
+        iterator_->SeekToFirst();
+        Parse();
+    }
+
+    void Next() override {
+        iterator_->Next();
+        Parse();
+    }
+
+    std::string Key() override { return iterator_->Key(); }
+
+    std::string Value() override {
+        std::string value;
+        if (!inode_.SerializeToString(&value)) {
+            status_ = -1;
+        }
+        return value;
+    }
+
+    const ValueType* RawValue() const override { return &inode_; }
+
+    int Status() override {
+        return status_ != 0 ? status_ : iterator_->Status();
+    }
+
+    bool ParseFromValue(ValueType* value) override {
+        value->CopyFrom(inode_);
+        return true;
+    }
+
+ private:
+    void Parse() {
+        if (!iterator_->Valid()) {
+            return;
+        }
+        Key4Inode key;
+        inode_.Clear();
+        if (!key.ParseFromString(iterator_->Key()) ||
+            !iterator_->ParseFromValue(&inode_) ||
+            apply_(key, &inode_) != MetaStatusCode::OK) {
+            status_ = -1;
+        }
+    }
+
+ private:
+    std::shared_ptr<Iterator> iterator_;
+    ApplyFunc apply_;
+    Inode inode_;
+    int status_;
+};
+
+}  // namespace
+
+// NOTE: the iterator mustn't outlive the inode storage
 std::shared_ptr<Iterator> InodeStorage::GetAllInode() {
-    ReadLockGuard lg(rwLock_);
-    std::string sprefix = conv_.SerializeToString(Prefix4AllInode());
-    return kvStorage_->HGetAll(table4Inode_);
+    std::shared_ptr<Iterator> iterator;
+    {
+        StripedLockGuard slg(&stripedLock_, false);
+        iterator = kvStorage_->HGetAll(table4Inode_);
+    }
+    if (iterator->Status() != 0) {
+        return iterator;
+    }
+    return std::make_shared<InodeDeltaIterator>(
+        iterator, [this](const Key4Inode& key, Inode* inode) {
+            StripedLockGuard slg(&stripedLock_, key.inodeId, false);
+            return ApplyInodeDelta(kvStorage_.get(), key, inode);
+        });
 }
 
 bool InodeStorage::GetAllInodeId(std::list<uint64_t>* ids) {
-    ReadLockGuard lg(rwLock_);
-    auto iterator = GetAllInode();
+    StripedLockGuard slg(&stripedLock_, false);
+    auto iterator = kvStorage_->HGetAll(table4Inode_);
+    if (snapshotIterator_) {
+        slg.Unlock();
+    }
     if (iterator->Status() != 0) {
         LOG(ERROR) << "failed to get iterator for all inode";
         return false;
@@ -443,13 +954,19 @@ bool InodeStorage::GetAllInodeId(std::list<uint64_t>* ids) {
 }
 
 size_t InodeStorage::Size() {
-    ReadLockGuard lg(rwLock_);
     return nInode_;
 }
 
 bool InodeStorage::Empty() {
-    ReadLockGuard lg(rwLock_);
-    auto iterator = GetAllInode();
+    // NOTE: the inode count is maintained with the inode table, so we
+    // needn't seek the table, which maybe full of tombstones after the
+    // partition is cleaned, unless it says the table is empty
+    if (nInode_ > 0) {
+        return false;
+    }
+
+    StripedLockGuard slg(&stripedLock_, false);
+    auto iterator = kvStorage_->HGetAll(table4Inode_);
     if (iterator->Status() != 0) {
         LOG(ERROR) << "failed to get iterator for all inode";
         return false;
@@ -470,7 +987,8 @@ MetaStatusCode InodeStorage::Clear() {
     // NOTE: clear operations non-atomic is acceptable
     // because if we fail stop, we will replay
     // raft logs and clear it again
-    WriteLockGuard lg(rwLock_);
+    LockGuard lg(writeLock_);
+    StripedLockGuard slg(&stripedLock_, true);
 
     Status s = kvStorage_->HClear(table4Inode_);
     if (!s.ok()) {
@@ -500,6 +1018,17 @@ MetaStatusCode InodeStorage::Clear() {
             << s.ToString();
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
+
+    s = kvStorage_->SClear(table4InodeDelta_);
+    if (!s.ok()) {
+        LOG(ERROR) << "InodeStorage clear inode delta table failed, status = "
+                   << s.ToString();
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+    {
+        WriteLockGuard lg(deltaInodesLock_);
+        deltaInodes_.clear();
+    }
     std::shared_ptr<storage::StorageTransaction> txn;
     const char* step = "Begin transaction";
     do {
@@ -587,29 +1116,113 @@ uint64_t InodeStorage::GetInodeS3MetaSize(uint32_t fsId, uint64_t inodeId) {
     return size;
 }
 
-MetaStatusCode InodeStorage::AddS3ChunkInfoList(
-    Transaction txn, uint32_t fsId, uint64_t inodeId, uint64_t chunkIndex,
-    const S3ChunkInfoList* list2add) {
-    if (nullptr == list2add || list2add->s3chunks_size() == 0) {
-        return MetaStatusCode::OK;
+MetaStatusCode InodeStorage::PutS3ChunkInfoList(
+    storage::BaseStorage* storage, uint32_t fsId, uint64_t inodeId,
+    uint64_t chunkIndex, const S3ChunkInfoList& list, bool merged) {
+    size_t size = list.s3chunks_size();
+    uint64_t firstChunkId = list.s3chunks(0).chunkid();
+    uint64_t lastChunkId = list.s3chunks(size - 1).chunkid();
+    if (merged) {
+        // chunk ids of merged list aren't sorted, e.g: the chunk infos
+        // kept by compaction, so its key covers all of them
+        for (const auto& info : list.s3chunks()) {
+            firstChunkId = std::min(firstChunkId, info.chunkid());
+            lastChunkId = std::max(lastChunkId, info.chunkid());
+        }
     }
 
-    size_t size = list2add->s3chunks_size();
-    uint64_t firstChunkId = list2add->s3chunks(0).chunkid();
-    uint64_t lastChunkId = list2add->s3chunks(size - 1).chunkid();
-
     Key4S3ChunkInfoList key(fsId, inodeId, chunkIndex, firstChunkId,
                             lastChunkId, size);
     std::string skey = conv_.SerializeToString(key);
     Status s;
-    if (txn) {
-        s = txn->SSet(table4S3ChunkInfo_, skey, *list2add);
+    // the merged list must be kept in packed format to be marked
+    if (FLAGS_s3chunkinfo_packed || merged) {
+        PackedS3ChunkInfoList packed;
+        PackS3ChunkInfoList(list, &packed);
+        packed.set_merged(merged);
+        s = storage->SSet(table4S3ChunkInfo_, skey, packed);
     } else {
-        s = kvStorage_->SSet(table4S3ChunkInfo_, skey, *list2add);
+        s = storage->SSet(table4S3ChunkInfo_, skey, list);
     }
     return s.ok() ? MetaStatusCode::OK : MetaStatusCode::STORAGE_INTERNAL_ERROR;
 }
 
+// The lists of a chunk index are appended one by one, they are merged
+// into one list lazily once their number reaches the threshold, so
+// reading an append-heavy chunk needn't to seek and parse too many lists.
+MetaStatusCode InodeStorage::MergeS3ChunkInfoList(
+    storage::BaseStorage* storage, uint32_t fsId, uint64_t inodeId,
+    uint64_t chunkIndex, S3ChunkInfoList* merged) {
+    Prefix4ChunkIndexS3ChunkInfoList prefix(fsId, inodeId, chunkIndex);
+    std::string sprefix = conv_.SerializeToString(prefix);
+    auto iterator = storage->SSeek(table4S3ChunkInfo_, sprefix);
+    if (iterator->Status() != 0) {
+        LOG(ERROR) << "Get iterator failed, prefix=" << sprefix;
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    std::vector<std::string> key2merge;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        std::string skey = iterator->Key();
+        if (!StringStartWith(skey, sprefix)) {
+            break;
+        }
+        key2merge.emplace_back(std::move(skey));
+    }
+    if (key2merge.size() + 1 < FLAGS_s3chunkinfo_merge_lists) {
+        return MetaStatusCode::OK;
+    }
+
+    PackedS3ChunkInfoList packed;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        if (!StringStartWith(iterator->Key(), sprefix)) {
+            break;
+        } else if (!iterator->ParseFromValue(&packed) ||
+                   !UnpackS3ChunkInfoList(packed, merged)) {
+            return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+        }
+    }
+
+    for (const auto& skey : key2merge) {
+        if (!storage->SDel(table4S3ChunkInfo_, skey).ok()) {
+            LOG(ERROR) << "Delete key failed, skey=" << skey;
+            return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+        }
+    }
+    VLOG(6) << "Merge " << key2merge.size() << " s3chunkinfo lists, fsId="
+            << fsId << ", inodeId=" << inodeId
+            << ", chunkIndex=" << chunkIndex;
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeStorage::AddS3ChunkInfoList(
+    Transaction txn, uint32_t fsId, uint64_t inodeId, uint64_t chunkIndex,
+    const S3ChunkInfoList* list2add) {
+    if (nullptr == list2add || list2add->s3chunks_size() == 0) {
+        return MetaStatusCode::OK;
+    }
+
+    storage::BaseStorage* storage = txn ? static_cast<storage::BaseStorage*>(
+                                              txn.get())
+                                        : kvStorage_.get();
+    S3ChunkInfoList merged;
+    if (FLAGS_s3chunkinfo_packed && FLAGS_s3chunkinfo_merge_lists > 0) {
+        auto rc =
+            MergeS3ChunkInfoList(storage, fsId, inodeId, chunkIndex, &merged);
+        if (rc != MetaStatusCode::OK) {
+            return rc;
+        }
+    }
+
+    if (merged.s3chunks_size() == 0) {
+        return PutS3ChunkInfoList(storage, fsId, inodeId, chunkIndex,
+                                  *list2add, false);
+    }
+    merged.mutable_s3chunks()->MergeFrom(list2add->s3chunks());
+    return PutS3ChunkInfoList(storage, fsId, inodeId, chunkIndex, merged,
+                              true);
+}
+
 MetaStatusCode InodeStorage::DelS3ChunkInfoList(
     Transaction txn, uint32_t fsId, uint64_t inodeId, uint64_t chunkIndex,
     const S3ChunkInfoList* list2del) {
@@ -631,7 +1244,9 @@ MetaStatusCode InodeStorage::DelS3ChunkInfoList(
     }
 
     Key4S3ChunkInfoList key;
+    PackedS3ChunkInfoList packed;
     std::vector<std::string> key2del;
+    std::vector<S3ChunkInfoList> lists2put;
     for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
         std::string skey = iterator->Key();
         if (!StringStartWith(skey, sprefix)) {
@@ -649,6 +1264,26 @@ MetaStatusCode InodeStorage::DelS3ChunkInfoList(
             // delete list range :  [  ]
         } else if (delLastChunkId < key.firstChunkId) {
             continue;
+        } else if (!iterator->ParseFromValue(&packed)) {
+            return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+        } else if (packed.merged()) {
+            // the merged list may contain chunk infos appended after
+            // the delete list is read, e.g: by compaction, keep them
+            S3ChunkInfoList current;
+            if (!UnpackS3ChunkInfoList(packed, &current)) {
+                return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+            }
+            S3ChunkInfoList remain;
+            for (auto& info : *current.mutable_s3chunks()) {
+                if (info.chunkid() < delFirstChunkId ||
+                    info.chunkid() > delLastChunkId) {
+                    remain.add_s3chunks()->Swap(&info);
+                }
+            }
+            key2del.push_back(skey);
+            if (remain.s3chunks_size() > 0) {
+                lists2put.emplace_back(std::move(remain));
+            }
         } else {
             LOG(ERROR) << "wrong delete list range (" << delFirstChunkId << ","
                        << delLastChunkId << "), skey=" << skey;
@@ -662,6 +1297,13 @@ MetaStatusCode InodeStorage::DelS3ChunkInfoList(
             return MetaStatusCode::STORAGE_INTERNAL_ERROR;
         }
     }
+    for (const auto& list : lists2put) {
+        auto rc = PutS3ChunkInfoList(txn.get(), fsId, inodeId, chunkIndex,
+                                     list, true);
+        if (rc != MetaStatusCode::OK) {
+            return rc;
+        }
+    }
     return MetaStatusCode::OK;
 }
 
@@ -676,7 +1318,7 @@ MetaStatusCode InodeStorage::ModifyInodeS3ChunkInfoList(
             return MetaStatusCode::STORAGE_INTERNAL_ERROR;
         }
     }
-    WriteLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, inodeId, true);
     std::string step;
     auto rc = DelS3ChunkInfoList(*txn, fsId, inodeId, chunkIndex, list2del);
     step = "del s3 chunkinfo list ";
@@ -730,42 +1372,50 @@ MetaStatusCode InodeStorage::ModifyInodeS3ChunkInfoList(
 MetaStatusCode InodeStorage::PaddingInodeS3ChunkInfo(int32_t fsId,
                                                      uint64_t inodeId,
                                                      S3ChunkInfoMap* m,
-                                                     uint64_t limit) {
-    ReadLockGuard lg(rwLock_);
+                                                     uint64_t limit,
+                                                     uint64_t offset,
+                                                     uint64_t length) {
+    StripedLockGuard slg(&stripedLock_, inodeId, false);
     if (limit != 0 && GetInodeS3MetaSize(fsId, inodeId) > limit) {
         return MetaStatusCode::INODE_S3_META_TOO_LARGE;
     }
 
-    auto iterator = GetInodeS3ChunkInfoList(fsId, inodeId);
+    Prefix4InodeS3ChunkInfoList prefix(fsId, inodeId);
+    auto iterator = kvStorage_->SSeek(table4S3ChunkInfo_,
+                                      conv_.SerializeToString(prefix));
     if (iterator->Status() != 0) {
         LOG(ERROR) << "Get inode s3chunkinfo failed";
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
     }
-
-    auto merge = [](const S3ChunkInfoList& from, S3ChunkInfoList* to) {
-        for (int i = 0; i < from.s3chunks_size(); i++) {
-            auto chunkinfo = to->add_s3chunks();
-            chunkinfo->CopyFrom(from.s3chunks(i));
-        }
-    };
+    if (snapshotIterator_) {
+        slg.Unlock();
+    }
 
     Key4S3ChunkInfoList key;
-    S3ChunkInfoList list;
+    PackedS3ChunkInfoList packed;
     for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
         std::string skey = iterator->Key();
-        std::string svalue = iterator->Value();
         if (!conv_.ParseFromString(skey, &key)) {
             return MetaStatusCode::PARSE_FROM_STRING_FAILED;
-        } else if (!iterator->ParseFromValue(&list)) {
+        } else if (!iterator->ParseFromValue(&packed)) {
             return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+        } else if (length != 0 && !MayOverlap(packed, offset, length)) {
+            continue;
         }
 
-        uint64_t chunkIndex = key.chunkIndex;
-        auto iter = m->find(chunkIndex);
-        if (iter == m->end()) {
-            m->insert({chunkIndex, list});
+        bool succ;
+        if (length == 0) {
+            succ = UnpackS3ChunkInfoList(packed, &(*m)[key.chunkIndex]);
         } else {
-            merge(list, &iter->second);
+            // chunk indexes without chunk info in range are not padded
+            S3ChunkInfoList list;
+            succ = UnpackS3ChunkInfoList(packed, offset, length, &list);
+            if (succ && list.s3chunks_size() > 0) {
+                (*m)[key.chunkIndex].MergeFrom(list);
+            }
+        }
+        if (!succ) {
+            return MetaStatusCode::PARSE_FROM_STRING_FAILED;
         }
     }
 
@@ -774,26 +1424,37 @@ MetaStatusCode InodeStorage::PaddingInodeS3ChunkInfo(int32_t fsId,
 
 std::shared_ptr<Iterator> InodeStorage::GetInodeS3ChunkInfoList(
     uint32_t fsId, uint64_t inodeId) {
-    ReadLockGuard lg(rwLock_);
+    StripedLockGuard slg(&stripedLock_, inodeId, false);
+    Prefix4InodeS3ChunkInfoList prefix(fsId, inodeId);
+    std::string sprefix = conv_.SerializeToString(prefix);
+    return std::make_shared<S3ChunkInfoListIterator>(
+        kvStorage_->SSeek(table4S3ChunkInfo_, sprefix));
+}
+
+std::shared_ptr<Iterator> InodeStorage::GetInodeS3ChunkInfoList(
+    uint32_t fsId, uint64_t inodeId, uint64_t offset, uint64_t length) {
+    StripedLockGuard slg(&stripedLock_, inodeId, false);
     Prefix4InodeS3ChunkInfoList prefix(fsId, inodeId);
     std::string sprefix = conv_.SerializeToString(prefix);
-    return kvStorage_->SSeek(table4S3ChunkInfo_, sprefix);
+    return std::make_shared<S3ChunkInfoListIterator>(
+        kvStorage_->SSeek(table4S3ChunkInfo_, sprefix), offset, length);
 }
 
 std::shared_ptr<Iterator> InodeStorage::GetAllS3ChunkInfoList() {
-    ReadLockGuard lg(rwLock_);
-    return kvStorage_->SGetAll(table4S3ChunkInfo_);
+    StripedLockGuard slg(&stripedLock_, false);
+    return std::make_shared<S3ChunkInfoListIterator>(
+        kvStorage_->SGetAll(table4S3ChunkInfo_));
 }
 
 std::shared_ptr<Iterator> InodeStorage::GetAllVolumeExtentList() {
-    ReadLockGuard guard(rwLock_);
+    StripedLockGuard slg(&stripedLock_, false);
     return kvStorage_->SGetAll(table4VolumeExtent_);
 }
 
 MetaStatusCode InodeStorage::UpdateVolumeExtentSlice(
     std::shared_ptr<storage::StorageTransaction>* txn, uint32_t fsId,
     uint64_t inodeId, const VolumeExtentSlice& slice, int64_t logIndex) {
-    WriteLockGuard guard(rwLock_);
+    StripedLockGuard slg(&stripedLock_, inodeId, true);
     if (*txn == nullptr) {
         *txn = kvStorage_->BeginTransaction();
         if (*txn == nullptr) {
@@ -843,7 +1504,7 @@ MetaStatusCode InodeStorage::UpdateVolumeExtentSlice(
 
 MetaStatusCode InodeStorage::GetAllVolumeExtent(
     uint32_t fsId, uint64_t inodeId, VolumeExtentSliceList* extents) {
-    ReadLockGuard guard(rwLock_);
+    StripedLockGuard slg(&stripedLock_, inodeId, false);
     auto key = conv_.SerializeToString(Prefix4InodeVolumeExtent{fsId, inodeId});
     auto iter = kvStorage_->SSeek(table4VolumeExtent_, key);
 
@@ -867,7 +1528,7 @@ MetaStatusCode InodeStorage::GetAllVolumeExtent(
 
 std::shared_ptr<Iterator> InodeStorage::GetAllVolumeExtent(uint32_t fsId,
                                                            uint64_t inodeId) {
-    ReadLockGuard guard(rwLock_);
+    StripedLockGuard slg(&stripedLock_, inodeId, false);
     auto key = conv_.SerializeToString(Prefix4InodeVolumeExtent{fsId, inodeId});
     return kvStorage_->SSeek(table4VolumeExtent_, key);
 }
@@ -876,7 +1537,7 @@ MetaStatusCode InodeStorage::GetVolumeExtentByOffset(uint32_t fsId,
                                                      uint64_t inodeId,
                                                      uint64_t offset,
                                                      VolumeExtentSlice* slice) {
-    ReadLockGuard guard(RWLock);
+    StripedLockGuard slg(&stripedLock_, inodeId, false);
     auto key =
         conv_.SerializeToString(Key4VolumeExtentSlice{fsId, inodeId, offset});
 
@@ -919,6 +1580,7 @@ MetaStatusCode InodeStorage::GetAllBlockGroup(
 
 MetaStatusCode InodeStorage::UpdateDeallocatableBlockGroup(
     uint32_t fsId, const DeallocatableBlockGroupVec& update, int64_t logIndex) {
+    LockGuard lg(writeLock_);
     auto txn = kvStorage_->BeginTransaction();
 
     MetaStatusCode st = MetaStatusCode::OK;
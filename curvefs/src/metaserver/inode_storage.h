@@ -23,6 +23,10 @@
 #ifndef CURVEFS_SRC_METASERVER_INODE_STORAGE_H_
 #define CURVEFS_SRC_METASERVER_INODE_STORAGE_H_
 
+#include <gflags/gflags.h>
+#include <gtest/gtest_prod.h>
+
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -37,15 +41,21 @@
 #include "absl/container/btree_map.h"
 #include "absl/container/btree_set.h"
 #include "curvefs/proto/metaserver.pb.h"
+#include "curvefs/src/metaserver/common/striped_lock.h"
 #include "curvefs/src/metaserver/storage/converter.h"
 #include "curvefs/src/metaserver/storage/status.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/utils.h"
+#include "src/common/concurrent/concurrent.h"
 #include "src/common/concurrent/rw_lock.h"
 
+DECLARE_uint32(s3chunkinfo_merge_lists);
+DECLARE_uint32(inode_delta_merge_count);
+
 namespace curvefs {
 namespace metaserver {
 
+using ::curve::common::Mutex;
 using ::curve::common::RWLock;
 using ::curvefs::metaserver::storage::Converter;
 using ::curvefs::metaserver::storage::Iterator;
@@ -123,13 +133,25 @@ class InodeStorage {
                           const Inode& inode, int64_t logIndex,
                           bool inodeDeallocate = false);
 
+    /**
+     * @brief append the change of a directory inode without rewriting it,
+     *        the pending deltas are applied on read, and merged into the
+     *        inode once their number reaches FLAGS_inode_delta_merge_count.
+     *        Appendings of one inode can run at the same time
+     * @param[in] delta: the change of nlink, mtime and ctime
+     * @param[in] logIndex: the index of raft log
+     * @return If inode not exist, return NOT_FOUND
+     */
+    MetaStatusCode AppendInodeDelta(uint32_t fsId, uint64_t inodeId,
+                                    const InodeDelta& delta, int64_t logIndex);
+
+    // NOTE: the pending deltas of directory inodes are applied
     std::shared_ptr<Iterator> GetAllInode();
 
     bool GetAllInodeId(std::list<uint64_t>* ids);
 
-    // NOTE: the return size is accurate under normal cluster status,
-    // but under abnormal status, the return size maybe less than
-    // the real value for delete the unexist inode multi-times.
+    // NOTE: the inode count is maintained in the same transaction with
+    // the inode table and persisted, so it's O(1) and accurate.
     size_t Size();
 
     bool Empty();
@@ -148,13 +170,25 @@ class InodeStorage {
         uint64_t inodeId, uint64_t chunkIndex, const S3ChunkInfoList* list2add,
         const S3ChunkInfoList* list2del, int64_t logIndex);
 
+    // only chunk infos overlapped with [offset, offset + length) are
+    // padded if |length| isn't 0
     MetaStatusCode PaddingInodeS3ChunkInfo(int32_t fsId, uint64_t inodeId,
                                            S3ChunkInfoMap* m,
-                                           uint64_t limit = 0);
+                                           uint64_t limit = 0,
+                                           uint64_t offset = 0,
+                                           uint64_t length = 0);
 
+    // the iterators of s3chunkinfo lists yield unpacked S3ChunkInfoList
     std::shared_ptr<Iterator> GetInodeS3ChunkInfoList(uint32_t fsId,
                                                       uint64_t inodeId);
 
+    // only chunk infos overlapped with [offset, offset + length) are
+    // yielded, lists out of the range are skipped without being unpacked
+    std::shared_ptr<Iterator> GetInodeS3ChunkInfoList(uint32_t fsId,
+                                                      uint64_t inodeId,
+                                                      uint64_t offset,
+                                                      uint64_t length);
+
     std::shared_ptr<Iterator> GetAllS3ChunkInfoList();
 
     // volume extent
@@ -187,13 +221,14 @@ class InodeStorage {
     MetaStatusCode GetAllBlockGroup(
         std::vector<DeallocatableBlockGroup>* deallocatableBlockGroupVec);
 
+    // return the number of s3chunkinfos of inode, or uint64_t max on error
+    uint64_t GetInodeS3MetaSize(uint32_t fsId, uint64_t inodeId);
+
  private:
     MetaStatusCode UpdateInodeS3MetaSize(Transaction txn, uint32_t fsId,
                                          uint64_t inodeId, uint64_t size4add,
                                          uint64_t size4del);
 
-    uint64_t GetInodeS3MetaSize(uint32_t fsId, uint64_t inodeId);
-
     MetaStatusCode DelS3ChunkInfoList(Transaction txn, uint32_t fsId,
                                       uint64_t inodeId, uint64_t chunkIndex,
                                       const S3ChunkInfoList* list2del);
@@ -202,6 +237,17 @@ class InodeStorage {
                                       uint64_t inodeId, uint64_t chunkIndex,
                                       const S3ChunkInfoList* list2add);
 
+    MetaStatusCode PutS3ChunkInfoList(storage::BaseStorage* storage,
+                                      uint32_t fsId, uint64_t inodeId,
+                                      uint64_t chunkIndex,
+                                      const S3ChunkInfoList& list,
+                                      bool merged);
+
+    MetaStatusCode MergeS3ChunkInfoList(storage::BaseStorage* storage,
+                                        uint32_t fsId, uint64_t inodeId,
+                                        uint64_t chunkIndex,
+                                        S3ChunkInfoList* merged);
+
     MetaStatusCode Increase(Transaction txn, uint32_t fsId,
                             const IncreaseDeallocatableBlockGroup& increase,
                             DeallocatableBlockGroup* out);
@@ -212,6 +258,28 @@ class InodeStorage {
     MetaStatusCode Mark(const MarkDeallocatableBlockGroup& mark,
                         DeallocatableBlockGroup* out);
 
+    // sum up the pending deltas of inode, and return the keys of them
+    MetaStatusCode GetInodeDelta(storage::BaseStorage* storage,
+                                 const Key4Inode& key, InodeDelta* delta,
+                                 std::vector<std::string>* keys);
+
+    // apply the pending deltas if the inode is a directory
+    // REQUIRES: the stripe of inode is locked
+    MetaStatusCode ApplyInodeDelta(storage::BaseStorage* storage,
+                                   const Key4Inode& key, Inode* inode);
+
+    // merge the pending deltas into inode and drop them
+    MetaStatusCode MergeInodeDelta(const Key4Inode& key);
+
+    // drop the pending deltas, the inode is overwritten or deleted
+    MetaStatusCode DelInodeDelta(storage::StorageTransaction* transaction,
+                                 const Key4Inode& key);
+
+    // rebuild |deltaInodes_| from the delta table
+    bool LoadDeltaInodes();
+
+    bool HasInodeDelta(uint64_t inodeId);
+
     storage::Status SetAppliedIndex(storage::StorageTransaction* transaction,
                                     int64_t index);
 
@@ -219,6 +287,11 @@ class InodeStorage {
 
     storage::Status GetInodeCount(std::size_t* count);
 
+    storage::Status RecoverInodeCount(std::size_t* count);
+
+    // rewrite keys in all tables which aren't in current key format
+    bool MigrateKeyFormat();
+
     storage::Status SetInodeCount(storage::StorageTransaction* transaction,
                                   std::size_t count);
 
@@ -231,10 +304,23 @@ class InodeStorage {
                                    const Key4Inode& key);
 
  private:
-    // FIXME: please remove this lock, because we has locked each inode
-    // in inode manager, this lock only for proetct storage, but now we
-    // use rocksdb storage, it support write in parallel.
-    RWLock rwLock_;
+    // NOTE: the tables of the same inode are protected by the striped lock
+    // between readers and writers, mutations of one inode only take its
+    // stripe exclusively, except appending deltas, which are commutative
+    // and only take it shared. The mutations which change the inode count or
+    // the deallocatable block groups, which are shared by all inodes, are
+    // also serialized by `writeLock_`, readers never take it. Mutations of
+    // different inodes are applied in parallel, so the applied index may be
+    // written out of log order, it's only used to skip the logs which are
+    // already in the checkpoint on replay, and the checkpoint is taken
+    // after all applying logs finished.
+    Mutex writeLock_;
+    StripedRWLock stripedLock_;
+    // whether the iterator of storage reads from a snapshot
+    bool snapshotIterator_;
+    // whether the storage can be written by multiple threads at the same
+    // time, the containers of memory storage can't
+    bool concurrentWrite_;
     std::shared_ptr<KVStorage> kvStorage_;
     std::string table4Inode_;
     std::string table4S3ChunkInfo_;
@@ -244,12 +330,21 @@ class InodeStorage {
     std::string table4DeallocatableInode_;
     std::string table4AppliedIndex_;
     std::string table4InodeCount_;
-
-    size_t nInode_;
+    std::string table4InodeDelta_;
+
+    std::atomic<size_t> nInode_;
+    // directory inodes which may have pending deltas and the number of them,
+    // so reading the others needn't seek the delta table, and the deltas are
+    // merged once the number reaches FLAGS_inode_delta_merge_count.
+    // It's rebuilt from the delta table on init
+    RWLock deltaInodesLock_;
+    std::unordered_map<uint64_t, uint32_t> deltaInodes_;
     Converter conv_;
 
     static const char* kInodeCountKey;
     static const char* kInodeAppliedKey;
+
+    FRIEND_TEST(InodeStorageTest, ConcurrentAppendInodeDelta);
 };
 
 }  // namespace metaserver
@@ -36,7 +36,9 @@
 #include "curvefs/src/metaserver/register.h"
 #include "curvefs/src/metaserver/s3compact_manager.h"
 #include "curvefs/src/metaserver/trash_manager.h"
+#include "curvefs/src/metaserver/storage/converter.h"
 #include "curvefs/src/metaserver/storage/storage.h"
+#include "curvefs/src/metaserver/storage/dumpfile.h"
 #include "curvefs/src/metaserver/storage/rocksdb_perf.h"
 #include "curvefs/src/metaserver/mds/fsinfo_manager.h"
 #include "src/common/crc32.h"
@@ -633,12 +635,33 @@ void Metaserver::InitStorage() {
     LOG_IF(FATAL, !conf_->GetBoolValue("storage.memory.compression",
                                        &options.compression));
 
+    std::string keyFormat = "text";
+    LOG_IF(WARNING, !conf_->GetStringValue("storage.key_format", &keyFormat))
+        << "Not found `storage.key_format` in conf, use default value `"
+        << keyFormat << '`';
+    storage::KeyFormat format;
+    LOG_IF(FATAL, !storage::StringToKeyFormat(keyFormat, &format))
+        << "Invalid storage key format: " << keyFormat;
+    storage::SetKeyFormat(format);
+
     conf_->GetValueFatalIfFail("storage.rocksdb.perf_level",
                                &FLAGS_rocksdb_perf_level);
     conf_->GetValueFatalIfFail("storage.rocksdb.perf_slow_us",
                                &FLAGS_rocksdb_perf_slow_us);
     conf_->GetValueFatalIfFail("storage.rocksdb.perf_sampling_ratio",
                                &FLAGS_rocksdb_perf_sampling_ratio);
+    LOG_IF(WARNING, !conf_->GetBoolValue("storage.dumpfile.sections",
+                                         &FLAGS_dumpfile_sections))
+        << "Not found `storage.dumpfile.sections` in conf, "
+        << "use default value `" << FLAGS_dumpfile_sections << '`';
+    LOG_IF(WARNING, !conf_->GetUInt32Value("storage.dumpfile.threads",
+                                           &FLAGS_dumpfile_threads))
+        << "Not found `storage.dumpfile.threads` in conf, use default value `"
+        << FLAGS_dumpfile_threads << '`';
+    LOG_IF(WARNING, !conf_->GetBoolValue("storage.dumpfile.compression",
+                                         &FLAGS_dumpfile_compression))
+        << "Not found `storage.dumpfile.compression` in conf, "
+        << "use default value `" << FLAGS_dumpfile_compression << '`';
     LOG_IF(FATAL, !conf_->GetUInt64Value(
         "storage.s3_meta_inside_inode.limit_size",
         &options.s3MetaLimitSizeInsideInode));
@@ -44,12 +44,14 @@ using ::curvefs::metaserver::copyset::CreateInodeOperator;
 using ::curvefs::metaserver::copyset::CreateRootInodeOperator;
 using ::curvefs::metaserver::copyset::CreateManageInodeOperator;
 using ::curvefs::metaserver::copyset::UpdateInodeOperator;
+using ::curvefs::metaserver::copyset::BatchUpdateInodeOperator;
 using ::curvefs::metaserver::copyset::GetOrModifyS3ChunkInfoOperator;
 using ::curvefs::metaserver::copyset::DeleteInodeOperator;
 using ::curvefs::metaserver::copyset::UpdateInodeS3VersionOperator;
 using ::curvefs::metaserver::copyset::CreatePartitionOperator;
 using ::curvefs::metaserver::copyset::DeletePartitionOperator;
 using ::curvefs::metaserver::copyset::PrepareRenameTxOperator;
+using ::curvefs::metaserver::copyset::RenameDentryOperator;
 using ::curvefs::metaserver::copyset::GetVolumeExtentOperator;
 using ::curvefs::metaserver::copyset::UpdateVolumeExtentOperator;
 using ::curvefs::metaserver::copyset::UpdateDeallocatableBlockGroupOperator;
@@ -224,6 +226,17 @@ void MetaServerServiceImpl::UpdateInode(
                                            request->copysetid());
 }
 
+void MetaServerServiceImpl::BatchUpdateInode(
+    ::google::protobuf::RpcController* controller,
+    const ::curvefs::metaserver::BatchUpdateInodeRequest* request,
+    ::curvefs::metaserver::BatchUpdateInodeResponse* response,
+    ::google::protobuf::Closure* done) {
+    OperatorHelper helper(copysetNodeManager_, inflightThrottle_);
+    helper.operator()<BatchUpdateInodeOperator>(controller, request, response,
+                                                done, request->poolid(),
+                                                request->copysetid());
+}
+
 void MetaServerServiceImpl::GetOrModifyS3ChunkInfo(
     ::google::protobuf::RpcController* controller,
     const ::curvefs::metaserver::GetOrModifyS3ChunkInfoRequest* request,
@@ -277,6 +290,16 @@ void MetaServerServiceImpl::PrepareRenameTx(
                                                request->copysetid());
 }
 
+void MetaServerServiceImpl::RenameDentry(
+    google::protobuf::RpcController* controller,
+    const RenameDentryRequest* request, RenameDentryResponse* response,
+    google::protobuf::Closure* done) {
+    OperatorHelper helper(copysetNodeManager_, inflightThrottle_);
+    helper.operator()<RenameDentryOperator>(controller, request, response,
+                                            done, request->poolid(),
+                                            request->copysetid());
+}
+
 void MetaServerServiceImpl::GetVolumeExtent(
     ::google::protobuf::RpcController* controller,
     const GetVolumeExtentRequest* request,
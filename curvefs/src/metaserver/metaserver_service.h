@@ -88,6 +88,11 @@ class MetaServerServiceImpl : public MetaServerService {
                      const ::curvefs::metaserver::UpdateInodeRequest* request,
                      ::curvefs::metaserver::UpdateInodeResponse* response,
                      ::google::protobuf::Closure* done) override;
+    void BatchUpdateInode(
+        ::google::protobuf::RpcController* controller,
+        const ::curvefs::metaserver::BatchUpdateInodeRequest* request,
+        ::curvefs::metaserver::BatchUpdateInodeResponse* response,
+        ::google::protobuf::Closure* done) override;
     void GetOrModifyS3ChunkInfo(
         ::google::protobuf::RpcController* controller,
         const ::curvefs::metaserver::GetOrModifyS3ChunkInfoRequest* request,
@@ -113,6 +118,11 @@ class MetaServerServiceImpl : public MetaServerService {
                          PrepareRenameTxResponse* response,
                          google::protobuf::Closure* done) override;
 
+    void RenameDentry(google::protobuf::RpcController* controller,
+                      const RenameDentryRequest* request,
+                      RenameDentryResponse* response,
+                      google::protobuf::Closure* done) override;
+
     void GetVolumeExtent(::google::protobuf::RpcController* controller,
                          const GetVolumeExtentRequest* request,
                          GetVolumeExtentResponse* response,
@@ -66,6 +66,7 @@ using ::curvefs::metaserver::storage::StorageOptions;
 namespace {
 const char *const kMetaDataFilename = "metadata";
 bvar::LatencyRecorder g_storage_checkpoint_latency("storage_checkpoint");
+bvar::LatencyRecorder g_storage_save_meta_latency("storage_save_meta");
 }  // namespace
 
 std::unique_ptr<MetaStoreImpl>
@@ -170,26 +171,75 @@ void MetaStoreImpl::SaveBackground(const std::string &path,
 
 bool MetaStoreImpl::SaveMeta(const std::string& dir,
                              std::vector<std::string>* files) {
-    // NOTE: we will keep meta fstream consistent with
-    // snapshot metadata, so we should hold the locks
-    // during `fstream.Save()`
-    WriteLockGuard writeLockGuard(rwLock_);
-    MetaStoreFStream fstream(&partitionMap_, kvStorage_,
-                             copysetNode_->GetPoolId(),
-                             copysetNode_->GetCopysetId());
+    butil::Timer timer;
+    timer.start();
 
-    const std::string metadata = dir + "/" + kMetaDataFilename;
-    if (fstream.Save(metadata)) {
-        files->push_back(kMetaDataFilename);
-        return true;
+    // NOTE: the state machine is paused now, so we only capture what the
+    // snapshot contains here and serialize it in `SaveData()` off the state
+    // machine thread:
+    //   1. a copy of the partition info, which is taken under the read lock,
+    //      so requests on this copyset are not blocked
+    //   2. a point-in-time view of storage, because the checkpoint must not
+    //      contain entries newer than the snapshot index: the partition info
+    //      is taken at the snapshot index, and an operation which spans more
+    //      than one transaction may be half applied in a newer checkpoint,
+    //      the applied index can't tell which part to skip on replay
+    std::shared_ptr<Iterator> partitions;
+    {
+        ReadLockGuard readLockGuard(rwLock_);
+        MetaStoreFStream fstream(&partitionMap_, kvStorage_,
+                                 copysetNode_->GetPoolId(),
+                                 copysetNode_->GetCopysetId());
+        partitions = fstream.NewPartitionIterator();
+    }
+    if (nullptr == partitions) {
+        LOG(ERROR) << "Failed to copy partitions of metastore";
+        return false;
     }
-    return false;
+
+    if (!kvStorage_->PrepareCheckpoint(dir)) {
+        LOG(ERROR) << "Failed to prepare storage checkpoint";
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(pendingMetaMutex_);
+        pendingMetaDir_ = dir;
+        pendingMeta_ = std::move(partitions);
+    }
+    files->push_back(kMetaDataFilename);
+
+    timer.stop();
+    g_storage_save_meta_latency << timer.u_elapsed();
+    return true;
 }
 
 bool MetaStoreImpl::SaveData(const std::string& dir,
                              std::vector<std::string>* files) {
     butil::Timer timer;
     timer.start();
+
+    std::shared_ptr<Iterator> partitions;
+    {
+        std::lock_guard<std::mutex> lk(pendingMetaMutex_);
+        if (pendingMetaDir_ == dir) {
+            partitions = std::move(pendingMeta_);
+            pendingMetaDir_.clear();
+        }
+    }
+    if (nullptr == partitions) {
+        LOG(ERROR) << "Metadata of `" << dir << "` isn't saved by SaveMeta()";
+        return false;
+    }
+
+    MetaStoreFStream fstream(&partitionMap_, kvStorage_,
+                             copysetNode_->GetPoolId(),
+                             copysetNode_->GetCopysetId());
+    const std::string metadata = dir + "/" + kMetaDataFilename;
+    if (!fstream.Save(metadata, std::move(partitions))) {
+        return false;
+    }
+
     std::vector<std::string> tmp;
     bool succ = kvStorage_->Checkpoint(dir, &tmp);
     if (!succ) {
@@ -491,6 +541,28 @@ MetaStatusCode MetaStoreImpl::PrepareRenameTx(
     return rc;
 }
 
+MetaStatusCode MetaStoreImpl::RenameDentry(const RenameDentryRequest* request,
+                                           RenameDentryResponse* response,
+                                           int64_t logIndex) {
+    ReadLockGuard readLockGuard(rwLock_);
+    std::shared_ptr<Partition> partition;
+    GET_PARTITION_OR_RETURN(partition);
+
+    std::shared_ptr<Partition> dstPartition = partition;
+    if (request->dstpartitionid() != request->partitionid()) {
+        dstPartition = GetPartition(request->dstpartitionid());
+        if (dstPartition == nullptr) {
+            response->set_statuscode(MetaStatusCode::PARTITION_NOT_FOUND);
+            return MetaStatusCode::PARTITION_NOT_FOUND;
+        }
+    }
+
+    auto rc = partition->RenameDentry(request->srcdentry(), dstPartition.get(),
+                                      request->dstdentry(), logIndex);
+    response->set_statuscode(rc);
+    return rc;
+}
+
 // inode
 MetaStatusCode MetaStoreImpl::CreateInode(const CreateInodeRequest* request,
                                           CreateInodeResponse* response,
@@ -731,6 +803,31 @@ MetaStatusCode MetaStoreImpl::UpdateInode(const UpdateInodeRequest* request,
     return status;
 }
 
+MetaStatusCode MetaStoreImpl::BatchUpdateInode(
+    const BatchUpdateInodeRequest* request, BatchUpdateInodeResponse* response,
+    int64_t logIndex) {
+    ReadLockGuard readLockGuard(rwLock_);
+    VLOG(9) << "BatchUpdateInode, partitionid: " << request->partitionid()
+            << ", size: " << request->updates_size();
+    std::shared_ptr<Partition> partition;
+    GET_PARTITION_OR_RETURN(partition);
+
+    // the whole batch is applied in one transaction, since it shares one
+    // log index. Failure of one inode (e.g. it has been deleted) doesn't
+    // affect the others in the same batch
+    std::vector<MetaStatusCode> statuses;
+    MetaStatusCode status =
+        partition->BatchUpdateInode(*request, &statuses, logIndex);
+    if (status == MetaStatusCode::OK) {
+        for (const auto& item : statuses) {
+            response->add_statuses(item);
+        }
+    }
+
+    response->set_statuscode(status);
+    return status;
+}
+
 MetaStatusCode MetaStoreImpl::GetOrModifyS3ChunkInfo(
     const GetOrModifyS3ChunkInfoRequest* request,
     GetOrModifyS3ChunkInfoResponse* response,
@@ -742,13 +839,17 @@ MetaStatusCode MetaStoreImpl::GetOrModifyS3ChunkInfo(
 
     uint32_t fsId = request->fsid();
     uint64_t inodeId = request->inodeid();
+    // length 0 means the whole file
+    uint64_t offset = request->offset();
+    uint64_t length = request->length();
     rc = partition->GetOrModifyS3ChunkInfo(
         fsId, inodeId, request->s3chunkinfoadd(), request->s3chunkinforemove(),
-        request->returns3chunkinfomap(), iterator, logIndex);
+        request->returns3chunkinfomap(), iterator, logIndex, offset, length);
     if (rc == MetaStatusCode::OK && !request->supportstreaming() &&
         request->returns3chunkinfomap()) {
         rc = partition->PaddingInodeS3ChunkInfo(
-            fsId, inodeId, response->mutable_s3chunkinfomap(), 0);
+            fsId, inodeId, response->mutable_s3chunkinfomap(), 0, offset,
+            length);
     }
 
     response->set_statuscode(rc);
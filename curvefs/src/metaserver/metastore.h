@@ -28,6 +28,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -66,6 +67,8 @@ using curvefs::metaserver::CreateInodeRequest;
 using curvefs::metaserver::CreateInodeResponse;
 using curvefs::metaserver::UpdateInodeRequest;
 using curvefs::metaserver::UpdateInodeResponse;
+using curvefs::metaserver::BatchUpdateInodeRequest;
+using curvefs::metaserver::BatchUpdateInodeResponse;
 using curvefs::metaserver::DeleteInodeRequest;
 using curvefs::metaserver::DeleteInodeResponse;
 using curvefs::metaserver::CreateRootInodeRequest;
@@ -155,6 +158,10 @@ class MetaStore {
         const PrepareRenameTxRequest* request,
         PrepareRenameTxResponse* response, int64_t logIndex) = 0;
 
+    virtual MetaStatusCode RenameDentry(const RenameDentryRequest* request,
+                                        RenameDentryResponse* response,
+                                        int64_t logIndex) = 0;
+
     // inode
     virtual MetaStatusCode CreateInode(const CreateInodeRequest* request,
                                        CreateInodeResponse* response,
@@ -188,6 +195,10 @@ class MetaStore {
                                        UpdateInodeResponse* response,
                                        int64_t logIndex) = 0;
 
+    virtual MetaStatusCode BatchUpdateInode(
+        const BatchUpdateInodeRequest* request,
+        BatchUpdateInodeResponse* response, int64_t logIndex) = 0;
+
     virtual MetaStatusCode GetOrModifyS3ChunkInfo(
         const GetOrModifyS3ChunkInfoRequest* request,
         GetOrModifyS3ChunkInfoResponse* response,
@@ -261,6 +272,10 @@ class MetaStoreImpl : public MetaStore {
                                    PrepareRenameTxResponse* response,
                                    int64_t logIndex) override;
 
+    MetaStatusCode RenameDentry(const RenameDentryRequest* request,
+                                RenameDentryResponse* response,
+                                int64_t logIndex) override;
+
     // inode
     MetaStatusCode CreateInode(const CreateInodeRequest* request,
                                CreateInodeResponse* response,
@@ -294,6 +309,10 @@ class MetaStoreImpl : public MetaStore {
                                UpdateInodeResponse* response,
                                int64_t logIndex) override;
 
+    MetaStatusCode BatchUpdateInode(const BatchUpdateInodeRequest* request,
+                                    BatchUpdateInodeResponse* response,
+                                    int64_t logIndex) override;
+
     std::shared_ptr<Partition> GetPartition(uint32_t partitionId);
 
     MetaStatusCode GetOrModifyS3ChunkInfo(
@@ -359,6 +378,11 @@ class MetaStoreImpl : public MetaStore {
 
     copyset::CopysetNode* copysetNode_;
 
+    // partitions captured by `SaveMeta()` and saved by `SaveData()`
+    std::mutex pendingMetaMutex_;
+    std::string pendingMetaDir_;
+    std::shared_ptr<Iterator> pendingMeta_;
+
     std::shared_ptr<StreamServer> streamServer_;
 
     storage::StorageOptions storageOptions_;
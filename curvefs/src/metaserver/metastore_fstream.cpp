@@ -286,5 +286,23 @@ bool MetaStoreFStream::Save(const std::string &path, DumpFileClosure *done) {
     return succ;
 }
 
+bool MetaStoreFStream::Save(const std::string &path,
+                            std::shared_ptr<Iterator> partitions) {
+    if (nullptr == partitions) {
+        return false;
+    }
+
+    ChildrenType children{std::move(partitions)};
+    auto mergeIterator = std::make_shared<MergeIterator>(children);
+    bool succ = SaveToFile(path, mergeIterator, /*background*/ false);
+    if (succ) {
+        LOG(INFO) << "MetaStoreFStream save success";
+    } else {
+        LOG(ERROR) << "MetaStoreFStream save failed";
+    }
+
+    return succ;
+}
+
 }  // namespace metaserver
 }  // namespace curvefs
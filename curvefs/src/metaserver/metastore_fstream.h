@@ -56,6 +56,13 @@ class MetaStoreFStream {
     bool Save(const std::string& path,
               DumpFileClosure* done = nullptr);
 
+    // Save partitions captured by `NewPartitionIterator()` before, it's
+    // written in the calling thread because the iterator owns a copy
+    bool Save(const std::string& path, std::shared_ptr<Iterator> partitions);
+
+    // Copy the info of all partitions, return nullptr on failure
+    std::shared_ptr<Iterator> NewPartitionIterator();
+
  private:
     bool LoadPartition(uint32_t partitionId,
                        const std::string& key,
@@ -65,8 +72,6 @@ class MetaStoreFStream {
                        const std::string& key,
                        const std::string& value);
 
-    std::shared_ptr<Iterator> NewPartitionIterator();
-
     std::shared_ptr<Iterator> NewInodeIterator(
         std::shared_ptr<Partition> partition);
 
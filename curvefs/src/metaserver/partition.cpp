@@ -29,6 +29,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include <future>
 
 #include "curvefs/proto/metaserver.pb.h"
@@ -211,6 +212,35 @@ MetaStatusCode Partition::HandleRenameTx(const std::vector<Dentry>& dentrys,
     return dentryManager_->HandleRenameTx(dentrys, logIndex);
 }
 
+MetaStatusCode Partition::RenameDentry(const Dentry& srcDentry,
+                                       Partition* dstPartition,
+                                       const Dentry& dstDentry,
+                                       int64_t logIndex) {
+    PRECHECK(srcDentry.fsid(), srcDentry.parentinodeid());
+    if (!dstPartition->IsInodeBelongs(dstDentry.fsid(),
+                                      dstDentry.parentinodeid())) {
+        return MetaStatusCode::PARTITION_ID_MISSMATCH;
+    }
+    if (dstPartition->GetStatus() == PartitionStatus::DELETING) {
+        return MetaStatusCode::PARTITION_DELETING;
+    }
+
+    // NOTE: the pending tx will be committed or rolled back later,
+    // the dentrys it touched should be renamed by transaction too
+    std::vector<Dentry> dentrys{srcDentry, dstDentry};
+    if (txManager_->IsPendingTxConflict(dentrys) ||
+        dstPartition->txManager_->IsPendingTxConflict(dentrys)) {
+        return MetaStatusCode::HANDLE_PENDING_TX_FAILED;
+    }
+
+    auto rc = dentryManager_->RenameDentry(
+        srcDentry, dstPartition->dentryManager_.get(), dstDentry, logIndex);
+    if (rc == MetaStatusCode::IDEMPOTENCE_OK) {
+        rc = MetaStatusCode::OK;
+    }
+    return rc;
+}
+
 bool Partition::InsertPendingTx(const PrepareRenameTxRequest& pendingTx) {
     std::vector<Dentry> dentrys{pendingTx.dentrys().begin(),
                                 pendingTx.dentrys().end()};
@@ -339,14 +369,51 @@ MetaStatusCode Partition::UpdateInode(const UpdateInodeRequest& request,
     return ret;
 }
 
+MetaStatusCode Partition::BatchUpdateInode(
+    const BatchUpdateInodeRequest& request,
+    std::vector<MetaStatusCode>* statuses, int64_t logIndex) {
+    if (GetStatus() == PartitionStatus::DELETING) {
+        return MetaStatusCode::PARTITION_DELETING;
+    }
+
+    // updates not belong to this partition are rejected one by one,
+    // the others are applied together
+    std::vector<const UpdateInodeRequest*> updates;
+    statuses->assign(request.updates_size(),
+                     MetaStatusCode::PARTITION_ID_MISSMATCH);
+    for (const auto& update : request.updates()) {
+        if (update.partitionid() == request.partitionid() &&
+            IsInodeBelongs(update.fsid(), update.inodeid())) {
+            updates.push_back(&update);
+        }
+    }
+
+    std::vector<MetaStatusCode> results;
+    auto ret = inodeManager_->BatchUpdateInode(updates, &results, logIndex);
+    if (ret == MetaStatusCode::IDEMPOTENCE_OK) {
+        results.assign(updates.size(), MetaStatusCode::OK);
+    } else if (ret != MetaStatusCode::OK) {
+        return ret;
+    }
+
+    size_t next = 0;
+    for (int i = 0; i < request.updates_size(); i++) {
+        if (next < updates.size() && updates[next] == &request.updates(i)) {
+            (*statuses)[i] = results[next++];
+        }
+    }
+    return MetaStatusCode::OK;
+}
+
 MetaStatusCode Partition::GetOrModifyS3ChunkInfo(
     uint32_t fsId, uint64_t inodeId, const S3ChunkInfoMap& map2add,
     const S3ChunkInfoMap& map2del, bool returnS3ChunkInfoMap,
-    std::shared_ptr<Iterator>* iterator, int64_t logIndex) {
+    std::shared_ptr<Iterator>* iterator, int64_t logIndex, uint64_t offset,
+    uint64_t length) {
     PRECHECK(fsId, inodeId);
     auto ret = inodeManager_->GetOrModifyS3ChunkInfo(
         fsId, inodeId, map2add, map2del, returnS3ChunkInfoMap, iterator,
-        logIndex);
+        logIndex, offset, length);
     if (ret == MetaStatusCode::IDEMPOTENCE_OK) {
         ret = MetaStatusCode::OK;
     }
@@ -356,9 +423,12 @@ MetaStatusCode Partition::GetOrModifyS3ChunkInfo(
 MetaStatusCode Partition::PaddingInodeS3ChunkInfo(int32_t fsId,
                                                   uint64_t inodeId,
                                                   S3ChunkInfoMap* m,
-                                                  uint64_t limit) {
+                                                  uint64_t limit,
+                                                  uint64_t offset,
+                                                  uint64_t length) {
     PRECHECK(fsId, inodeId);
-    return inodeManager_->PaddingInodeS3ChunkInfo(fsId, inodeId, m, limit);
+    return inodeManager_->PaddingInodeS3ChunkInfo(fsId, inodeId, m, limit,
+                                                  offset, length);
 }
 
 bool Partition::GetInodeIdList(std::list<uint64_t>* InodeIdList) {
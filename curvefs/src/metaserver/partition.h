@@ -78,6 +78,12 @@ class Partition {
     MetaStatusCode HandleRenameTx(const std::vector<Dentry>& dentrys,
                                   int64_t logIndex);
 
+    // rename |srcDentry| in this partition to |dstDentry| in |dstPartition|
+    // atomically, both partitions must be in the same copyset
+    MetaStatusCode RenameDentry(const Dentry& srcDentry,
+                                Partition* dstPartition,
+                                const Dentry& dstDentry, int64_t logIndex);
+
     bool InsertPendingTx(const PrepareRenameTxRequest& pendingTx);
 
     bool FindPendingTx(PrepareRenameTxRequest* pendingTx);
@@ -109,16 +115,25 @@ class Partition {
     MetaStatusCode UpdateInode(const UpdateInodeRequest& request,
                                int64_t logIndex);
 
+    // |statuses| holds the result of each update in |request|
+    MetaStatusCode BatchUpdateInode(const BatchUpdateInodeRequest& request,
+                                    std::vector<MetaStatusCode>* statuses,
+                                    int64_t logIndex);
+
     MetaStatusCode GetOrModifyS3ChunkInfo(uint32_t fsId, uint64_t inodeId,
                                           const S3ChunkInfoMap& map2add,
                                           const S3ChunkInfoMap& map2del,
                                           bool returnS3ChunkInfoMap,
                                           std::shared_ptr<Iterator>* iterator,
-                                          int64_t logIndex);
+                                          int64_t logIndex,
+                                          uint64_t offset = 0,
+                                          uint64_t length = 0);
 
     MetaStatusCode PaddingInodeS3ChunkInfo(int32_t fsId, uint64_t inodeId,
                                            S3ChunkInfoMap* m,
-                                           uint64_t limit = 0);
+                                           uint64_t limit = 0,
+                                           uint64_t offset = 0,
+                                           uint64_t length = 0);
 
     MetaStatusCode UpdateVolumeExtent(uint32_t fsId, uint64_t inodeId,
                                       const VolumeExtentSliceList& extents,
@@ -0,0 +1,320 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/metaserver/s3chunkinfo_codec.h"
+
+#include <glog/logging.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+static bool pass_bool(const char*, bool) { return true; }
+
+DEFINE_bool(s3chunkinfo_packed, false,
+            "whether to store the s3chunkinfo lists in packed format, "
+            "the lists in it can't be read by older versions");
+DEFINE_validator(s3chunkinfo_packed, &pass_bool);
+
+DEFINE_bool(s3chunkinfo_compression, false,
+            "whether to compress the s3chunkinfo lists stored in metaserver");
+DEFINE_validator(s3chunkinfo_compression, &pass_bool);
+
+namespace curvefs {
+namespace metaserver {
+
+namespace {
+
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::io::CodedOutputStream;
+
+// lists shorter than it are hardly compressible
+constexpr size_t kMinCompressLength = 256;
+
+constexpr uint8_t kFlagZero = 1;
+constexpr uint8_t kFlagSizeEqualLen = 1 << 1;
+
+inline uint64_t ZigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^
+           static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline uint64_t RangeEnd(uint64_t offset, uint64_t length) {
+    return length > std::numeric_limits<uint64_t>::max() - offset
+               ? std::numeric_limits<uint64_t>::max()
+               : offset + length;
+}
+
+void Compress(PackedS3ChunkInfoList* packed) {
+    const std::string& raw = packed->data();
+    uLongf length = compressBound(raw.size());
+    std::string compressed(length, '\0');
+    auto ret = compress2(reinterpret_cast<Bytef*>(&compressed[0]), &length,
+                         reinterpret_cast<const Bytef*>(raw.data()),
+                         raw.size(), Z_BEST_SPEED);
+    // keep the raw data if it's incompressible
+    if (ret == Z_OK && length < raw.size()) {
+        compressed.resize(length);
+        packed->set_data(std::move(compressed));
+        packed->set_compressed(true);
+    }
+}
+
+bool Uncompress(const PackedS3ChunkInfoList& packed, std::string* raw) {
+    uLongf length = packed.rawlength();
+    raw->resize(length);
+    auto ret = uncompress(reinterpret_cast<Bytef*>(&(*raw)[0]), &length,
+                          reinterpret_cast<const Bytef*>(packed.data().data()),
+                          packed.data().size());
+    if (ret != Z_OK || length != packed.rawlength()) {
+        LOG(ERROR) << "Uncompress s3chunkinfo list failed, ret = " << ret;
+        return false;
+    }
+    return true;
+}
+
+// the list stored by older versions is kept in unknown fields
+bool UnpackLegacy(const PackedS3ChunkInfoList& packed, bool filter,
+                  uint64_t offset, uint64_t end, S3ChunkInfoList* list) {
+    std::string value;
+    S3ChunkInfoList legacy;
+    if (!packed.SerializeToString(&value) || !legacy.ParseFromString(value)) {
+        LOG(ERROR) << "Parse legacy s3chunkinfo list failed";
+        return false;
+    }
+    for (auto& info : *legacy.mutable_s3chunks()) {
+        if (!filter ||
+            (info.offset() < end && info.offset() + info.len() > offset)) {
+            list->add_s3chunks()->Swap(&info);
+        }
+    }
+    return true;
+}
+
+bool Unpack(const PackedS3ChunkInfoList& packed, bool filter, uint64_t offset,
+            uint64_t end, S3ChunkInfoList* list) {
+    if (!packed.has_data()) {
+        return UnpackLegacy(packed, filter, offset, end, list);
+    } else if (filter && !(packed.minoffset() < end &&
+                           packed.maxend() > offset)) {
+        return true;
+    }
+
+    std::string raw;
+    const std::string* data = &packed.data();
+    if (packed.compressed()) {
+        if (!Uncompress(packed, &raw)) {
+            return false;
+        }
+        data = &raw;
+    }
+
+    CodedInputStream input(reinterpret_cast<const uint8_t*>(data->data()),
+                           static_cast<int>(data->size()));
+    uint64_t chunkId = 0;
+    uint64_t chunkOffset = 0;
+    list->mutable_s3chunks()->Reserve(list->s3chunks_size() + packed.count());
+    for (uint32_t i = 0; i < packed.count(); i++) {
+        uint32_t flags = 0;
+        uint64_t chunkIdDelta = 0;
+        uint64_t compaction = 0;
+        uint64_t offsetDelta = 0;
+        uint64_t len = 0;
+        uint64_t size = 0;
+        if (!input.ReadVarint32(&flags) || !input.ReadVarint64(&chunkIdDelta) ||
+            !input.ReadVarint64(&compaction) ||
+            !input.ReadVarint64(&offsetDelta) || !input.ReadVarint64(&len)) {
+            LOG(ERROR) << "Decode s3chunkinfo list failed, index = " << i;
+            return false;
+        }
+        if (flags & kFlagSizeEqualLen) {
+            size = len;
+        } else if (!input.ReadVarint64(&size)) {
+            LOG(ERROR) << "Decode s3chunkinfo list failed, index = " << i;
+            return false;
+        }
+
+        chunkId += ZigZagDecode(chunkIdDelta);
+        chunkOffset += ZigZagDecode(offsetDelta);
+        if (filter && !(chunkOffset < end && chunkOffset + len > offset)) {
+            continue;
+        }
+
+        auto* info = list->add_s3chunks();
+        info->set_chunkid(chunkId);
+        info->set_compaction(compaction);
+        info->set_offset(chunkOffset);
+        info->set_len(len);
+        info->set_size(size);
+        info->set_zero(flags & kFlagZero);
+    }
+    return true;
+}
+
+}  // namespace
+
+void PackS3ChunkInfoList(const S3ChunkInfoList& list,
+                         PackedS3ChunkInfoList* packed) {
+    packed->Clear();
+
+    // 1 flag byte and at most 6 varints for each chunk info
+    std::string data(list.s3chunks_size() *
+                         (1 + 6 * CodedOutputStream::VarintSize64(
+                                      std::numeric_limits<uint64_t>::max())),
+                     '\0');
+    uint8_t* begin = reinterpret_cast<uint8_t*>(&data[0]);
+    uint8_t* ptr = begin;
+    uint64_t prevChunkId = 0;
+    uint64_t prevOffset = 0;
+    uint64_t minOffset = std::numeric_limits<uint64_t>::max();
+    uint64_t maxEnd = 0;
+    for (const auto& info : list.s3chunks()) {
+        uint8_t flags = 0;
+        if (info.zero()) {
+            flags |= kFlagZero;
+        }
+        if (info.size() == info.len()) {
+            flags |= kFlagSizeEqualLen;
+        }
+
+        ptr = CodedOutputStream::WriteVarint32ToArray(flags, ptr);
+        ptr = CodedOutputStream::WriteVarint64ToArray(
+            ZigZagEncode(info.chunkid() - prevChunkId), ptr);
+        ptr = CodedOutputStream::WriteVarint64ToArray(info.compaction(), ptr);
+        ptr = CodedOutputStream::WriteVarint64ToArray(
+            ZigZagEncode(info.offset() - prevOffset), ptr);
+        ptr = CodedOutputStream::WriteVarint64ToArray(info.len(), ptr);
+        if (!(flags & kFlagSizeEqualLen)) {
+            ptr = CodedOutputStream::WriteVarint64ToArray(info.size(), ptr);
+        }
+
+        prevChunkId = info.chunkid();
+        prevOffset = info.offset();
+        minOffset = std::min(minOffset, info.offset());
+        maxEnd = std::max(maxEnd, info.offset() + info.len());
+    }
+    data.resize(ptr - begin);
+
+    packed->set_count(list.s3chunks_size());
+    packed->set_minoffset(list.s3chunks_size() == 0 ? 0 : minOffset);
+    packed->set_maxend(maxEnd);
+    packed->set_rawlength(data.size());
+    packed->set_compressed(false);
+    packed->set_data(std::move(data));
+    if (FLAGS_s3chunkinfo_compression &&
+        packed->data().size() >= kMinCompressLength) {
+        Compress(packed);
+    }
+}
+
+bool UnpackS3ChunkInfoList(const PackedS3ChunkInfoList& packed,
+                           S3ChunkInfoList* list) {
+    return Unpack(packed, false, 0, 0, list);
+}
+
+bool UnpackS3ChunkInfoList(const PackedS3ChunkInfoList& packed,
+                           uint64_t offset, uint64_t length,
+                           S3ChunkInfoList* list) {
+    return Unpack(packed, true, offset, RangeEnd(offset, length), list);
+}
+
+bool MayOverlap(const PackedS3ChunkInfoList& packed, uint64_t offset,
+                uint64_t length) {
+    if (!packed.has_data()) {
+        return true;
+    }
+    return packed.minoffset() < RangeEnd(offset, length) &&
+           packed.maxend() > offset;
+}
+
+S3ChunkInfoListIterator::S3ChunkInfoListIterator(
+    std::shared_ptr<storage::Iterator> iter)
+    : iter_(std::move(iter)),
+      filter_(false),
+      offset_(0),
+      length_(0),
+      status_(0) {}
+
+S3ChunkInfoListIterator::S3ChunkInfoListIterator(
+    std::shared_ptr<storage::Iterator> iter, uint64_t offset, uint64_t length)
+    : iter_(std::move(iter)),
+      filter_(true),
+      offset_(offset),
+      length_(length),
+      status_(0) {}
+
+void S3ChunkInfoListIterator::SeekToFirst() {
+    status_ = 0;
+    iter_->SeekToFirst();
+    Skip();
+}
+
+void S3ChunkInfoListIterator::Next() {
+    iter_->Next();
+    Skip();
+}
+
+void S3ChunkInfoListIterator::Skip() {
+    for (; iter_->Valid(); iter_->Next()) {
+        if (!iter_->ParseFromValue(&packed_)) {
+            LOG(ERROR) << "Parse s3chunkinfo list failed, key = "
+                       << iter_->Key();
+            status_ = -1;
+            return;
+        } else if (!filter_ || MayOverlap(packed_, offset_, length_)) {
+            return;
+        }
+    }
+}
+
+bool S3ChunkInfoListIterator::Unpack(S3ChunkInfoList* list) const {
+    return filter_ ? UnpackS3ChunkInfoList(packed_, offset_, length_, list)
+                   : UnpackS3ChunkInfoList(packed_, list);
+}
+
+std::string S3ChunkInfoListIterator::Value() {
+    std::string value;
+    S3ChunkInfoList list;
+    if (!Unpack(&list) || !list.SerializeToString(&value)) {
+        status_ = -1;
+    }
+    return value;
+}
+
+bool S3ChunkInfoListIterator::ParseFromValue(storage::ValueType* value) {
+    auto* list = dynamic_cast<S3ChunkInfoList*>(value);
+    if (list == nullptr) {
+        return false;
+    }
+    list->Clear();
+    return Unpack(list);
+}
+
+}  // namespace metaserver
+}  // namespace curvefs
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_S3CHUNKINFO_CODEC_H_
+#define CURVEFS_SRC_METASERVER_S3CHUNKINFO_CODEC_H_
+
+#include <gflags/gflags.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "curvefs/proto/metaserver.pb.h"
+#include "curvefs/src/metaserver/storage/iterator.h"
+
+DECLARE_bool(s3chunkinfo_packed);
+DECLARE_bool(s3chunkinfo_compression);
+
+namespace curvefs {
+namespace metaserver {
+
+// Pack |list| into the storage format, each chunk info is encoded as
+// a flag byte followed by varints of chunk id delta, compaction,
+// offset delta, len and size (omitted if it's equal to len).
+void PackS3ChunkInfoList(const S3ChunkInfoList& list,
+                         PackedS3ChunkInfoList* packed);
+
+// Unpack chunk infos from |packed| and append them to |list|, the list
+// stored by older versions (plain S3ChunkInfoList) is also accepted.
+bool UnpackS3ChunkInfoList(const PackedS3ChunkInfoList& packed,
+                           S3ChunkInfoList* list);
+
+// Same as above, but only chunk infos overlapped with the file range
+// [offset, offset + length) are appended.
+bool UnpackS3ChunkInfoList(const PackedS3ChunkInfoList& packed,
+                           uint64_t offset, uint64_t length,
+                           S3ChunkInfoList* list);
+
+// Whether |packed| may contain chunk infos overlapped with the file range
+// [offset, offset + length), it's decided by the header only.
+bool MayOverlap(const PackedS3ChunkInfoList& packed, uint64_t offset,
+                uint64_t length);
+
+// Wrap the iterator of stored (packed) s3chunkinfo lists, the value it
+// yields is S3ChunkInfoList, so it can be sent to client as is.
+class S3ChunkInfoListIterator : public storage::Iterator {
+ public:
+    explicit S3ChunkInfoListIterator(std::shared_ptr<storage::Iterator> iter);
+
+    // only chunk infos overlapped with [offset, offset + length) are yielded
+    S3ChunkInfoListIterator(std::shared_ptr<storage::Iterator> iter,
+                            uint64_t offset, uint64_t length);
+
+    uint64_t Size() override { return iter_->Size(); }
+
+    bool Valid() override { return status_ == 0 && iter_->Valid(); }
+
+    void SeekToFirst() override;
+
+    void Next() override;
+
+    std::string Key() override { return iter_->Key(); }
+
+    std::string Value() override;
+
+    int Status() override { return status_ != 0 ? status_ : iter_->Status(); }
+
+    bool ParseFromValue(storage::ValueType* value) override;
+
+    void DisablePrefixChecking() override { iter_->DisablePrefixChecking(); }
+
+ private:
+    // parse the current list and skip the lists out of range
+    void Skip();
+
+    bool Unpack(S3ChunkInfoList* list) const;
+
+ private:
+    std::shared_ptr<storage::Iterator> iter_;
+    bool filter_;
+    uint64_t offset_;
+    uint64_t length_;
+    PackedS3ChunkInfoList packed_;
+    int status_;
+};
+
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_S3CHUNKINFO_CODEC_H_
@@ -22,12 +22,16 @@
 
 #include "curvefs/src/metaserver/s3compact_inode.h"
 
+#include <butil/time.h>
+
 #include <algorithm>
+#include <chrono>
 #include <deque>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -36,8 +40,11 @@
 #include "curvefs/src/common/s3util.h"
 #include "curvefs/src/metaserver/copyset/copyset_node_manager.h"
 #include "curvefs/src/metaserver/copyset/meta_operator.h"
+#include "src/common/concurrent/count_down_event.h"
 
 using curve::common::Configuration;
+using curve::common::CountDownEvent;
+using curve::common::GetObjectAsyncContext;
 using curve::common::InitS3AdaptorOptionExceptS3InfoOption;
 using curve::common::S3Adapter;
 using curve::common::S3AdapterOption;
@@ -47,6 +54,16 @@ using curvefs::metaserver::copyset::GetOrModifyS3ChunkInfoOperator;
 namespace curvefs {
 namespace metaserver {
 
+S3CompactMetric::S3CompactMetric()
+    : readBytes("s3compact_read_bytes"),
+      readBps("s3compact_read_bps", &readBytes),
+      writeBytes("s3compact_write_bytes"),
+      writeBps("s3compact_write_bps", &writeBytes),
+      keptBytes("s3compact_kept_bytes"),
+      compactedChunks("s3compact_compacted_chunks"),
+      fragmentsBefore("s3compact_fragments_before"),
+      fragmentsAfter("s3compact_fragments_after"),
+      inodeLatency("s3compact_inode") {}
 
 std::vector<uint64_t> CompactInodeJob::GetNeedCompact(
     const ::google::protobuf::Map<uint64_t, S3ChunkInfoList>& s3chunkinfoMap,
@@ -183,6 +200,11 @@ void CompactInodeJob::GenS3ReadRequests(
         if (curr->zero) {
             reqs->emplace_back(reqIndex++, true, "", 0,
                                curr->end - curr->begin + 1);
+            if (next != validList.end() && curr->end + 1 < next->begin) {
+                // hole, append 0
+                reqs->emplace_back(reqIndex++, true, "", 0,
+                                   next->begin - curr->end - 1);
+            }
             curr = next;
             continue;
         }
@@ -238,10 +260,115 @@ void CompactInodeJob::GenS3ReadRequests(
     // inc compaction
     newCompaction += 1;
     newChunkInfo->newChunkId = newChunkId;
-    newChunkInfo->newOff = validList.front().chunkoff;
+    newChunkInfo->newOff = validList.front().begin;
     newChunkInfo->newCompaction = newCompaction;
 }
 
+void CompactInodeJob::SplitValidList(
+    const std::list<struct Node>& validList, uint64_t blockSize,
+    std::vector<std::list<struct Node>>* runs, S3ChunkInfoList* kept) {
+    auto keep = [&](const struct Node& node) {
+        auto info = kept->add_s3chunks();
+        info->set_chunkid(node.chunkid);
+        info->set_compaction(node.compaction);
+        info->set_offset(node.begin);
+        info->set_len(node.end - node.begin + 1);
+        info->set_size(node.end - node.begin + 1);
+        info->set_zero(node.zero);
+    };
+    auto whole = [](const struct Node& node) {
+        return node.begin == node.chunkoff &&
+               node.end + 1 == node.chunkoff + node.chunklen;
+    };
+
+    std::list<struct Node> run;
+    auto finishRun = [&]() {
+        if (run.empty()) {
+            return;
+        }
+        if (run.size() == 1 && !run.front().zero && whole(run.front())) {
+            // rewriting a single s3chunkinfo makes no sense
+            keep(run.front());
+        } else {
+            runs->emplace_back(std::move(run));
+        }
+        run.clear();
+    };
+
+    for (const auto& node : validList) {
+        uint64_t len = node.end - node.begin + 1;
+        // a zero extent or an intact s3chunkinfo which is not smaller than a
+        // block is good enough for readers, only fragments around are merged
+        if (len >= blockSize && (node.zero || whole(node))) {
+            finishRun();
+            keep(node);
+            continue;
+        }
+        // large hole reads as zero, there is no need to fill it
+        if (!run.empty() && node.begin - run.back().end - 1 >= blockSize) {
+            finishRun();
+        }
+        run.push_back(node);
+    }
+    finishRun();
+}
+
+int CompactInodeJob::ReadObjRanges(
+    const struct S3CompactCtx& ctx,
+    std::unordered_map<std::string, struct S3ObjRange>* objRanges) {
+    std::vector<std::shared_ptr<GetObjectAsyncContext>> pending;
+    for (auto& item : *objRanges) {
+        auto& range = item.second;
+        range.data.resize(range.end - range.begin);
+        pending.emplace_back(std::make_shared<GetObjectAsyncContext>(
+            item.first, &range.data[0], range.begin, range.data.size()));
+    }
+
+    uint64_t retry = 0;
+    const auto maxRetry = opts_->s3ReadMaxRetry;
+    const auto retryInterval = opts_->s3ReadRetryInterval;
+    while (true) {
+        // issue all ranged reads at once, the inflight bytes are throttled
+        // by s3adapter
+        CountDownEvent counter(pending.size());
+        for (auto& context : pending) {
+            context->cb = [&counter](
+                              const S3Adapter*,
+                              const std::shared_ptr<GetObjectAsyncContext>&) {
+                counter.Signal();
+            };
+            ctx.s3adapter->GetObjectAsync(context);
+        }
+        counter.Wait();
+
+        std::vector<std::shared_ptr<GetObjectAsyncContext>> failed;
+        for (auto& context : pending) {
+            if (context->retCode < 0 || context->actualLen != context->len) {
+                LOG(WARNING) << "s3compact: get s3 obj " << context->key
+                             << " failed";
+                failed.emplace_back(std::move(context));
+            } else {
+                S3CompactMetric::GetInstance().readBytes << context->len;
+            }
+        }
+        if (failed.empty()) {
+            return 0;
+        }
+
+        // why we need retry
+        // if you enable client's diskcache,
+        // metadata may be newer than data in s3
+        // which means you cannot read data from s3
+        // we have to wait data to be flushed to s3
+        if (retry == maxRetry) return -1;  // no chance
+        retry++;
+        LOG(WARNING) << "s3compact: will retry after " << retryInterval
+                     << " seconds, current retry time:" << retry;
+        std::this_thread::sleep_for(std::chrono::seconds(retryInterval));
+        pending.swap(failed);
+    }
+}
+
 int CompactInodeJob::ReadFullChunk(
     const struct S3CompactCtx& ctx, const std::list<struct Node>& validList,
     std::string* fullChunk, struct S3NewChunkInfo* newChunkInfo) {
@@ -256,58 +383,35 @@ int CompactInodeJob::ReadFullChunk(
                 << ", len:" << s3req.len;
     }
     readContent.resize(s3reqs.size());
-    std::unordered_map<std::string, std::vector<struct S3Request*>> objReqs;
+    // process zero first and will not fail, requests of the same obj are
+    // merged into one ranged read
+    std::unordered_map<std::string, struct S3ObjRange> objRanges;
     for (auto& req : s3reqs) {
         if (req.zero) {
-            objReqs["zero"].emplace_back(&req);
-        } else {
-            objReqs[req.objName].emplace_back(&req);
+            readContent[req.reqIndex] = std::string(req.len, '\0');
+            continue;
         }
+        auto& range = objRanges[req.objName];
+        range.begin = std::min(range.begin, req.off);
+        range.end = std::max(range.end, req.off + req.len);
+        range.reqs.emplace_back(&req);
     }
-    // process zero first and will not fail
-    if (objReqs.find("zero") != objReqs.end()) {
-        for (const auto& req : objReqs["zero"]) {
-            readContent[req->reqIndex] = std::string(req->len, '\0');
-        }
-        objReqs.erase("zero");
+    // read objs in parallel
+    int ret = ReadObjRanges(ctx, &objRanges);
+    if (ret != 0) {
+        return ret;
     }
-    // read and process objs one by one
-    uint64_t retry = 0;
-    for (auto it = objReqs.begin(); it != objReqs.end(); it++) {
-        std::string buf;
-        const std::string& objName = it->first;
-        const auto& reqs = it->second;
-        const Aws::String aws_key(objName.c_str(), objName.size());
-        const auto maxRetry = opts_->s3ReadMaxRetry;
-        const auto retryInterval = opts_->s3ReadRetryInterval;
-        while (retry <= maxRetry) {
-            // why we need retry
-            // if you enable client's diskcache,
-            // metadata may be newer than data in s3
-            // which means you cannot read data from s3
-            // we have to wait data to be flushed to s3
-            int ret = ctx.s3adapter->GetObject(aws_key, &buf);
-            if (ret != 0) {
-                LOG(WARNING)
-                    << "s3compact: get s3 obj " << objName << " failed";
-                if (retry == maxRetry) return -1;  // no chance
-                retry++;
-                LOG(WARNING) << "s3compact: will retry after " << retryInterval
-                             << " seconds, current retry time:" << retry;
-                std::this_thread::sleep_for(
-                    std::chrono::seconds(retryInterval));
-                continue;
-            }
-            for (const auto& req : reqs) {
-                readContent[req->reqIndex] = buf.substr(req->off, req->len);
-            }
-            break;
+    for (const auto& item : objRanges) {
+        const auto& range = item.second;
+        for (const auto& req : range.reqs) {
+            readContent[req->reqIndex] =
+                range.data.substr(req->off - range.begin, req->len);
         }
     }
 
     // merge all read content
-    for (auto content : readContent) {
-        (*fullChunk) += std::move(content);
+    for (auto& content : readContent) {
+        (*fullChunk) += content;
     }
 
     return 0;
@@ -456,7 +560,8 @@ void CompactInodeJob::CompactChunk(
     const struct S3CompactCtx& compactCtx, uint64_t index, const Inode& inode,
     std::unordered_map<uint64_t, std::vector<std::string>>* objsAddedMap,
     ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoAdd,
-    ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoRemove) {
+    ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoRemove,
+    ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoDrop) {
     auto cleanup = absl::MakeCleanup(
         [&]() { VLOG(6) << "s3compact: exit index " << index; });
     VLOG(6) << "s3compact: begin to compact index " << index;
@@ -475,48 +580,114 @@ void CompactInodeJob::CompactChunk(
     if (validList.empty()) {
         // chunk is not valid, just delete this chunk
         s3ChunkInfoRemove->insert({index, s3chunkinfolist});
+        s3ChunkInfoDrop->insert({index, s3chunkinfolist});
         return;
     }
-    // 1.2  first read full chunk
-    struct S3NewChunkInfo newChunkInfo;
-    std::string fullChunk;
-    int ret = ReadFullChunk(compactCtx, validList, &fullChunk, &newChunkInfo);
-    if (ret != 0) {
-        LOG(WARNING) << "s3compact: ReadFullChunk failed, index " << index;
-        opts_->s3infoCache->InvalidateS3Info(
-            compactCtx.fsId);  // maybe s3info changed?
+    // 1.2 only fragments are merged, large extents are kept as they are
+    std::vector<std::list<Node>> runs;
+    S3ChunkInfoList toAddList;
+    SplitValidList(validList, compactCtx.blockSize, &runs, &toAddList);
+    if (runs.empty() &&
+        toAddList.s3chunks_size() == s3chunkinfolist.s3chunks_size()) {
+        VLOG(6) << "s3compact: nothing to merge, index " << index;
         return;
     }
-    VLOG(6) << "s3compact: finish read full chunk, size: " << fullChunk.size();
-    VLOG(6) << "s3compact: new s3chunk info will be id:"
-            << newChunkInfo.newChunkId << ", off:" << newChunkInfo.newOff
-            << ", compaction:" << newChunkInfo.newCompaction;
-    // 1.3 then write objs with newChunkid and newCompaction
+    uint64_t keptBytes = 0;
+    for (const auto& info : toAddList.s3chunks()) {
+        keptBytes += info.len();
+    }
+
+    // new objs of all runs use the largest chunkid with different compaction
+    uint64_t newChunkId = 0;
+    uint64_t newCompaction = 0;
+    for (const auto& info : s3chunkinfolist.s3chunks()) {
+        if (info.chunkid() > newChunkId) {
+            newChunkId = info.chunkid();
+            newCompaction = info.compaction();
+        } else if (info.chunkid() == newChunkId) {
+            newCompaction = std::max(newCompaction, info.compaction());
+        }
+    }
+
     std::vector<std::string> objsAdded;
-    ret = WriteFullChunk(compactCtx, newChunkInfo, fullChunk, &objsAdded);
-    if (ret != 0) {
-        LOG(WARNING) << "s3compact: WriteFullChunk failed, index " << index;
-        opts_->s3infoCache->InvalidateS3Info(
-            compactCtx.fsId);  // maybe s3info changed?
-        DeleteObjs(objsAdded, compactCtx.s3adapter);
-        return;
+    uint64_t writeBytes = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        // 1.3 first read the run
+        struct S3NewChunkInfo newChunkInfo;
+        std::string fullChunk;
+        int ret = ReadFullChunk(compactCtx, runs[i], &fullChunk, &newChunkInfo);
+        if (ret != 0) {
+            LOG(WARNING) << "s3compact: ReadFullChunk failed, index " << index;
+            opts_->s3infoCache->InvalidateS3Info(
+                compactCtx.fsId);  // maybe s3info changed?
+            DeleteObjs(objsAdded, compactCtx.s3adapter);
+            return;
+        }
+        newChunkInfo.newChunkId = newChunkId;
+        newChunkInfo.newCompaction = newCompaction + 1 + i;
+        VLOG(6) << "s3compact: finish read full chunk, size: "
+                << fullChunk.size();
+        VLOG(6) << "s3compact: new s3chunk info will be id:"
+                << newChunkInfo.newChunkId << ", off:" << newChunkInfo.newOff
+                << ", compaction:" << newChunkInfo.newCompaction;
+        // 1.4 then write objs with newChunkid and newCompaction
+        ret = WriteFullChunk(compactCtx, newChunkInfo, fullChunk, &objsAdded);
+        if (ret != 0) {
+            LOG(WARNING) << "s3compact: WriteFullChunk failed, index " << index;
+            opts_->s3infoCache->InvalidateS3Info(
+                compactCtx.fsId);  // maybe s3info changed?
+            DeleteObjs(objsAdded, compactCtx.s3adapter);
+            return;
+        }
+        S3ChunkInfo toAdd;
+        toAdd.set_chunkid(newChunkInfo.newChunkId);
+        toAdd.set_compaction(newChunkInfo.newCompaction);
+        toAdd.set_offset(newChunkInfo.newOff);
+        toAdd.set_len(fullChunk.length());
+        toAdd.set_size(fullChunk.length());
+        toAdd.set_zero(false);
+        *toAddList.add_s3chunks() = std::move(toAdd);
+        writeBytes += fullChunk.length();
     }
     VLOG(6) << "s3compact: finish write full chunk";
-    // 1.4 record add/delete
+
+    // 1.5 record add/delete
     objsAddedMap->emplace(index, std::move(objsAdded));
-    // to add
-    S3ChunkInfoList toAddList;
-    S3ChunkInfo toAdd;
-    toAdd.set_chunkid(newChunkInfo.newChunkId);
-    toAdd.set_compaction(newChunkInfo.newCompaction);
-    toAdd.set_offset(newChunkInfo.newOff);
-    toAdd.set_len(fullChunk.length());
-    toAdd.set_size(fullChunk.length());
-    toAdd.set_zero(false);
-    *toAddList.add_s3chunks() = std::move(toAdd);
+    // to add, s3chunkinfo list is ordered by chunkid
+    std::stable_sort(toAddList.mutable_s3chunks()->begin(),
+                     toAddList.mutable_s3chunks()->end(),
+                     [](const S3ChunkInfo& a, const S3ChunkInfo& b) {
+                         return a.chunkid() < b.chunkid();
+                     });
+    // to drop, objs of kept s3chunkinfos are still in use
+    S3ChunkInfoList toDropList;
+    for (const auto& info : s3chunkinfolist.s3chunks()) {
+        bool inUse = !info.zero() &&
+                     std::any_of(toAddList.s3chunks().begin(),
+                                 toAddList.s3chunks().end(),
+                                 [&](const S3ChunkInfo& added) {
+                                     return !added.zero() &&
+                                            added.chunkid() == info.chunkid() &&
+                                            added.compaction() ==
+                                                info.compaction() &&
+                                            added.offset() == info.offset();
+                                 });
+        if (!inUse) {
+            *toDropList.add_s3chunks() = info;
+        }
+    }
+
+    auto& metric = S3CompactMetric::GetInstance();
+    metric.fragmentsBefore << s3chunkinfolist.s3chunks_size();
+    metric.fragmentsAfter << toAddList.s3chunks_size();
+    metric.keptBytes << keptBytes;
+    metric.writeBytes << writeBytes;
+    metric.compactedChunks << 1;
+
     s3ChunkInfoAdd->insert({index, std::move(toAddList)});
     // to remove
     s3ChunkInfoRemove->insert({index, s3chunkinfolist});
+    s3ChunkInfoDrop->insert({index, std::move(toDropList)});
 }
 
 void CompactInodeJob::DeleteObjsOfS3ChunkInfoList(
@@ -579,12 +750,15 @@ void CompactInodeJob::CompactChunks(const S3CompactTask& task) {
     std::unordered_map<uint64_t, std::vector<std::string>> objsAddedMap;
     ::google::protobuf::Map<uint64_t, S3ChunkInfoList> s3ChunkInfoAdd;
     ::google::protobuf::Map<uint64_t, S3ChunkInfoList> s3ChunkInfoRemove;
+    ::google::protobuf::Map<uint64_t, S3ChunkInfoList> s3ChunkInfoDrop;
     VLOG(6) << "s3compact: begin to compact fsId:" << fsId
             << ", inodeId:" << inodeId;
+    butil::Timer timer;
+    timer.start();
     for (const auto& index : needCompact) {
         // s3chunklist order: from small chunkid to big chunkid
         CompactChunk(compactCtx, index, inode, &objsAddedMap, &s3ChunkInfoAdd,
-                     &s3ChunkInfoRemove);
+                     &s3ChunkInfoRemove, &s3ChunkInfoDrop);
     }
     if (s3ChunkInfoAdd.empty() && s3ChunkInfoRemove.empty()) {
         VLOG(6) << "s3compact: do nothing to metadata";
@@ -599,11 +773,6 @@ void CompactInodeJob::CompactChunks(const S3CompactTask& task) {
         opts_->s3adapterManager->ReleaseS3Adapter(s3adapterIndex);
         return;
     }
-    std::vector<int> s3ChunkInfoRemoveIndex;
-    s3ChunkInfoRemoveIndex.reserve(s3ChunkInfoRemove.size());
-    for (const auto& element : s3ChunkInfoRemove) {
-        s3ChunkInfoRemoveIndex.push_back(element.first);
-    }
     auto ret =
         UpdateInode(task.copysetNodeWrapper->Get(), compactCtx.pinfo, inodeId,
                     std::move(s3ChunkInfoAdd), std::move(s3ChunkInfoRemove));
@@ -621,12 +790,13 @@ void CompactInodeJob::CompactChunks(const S3CompactTask& task) {
 
     // 3. delete old objs
     VLOG(6) << "s3compact: start delete old objs";
-    for (const auto& index : s3ChunkInfoRemoveIndex) {
-        const auto& l = inode.s3chunkinfomap().at(index);
-        DeleteObjsOfS3ChunkInfoList(compactCtx, l);
+    for (const auto& item : s3ChunkInfoDrop) {
+        DeleteObjsOfS3ChunkInfoList(compactCtx, item.second);
     }
     VLOG(6) << "s3compact: finish delete objs";
     opts_->s3adapterManager->ReleaseS3Adapter(s3adapterIndex);
+    timer.stop();
+    S3CompactMetric::GetInstance().inodeLatency << timer.u_elapsed();
     VLOG(6) << "s3compact: compact successfully";
 }
 
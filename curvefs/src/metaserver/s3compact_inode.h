@@ -23,9 +23,12 @@
 #ifndef CURVEFS_SRC_METASERVER_S3COMPACT_INODE_H_
 #define CURVEFS_SRC_METASERVER_S3COMPACT_INODE_H_
 
+#include <bvar/bvar.h>
+
 #include <algorithm>
 #include <condition_variable>
 #include <deque>
+#include <limits>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -73,6 +76,33 @@ class CopysetNodeWrapper {
 
 struct S3CompactionWorkerOptions;
 
+// S3CompactMetric is shared by all compaction jobs
+struct S3CompactMetric {
+    S3CompactMetric();
+
+    static S3CompactMetric& GetInstance() {
+        static S3CompactMetric metric;
+        return metric;
+    }
+
+    // bytes read from s3
+    bvar::Adder<uint64_t> readBytes;
+    bvar::PerSecond<bvar::Adder<uint64_t>> readBps;
+    // bytes rewritten to s3
+    bvar::Adder<uint64_t> writeBytes;
+    bvar::PerSecond<bvar::Adder<uint64_t>> writeBps;
+    // bytes of valid extents which are kept without rewriting
+    bvar::Adder<uint64_t> keptBytes;
+    // number of chunks compacted
+    bvar::Adder<uint64_t> compactedChunks;
+    // number of s3chunkinfos of a chunk before and after compaction,
+    // readers issue at least one s3 request for each of them
+    bvar::IntRecorder fragmentsBefore;
+    bvar::IntRecorder fragmentsAfter;
+    // latency of compacting an inode
+    bvar::LatencyRecorder inodeLatency;
+};
+
 class CompactInodeJob {
  public:
     explicit CompactInodeJob(const S3CompactWorkerOptions* opts)
@@ -124,6 +154,14 @@ class CompactInodeJob {
               len(len) {}
     };
 
+    // ranged read of one s3 object, which covers all requests of it
+    struct S3ObjRange {
+        uint64_t begin = std::numeric_limits<uint64_t>::max();
+        uint64_t end = 0;
+        std::string data;
+        std::vector<struct S3Request*> reqs;
+    };
+
     // node for building valid list
     struct Node {
         uint64_t begin;
@@ -182,6 +220,15 @@ class CompactInodeJob {
                            const std::list<struct Node>& validList,
                            std::vector<struct S3Request>* reqs,
                            struct S3NewChunkInfo* newChunkInfo);
+    // split valid list into extents which are kept as they are, and runs
+    // of fragments which need to be rewritten
+    void SplitValidList(const std::list<struct Node>& validList,
+                        uint64_t blockSize,
+                        std::vector<std::list<struct Node>>* runs,
+                        S3ChunkInfoList* kept);
+    int ReadObjRanges(
+        const struct S3CompactCtx& ctx,
+        std::unordered_map<std::string, struct S3ObjRange>* objRanges);
     int ReadFullChunk(const struct S3CompactCtx& ctx,
                       const std::list<struct Node>& validList,
                       std::string* fullChunk,
@@ -194,12 +241,15 @@ class CompactInodeJob {
                        const struct S3NewChunkInfo& newChunkInfo,
                        const std::string& fullChunk,
                        std::vector<std::string>* objsAdded);
+    // s3ChunkInfoDrop records s3chunkinfos whose objs will be deleted after
+    // inode is updated, it's s3ChunkInfoRemove except the kept ones
     void CompactChunk(
         const struct S3CompactCtx& compactCtx, uint64_t index,
         const Inode& inode,
         std::unordered_map<uint64_t, std::vector<std::string>>* objsAddedMap,
         ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoAdd,
-        ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoRemove);
+        ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoRemove,
+        ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoDrop);
 
     void DeleteObjsOfS3ChunkInfoList(const struct S3CompactCtx& ctx,
                                      const S3ChunkInfoList& s3chunkinfolist);
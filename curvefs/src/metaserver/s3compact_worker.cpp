@@ -26,7 +26,9 @@
 
 #include <atomic>
 #include <chrono>
+#include <limits>
 #include <mutex>
+#include <queue>
 #include <thread>
 #include <utility>
 
@@ -109,6 +111,29 @@ void S3CompactWorker::CleanupCompact(bool again) {
     s3Compact_.reset();
 }
 
+void S3CompactWorker::SortInodesByFragments(std::list<uint64_t>* inodes) {
+    const auto fsId = s3Compact_->partitionInfo.fsid();
+    std::priority_queue<std::pair<uint64_t, uint64_t>> queue;
+    for (auto ino : *inodes) {
+        uint64_t fragments =
+            s3Compact_->inodeManager->GetInodeS3MetaSize(fsId, ino);
+        // the size is unknown if failed to load it, skip the inode and
+        // it will be checked again in next round
+        if (fragments == std::numeric_limits<uint64_t>::max()) {
+            VLOG(3) << "Skip inode which failed to get s3 meta size, fsId: "
+                    << fsId << ", inodeId: " << ino;
+        } else if (fragments != 0) {
+            queue.emplace(fragments, ino);
+        }
+    }
+
+    inodes->clear();
+    while (!queue.empty()) {
+        inodes->push_back(queue.top().second);
+        queue.pop();
+    }
+}
+
 bool S3CompactWorker::CompactInodes(const std::list<uint64_t>& inodes,
                                     copyset::CopysetNode* node) {
     if (inodes.empty()) {
@@ -195,6 +220,7 @@ void S3CompactWorker::CompactWorker() {
             continue;
         }
 
+        SortInodesByFragments(&inodes);
         compactAgain = CompactInodes(inodes, s3Compact_->copysetNode.get());
     }
 
@@ -91,6 +91,10 @@ class S3CompactWorker {
     // Return true if we've got a partition to compact, otherwise return false
     bool WaitCompact();
 
+    // Order inodes by the number of s3chunkinfos, the most fragmented first,
+    // inodes without any s3chunkinfo are removed
+    void SortInodesByFragments(std::list<uint64_t>* inodes);
+
     // Return whether compact current partition again
     bool CompactInodes(const std::list<uint64_t>& inodes,
                        copyset::CopysetNode* node);
@@ -21,8 +21,10 @@
  */
 
 #include <inttypes.h>
+#include <butil/sys_byteorder.h>
 #include <glog/logging.h>
 
+#include <atomic>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -52,6 +54,121 @@ static bool CompareType(const std::string& str, KEY_TYPE keyType) {
     return StringToUl(str, &n) && n == keyType;
 }
 
+static std::atomic<KeyFormat> keyFormat(KeyFormat::kText);
+
+void SetKeyFormat(KeyFormat format) {
+    keyFormat.store(format, std::memory_order_relaxed);
+}
+
+KeyFormat GetKeyFormat() {
+    return keyFormat.load(std::memory_order_relaxed);
+}
+
+KeyFormat FormatOfKey(const std::string& key) {
+    // text key always starts with a decimal key type, and binary key starts
+    // with the raw key type which is less than '0'
+    if (!key.empty() && key[0] >= '0' && key[0] <= '9') {
+        return KeyFormat::kText;
+    }
+    return KeyFormat::kBinary;
+}
+
+bool StringToKeyFormat(const std::string& str, KeyFormat* format) {
+    if (str == "text") {
+        *format = KeyFormat::kText;
+    } else if (str == "binary") {
+        *format = KeyFormat::kBinary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool UseBinaryKey() {
+    return GetKeyFormat() == KeyFormat::kBinary;
+}
+
+namespace {
+
+class BinaryKeyWriter {
+ public:
+    explicit BinaryKeyWriter(KEY_TYPE type) {
+        key_.reserve(48);
+        key_.push_back(static_cast<char>(type));
+    }
+
+    BinaryKeyWriter& Put(uint32_t value) {
+        value = butil::HostToNet32(value);
+        key_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    BinaryKeyWriter& Put(uint64_t value) {
+        value = butil::HostToNet64(value);
+        key_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    BinaryKeyWriter& Put(const std::string& value) {
+        key_.append(value);
+        return *this;
+    }
+
+    std::string Release() { return std::move(key_); }
+
+ private:
+    std::string key_;
+};
+
+class BinaryKeyReader {
+ public:
+    BinaryKeyReader(const std::string& key, KEY_TYPE type)
+        : key_(key),
+          pos_(1),
+          ok_(!key.empty() && key[0] == static_cast<char>(type)) {}
+
+    BinaryKeyReader& Get(uint32_t* value) { return Fixed(value); }
+
+    BinaryKeyReader& Get(uint64_t* value) { return Fixed(value); }
+
+    // take all remaining bytes
+    BinaryKeyReader& Get(std::string* value) {
+        if (ok_) {
+            value->assign(key_, pos_, std::string::npos);
+            pos_ = key_.size();
+        }
+        return *this;
+    }
+
+    // all fields are parsed and nothing left
+    bool Done() const { return ok_ && pos_ == key_.size(); }
+
+ private:
+    template <typename T>
+    BinaryKeyReader& Fixed(T* value) {
+        if (!ok_ || key_.size() - pos_ < sizeof(T)) {
+            ok_ = false;
+            return *this;
+        }
+        T raw;
+        std::memcpy(&raw, key_.data() + pos_, sizeof(T));
+        *value = ToHost(raw);
+        pos_ += sizeof(T);
+        return *this;
+    }
+
+    static uint32_t ToHost(uint32_t value) { return butil::NetToHost32(value); }
+
+    static uint64_t ToHost(uint64_t value) { return butil::NetToHost64(value); }
+
+ private:
+    const std::string& key_;
+    size_t pos_;
+    bool ok_;
+};
+
+}  // namespace
+
 NameGenerator::NameGenerator(uint32_t partitionId)
     : tableName4Inode_(Format(kTypeInode, partitionId)),
       tableName4DeallocatableIndoe_(
@@ -65,7 +182,8 @@ NameGenerator::NameGenerator(uint32_t partitionId)
       tableName4AppliedIndex_(Format(kTypeAppliedIndex, partitionId)),
       tableName4Transaction_(Format(kTypeTransaction, partitionId)),
       tableName4InodeCount_(Format(kTypeInodeCount, partitionId)),
-      tableName4DentryCount_(Format(kTypeDentryCount, partitionId)) {}
+      tableName4DentryCount_(Format(kTypeDentryCount, partitionId)),
+      tableName4InodeDelta_(Format(kTypeInodeDelta, partitionId)) {}
 
 std::string NameGenerator::GetInodeTableName() const {
     return tableName4Inode_;
@@ -111,6 +229,10 @@ std::string NameGenerator::GetDentryCountTableName() const {
     return tableName4DentryCount_;
 }
 
+std::string NameGenerator::GetInodeDeltaTableName() const {
+    return tableName4InodeDelta_;
+}
+
 size_t NameGenerator::GetFixedLength() {
     size_t length = sizeof(kTypeInode) + sizeof(uint32_t) + strlen(kDelimiter);
     LOG(INFO) << "Tablename fixed length is " << length;
@@ -136,10 +258,16 @@ bool Key4Inode::operator==(const Key4Inode& rhs) {
 }
 
 std::string Key4Inode::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId).Put(inodeId).Release();
+    }
     return absl::StrCat(keyType_, ":", fsId, ":", inodeId);
 }
 
 bool Key4Inode::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Get(&fsId).Get(&inodeId).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 3 && CompareType(items[0], keyType_) &&
@@ -147,10 +275,16 @@ bool Key4Inode::ParseFromString(const std::string& value) {
 }
 
 std::string Prefix4AllInode::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Release();
+    }
     return absl::StrCat(keyType_, ":");
 }
 
 bool Prefix4AllInode::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 1 && CompareType(items[0], keyType_);
@@ -179,6 +313,16 @@ Key4S3ChunkInfoList::Key4S3ChunkInfoList(uint32_t fsId, uint64_t inodeId,
       size(size) {}
 
 std::string Key4S3ChunkInfoList::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_)
+            .Put(fsId)
+            .Put(inodeId)
+            .Put(chunkIndex)
+            .Put(firstChunkId)
+            .Put(lastChunkId)
+            .Put(size)
+            .Release();
+    }
     return absl::StrCat(keyType_, ":", fsId, ":", inodeId, ":", chunkIndex, ":",
                         absl::StrFormat("%020" PRIu64 "", firstChunkId), ":",
                         absl::StrFormat("%020" PRIu64 "", lastChunkId), ":",
@@ -186,6 +330,16 @@ std::string Key4S3ChunkInfoList::SerializeToString() const {
 }
 
 bool Key4S3ChunkInfoList::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId)
+            .Get(&inodeId)
+            .Get(&chunkIndex)
+            .Get(&firstChunkId)
+            .Get(&lastChunkId)
+            .Get(&size)
+            .Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 7 && CompareType(items[0], keyType_) &&
@@ -203,12 +357,26 @@ Prefix4ChunkIndexS3ChunkInfoList::Prefix4ChunkIndexS3ChunkInfoList(
     : fsId(fsId), inodeId(inodeId), chunkIndex(chunkIndex) {}
 
 std::string Prefix4ChunkIndexS3ChunkInfoList::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_)
+            .Put(fsId)
+            .Put(inodeId)
+            .Put(chunkIndex)
+            .Release();
+    }
     return absl::StrCat(keyType_, ":", fsId, ":", inodeId, ":", chunkIndex,
                         ":");
 }
 
 bool Prefix4ChunkIndexS3ChunkInfoList::ParseFromString(
     const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId)
+            .Get(&inodeId)
+            .Get(&chunkIndex)
+            .Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 4 && CompareType(items[0], keyType_) &&
@@ -224,10 +392,16 @@ Prefix4InodeS3ChunkInfoList::Prefix4InodeS3ChunkInfoList(uint32_t fsId,
     : fsId(fsId), inodeId(inodeId) {}
 
 std::string Prefix4InodeS3ChunkInfoList::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId).Put(inodeId).Release();
+    }
     return absl::StrCat(keyType_, ":", fsId, ":", inodeId, ":");
 }
 
 bool Prefix4InodeS3ChunkInfoList::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Get(&fsId).Get(&inodeId).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 3 && CompareType(items[0], keyType_) &&
@@ -235,10 +409,16 @@ bool Prefix4InodeS3ChunkInfoList::ParseFromString(const std::string& value) {
 }
 
 std::string Prefix4AllS3ChunkInfoList::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Release();
+    }
     return absl::StrCat(kTypeS3ChunkInfo, ":");
 }
 
 bool Prefix4AllS3ChunkInfoList::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 1 && CompareType(items[0], keyType_);
@@ -249,11 +429,25 @@ Key4Dentry::Key4Dentry(uint32_t fsId, uint64_t parentInodeId,
     : fsId(fsId), parentInodeId(parentInodeId), name(name) {}
 
 std::string Key4Dentry::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_)
+            .Put(fsId)
+            .Put(parentInodeId)
+            .Put(name)
+            .Release();
+    }
     return absl::StrCat(keyType_, kDelimiter, fsId, kDelimiter, parentInodeId,
                         kDelimiter, name);
 }
 
 bool Key4Dentry::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId)
+            .Get(&parentInodeId)
+            .Get(&name)
+            .Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     if (items.size() < 3 || !CompareType(items[0], keyType_) ||
@@ -276,11 +470,20 @@ Prefix4SameParentDentry::Prefix4SameParentDentry(uint32_t fsId,
     : fsId(fsId), parentInodeId(parentInodeId) {}
 
 std::string Prefix4SameParentDentry::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId).Put(parentInodeId).Release();
+    }
     return absl::StrCat(keyType_, kDelimiter, fsId, kDelimiter, parentInodeId,
                         kDelimiter);
 }
 
 bool Prefix4SameParentDentry::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId)
+            .Get(&parentInodeId)
+            .Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 3 && CompareType(items[0], keyType_) &&
@@ -288,10 +491,16 @@ bool Prefix4SameParentDentry::ParseFromString(const std::string& value) {
 }
 
 std::string Prefix4AllDentry::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Release();
+    }
     return absl::StrCat(keyType_, ":");
 }
 
 bool Prefix4AllDentry::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 1 && CompareType(items[0], keyType_);
@@ -302,11 +511,25 @@ Key4VolumeExtentSlice::Key4VolumeExtentSlice(uint32_t fsId, uint64_t inodeId,
     : fsId_(fsId), inodeId_(inodeId), offset_(offset) {}
 
 std::string Key4VolumeExtentSlice::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_)
+            .Put(fsId_)
+            .Put(inodeId_)
+            .Put(offset_)
+            .Release();
+    }
     return absl::StrCat(keyType_, kDelimiter, fsId_, kDelimiter, inodeId_,
                         kDelimiter, offset_);
 }
 
 bool Key4VolumeExtentSlice::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId_)
+            .Get(&inodeId_)
+            .Get(&offset_)
+            .Done();
+    }
     // TODO(wuhanqing): reduce unnecessary creation of temporary strings,
     //                  but, currently, `absl::from_chars` only support floating
     //                  point
@@ -322,11 +545,20 @@ Prefix4InodeVolumeExtent::Prefix4InodeVolumeExtent(uint32_t fsId,
     : fsId_(fsId), inodeId_(inodeId) {}
 
 std::string Prefix4InodeVolumeExtent::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId_).Put(inodeId_).Release();
+    }
     return absl::StrCat(keyType_, kDelimiter, fsId_, kDelimiter, inodeId_,
                         kDelimiter);
 }
 
 bool Prefix4InodeVolumeExtent::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId_)
+            .Get(&inodeId_)
+            .Done();
+    }
     std::vector<std::string> items;
     SplitString(value, kDelimiter, &items);
     return items.size() == 3 && CompareType(items[0], keyType_) &&
@@ -334,10 +566,16 @@ bool Prefix4InodeVolumeExtent::ParseFromString(const std::string& value) {
 }
 
 std::string Prefix4AllVolumeExtent::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Release();
+    }
     return absl::StrCat(keyType_, kDelimiter);
 }
 
 bool Prefix4AllVolumeExtent::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, kDelimiter, &items);
     return items.size() == 1 && CompareType(items[0], keyType_);
@@ -347,10 +585,68 @@ Key4InodeAuxInfo::Key4InodeAuxInfo(uint32_t fsId, uint64_t inodeId)
     : fsId(fsId), inodeId(inodeId) {}
 
 std::string Key4InodeAuxInfo::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId).Put(inodeId).Release();
+    }
     return absl::StrCat(keyType_, kDelimiter, fsId, kDelimiter, inodeId);
 }
 
 bool Key4InodeAuxInfo::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Get(&fsId).Get(&inodeId).Done();
+    }
+    std::vector<std::string> items;
+    SplitString(value, kDelimiter, &items);
+    return items.size() == 3 && CompareType(items[0], keyType_) &&
+           StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId);
+}
+
+Key4InodeDelta::Key4InodeDelta(uint32_t fsId, uint64_t inodeId,
+                               uint64_t logIndex)
+    : fsId(fsId), inodeId(inodeId), logIndex(logIndex) {}
+
+std::string Key4InodeDelta::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_)
+            .Put(fsId)
+            .Put(inodeId)
+            .Put(logIndex)
+            .Release();
+    }
+    return absl::StrCat(keyType_, kDelimiter, fsId, kDelimiter, inodeId,
+                        kDelimiter, logIndex);
+}
+
+bool Key4InodeDelta::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId)
+            .Get(&inodeId)
+            .Get(&logIndex)
+            .Done();
+    }
+    std::vector<std::string> items;
+    SplitString(value, kDelimiter, &items);
+    return items.size() == 4 && CompareType(items[0], keyType_) &&
+           StringToUl(items[1], &fsId) && StringToUll(items[2], &inodeId) &&
+           StringToUll(items[3], &logIndex);
+}
+
+Prefix4InodeDelta::Prefix4InodeDelta(uint32_t fsId, uint64_t inodeId)
+    : fsId(fsId), inodeId(inodeId) {}
+
+std::string Prefix4InodeDelta::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId).Put(inodeId).Release();
+    }
+    return absl::StrCat(keyType_, kDelimiter, fsId, kDelimiter, inodeId,
+                        kDelimiter);
+}
+
+bool Prefix4InodeDelta::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Get(&fsId).Get(&inodeId).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, kDelimiter, &items);
     return items.size() == 3 && CompareType(items[0], keyType_) &&
@@ -358,10 +654,19 @@ bool Key4InodeAuxInfo::ParseFromString(const std::string& value) {
 }
 
 std::string Key4DeallocatableBlockGroup::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Put(fsId).Put(volumeOffset).Release();
+    }
     return absl::StrCat(keyType_, kDelimiter, fsId, kDelimiter, volumeOffset);
 }
 
 bool Key4DeallocatableBlockGroup::ParseFromString(const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_)
+            .Get(&fsId)
+            .Get(&volumeOffset)
+            .Done();
+    }
     std::vector<std::string> items;
     SplitString(value, kDelimiter, &items);
     return items.size() == 3 && CompareType(items[0], keyType_) &&
@@ -369,11 +674,17 @@ bool Key4DeallocatableBlockGroup::ParseFromString(const std::string& value) {
 }
 
 std::string Prefix4AllDeallocatableBlockGroup::SerializeToString() const {
+    if (UseBinaryKey()) {
+        return BinaryKeyWriter(keyType_).Release();
+    }
     return absl::StrCat(keyType_, ":");
 }
 
 bool Prefix4AllDeallocatableBlockGroup::ParseFromString(
     const std::string& value) {
+    if (FormatOfKey(value) == KeyFormat::kBinary) {
+        return BinaryKeyReader(value, keyType_).Done();
+    }
     std::vector<std::string> items;
     SplitString(value, ":", &items);
     return items.size() == 1 && CompareType(items[0], keyType_);
@@ -49,9 +49,28 @@ enum KEY_TYPE : unsigned char {
     kTypeAppliedIndex = 9,
     kTypeTransaction = 10,
     kTypeInodeCount = 11,
-    kTypeDentryCount = 12
+    kTypeDentryCount = 12,
+    kTypeInodeDelta = 13
 };
 
+// on-disk format of storage keys
+enum class KeyFormat : unsigned char {
+    // decimal fields separated by ':', e.g: "1:1:100"
+    kText = 0,
+    // fixed-width big-endian fields, the first byte is KEY_TYPE
+    kBinary = 1,
+};
+
+// the format of keys to serialize, keys in both formats can be parsed
+void SetKeyFormat(KeyFormat format);
+
+KeyFormat GetKeyFormat();
+
+// return the format of a serialized key
+KeyFormat FormatOfKey(const std::string& key);
+
+bool StringToKeyFormat(const std::string& str, KeyFormat* format);
+
 // NOTE: you must generate all table name by NameGenerator class for
 // gurantee the fixed prefix for rocksdb storage.
 // e.g: 1:0001
@@ -83,6 +102,8 @@ class NameGenerator {
 
     std::string GetDentryCountTableName() const;
 
+    std::string GetInodeDeltaTableName() const;
+
     static size_t GetFixedLength();
 
  private:
@@ -100,6 +121,7 @@ class NameGenerator {
     std::string tableName4Transaction_;
     std::string tableName4InodeCount_;
     std::string tableName4DentryCount_;
+    std::string tableName4InodeDelta_;
 };
 
 class StorageKey {
@@ -124,8 +146,15 @@ class StorageKey {
  *   Prefix4InodeVolumeExtent         : kTypeExtent:fsId:inodeId:
  *   Prefix4AllVolumeExtent           : kTypeExtent:
  *   Key4InodeAuxInfo                 : kTypeInodeAuxInfo:fsId:inodeId
+ *   Key4InodeDelta                   : kTypeInodeDelta:fsId:inodeId:logIndex
+ *   Prefix4InodeDelta                : kTypeInodeDelta:fsId:inodeId:
  *   Key4DeallocatableBlockGroup      : kTypeBlockGroup:fsId:volumeOffset
  *   Prefix4AllDeallocatableBlockGroup: kTypeBlockGroup:
+ *
+ * in binary format, the delimiters are removed, the key type takes one byte,
+ * fsId takes 4 bytes and other integers take 8 bytes, all in big-endian,
+ * so keys are ordered numerically. e.g: Key4Dentry is
+ *   | kTypeDentry (1) | fsId (4) | parentInodeId (8) | name |
  */
 
 class Key4Inode : public StorageKey {
@@ -353,6 +382,43 @@ class Key4InodeAuxInfo : public StorageKey {
     static constexpr KEY_TYPE keyType_ = kTypeInodeAuxInfo;
 };
 
+class Key4InodeDelta : public StorageKey {
+ public:
+    Key4InodeDelta() = default;
+
+    Key4InodeDelta(uint32_t fsId, uint64_t inodeId, uint64_t logIndex);
+
+    std::string SerializeToString() const override;
+
+    bool ParseFromString(const std::string& value) override;
+
+ public:
+    uint32_t fsId;
+    uint64_t inodeId;
+    uint64_t logIndex;
+
+ private:
+    static constexpr KEY_TYPE keyType_ = kTypeInodeDelta;
+};
+
+class Prefix4InodeDelta : public StorageKey {
+ public:
+    Prefix4InodeDelta() = default;
+
+    Prefix4InodeDelta(uint32_t fsId, uint64_t inodeId);
+
+    std::string SerializeToString() const override;
+
+    bool ParseFromString(const std::string& value) override;
+
+ public:
+    uint32_t fsId;
+    uint64_t inodeId;
+
+ private:
+    static constexpr KEY_TYPE keyType_ = kTypeInodeDelta;
+};
+
 class Key4DeallocatableBlockGroup : public StorageKey {
  public:
     Key4DeallocatableBlockGroup() = default;
@@ -25,7 +25,9 @@
 #include <sys/wait.h>
 #include <sys/prctl.h>
 #include <glog/logging.h>
+#include <lz4.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <thread>
@@ -39,6 +41,20 @@
 #include "curvefs/src/metaserver/storage/iterator.h"
 #include "curvefs/src/metaserver/storage/dumpfile.h"
 
+static bool pass_uint32(const char*, uint32_t) { return true; }
+static bool pass_bool(const char*, bool) { return true; }
+
+DEFINE_bool(dumpfile_sections, false,
+            "whether to save dumpfile in sections (version 5) by default, "
+            "it can't be loaded by older versions");
+DEFINE_validator(dumpfile_sections, &pass_bool);
+DEFINE_uint32(dumpfile_threads, 4,
+              "number of threads to save and load a dumpfile");
+DEFINE_validator(dumpfile_threads, &pass_uint32);
+DEFINE_bool(dumpfile_compression, false,
+            "whether to compress the sections of dumpfile");
+DEFINE_validator(dumpfile_compression, &pass_bool);
+
 namespace curvefs {
 namespace metaserver {
 namespace storage {
@@ -67,9 +83,24 @@ using ::curve::common::CRC32;
 
 const std::string DumpFile::kCurvefs_ = "CURVEFS";  // NOLINT
 const uint32_t DumpFile::kEOF_ = 0;
-const uint8_t DumpFile::kVersion_ = kDumpFileV4;
+const uint8_t DumpFile::kVersion_ = kDumpFileV5;
 
 const uint32_t DumpFile::kMaxStringLength_ = 1024 * 1024 * 1024;  // 1GB
+const uint64_t DumpFile::kSectionSize_ = 4 * 1024 * 1024;  // 4MB
+
+namespace {
+
+uint32_t DumpFileThreads() {
+    return std::max<uint32_t>(FLAGS_dumpfile_threads, 1);
+}
+
+void AppendEntry(const std::string& entry, std::string* pairs) {
+    uint32_t length = entry.size();
+    pairs->append(reinterpret_cast<char*>(&length), sizeof(length));
+    pairs->append(entry);
+}
+
+}  // namespace
 
 std::ostream& operator<<(std::ostream& os, DUMPFILE_ERROR code) {
     static auto code2str = std::map<DUMPFILE_ERROR, std::string> {
@@ -87,6 +118,8 @@ std::ostream& operator<<(std::ostream& os, DUMPFILE_ERROR code) {
         ERR2STR(WAITPID_FAILED)
         ERR2STR(UNEXPECTED_SIGNAL)
         ERR2STR(ENCOUNTER_EOF)
+        ERR2STR(CHECKSUM_MISMATCH)
+        ERR2STR(UNCOMPRESS_FAILED)
     };
 
     auto iter = code2str.find(code);
@@ -125,12 +158,16 @@ bool DumpFile::CheckDumpFileVersion(uint8_t ver) {
     return ver >= kDumpFileV1 && ver <= kVersion_;
 }
 
+uint8_t DumpFile::DefaultVersion() {
+    return FLAGS_dumpfile_sections ? kDumpFileV5 : kDumpFileV4;
+}
+
 DumpFile::DumpFile(const std::string& pathname)
     : pathname_(pathname),
       fd_(-1),
       fs_(Ext4FileSystemImpl::getInstance()),
       loadStatus_(DUMPFILE_LOAD_STATUS::INCOMPLETE),
-      version_(kVersion_) {}
+      version_(DefaultVersion()) {}
 
 DumpFile::DumpFile(const std::string& pathname, uint8_t version)
     : pathname_(pathname),
@@ -295,6 +332,8 @@ DUMPFILE_ERROR DumpFile::LoadEntry(std::string* entry,
 DUMPFILE_ERROR DumpFile::Save(std::shared_ptr<Iterator> iter) {
     if (fd_ < 0) {
         return DUMPFILE_ERROR::BAD_FD;
+    } else if (version_ >= kDumpFileV5) {
+        return Save(std::vector<std::shared_ptr<Iterator>>{ iter });
     }
 
     off_t offset = 0;
@@ -344,6 +383,243 @@ DUMPFILE_ERROR DumpFile::Save(std::shared_ptr<Iterator> iter) {
     return DUMPFILE_ERROR::OK;
 }
 
+void DumpFile::EncodeSection(std::string* pairs,
+                             uint64_t nPairs,
+                             DumpFileSection* section) {
+    section->rawLength = pairs->size();
+    section->nPairs = nPairs;
+    section->compression = kNoCompression;
+    if (FLAGS_dumpfile_compression &&
+        pairs->size() <= static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        std::string compressed(LZ4_compressBound(pairs->size()), '\0');
+        int length = LZ4_compress_default(pairs->data(), &compressed[0],
+                                          pairs->size(), compressed.size());
+        // keep the raw pairs if it's incompressible
+        if (length > 0 && static_cast<size_t>(length) < pairs->size()) {
+            compressed.resize(length);
+            pairs->swap(compressed);
+            section->compression = kLz4Compression;
+        }
+    }
+    section->length = pairs->size();
+    section->checkSum = CRC32(pairs->data(), pairs->size());
+}
+
+DUMPFILE_ERROR DumpFile::SaveSectionTable(
+    const std::vector<DumpFileSection>& sections,
+    off_t* offset,
+    uint32_t* checkSum) {
+    RETURN_IF_UNSUCCESS(SaveInt<uint32_t>(sections.size(), offset, checkSum));
+    for (const auto& section : sections) {
+        RETURN_IF_UNSUCCESS(SaveInt<uint64_t>(section.offset,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(SaveInt<uint64_t>(section.length,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(SaveInt<uint64_t>(section.rawLength,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(SaveInt<uint64_t>(section.nPairs,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(SaveInt<uint8_t>(section.compression,
+                                             offset, checkSum));
+        RETURN_IF_UNSUCCESS(SaveInt<uint32_t>(section.checkSum,
+                                              offset, checkSum));
+    }
+    return DUMPFILE_ERROR::OK;
+}
+
+DUMPFILE_ERROR DumpFile::LoadSectionTable(
+    std::vector<DumpFileSection>* sections,
+    off_t* offset,
+    uint32_t* checkSum) {
+    uint32_t nSections;
+    RETURN_IF_UNSUCCESS(LoadInt<uint32_t>(&nSections, offset, checkSum));
+    for (uint32_t i = 0; i < nSections; i++) {
+        DumpFileSection section;
+        RETURN_IF_UNSUCCESS(LoadInt<uint64_t>(&section.offset,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(LoadInt<uint64_t>(&section.length,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(LoadInt<uint64_t>(&section.rawLength,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(LoadInt<uint64_t>(&section.nPairs,
+                                              offset, checkSum));
+        RETURN_IF_UNSUCCESS(LoadInt<uint8_t>(&section.compression,
+                                             offset, checkSum));
+        RETURN_IF_UNSUCCESS(LoadInt<uint32_t>(&section.checkSum,
+                                              offset, checkSum));
+        sections->push_back(section);
+    }
+    return DUMPFILE_ERROR::OK;
+}
+
+DUMPFILE_ERROR DumpFile::LoadSection(const DumpFileSection& section,
+                                     std::string* pairs) {
+    std::string data(section.length, '\0');
+    RETURN_IF_UNSUCCESS(Read(&data[0], section.offset, section.length));
+    if (CRC32(data.data(), data.size()) != section.checkSum) {
+        LOG(ERROR) << "Section checksum mismatch, offset = " << section.offset
+                   << ", length = " << section.length;
+        return DUMPFILE_ERROR::CHECKSUM_MISMATCH;
+    }
+
+    if (section.compression == kNoCompression) {
+        pairs->swap(data);
+        return DUMPFILE_ERROR::OK;
+    } else if (section.compression != kLz4Compression) {
+        LOG(ERROR) << "Unknown section compression: "
+                   << static_cast<int>(section.compression);
+        return DUMPFILE_ERROR::UNCOMPRESS_FAILED;
+    } else if (section.rawLength > kMaxStringLength_) {
+        LOG(ERROR) << "The section is too large, size(" << section.rawLength
+                   << ") > limit(" << kMaxStringLength_ << ")";
+        return DUMPFILE_ERROR::EXCEED_MAX_STRING_LENGTH;
+    }
+
+    pairs->assign(section.rawLength, '\0');
+    int length = LZ4_decompress_safe(data.data(), &(*pairs)[0], data.size(),
+                                     section.rawLength);
+    if (length < 0 || static_cast<uint64_t>(length) != section.rawLength) {
+        LOG(ERROR) << "Uncompress section failed, ret = " << length
+                   << ", offset = " << section.offset;
+        return DUMPFILE_ERROR::UNCOMPRESS_FAILED;
+    }
+    return DUMPFILE_ERROR::OK;
+}
+
+DUMPFILE_ERROR DumpFile::ParseEntry(const std::string& pairs,
+                                    size_t* pos,
+                                    std::string* entry) {
+    uint32_t length;
+    if (pairs.size() - *pos < sizeof(length)) {
+        return DUMPFILE_ERROR::READ_FAILED;
+    }
+    memcpy(&length, pairs.data() + *pos, sizeof(length));
+    *pos += sizeof(length);
+
+    if (length > kMaxStringLength_) {
+        LOG(ERROR) << "The loaded string is too large, size("
+                   << length << ") > limit(" << kMaxStringLength_ << ")";
+        return DUMPFILE_ERROR::EXCEED_MAX_STRING_LENGTH;
+    } else if (pairs.size() - *pos < length) {
+        return DUMPFILE_ERROR::READ_FAILED;
+    }
+    entry->assign(pairs, *pos, length);
+    *pos += length;
+    return DUMPFILE_ERROR::OK;
+}
+
+DUMPFILE_ERROR DumpFile::Save(
+    const std::vector<std::shared_ptr<Iterator>>& shards) {
+    if (fd_ < 0) {
+        return DUMPFILE_ERROR::BAD_FD;
+    } else if (version_ < kDumpFileV5) {
+        return Save(std::make_shared<MergeIterator>(shards));
+    }
+
+    off_t offset = 0;
+    uint32_t checkSum = 0;
+
+    // Step1: save magic, version and the placeholder of table offset
+    RETURN_IF_UNSUCCESS(SaveString(kCurvefs_, &offset, &checkSum));
+    RETURN_IF_UNSUCCESS(SaveInt<uint8_t>(version_, &offset, &checkSum));
+    off_t tableOffsetPos = offset;
+    uint32_t dummyCheckSum = 0;
+    RETURN_IF_UNSUCCESS(SaveInt<uint64_t>(0, &offset, &dummyCheckSum));
+
+    // Step2: save sections, shards are distributed to threads and every
+    //        thread reserves the space of its sections before writing them
+    std::mutex mtx;
+    std::vector<DumpFileSection> sections;
+    off_t sectionEnd = offset;
+    auto retCode = DUMPFILE_ERROR::OK;
+    auto saveSection = [&](std::string* pairs, uint64_t nPairs) {
+        DumpFileSection section;
+        EncodeSection(pairs, nPairs, &section);
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (retCode != DUMPFILE_ERROR::OK) {
+                return retCode;
+            }
+            section.offset = sectionEnd;
+            sectionEnd += section.length;
+            sections.push_back(section);
+        }
+        return Write(pairs->data(), section.offset, section.length);
+    };
+
+    auto saveShards = [&](size_t index, size_t step) {
+        std::string pairs;
+        uint64_t nPairs = 0;
+        auto rc = DUMPFILE_ERROR::OK;
+        for (size_t i = index; i < shards.size(); i += step) {
+            const auto& iter = shards[i];
+            for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+                AppendEntry(iter->Key(), &pairs);
+                AppendEntry(iter->Value(), &pairs);
+                nPairs++;
+                if (pairs.size() < kSectionSize_) {
+                    continue;
+                }
+
+                rc = saveSection(&pairs, nPairs);
+                if (rc != DUMPFILE_ERROR::OK) {
+                    break;
+                }
+                pairs.clear();
+                nPairs = 0;
+            }
+            if (rc != DUMPFILE_ERROR::OK) {
+                break;
+            }
+        }
+        if (rc == DUMPFILE_ERROR::OK && nPairs > 0) {
+            rc = saveSection(&pairs, nPairs);
+        }
+
+        std::lock_guard<std::mutex> lk(mtx);
+        if (retCode == DUMPFILE_ERROR::OK) {
+            retCode = rc;
+        }
+    };
+
+    size_t nThreads = std::min<size_t>(DumpFileThreads(), shards.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nThreads; i++) {
+        threads.emplace_back(saveShards, i, nThreads);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    RETURN_IF_UNSUCCESS(retCode);
+
+    // Step3: save table offset, section table and checksum
+    RETURN_IF_UNSUCCESS(SaveInt<uint64_t>(sectionEnd, &tableOffsetPos,
+                                          &checkSum));
+    offset = sectionEnd;
+    RETURN_IF_UNSUCCESS(SaveSectionTable(sections, &offset, &checkSum));
+    uint32_t realCheckSum = checkSum;
+    RETURN_IF_UNSUCCESS(SaveInt<uint32_t>(checkSum, &offset, &checkSum));
+
+    // Step4: sync
+    auto ret = fs_->Fsync(fd_);
+    if (ret != 0) {
+        LOG(ERROR) << "Sync data to disk failed, retCode = " << ret;
+        return  DUMPFILE_ERROR::SYNC_FAILED;
+    }
+
+    uint64_t nPairs = 0;
+    for (const auto& section : sections) {
+        nPairs += section.nPairs;
+    }
+    LOG(INFO) << "Save success, version = " << std::to_string(version_)
+              << ", number of shards = " << shards.size()
+              << ", number of threads = " << nThreads
+              << ", number of sections = " << sections.size()
+              << ", number of saved entrys = " << nPairs
+              << ", checksum = " << realCheckSum;
+    return DUMPFILE_ERROR::OK;
+}
+
 DUMPFILE_ERROR DumpFile::WaitSaveDone(pid_t childpid) {
     int status;
     if (waitpid(childpid, &status, WUNTRACED) == -1) {
@@ -422,7 +698,8 @@ DUMPFILE_ERROR DumpFile::CloseSockets() {
                        DUMPFILE_ERROR::OK;
 }
 
-void DumpFile::SaveWorker(std::shared_ptr<Iterator> iter) {
+void DumpFile::SaveWorker(
+    const std::vector<std::shared_ptr<Iterator>>& shards) {
     // If we use multi-raft, there maybe multi process to do save
     // at the same time, so we should to distinguish them
     auto title = "curvefs: save process [filepath: " + pathname_ + "]";
@@ -445,7 +722,7 @@ void DumpFile::SaveWorker(std::shared_ptr<Iterator> iter) {
     // We should ensure the child process exit when the parent exit
     prctl(PR_SET_PDEATHSIG, SIGKILL);
 
-    retCode = Save(iter);
+    retCode = Save(shards);
     auto succ = (retCode == DUMPFILE_ERROR::OK);
     LOG(INFO) << "[child] Save " << (succ ? "success" : "fail")
               << ", retCode = " << retCode;
@@ -455,6 +732,13 @@ void DumpFile::SaveWorker(std::shared_ptr<Iterator> iter) {
 
 DUMPFILE_ERROR DumpFile::SaveBackground(std::shared_ptr<Iterator> iter,
                                         DumpFileClosure* done) {
+    return SaveBackground(std::vector<std::shared_ptr<Iterator>>{ iter },
+                          done);
+}
+
+DUMPFILE_ERROR DumpFile::SaveBackground(
+    const std::vector<std::shared_ptr<Iterator>>& shards,
+    DumpFileClosure* done) {
     if (fd_ < 0) {
         if (done != nullptr) {
             done->Runned();
@@ -463,7 +747,7 @@ DUMPFILE_ERROR DumpFile::SaveBackground(std::shared_ptr<Iterator> iter,
     }
 
     auto startTime = ::curve::common::TimeUtility::GetTimeofDayMs();
-    auto proc = [this, iter]() { SaveWorker(iter); };
+    auto proc = [this, shards]() { SaveWorker(shards); };
     pid_t childpid = ::curvefs::common::Process::SpawnProcess(proc);
     if (done != nullptr) {  // child process forked
         done->Runned();
@@ -507,7 +791,9 @@ DumpFileIterator::DumpFileIterator(DumpFile* dumpfile)
       size_(0),
       isValid_(false),
       startTime_(::curve::common::TimeUtility::GetTimeofDayMs()),
-      dumpfile_(dumpfile) {
+      dumpfile_(dumpfile),
+      nextSection_(0),
+      pos_(0) {
 }
 
 bool DumpFileIterator::Valid() {
@@ -548,20 +834,101 @@ void DumpFileIterator::SeekToFirst() {
                               DUMPFILE_LOAD_STATUS::INVALID_SIZE);
     }
 
+    // section table (only v5), it's verified before loading any section
+    if (dumpfile_->GetVersion() >= kDumpFileV5) {
+        uint64_t tableOffset;
+        retCode = dumpfile_->LoadInt<uint64_t>(
+            &tableOffset, &offset_, &checkSum_);
+        EXIT_LOAD_IF_UNEXPECT(retCode != DUMPFILE_ERROR::OK,
+                              DUMPFILE_LOAD_STATUS::INVALID_SIZE);
+
+        offset_ = tableOffset;
+        retCode = dumpfile_->LoadSectionTable(
+            &sections_, &offset_, &checkSum_);
+        EXIT_LOAD_IF_UNEXPECT(retCode != DUMPFILE_ERROR::OK,
+                              DUMPFILE_LOAD_STATUS::INVALID_SIZE);
+
+        uint32_t crc4load;
+        uint32_t crc4calc = checkSum_;
+        retCode = dumpfile_->LoadInt<uint32_t>(&crc4load, &offset_, &checkSum_);
+        EXIT_LOAD_IF_UNEXPECT(
+            retCode != DUMPFILE_ERROR::OK || crc4load != crc4calc,
+            DUMPFILE_LOAD_STATUS::INVALID_CHECKSUM);
+
+        for (const auto& section : sections_) {
+            size += section.nPairs;
+        }
+        LoadSectionsAhead();
+    }
+
     size_ = size;
     isValid_ = true;
     Next();
 }
 
+void DumpFileIterator::LoadSectionsAhead() {
+    while (loading_.size() < DumpFileThreads() &&
+           nextSection_ < sections_.size()) {
+        auto section = sections_[nextSection_++];
+        loading_.emplace_back(std::async(std::launch::async,
+            [this, section]() {
+                SectionData data;
+                data.first = dumpfile_->LoadSection(section, &data.second);
+                return data;
+            }));
+    }
+}
+
+void DumpFileIterator::NextInSection() {
+    while (pos_ >= pairs_.size()) {
+        if (loading_.empty()) {
+            return End();
+        }
+
+        auto data = loading_.front().get();
+        loading_.pop_front();
+        LoadSectionsAhead();
+        EXIT_LOAD_IF_UNEXPECT(
+            data.first == DUMPFILE_ERROR::CHECKSUM_MISMATCH,
+            DUMPFILE_LOAD_STATUS::INVALID_CHECKSUM);
+        EXIT_LOAD_IF_UNEXPECT(data.first != DUMPFILE_ERROR::OK,
+                              DUMPFILE_LOAD_STATUS::INVALID_PAIRS);
+        pairs_.swap(data.second);
+        pos_ = 0;
+    }
+
+    std::string key, value;
+    auto retCode = DumpFile::ParseEntry(pairs_, &pos_, &key);
+    EXIT_LOAD_IF_UNEXPECT(retCode != DUMPFILE_ERROR::OK,
+                          DUMPFILE_LOAD_STATUS::INVALID_PAIRS);
+    retCode = DumpFile::ParseEntry(pairs_, &pos_, &value);
+    EXIT_LOAD_IF_UNEXPECT(retCode != DUMPFILE_ERROR::OK,
+                          DUMPFILE_LOAD_STATUS::INVALID_PAIRS);
+
+    nPairs_++;
+    iter_.first = std::move(key);
+    iter_.second = std::move(value);
+}
+
 void DumpFileIterator::End() {
     uint32_t crc4load;
     uint32_t crc4calc = checkSum_;
-
-    auto retCode =
-        dumpfile_->LoadInt<uint32_t>(&crc4load, &offset_, &checkSum_);
-    auto succ = (retCode == DUMPFILE_ERROR::OK) && (crc4load == crc4calc);
-    auto status = succ ? DUMPFILE_LOAD_STATUS::COMPLETE :
-                         DUMPFILE_LOAD_STATUS::INVALID_CHECKSUM;
+    bool succ;
+    DUMPFILE_LOAD_STATUS status;
+
+    if (dumpfile_->GetVersion() >= kDumpFileV5) {
+        // the checksum of v5 has been verified before loading sections
+        crc4load = crc4calc;
+        succ = (nPairs_ == size_);
+        status = succ ? DUMPFILE_LOAD_STATUS::COMPLETE :
+                        DUMPFILE_LOAD_STATUS::INVALID_PAIRS;
+    } else {
+        auto retCode =
+            dumpfile_->LoadInt<uint32_t>(&crc4load, &offset_, &checkSum_);
+        succ = (retCode == DUMPFILE_ERROR::OK) && (crc4load == crc4calc);
+        status = succ ? DUMPFILE_LOAD_STATUS::COMPLETE :
+                        DUMPFILE_LOAD_STATUS::INVALID_CHECKSUM;
+    }
 
     auto endTime = ::curve::common::TimeUtility::GetTimeofDayMs();
     double elapsed = (endTime - startTime_) * 1.0 / 1000;
@@ -573,7 +940,8 @@ void DumpFileIterator::End() {
        << ", cost " << elapsed << " seconds"
        << ", version = " << std::to_string(version)
        << ", loaded size = "
-       << (version == kDumpFileV1 ? std::to_string(size_) : "unknown")
+       << (version == kDumpFileV1 || version >= kDumpFileV5 ?
+           std::to_string(size_) : "unknown")
        << ", number of loaded entrys = " << nPairs_
        << ", loaded checksum = " << crc4load
        << ", calculate checksum = " << crc4calc;
@@ -592,6 +960,8 @@ void DumpFileIterator::Next() {
         return;
     } else if (dumpfile_->version_ == 1 && nPairs_ == size_) {
         return End();
+    } else if (dumpfile_->version_ >= kDumpFileV5) {
+        return NextInSection();
     }
 
     std::string key, value;
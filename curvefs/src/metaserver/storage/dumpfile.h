@@ -23,14 +23,24 @@
 #ifndef CURVEFS_SRC_METASERVER_STORAGE_DUMPFILE_H_
 #define CURVEFS_SRC_METASERVER_STORAGE_DUMPFILE_H_
 
+#include <gflags/gflags.h>
+#include <signal.h>
+
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include <condition_variable>
 
 #include "curvefs/src/metaserver/storage/iterator.h"
 
+DECLARE_bool(dumpfile_sections);
+DECLARE_uint32(dumpfile_threads);
+DECLARE_bool(dumpfile_compression);
+
 namespace curve {
 namespace fs {
 
@@ -62,6 +72,8 @@ enum class DUMPFILE_ERROR {
     WAITPID_FAILED,
     UNEXPECTED_SIGNAL,
     ENCOUNTER_EOF,
+    CHECKSUM_MISMATCH,
+    UNCOMPRESS_FAILED,
 };
 
 enum class DUMPFILE_LOAD_STATUS {
@@ -91,6 +103,28 @@ enum DumpFileVersion : uint8_t {
     // kDumpFileV3 (because they're not inserted into rocksdb), other metadata
     // is saved by rocksdb
     kDumpFileV4 = 4,
+    // Version 5 splits key-value pairs into sections, each section is
+    // checksummed and optionally compressed on its own, so a dumpfile can be
+    // saved and loaded by multiple threads, it's saved by default only if
+    // `FLAGS_dumpfile_sections` is set because older versions can't load it
+    kDumpFileV5 = 5,
+};
+
+enum DumpFileCompression : uint8_t {
+    kNoCompression = 0,
+    kLz4Compression = 1,
+};
+
+struct DumpFileSection {
+    uint64_t offset;
+    // number of bytes stored in file
+    uint64_t length;
+    // number of bytes of the uncompressed key_value_pairs
+    uint64_t rawLength;
+    uint64_t nPairs;
+    uint8_t compression;
+    // checksum of the stored bytes
+    uint32_t checkSum;
 };
 
 std::ostream& operator<<(std::ostream& os, DUMPFILE_ERROR code);
@@ -141,6 +175,28 @@ class DumpFileIterator;
  *      EOF:      uint32_t  (4-bytes)
  *      checksum: uint32_t  (4-bytes)
  *
+ * v5:
+ *   +---------+---------+--------------+-----------+-----+-----------+
+ *   | CURVEFS | version | table_offset | section_1 | ... | section_n |
+ *   +---------+---------+--------------+-----------+-----+-----------+
+ *   +---------------+-----------+
+ *   | section_table | check_sum |
+ *   +---------------+-----------+
+ *      CURVEFS:      "CURVEFS" (7-bytes)
+ *      version:      uint8_t   (1-byte)
+ *      table_offset: uint64_t  (8-bytes)
+ *      section:      key_value_pairs, compressed if the section says so
+ *      checksum:     uint32_t  (4-bytes), it covers everything except the
+ *                    sections, which are covered by their own checksum
+ *
+ * section_table format:
+ *   +------------+-----------+-----+-----------+
+ *   | n_sections | section_1 | ... | section_n |
+ *   +------------+-----------+-----+-----------+
+ *      n_sections: uint32_t (4-bytes)
+ *      section:    offset (8-bytes), length (8-bytes), raw_length (8-bytes),
+ *                  n_pairs (8-bytes), compression (1-byte), checksum (4-bytes)
+ *
  * key_value_pairs format:
  *   +--------------+-------+----------------+---------+-----+--------------+-------+----------------+---------+
  *   | key_1_length | key_1 | value_1_length | value_1 | ... | key_n_length | key_n | value_n_length | value_n |
@@ -159,9 +215,17 @@ class DumpFile {
 
     DUMPFILE_ERROR Save(std::shared_ptr<Iterator> iter);
 
+    // Save the shards by multiple threads (v5 only), the order of key-value
+    // pairs inside a shard is preserved, but not across shards
+    DUMPFILE_ERROR Save(const std::vector<std::shared_ptr<Iterator>>& shards);
+
     DUMPFILE_ERROR SaveBackground(std::shared_ptr<Iterator> iter,
                                   DumpFileClosure* done = nullptr);
 
+    DUMPFILE_ERROR SaveBackground(
+        const std::vector<std::shared_ptr<Iterator>>& shards,
+        DumpFileClosure* done = nullptr);
+
     std::shared_ptr<DumpFileIterator> Load();
 
     DUMPFILE_LOAD_STATUS GetLoadStatus();
@@ -198,13 +262,36 @@ class DumpFile {
                              off_t* offset,
                              uint32_t* checkSum);
 
+    // Compress (if enabled) the pairs in place and fill the section
+    // except its offset
+    void EncodeSection(std::string* pairs,
+                       uint64_t nPairs,
+                       DumpFileSection* section);
+
+    DUMPFILE_ERROR SaveSectionTable(
+        const std::vector<DumpFileSection>& sections,
+        off_t* offset,
+        uint32_t* checkSum);
+
+    DUMPFILE_ERROR LoadSection(const DumpFileSection& section,
+                               std::string* pairs);
+
+    DUMPFILE_ERROR LoadSectionTable(std::vector<DumpFileSection>* sections,
+                                    off_t* offset,
+                                    uint32_t* checkSum);
+
+    // Parse an entry from the key_value_pairs of a section
+    static DUMPFILE_ERROR ParseEntry(const std::string& pairs,
+                                     size_t* pos,
+                                     std::string* entry);
+
     static void SignalHandler(int signo, siginfo_t* siginfo, void* ucontext);
 
     DUMPFILE_ERROR InitSignals();
 
     DUMPFILE_ERROR CloseSockets();
 
-    void SaveWorker(std::shared_ptr<Iterator> iter);
+    void SaveWorker(const std::vector<std::shared_ptr<Iterator>>& shards);
 
     DUMPFILE_ERROR WaitSaveDone(pid_t childpid);
 
@@ -215,6 +302,9 @@ class DumpFile {
     // Check whether a version is valid
     static bool CheckDumpFileVersion(uint8_t ver);
 
+    // The version saved by default
+    static uint8_t DefaultVersion();
+
  private:
     std::string pathname_;
 
@@ -228,11 +318,14 @@ class DumpFile {
 
     static const std::string kCurvefs_;
 
+    // The latest version which can be loaded
     static const uint8_t kVersion_;
 
     static const uint32_t kEOF_;
 
     static const uint32_t kMaxStringLength_;
+
+    static const uint64_t kSectionSize_;
 };
 
 class DumpFileIterator : public Iterator {
@@ -265,7 +358,15 @@ class DumpFileIterator : public Iterator {
  private:
     void End();
 
+    // Load the next pair from sections (v5 only)
+    void NextInSection();
+
+    // Keep at most `FLAGS_dumpfile_threads` sections loading in background
+    void LoadSectionsAhead();
+
  private:
+    using SectionData = std::pair<DUMPFILE_ERROR, std::string>;
+
     off_t offset_;
 
     uint32_t checkSum_;
@@ -283,6 +384,17 @@ class DumpFileIterator : public Iterator {
     DumpFile* dumpfile_;
 
     uint8_t version_;
+
+    std::vector<DumpFileSection> sections_;
+
+    size_t nextSection_;
+
+    std::deque<std::future<SectionData>> loading_;
+
+    // key_value_pairs of current section and the parsing position
+    std::string pairs_;
+
+    size_t pos_;
 };
 
 }  // namespace storage
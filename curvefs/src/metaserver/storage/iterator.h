@@ -103,6 +103,8 @@ class MergeIterator : public Iterator {
         return 0;
     }
 
+    const ChildrenType& Children() const { return children_; }
+
  private:
     void FindCurrent() {
         current_ = nullptr;
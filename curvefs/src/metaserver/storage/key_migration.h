@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_STORAGE_KEY_MIGRATION_H_
+#define CURVEFS_SRC_METASERVER_STORAGE_KEY_MIGRATION_H_
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "curvefs/src/metaserver/common/types.h"
+#include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/storage/storage.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace storage {
+
+// Rewrite all keys of table |name| which aren't in current key format,
+// e.g: the table is recovered from a checkpoint written by older version.
+//
+// Only keys are collected in the scan, and they are rewritten in batches,
+// each batch is committed in one transaction.
+template <typename Key, typename Value>
+Status MigrateKeyFormat(KVStorage* kvStorage, const std::string& name,
+                        bool ordered, uint64_t* migrated) {
+    static constexpr size_t kBatchSize = 1024;
+
+    std::vector<std::string> keys;
+    {
+        auto iterator =
+            ordered ? kvStorage->SGetAll(name) : kvStorage->HGetAll(name);
+        if (iterator == nullptr || iterator->Status() != 0) {
+            return Status::InternalError();
+        }
+        const KeyFormat format = GetKeyFormat();
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            std::string key = iterator->Key();
+            if (FormatOfKey(key) != format) {
+                keys.emplace_back(std::move(key));
+            }
+        }
+    }
+
+    *migrated = 0;
+    Converter conv;
+    Key key;
+    Value value;
+    for (size_t begin = 0; begin < keys.size(); begin += kBatchSize) {
+        auto txn = kvStorage->BeginTransaction();
+        if (txn == nullptr) {
+            return Status::InternalError();
+        }
+
+        Status s;
+        size_t end = std::min(begin + kBatchSize, keys.size());
+        for (size_t i = begin; i < end && s.ok(); i++) {
+            const auto& oldKey = keys[i];
+            if (!conv.ParseFromString(oldKey, &key)) {
+                s = Status::ParsedFailed();
+                break;
+            }
+            std::string newKey = conv.SerializeToString(key);
+            if (ordered) {
+                s = txn->SGet(name, oldKey, &value);
+                s = s.ok() ? txn->SSet(name, newKey, value) : s;
+                s = s.ok() ? txn->SDel(name, oldKey) : s;
+            } else {
+                s = txn->HGet(name, oldKey, &value);
+                s = s.ok() ? txn->HSet(name, newKey, value) : s;
+                s = s.ok() ? txn->HDel(name, oldKey) : s;
+            }
+        }
+
+        s = s.ok() ? txn->Commit() : s;
+        if (!s.ok()) {
+            LOG(ERROR) << "Migrate key format failed, table = "
+                       << StringToHex(name) << ", status = " << s.ToString();
+            if (!txn->Rollback().ok()) {
+                LOG(ERROR) << "Rollback transaction failed";
+            }
+            return s;
+        }
+        *migrated += end - begin;
+    }
+    return Status::OK();
+}
+
+}  // namespace storage
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_STORAGE_KEY_MIGRATION_H_
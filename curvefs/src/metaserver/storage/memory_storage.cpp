@@ -21,10 +21,14 @@
  */
 
 #include <glog/logging.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
 
+#include <cstring>
 #include <string>
 #include <memory>
 
+#include "absl/cleanup/cleanup.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/src/metaserver/storage/memory_storage.h"
 
@@ -43,6 +47,72 @@ using OrderedContainerType =
 using OrderedSeralizedContainerType =
     MemoryStorage::OrderedSeralizedContainerType;
 
+namespace {
+
+const char* const kMemoryCheckpointPath = "memory_checkpoint";
+
+const char kHashTable = 'h';
+const char kSortedTable = 's';
+
+// The key of a dumped pair is <kind><table name length><table name><key>,
+// and its value is <message type name>\0<serialized message>, the type
+// name is empty if the table is stored serialized.
+class CheckpointIterator : public Iterator {
+ public:
+    CheckpointIterator(char kind, const std::string& name,
+                       std::shared_ptr<Iterator> iterator)
+        : iterator_(std::move(iterator)) {
+        uint32_t length = name.size();
+        prefix_.push_back(kind);
+        prefix_.append(reinterpret_cast<char*>(&length), sizeof(length));
+        prefix_.append(name);
+    }
+
+    uint64_t Size() override { return iterator_->Size(); }
+
+    bool Valid() override { return iterator_->Valid(); }
+
+    void SeekToFirst() override { iterator_->SeekToFirst(); }
+
+    void Next() override { iterator_->Next(); }
+
+    std::string Key() override { return prefix_ + iterator_->Key(); }
+
+    std::string Value() override {
+        const ValueType* message = iterator_->RawValue();
+        std::string value = message == nullptr ? "" : message->GetTypeName();
+        value.push_back('\0');
+        return value.append(iterator_->Value());
+    }
+
+    bool ParseFromValue(ValueType* /*value*/) override { return true; }
+
+    int Status() override { return iterator_->Status(); }
+
+ private:
+    std::string prefix_;
+    std::shared_ptr<Iterator> iterator_;
+};
+
+bool DecodeCheckpointKey(const std::string& ikey, char* kind,
+                         std::string* name, std::string* key) {
+    uint32_t length;
+    if (ikey.size() < 1 + sizeof(length)) {
+        return false;
+    }
+    memcpy(&length, ikey.data() + 1, sizeof(length));
+    size_t offset = 1 + sizeof(length);
+    if (ikey.size() - offset < length) {
+        return false;
+    }
+    *kind = ikey[0];
+    name->assign(ikey, offset, length);
+    key->assign(ikey, offset + length, std::string::npos);
+    return true;
+}
+
+}  // namespace
+
 MemoryStorage::MemoryStorage(StorageOptions options)
     : options_(options) {}
 
@@ -88,7 +158,9 @@ do {                                            \
     if (iter == container->end()) {             \
         return Status::NotFound();              \
     }                                           \
-    VALUE->CopyFrom(*iter->second.Message());   \
+    if (!iter->second.CopyTo(VALUE)) {          \
+        return Status::ParsedFailed();          \
+    }                                           \
     return Status::OK();                        \
 } while (0)
 
@@ -299,18 +371,168 @@ StorageOptions MemoryStorage::GetStorageOptions() const {
     return options_;
 }
 
+bool MemoryStorage::SaveCheckpoint(const std::string& dir,
+                                   DumpFileClosure* done) {
+    std::vector<std::shared_ptr<Iterator>> shards;
+    {
+        ReadLockGuard readLockGuard(rwLock_);
+        for (const auto& item : UnorderedContainerDict_) {
+            shards.push_back(std::make_shared<CheckpointIterator>(
+                kHashTable, item.first,
+                std::make_shared<UnorderedContainerIterator<
+                    UnorderedContainerType>>(item.second, "")));
+        }
+        for (const auto& item : UnorderedSeralizedContainerDict_) {
+            shards.push_back(std::make_shared<CheckpointIterator>(
+                kHashTable, item.first,
+                std::make_shared<UnorderedSeralizedContainerIterator<
+                    UnorderedSeralizedContainerType>>(item.second, "")));
+        }
+        for (const auto& item : OrderedContainerDict_) {
+            shards.push_back(std::make_shared<CheckpointIterator>(
+                kSortedTable, item.first,
+                std::make_shared<OrderedContainerIterator<
+                    OrderedContainerType>>(item.second, "")));
+        }
+        for (const auto& item : OrderedSeralizedContainerDict_) {
+            shards.push_back(std::make_shared<CheckpointIterator>(
+                kSortedTable, item.first,
+                std::make_shared<OrderedSeralizedContainerIterator<
+                    OrderedSeralizedContainerType>>(item.second, "")));
+        }
+    }
+
+    // it's never loaded by older versions, so it's always sectioned
+    auto dumpfile = DumpFile(dir + "/" + kMemoryCheckpointPath, kDumpFileV5);
+    if (dumpfile.Open() != DUMPFILE_ERROR::OK) {
+        LOG(ERROR) << "Open memory checkpoint failed, dir = " << dir;
+        if (done != nullptr) {
+            done->Runned();
+        }
+        return false;
+    }
+
+    auto defer = absl::MakeCleanup([&dumpfile]() { dumpfile.Close(); });
+    auto rc = dumpfile.SaveBackground(shards, done);
+    LOG(INFO) << "Save memory checkpoint to `" << dir << "`, tables = "
+              << shards.size() << ", retCode = " << rc;
+    return rc == DUMPFILE_ERROR::OK;
+}
+
+bool MemoryStorage::PrepareCheckpoint(const std::string& dir) {
+    std::lock_guard<std::mutex> lk(checkpointMutex_);
+    DumpFileClosure forked;
+    checkpointDir_ = dir;
+    checkpoint_ = std::async(std::launch::async, [this, dir, &forked]() {
+        return SaveCheckpoint(dir, &forked);
+    });
+    forked.WaitRunned();
+    return true;
+}
+
 bool MemoryStorage::Checkpoint(const std::string& dir,
                                std::vector<std::string>* files) {
-    (void)dir;
-    (void)files;
-    LOG(WARNING) << "Not supported";
-    return false;
+    bool succ;
+    {
+        std::lock_guard<std::mutex> lk(checkpointMutex_);
+        if (checkpoint_.valid() && checkpointDir_ == dir) {
+            succ = checkpoint_.get();
+        } else {
+            succ = SaveCheckpoint(dir, nullptr);
+        }
+    }
+
+    if (succ) {
+        files->push_back(kMemoryCheckpointPath);
+    }
+    return succ;
+}
+
+bool MemoryStorage::RecoverPair(const std::string& ikey,
+                                const std::string& ivalue) {
+    char kind;
+    std::string name, key;
+    size_t pos = ivalue.find('\0');
+    if (!DecodeCheckpointKey(ikey, &kind, &name, &key) ||
+        (kind != kHashTable && kind != kSortedTable) ||
+        pos == std::string::npos) {
+        LOG(ERROR) << "Invalid pair in memory checkpoint";
+        return false;
+    }
+
+    std::string svalue = ivalue.substr(pos + 1);
+    if (options_.compression) {
+        if (kind == kHashTable) {
+            auto container = GET_CONTAINER(UnorderedSeralizedContainer, name);
+            (*container)[key] = std::move(svalue);
+        } else {
+            auto container = GET_CONTAINER(OrderedSeralizedContainer, name);
+            (*container)[key] = std::move(svalue);
+        }
+        return true;
+    }
+
+    // the type of message is needed to keep it unserialized
+    std::string typeName = ivalue.substr(0, pos);
+    const auto* descriptor =
+        google::protobuf::DescriptorPool::generated_pool()
+            ->FindMessageTypeByName(typeName);
+    if (descriptor == nullptr) {
+        LOG(ERROR) << "Unknown message type `" << typeName << "` of table "
+                   << name << ", the checkpoint may be saved with "
+                   << "storage.memory.compression enabled";
+        return false;
+    }
+
+    std::unique_ptr<ValueType> message(
+        google::protobuf::MessageFactory::generated_factory()
+            ->GetPrototype(descriptor)->New());
+    if (!message->ParseFromString(svalue)) {
+        return false;
+    }
+
+    auto valueWrapper = ValueWrapper(std::move(message));
+    if (kind == kHashTable) {
+        auto container = GET_CONTAINER(UnorderedContainer, name);
+        (*container)[key].Swap(valueWrapper);
+    } else {
+        auto container = GET_CONTAINER(OrderedContainer, name);
+        (*container)[key].Swap(valueWrapper);
+    }
+    return true;
 }
 
 bool MemoryStorage::Recover(const std::string& dir) {
-    (void)dir;
-    LOG(WARNING) << "Not supported";
-    return false;
+    LOG(INFO) << "Recovering storage from `" << dir << "`";
+
+    {
+        WriteLockGuard writeLockGuard(rwLock_);
+        UnorderedContainerDict_.clear();
+        UnorderedSeralizedContainerDict_.clear();
+        OrderedContainerDict_.clear();
+        OrderedSeralizedContainerDict_.clear();
+    }
+
+    auto dumpfile = DumpFile(dir + "/" + kMemoryCheckpointPath);
+    if (dumpfile.Open() != DUMPFILE_ERROR::OK) {
+        LOG(ERROR) << "Open memory checkpoint failed, dir = " << dir;
+        return false;
+    }
+
+    auto defer = absl::MakeCleanup([&dumpfile]() { dumpfile.Close(); });
+    auto iter = dumpfile.Load();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        if (!RecoverPair(iter->Key(), iter->Value())) {
+            return false;
+        }
+    }
+
+    auto status = dumpfile.GetLoadStatus();
+    if (status != DUMPFILE_LOAD_STATUS::COMPLETE) {
+        LOG(ERROR) << "Load memory checkpoint failed, status = " << status;
+        return false;
+    }
+    return true;
 }
 
 }  // namespace storage
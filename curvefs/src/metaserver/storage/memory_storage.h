@@ -23,6 +23,8 @@
 #ifndef CURVEFS_SRC_METASERVER_STORAGE_MEMORY_STORAGE_H_
 #define CURVEFS_SRC_METASERVER_STORAGE_MEMORY_STORAGE_H_
 
+#include <future>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <utility>
@@ -34,6 +36,7 @@
 #include "src/common/concurrent/rw_lock.h"
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/metaserver/storage/common.h"
+#include "curvefs/src/metaserver/storage/dumpfile.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/iterator.h"
 #include "curvefs/src/metaserver/storage/value_wrapper.h"
@@ -118,15 +121,34 @@ class MemoryStorage : public KVStorage, public StorageTransaction {
 
     Status Rollback() override;
 
+    // All tables are dumped into a sectioned dumpfile by a forked process,
+    // one shard for each table, so it's consistent only if nobody modifies
+    // the storage while forking. If `PrepareCheckpoint(dir)` was called
+    // before, it only waits for the process forked by it.
     bool Checkpoint(const std::string& dir,
                     std::vector<std::string>* files) override;
 
+    // Fork the process which dumps the checkpoint into `dir` and return
+    // once it's forked
+    bool PrepareCheckpoint(const std::string& dir) override;
+
     bool Recover(const std::string& dir) override;
 
+ private:
+    // Dump all tables into `dir` by a forked process, `done` is invoked
+    // once the process is forked
+    bool SaveCheckpoint(const std::string& dir, DumpFileClosure* done);
+
+    bool RecoverPair(const std::string& ikey, const std::string& ivalue);
+
  private:
     RWLock rwLock_;
     StorageOptions options_;
 
+    std::mutex checkpointMutex_;
+    std::string checkpointDir_;
+    std::future<bool> checkpoint_;
+
     std::unordered_map<std::string,
                        std::shared_ptr<UnorderedContainerType>>
         UnorderedContainerDict_;
@@ -224,9 +246,7 @@ class UnorderedContainerIterator : public MemoryStorageIterator<ContainerType> {
     }
 
     bool ParseFromValue(ValueType* value) override {
-        auto message = this->current_->second.Message();
-        value->CopyFrom(*message);
-        return true;
+        return this->current_->second.CopyTo(value);
     }
 };
 
@@ -275,9 +295,7 @@ class OrderedContainerIterator : public MemoryStorageIterator<ContainerType> {
     }
 
     bool ParseFromValue(ValueType* value) override {
-        auto message = this->current_->second.Message();
-        value->CopyFrom(*message);
-        return true;
+        return this->current_->second.CopyTo(value);
     }
 };
 
@@ -106,6 +106,13 @@ DEFINE_int32(rocksdb_stats_dump_period_sec,
              180,
              "Dump rocksdb.stats to LOG every stats_dump_period_sec");
 
+// NOTE: the WAL is disabled and raft log provides durability, so mutations
+// of applied raft entries can be accumulated in memory and written together
+DEFINE_int64(rocksdb_write_batch_size,
+             0,
+             "Write accumulated mutations to rocksdb once their size reach "
+             "it, 0 means write every mutation immediately");
+
 namespace {
 
 std::shared_ptr<rocksdb::Cache> rocksdbBlockCache;
@@ -267,6 +274,9 @@ void ParseRocksdbOptions(curve::common::Configuration* conf) {
     dummy.Load(conf, "rocksdb_stats_dump_period_sec",
                "storage.rocksdb.stats_dump_period_sec",
                &FLAGS_rocksdb_stats_dump_period_sec, /*fatalIfMissing*/ false);
+    dummy.Load(conf, "rocksdb_write_batch_size",
+               "storage.rocksdb.write_batch_size",
+               &FLAGS_rocksdb_write_batch_size, /*fatalIfMissing*/ false);
 }
 
 }  // namespace storage
@@ -23,6 +23,8 @@
 #ifndef CURVEFS_SRC_METASERVER_STORAGE_ROCKSDB_OPTIONS_H_
 #define CURVEFS_SRC_METASERVER_STORAGE_ROCKSDB_OPTIONS_H_
 
+#include <gflags/gflags.h>
+
 #include <vector>
 
 #include "rocksdb/db.h"
@@ -38,6 +40,8 @@ namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+DECLARE_int64(rocksdb_write_batch_size);
+
 // Parse rocksdb related options from conf
 void ParseRocksdbOptions(curve::common::Configuration* conf);
 
@@ -68,6 +68,7 @@ enum OPERATOR_TYPE : unsigned char {
     OP_BEGIN_TRANSACTION = 12,
     OP_COMMIT_TRANSACTION = 13,
     OP_ROLLBACK_TRANSACTION = 14,
+    OP_WRITE_BATCH = 15,
 };
 
 class RocksDBPerfGuard {
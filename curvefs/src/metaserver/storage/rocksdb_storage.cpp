@@ -87,6 +87,11 @@ RocksDBStorage::RocksDBStorage(const RocksDBStorage& storage,
       handles_(storage.handles_),
       InTransaction_(true),
       txn_(txn),
+      txnBatch_(txn == nullptr ? new WriteBatchWithIndex(
+                                     ROCKSDB_NAMESPACE::BytewiseComparator(),
+                                     0, /*overwrite_key*/ true)
+                               : nullptr),
+      pending_(storage.pending_),
       dbOptions_(storage.dbOptions_),
       dbTransOptions_(storage.dbTransOptions_),
       dbWriteOptions_(storage.dbWriteOptions_),
@@ -125,6 +130,9 @@ bool RocksDBStorage::Open() {
     }
 
     db_ = txnDB_->GetBaseDB();
+    if (FLAGS_rocksdb_write_batch_size > 0) {
+        pending_ = std::make_shared<PendingWriteBatch>();
+    }
 
     inited_ = true;
     return true;
@@ -135,6 +143,21 @@ bool RocksDBStorage::Close() {
         return true;
     }
 
+    if (BatchEnabled()) {
+        Status st = FlushPendingBatch();
+        if (!st.ok()) {
+            LOG(ERROR) << "Write pending batch before close failed, status = "
+                       << st.ToString();
+            return false;
+        }
+        pending_.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(checkpointMutex_);
+        checkpointDir_.clear();
+    }
+
     ROCKSDB_NAMESPACE::Status s;
     for (auto handle : handles_) {
         s = db_->DestroyColumnFamilyHandle(handle);
@@ -212,8 +235,18 @@ Status RocksDBStorage::Get(const std::string& name,
     auto handle = GetColumnFamilyHandle(ordered);
     {
         RocksDBPerfGuard guard(OP_GET);
-        s = InTransaction_ ? txn_->Get(dbReadOptions_, handle, ikey, &svalue) :
-                             db_->Get(dbReadOptions_, handle, ikey, &svalue);
+        if (txn_ != nullptr) {
+            s = txn_->Get(dbReadOptions_, handle, ikey, &svalue);
+        } else if (txnBatch_ != nullptr &&
+                   GetFromTxnBatch(handle, ikey, &s, &svalue)) {
+            // written or deleted by current transaction
+        } else if (BatchEnabled()) {
+            ReadLockGuard readLockGuard(pending_->rwLock);
+            s = pending_->batch.GetFromBatchAndDB(db_, dbReadOptions_, handle,
+                                                  ikey, &svalue);
+        } else {
+            s = db_->Get(dbReadOptions_, handle, ikey, &svalue);
+        }
     }
     if (s.ok() && !value->ParseFromString(svalue)) {
         return Status::ParsedFailed();
@@ -234,6 +267,14 @@ Status RocksDBStorage::Set(const std::string& name,
 
     auto handle = GetColumnFamilyHandle(ordered);
     std::string ikey = ToInternalKey(name, key, ordered);
+    if (txnBatch_ != nullptr) {
+        return ToStorageStatus(txnBatch_->Put(handle, ikey, svalue));
+    } else if (BatchEnabled()) {
+        WriteBatch batch;
+        batch.Put(handle, ikey, svalue);
+        return AppendPendingBatch(batch);
+    }
+
     RocksDBPerfGuard guard(OP_PUT);
     ROCKSDB_NAMESPACE::Status s = InTransaction_ ?
         txn_->Put(handle, ikey, svalue) :
@@ -250,6 +291,14 @@ Status RocksDBStorage::Del(const std::string& name,
 
     std::string ikey = ToInternalKey(name, key, ordered);
     auto handle = GetColumnFamilyHandle(ordered);
+    if (txnBatch_ != nullptr) {
+        return ToStorageStatus(txnBatch_->Delete(handle, ikey));
+    } else if (BatchEnabled()) {
+        WriteBatch batch;
+        batch.Delete(handle, ikey);
+        return AppendPendingBatch(batch);
+    }
+
     RocksDBPerfGuard guard(OP_DELETE);
     ROCKSDB_NAMESPACE::Status s = InTransaction_ ?
         txn_->Delete(handle, ikey) :
@@ -293,6 +342,11 @@ Status RocksDBStorage::Clear(const std::string& name, bool ordered) {
         // NOTE: rocksdb transaction has no `DeleteRange` function
         // maybe we can implement `Clear` by "iterate and delete"
         return Status::NotSupported();
+    } else if (BatchEnabled()) {
+        Status st = FlushPendingBatch();
+        if (!st.ok()) {
+            return st;
+        }
     }
 
     // TODO(all): Maybe we should let `Clear` just do nothing, because it's only
@@ -313,6 +367,10 @@ Status RocksDBStorage::Clear(const std::string& name, bool ordered) {
 }
 
 std::shared_ptr<StorageTransaction> RocksDBStorage::BeginTransaction() {
+    if (BatchEnabled()) {
+        return std::make_shared<RocksDBStorage>(*this, nullptr);
+    }
+
     RocksDBPerfGuard guard(OP_BEGIN_TRANSACTION);
     ROCKSDB_NAMESPACE::Transaction* txn =
         txnDB_->BeginTransaction(dbWriteOptions_);
@@ -323,8 +381,12 @@ std::shared_ptr<StorageTransaction> RocksDBStorage::BeginTransaction() {
 }
 
 Status RocksDBStorage::Commit() {
-    if (!InTransaction_ || nullptr == txn_) {
+    if (!InTransaction_ || (nullptr == txn_ && nullptr == txnBatch_)) {
         return Status::NotSupported();
+    } else if (txnBatch_ != nullptr) {
+        Status st = AppendPendingBatch(*txnBatch_->GetWriteBatch());
+        txnBatch_->Clear();
+        return st;
     }
 
     RocksDBPerfGuard guard(OP_COMMIT_TRANSACTION);
@@ -338,8 +400,11 @@ Status RocksDBStorage::Commit() {
 }
 
 Status RocksDBStorage::Rollback()  {
-    if (!InTransaction_ || nullptr == txn_) {
+    if (!InTransaction_ || (nullptr == txn_ && nullptr == txnBatch_)) {
         return Status::NotSupported();
+    } else if (txnBatch_ != nullptr) {
+        txnBatch_->Clear();
+        return Status::OK();
     }
 
     RocksDBPerfGuard guard(OP_ROLLBACK_TRANSACTION);
@@ -352,6 +417,160 @@ Status RocksDBStorage::Rollback()  {
     return ToStorageStatus(s);
 }
 
+namespace {
+
+// Append mutations of a write batch to an indexed write batch
+class IndexedBatchAppender : public WriteBatch::Handler {
+ public:
+    IndexedBatchAppender(WriteBatchWithIndex* batch,
+                         const std::vector<ColumnFamilyHandle*>& handles)
+        : batch_(batch), handles_(handles) {}
+
+    ROCKSDB_NAMESPACE::Status PutCF(
+        uint32_t columnFamilyId, const ROCKSDB_NAMESPACE::Slice& key,
+        const ROCKSDB_NAMESPACE::Slice& value) override {
+        auto handle = GetHandle(columnFamilyId);
+        if (handle == nullptr) {
+            return ROCKSDB_NAMESPACE::Status::InvalidArgument();
+        }
+        return batch_->Put(handle, key, value);
+    }
+
+    ROCKSDB_NAMESPACE::Status DeleteCF(
+        uint32_t columnFamilyId,
+        const ROCKSDB_NAMESPACE::Slice& key) override {
+        auto handle = GetHandle(columnFamilyId);
+        if (handle == nullptr) {
+            return ROCKSDB_NAMESPACE::Status::InvalidArgument();
+        }
+        return batch_->Delete(handle, key);
+    }
+
+ private:
+    ColumnFamilyHandle* GetHandle(uint32_t columnFamilyId) const {
+        for (auto handle : handles_) {
+            if (handle->GetID() == columnFamilyId) {
+                return handle;
+            }
+        }
+        return nullptr;
+    }
+
+ private:
+    WriteBatchWithIndex* batch_;
+    const std::vector<ColumnFamilyHandle*>& handles_;
+};
+
+}  // namespace
+
+bool RocksDBStorage::GetFromTxnBatch(ColumnFamilyHandle* handle,
+                                     const std::string& ikey,
+                                     ROCKSDB_NAMESPACE::Status* status,
+                                     std::string* svalue) {
+    std::unique_ptr<ROCKSDB_NAMESPACE::WBWIIterator> iter(
+        txnBatch_->NewIterator(handle));
+    iter->Seek(ikey);
+    if (!iter->Valid() ||
+        iter->Entry().key != ROCKSDB_NAMESPACE::Slice(ikey)) {
+        return false;
+    }
+
+    // the index only keeps the latest entry of each key, see `overwrite_key`
+    auto entry = iter->Entry();
+    switch (entry.type) {
+        case ROCKSDB_NAMESPACE::kPutRecord:
+            svalue->assign(entry.value.data(), entry.value.size());
+            *status = ROCKSDB_NAMESPACE::Status::OK();
+            return true;
+        case ROCKSDB_NAMESPACE::kDeleteRecord:
+            *status = ROCKSDB_NAMESPACE::Status::NotFound();
+            return true;
+        default:
+            return false;
+    }
+}
+
+Status RocksDBStorage::AppendPendingBatch(const WriteBatch& batch) {
+    bool full = false;
+    {
+        WriteLockGuard writeLockGuard(pending_->rwLock);
+        // the mutations are appended all or nothing
+        pending_->batch.SetSavePoint();
+        IndexedBatchAppender appender(&pending_->batch, handles_);
+        ROCKSDB_NAMESPACE::Status s = batch.Iterate(&appender);
+        if (!s.ok()) {
+            LOG(ERROR) << "Append mutations to pending batch failed"
+                       << ", status = " << s.ToString();
+            pending_->batch.RollbackToSavePoint();
+            return ToStorageStatus(s);
+        }
+        pending_->batch.PopSavePoint();
+        full = pending_->batch.GetWriteBatch()->GetDataSize() >=
+               static_cast<size_t>(FLAGS_rocksdb_write_batch_size);
+    }
+
+    // the mutations are visible and will be written by the next flush,
+    // so the failure of flushing doesn't fail the caller, and it's
+    // retried by the next append or checkpoint
+    if (full) {
+        Status st = FlushPendingBatch();
+        LOG_IF(ERROR, !st.ok())
+            << "Flush pending batch failed, it will be retried later";
+    }
+    return Status::OK();
+}
+
+Status RocksDBStorage::FlushPendingBatch() {
+    WriteLockGuard writeLockGuard(pending_->rwLock);
+    WriteBatch* batch = pending_->batch.GetWriteBatch();
+    if (batch->Count() == 0) {
+        return Status::OK();
+    }
+
+    RocksDBPerfGuard guard(OP_WRITE_BATCH);
+    ROCKSDB_NAMESPACE::Status s = db_->Write(dbWriteOptions_, batch);
+    if (!s.ok()) {
+        LOG(ERROR) << "Write pending batch failed, count = " << batch->Count()
+                   << ", status = " << s.ToString();
+        return ToStorageStatus(s);
+    }
+    pending_->batch.Clear();
+    return Status::OK();
+}
+
+std::unique_ptr<WriteBatchWithIndex> RocksDBStorage::CopyPendingMutations(
+    ColumnFamilyHandle* handle,
+    const std::string& start,
+    const std::string& prefix) {
+    std::unique_ptr<WriteBatchWithIndex> copy;
+    auto copyFrom = [&](WriteBatchWithIndex* batch) {
+        std::unique_ptr<ROCKSDB_NAMESPACE::WBWIIterator> iter(
+            batch->NewIterator(handle));
+        for (iter->Seek(start); iter->Valid(); iter->Next()) {
+            auto entry = iter->Entry();
+            if (!entry.key.starts_with(prefix)) {
+                break;
+            } else if (copy == nullptr) {
+                copy.reset(new WriteBatchWithIndex(
+                    ROCKSDB_NAMESPACE::BytewiseComparator(), 0,
+                    /*overwrite_key*/ true));
+            }
+
+            if (entry.type == ROCKSDB_NAMESPACE::kPutRecord) {
+                copy->Put(handle, entry.key, entry.value);
+            } else if (entry.type == ROCKSDB_NAMESPACE::kDeleteRecord) {
+                copy->Delete(handle, entry.key);
+            }
+        }
+    };
+
+    copyFrom(&pending_->batch);
+    if (txnBatch_ != nullptr) {
+        copyFrom(txnBatch_.get());
+    }
+    return copy;
+}
+
 StorageOptions RocksDBStorage::GetStorageOptions() const {
     return options_;
 }
@@ -434,8 +653,13 @@ bool DuplicateRocksdbCheckpoint(const std::string& from,
 
 }  // namespace
 
-bool RocksDBStorage::Checkpoint(const std::string& dir,
-                                std::vector<std::string>* files) {
+bool RocksDBStorage::CreateCheckpoint(const std::string& dest) {
+    // mutations in pending batch must be included by checkpoint
+    if (BatchEnabled() && !FlushPendingBatch().ok()) {
+        LOG(ERROR) << "Failed to write pending batch before checkpoint";
+        return false;
+    }
+
     rocksdb::FlushOptions options;
     options.wait = true;
     // NOTE: for asynchronous snapshot
@@ -449,10 +673,32 @@ bool RocksDBStorage::Checkpoint(const std::string& dir,
         return false;
     }
 
+    return DoCheckpoint(db_, dest);
+}
+
+bool RocksDBStorage::PrepareCheckpoint(const std::string& dir) {
+    // only the memtables are flushed, sst files are hard linked
     const std::string dest = dir + "/" + kRocksdbCheckpointPath;
-    if (!DoCheckpoint(db_, dest)) {
+    std::lock_guard<std::mutex> lk(checkpointMutex_);
+    checkpointDir_.clear();
+    if (!CreateCheckpoint(dest)) {
         return false;
     }
+    checkpointDir_ = dir;
+    return true;
+}
+
+bool RocksDBStorage::Checkpoint(const std::string& dir,
+                                std::vector<std::string>* files) {
+    const std::string dest = dir + "/" + kRocksdbCheckpointPath;
+    {
+        std::lock_guard<std::mutex> lk(checkpointMutex_);
+        bool prepared = (checkpointDir_ == dir);
+        checkpointDir_.clear();
+        if (!prepared && !CreateCheckpoint(dest)) {
+            return false;
+        }
+    }
 
     std::vector<std::string> filenames;
     int ret = options_.localFileSystem->List(dest, &filenames);
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <unordered_map>
@@ -38,6 +39,7 @@
 #include "rocksdb/table_properties.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/transaction_db.h"
+#include "rocksdb/utilities/write_batch_with_index.h"
 #include "rocksdb/utilities/table_properties_collectors.h"
 #include "src/common/concurrent/rw_lock.h"
 #include "curvefs/src/metaserver/storage/utils.h"
@@ -59,14 +61,39 @@ using ROCKSDB_NAMESPACE::ColumnFamilyDescriptor;
 using ROCKSDB_NAMESPACE::BlockBasedTableOptions;
 using ROCKSDB_NAMESPACE::Transaction;
 using ROCKSDB_NAMESPACE::TransactionDB;
+using ROCKSDB_NAMESPACE::WriteBatch;
+using ROCKSDB_NAMESPACE::WriteBatchWithIndex;
 using ROCKSDB_NAMESPACE::NewLRUCache;
 using ROCKSDB_NAMESPACE::NewBloomFilterPolicy;
 using ROCKSDB_NAMESPACE::NewFixedPrefixTransform;
 using ROCKSDB_NAMESPACE::NewBlockBasedTableFactory;
 using STORAGE_TYPE = KVStorage::STORAGE_TYPE;
 
+// Mutations which are accumulated in memory and not written to database yet,
+// it's shared by storage and its transactions.
+struct PendingWriteBatch {
+    RWLock rwLock;
+    WriteBatchWithIndex batch;
+
+    PendingWriteBatch()
+        : batch(ROCKSDB_NAMESPACE::BytewiseComparator(), 0,
+                /*overwrite_key*/ true) {}
+};
+
 // NOTE: The HSize() and SSize() is an expensive operation for rocksdb storage,
 // you should only invoke it in test cases.
+//
+// If `rocksdb_write_batch_size` is greater than 0, mutations are accumulated
+// in a pending write batch and written to database once their size reach it,
+// reads are served from the pending batch and database, and iterators merge
+// a copy of the pending mutations in their range with a database snapshot.
+// Transactions buffer their mutations in their own batch and append them to
+// the pending batch when committed. The pending batch is written before
+// clearing tables, doing checkpoint and closing.
+//
+// Transactions in this mode take no row locks. It's safe because every key
+// belongs to the tables of one partition, and all mutations of a partition
+// come from its raft apply path, which is serialized by the apply queue.
 class RocksDBStorage : public KVStorage, public StorageTransaction {
  public:
     RocksDBStorage();
@@ -126,6 +153,10 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
 
     Status Rollback() override;
 
+    // Create the rocksdb checkpoint under `dir`, which only flushes the
+    // memtables and hard links the sst files, `Checkpoint(dir)` will list it
+    bool PrepareCheckpoint(const std::string& dir) override;
+
     bool Checkpoint(const std::string& dir,
                     std::vector<std::string>* files) override;
 
@@ -134,6 +165,9 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
  private:
     ColumnFamilyHandle* GetColumnFamilyHandle(bool ordered);
 
+    // write pending batch and memtables, then create checkpoint at `dest`
+    bool CreateCheckpoint(const std::string& dest);
+
     static size_t GetKeyPrefixLength();
 
     static std::string ToInternalName(const std::string& name,
@@ -184,6 +218,31 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
 
     void InitDbOptions();
 
+    bool BatchEnabled() const { return pending_ != nullptr; }
+
+    // get value from transaction's own batch, return true if the key is
+    // written or deleted by current transaction
+    bool GetFromTxnBatch(ColumnFamilyHandle* handle,
+                         const std::string& ikey,
+                         ROCKSDB_NAMESPACE::Status* status,
+                         std::string* svalue);
+
+    // append all or none of the mutations to pending batch, and write
+    // pending batch to database if its size exceed the limit. It succeeds
+    // once the mutations are appended, even if the writing failed.
+    Status AppendPendingBatch(const WriteBatch& batch);
+
+    // write pending batch to database
+    Status FlushPendingBatch();
+
+    // copy the pending mutations and then the ones of current transaction
+    // whose keys are in [start, ...) and start with |prefix|, the caller
+    // must hold the lock of pending batch. Return nullptr if nothing copied.
+    std::unique_ptr<WriteBatchWithIndex> CopyPendingMutations(
+        ColumnFamilyHandle* handle,
+        const std::string& start,
+        const std::string& prefix);
+
  private:
     bool inited_ = false;
     StorageOptions options_;
@@ -198,6 +257,14 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
     // only for transaction
     bool InTransaction_;
     Transaction* txn_ = nullptr;
+    std::unique_ptr<WriteBatchWithIndex> txnBatch_;
+
+    // only for write batch
+    std::shared_ptr<PendingWriteBatch> pending_;
+
+    // directory of the checkpoint created by `PrepareCheckpoint()`
+    std::mutex checkpointMutex_;
+    std::string checkpointDir_;
 
     // db options
     rocksdb::DBOptions dbOptions_;
@@ -289,8 +356,18 @@ class RocksDBStorageIterator : public Iterator {
         RocksDBPerfGuard guard(OP_GET_SNAPSHOT);
         if (status_ == 0) {
             readOptions_ = storage_->dbReadOptions_;
-            if (storage_->InTransaction_) {
+            if (storage_->txn_ != nullptr) {
                 readOptions_.snapshot = storage_->txn_->GetSnapshot();
+            } else if (storage_->BatchEnabled()) {
+                // the pending mutations are copied under the same lock with
+                // the snapshot, so none of them is written to database or
+                // missed in between
+                ReadLockGuard readLockGuard(storage_->pending_->rwLock);
+                readOptions_.snapshot = storage_->db_->GetSnapshot();
+                overlay_ = storage_->CopyPendingMutations(
+                    storage_->GetColumnFamilyHandle(ordered_), prefix_,
+                    prefix_.substr(0, RocksDBStorage::GetKeyPrefixLength() +
+                                        RocksDBStorage::kDelimiter_.size()));
             } else {
                 readOptions_.snapshot = storage_->db_->GetSnapshot();
             }
@@ -300,7 +377,7 @@ class RocksDBStorageIterator : public Iterator {
     ~RocksDBStorageIterator() {
         RocksDBPerfGuard guard(OP_CLEAR_SNAPSHOT);
         if (status_ == 0) {
-            if (storage_->InTransaction_) {
+            if (storage_->txn_ != nullptr) {
                 storage_->txn_->ClearSnapshot();
             } else {
                 storage_->db_->ReleaseSnapshot(readOptions_.snapshot);
@@ -327,8 +404,12 @@ class RocksDBStorageIterator : public Iterator {
         auto handler = storage_->GetColumnFamilyHandle(ordered_);
         {
             RocksDBPerfGuard guard(OP_GET_ITERATOR);
-            if (storage_->InTransaction_) {
+            if (storage_->txn_ != nullptr) {
                 iter_.reset(storage_->txn_->GetIterator(readOptions_, handler));
+            } else if (overlay_ != nullptr) {
+                iter_.reset(overlay_->NewIteratorWithBase(
+                    handler,
+                    storage_->db_->NewIterator(readOptions_, handler)));
             } else {
                 iter_.reset(storage_->db_->NewIterator(readOptions_, handler));
             }
@@ -380,6 +461,8 @@ class RocksDBStorageIterator : public Iterator {
     int status_;
     bool prefixChecking_;
     bool ordered_;
+    // pending mutations in the range of iterator, it must outlive |iter_|
+    std::unique_ptr<WriteBatchWithIndex> overlay_;
     std::unique_ptr<rocksdb::Iterator> iter_;
     rocksdb::ReadOptions readOptions_;
 };
@@ -105,8 +105,18 @@ class KVStorage : public BaseStorage {
 
     virtual std::shared_ptr<StorageTransaction> BeginTransaction() = 0;
 
+    // Capture a point-in-time view of storage for the next `Checkpoint(dir)`,
+    // it should be called while the storage is not modified, e.g: the state
+    // machine is paused, and it's cheap compared to `Checkpoint()`
+    virtual bool PrepareCheckpoint(const std::string& dir) {
+        (void)dir;
+        return true;
+    }
+
     // Save storage's data into the destination directory, and return relative
-    // filenames of current checkpoint under the directory
+    // filenames of current checkpoint under the directory. If
+    // `PrepareCheckpoint(dir)` was called before, the view captured by it is
+    // saved, otherwise the current one is saved
     virtual bool Checkpoint(const std::string& dir,
                             std::vector<std::string>* files) = 0;
 
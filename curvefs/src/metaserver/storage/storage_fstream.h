@@ -128,15 +128,16 @@ inline bool SaveToFile(const std::string &pathname,
         return false;
     }
 
+    // every child is saved as a shard of dumpfile if it is sectioned
     DUMPFILE_ERROR rc;
     auto defer = absl::MakeCleanup([&dumpfile]() { dumpfile.Close(); });
     if (background) {
-        rc = dumpfile.SaveBackground(iterator, done);
+        rc = dumpfile.SaveBackground(iterator->Children(), done);
     } else {
         if (done != nullptr) {
             done->Runned();
         }
-        rc = dumpfile.Save(iterator);
+        rc = dumpfile.Save(iterator->Children());
     }
     LOG(INFO) << "SaveToFile retcode = " << rc;
     return (rc == DUMPFILE_ERROR::OK) && (iterator->Status() == 0);
@@ -32,6 +32,8 @@
 #include "src/fs/local_filesystem.h"
 #include "src/fs/ext4_filesystem_impl.h"
 #include "curvefs/src/metaserver/storage/utils.h"
+#include "curvefs/src/metaserver/common/striped_lock.h"
+#include "curvefs/src/metaserver/storage/storage.h"
 
 namespace curvefs {
 namespace metaserver {
@@ -92,6 +94,13 @@ bool GetProcMemory(uint64_t* vmRSS) {
     return false;
 }
 
+size_t LockStripes(KVStorage* kvStorage) {
+    if (kvStorage->Type() == KVStorage::STORAGE_TYPE::ROCKSDB_STORAGE) {
+        return StripedRWLock::kDefaultStripes;
+    }
+    return 1;
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
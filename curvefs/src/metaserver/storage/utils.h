@@ -36,12 +36,19 @@ namespace storage {
 
 using ::curve::common::RWLock;
 
+class KVStorage;
+
 bool GetFileSystemSpaces(const std::string& path,
                          uint64_t* capacity,
                          uint64_t* available);
 
 bool GetProcMemory(uint64_t* vmRSS);
 
+// Return the number of lock stripes for tables in |kvStorage|, the
+// containers of memory storage aren't thread-safe, so there is only
+// one stripe for it, which is the same as a table lock.
+size_t LockStripes(KVStorage* kvStorage);
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
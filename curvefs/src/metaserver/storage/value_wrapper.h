@@ -25,6 +25,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "curvefs/src/metaserver/storage/common.h"
@@ -42,6 +43,9 @@ class ValueWrapper {
         value_->CopyFrom(value);
     }
 
+    explicit ValueWrapper(std::unique_ptr<ValueType> value)
+        : value_(std::move(value)) {}
+
     void Swap(ValueWrapper& other) noexcept {
         using std::swap;
         swap(value_, other.value_);
@@ -49,6 +53,19 @@ class ValueWrapper {
 
     const ValueType* Message() const { return value_.get(); }
 
+    // Copy the value into |value|. A value read as another message type
+    // with the same wire format (e.g. a s3chunkinfo list read as a packed
+    // one) is converted by serialization, as it is in other storages.
+    bool CopyTo(ValueType* value) const {
+        if (value->GetDescriptor() == value_->GetDescriptor()) {
+            value->CopyFrom(*value_);
+            return true;
+        }
+        std::string svalue;
+        return value_->SerializeToString(&svalue) &&
+               value->ParseFromString(svalue);
+    }
+
     friend void swap(ValueWrapper& lhs, ValueWrapper& rhs) noexcept {
         return lhs.Swap(rhs);
     }
@@ -200,5 +200,22 @@ bool TxManager::HandlePendingTx(uint64_t txId, RenameTx* pendingTx,
     return pendingTx->Rollback(logIndex);
 }
 
+bool TxManager::IsPendingTxConflict(const std::vector<Dentry>& dentrys) {
+    ReadLockGuard r(rwLock_);
+    if (pendingTx_ == EMPTY_TX) {
+        return false;
+    }
+    for (const auto& pending : *pendingTx_.GetDentrys()) {
+        for (const auto& dentry : dentrys) {
+            if (pending.fsid() == dentry.fsid() &&
+                pending.parentinodeid() == dentry.parentinodeid() &&
+                pending.name() == dentry.name()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 };  // namespace metaserver
 };  // namespace curvefs
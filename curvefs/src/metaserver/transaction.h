@@ -89,6 +89,9 @@ class TxManager {
 
     bool HandlePendingTx(uint64_t txId, RenameTx* pendingTx, int64_t logIndex);
 
+    // whether the pending tx touches any of the |dentrys|
+    bool IsPendingTxConflict(const std::vector<Dentry>& dentrys);
+
     void SerializeRenameTx(const RenameTx& in, PrepareRenameTxRequest* out);
 
     bool Init();
@@ -52,6 +52,16 @@ class Allocator {
                            const AllocateHint& hint,
                            std::vector<Extent>* exts) = 0;
 
+    /**
+     * @brief Same as Alloc, but return 0 immediately if the allocator is
+     *        busy or hasn't enough space, so caller can try another one
+     */
+    virtual uint64_t TryAlloc(const uint64_t size,
+                              const AllocateHint& hint,
+                              std::vector<Extent>* exts) {
+        return Alloc(size, hint, exts);
+    }
+
     /**
      * @brief DeAllocate space
      *
@@ -88,7 +88,7 @@ BitmapAllocator::BitmapAllocator(const BitmapAllocatorOption& opt)
             << ", size_per_bit: " << opt_.sizePerBit << ", bitmapAreaLength_ "
             << bitmapAreaLength_ << ", bitmapAreaOffset_: " << bitmapAreaOffset_
             << ", smallAreaLength_: " << smallAreaLength_
-            << ", available: " << available_;
+            << ", available: " << available_.load();
 }
 
 BitmapAllocator::~BitmapAllocator() {}
@@ -96,6 +96,27 @@ BitmapAllocator::~BitmapAllocator() {}
 uint64_t BitmapAllocator::Alloc(uint64_t size,
                                 const AllocateHint& hint,
                                 std::vector<Extent>* exts) {
+    std::lock_guard<bthread::Mutex> lock(mtx_);
+    return AllocLocked(size, hint, exts);
+}
+
+uint64_t BitmapAllocator::TryAlloc(uint64_t size,
+                                   const AllocateHint& hint,
+                                   std::vector<Extent>* exts) {
+    if (available_.load(std::memory_order_relaxed) < size) {
+        return 0;
+    }
+
+    std::unique_lock<bthread::Mutex> lock(mtx_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return 0;
+    }
+    return AllocLocked(size, hint, exts);
+}
+
+uint64_t BitmapAllocator::AllocLocked(uint64_t size,
+                                      const AllocateHint& hint,
+                                      std::vector<Extent>* exts) {
     assert(is_aligned(size, kAlignment));
 
     static const BitmapAllocator::AllocOrder kAllocBig(
@@ -113,7 +134,6 @@ uint64_t BitmapAllocator::Alloc(uint64_t size,
         &BitmapAllocator::AllocFromBitmapExtent,
         &BitmapAllocator::AllocFromBitmap);
 
-    std::lock_guard<bthread::Mutex> lock(mtx_);
     if (available_ == 0) {
         return 0;
     }
@@ -429,7 +449,7 @@ void BitmapAllocator::Split(const uint64_t off,
 }
 
 std::ostream& operator<<(std::ostream& os, const BitmapAllocator& alloc) {
-    os << "avail: " << alloc.available_
+    os << "avail: " << alloc.available_.load()
        << ", [== bitmap ext: " << alloc.bitmapExtent_ << "  ==]"
        << ", [== small ext: " << alloc.smallExtent_ << " ==]";
 
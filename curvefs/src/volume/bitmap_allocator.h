@@ -25,6 +25,7 @@
 
 #include <bthread/mutex.h>
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -46,6 +47,10 @@ class BitmapAllocator : public Allocator {
                    const AllocateHint& hint,
                    std::vector<Extent>* exts) override;
 
+    uint64_t TryAlloc(const uint64_t size,
+                      const AllocateHint& hint,
+                      std::vector<Extent>* exts) override;
+
     bool DeAlloc(const uint64_t off, const uint64_t len) override;
 
     bool DeAlloc(const std::vector<Extent>& exts) override;
@@ -55,8 +60,7 @@ class BitmapAllocator : public Allocator {
     uint64_t Total() const override { return opt_.length; }
 
     uint64_t AvailableSize() const override {
-        std::lock_guard<bthread::Mutex> lock(mtx_);
-        return available_;
+        return available_.load(std::memory_order_relaxed);
     }
 
     bool MarkUsed(const std::vector<Extent>& extents) override;
@@ -71,6 +75,11 @@ class BitmapAllocator : public Allocator {
  private:
     struct AllocOrder;
 
+    // allocate with mtx_ held
+    uint64_t AllocLocked(const uint64_t size,
+                         const AllocateHint& hint,
+                         std::vector<Extent>* exts);
+
     /**
      * @brief call real allocate functions that stored in AllocOrder one by one,
      * untilsatisfy size or all functions has been called
@@ -122,8 +131,9 @@ class BitmapAllocator : public Allocator {
     // protect below fields
     mutable bthread::Mutex mtx_;
 
-    // current available size
-    uint64_t available_;
+    // current available size, it's only updated with mtx_ held,
+    // but can be read without lock
+    std::atomic<uint64_t> available_;
 
     // last bitmap allocate index
     uint64_t bitmapAllocIdx_;
@@ -65,22 +65,14 @@ void AioReadCallBack(CurveAioContext *aio) {
     AioRead *read = reinterpret_cast<AioRead *>(reinterpret_cast<char *>(aio) -
                                                 offsetof(AioRead, aio));
 
-    {
-        std::lock_guard<std::mutex> lock(read->mtx);
-        read->done = true;
-    }
-    read->cond.notify_one();
+    read->OnComplete();
 }
 
 void AioWriteCallBack(CurveAioContext *aio) {
     AioWrite *write = reinterpret_cast<AioWrite *>(
         reinterpret_cast<char *>(aio) - offsetof(AioWrite, aio));
 
-    {
-        std::lock_guard<std::mutex> lock(write->mtx);
-        write->done = true;
-    }
-    write->cond.notify_one();
+    write->OnComplete();
 }
 
 void AioWritePaddingReadCallBack(CurveAioContext *aio) {
@@ -92,9 +84,32 @@ void AioWritePaddingReadCallBack(CurveAioContext *aio) {
 
 }  // namespace
 
+void AioBatch::Done() {
+    if (1 != pending_.fetch_sub(1, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // NOTE: notify while holding the lock, the batch usually lives on the
+    // waiter's stack and may be destroyed as soon as the waiter wakes up
+    std::lock_guard<std::mutex> lock(mtx_);
+    done_ = true;
+    cond_.notify_one();
+}
+
+void AioBatch::Wait() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cond_.wait(lock, [this]() { return done_; });
+}
+
 AioRead::AioRead(off_t offset, size_t length, char *data, FileClient *dev,
-                 int fd)
-    : aio(), offset(offset), length(length), data(data), dev(dev), fd(fd) {}
+                 int fd, AioBatch *batch)
+    : aio(),
+      offset(offset),
+      length(length),
+      data(data),
+      dev(dev),
+      fd(fd),
+      batch(batch) {}
 
 void AioRead::Issue() {
     if (is_aligned(offset, IO_ALIGNED_BLOCK_SIZE) &&
@@ -109,7 +124,7 @@ void AioRead::Issue() {
         int ret = dev->AioRead(fd, &aio);
         if (ret < 0) {
             LOG(ERROR) << "Failed to issue aio read: " << &aio;
-            done = true;
+            OnComplete();
         }
 
         return;
@@ -134,13 +149,29 @@ void AioRead::Issue() {
     int ret = dev->AioRead(fd, &aio);
     if (ret < 0) {
         LOG(ERROR) << "Failed to issue aio read: " << &aio;
+        OnComplete();
+    }
+}
+
+void AioRead::OnComplete() {
+    if (batch != nullptr) {
+        done = true;
+        batch->Done();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
         done = true;
     }
+    cond.notify_one();
 }
 
 ssize_t AioRead::Wait() {
-    std::unique_lock<std::mutex> lock(mtx);
-    cond.wait(lock, [this]() { return done; });
+    if (batch == nullptr) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait(lock, [this]() { return done; });
+    }
 
     if (static_cast<ssize_t>(aio.ret) != static_cast<ssize_t>(aio.length)) {
         LOG(ERROR) << "AioRead error: " << &aio;
@@ -156,8 +187,13 @@ ssize_t AioRead::Wait() {
 }
 
 AioWrite::AioWrite(off_t offset, size_t length, const char *data,
-                   FileClient *dev, int fd)
-    : offset(offset), length(length), data(data), dev(dev), fd(fd) {}
+                   FileClient *dev, int fd, AioBatch *batch)
+    : offset(offset),
+      length(length),
+      data(data),
+      dev(dev),
+      fd(fd),
+      batch(batch) {}
 
 void AioWrite::Issue() {
     if (is_aligned(offset, IO_ALIGNED_BLOCK_SIZE) &&
@@ -172,7 +208,7 @@ void AioWrite::Issue() {
         int ret = dev->AioWrite(fd, &aio);
         if (ret < 0) {
             LOG(ERROR) << "Failed to issue aio write: " << &aio;
-            done = true;
+            OnComplete();
         }
 
         return;
@@ -237,9 +273,25 @@ void AioWrite::Issue() {
     }
 }
 
+void AioWrite::OnComplete() {
+    if (batch != nullptr) {
+        done = true;
+        batch->Done();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        done = true;
+    }
+    cond.notify_one();
+}
+
 ssize_t AioWrite::Wait() {
-    std::unique_lock<std::mutex> lock(mtx);
-    cond.wait(lock, [this]() { return done; });
+    if (batch == nullptr) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait(lock, [this]() { return done; });
+    }
 
     if (static_cast<ssize_t>(aio.ret) != static_cast<ssize_t>(aio.length) ||
         (aux != nullptr && aux->error.load(std::memory_order_acquire))) {
@@ -262,11 +314,7 @@ void AioWrite::OnPaddingReadComplete(CurveAioContext *read) {
 
     // padding read error
     if (aux->error.load(std::memory_order_acquire)) {
-        {
-            std::lock_guard<std::mutex> lock(mtx);
-            done = true;
-        }
-        cond.notify_one();
+        OnComplete();
         return;
     }
 
@@ -283,11 +331,7 @@ void AioWrite::OnPaddingReadComplete(CurveAioContext *read) {
     int ret = dev->AioWrite(fd, &aio);
     if (ret < 0) {
         LOG(ERROR) << "Failed to issue aio write: " << &aio;
-        {
-            std::lock_guard<std::mutex> lock(mtx);
-            done = true;
-        }
-        cond.notify_one();
+        OnComplete();
     }
 }
 
@@ -42,6 +42,25 @@ namespace volume {
 
 using ::curve::client::FileClient;
 
+// A batch of aio requests which are issued together and share one
+// completion, only the last finished request wakes up the waiter.
+class AioBatch {
+ public:
+    explicit AioBatch(size_t count) : pending_(count), done_(count == 0) {}
+
+    // Called by each request when it's finished.
+    void Done();
+
+    // Wait until all requests are finished.
+    void Wait();
+
+ private:
+    std::atomic<size_t> pending_;
+    bool done_;
+    std::mutex mtx_;
+    std::condition_variable cond_;
+};
+
 struct AioRead {
     // aio context
     CurveAioContext aio;
@@ -69,15 +88,26 @@ struct AioRead {
     // padding read request if necessary
     std::unique_ptr<Padding> padding;
 
-    AioRead(off_t offset, size_t length, char* data, FileClient* dev, int fd);
+    // batch this request belongs to, nullptr if it's a standalone request
+    AioBatch* batch;
+
+    AioRead(off_t offset,
+            size_t length,
+            char* data,
+            FileClient* dev,
+            int fd,
+            AioBatch* batch = nullptr);
 
     // Issue the read request.
     void Issue();
 
-    // Wait until request is finished.
+    // Wait until request is finished, if request belongs to a batch, wait
+    // the batch instead and call this to get the result.
     // Return read bytes if succeeded, other return values mean an error
     // occurred.
     ssize_t Wait();
+
+    void OnComplete();
 };
 
 struct AioWrite {
@@ -122,20 +152,27 @@ struct AioWrite {
 
     std::unique_ptr<PaddingAux> aux;
 
+    // batch this request belongs to, nullptr if it's a standalone request
+    AioBatch* batch;
+
     AioWrite(off_t offset,
              size_t length,
              const char* data,
              FileClient* dev,
-             int fd);
+             int fd,
+             AioBatch* batch = nullptr);
 
     // Issue the write request.
     void Issue();
 
-    // Wait until request is finished.
+    // Wait until request is finished, if request belongs to a batch, wait
+    // the batch instead and call this to get the result.
     // Return written bytes if succeeded, other return values mean an error
     // occurred.
     ssize_t Wait();
 
+    void OnComplete();
+
     void OnPaddingReadComplete(CurveAioContext* read);
 };
 
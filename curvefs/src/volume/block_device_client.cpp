@@ -25,11 +25,11 @@
 #include <sys/types.h>
 #include <glog/logging.h>
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
 
-#include "absl/memory/memory.h"
 #include "curvefs/src/common/metric_utils.h"
 #include "curvefs/src/volume/block_device_aio.h"
 #include "include/client/libcurve_define.h"
@@ -47,6 +47,29 @@ namespace {
 bvar::LatencyRecorder g_write_latency("block_device_write");
 bvar::LatencyRecorder g_read_latency("block_device_read");
 
+// Merge parts which are continuous both on device and in user buffer, so that
+// they are issued as one request.
+template <typename Part>
+std::vector<Part> Coalesce(const std::vector<Part> &iov) {
+    std::vector<Part> parts;
+    parts.reserve(iov.size());
+
+    for (const auto &io : iov) {
+        if (!parts.empty()) {
+            auto &last = parts.back();
+            if (last.offset + static_cast<off_t>(last.length) == io.offset &&
+                last.data + last.length == io.data) {
+                last.length += io.length;
+                continue;
+            }
+        }
+
+        parts.push_back(io);
+    }
+
+    return parts;
+}
+
 }  // namespace
 
 BlockDeviceClientImpl::BlockDeviceClientImpl()
@@ -138,30 +161,34 @@ ssize_t BlockDeviceClientImpl::Read(char *buf, off_t offset, size_t length) {
 }
 
 ssize_t BlockDeviceClientImpl::Readv(const std::vector<ReadPart> &iov) {
-    if (iov.size() == 1) {
-        VLOG(9) << "read block offset: " << iov[0].offset
-                << ", length: " << iov[0].length;
-        return Read(iov[0].data, iov[0].offset, iov[0].length);
+    const auto parts = Coalesce(iov);
+    if (parts.size() == 1) {
+        VLOG(9) << "read block offset: " << parts[0].offset
+                << ", length: " << parts[0].length;
+        return Read(parts[0].data, parts[0].offset, parts[0].length);
     }
 
-    std::vector<std::unique_ptr<AioRead>> requests;
-    requests.reserve(iov.size());
+    // issue all requests together, and wait them in one go
+    AioBatch batch(parts.size());
+    std::deque<AioRead> requests;
 
-    for (const auto &io : iov) {
-        requests.push_back(absl::make_unique<AioRead>(
-            io.offset, io.length, io.data, fileClient_.get(), fd_));
+    for (const auto &io : parts) {
+        requests.emplace_back(io.offset, io.length, io.data, fileClient_.get(),
+                              fd_, &batch);
 
-        requests.back()->Issue();
+        requests.back().Issue();
     }
 
+    batch.Wait();
+
     bool error = false;
     ssize_t total = 0;
-    for (const auto &r : requests) {
-        auto nr = r->Wait();
+    for (auto &r : requests) {
+        auto nr = r.Wait();
         if (nr < 0) {
             error = true;
-            LOG(ERROR) << "AioRead error, offset: " << r->offset
-                       << ", length: " << r->length;
+            LOG(ERROR) << "AioRead error, offset: " << r.offset
+                       << ", length: " << r.length;
         } else {
             total += nr;
         }
@@ -188,28 +215,32 @@ ssize_t BlockDeviceClientImpl::Write(const char *buf, off_t offset,
 }
 
 ssize_t BlockDeviceClientImpl::Writev(const std::vector<WritePart> &iov) {
-    if (iov.size() == 1) {
-        return Write(iov[0].data, iov[0].offset, iov[0].length);
+    const auto parts = Coalesce(iov);
+    if (parts.size() == 1) {
+        return Write(parts[0].data, parts[0].offset, parts[0].length);
     }
 
-    std::vector<std::unique_ptr<AioWrite>> requests;
-    requests.reserve(iov.size());
+    // issue all requests together, and wait them in one go
+    AioBatch batch(parts.size());
+    std::deque<AioWrite> requests;
 
-    for (const auto &io : iov) {
-        requests.push_back(absl::make_unique<AioWrite>(
-            io.offset, io.length, io.data, fileClient_.get(), fd_));
+    for (const auto &io : parts) {
+        requests.emplace_back(io.offset, io.length, io.data, fileClient_.get(),
+                              fd_, &batch);
 
-        requests.back()->Issue();
+        requests.back().Issue();
     }
 
+    batch.Wait();
+
     bool error = false;
     ssize_t total = 0;
-    for (const auto &r : requests) {
-        auto nr = r->Wait();
+    for (auto &r : requests) {
+        auto nr = r.Wait();
         if (nr < 0) {
             error = true;
-            LOG(ERROR) << "AioWrite error, offset: " << r->offset
-                       << ", length: " << r->length;
+            LOG(ERROR) << "AioWrite error, offset: " << r.offset
+                       << ", length: " << r.length;
         } else {
             total += nr;
         }
@@ -24,8 +24,10 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "curvefs/src/volume/block_device_client.h"
@@ -33,6 +35,9 @@
 namespace curvefs {
 namespace volume {
 
+using ::curve::common::BitRange;
+using ::curve::common::BITMAP_UNIT_SIZE;
+
 void BlockGroupBitmapUpdater::Update(const Extent& ext, Op op) {
     assert(ext.len != 0);
     std::lock_guard<std::mutex> lk(bitmapMtx_);
@@ -48,35 +53,91 @@ void BlockGroupBitmapUpdater::Update(const Extent& ext, Op op) {
         bitmap_.Clear(startIdx, endIdx);
     }
 
-    dirty_ = true;
+    dirtyPages_.Set(startIdx / BITMAP_UNIT_SIZE / kPageSize,
+                    endIdx / BITMAP_UNIT_SIZE / kPageSize);
+    updateSeq_++;
 }
 
 bool BlockGroupBitmapUpdater::Sync() {
     std::unique_ptr<char[]> bitmap;
-    std::lock_guard<std::mutex> lk(syncMtx_);
+    std::vector<BitRange> dirty;
+    std::vector<WritePart> pages;
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lk(bitmapMtx_);
+        seq = updateSeq_;
+    }
 
+    std::lock_guard<std::mutex> lk(syncMtx_);
     {
         std::lock_guard<std::mutex> lk(bitmapMtx_);
 
-        if (!dirty_) {
+        // our updates have been written by the previous sync
+        if (syncedSeq_ >= seq) {
             return true;
         }
 
+        seq = updateSeq_;
+        dirtyPages_.Divide(0, dirtyPages_.Size() - 1, nullptr, &dirty);
+        if (dirty.empty()) {
+            syncedSeq_ = seq;
+            return true;
+        }
+
+        // only copy dirty pages, adjacent dirty pages are merged into one
         bitmap = absl::make_unique<char[]>(bitmapRange_.length);
-        mempcpy(bitmap.get(), bitmap_.GetBitmap(), bitmapRange_.length);
-        dirty_ = false;
+        for (const auto& range : dirty) {
+            uint64_t off = range.beginIndex * kPageSize;
+            uint64_t end = std::min<uint64_t>((range.endIndex + 1) * kPageSize,
+                                              bitmapRange_.length);
+            memcpy(bitmap.get() + off, bitmap_.GetBitmap() + off, end - off);
+            pages.emplace_back(bitmapRange_.offset + off, end - off,
+                               bitmap.get() + off);
+        }
+        dirtyPages_.Clear();
     }
 
-    auto ret = blockDev_->Write(bitmap.get(), bitmapRange_.offset,
-                                bitmapRange_.length);
-
-    if (ret < 0 || static_cast<size_t>(ret) != bitmapRange_.length) {
-        LOG(ERROR) << "Sync block group bitmap failed, err: " << ret
+    if (!WritePages(pages)) {
+        LOG(ERROR) << "Sync block group bitmap failed"
                    << ", block group offset: " << groupOffset_;
+        // write them again at next sync
+        std::lock_guard<std::mutex> lk(bitmapMtx_);
+        for (const auto& range : dirty) {
+            dirtyPages_.Set(range.beginIndex, range.endIndex);
+        }
         return false;
     }
 
-    dirty_ = false;
+    std::lock_guard<std::mutex> lock(bitmapMtx_);
+    syncedSeq_ = seq;
+    return true;
+}
+
+bool BlockGroupBitmapUpdater::WritePages(const std::vector<WritePart>& pages) {
+    size_t total = 0;
+    bool aligned = true;
+    for (const auto& page : pages) {
+        total += page.length;
+        aligned = aligned && page.offset % kPageSize == 0 &&
+                  page.length % kPageSize == 0;
+    }
+
+    // non-adjacent pages are issued concurrently if they're aligned,
+    // otherwise they are written one by one
+    if (pages.size() > 1 && aligned) {
+        auto ret = blockDev_->Writev(pages);
+        return ret >= 0 && static_cast<size_t>(ret) == total;
+    }
+
+    for (const auto& page : pages) {
+        auto ret = blockDev_->Write(page.data, page.offset, page.length);
+        if (ret < 0 || static_cast<size_t>(ret) != page.length) {
+            LOG(ERROR) << "Write block group bitmap failed, err: " << ret
+                       << ", offset: " << page.offset
+                       << ", length: " << page.length;
+            return false;
+        }
+    }
     return true;
 }
 
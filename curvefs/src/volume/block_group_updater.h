@@ -25,6 +25,7 @@
 
 #include <mutex>
 #include <utility>
+#include <vector>
 
 #include "curvefs/src/volume/common.h"
 #include "src/common/bitmap.h"
@@ -42,15 +43,25 @@ struct BitmapRange {
 };
 
 // bitmap updater for each block group
+//
+// Bitmap is persisted at page granularity, only dirty pages are written back,
+// and non-adjacent dirty pages are written concurrently.
+// Allocations sync their bits before returning extents to caller, so a crash
+// never leaves an extent referenced but marked free on disk; a failed sync
+// keeps the pages dirty, they will be written by the next sync.
+// Concurrent syncs are coalesced: the one holding the sync lock writes all
+// dirty pages, and the others covered by it return without writing again.
 class BlockGroupBitmapUpdater {
  public:
+    static constexpr uint64_t kPageSize = 4096;
+
     BlockGroupBitmapUpdater(Bitmap bitmap,
                             uint32_t blockSize,
                             uint32_t groupSize,
                             uint64_t groupOffset,
                             const BitmapRange& range,
                             BlockDeviceClient* blockDev)
-        : dirty_(false),
+        : dirtyPages_((range.length + kPageSize - 1) / kPageSize),
           bitmap_(std::move(bitmap)),
           blockSize_(blockSize),
           groupSize_(groupSize),
@@ -67,15 +78,23 @@ class BlockGroupBitmapUpdater {
     void Update(const Extent& ext, Op op);
 
     /**
-     * @brief Sync bitmap to backend storage if dirty
+     * @brief Sync bitmap to backend storage if dirty, all updates before
+     *        it are persisted if success
      * @return return true if success, otherwise, return false
      */
     bool Sync();
 
+ private:
+    bool WritePages(const std::vector<WritePart>& pages);
+
  private:
     std::mutex bitmapMtx_;
     std::mutex syncMtx_;
-    bool dirty_;
+    // dirty pages of bitmap, 1 means dirty
+    Bitmap dirtyPages_;
+    // number of updates, and the updates before |syncedSeq_| are persisted
+    uint64_t updateSeq_ = 0;
+    uint64_t syncedSeq_ = 0;
     Bitmap bitmap_;
     uint32_t blockSize_;
     uint32_t groupSize_;
@@ -57,6 +57,10 @@ struct SpaceManagerOption {
 
     double threshold{1.0};
     uint64_t releaseInterSec{300};
+
+    // fetch block groups from mds in background once available space drops
+    // below this proportion of a block group, 0 means disabled
+    double prefetchWatermark{0};
 };
 
 }  // namespace volume
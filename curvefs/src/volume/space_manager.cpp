@@ -26,6 +26,8 @@
 #include <bvar/bvar.h>
 
 #include <atomic>
+#include <functional>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 
@@ -50,7 +52,8 @@ SpaceManagerImpl::SpaceManagerImpl(
       blockGroupManager_(new BlockGroupManagerImpl(
           this, mdsClient, blockDev, option.blockGroupManagerOption,
           option.allocatorOption)),
-      allocating_(false), threshold_(option.threshold),
+      allocating_(false), prefetchWatermark_(option.prefetchWatermark),
+      threshold_(option.threshold),
       releaseInterSec_(option.releaseInterSec) {}
 
 bool SpaceManagerImpl::Alloc(uint32_t size,
@@ -89,9 +92,12 @@ bool SpaceManagerImpl::Alloc(uint32_t size,
     if (!ret) {
         LOG(ERROR) << "Update bitmap failed";
         metric_.errorCount << 1;
+        RollbackAlloc(extents);
         return false;
     }
 
+    MaybePrefetchBlockGroups();
+
     timer.stop();
     metric_.allocLatency << timer.u_elapsed();
     metric_.allocSize << size;
@@ -150,9 +156,12 @@ SpaceManagerImpl::FindAllocator(const AllocateHint& hint) {
         }
     }
 
-    static thread_local unsigned int seed = time(nullptr);
+    // without hint, every thread sticks to its own block group, so parallel
+    // writers rarely contend on the same allocator
+    static thread_local const size_t slot =
+        std::hash<std::thread::id>()(std::this_thread::get_id());
     auto it = allocators_.begin();
-    std::advance(it, rand_r(&seed) % allocators_.size());
+    std::advance(it, slot % allocators_.size());
 
     return it;
 }
@@ -167,24 +176,25 @@ int64_t SpaceManagerImpl::AllocInternal(int64_t size,
     }
 
     int64_t left = size;
-    auto it = FindAllocator(hint);
-    const auto beginIt = it;
-
-    do {
-        left -= it->second->Alloc(left, hint, exts);
-        if (left <= 0) {
-            break;
-        }
-
-        ++it;
-        if (it == allocators_.end()) {
-            it = allocators_.begin();
-        }
+    const auto beginIt = FindAllocator(hint);
+
+    // first round only takes allocators which are idle and have enough space,
+    // then wait for busy ones if it's still not satisfied
+    for (bool tryOnly : { true, false }) {
+        auto it = beginIt;
+        do {
+            left -= tryOnly ? it->second->TryAlloc(left, hint, exts)
+                            : it->second->Alloc(left, hint, exts);
+            if (left <= 0) {
+                return size - left;
+            }
 
-        if (it == beginIt) {
-            break;
-        }
-    } while (true);
+            ++it;
+            if (it == allocators_.end()) {
+                it = allocators_.begin();
+            }
+        } while (it != beginIt);
+    }
 
     return size - left;
 }
@@ -200,11 +210,40 @@ bool SpaceManagerImpl::UpdateBitmap(const std::vector<Extent> &exts,
         dirty.insert(updater);
     }
 
+    // freed bits are written by later syncs, losing them on crash only
+    // leaks space, while allocated bits must be persisted before returning
+    if (op == BlockGroupBitmapUpdater::Op::Clear) {
+        return true;
+    }
+
+    bool ret = true;
     for (auto d : dirty) {
-        d->Sync();
+        ret = d->Sync() && ret;
     }
 
-    return true;
+    return ret;
+}
+
+void SpaceManagerImpl::RollbackAlloc(std::vector<Extent>* exts) {
+    UpdateBitmap(*exts, BlockGroupBitmapUpdater::Op::Clear);
+
+    ReadLockGuard lk(allocatorsLock_);
+    for (const auto& ext : *exts) {
+        auto it = allocators_.find(align_down(ext.offset, blockGroupSize_));
+        if (it != allocators_.end() &&
+            it->second->DeAlloc(ext.offset, ext.len)) {
+            availableBytes_.fetch_add(ext.len, std::memory_order_relaxed);
+        }
+    }
+    exts->clear();
+}
+
+void SpaceManagerImpl::SyncBitmap() {
+    ReadLockGuard lk(updatersLock_);
+    for (auto& updater : bitmapUpdaters_) {
+        LOG_IF(ERROR, !updater.second->Sync())
+            << "Sync bitmap failed, block group offset: " << updater.first;
+    }
 }
 
 BlockGroupBitmapUpdater* SpaceManagerImpl::FindBitmapUpdater(
@@ -221,6 +260,9 @@ BlockGroupBitmapUpdater* SpaceManagerImpl::FindBitmapUpdater(
 
 void SpaceManagerImpl::Run() {
     releaseT_ = std::thread(&SpaceManagerImpl::ReleaseFullBlockGroups, this);
+    if (prefetchWatermark_ > 0) {
+        prefetchT_ = std::thread(&SpaceManagerImpl::PrefetchBlockGroups, this);
+    }
     running_ = true;
 }
 
@@ -229,6 +271,9 @@ void SpaceManagerImpl::ReleaseFullBlockGroups() {
     while (sleeper_.wait_for(std::chrono::seconds(releaseInterSec_))) {
         std::vector<uint64_t> selectBlockGroups;
 
+        // write back the freed bits
+        SyncBitmap();
+
         // find the blockgroup whose space usage ratio is greater than a certain
         // threshold
         {
@@ -264,6 +309,16 @@ void SpaceManagerImpl::ReleaseFullBlockGroups() {
             for (auto &id : selectBlockGroups) {
                 auto iter = allocators_.find(id);
                 assert(iter != allocators_.end());
+
+                // the bitmap must be persisted before others own it
+                auto updater = bitmapUpdaters_.find(id);
+                if (updater != bitmapUpdaters_.end() &&
+                    !updater->second->Sync()) {
+                    LOG(WARNING) << "Sync bitmap failed, skip releasing block "
+                                    "group, id: " << id;
+                    continue;
+                }
+
                 auto availableSize = iter->second->AvailableSize();
 
                 availableBytes_.fetch_sub(availableSize,
@@ -288,6 +343,15 @@ void SpaceManagerImpl::ReleaseFullBlockGroups() {
 bool SpaceManagerImpl::Shutdown() {
     bool ret = false;
 
+    if (prefetchT_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            stopping_ = true;
+            cond_.notify_all();
+        }
+        prefetchT_.join();
+    }
+
     {
         WriteLockGuard allocLk(allocatorsLock_);
         WriteLockGuard updaterLk(updatersLock_);
@@ -316,10 +380,64 @@ bool SpaceManagerImpl::Shutdown() {
 
 bool SpaceManagerImpl::AllocateBlockGroup(uint64_t hint) {
     std::unique_lock<std::mutex> lk(mtx_);
+    // the ongoing allocation (maybe a prefetch) may bring enough space
+    cond_.wait(lk, [this]() { return !allocating_; });
     if (availableBytes_.load(std::memory_order_relaxed) >= hint) {
         return true;
     }
 
+    allocating_ = true;
+    lk.unlock();
+    auto ret = FetchBlockGroups();
+    lk.lock();
+    allocating_ = false;
+    cond_.notify_all();
+    return ret;
+}
+
+bool SpaceManagerImpl::BelowPrefetchWatermark() const {
+    return prefetchWatermark_ > 0 &&
+           availableBytes_.load(std::memory_order_relaxed) <
+               prefetchWatermark_ * blockGroupSize_;
+}
+
+void SpaceManagerImpl::MaybePrefetchBlockGroups() {
+    if (!BelowPrefetchWatermark()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (prefetchT_.joinable() && !allocating_ && !prefetch_) {
+        prefetch_ = true;
+        cond_.notify_all();
+    }
+}
+
+void SpaceManagerImpl::PrefetchBlockGroups() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (true) {
+        cond_.wait(lk, [this]() { return prefetch_ || stopping_; });
+        if (stopping_) {
+            break;
+        }
+
+        prefetch_ = false;
+        if (allocating_ || !BelowPrefetchWatermark()) {
+            continue;
+        }
+
+        allocating_ = true;
+        lk.unlock();
+        auto ret = FetchBlockGroups();
+        metric_.prefetchCount << 1;
+        LOG_IF(WARNING, !ret) << "Prefetch block group failed";
+        lk.lock();
+        allocating_ = false;
+        cond_.notify_all();
+    }
+}
+
+bool SpaceManagerImpl::FetchBlockGroups() {
     std::vector<AllocatorAndBitmapUpdater> out;
     auto ret = blockGroupManager_->AllocateBlockGroup(&out);
     if (!ret) {
@@ -348,8 +466,12 @@ bool SpaceManagerImpl::AllocateBlockGroup(uint64_t hint) {
 
 bool SpaceManagerImpl::AcquireBlockGroup(uint64_t blockGroupOffset) {
     std::unique_lock<std::mutex> lk(mtx_);
-    if (bitmapUpdaters_.find(blockGroupOffset) != bitmapUpdaters_.end()) {
-        return true;
+    {
+        // block groups may be added by an allocation without holding mtx_
+        ReadLockGuard updaterLk(updatersLock_);
+        if (bitmapUpdaters_.find(blockGroupOffset) != bitmapUpdaters_.end()) {
+            return true;
+        }
     }
 
     AllocatorAndBitmapUpdater out;
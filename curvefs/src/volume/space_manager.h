@@ -102,11 +102,36 @@ class SpaceManagerImpl final : public SpaceManager {
     bool UpdateBitmap(const std::vector<Extent> &exts,
                       BlockGroupBitmapUpdater::Op op);
 
+    /**
+     * @brief Give back the extents which are allocated but failed to persist
+     */
+    void RollbackAlloc(std::vector<Extent>* exts);
+
+    /**
+     * @brief Write back the dirty bitmap of all block groups
+     */
+    void SyncBitmap();
+
     void ReleaseFullBlockGroups();
 
  private:
     bool AllocateBlockGroup(uint64_t hint);
 
+    /**
+     * @brief Allocate block groups from mds and add them into allocators,
+     *        caller should have marked `allocating_`
+     */
+    bool FetchBlockGroups();
+
+    bool BelowPrefetchWatermark() const;
+
+    /**
+     * @brief Wake up prefetch thread if available space is low
+     */
+    void MaybePrefetchBlockGroups();
+
+    void PrefetchBlockGroups();
+
     bool AcquireBlockGroup(uint64_t blockGroupOffset);
 
  private:
@@ -126,10 +151,18 @@ class SpaceManagerImpl final : public SpaceManager {
 
     std::unique_ptr<BlockGroupManager> blockGroupManager_;
 
+    // only one allocation (including prefetch) talks to mds at a time,
+    // others wait on cond_ for its result
     bool allocating_;
     std::mutex mtx_;
     std::condition_variable cond_;
 
+    // prefetchT_ fetches block groups before space runs out
+    double prefetchWatermark_;
+    bool prefetch_{false};
+    bool stopping_{false};
+    std::thread prefetchT_;
+
     // releaseT_ is periodically release the allocated blockgroup
     double threshold_;
     uint64_t releaseInterSec_;
@@ -144,11 +177,13 @@ class SpaceManagerImpl final : public SpaceManager {
         bvar::LatencyRecorder deallocLatency;
         bvar::LatencyRecorder allocSize;
         bvar::Adder<uint64_t> errorCount;
+        bvar::Adder<uint64_t> prefetchCount;
 
         Metric()
             : allocLatency("space_alloc_latency"),
               deallocLatency("space_dealloc_latency"),
-              allocSize("space_alloc_size"), errorCount("space_alloc_error") {}
+              allocSize("space_alloc_size"), errorCount("space_alloc_error"),
+              prefetchCount("space_prefetch_block_group") {}
     };
 
     Metric metric_;
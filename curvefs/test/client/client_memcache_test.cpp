@@ -27,6 +27,8 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "curvefs/src/client/kvclient/kvclient_manager.h"
@@ -141,5 +143,117 @@ TEST_F(MemCachedTest, MultiThreadTask) {
         }
     }
 }
+
+TEST_F(MemCachedTest, MGet) {
+    const int kKeys = 10;
+    std::vector<std::string> keys;
+    std::vector<std::string> values;
+    CountDownEvent setEvent(kKeys);
+    for (int i = 0; i < kKeys; i++) {
+        keys.emplace_back(absl::StrCat("mget_", i));
+        values.emplace_back(absl::StrCat("value_", i));
+        manager_.Set(std::make_shared<SetKVCacheTask>(
+            keys[i], values[i].c_str(), values[i].length(),
+            [&setEvent](const std::shared_ptr<SetKVCacheTask>& task) {
+                ASSERT_TRUE(task->res);
+                setEvent.Signal();
+            }));
+    }
+    setEvent.Wait();
+
+    // all keys, ranged read of the first key and a key not exist
+    std::string notExist = "mget_not_exist";
+    std::vector<std::vector<char>> results(kKeys + 2, std::vector<char>(8));
+    std::vector<std::shared_ptr<GetKVCacheTask>> tasks;
+    CountDownEvent getEvent(kKeys + 2);
+    auto done = [&getEvent](const std::shared_ptr<GetKVCacheTask>&) {
+        getEvent.Signal();
+    };
+    for (int i = 0; i < kKeys; i++) {
+        tasks.emplace_back(std::make_shared<GetKVCacheTask>(
+            keys[i], results[i].data(), 0, values[i].length(), done));
+    }
+    tasks.emplace_back(std::make_shared<GetKVCacheTask>(
+        keys[0], results[kKeys].data(), 2, 5, done));
+    tasks.emplace_back(std::make_shared<GetKVCacheTask>(
+        notExist, results[kKeys + 1].data(), 0, 1, done));
+    manager_.MGet(tasks);
+    getEvent.Wait();
+
+    for (int i = 0; i < kKeys; i++) {
+        ASSERT_TRUE(tasks[i]->res);
+        ASSERT_EQ(values[i].length(), tasks[i]->length);
+        ASSERT_EQ(values[i],
+                  std::string(results[i].data(), values[i].length()));
+    }
+    ASSERT_TRUE(tasks[kKeys]->res);
+    ASSERT_EQ("lue_0", std::string(results[kKeys].data(), 5));
+    ASSERT_FALSE(tasks[kKeys + 1]->res);
+}
+
+TEST_F(MemCachedTest, SubBlock) {
+    std::shared_ptr<MemCachedClient> client(new MemCachedClient());
+    MemcacheClusterInfo info;
+    client->Init(info, "test_subblock");
+    ASSERT_TRUE(client->AddServer("127.0.0.1", 18080));
+    ASSERT_TRUE(client->PushServer());
+    KVClientManagerOpt opt;
+    opt.subBlockSize = 4;
+    KVClientManager manager;
+    ASSERT_TRUE(manager.Init(opt, client, "test_subblock"));
+
+    std::string key = "subblock";
+    std::string value = "0123456789";
+    CountDownEvent setEvent(1);
+    manager.Set(std::make_shared<SetKVCacheTask>(
+        key, value.c_str(), value.length(),
+        [&setEvent](const std::shared_ptr<SetKVCacheTask>& task) {
+            ASSERT_TRUE(task->res);
+            setEvent.Signal();
+        }));
+    setEvent.Wait();
+
+    // stored by sub-blocks
+    std::string errorlog;
+    char buf[10];
+    uint64_t actLength = 0;
+    memcached_return_t retCode;
+    ASSERT_TRUE(client->Get("subblock@1", buf, 0, 4, &errorlog, &actLength,
+                            &retCode));
+    ASSERT_EQ("4567", std::string(buf, 4));
+    ASSERT_EQ(4, actLength);
+    ASSERT_TRUE(client->Get("subblock@2", buf, 0, 2, &errorlog, &actLength,
+                            &retCode));
+    ASSERT_EQ(2, actLength);
+
+    // ranged read only fetches the sub-blocks it covers
+    for (const auto& range : std::vector<std::pair<uint64_t, uint64_t>>{
+             {0, 10}, {3, 6}, {4, 4}, {9, 1}}) {
+        CountDownEvent getEvent(1);
+        memset(buf, 0, sizeof(buf));
+        auto task = std::make_shared<GetKVCacheTask>(
+            key, buf, range.first, range.second,
+            [&getEvent](const std::shared_ptr<GetKVCacheTask>&) {
+                getEvent.Signal();
+            });
+        manager.Get(task);
+        getEvent.Wait();
+        ASSERT_TRUE(task->res);
+        ASSERT_EQ(value.substr(range.first, range.second),
+                  std::string(buf, range.second));
+        ASSERT_EQ(value.length(), task->length);
+    }
+
+    // out of range
+    CountDownEvent getEvent(1);
+    auto task = std::make_shared<GetKVCacheTask>(
+        key, buf, 8, 4, [&getEvent](const std::shared_ptr<GetKVCacheTask>&) {
+            getEvent.Signal();
+        });
+    manager.Get(task);
+    getEvent.Wait();
+    ASSERT_FALSE(task->res);
+}
+
 }  // namespace client
 }  // namespace curvefs
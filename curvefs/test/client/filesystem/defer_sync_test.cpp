@@ -174,6 +174,63 @@ TEST_F(DeferSyncTest, Dirty) {
     deferSync->Stop();
 }
 
+TEST_F(DeferSyncTest, Coalesce) {
+    auto builder = DeferSyncBuilder();
+    auto deferSync = builder.SetOption([&](bool* cto, DeferSyncOption* option) {
+        option->delay = 3;
+        option->batchFlush = true;
+    }).Build();
+    deferSync->Start();
+
+    // inode shipped many times in one window is synced only once
+    auto inode = MkInode(100, InodeOption().metaClient(metaClient_));
+    inode->SetLength(100);
+    EXPECT_CALL(*metaClient_, BatchUpdateInodeWithOutNlinkAsync_rvr(_, _))
+        .WillOnce(Invoke([](uint32_t, std::vector<InodeUpdate> updates) {
+            ASSERT_EQ(1, updates.size());
+            ASSERT_EQ(100, updates[0].inodeId);
+            updates[0].done->SetMetaStatusCode(MetaStatusCode::OK);
+            updates[0].done->Run();
+        }));
+    for (int i = 0; i < 3; i++) {
+        deferSync->Push(inode);
+    }
+    deferSync->Stop();
+}
+
+TEST_F(DeferSyncTest, SyncPending) {
+    auto builder = DeferSyncBuilder();
+    auto deferSync = builder.SetOption([&](bool* cto, DeferSyncOption* option) {
+        option->delay = 3;
+        option->batchFlush = true;
+        option->batchFlushSize = 2;
+    }).Build();
+
+    auto inode1 = MkInode(100, InodeOption().metaClient(metaClient_));
+    auto inode2 = MkInode(200, InodeOption().metaClient(metaClient_));
+    inode1->SetLength(100);
+    inode2->SetLength(200);
+    EXPECT_CALL(*metaClient_, BatchUpdateInodeWithOutNlinkAsync_rvr(_, _))
+        .WillOnce(Invoke([](uint32_t, std::vector<InodeUpdate> updates) {
+            ASSERT_EQ(2, updates.size());
+            for (auto& update : updates) {
+                update.done->SetMetaStatusCode(MetaStatusCode::OK);
+                update.done->Run();
+            }
+        }));
+
+    // CASE 1: less than a batch, wait for the window
+    deferSync->Push(inode1);
+    deferSync->SyncPending(false);
+
+    // CASE 2: a full batch is shipped at once
+    deferSync->Push(inode2);
+    deferSync->SyncPending(false);
+
+    // CASE 3: nothing left
+    deferSync->SyncPending(true);
+}
+
 TEST_F(DeferSyncTest, IsDefered_cto) {
     auto builder = DeferSyncBuilder();
     auto deferSync = builder.SetOption([&](bool* cto, DeferSyncOption* option) {
@@ -213,6 +213,27 @@ TEST_F(DirEntryListTest, Mtime) {
     ASSERT_EQ(time, TimeSpec(123, 456));
 }
 
+TEST_F(DirEntryListTest, Lookup) {
+    DirEntryList entries;
+    entries.Add(MkDirEntry(100, "f1"));
+
+    // CASE 1: name index is built at first lookup
+    DirEntry dirEntry;
+    ASSERT_TRUE(entries.Lookup("f1", &dirEntry));
+    ASSERT_EQ(dirEntry.ino, 100);
+    ASSERT_FALSE(entries.Lookup("f2", &dirEntry));
+
+    // CASE 2: entry added after index built
+    entries.Add(MkDirEntry(200, "f2"));
+    ASSERT_TRUE(entries.Lookup("f2", &dirEntry));
+    ASSERT_EQ(dirEntry.ino, 200);
+
+    // CASE 3: lookup after clear
+    entries.Clear();
+    ASSERT_FALSE(entries.Lookup("f1", &dirEntry));
+    ASSERT_FALSE(entries.Lookup("f2", &dirEntry));
+}
+
 }  // namespace filesystem
 }  // namespace client
 }  // namespace curvefs
@@ -25,6 +25,7 @@
 
 #include "curvefs/test/client/filesystem/helper/helper.h"
 #include "curvefs/src/client/filesystem/filesystem.h"
+#include "src/common/timeutility.h"
 
 namespace curvefs {
 namespace client {
@@ -205,6 +206,153 @@ TEST_F(FileSystemTest, Lookup_NegativeCache) {
     ASSERT_EQ(rc, CURVEFS_ERROR::NOT_EXIST);
 }
 
+TEST_F(FileSystemTest, Lookup_DirCache) {
+    auto builder = FileSystemBuilder();
+    auto fs = builder.Build();
+
+    // mock what opendir() and getattr() do:
+    Ino parent(1);
+    auto handler = fs->NewHandler();
+    handler->mtime = TimeSpec(123, 456);
+    auto fi = FileInfo();
+    fi.fh = handler->fh;
+    auto attrWatcher = fs->BorrowMember().attrWatcher;
+    attrWatcher->RemeberMtime(MkAttr(parent, AttrOption().mtime(123, 456)));
+
+    EXPECT_CALL_INVOKE_ListDentry(*builder.GetDentryManager(),
+        [&](uint64_t parent,
+            std::list<Dentry>* dentries,
+            uint32_t limit,
+            bool only,
+            uint32_t nlink) -> CURVEFS_ERROR {
+            dentries->push_back(MkDentry(100, "f1"));
+            return CURVEFS_ERROR::OK;
+        });
+    EXPECT_CALL_INVOKE_BatchGetInodeAttrAsync(*builder.GetInodeManager(),
+        [&](uint64_t parentId,
+            std::set<uint64_t>* inos,
+            std::map<uint64_t, InodeAttr>* attrs) -> CURVEFS_ERROR {
+            for (const auto& ino : *inos) {
+                attrs->emplace(ino, MkAttr(ino, AttrOption().length(4096)));
+            }
+            return CURVEFS_ERROR::OK;
+        });
+
+    auto entries = std::make_shared<DirEntryList>();
+    auto rc = fs->ReadDir(parent, &fi, &entries);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+
+    // CASE 1: lookup hit directory cache without rpc
+    EntryOut entryOut;
+    rc = fs->Lookup(parent, "f1", &entryOut);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+    ASSERT_EQ(entryOut.attr.inodeid(), 100);
+    ASSERT_EQ(entryOut.attr.length(), 4096);
+
+    // CASE 2: entry not in directory cache
+    rc = fs->Lookup(parent, "f2", &entryOut);
+    ASSERT_EQ(rc, CURVEFS_ERROR::NOT_EXIST);
+
+    // CASE 3: directory modified by ourself
+    fs->InvalidateDir(parent);
+    EXPECT_CALL_RETURN_GetDentry(*builder.GetDentryManager(),
+                                 CURVEFS_ERROR::NOT_EXIST);
+    rc = fs->Lookup(parent, "f1", &entryOut);
+    ASSERT_EQ(rc, CURVEFS_ERROR::NOT_EXIST);
+}
+
+TEST_F(FileSystemTest, Lookup_DirCacheLeased) {
+    auto builder = FileSystemBuilder();
+    auto fs = builder.SetOption([](FileSystemOption* option) {
+        option->metaLeaseOption.enable = true;
+    }).Build();
+
+    // mock what the session refresh does
+    auto lease = fs->BorrowMember().metaLease;
+    auto refresh = [&](std::vector<uint64_t> granted) {
+        MetaLeaseRequest request;
+        MetaLeaseResponse response;
+        lease->PrepareRefresh(&request);
+        response.set_epoch(1);
+        response.set_sequence(0);
+        response.set_leasetimeus(3600 * 1000000ULL);
+        *response.mutable_granted() = {granted.begin(), granted.end()};
+        lease->OnRefreshed(true, request, response,
+                           ::curve::common::TimeUtility::GetTimeofDayUs());
+    };
+    refresh({});
+
+    // mock what opendir() does, the mtime of parent is unknown
+    Ino parent(1);
+    auto handler = fs->NewHandler();
+    handler->mtime = TimeSpec(123, 456);
+    auto fi = FileInfo();
+    fi.fh = handler->fh;
+
+    auto listDentry = [&]() {
+        EXPECT_CALL_INVOKE_ListDentry(*builder.GetDentryManager(),
+            [&](uint64_t parent,
+                std::list<Dentry>* dentries,
+                uint32_t limit,
+                bool only,
+                uint32_t nlink) -> CURVEFS_ERROR {
+                dentries->push_back(MkDentry(100, "f1"));
+                return CURVEFS_ERROR::OK;
+            });
+        EXPECT_CALL_INVOKE_BatchGetInodeAttrAsync(*builder.GetInodeManager(),
+            [&](uint64_t parentId,
+                std::set<uint64_t>* inos,
+                std::map<uint64_t, InodeAttr>* attrs) -> CURVEFS_ERROR {
+                for (const auto& ino : *inos) {
+                    attrs->emplace(ino,
+                                   MkAttr(ino, AttrOption().length(4096)));
+                }
+                return CURVEFS_ERROR::OK;
+            });
+    };
+    listDentry();
+    auto entries = std::make_shared<DirEntryList>();
+    auto rc = fs->ReadDir(parent, &fi, &entries);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+    refresh({ parent });
+    ASSERT_TRUE(lease->Hold(parent));
+
+    // CASE 1: the name is trusted, but the attribute of child is fetched
+    EXPECT_CALL_INVOKE_GetInodeAttr(*builder.GetInodeManager(),
+        [&](uint64_t ino, InodeAttr* attr) -> CURVEFS_ERROR {
+            *attr = MkAttr(ino, AttrOption().length(8192));
+            return CURVEFS_ERROR::OK;
+        });
+    EntryOut entryOut;
+    rc = fs->Lookup(parent, "f1", &entryOut);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+    ASSERT_EQ(entryOut.attr.inodeid(), 100);
+    ASSERT_EQ(entryOut.attr.length(), 8192);
+
+    // CASE 2: entry not in directory cache
+    rc = fs->Lookup(parent, "f2", &entryOut);
+    ASSERT_EQ(rc, CURVEFS_ERROR::NOT_EXIST);
+
+    // CASE 3: opendir() skips getattr() before the entries expire
+    rc = fs->OpenDir(parent, &fi);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+    ASSERT_EQ(fs->FindHandler(fi.fh)->mtime, TimeSpec(123, 456));
+
+    // CASE 4: the expired entries are dropped even if we hold the lease
+    entries->SetExpireTime(TimeSpec(0, 0));
+    EXPECT_CALL_INVOKE_GetInodeAttr(*builder.GetInodeManager(),
+        [&](uint64_t ino, InodeAttr* attr) -> CURVEFS_ERROR {
+            *attr = MkAttr(ino, AttrOption().mtime(123, 456));
+            return CURVEFS_ERROR::OK;
+        });
+    rc = fs->OpenDir(parent, &fi);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+
+    listDentry();
+    rc = fs->ReadDir(parent, &fi, &entries);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+}
+
 TEST_F(FileSystemTest, GetAttr_Basic) {
     auto builder = FileSystemBuilder();
     auto fs = builder.Build();
@@ -38,24 +38,24 @@ TEST_F(LookupCacheTest, Basic) {
     auto option = LookupCacheOption{ lruSize: 10, negativeTimeoutSec: 1 };
     auto cache = std::make_shared<LookupCache>(option);
 
-    ASSERT_FALSE(cache->Get(1, "f1"));
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(0, 0)));
 
-    cache->Put(1, "f1");
-    ASSERT_TRUE(cache->Get(1, "f1"));
+    cache->Put(1, "f1", TimeSpec(0, 0));
+    ASSERT_TRUE(cache->Get(1, "f1", TimeSpec(0, 0)));
 }
 
 TEST_F(LookupCacheTest, Enable) {
     // CASE 1: cache off, negativeTimeoutSec = 0.
     auto option = LookupCacheOption{ lruSize: 10, negativeTimeoutSec: 0 };
     auto cache = std::make_shared<LookupCache>(option);
-    cache->Put(1, "f1");
-    ASSERT_FALSE(cache->Get(1, "f1"));
+    cache->Put(1, "f1", TimeSpec(0, 0));
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(0, 0)));
 
     // CASE 2: cache on, negativeTimeoutSec = 1.
     option = LookupCacheOption{ lruSize: 10, negativeTimeoutSec: 1 };
     cache = std::make_shared<LookupCache>(option);
-    cache->Put(1, "f1");
-    ASSERT_TRUE(cache->Get(1, "f1"));
+    cache->Put(1, "f1", TimeSpec(0, 0));
+    ASSERT_TRUE(cache->Get(1, "f1", TimeSpec(0, 0)));
 }
 
 TEST_F(LookupCacheTest, Timeout) {
@@ -63,12 +63,12 @@ TEST_F(LookupCacheTest, Timeout) {
     auto cache = std::make_shared<LookupCache>(option);
 
     // CASE 1: cache hit.
-    cache->Put(1, "f1");
-    ASSERT_TRUE(cache->Get(1, "f1"));
+    cache->Put(1, "f1", TimeSpec(0, 0));
+    ASSERT_TRUE(cache->Get(1, "f1", TimeSpec(0, 0)));
 
     // CASE 2: cache miss due to expiration.
     std::this_thread::sleep_for(std::chrono::seconds(1));
-    ASSERT_FALSE(cache->Get(1, "f1"));
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(0, 0)));
 }
 
 TEST_F(LookupCacheTest, LRUSize) {
@@ -76,13 +76,44 @@ TEST_F(LookupCacheTest, LRUSize) {
     auto cache = std::make_shared<LookupCache>(option);
 
     // CASE 1: cache hit.
-    cache->Put(1, "f1");
-    ASSERT_TRUE(cache->Get(1, "f1"));
+    cache->Put(1, "f1", TimeSpec(0, 0));
+    ASSERT_TRUE(cache->Get(1, "f1", TimeSpec(0, 0)));
 
     // CASE 2: cache miss due to eviction.
-    cache->Put(1, "f2");
-    ASSERT_FALSE(cache->Get(1, "f1"));
-    ASSERT_TRUE(cache->Get(1, "f2"));
+    cache->Put(1, "f2", TimeSpec(0, 0));
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(0, 0)));
+    ASSERT_TRUE(cache->Get(1, "f2", TimeSpec(0, 0)));
+}
+
+TEST_F(LookupCacheTest, Mtime) {
+    auto option = LookupCacheOption{ lruSize: 10, negativeTimeoutSec: 1 };
+    auto cache = std::make_shared<LookupCache>(option);
+
+    // CASE 1: cache hit with same modified time of directory.
+    cache->Put(1, "f1", TimeSpec(100, 0));
+    ASSERT_TRUE(cache->Get(1, "f1", TimeSpec(100, 0)));
+
+    // CASE 2: cache miss due to directory modified.
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(200, 0)));
+
+    // CASE 3: entries with old modified time are dropped.
+    cache->Put(1, "f2", TimeSpec(200, 0));
+    ASSERT_TRUE(cache->Get(1, "f2", TimeSpec(200, 0)));
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(100, 0)));
+}
+
+TEST_F(LookupCacheTest, Drop) {
+    auto option = LookupCacheOption{ lruSize: 10, negativeTimeoutSec: 1 };
+    auto cache = std::make_shared<LookupCache>(option);
+
+    cache->Put(1, "f1", TimeSpec(0, 0));
+    cache->Put(1, "f2", TimeSpec(0, 0));
+    cache->Put(2, "f1", TimeSpec(0, 0));
+
+    cache->Drop(1);
+    ASSERT_FALSE(cache->Get(1, "f1", TimeSpec(0, 0)));
+    ASSERT_FALSE(cache->Get(1, "f2", TimeSpec(0, 0)));
+    ASSERT_TRUE(cache->Get(2, "f1", TimeSpec(0, 0)));
 }
 
 }  // namespace filesystem
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "curvefs/src/client/filesystem/read_buffer.h"
+
+namespace curvefs {
+namespace client {
+namespace filesystem {
+
+class ReadBufferTest : public ::testing::Test {
+ protected:
+    int OpenFile() {
+        int fd = ::open("/dev/zero", O_RDONLY);
+        EXPECT_GE(fd, 0);
+        return fd;
+    }
+};
+
+TEST_F(ReadBufferTest, Memory) {
+    ReadBuffer buffer;
+    char* data = buffer.Allocate(4096);
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(buffer.Size(), 4096);
+
+    buffer.SetSize(100);
+    auto bufvec = buffer.ToBufvec();
+    ASSERT_EQ(bufvec->count, 1);
+    ASSERT_EQ(bufvec->buf[0].size, 100);
+    ASSERT_EQ(bufvec->buf[0].mem, data);
+    ASSERT_EQ(fuse_buf_size(bufvec), 100);
+}
+
+TEST_F(ReadBufferTest, Empty) {
+    ReadBuffer buffer;
+    buffer.Allocate(4096);
+    buffer.SetSize(0);
+    auto bufvec = buffer.ToBufvec();
+    ASSERT_EQ(bufvec->count, 1);
+    ASSERT_EQ(fuse_buf_size(bufvec), 0);
+}
+
+TEST_F(ReadBufferTest, MemoryAndFiles) {
+    ReadBuffer buffer;
+    char* data = buffer.Allocate(10);
+    int fd1 = OpenFile();
+    int fd2 = OpenFile();
+    buffer.AddFile(8, fd2, 100, 2);  // out of order
+    buffer.AddFile(3, fd1, 0, 3);
+    ASSERT_EQ(buffer.NumRanges(), 2);
+
+    // |   mem   |  fd1  | mem | fd2 |
+    // 0         3       6     8     10
+    auto bufvec = buffer.ToBufvec();
+    ASSERT_EQ(bufvec->count, 4);
+    ASSERT_EQ(fuse_buf_size(bufvec), 10);
+
+    ASSERT_EQ(bufvec->buf[0].mem, data);
+    ASSERT_EQ(bufvec->buf[0].size, 3);
+    ASSERT_TRUE(bufvec->buf[1].flags & FUSE_BUF_IS_FD);
+    ASSERT_EQ(bufvec->buf[1].fd, fd1);
+    ASSERT_EQ(bufvec->buf[1].pos, 0);
+    ASSERT_EQ(bufvec->buf[1].size, 3);
+    ASSERT_EQ(bufvec->buf[2].mem, data + 6);
+    ASSERT_EQ(bufvec->buf[2].size, 2);
+    ASSERT_EQ(bufvec->buf[3].fd, fd2);
+    ASSERT_EQ(bufvec->buf[3].pos, 100);
+    ASSERT_EQ(bufvec->buf[3].size, 2);
+}
+
+TEST_F(ReadBufferTest, ShortRead) {
+    ReadBuffer buffer;
+    char* data = buffer.Allocate(10);
+    int fd = OpenFile();
+    buffer.AddFile(4, fd, 0, 6);
+    buffer.SetSize(6);
+
+    // the file range is truncated to the reply size
+    auto bufvec = buffer.ToBufvec();
+    ASSERT_EQ(bufvec->count, 2);
+    ASSERT_EQ(bufvec->buf[0].mem, data);
+    ASSERT_EQ(bufvec->buf[0].size, 4);
+    ASSERT_EQ(bufvec->buf[1].fd, fd);
+    ASSERT_EQ(bufvec->buf[1].size, 2);
+    ASSERT_EQ(fuse_buf_size(bufvec), 6);
+}
+
+TEST_F(ReadBufferTest, SharedMemory) {
+    ReadBuffer buffer;
+    char* data = buffer.Allocate(10);
+    int fd = OpenFile();
+    auto page = std::make_shared<std::vector<char>>(4, 'a');
+    std::weak_ptr<std::vector<char>> weak = page;
+    buffer.AddMemory(6, page->data(), 4, page);
+    buffer.AddFile(2, fd, 0, 2);
+    page.reset();
+    ASSERT_FALSE(weak.expired());
+
+    // | mem | fd | mem | page |
+    // 0     2    4     6      10
+    auto bufvec = buffer.ToBufvec();
+    ASSERT_EQ(bufvec->count, 4);
+    ASSERT_EQ(fuse_buf_size(bufvec), 10);
+    ASSERT_EQ(bufvec->buf[0].mem, data);
+    ASSERT_EQ(bufvec->buf[1].fd, fd);
+    ASSERT_EQ(bufvec->buf[2].mem, data + 4);
+    ASSERT_EQ(bufvec->buf[2].size, 2);
+    ASSERT_FALSE(bufvec->buf[3].flags & FUSE_BUF_IS_FD);
+    ASSERT_EQ(bufvec->buf[3].mem, weak.lock()->data());
+    ASSERT_EQ(bufvec->buf[3].size, 4);
+
+    buffer.DropRanges();
+    ASSERT_TRUE(weak.expired());
+}
+
+TEST_F(ReadBufferTest, DropRanges) {
+    ReadBuffer buffer;
+    buffer.Allocate(10);
+    buffer.AddFile(0, OpenFile(), 0, 10);
+    buffer.DropRanges();
+    ASSERT_EQ(buffer.NumRanges(), 0);
+
+    auto bufvec = buffer.ToBufvec();
+    ASSERT_EQ(bufvec->count, 1);
+    ASSERT_FALSE(bufvec->buf[0].flags & FUSE_BUF_IS_FD);
+}
+
+}  // namespace filesystem
+}  // namespace client
+}  // namespace curvefs
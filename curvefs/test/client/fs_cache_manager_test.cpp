@@ -27,6 +27,7 @@
 #include "curvefs/src/client/s3/client_s3_cache_manager.h"
 #include "src/common/concurrent/count_down_event.h"
 #include "curvefs/test/client/mock_client_s3_cache_manager.h"
+#include "curvefs/test/client/mock_inode_cache_manager.h"
 
 namespace curvefs {
 namespace client {
@@ -61,7 +62,8 @@ class FsCacheManagerTest : public testing::Test {
         fsCacheManager_ = std::make_shared<FsCacheManager>(
             s3ClientAdaptor_, maxReadCacheByte_, maxWriteCacheByte,
             option.readCacheThreads, nullptr);
-        s3ClientAdaptor_->Init(option, nullptr, nullptr, nullptr,
+        mockInodeManager_ = std::make_shared<MockInodeCacheManager>();
+        s3ClientAdaptor_->Init(option, nullptr, mockInodeManager_, nullptr,
                                fsCacheManager_, nullptr, nullptr);
         s3ClientAdaptor_->SetFsId(2);
 
@@ -76,6 +78,7 @@ class FsCacheManagerTest : public testing::Test {
     S3ClientAdaptorImpl *s3ClientAdaptor_;
     std::shared_ptr<FsCacheManager> fsCacheManager_;
     std::shared_ptr<MockChunkCacheManager> mockChunkCacheManager_;
+    std::shared_ptr<MockInodeCacheManager> mockInodeManager_;
     uint64_t maxReadCacheByte_;
 };
 
@@ -158,11 +161,76 @@ TEST_F(FsCacheManagerTest, test_lru_set_and_delete) {
     }
 }
 
+TEST_F(FsCacheManagerTest, test_arc_scan_resistant) {
+    auto fsCacheManager = std::make_shared<FsCacheManager>(
+        s3ClientAdaptor_, maxReadCacheByte_, maxReadCacheByte_, 1, nullptr,
+        true);
+    uint64_t dataCacheByte = 4ull * 1024 * 1024;  // 4MiB
+    uint64_t pageSize = 64ull * 1024;
+    char *buf = new char[dataCacheByte];
+    std::list<DataCachePtr>::iterator outIter;
+
+    EXPECT_CALL(*mockChunkCacheManager_, ReleaseReadDataCache(_))
+        .WillRepeatedly(Return());
+
+    // 1. data caches read twice are moved to frequent list
+    std::vector<DataCachePtr> hot;
+    for (uint64_t i = 0; i < 2; ++i) {
+        auto dataCache = std::make_shared<DataCache>(
+            s3ClientAdaptor_, mockChunkCacheManager_, i * pageSize,
+            dataCacheByte, buf, nullptr);
+        ASSERT_TRUE(fsCacheManager->Set(dataCache, &outIter));
+        ASSERT_FALSE(dataCache->InFrequentList());
+        fsCacheManager->Get(outIter);
+        ASSERT_TRUE(dataCache->InFrequentList());
+        hot.push_back(dataCache);
+    }
+
+    // 2. scan only evicts the data caches read once
+    std::vector<DataCachePtr> scan;
+    for (uint64_t i = 2; i < 20; ++i) {
+        auto dataCache = std::make_shared<DataCache>(
+            s3ClientAdaptor_, mockChunkCacheManager_, i * pageSize,
+            dataCacheByte, buf, nullptr);
+        ASSERT_TRUE(fsCacheManager->Set(dataCache, &outIter));
+        ASSERT_LE(fsCacheManager->GetLruByte(), maxReadCacheByte_);
+        scan.push_back(dataCache);
+    }
+    ASSERT_TRUE(hot[0]->InReadCache());
+    ASSERT_TRUE(hot[1]->InReadCache());
+    ASSERT_TRUE(scan.back()->InReadCache());
+    ASSERT_FALSE(scan.front()->InReadCache());
+
+    // 3. read a data cache evicted recently, it hits the ghost list even
+    //    if its chunk cache manager is released and created again
+    uint64_t evictedPos = scan[scan.size() - 3]->GetChunkPos();
+    ASSERT_FALSE(scan[scan.size() - 3]->InReadCache());
+    auto chunkCacheManager = std::make_shared<MockChunkCacheManager>();
+    EXPECT_CALL(*chunkCacheManager, ReleaseReadDataCache(_))
+        .WillRepeatedly(Return());
+    auto dataCache = std::make_shared<DataCache>(
+        s3ClientAdaptor_, chunkCacheManager, evictedPos, dataCacheByte,
+        buf, nullptr);
+    ASSERT_TRUE(fsCacheManager->Set(dataCache, &outIter));
+    ASSERT_TRUE(dataCache->InFrequentList());
+
+    // 4. delete from frequent list
+    ASSERT_TRUE(fsCacheManager->Delete(outIter));
+    ASSERT_FALSE(dataCache->InReadCache());
+    ASSERT_LE(fsCacheManager->GetLruByte(), maxReadCacheByte_ - dataCacheByte);
+
+    delete[] buf;
+}
+
 TEST_F(FsCacheManagerTest, test_fsSync_ok) {
     uint64_t inodeId = 1;
     auto fileCache = std::make_shared<MockFileCacheManager>();
 
     EXPECT_CALL(*fileCache, Flush(_, _)).WillOnce(Return(CURVEFS_ERROR::OK));
+    // full batch is shipped behind the uploads of each file,
+    // the rest is shipped at the end of a forced sync
+    EXPECT_CALL(*mockInodeManager_, SyncPending(false)).Times(1);
+    EXPECT_CALL(*mockInodeManager_, SyncPending(true)).Times(1);
     fsCacheManager_->SetFileCacheManagerForTest(inodeId, fileCache);
     ASSERT_EQ(CURVEFS_ERROR::OK, fsCacheManager_->FsSync(true));
 }
@@ -185,6 +253,7 @@ TEST_F(FsCacheManagerTest, test_fsSync_fail) {
 
     EXPECT_CALL(*fileCache, Flush(_, _))
         .WillOnce(Return(CURVEFS_ERROR::INTERNAL));
+    EXPECT_CALL(*mockInodeManager_, SyncPending(_)).Times(0);
     fsCacheManager_->SetFileCacheManagerForTest(inodeId, fileCache);
     ASSERT_EQ(CURVEFS_ERROR::INTERNAL, fsCacheManager_->FsSync(true));
 }
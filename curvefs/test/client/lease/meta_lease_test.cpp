@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "curvefs/src/client/lease/meta_lease.h"
+#include "src/common/timeutility.h"
+
+namespace curvefs {
+namespace client {
+
+using ::curve::common::TimeUtility;
+
+class MetaLeaseTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        MetaLeaseOption option;
+        option.enable = true;
+        option.lruSize = 2;
+        lease_ = std::make_shared<MetaLease>(option);
+        lease_->SetRevokeHandler(
+            [this](uint64_t ino) { revoked_.push_back(ino); });
+    }
+
+    // refresh once, the |response| is filled with current epoch
+    void Refresh(MetaLeaseResponse response,
+                 MetaLeaseRequest* request = nullptr) {
+        MetaLeaseRequest req;
+        lease_->PrepareRefresh(&req);
+        response.set_epoch(kEpoch);
+        response.set_leasetimeus(kLeaseTimeUs);
+        lease_->OnRefreshed(true, req, response, Now());
+        if (request != nullptr) {
+            *request = req;
+        }
+    }
+
+    uint64_t Now() { return TimeUtility::GetTimeofDayUs(); }
+
+ protected:
+    static constexpr uint64_t kEpoch = 100;
+    static constexpr uint64_t kLeaseTimeUs = 1000000;
+    std::shared_ptr<MetaLease> lease_;
+    std::vector<uint64_t> revoked_;
+};
+
+constexpr uint64_t MetaLeaseTest::kEpoch;
+constexpr uint64_t MetaLeaseTest::kLeaseTimeUs;
+
+TEST_F(MetaLeaseTest, AcquireAndRevoke) {
+    MetaLeaseResponse response;
+    response.set_sequence(1);
+    Refresh(response);
+    ASSERT_EQ(lease_->Sequence(), 1);
+
+    lease_->Acquire(10, lease_->Sequence());
+    ASSERT_FALSE(lease_->Hold(10));
+
+    MetaLeaseRequest request;
+    response.add_granted(10);
+    Refresh(response, &request);
+    ASSERT_EQ(request.epoch(), kEpoch);
+    ASSERT_EQ(request.sequence(), 1);
+    ASSERT_EQ(request.acquire_size(), 1);
+    ASSERT_TRUE(lease_->Hold(10));
+
+    response.Clear();
+    response.set_sequence(2);
+    response.add_revoked(10);
+    Refresh(response);
+    ASSERT_FALSE(lease_->Hold(10));
+    ASSERT_EQ(revoked_, std::vector<uint64_t>{10});
+}
+
+TEST_F(MetaLeaseTest, EvictAndRelease) {
+    MetaLeaseResponse response;
+    Refresh(response);
+
+    response.add_granted(1);
+    response.add_granted(2);
+    response.add_granted(3);
+    Refresh(response);
+    ASSERT_FALSE(lease_->Hold(1));
+    ASSERT_TRUE(lease_->Hold(2));
+    ASSERT_TRUE(lease_->Hold(3));
+    ASSERT_EQ(revoked_, std::vector<uint64_t>{1});
+
+    MetaLeaseRequest request;
+    lease_->Modified(2);
+    Refresh(MetaLeaseResponse(), &request);
+    ASSERT_EQ(request.release_size(), 1);
+    ASSERT_EQ(request.release(0), 1);
+    ASSERT_EQ(request.modified_size(), 1);
+    ASSERT_EQ(request.modified(0), 2);
+}
+
+TEST_F(MetaLeaseTest, RefreshFailed) {
+    MetaLeaseResponse response;
+    Refresh(response);
+    response.add_granted(1);
+    Refresh(response);
+    ASSERT_TRUE(lease_->Hold(1));
+
+    // leases are dropped and the messages are sent again
+    MetaLeaseRequest request;
+    lease_->Modified(2);
+    lease_->PrepareRefresh(&request);
+    lease_->OnRefreshed(false, request, MetaLeaseResponse(), Now());
+    ASSERT_FALSE(lease_->Hold(1));
+    ASSERT_EQ(revoked_, std::vector<uint64_t>{1});
+
+    lease_->PrepareRefresh(&request);
+    ASSERT_EQ(request.epoch(), 0);
+    ASSERT_EQ(request.release_size(), 1);
+    ASSERT_EQ(request.modified_size(), 1);
+}
+
+TEST_F(MetaLeaseTest, EpochChanged) {
+    MetaLeaseResponse response;
+    Refresh(response);
+    response.add_granted(1);
+    Refresh(response);
+    ASSERT_TRUE(lease_->Hold(1));
+
+    MetaLeaseRequest request;
+    lease_->PrepareRefresh(&request);
+    response.Clear();
+    response.set_epoch(kEpoch + 1);
+    response.set_leasetimeus(kLeaseTimeUs);
+    response.add_granted(2);
+    lease_->OnRefreshed(true, request, response, Now());
+    ASSERT_FALSE(lease_->Hold(1));
+    ASSERT_FALSE(lease_->Hold(2));
+    ASSERT_EQ(revoked_, std::vector<uint64_t>{1});
+}
+
+TEST_F(MetaLeaseTest, LeaseExpired) {
+    MetaLeaseResponse response;
+    Refresh(response);
+    response.add_granted(1);
+    Refresh(response);
+    ASSERT_TRUE(lease_->Hold(1));
+
+    // the lease time is counted from the request sent
+    MetaLeaseRequest request;
+    lease_->PrepareRefresh(&request);
+    response.set_epoch(kEpoch);
+    response.set_leasetimeus(kLeaseTimeUs);
+    lease_->OnRefreshed(true, request, response, Now() - kLeaseTimeUs);
+    ASSERT_FALSE(lease_->Hold(1));
+
+    Refresh(MetaLeaseResponse());
+    ASSERT_TRUE(lease_->Hold(1));
+}
+
+TEST_F(MetaLeaseTest, ReportModified) {
+    Refresh(MetaLeaseResponse());
+
+    std::atomic<bool> fail(false);
+    std::atomic<int> refreshed(0);
+    std::thread::id reporter;
+    std::vector<uint64_t> reported;
+    lease_->SetRefresher([&]() {
+        MetaLeaseRequest request;
+        if (fail) {
+            lease_->PrepareRefresh(&request);
+            lease_->OnRefreshed(false, request, MetaLeaseResponse(), Now());
+        } else {
+            Refresh(MetaLeaseResponse(), &request);
+            reported.insert(reported.end(), request.modified().begin(),
+                            request.modified().end());
+        }
+        reporter = std::this_thread::get_id();
+        refreshed++;
+    });
+    auto waitRefreshed = [&](int count) {
+        for (int i = 0; i < 500 && refreshed < count; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return refreshed == count;
+    };
+    lease_->Start();
+
+    // CASE 1: the modification is reported in background
+    lease_->Modified(1);
+    ASSERT_TRUE(waitRefreshed(1));
+    ASSERT_NE(reporter, std::this_thread::get_id());
+    ASSERT_EQ(reported, std::vector<uint64_t>{1});
+
+    // CASE 2: report failed, it is sent again at the next periodic refresh
+    //         rather than retried in background
+    fail = true;
+    lease_->Modified(2);
+    ASSERT_TRUE(waitRefreshed(2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(refreshed, 2);
+    lease_->Stop();
+
+    MetaLeaseRequest request;
+    lease_->PrepareRefresh(&request);
+    ASSERT_EQ(request.modified_size(), 1);
+    ASSERT_EQ(request.modified(0), 2);
+}
+
+TEST_F(MetaLeaseTest, Disabled) {
+    lease_ = std::make_shared<MetaLease>(MetaLeaseOption());
+    ASSERT_FALSE(lease_->Enabled());
+    lease_->Acquire(1, 0);
+    lease_->Modified(1);
+
+    MetaLeaseRequest request;
+    lease_->PrepareRefresh(&request);
+    ASSERT_EQ(request.acquire_size(), 0);
+    ASSERT_EQ(request.modified_size(), 0);
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -0,0 +1,302 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include <dirent.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "curvefs/src/client/logger/access_log.h"
+
+namespace curvefs {
+namespace client {
+namespace logger {
+
+namespace {
+
+enum class Code { kOK = 0, kNotExist = -3 };
+
+std::string StrCode(Code code) {
+    return code == Code::kOK ? "OK" : "not exist";
+}
+
+struct Summary {
+    uint64_t ino;
+    uint64_t length;
+};
+
+std::string StrSummary(Summary summary) {
+    return " (" + std::to_string(summary.ino) + ":" +
+           std::to_string(summary.length) + ")";
+}
+
+DeferredArg<Code> LogCode(Code code) { return { code, &StrCode }; }
+
+std::string Format(const AccessLogRecord& record) {
+    std::string message;
+    EXPECT_TRUE(record.FormatTo(&message));
+    return message;
+}
+
+// return all lines of the access log files under |dir|
+std::vector<std::string> ReadLogs(const std::string& dir) {
+    std::vector<std::string> lines;
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr) {
+        return lines;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.find("access.") != 0) {
+            continue;
+        }
+        std::ifstream in(dir + "/" + name);
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+    }
+    closedir(d);
+    return lines;
+}
+
+size_t CountLogs(const std::vector<std::string>& lines,
+                 const std::string& pattern) {
+    size_t count = 0;
+    for (const auto& line : lines) {
+        if (line.find(pattern) != std::string::npos) {
+            count++;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(AccessLogRecordTest, EncodeAndFormat) {
+    AccessLogRecord record;
+    std::string name = "file";
+    const char* cname = "dir";
+    uint64_t fh = 7;
+    int32_t offset = -5;
+    size_t size = 4096;
+    uint16_t mode = 0755;
+    record.Encode("op (%d,%s,%s,%d,%d,0%04o,0x%X): %s%s %.2f", offset, name,
+                  cname, fh, size, mode, 255, LogCode(Code::kNotExist),
+                  DeferredArg<Summary>{ Summary{ 100, 8192 }, &StrSummary },
+                  1.5);
+    ASSERT_EQ("op (-5,file,dir,7,4096,00755,0xFF): not exist (100:8192) 1.50",
+              Format(record));
+
+    // the buffer is reused by later records
+    record.Encode("destory : OK");
+    ASSERT_EQ("destory : OK", Format(record));
+
+    record.Encode("lookup (%d,%s): %s", 1, "", LogCode(Code::kOK));
+    ASSERT_EQ("lookup (1,): OK", Format(record));
+
+    const char* null = nullptr;
+    record.Encode("readlink (%d): %s", 2, null);
+    ASSERT_EQ("readlink (2): (null)", Format(record));
+
+    // the string is copied, so it may be modified after encoding
+    name = "modified";
+    record.Encode("unlink (%d,%s): %s", 1, name, LogCode(Code::kOK));
+    name.clear();
+    ASSERT_EQ("unlink (1,modified): OK", Format(record));
+}
+
+TEST(AccessLogRingTest, FullAndWraparound) {
+    AccessLogRing ring(4);
+    ASSERT_EQ(nullptr, ring.Front());
+
+    int pushed = 0;
+    int popped = 0;
+    auto push = [&]() {
+        AccessLogRecord* record = ring.Reserve();
+        if (record == nullptr) {
+            return false;
+        }
+        record->Encode("%d", pushed++);
+        ring.Commit();
+        return true;
+    };
+    auto pop = [&]() {
+        const AccessLogRecord* record = ring.Front();
+        if (record == nullptr) {
+            return false;
+        }
+        EXPECT_EQ(std::to_string(popped++), Format(*record));
+        ring.Pop();
+        return true;
+    };
+
+    // CASE 1: the ring is full
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(push());
+    }
+    ASSERT_FALSE(push());
+
+    // CASE 2: the popped slot is reused
+    ASSERT_TRUE(pop());
+    ASSERT_TRUE(push());
+    ASSERT_FALSE(push());
+
+    // CASE 3: records are popped in order across the wraparound
+    for (int round = 0; round < 10; round++) {
+        ASSERT_TRUE(pop());
+        ASSERT_TRUE(pop());
+        ASSERT_TRUE(push());
+        ASSERT_TRUE(push());
+    }
+    while (pop()) {
+    }
+    ASSERT_EQ(pushed, popped);
+    ASSERT_EQ(nullptr, ring.Front());
+}
+
+TEST(AccessLogRingTest, ConcurrentPushAndPop) {
+    AccessLogRing ring(64);
+    constexpr int kCount = 100000;
+    std::thread producer([&ring]() {
+        for (int i = 0; i < kCount; i++) {
+            AccessLogRecord* record;
+            while ((record = ring.Reserve()) == nullptr) {
+                std::this_thread::yield();
+            }
+            record->Encode("%d", i);
+            ring.Commit();
+        }
+    });
+
+    std::string message;
+    for (int i = 0; i < kCount; i++) {
+        const AccessLogRecord* record;
+        while ((record = ring.Front()) == nullptr) {
+            std::this_thread::yield();
+        }
+        ASSERT_TRUE(record->FormatTo(&message));
+        ASSERT_EQ(std::to_string(i), message);
+        ring.Pop();
+    }
+    producer.join();
+    ASSERT_EQ(nullptr, ring.Front());
+}
+
+TEST(AccessLogTest, SampleRate) {
+    uint32_t saved = common::FLAGS_access_log_sample_rate;
+    for (uint32_t rate : { 0, 1, 4, 10 }) {
+        common::FLAGS_access_log_sample_rate = rate;
+        int logged = 0;
+        for (int i = 0; i < 1000; i++) {
+            logged += ShouldLog("lookup") ? 1 : 0;
+        }
+        ASSERT_EQ(rate <= 1 ? 1000 : 1000 / rate, logged) << rate;
+    }
+    common::FLAGS_access_log_sample_rate = saved;
+}
+
+// the filter and the background writer are process-wide, so they are
+// tested in one case
+TEST(AccessLogTest, FilterAndWrite) {
+    const std::string dir = "./curvefs_client_access_log_test";
+    ASSERT_EQ(0, std::system(("rm -rf " + dir).c_str()));
+    ASSERT_EQ(0, std::system(("mkdir -p " + dir).c_str()));
+    ASSERT_TRUE(InitAccessLog(dir));
+
+    // wait until the background writer applies the filter
+    auto waitFilter = [](const char* op, bool expected) {
+        for (int i = 0; i < 500 && ShouldLog(op) != expected; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return ShouldLog(op) == expected;
+    };
+
+    // CASE 1: only the operations in the filter are logged
+    google::SetCommandLineOption("access_log_ops", "lookup, getattr");
+    ASSERT_TRUE(waitFilter("mkdir", false));
+    ASSERT_TRUE(ShouldLog("lookup"));
+    ASSERT_TRUE(ShouldLog("getattr"));
+    ASSERT_FALSE(ShouldLog("look"));
+
+    // CASE 2: the filter is disabled by empty list
+    google::SetCommandLineOption("access_log_ops", "");
+    ASSERT_TRUE(waitFilter("mkdir", true));
+
+    // CASE 3: logs of exited threads are all written, their rings are
+    //         drained for the last time after the threads exit
+    constexpr int kThreads = 8;
+    constexpr int kLogs = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < kLogs; i++) {
+                std::string name = "f" + std::to_string(i);
+                AccessLogGuard log("lookup", [&](AccessLogRecord* record) {
+                    record->Encode("lookup (%d,%s): %s", t, name,
+                                   LogCode(Code::kNotExist));
+                });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // the threads have exited, the writer still drains their rings
+    std::vector<std::string> lines;
+    for (int i = 0; i < 500; i++) {
+        Logger->flush();
+        lines = ReadLogs(dir);
+        if (CountLogs(lines, ": not exist <") == kThreads * kLogs) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(kThreads * kLogs, CountLogs(lines, ": not exist <"));
+    for (int t = 0; t < kThreads; t++) {
+        std::string pattern = "lookup (" + std::to_string(t) + ",f999): ";
+        ASSERT_EQ(1, CountLogs(lines, pattern));
+    }
+
+    // CASE 4: pending logs are written by shutdown
+    {
+        AccessLogGuard log("mkdir", [](AccessLogRecord* record) {
+            record->Encode("mkdir (%d,%s): %s", 1, "dir", LogCode(Code::kOK));
+        });
+    }
+    ShutdownAccessLog();
+    lines = ReadLogs(dir);
+    ASSERT_EQ(1, CountLogs(lines, "mkdir (1,dir): OK <"));
+    ASSERT_EQ(0, std::system(("rm -rf " + dir).c_str()));
+}
+
+}  // namespace logger
+}  // namespace client
+}  // namespace curvefs
@@ -70,6 +70,7 @@ class MockDiskCacheManager2 : public DiskCacheManager {
     MOCK_METHOD3(WriteReadDirect, int(const std::string fileName,
                                       const char *buf, uint64_t length));
     MOCK_METHOD1(IsCached, bool(const std::string));
+    MOCK_METHOD1(Touch, void(const std::string &));
 };
 
 class MockDiskCacheManagerImpl : public DiskCacheManagerImpl {
@@ -85,6 +86,7 @@ class MockDiskCacheManagerImpl : public DiskCacheManagerImpl {
     MOCK_METHOD1(UploadWriteCacheByInode, int(const std::string& inode));
     MOCK_METHOD1(ClearReadCache, int(const std::list<std::string>& files));
     MOCK_METHOD1(IsCached, bool(const std::string));
+    MOCK_METHOD1(Touch, void(const std::string &));
     MOCK_METHOD0(UmountDiskCache, int());
     MOCK_METHOD3(WriteReadDirect, int(const std::string fileName,
                                       const char* buf, uint64_t length));
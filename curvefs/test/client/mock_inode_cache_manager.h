@@ -71,6 +71,8 @@ class MockInodeCacheManager : public InodeCacheManager {
 
     MOCK_METHOD1(ShipToFlush, void(
         const std::shared_ptr<InodeWrapper> &inodeWrapper));
+
+    MOCK_METHOD1(SyncPending, void(bool force));
 };
 
 }  // namespace client
@@ -71,6 +71,12 @@ class MockMetaServerClient : public MetaServerClient {
     MOCK_METHOD1(PrepareRenameTx,
                  MetaStatusCode(const std::vector<Dentry>& dentrys));
 
+    MOCK_METHOD3(IsSameCopyset, bool(uint32_t fsId, uint64_t inodeId,
+                                     uint64_t otherInodeId));
+
+    MOCK_METHOD2(RenameDentry, MetaStatusCode(const Dentry& srcDentry,
+                                              const Dentry& dstDentry));
+
     MOCK_METHOD4(GetInode, MetaStatusCode(
             uint32_t fsId, uint64_t inodeid, Inode *out, bool* streaming));
 
@@ -119,6 +125,14 @@ class MockMetaServerClient : public MetaServerClient {
                       MetaServerClientDone* done,
                       DataIndices));
 
+    void BatchUpdateInodeWithOutNlinkAsync(
+        uint32_t fsId, std::vector<InodeUpdate>&& updates) override {
+        return BatchUpdateInodeWithOutNlinkAsync_rvr(fsId, std::move(updates));
+    }
+
+    MOCK_METHOD2(BatchUpdateInodeWithOutNlinkAsync_rvr,
+                 void(uint32_t, std::vector<InodeUpdate>));
+
     MOCK_METHOD2(UpdateXattrAsync, void(const Inode &inode,
         MetaServerClientDone *done));
 
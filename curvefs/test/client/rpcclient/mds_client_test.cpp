@@ -847,7 +847,8 @@ TEST_F(MdsClientImplTest, RefreshSession) {
         EXPECT_CALL(mockmdsbasecli_, RefreshSession(_, _, _, _))
             .WillOnce(SetArgPointee<1>(response));
         ASSERT_FALSE(mdsclient_.RefreshSession(txIds, &out,
-                                fsName, mountpoint, enableSumInDir));
+                                fsName, mountpoint, enableSumInDir,
+                                nullptr, nullptr));
         ASSERT_TRUE(out.empty());
     }
 
@@ -858,7 +859,8 @@ TEST_F(MdsClientImplTest, RefreshSession) {
         EXPECT_CALL(mockmdsbasecli_, RefreshSession(_, _, _, _))
             .WillOnce(SetArgPointee<1>(response));
         ASSERT_FALSE(mdsclient_.RefreshSession(txIds, &out,
-                            fsName, mountpoint, enableSumInDir));
+                            fsName, mountpoint, enableSumInDir,
+                            nullptr, nullptr));
         ASSERT_EQ(1, out.size());
         ASSERT_TRUE(
             google::protobuf::util::MessageDifferencer::Equals(out[0], tmp))
@@ -875,7 +877,7 @@ TEST_F(MdsClientImplTest, RefreshSession) {
             .WillRepeatedly(Invoke(RefreshSessionRpcFailed));
         ASSERT_EQ(FSStatusCode::RPC_ERROR,
             mdsclient_.RefreshSession(txIds, &out, fsName, mountpoint,
-            enableSumInDir));
+            enableSumInDir, nullptr, nullptr));
     }
 }
 
@@ -341,6 +341,77 @@ TEST_F(MetaCacheTest, test_GetPartitionIdByInodeId) {
     ASSERT_EQ(pid, 1);
 }
 
+TEST_F(MetaCacheTest, test_GetTargetWithManyPartitions) {
+    // partitions are listed out of order, each covers 100 inodes
+    const uint64_t kPartitionNum = 1000;
+    MetaCache::PartitionInfoList pInfoList;
+    for (uint64_t i = kPartitionNum; i > 0; i--) {
+        PartitionInfo pInfo;
+        pInfo.set_fsid(1);
+        pInfo.set_poolid(1);
+        pInfo.set_copysetid(1);
+        pInfo.set_partitionid(i);
+        pInfo.set_start((i - 1) * 100);
+        pInfo.set_end(i * 100 - 1);
+        pInfo.set_txid(i);
+        pInfoList.emplace_back(pInfo);
+    }
+
+    std::vector<CopysetInfo<MetaserverID>> metaServerInfos;
+    metaServerInfos.push_back(metaServerList_);
+    EXPECT_CALL(*mockMdsClient_.get(), ListPartition(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(pInfoList), Return(true)));
+    EXPECT_CALL(*mockMdsClient_.get(), GetCopysetOfPartitions(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copysetMap_), Return(true)));
+    EXPECT_CALL(*mockMdsClient_.get(), GetMetaServerListInCopysets(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(metaServerInfos), Return(true)));
+
+    // served by the partition index and cached leader after listed once
+    CopysetTarget target;
+    for (uint64_t inodeID : {0, 99, 100, 12345, 99999}) {
+        ASSERT_TRUE(metaCache_.GetTarget(1, inodeID, &target));
+        expect.partitionID = inodeID / 100 + 1;
+        expect.txId = expect.partitionID;
+        ASSERT_TRUE(CopysetTargetEQ(target, expect));
+    }
+
+    // txid updated is visible to lookup
+    metaCache_.SetTxId(124, 1000);
+    ASSERT_TRUE(metaCache_.GetTarget(1, 12345, &target));
+    ASSERT_EQ(target.txId, 1000);
+    uint32_t partitionId = 0;
+    uint64_t txId = 0;
+    ASSERT_TRUE(metaCache_.GetTxId(1, 12345, &partitionId, &txId));
+    ASSERT_EQ(partitionId, 124);
+    ASSERT_EQ(txId, 1000);
+    ASSERT_FALSE(metaCache_.GetTxId(2, 12345, &partitionId, &txId));
+
+    PartitionID pid = 0;
+    ASSERT_TRUE(metaCache_.GetPartitionIdByInodeId(1, 500, &pid));
+    ASSERT_EQ(pid, 6);
+
+    // leader updated is visible to lookup
+    metaServerList_.UpdateLeaderIndex(1);
+    metaCache_.UpdateCopysetInfo(CopysetGroupID(1, 1), metaServerList_);
+    ASSERT_TRUE(metaCache_.GetTarget(1, 0, &target));
+    ASSERT_EQ(target.metaServerID, 2);
+    ASSERT_EQ(target.endPoint.port, 9121);
+
+    // leader may change, refresh it from metaserver
+    curve::client::PeerAddr pd;
+    pd.Parse("127.0.0.1:9120:0");
+    metaServerList_.SetLeaderUnstableFlag();
+    metaCache_.UpdateCopysetInfo(CopysetGroupID(1, 1), metaServerList_);
+    EXPECT_CALL(*mockCli2Client_.get(), GetLeader(_, _, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(pd), Return(true)));
+    ASSERT_TRUE(metaCache_.GetTarget(1, 0, &target));
+    expect.partitionID = 1;
+    expect.txId = 1;
+    ASSERT_TRUE(CopysetTargetEQ(target, expect));
+    ASSERT_TRUE(metaCache_.GetTarget(1, 0, &target));
+    ASSERT_TRUE(CopysetTargetEQ(target, expect));
+}
+
 }  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
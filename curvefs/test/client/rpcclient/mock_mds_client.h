@@ -106,12 +106,14 @@ class MockMdsClient : public MdsClient {
                  bool(uint32_t fsID,
                       std::vector<PartitionInfo>* partitionInfos));
 
-    MOCK_METHOD5(RefreshSession,
+    MOCK_METHOD7(RefreshSession,
                  FSStatusCode(const std::vector<PartitionTxId> &txIds,
                               std::vector<PartitionTxId> *latestTxIdList,
                               const std::string& fsName,
                               const Mountpoint& mountpoint,
-                              std::atomic<bool>* enableSumInDir));
+                              std::atomic<bool>* enableSumInDir,
+                              const MetaLeaseRequest* leaseRequest,
+                              MetaLeaseResponse* leaseResponse));
 
     MOCK_METHOD4(AllocateVolumeBlockGroup,
                  SpaceErrCode(uint32_t,
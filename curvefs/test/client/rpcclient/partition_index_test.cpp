@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/client/rpcclient/partition_index.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace curvefs {
+namespace client {
+namespace rpcclient {
+
+namespace {
+
+std::shared_ptr<PartitionRoute> GenRoute(PartitionID partitionID,
+                                         uint64_t start, uint64_t end) {
+    auto route = std::make_shared<PartitionRoute>();
+    route->partitionID = partitionID;
+    route->start = start;
+    route->end = end;
+    route->leader = std::make_shared<LeaderCache>();
+    return route;
+}
+
+}  // namespace
+
+TEST(PartitionIndexTest, Find) {
+    PartitionIndex empty;
+    ASSERT_EQ(empty.Find(1), nullptr);
+
+    // [10, 19], [20, 29], hole, [100, 199]
+    PartitionIndex index(
+        {GenRoute(3, 100, 199), GenRoute(1, 10, 19), GenRoute(2, 20, 29)});
+    ASSERT_EQ(index.Size(), 3);
+
+    ASSERT_EQ(index.Find(0), nullptr);
+    ASSERT_EQ(index.Find(9), nullptr);
+    ASSERT_EQ(index.Find(10)->partitionID, 1);
+    ASSERT_EQ(index.Find(19)->partitionID, 1);
+    ASSERT_EQ(index.Find(20)->partitionID, 2);
+    ASSERT_EQ(index.Find(29)->partitionID, 2);
+    ASSERT_EQ(index.Find(30), nullptr);
+    ASSERT_EQ(index.Find(99), nullptr);
+    ASSERT_EQ(index.Find(100)->partitionID, 3);
+    ASSERT_EQ(index.Find(199)->partitionID, 3);
+    ASSERT_EQ(index.Find(200), nullptr);
+    ASSERT_EQ(index.Find(UINT64_MAX), nullptr);
+}
+
+TEST(PartitionIndexTest, LeaderCache) {
+    LeaderCache leader;
+    MetaserverID metaServerID = 0;
+    butil::EndPoint endPoint;
+    ASSERT_FALSE(leader.Get(&metaServerID, &endPoint));
+
+    butil::EndPoint expect;
+    ASSERT_EQ(0, butil::str2endpoint("127.0.0.1", 9120, &expect));
+    leader.Set(1, expect);
+    ASSERT_TRUE(leader.Get(&metaServerID, &endPoint));
+    ASSERT_EQ(metaServerID, 1);
+    ASSERT_EQ(endPoint, expect);
+
+    leader.Invalidate();
+    ASSERT_FALSE(leader.Get(&metaServerID, &endPoint));
+}
+
+}  // namespace rpcclient
+}  // namespace client
+}  // namespace curvefs
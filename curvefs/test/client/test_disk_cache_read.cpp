@@ -111,6 +111,44 @@ TEST_F(TestDiskCacheRead, ReadDiskFile) {
     ASSERT_EQ(length, ret);
 }
 
+TEST_F(TestDiskCacheRead, OpenDiskFile) {
+    std::string fileName = "test";
+    uint64_t length = 10;
+    int fd = -1;
+
+    // open failed
+    EXPECT_CALL(*wrapper_, open(_, _, _)).WillOnce(Return(-1));
+    int ret = diskCacheRead_->OpenDiskFile(fileName, length, length, &fd);
+    ASSERT_EQ(-1, ret);
+
+    // fstat failed
+    EXPECT_CALL(*wrapper_, open(_, _, _)).WillOnce(Return(3));
+    EXPECT_CALL(*wrapper_, fstat(3, _)).WillOnce(Return(-1));
+    EXPECT_CALL(*wrapper_, close(3)).WillOnce(Return(0));
+    ret = diskCacheRead_->OpenDiskFile(fileName, length, length, &fd);
+    ASSERT_EQ(-1, ret);
+
+    // file is too small
+    struct stat statFile;
+    statFile.st_size = 2 * length - 1;
+    EXPECT_CALL(*wrapper_, open(_, _, _)).WillOnce(Return(3));
+    EXPECT_CALL(*wrapper_, fstat(3, _))
+        .WillOnce(DoAll(SetArgPointee<1>(statFile), Return(0)));
+    EXPECT_CALL(*wrapper_, close(3)).WillOnce(Return(0));
+    ret = diskCacheRead_->OpenDiskFile(fileName, length, length, &fd);
+    ASSERT_EQ(-1, ret);
+
+    // success, fd is owned by caller
+    statFile.st_size = 2 * length;
+    EXPECT_CALL(*wrapper_, open(_, _, _)).WillOnce(Return(3));
+    EXPECT_CALL(*wrapper_, fstat(3, _))
+        .WillOnce(DoAll(SetArgPointee<1>(statFile), Return(0)));
+    EXPECT_CALL(*wrapper_, close(_)).Times(0);
+    ret = diskCacheRead_->OpenDiskFile(fileName, length, length, &fd);
+    ASSERT_EQ(0, ret);
+    ASSERT_EQ(3, fd);
+}
+
 TEST_F(TestDiskCacheRead, LinkWriteToRead) {
     EXPECT_CALL(*wrapper_, stat(NotNull(), NotNull())).WillOnce(Return(-1));
     std::string fileName = "test";
@@ -24,9 +24,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/common/common.h"
@@ -47,6 +54,7 @@
 #include "curvefs/test/client/mock_metaserver_client.h"
 #include "curvefs/test/client/rpcclient/mock_mds_client.h"
 #include "fuse3/fuse_lowlevel.h"
+#include "src/common/concurrent/count_down_event.h"
 
 struct fuse_req {
     struct fuse_ctx* ctx;
@@ -73,6 +81,7 @@ namespace curvefs {
 namespace client {
 
 using ::curve::common::Configuration;
+using ::curve::common::CountDownEvent;
 using ::curvefs::mds::topology::PartitionTxId;
 using ::testing::_;
 using ::testing::AtLeast;
@@ -129,6 +138,73 @@ class WarmupManagerS3Test : public warmup::WarmupManagerS3Impl {
         return warmup::WarmupManagerS3Impl::FetchDentry(key, ino, file,
                                                         symlink_depth);
     }
+
+    using warmup::WarmupManagerS3Impl::FetchDataEnqueue;
+    using warmup::WarmupManagerS3Impl::ScanCleanFetchS3ObjectsPool;
+    using warmup::WarmupManagerS3Impl::ScanCleanWarmupProgress;
+    using warmup::WarmupManagerS3Impl::WarmUpAllObjs;
+
+    // start the stages without the background thread,
+    // so the tests scan and clean them by themselves
+    void InitWithoutBackground(const FuseClientOption& option) {
+        option_ = option;
+        bgFetchStop_.store(false, std::memory_order_release);
+    }
+
+    void AddProgress(fuse_ino_t key, warmup::WarmupStorageType type) {
+        curve::common::WriteLockGuard lock(inode2ProgressMutex_);
+        AddWarmupProcessLocked(key, "/warmup", type);
+    }
+
+    int64_t GetPending(fuse_ino_t key) {
+        warmup::WarmupProgress progress;
+        if (!QueryWarmupProgress(key, &progress)) {
+            return -1;
+        }
+        return progress.GetPending();
+    }
+};
+
+// Download objects by hand, the contexts are held until
+// they are completed by tests.
+class ManualS3Client : public MockS3Client {
+ public:
+    ManualS3Client() {
+        ON_CALL(*this, DownloadAsync(_))
+            .WillByDefault(
+                Invoke([this](std::shared_ptr<GetObjectAsyncContext> context) {
+                    std::lock_guard<std::mutex> lk(mutex_);
+                    contexts_.push_back(std::move(context));
+                    cond_.notify_all();
+                }));
+    }
+
+    // wait until |count| downloads have been issued in total
+    void WaitIssued(size_t count) {
+        std::unique_lock<std::mutex> lk(mutex_);
+        cond_.wait(lk, [&]() { return contexts_.size() >= count; });
+    }
+
+    size_t Issued() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return contexts_.size();
+    }
+
+    std::shared_ptr<GetObjectAsyncContext> Context(size_t index) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return contexts_[index];
+    }
+
+    void Complete(size_t index, int retCode = 0) {
+        auto context = Context(index);
+        context->retCode = retCode;
+        context->cb(nullptr, context);
+    }
+
+ private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<std::shared_ptr<GetObjectAsyncContext>> contexts_;
 };
 
 class TestFuseS3Client : public ::testing::Test {
@@ -3136,6 +3212,147 @@ TEST_F(TestFuseS3Client,
               false);
 }
 
+TEST_F(TestFuseS3Client, warmUp_FetchDataEnqueue_pending) {
+    constexpr fuse_ino_t key = 10;
+    constexpr fuse_ino_t ino = 11;
+    auto warmupManager = std::make_shared<WarmupManagerS3Test>(
+        metaClient_, inodeManager_, dentryManager_, nullptr, nullptr, nullptr,
+        nullptr, s3ClientAdaptor_);
+    warmupManager->InitWithoutBackground(fuseClientOption_);
+    warmupManager->AddProgress(
+        key, curvefs::client::common::WarmupStorageType::
+                 kWarmupStorageTypeKvClient);
+
+    // the fetch is pending before it runs, so the progress
+    // survives the scans even if the pool has been cleaned
+    CountDownEvent started(1);
+    CountDownEvent release(1);
+    EXPECT_CALL(*inodeManager_, GetInode(ino, _))
+        .WillOnce(Invoke([&](uint64_t, std::shared_ptr<InodeWrapper>&) {
+            started.Signal();
+            release.Wait();
+            return CURVEFS_ERROR::NOT_EXIST;
+        }));
+    warmupManager->FetchDataEnqueue(key, ino);
+    ASSERT_EQ(1, warmupManager->GetPending(key));
+    started.Wait();
+    warmupManager->ScanCleanFetchS3ObjectsPool();
+    warmupManager->ScanCleanWarmupProgress();
+    ASSERT_EQ(1, warmupManager->GetPending(key));
+
+    // the progress is done once the fetch is finished
+    release.Signal();
+    for (int i = 0; i < 1000 && warmupManager->GetPending(key) != -1; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        warmupManager->ScanCleanFetchS3ObjectsPool();
+        warmupManager->ScanCleanWarmupProgress();
+    }
+    ASSERT_EQ(-1, warmupManager->GetPending(key));
+
+    warmupManager->UnInit();
+}
+
+TEST_F(TestFuseS3Client, warmUp_WarmUpAllObjs_inflightLimit) {
+    constexpr fuse_ino_t key = 10;
+    auto s3Client = std::make_shared<ManualS3Client>();
+    EXPECT_CALL(*s3ClientAdaptor_, GetS3Client())
+        .WillRepeatedly(Return(s3Client));
+    auto warmupManager = std::make_shared<WarmupManagerS3Test>(
+        metaClient_, inodeManager_, dentryManager_, nullptr, nullptr, nullptr,
+        nullptr, s3ClientAdaptor_);
+    auto option = fuseClientOption_;
+    option.warmupMaxInflightObjects = 2;
+    warmupManager->InitWithoutBackground(option);
+    warmupManager->AddProgress(
+        key, curvefs::client::common::WarmupStorageType::
+                 kWarmupStorageTypeKvClient);
+
+    std::list<std::pair<std::string, uint64_t>> objs;
+    for (int i = 0; i < 4; i++) {
+        objs.emplace_back("obj_" + std::to_string(i), 1024);
+    }
+    std::thread issuer([&]() { warmupManager->WarmUpAllObjs(key, objs); });
+
+    // only 2 objects are downloading at the same time,
+    // the one waiting for a free slot is pending too
+    s3Client->WaitIssued(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(2, s3Client->Issued());
+    ASSERT_EQ(3, warmupManager->GetPending(key));
+
+    s3Client->Complete(0);
+    s3Client->WaitIssued(3);
+    s3Client->Complete(1);
+    s3Client->WaitIssued(4);
+    issuer.join();
+    s3Client->Complete(2);
+    s3Client->Complete(3);
+
+    warmup::WarmupProgress progress;
+    ASSERT_TRUE(warmupManager->QueryWarmupProgress(key, &progress));
+    ASSERT_EQ(0, progress.GetPending());
+    ASSERT_EQ(4, progress.GetFinished());
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_EQ(nullptr, s3Client->Context(i)->buf);
+    }
+
+    warmupManager->UnInit();
+}
+
+TEST_F(TestFuseS3Client, warmUp_cancel_freeBuffer) {
+    constexpr fuse_ino_t key = 10;
+    auto s3Client = std::make_shared<ManualS3Client>();
+    EXPECT_CALL(*s3ClientAdaptor_, GetS3Client())
+        .WillRepeatedly(Return(s3Client));
+    auto warmupManager = std::make_shared<WarmupManagerS3Test>(
+        metaClient_, inodeManager_, dentryManager_, nullptr, nullptr, nullptr,
+        nullptr, s3ClientAdaptor_);
+    warmupManager->InitWithoutBackground(fuseClientOption_);
+    warmupManager->SetMounted(true);
+    warmupManager->AddProgress(
+        key, curvefs::client::common::WarmupStorageType::
+                 kWarmupStorageTypeKvClient);
+
+    warmupManager->WarmUpAllObjs(key, {{"obj_0", 1024}});
+    ASSERT_EQ(1, s3Client->Issued());
+    ASSERT_NE(nullptr, s3Client->Context(0)->buf);
+
+    // the object downloaded after the task is canceled is dropped
+    ASSERT_TRUE(warmupManager->CancelWarmupFileOrFilelist(key));
+    s3Client->Complete(0);
+    ASSERT_EQ(nullptr, s3Client->Context(0)->buf);
+    ASSERT_EQ(-1, warmupManager->GetPending(key));
+
+    warmupManager->UnInit();
+}
+
+TEST_F(TestFuseS3Client, warmUp_UnInit_waitCallback) {
+    constexpr fuse_ino_t key = 10;
+    auto s3Client = std::make_shared<ManualS3Client>();
+    EXPECT_CALL(*s3ClientAdaptor_, GetS3Client())
+        .WillRepeatedly(Return(s3Client));
+    auto warmupManager = std::make_shared<WarmupManagerS3Test>(
+        metaClient_, inodeManager_, dentryManager_, nullptr, nullptr, nullptr,
+        nullptr, s3ClientAdaptor_);
+    warmupManager->InitWithoutBackground(fuseClientOption_);
+    warmupManager->AddProgress(
+        key, curvefs::client::common::WarmupStorageType::
+                 kWarmupStorageTypeKvClient);
+
+    warmupManager->WarmUpAllObjs(key, {{"obj_0", 1024}});
+    ASSERT_EQ(1, s3Client->Issued());
+
+    // the callback refers to the manager, so UnInit waits for it
+    auto uninit = std::async(std::launch::async,
+                             [&]() { warmupManager->UnInit(); });
+    ASSERT_EQ(std::future_status::timeout,
+              uninit.wait_for(std::chrono::milliseconds(100)));
+
+    s3Client->Complete(0);
+    uninit.get();
+    ASSERT_EQ(nullptr, s3Client->Context(0)->buf);
+}
+
 TEST_F(TestFuseS3Client, FuseInit_when_fs_exist) {
     MountOption mOpts;
     memset(&mOpts, 0, sizeof(mOpts));
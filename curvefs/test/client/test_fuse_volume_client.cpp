@@ -181,6 +181,14 @@ class TestFuseVolumeClient : public ::testing::Test {
     static const uint32_t TX_PREPARE = DentryFlag::TRANSACTION_PREPARE_FLAG;
 };
 
+class TestFuseVolumeClientRenameInCopyset : public TestFuseVolumeClient {
+ protected:
+    void SetUp() override {
+        fuseClientOption_.enableRenameInCopyset = true;
+        TestFuseVolumeClient::SetUp();
+    }
+};
+
 TEST_F(TestFuseVolumeClient, FuseOpInit_when_fs_exist) {
     MountOption mOpts;
     memset(&mOpts, 0, sizeof(mOpts));
@@ -947,6 +955,110 @@ TEST_F(TestFuseVolumeClient, FuseOpRenameBasic) {
     ASSERT_EQ(rc, CURVEFS_ERROR::OK);
 }
 
+TEST_F(TestFuseVolumeClientRenameInCopyset, FuseOpRenameBasic) {
+    fuse_req_t req = nullptr;
+    fuse_ino_t parent = 1;
+    std::string name = "A";
+    fuse_ino_t newparent = 3;
+    std::string newname = "B";
+    unsigned int flags = 0;
+    uint64_t inodeId = 1000;
+    uint32_t srcPartitionId = 1;
+    uint32_t dstPartitionId = 2;
+    uint64_t srcTxId = 0;
+    uint64_t dstTxId = 2;
+
+    // step1: get txid
+    EXPECT_CALL(*metaClient_, GetTxId(fsId, parent, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(srcPartitionId),
+                        SetArgPointee<3>(srcTxId), Return(MetaStatusCode::OK)));
+    EXPECT_CALL(*metaClient_, GetTxId(fsId, newparent, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(dstPartitionId),
+                        SetArgPointee<3>(dstTxId), Return(MetaStatusCode::OK)));
+
+    // step2: link dest parent inode
+    Inode destParentInode;
+    destParentInode.set_inodeid(newparent);
+    destParentInode.set_nlink(2);
+    InodeAttr dattr;
+    dattr.set_inodeid(newparent);
+    dattr.set_nlink(2);
+    auto inodeWrapper =
+        std::make_shared<InodeWrapper>(destParentInode, metaClient_);
+    EXPECT_CALL(*inodeManager_, GetInode(newparent, _))
+        .WillOnce(DoAll(SetArgReferee<1>(inodeWrapper),
+                  Return(CURVEFS_ERROR::OK)));
+    EXPECT_CALL(*metaClient_, GetInodeAttr(_, newparent, _))
+        .WillOnce(DoAll(SetArgPointee<2>(dattr), Return(MetaStatusCode::OK)));
+    // include below unlink operate and update inode parent
+    EXPECT_CALL(*metaClient_, UpdateInodeAttr(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(MetaStatusCode::OK));
+
+    // step3: precheck
+    // dentry = { fsid, parentid, name, txid, inodeid, DELETE }
+    auto dentry = GenDentry(fsId, parent, name, srcTxId, inodeId, 0);
+    dentry.set_type(FsFileType::TYPE_DIRECTORY);
+    EXPECT_CALL(*dentryManager_, GetDentry(parent, name, _))
+        .WillOnce(DoAll(SetArgPointee<2>(dentry), Return(CURVEFS_ERROR::OK)));
+    EXPECT_CALL(*dentryManager_, GetDentry(newparent, newname, _))
+        .WillOnce(Return(CURVEFS_ERROR::NOT_EXIST));
+
+    // step4: rename in copyset
+    EXPECT_CALL(*metaClient_, IsSameCopyset(fsId, parent, newparent))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*metaClient_, RenameDentry(_, _))
+        .WillOnce(Invoke([&](const Dentry& src, const Dentry& dst) {
+            auto srcDentry = GenDentry(fsId, parent, name, srcTxId, inodeId, 0);
+            srcDentry.set_type(FsFileType::TYPE_DIRECTORY);
+            auto dstDentry =
+                GenDentry(fsId, newparent, newname, srcTxId, inodeId, 0);
+            dstDentry.set_type(FsFileType::TYPE_DIRECTORY);
+            if (src == srcDentry && dst == dstDentry) {
+                return MetaStatusCode::OK;
+            }
+            return MetaStatusCode::UNKNOWN_ERROR;
+        }));
+
+    // step5: no transaction
+    EXPECT_CALL(*metaClient_, PrepareRenameTx(_)).Times(0);
+    EXPECT_CALL(*mdsClient_, CommitTx(_)).Times(0);
+
+    // step6: unlink source parent inode
+    Inode srcParentInode;
+    srcParentInode.set_inodeid(parent);
+    srcParentInode.set_nlink(3);
+    InodeAttr sattr;
+    sattr.set_inodeid(parent);
+    sattr.set_nlink(3);
+    EXPECT_CALL(*metaClient_, GetInodeAttr(_, parent, _))
+        .WillOnce(DoAll(SetArgPointee<2>(sattr), Return(MetaStatusCode::OK)));
+    inodeWrapper = std::make_shared<InodeWrapper>(srcParentInode, metaClient_);
+    EXPECT_CALL(*inodeManager_, GetInode(parent, _))
+        .WillOnce(DoAll(SetArgReferee<1>(inodeWrapper),
+                  Return(CURVEFS_ERROR::OK)));
+
+    // step7: update inode parent and ctime
+    Inode InodeInfo;
+    InodeInfo.set_inodeid(inodeId);
+    InodeInfo.add_parent(parent);
+    inodeWrapper = std::make_shared<InodeWrapper>(InodeInfo, metaClient_);
+    EXPECT_CALL(*inodeManager_, GetInode(inodeId, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgReferee<1>(inodeWrapper),
+                  Return(CURVEFS_ERROR::OK)));
+    EXPECT_CALL(*metaClient_, UpdateInodeAttrWithOutNlink(_, inodeId, _, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(MetaStatusCode::OK));
+
+    // step8: txid unchanged
+    EXPECT_CALL(*metaClient_, SetTxId(_, _)).Times(0);
+
+    auto rc = client_->FuseOpRename(req, parent, name.c_str(), newparent,
+                                    newname.c_str(), flags);
+    ASSERT_EQ(rc, CURVEFS_ERROR::OK);
+}
+
 TEST_F(TestFuseVolumeClient, FuseOpRenameOverwrite) {
     fuse_req_t req = nullptr;
     fuse_ino_t parent = 1;
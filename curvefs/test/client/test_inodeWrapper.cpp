@@ -299,6 +299,44 @@ TEST_F(TestInodeWrapper, TestAsyncInode) {
     }
 }
 
+TEST_F(TestInodeWrapper, TestAsyncBatch) {
+    std::vector<std::shared_ptr<InodeWrapper>> inodes;
+    for (uint64_t ino : {1, 2, 3}) {
+        Inode inode;
+        inode.set_inodeid(ino);
+        auto wrapper = std::make_shared<InodeWrapper>(inode, metaClient_);
+        wrapper->SetType(ino == 3 ? FsFileType::TYPE_DIRECTORY
+                                  : FsFileType::TYPE_S3);
+        inodes.emplace_back(wrapper);
+    }
+    // inode 2 has nothing to sync, callback should be invoked directly
+    inodes[1]->ClearDirty();
+
+    EXPECT_CALL(*metaClient_, BatchUpdateInodeWithOutNlinkAsync_rvr(_, _))
+        .WillOnce(Invoke([](uint32_t, std::vector<InodeUpdate> updates) {
+            ASSERT_EQ(2, updates.size());
+            ASSERT_EQ(1, updates[0].inodeId);
+            ASSERT_EQ(3, updates[1].inodeId);
+            for (auto& update : updates) {
+                update.done->SetMetaStatusCode(MetaStatusCode::OK);
+                update.done->Run();
+            }
+        }));
+
+    FakeCallback done1;
+    FakeCallback done2;
+    FakeCallback done3;
+    InodeWrapper::AsyncBatch(inodes, {&done1, &done2, &done3});
+    done1.Wait();
+    done2.Wait();
+    done3.Wait();
+    ASSERT_EQ(MetaStatusCode::OK, done1.GetStatusCode());
+    ASSERT_EQ(MetaStatusCode::OK, done2.GetStatusCode());
+    ASSERT_EQ(MetaStatusCode::OK, done3.GetStatusCode());
+    ASSERT_FALSE(inodes[0]->IsDirty());
+    ASSERT_FALSE(inodes[2]->IsDirty());
+}
+
 TEST_F(TestInodeWrapper, TestUpdateInodeAttrIncrementally) {
     Inode inode;
     inode.set_type(FsFileType::TYPE_S3);
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "curvefs/src/client/volume/extent_cache.h"
+#include "curvefs/test/client/volume/common.h"
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+class Stopwatch {
+ public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+    double ElapsedUs() const {
+        return std::chrono::duration<double, std::micro>(
+                   std::chrono::steady_clock::now() - start_)
+            .count();
+    }
+
+ private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+void Report(const char* name, uint64_t ops, double us) {
+    std::cout << name << ": " << ops << " ops, " << us / ops << " us/op"
+              << std::endl;
+}
+
+// Fill `extents` with `count` adjacent extents, insert and look up
+// random ones and walk all of them, which is what ExtentSlice does on
+// write, read and GetDirtyExtents respectively.
+template <typename Map>
+void BenchContainer(const char* name, uint64_t count, uint64_t ops) {
+    Map extents;
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<uint64_t> dist(0, count * 2 - 1);
+
+    for (uint64_t i = 0; i < count; ++i) {
+        extents.emplace_hint(extents.end(), i * 2 * kKiB,
+                             PExtent{kKiB, i * kKiB, false});
+    }
+
+    Stopwatch insertWatch;
+    for (uint64_t i = 0; i < ops; ++i) {
+        const uint64_t off = dist(rng) * kKiB;
+        auto it = extents.lower_bound(off);
+        if (it != extents.end() && it->first == off) {
+            it->second.UnWritten = false;
+        } else {
+            extents.emplace_hint(it, off, PExtent{kKiB, off, true});
+        }
+    }
+    std::cout << name << " ";
+    Report("insert", ops, insertWatch.ElapsedUs());
+
+    Stopwatch lookupWatch;
+    uint64_t found = 0;
+    for (uint64_t i = 0; i < ops; ++i) {
+        auto it = extents.upper_bound(dist(rng) * kKiB);
+        found += (it != extents.begin());
+    }
+    std::cout << name << " ";
+    Report("lookup", ops, lookupWatch.ElapsedUs());
+
+    Stopwatch walkWatch;
+    uint64_t len = 0;
+    for (const auto& ext : extents) {
+        len += ext.second.len;
+    }
+    std::cout << name << " ";
+    Report("walk", 1, walkWatch.ElapsedUs());
+
+    ASSERT_GT(found, 0);
+    ASSERT_GT(len, 0);
+}
+
+}  // namespace
+
+// Compares the container ExtentSlice is built on with the std::map it
+// replaced, run with
+// `--gtest_also_run_disabled_tests --gtest_filter=*Container*`.
+TEST(ExtentCachePerfTest, DISABLED_Container) {
+    constexpr uint64_t kExtents = 1000000;
+    constexpr uint64_t kOps = 1000000;
+
+    BenchContainer<std::map<uint64_t, PExtent>>("std::map", kExtents, kOps);
+    BenchContainer<absl::btree_map<uint64_t, PExtent>>("absl::btree_map",
+                                                       kExtents, kOps);
+}
+
+// Microbenchmark of random small writes into a large, heavily fragmented
+// file, run with `--gtest_also_run_disabled_tests`.
+TEST(ExtentCachePerfTest, DISABLED_RandomWrite) {
+    constexpr uint64_t kFileSize = 100 * kGiB;
+    constexpr uint64_t kIoSize = 4 * kKiB;
+    constexpr uint64_t kWrites = 1000000;
+    constexpr uint64_t kReads = 1000000;
+    constexpr uint64_t kFlushInterval = 10000;
+
+    ExtentCacheOption option;
+    ExtentCache::SetOption(option);
+
+    ExtentCache cache;
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<uint64_t> dist(0,
+                                                 kFileSize / kIoSize - 1);
+    std::vector<char> data(kIoSize);
+
+    // physical space is allocated sequentially, so logically adjacent
+    // extents are hardly ever physically continuous
+    uint64_t nextPhysical = 0;
+    uint64_t flushed = 0;
+    uint64_t flushes = 0;
+    double flushUs = 0;
+
+    Stopwatch writeWatch;
+    for (uint64_t i = 0; i < kWrites; ++i) {
+        const uint64_t offset = dist(rng) * kIoSize;
+
+        std::vector<WritePart> allocated;
+        std::vector<AllocPart> needAlloc;
+        cache.DivideForWrite(offset, kIoSize, data.data(), &allocated,
+                             &needAlloc);
+
+        for (const auto& part : needAlloc) {
+            cache.Merge(part.allocInfo.lOffset,
+                        PExtent{part.allocInfo.len, nextPhysical, true});
+            nextPhysical += part.allocInfo.len;
+        }
+
+        cache.MarkWritten(offset, kIoSize);
+
+        if ((i + 1) % kFlushInterval == 0) {
+            Stopwatch flushWatch;
+            flushed += cache.GetDirtyExtents().slices_size();
+            flushUs += flushWatch.ElapsedUs();
+            ++flushes;
+        }
+    }
+    Report("random write", kWrites, writeWatch.ElapsedUs() - flushUs);
+    Report("flush dirty extents", flushes, flushUs);
+
+    Stopwatch readWatch;
+    uint64_t parts = 0;
+    for (uint64_t i = 0; i < kReads; ++i) {
+        std::vector<ReadPart> reads;
+        std::vector<ReadPart> holes;
+        cache.DivideForRead(dist(rng) * kIoSize, 4 * kIoSize, data.data(),
+                            &reads, &holes);
+        parts += reads.size() + holes.size();
+    }
+    Report("random read", kReads, readWatch.ElapsedUs());
+
+    ASSERT_GT(flushed, 0);
+    ASSERT_GT(parts, kReads);
+}
+
+}  // namespace client
+}  // namespace curvefs
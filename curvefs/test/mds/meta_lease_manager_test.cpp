@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/mds/meta_lease_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace curvefs {
+namespace mds {
+
+namespace {
+
+const char* kFsName = "fs";
+const char* kClient1 = "host1:9000:/mnt";
+const char* kClient2 = "host2:9000:/mnt";
+
+std::vector<uint64_t> Granted(const MetaLeaseResponse& response) {
+    return {response.granted().begin(), response.granted().end()};
+}
+
+std::vector<uint64_t> Revoked(const MetaLeaseResponse& response) {
+    std::vector<uint64_t> revoked(response.revoked().begin(),
+                                  response.revoked().end());
+    std::sort(revoked.begin(), revoked.end());
+    return revoked;
+}
+
+}  // namespace
+
+class MetaLeaseManagerTest : public ::testing::Test {
+ protected:
+    void SetUp() override { Init(MetaLeaseOption()); }
+
+    void Init(const MetaLeaseOption& option) {
+        manager_ = std::make_shared<MetaLeaseManager>(option);
+        epochs_.clear();
+    }
+
+    // refresh as |mountpoint| with the epoch it learned last time
+    MetaLeaseResponse Refresh(const std::string& mountpoint,
+                              uint64_t sequence,
+                              std::vector<uint64_t> acquire,
+                              std::vector<uint64_t> modified = {},
+                              std::vector<uint64_t> release = {}) {
+        MetaLeaseRequest request;
+        *request.mutable_acquire() = {acquire.begin(), acquire.end()};
+        *request.mutable_modified() = {modified.begin(), modified.end()};
+        *request.mutable_release() = {release.begin(), release.end()};
+        request.set_epoch(epochs_[mountpoint]);
+        request.set_sequence(sequence);
+
+        MetaLeaseResponse response;
+        manager_->Refresh(kFsName, mountpoint, request, &response);
+        epochs_[mountpoint] = response.epoch();
+        return response;
+    }
+
+ protected:
+    std::shared_ptr<MetaLeaseManager> manager_;
+    std::unordered_map<std::string, uint64_t> epochs_;
+};
+
+TEST_F(MetaLeaseManagerTest, GrantAndRevoke) {
+    // CASE 1: leases can't be granted before the client knows the epoch
+    auto response = Refresh(kClient1, 0, {1});
+    ASSERT_TRUE(Granted(response).empty());
+    ASSERT_GT(response.epoch(), 0);
+    ASSERT_EQ(response.leasetimeus(), MetaLeaseOption().leaseTimeMs * 1000);
+    Refresh(kClient2, 0, {});
+
+    // CASE 2: both clients hold lease of inode 1
+    response = Refresh(kClient1, 0, {1, 2});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1, 2}));
+    response = Refresh(kClient2, 0, {1});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1}));
+    ASSERT_NE(epochs_[kClient1], epochs_[kClient2]);
+
+    // CASE 3: client2 modified inode 1, the lease of client1 is revoked
+    //         at its next refresh
+    response = Refresh(kClient2, 0, {}, {1});
+    ASSERT_TRUE(Revoked(response).empty());
+    ASSERT_EQ(response.sequence(), 1);
+
+    response = Refresh(kClient1, 1, {});
+    ASSERT_EQ(Revoked(response), std::vector<uint64_t>({1}));
+
+    // CASE 4: revoked only once
+    response = Refresh(kClient1, 1, {});
+    ASSERT_TRUE(Revoked(response).empty());
+
+    // CASE 5: the lease of modifier itself is kept
+    response = Refresh(kClient2, 1, {}, {1});
+    ASSERT_TRUE(Revoked(response).empty());
+    response = Refresh(kClient2, 2, {1});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1}));
+}
+
+TEST_F(MetaLeaseManagerTest, DenyStaleAcquire) {
+    Refresh(kClient1, 0, {});
+    auto response = Refresh(kClient2, 0, {}, {1});
+    ASSERT_EQ(response.sequence(), 1);
+
+    // CASE 1: metadata fetched before modification
+    response = Refresh(kClient1, 0, {1, 2});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({2}));
+
+    // CASE 2: metadata fetched after modification
+    response = Refresh(kClient1, 1, {1});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1}));
+
+    // CASE 3: epoch mismatch
+    uint64_t epoch = epochs_[kClient1]--;
+    response = Refresh(kClient1, 1, {3});
+    ASSERT_TRUE(Granted(response).empty());
+    ASSERT_EQ(response.epoch(), epoch);
+}
+
+TEST_F(MetaLeaseManagerTest, Limits) {
+    MetaLeaseOption option;
+    option.maxLeasesPerClient = 2;
+    option.maxModifiedRecords = 1;
+    Init(option);
+    Refresh(kClient1, 0, {});
+    Refresh(kClient2, 0, {});
+
+    // CASE 1: max leases per client
+    auto response = Refresh(kClient1, 0, {1, 2, 3});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1, 2}));
+
+    response = Refresh(kClient1, 0, {3}, {}, {1});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({3}));
+
+    // CASE 2: modified records are discarded
+    Refresh(kClient2, 0, {}, {4, 5});
+    response = Refresh(kClient2, 0, {6});
+    ASSERT_TRUE(Granted(response).empty());
+
+    response = Refresh(kClient2, 1, {6});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({6}));
+}
+
+TEST_F(MetaLeaseManagerTest, UnleasedMountpoint) {
+    const char* kClient3 = "host3:9000:/mnt";
+    Refresh(kClient1, 0, {});
+    auto response = Refresh(kClient1, 0, {1});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1}));
+
+    // CASE 1: a new mountpoint revokes all leases, and no lease is granted
+    //         before it refreshes with lease
+    manager_->AddMountpoint(kFsName, kClient2);
+    response = Refresh(kClient1, 1, {2});
+    ASSERT_EQ(Revoked(response), std::vector<uint64_t>({1}));
+    ASSERT_TRUE(Granted(response).empty());
+
+    // CASE 2: the mountpoint exchanges leases
+    Refresh(kClient2, 1, {});
+    response = Refresh(kClient1, 1, {2});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({2}));
+
+    // CASE 3: adding a known mountpoint changes nothing
+    manager_->AddMountpoint(kFsName, kClient1);
+    response = Refresh(kClient1, 1, {3});
+    ASSERT_TRUE(Revoked(response).empty());
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({3}));
+
+    // CASE 4: the lease is disabled by the mountpoint
+    manager_->AddMountpoint(kFsName, kClient3);
+    response = Refresh(kClient1, 2, {4});
+    ASSERT_EQ(Revoked(response), std::vector<uint64_t>({2, 3}));
+    ASSERT_TRUE(Granted(response).empty());
+
+    // CASE 5: the metadata fetched while it was alive is still denied
+    manager_->RemoveMountpoint(kFsName, kClient3);
+    response = Refresh(kClient1, 2, {4});
+    ASSERT_TRUE(Granted(response).empty());
+    response = Refresh(kClient1, response.sequence(), {4});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({4}));
+}
+
+TEST_F(MetaLeaseManagerTest, RemoveMountpoint) {
+    Refresh(kClient1, 0, {});
+    Refresh(kClient2, 0, {});
+    auto response = Refresh(kClient1, 0, {1});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({1}));
+    response = Refresh(kClient2, 0, {2});
+    ASSERT_EQ(Granted(response), std::vector<uint64_t>({2}));
+    uint64_t epoch = epochs_[kClient1];
+
+    // CASE 1: the unreported modifications of removed mountpoint are
+    //         unknown, so the leases of others are revoked
+    manager_->RemoveMountpoint(kFsName, kClient1);
+    response = Refresh(kClient2, 0, {3});
+    ASSERT_EQ(Revoked(response), std::vector<uint64_t>({2}));
+    ASSERT_TRUE(Granted(response).empty());
+
+    // CASE 2: the client gets a new epoch and drops its leases
+    response = Refresh(kClient1, 1, {2});
+    ASSERT_TRUE(Revoked(response).empty());
+    ASSERT_TRUE(Granted(response).empty());
+    ASSERT_NE(response.epoch(), epoch);
+
+    // CASE 3: remove all mountpoints
+    manager_->RemoveMountpoint(kFsName, kClient1);
+    manager_->RemoveMountpoint(kFsName, kClient2);
+    response = Refresh(kClient2, 1, {3});
+    ASSERT_TRUE(Granted(response).empty());
+}
+
+}  // namespace mds
+}  // namespace curvefs
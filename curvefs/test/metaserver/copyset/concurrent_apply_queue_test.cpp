@@ -22,9 +22,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <vector>
 #include <atomic>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 #include "src/common/timeutility.h"
 #include "curvefs/src/metaserver/copyset/concurrent_apply_queue.h"
@@ -94,8 +97,10 @@ static void InitReadWriteTypeList(std::vector<OperatorType> *readTypeList,
         return false;
     };
 
+    // barrier operators are run in place, see BarrierTest
     for (uint32_t i = 0; i < static_cast<uint32_t>(OperatorType::OperatorTypeMax); ++i) {  // NOLINT
-        if (!IsRead(static_cast<OperatorType>(i))) {
+        if (!IsRead(static_cast<OperatorType>(i)) &&
+            static_cast<OperatorType>(i) != OperatorType::RenameDentry) {
             writeTypeList->push_back(static_cast<OperatorType>(i));
         }
     }
@@ -169,6 +174,153 @@ TEST(ApplyQueue, FlushTest) {
     concurrentapply.Stop();
 }
 
+TEST(ApplyQueue, BarrierTest) {
+    std::vector<OperatorType> readTypeList;
+    std::vector<OperatorType> writeTypeList;
+    InitReadWriteTypeList(&readTypeList, &writeTypeList);
+
+    ApplyQueue concurrentapply;
+    ApplyOption opt(4, 1000, 1, 1);
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    std::atomic<uint32_t> testnum(0);
+    auto task = [&testnum]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        testnum.fetch_add(1);
+    };
+
+    for (int i = 0; i < 1000; i++) {
+        concurrentapply.Push(i, get_random_type(writeTypeList), task);
+    }
+
+    // all previous writes are finished before the barrier runs,
+    // and the barrier is finished once pushed
+    uint32_t seen = 0;
+    bool runned = false;
+    ASSERT_TRUE(concurrentapply.Push(0, OperatorType::RenameDentry,
+                                     [&testnum, &seen, &runned]() {
+                                         seen = testnum.load();
+                                         runned = true;
+                                     }));
+    ASSERT_TRUE(runned);
+    ASSERT_EQ(1000, seen);
+
+    concurrentapply.Stop();
+}
+
+TEST(ApplyQueue, ConflictTest) {
+    ApplyQueue concurrentapply;
+    ApplyOption opt(1, 10, 4, 10);
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    // write of inode 10 in partition 1 is blocked until released
+    std::atomic<bool> release(false);
+    std::atomic<bool> written(false);
+    concurrentapply.Push(1, 10, OperatorType::UpdateInode,
+                         [&release, &written]() {
+                             while (!release.load()) {
+                                 std::this_thread::sleep_for(
+                                     std::chrono::milliseconds(1));
+                             }
+                             written.store(true);
+                         });
+
+    // read of other inode isn't blocked by the write
+    std::atomic<bool> otherRead(false);
+    concurrentapply.Push(1, 20, OperatorType::GetInode,
+                         [&otherRead]() { otherRead.store(true); });
+    while (!otherRead.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // read of the same inode or whole partition sees the write
+    std::atomic<uint32_t> seen(0);
+    auto read = [&written, &seen]() {
+        if (written.load()) {
+            seen.fetch_add(1);
+        }
+    };
+    concurrentapply.Push(1, 10, OperatorType::GetInode, read);
+    concurrentapply.Push(1, OperatorType::BatchGetInodeAttr, read);
+
+    release.store(true);
+    concurrentapply.Flush();
+    ASSERT_EQ(2, seen.load());
+
+    // no pending writes, read is run by read threads
+    concurrentapply.Push(1, 10, OperatorType::GetInode, read);
+    concurrentapply.FlushAll();
+    ASSERT_EQ(3, seen.load());
+
+    concurrentapply.Stop();
+}
+
+TEST(ApplyQueue, WriteScheduleTest) {
+    ApplyQueue concurrentapply;
+    ApplyOption opt(4, 100, 1, 10);
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    std::mutex mtx;
+    std::vector<int> order;
+    auto write = [&mtx, &order](int id, std::atomic<bool>* release) {
+        while (release != nullptr && !release->load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::lock_guard<std::mutex> lk(mtx);
+        order.push_back(id);
+    };
+    auto finished = [&mtx, &order](int id) {
+        std::lock_guard<std::mutex> lk(mtx);
+        return std::find(order.begin(), order.end(), id) != order.end();
+    };
+
+    // CASE 1: writes of inode 10 and 12 in partition 1 are blocked
+    //         on different threads until released
+    std::atomic<bool> release10(false);
+    std::atomic<bool> release12(false);
+    concurrentapply.Push(1, 10, OperatorType::UpdateInode, write, 1,
+                         &release10);
+    concurrentapply.Push(1, 12, OperatorType::UpdateInode, write, 2,
+                         &release12);
+
+    // CASE 2: write of other inode in the same partition isn't blocked
+    concurrentapply.Push(1, 21, OperatorType::UpdateInode, write, 3,
+                         nullptr);
+    while (!finished(3)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // CASE 3: writes of the same inode are executed in log order
+    concurrentapply.Push(1, 10, OperatorType::CreateDentry, write, 4,
+                         nullptr);
+
+    // CASE 4: write of the whole partition waits until the pending writes
+    //         are queued to one thread, and later writes of the partition
+    //         are executed after it
+    std::thread pusher([&]() {
+        concurrentapply.Push(1, OperatorType::CreateInode, write, 5,
+                             nullptr);
+        concurrentapply.Push(1, 21, OperatorType::UpdateInode, write, 6,
+                             nullptr);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(finished(4));
+    ASSERT_FALSE(finished(5));
+    ASSERT_FALSE(finished(6));
+
+    release12.store(true);
+    while (!finished(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    release10.store(true);
+    pusher.join();
+    concurrentapply.Flush();
+
+    std::vector<int> expected{3, 2, 1, 4, 5, 6};
+    ASSERT_EQ(expected, order);
+    concurrentapply.Stop();
+}
+
 TEST(ApplyQueue, ConcurrentTest) {
     std::vector<OperatorType> readTypeList;
     std::vector<OperatorType> writeTypeList;
@@ -284,6 +284,38 @@ TEST_F(CopysetNodeTest, UpdateAppliedIndexTest) {
     EXPECT_EQ(maxAppliedIndex, node.GetAppliedIndex());
 }
 
+TEST_F(CopysetNodeTest, AppliedIndexWatermarkTest) {
+    CopysetNode node(poolId_, copysetId_, conf_, &mockNodeManager_);
+    CopysetNodeOptions options = options_;
+    options.dataUri = "local:///data/";
+    options.ip = "127.0.0.1";
+    options.port = 29940;
+
+    EXPECT_TRUE(node.Init(options));
+
+    int runned = 0;
+    auto task = [&runned]() { runned++; };
+    node.StartApply(10);
+    node.StartApply(11);
+    node.StartApply(13);
+
+    // the applied index isn't advanced until all previous entries finished
+    node.RunApplyTask(13, task);
+    EXPECT_EQ(0, node.GetAppliedIndex());
+    node.RunApplyTask(11, task);
+    EXPECT_EQ(0, node.GetAppliedIndex());
+    node.RunApplyTask(10, task);
+    EXPECT_EQ(13, node.GetAppliedIndex());
+
+    node.StartApply(14);
+    node.StartApply(15);
+    node.RunApplyTask(14, task);
+    EXPECT_EQ(14, node.GetAppliedIndex());
+    node.RunApplyTask(15, task);
+    EXPECT_EQ(15, node.GetAppliedIndex());
+    EXPECT_EQ(5, runned);
+}
+
 TEST_F(CopysetNodeTest, ListPeersTest) {
     CopysetNode node(poolId_, copysetId_, conf_, &mockNodeManager_);
     CopysetNodeOptions options = options_;
@@ -150,6 +150,7 @@ TEST_F(MetaOperatorTest, OperatorTypeTest) {
     TEST_OPERATOR_TYPE(CreatePartition);
     TEST_OPERATOR_TYPE(DeletePartition);
     TEST_OPERATOR_TYPE(PrepareRenameTx);
+    TEST_OPERATOR_TYPE(RenameDentry);
     TEST_OPERATOR_TYPE(UpdateDeallocatableBlockGroup);
 
 
@@ -198,6 +199,7 @@ TEST_F(MetaOperatorTest, OnApplyErrorTest) {
     OPERATOR_ON_APPLY_TEST(CreatePartition);
     OPERATOR_ON_APPLY_TEST(DeletePartition);
     OPERATOR_ON_APPLY_TEST(PrepareRenameTx);
+    OPERATOR_ON_APPLY_TEST(RenameDentry);
 
 #undef OPERATOR_ON_APPLY_TEST
 
@@ -317,6 +319,7 @@ TEST_F(MetaOperatorTest, OnApplyFromLogErrorTest) {
     OPERATOR_ON_APPLY_FROM_LOG_TEST(CreatePartition);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(DeletePartition);
     OPERATOR_ON_APPLY_FROM_LOG_TEST(PrepareRenameTx);
+    OPERATOR_ON_APPLY_FROM_LOG_TEST(RenameDentry);
 
 #undef OPERATOR_ON_APPLY_FROM_LOG_TEST
 
@@ -124,6 +124,7 @@ TEST(RaftLogCodecTest, DecodeFailedTest) {
     DECODE_FAILED_TEST(CreatePartition);
     DECODE_FAILED_TEST(DeletePartition);
     DECODE_FAILED_TEST(PrepareRenameTx);
+    DECODE_FAILED_TEST(RenameDentry);
 
 #undef DECODE_FAILED_TEST
 }
@@ -157,6 +158,7 @@ TEST(RaftLogCodecTest, DecodeSuccessTest) {
     ENCODE_DECODE_TEST(CreatePartition);
     ENCODE_DECODE_TEST(DeletePartition);
     ENCODE_DECODE_TEST(PrepareRenameTx);
+    ENCODE_DECODE_TEST(RenameDentry);
 
 #undef ENCODE_DECODE_TEST
 }
@@ -25,6 +25,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>  // NOLINT
+
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/rocksdb_storage.h"
 #include "curvefs/test/metaserver/storage/utils.h"
@@ -234,6 +237,56 @@ TEST_F(DentryStorageTest, Delete) {
     ASSERT_EQ(storage.Size(), 0);
 }
 
+TEST_F(DentryStorageTest, Rename) {
+    DentryStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+    // another partition in the same copyset
+    DentryStorage storage2(kvStorage_, std::make_shared<NameGenerator>(2), 0);
+    ASSERT_TRUE(storage2.Init());
+
+    Dentry src = GenDentry(1, 1, "A", 0, 10, false);
+    Dentry dst = GenDentry(1, 2, "B", 0, 10, false);
+
+    // CASE 1: source dentry not found
+    ASSERT_EQ(storage.Rename(src, &storage2, dst, logIndex_++),
+              MetaStatusCode::NOT_FOUND);
+
+    // CASE 2: rename across storages
+    ASSERT_EQ(storage.Insert(src, logIndex_++), MetaStatusCode::OK);
+    ASSERT_EQ(storage.Rename(src, &storage2, dst, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_EQ(storage.Size(), 0);
+    ASSERT_EQ(storage2.Size(), 1);
+    Dentry dentry = GenDentry(1, 2, "B", 0, 0, false);
+    ASSERT_EQ(storage2.Get(&dentry), MetaStatusCode::OK);
+    ASSERT_EQ(dentry.inodeid(), 10);
+
+    // CASE 3: rename idempotence
+    ASSERT_EQ(storage.Rename(src, &storage2, dst, logIndex_++),
+              MetaStatusCode::IDEMPOTENCE_OK);
+
+    // CASE 4: rename in the same storage with overwrite
+    Dentry old = GenDentry(1, 2, "C", 0, 11, false);
+    ASSERT_EQ(storage2.Insert(old, logIndex_++), MetaStatusCode::OK);
+    ASSERT_EQ(storage2.Size(), 2);
+    Dentry overwrite = GenDentry(1, 2, "C", 0, 10, false);
+    ASSERT_EQ(storage2.Rename(dst, &storage2, overwrite, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_EQ(storage2.Size(), 1);
+    dentry = GenDentry(1, 2, "C", 0, 0, false);
+    ASSERT_EQ(storage2.Get(&dentry), MetaStatusCode::OK);
+    ASSERT_EQ(dentry.inodeid(), 10);
+
+    // CASE 5: rename to itself, the applied index is recorded
+    int64_t index = logIndex_;
+    ASSERT_EQ(storage2.Rename(overwrite, &storage2, overwrite, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_EQ(storage2.Size(), 1);
+    int64_t appliedIndex = -1;
+    ASSERT_EQ(storage2.GetAppliedIndex(&appliedIndex), MetaStatusCode::OK);
+    ASSERT_EQ(appliedIndex, index);
+}
+
 TEST_F(DentryStorageTest, Get) {
     DentryStorage storage(kvStorage_, nameGenerator_, 0);
     ASSERT_TRUE(storage.Init());
@@ -573,5 +626,94 @@ TEST_F(DentryStorageTest, HandleTx) {
     ASSERT_EQ(dentry.inodeid(), 1);
 }
 
+TEST_F(DentryStorageTest, ConcurrentListAndInsert) {
+    DentryStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+
+    const int kDentrys = 100;
+    for (int i = 0; i < kDentrys; i++) {
+        auto dentry =
+            GenDentry(1, 1, "A" + std::to_string(i), 0, i + 10, false);
+        ASSERT_EQ(storage.Insert(dentry, logIndex_++), MetaStatusCode::OK);
+    }
+
+    // list parent 1 while inserting dentrys into parent 1 and 2
+    std::thread writer([&]() {
+        for (int i = 0; i < kDentrys; i++) {
+            auto d1 = GenDentry(1, 1, "B" + std::to_string(i), 0, i + 1000,
+                                false);
+            auto d2 = GenDentry(1, 2, "C" + std::to_string(i), 0, i + 2000,
+                                false);
+            ASSERT_EQ(storage.Insert(d1, logIndex_++), MetaStatusCode::OK);
+            ASSERT_EQ(storage.Insert(d2, logIndex_++), MetaStatusCode::OK);
+        }
+    });
+
+    size_t last = kDentrys;
+    for (int i = 0; i < 50; i++) {
+        std::vector<Dentry> dentrys;
+        auto dentry = GenDentry(1, 1, "", 0, 0, false);
+        ASSERT_EQ(storage.List(dentry, &dentrys, 0), MetaStatusCode::OK);
+        ASSERT_GE(dentrys.size(), last);
+        ASSERT_LE(dentrys.size(), 2 * kDentrys);
+        for (const auto& item : dentrys) {
+            ASSERT_EQ(item.parentinodeid(), 1);
+        }
+        last = dentrys.size();
+    }
+    writer.join();
+
+    std::vector<Dentry> dentrys;
+    auto dentry = GenDentry(1, 1, "", 0, 0, false);
+    ASSERT_EQ(storage.List(dentry, &dentrys, 0), MetaStatusCode::OK);
+    ASSERT_EQ(dentrys.size(), 2 * kDentrys);
+    ASSERT_EQ(storage.Size(), 3 * kDentrys);
+}
+
+// NOTE: the listing iterator of rocksdb reads from a snapshot, so list
+// doesn't hold the directory's stripe during the scan, an insertion into
+// the directory may start and finish while it's being listed
+TEST_F(DentryStorageTest, ListDoesNotBlockInsert) {
+    DentryStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+
+    const int kDentrys = 5000;
+    for (int i = 0; i < kDentrys; i++) {
+        auto dentry =
+            GenDentry(1, 1, "A" + std::to_string(i), 0, i + 10, false);
+        ASSERT_EQ(storage.Insert(dentry, logIndex_++), MetaStatusCode::OK);
+    }
+
+    // |listing| is odd while a list is in progress
+    std::atomic<uint64_t> listing(0);
+    std::atomic<uint64_t> overlapped(0);
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        for (int i = 0; !stop.load(); i++) {
+            auto dentry = GenDentry(1, 1, "B" + std::to_string(i), 0,
+                                    i + 100000, false);
+            uint64_t before = listing.load();
+            ASSERT_EQ(storage.Insert(dentry, logIndex_++),
+                      MetaStatusCode::OK);
+            if (before % 2 == 1 && listing.load() == before) {
+                overlapped.fetch_add(1);
+            }
+        }
+    });
+
+    for (int i = 0; i < 1000 && overlapped.load() == 0; i++) {
+        std::vector<Dentry> dentrys;
+        auto dentry = GenDentry(1, 1, "", 0, 0, false);
+        listing.fetch_add(1);
+        ASSERT_EQ(storage.List(dentry, &dentrys, 0), MetaStatusCode::OK);
+        listing.fetch_add(1);
+        ASSERT_GE(dentrys.size(), static_cast<size_t>(kDentrys));
+    }
+    stop.store(true);
+    writer.join();
+
+    ASSERT_GT(overlapped.load(), 0);
+}
+
 }  // namespace metaserver
 }  // namespace curvefs
@@ -428,6 +428,43 @@ TEST_F(InodeManagerTest, UpdateInode) {
     ASSERT_EQ(MetaStatusCode::OK, manager->UpdateInode(request, logIndex_++));
 }
 
+TEST_F(InodeManagerTest, BatchUpdateInode) {
+    Inode inode1;
+    Inode inode2;
+    ASSERT_EQ(MetaStatusCode::OK,
+              manager->CreateInode(2, param_, &inode1, logIndex_++));
+    ASSERT_EQ(MetaStatusCode::OK,
+              manager->CreateInode(3, param_, &inode2, logIndex_++));
+    ASSERT_EQ(2, (*filetype2InodeNum_)[FsFileType::TYPE_FILE]);
+
+    // update inode1 twice, unlink inode2 and update a missing inode
+    UpdateInodeRequest request1 = MakeUpdateInodeRequestFromInode(inode1);
+    request1.set_length(1000);
+    UpdateInodeRequest request2 = MakeUpdateInodeRequestFromInode(inode1);
+    request2.clear_length();
+    request2.set_mtime(1000);
+    UpdateInodeRequest request3 = MakeUpdateInodeRequestFromInode(inode2);
+    request3.set_nlink(0);
+    UpdateInodeRequest request4 = MakeUpdateInodeRequestFromInode(inode2);
+    request4.set_inodeid(100);
+
+    std::vector<MetaStatusCode> statuses;
+    ASSERT_EQ(MetaStatusCode::OK,
+              manager->BatchUpdateInode(
+                  {&request1, &request2, &request3, &request4}, &statuses,
+                  logIndex_++));
+    ASSERT_EQ(statuses, std::vector<MetaStatusCode>(
+                            {MetaStatusCode::OK, MetaStatusCode::OK,
+                             MetaStatusCode::OK, MetaStatusCode::NOT_FOUND}));
+
+    Inode out;
+    ASSERT_EQ(MetaStatusCode::OK, manager->GetInode(1, 2, &out));
+    ASSERT_EQ(1000, out.length());
+    ASSERT_EQ(1000, out.mtime());
+    ASSERT_EQ(MetaStatusCode::OK, manager->GetInode(1, 3, &out));
+    ASSERT_EQ(0, out.nlink());
+    ASSERT_EQ(1, (*filetype2InodeNum_)[FsFileType::TYPE_FILE]);
+}
 
 TEST_F(InodeManagerTest, testGetAttr) {
     // CREATE
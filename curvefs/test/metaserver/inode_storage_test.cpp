@@ -25,13 +25,20 @@
 #include <google/protobuf/empty.pb.h>
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
 #include <memory>
 #include <ostream>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/proto/common.pb.h"
 #include "curvefs/src/metaserver/inode_storage.h"
+#include "curvefs/src/metaserver/s3chunkinfo_codec.h"
 #include "curvefs/src/common/define.h"
 
 #include "curvefs/src/metaserver/storage/config.h"
@@ -243,6 +250,52 @@ TEST_F(InodeStorageTest, test1) {
     ASSERT_EQ(inodeIdList.size(), 2);
 }
 
+TEST_F(InodeStorageTest, InodeCount) {
+    {
+        InodeStorage storage(kvStorage_, nameGenerator_, 0);
+        ASSERT_TRUE(storage.Init());
+        ASSERT_TRUE(storage.Empty());
+        for (uint64_t inodeId = 1; inodeId <= 3; inodeId++) {
+            ASSERT_EQ(storage.Insert(GenInode(1, inodeId), logIndex_++),
+                      MetaStatusCode::OK);
+        }
+        ASSERT_EQ(storage.Size(), 3);
+        ASSERT_FALSE(storage.Empty());
+
+        // delete the non-exist inode doesn't change the count
+        ASSERT_EQ(storage.Delete(Key4Inode(1, 100), logIndex_++),
+                  MetaStatusCode::OK);
+        ASSERT_EQ(storage.Size(), 3);
+        ASSERT_EQ(storage.Delete(Key4Inode(1, 1), logIndex_++),
+                  MetaStatusCode::OK);
+        ASSERT_EQ(storage.Delete(Key4Inode(1, 1), logIndex_++),
+                  MetaStatusCode::OK);
+        ASSERT_EQ(storage.Size(), 2);
+    }
+
+    // the count is persisted
+    {
+        InodeStorage storage(kvStorage_, nameGenerator_, 0);
+        ASSERT_TRUE(storage.Init());
+        ASSERT_EQ(storage.Size(), 2);
+    }
+
+    // the count is recovered if it isn't persisted by older versions
+    {
+        auto tableName = nameGenerator_->GetInodeCountTableName();
+        ASSERT_TRUE(kvStorage_->SDel(tableName, "count").ok());
+        InodeStorage storage(kvStorage_, nameGenerator_, 100);
+        ASSERT_TRUE(storage.Init());
+        ASSERT_EQ(storage.Size(), 2);
+        ASSERT_EQ(storage.Delete(Key4Inode(1, 2), logIndex_++),
+                  MetaStatusCode::OK);
+        ASSERT_EQ(storage.Delete(Key4Inode(1, 3), logIndex_++),
+                  MetaStatusCode::OK);
+        ASSERT_EQ(storage.Size(), 0);
+        ASSERT_TRUE(storage.Empty());
+    }
+}
+
 TEST_F(InodeStorageTest, testGetAttrNotFound) {
     InodeStorage storage(kvStorage_, nameGenerator_, 0);
     ASSERT_TRUE(storage.Init());
@@ -705,6 +758,365 @@ TEST_F(InodeStorageTest, PaddingInodeS3ChunkInfo) {
     }
 }
 
+TEST_F(InodeStorageTest, MergeS3ChunkInfoList) {
+    uint32_t fsId = 1;
+    uint64_t inodeId = 1;
+    uint64_t chunkIndex = 1;
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+    Inode inode = GenInode(fsId, inodeId);
+    ASSERT_EQ(storage.Insert(inode, logIndex_++), MetaStatusCode::OK);
+
+    bool packed = FLAGS_s3chunkinfo_packed;
+    uint32_t mergeLists = FLAGS_s3chunkinfo_merge_lists;
+    FLAGS_s3chunkinfo_packed = true;
+    FLAGS_s3chunkinfo_merge_lists = 4;
+
+    // step1: the lists are merged once their number reaches the threshold
+    std::vector<S3ChunkInfoList> lists2add{
+        GenS3ChunkInfoList(1, 2), GenS3ChunkInfoList(3, 4),
+        GenS3ChunkInfoList(5, 6), GenS3ChunkInfoList(7, 8)};
+    for (size_t i = 0; i < lists2add.size(); i++) {
+        MetaStatusCode rc = storage.ModifyInodeS3ChunkInfoList(
+            fsId, inodeId, chunkIndex, &lists2add[i], nullptr, logIndex_++);
+        ASSERT_EQ(rc, MetaStatusCode::OK);
+        if (i < 3) {
+            CHECK_INODE_S3CHUNKINFOLIST(
+                &storage, fsId, inodeId,
+                std::vector<uint64_t>(i + 1, chunkIndex),
+                std::vector<S3ChunkInfoList>(lists2add.begin(),
+                                             lists2add.begin() + i + 1));
+        }
+    }
+    CHECK_INODE_S3CHUNKINFOLIST(&storage, fsId, inodeId,
+                                std::vector<uint64_t>{chunkIndex},
+                                std::vector<S3ChunkInfoList>{
+                                    GenS3ChunkInfoList(1, 8),
+                                });
+
+    // step2: compaction which read the lists before the last append
+    //        only deletes the chunk infos it read
+    S3ChunkInfoList list2add = GenS3ChunkInfoList(9, 9);
+    S3ChunkInfoList list2del = GenS3ChunkInfoList(1, 6);
+    MetaStatusCode rc = storage.ModifyInodeS3ChunkInfoList(
+        fsId, inodeId, chunkIndex, &list2add, &list2del, logIndex_++);
+    ASSERT_EQ(rc, MetaStatusCode::OK);
+    CHECK_INODE_S3CHUNKINFOLIST(&storage, fsId, inodeId,
+                                std::vector<uint64_t>{chunkIndex, chunkIndex},
+                                std::vector<S3ChunkInfoList>{
+                                    GenS3ChunkInfoList(7, 8),
+                                    GenS3ChunkInfoList(9, 9),
+                                });
+    ASSERT_EQ(storage.GetInodeS3MetaSize(fsId, inodeId), 3);
+
+    // step3: padding inode with merged list
+    Inode out;
+    rc = storage.PaddingInodeS3ChunkInfo(fsId, inodeId,
+                                         out.mutable_s3chunkinfomap());
+    ASSERT_EQ(rc, MetaStatusCode::OK);
+    ASSERT_EQ(out.s3chunkinfomap().size(), 1);
+    ASSERT_TRUE(EqualS3ChunkInfoList(out.s3chunkinfomap().at(chunkIndex),
+                                     GenS3ChunkInfoList(7, 9)));
+
+    FLAGS_s3chunkinfo_packed = packed;
+    FLAGS_s3chunkinfo_merge_lists = mergeLists;
+}
+
+TEST_F(InodeStorageTest, AppendInodeDelta) {
+    uint32_t fsId = 1;
+    uint64_t inodeId = 1;
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+    Inode inode = GenInode(fsId, inodeId);
+    inode.set_type(FsFileType::TYPE_DIRECTORY);
+    inode.set_nlink(2);
+    ASSERT_EQ(storage.Insert(inode, logIndex_++), MetaStatusCode::OK);
+
+    uint32_t mergeCount = FLAGS_inode_delta_merge_count;
+    FLAGS_inode_delta_merge_count = 4;
+
+    // the inode in storage without pending deltas
+    auto getStored = [&](Inode* out) {
+        std::string skey = conv_->SerializeToString(Key4Inode(fsId, inodeId));
+        return kvStorage_->HGet(nameGenerator_->GetInodeTableName(), skey, out)
+            .ok();
+    };
+
+    // step1: deltas are applied on read, the inode isn't rewritten
+    InodeDelta delta;
+    delta.set_nlink(1);
+    for (int i = 0; i < 3; i++) {
+        delta.set_time(100 + i);
+        delta.set_time_ns(i);
+        ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta, logIndex_++),
+                  MetaStatusCode::OK);
+    }
+    Inode out;
+    ASSERT_EQ(storage.Get(Key4Inode(fsId, inodeId), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 5);
+    ASSERT_EQ(out.mtime(), 102);
+    ASSERT_EQ(out.mtime_ns(), 2);
+    ASSERT_EQ(out.ctime(), 102);
+    ASSERT_EQ(out.ctime_ns(), 2);
+    InodeAttr attr;
+    ASSERT_EQ(storage.GetAttr(Key4Inode(fsId, inodeId), &attr),
+              MetaStatusCode::OK);
+    ASSERT_EQ(attr.nlink(), 5);
+    ASSERT_EQ(attr.mtime(), 102);
+    ASSERT_TRUE(getStored(&out));
+    ASSERT_EQ(out.nlink(), 2);
+    ASSERT_EQ(out.mtime(), 0);
+
+    // step2: deltas are merged once their number reaches the threshold,
+    //        and the latest time wins
+    delta.set_nlink(-1);
+    delta.set_time(99);
+    delta.set_time_ns(0);
+    ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_TRUE(getStored(&out));
+    ASSERT_EQ(out.nlink(), 4);
+    ASSERT_EQ(out.mtime(), 102);
+    ASSERT_EQ(storage.Get(Key4Inode(fsId, inodeId), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 4);
+
+    // step3: the pending deltas and their count survive restart
+    delta.set_nlink(1);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta, logIndex_++),
+                  MetaStatusCode::OK);
+    }
+    InodeStorage restarted(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(restarted.Init());
+    ASSERT_EQ(restarted.Get(Key4Inode(fsId, inodeId), &out),
+              MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 6);
+    auto iterator = restarted.GetAllInode();
+    ASSERT_EQ(iterator->Status(), 0);
+    iterator->SeekToFirst();
+    ASSERT_TRUE(iterator->Valid());
+    ASSERT_TRUE(iterator->ParseFromValue(&out));
+    ASSERT_EQ(out.nlink(), 6);
+    ASSERT_EQ(restarted.AppendInodeDelta(fsId, inodeId, delta, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_TRUE(getStored(&out));
+    ASSERT_EQ(out.nlink(), 4);
+    ASSERT_EQ(restarted.AppendInodeDelta(fsId, inodeId, delta, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_TRUE(getStored(&out));
+    ASSERT_EQ(out.nlink(), 8);
+
+    // step4: appending is idempotent when the log is replayed
+    int64_t logIndex = logIndex_++;
+    delta.set_nlink(1);
+    ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta, logIndex),
+              MetaStatusCode::OK);
+    ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta, logIndex),
+              MetaStatusCode::OK);
+    ASSERT_EQ(storage.Get(Key4Inode(fsId, inodeId), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 9);
+
+    // step5: updating inode drops the pending deltas which read before
+    out.set_nlink(10);
+    ASSERT_EQ(storage.Update(out, logIndex_++), MetaStatusCode::OK);
+    ASSERT_EQ(storage.Get(Key4Inode(fsId, inodeId), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 10);
+
+    // step6: the deltas of deleted inode are ignored
+    out.set_nlink(0);
+    ASSERT_EQ(storage.Update(out, logIndex_++), MetaStatusCode::OK);
+    ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta, logIndex_++),
+              MetaStatusCode::OK);
+    ASSERT_EQ(storage.Get(Key4Inode(fsId, inodeId), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 0);
+
+    // step7: the parent must exist
+    ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId + 1, delta, logIndex_++),
+              MetaStatusCode::NOT_FOUND);
+
+    FLAGS_inode_delta_merge_count = mergeCount;
+}
+
+TEST_F(InodeStorageTest, ConcurrentAppendInodeDelta) {
+    uint32_t fsId = 1;
+    uint64_t inodeId = 1;
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+    Inode inode = GenInode(fsId, inodeId);
+    inode.set_type(FsFileType::TYPE_DIRECTORY);
+    inode.set_nlink(2);
+    ASSERT_EQ(storage.Insert(inode, logIndex_++), MetaStatusCode::OK);
+
+    uint32_t mergeCount = FLAGS_inode_delta_merge_count;
+    FLAGS_inode_delta_merge_count = 16;
+    InodeDelta delta;
+    delta.set_nlink(1);
+
+    // CASE 1: appending only takes the stripe of inode shared, so it isn't
+    //         blocked by the others which hold the stripe shared, e.g.
+    //         another appending of the same inode
+    std::future<MetaStatusCode> appending;
+    {
+        StripedLockGuard slg(&storage.stripedLock_, inodeId, false);
+        int64_t logIndex = logIndex_++;
+        appending = std::async(std::launch::async, [&, logIndex]() {
+            return storage.AppendInodeDelta(fsId, inodeId, delta, logIndex);
+        });
+        ASSERT_EQ(appending.wait_for(std::chrono::seconds(10)),
+                  std::future_status::ready);
+    }
+    ASSERT_EQ(appending.get(), MetaStatusCode::OK);
+
+    // CASE 2: files are created in one directory by many threads at the
+    //         same time, all deltas are counted exactly once
+    const int kThreads = 8;
+    const int kFiles = 1000;
+    std::atomic<int64_t> logIndex(logIndex_);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < kFiles; j++) {
+                ASSERT_EQ(storage.AppendInodeDelta(fsId, inodeId, delta,
+                                                   logIndex.fetch_add(1)),
+                          MetaStatusCode::OK);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logIndex_ = logIndex.load();
+
+    Inode out;
+    ASSERT_EQ(storage.Get(Key4Inode(fsId, inodeId), &out), MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 3 + kThreads * kFiles);
+    InodeStorage restarted(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(restarted.Init());
+    ASSERT_EQ(restarted.Get(Key4Inode(fsId, inodeId), &out),
+              MetaStatusCode::OK);
+    ASSERT_EQ(out.nlink(), 3 + kThreads * kFiles);
+
+    FLAGS_inode_delta_merge_count = mergeCount;
+}
+
+TEST_F(InodeStorageTest, GetInodeS3ChunkInfoListByRange) {
+    uint32_t fsId = 1;
+    uint64_t inodeId = 1;
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+    Inode inode = GenInode(fsId, inodeId);
+    ASSERT_EQ(storage.Insert(inode, logIndex_++), MetaStatusCode::OK);
+
+    // chunk info |id| covers the file range [id * 4096, (id + 1) * 4096)
+    auto genList = [&](uint64_t firstChunkId, uint64_t lastChunkId) {
+        S3ChunkInfoList list = GenS3ChunkInfoList(firstChunkId, lastChunkId);
+        for (auto& info : *list.mutable_s3chunks()) {
+            info.set_offset(info.chunkid() * 4096);
+            info.set_len(4096);
+            info.set_size(4096);
+        }
+        return list;
+    };
+
+    // the lists of chunk index 0 are plain, and the ones of 1 are packed
+    bool packed = FLAGS_s3chunkinfo_packed;
+    std::vector<uint64_t> chunkIndexs{0, 1};
+    std::vector<S3ChunkInfoList> lists2add{genList(0, 3), genList(4, 7)};
+    for (size_t i = 0; i < chunkIndexs.size(); i++) {
+        FLAGS_s3chunkinfo_packed = (i == 1);
+        MetaStatusCode rc = storage.ModifyInodeS3ChunkInfoList(
+            fsId, inodeId, chunkIndexs[i], &lists2add[i], nullptr,
+            logIndex_++);
+        ASSERT_EQ(rc, MetaStatusCode::OK);
+    }
+    FLAGS_s3chunkinfo_packed = packed;
+
+    // step1: get by iterator
+    auto getByRange = [&](uint64_t offset, uint64_t length) {
+        std::map<uint64_t, S3ChunkInfoList> lists;
+        Key4S3ChunkInfoList key;
+        S3ChunkInfoList list4get;
+        auto iterator =
+            storage.GetInodeS3ChunkInfoList(fsId, inodeId, offset, length);
+        EXPECT_EQ(iterator->Status(), 0);
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            EXPECT_TRUE(conv_->ParseFromString(iterator->Key(), &key));
+            EXPECT_TRUE(iterator->ParseFromValue(&list4get));
+            lists[key.chunkIndex].MergeFrom(list4get);
+        }
+        return lists;
+    };
+
+    auto lists = getByRange(5 * 4096 + 1, 4096);
+    ASSERT_TRUE(EqualS3ChunkInfoList(lists[1], genList(5, 6)));
+    ASSERT_EQ(lists[0].s3chunks_size(), 0);
+
+    lists = getByRange(3 * 4096, 2 * 4096);
+    ASSERT_TRUE(EqualS3ChunkInfoList(lists[0], genList(3, 3)));
+    ASSERT_TRUE(EqualS3ChunkInfoList(lists[1], genList(4, 4)));
+
+    // step2: padding
+    S3ChunkInfoMap m;
+    ASSERT_EQ(storage.PaddingInodeS3ChunkInfo(fsId, inodeId, &m, 0, 6 * 4096,
+                                              UINT64_MAX),
+              MetaStatusCode::OK);
+    ASSERT_EQ(m.size(), 1);
+    ASSERT_TRUE(EqualS3ChunkInfoList(m.at(1), genList(6, 7)));
+}
+
+TEST_F(InodeStorageTest, S3ChunkInfoListFormat) {
+    uint32_t fsId = 1;
+    uint64_t inodeId = 1;
+    uint64_t chunkIndex = 1;
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_TRUE(storage.Init());
+    Inode inode = GenInode(fsId, inodeId);
+    ASSERT_EQ(storage.Insert(inode, logIndex_++), MetaStatusCode::OK);
+
+    bool packed = FLAGS_s3chunkinfo_packed;
+    uint32_t mergeLists = FLAGS_s3chunkinfo_merge_lists;
+    FLAGS_s3chunkinfo_merge_lists = 2;
+
+    // whether the stored lists are in packed format, in order of chunk id
+    auto getStored = [&]() {
+        std::vector<bool> formats;
+        PackedS3ChunkInfoList value;
+        auto iterator =
+            kvStorage_->SGetAll(nameGenerator_->GetS3ChunkInfoTableName());
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            EXPECT_TRUE(iterator->ParseFromValue(&value));
+            formats.push_back(value.has_data());
+        }
+        return formats;
+    };
+
+    // step1: the lists are stored as is by default, and never merged
+    std::vector<S3ChunkInfoList> lists2add{GenS3ChunkInfoList(1, 2),
+                                           GenS3ChunkInfoList(3, 4),
+                                           GenS3ChunkInfoList(5, 6)};
+    FLAGS_s3chunkinfo_packed = false;
+    for (size_t i = 0; i < 2; i++) {
+        MetaStatusCode rc = storage.ModifyInodeS3ChunkInfoList(
+            fsId, inodeId, chunkIndex, &lists2add[i], nullptr, logIndex_++);
+        ASSERT_EQ(rc, MetaStatusCode::OK);
+    }
+    ASSERT_EQ(getStored(), std::vector<bool>({false, false}));
+
+    // step2: lists in both formats can be read
+    FLAGS_s3chunkinfo_packed = true;
+    FLAGS_s3chunkinfo_merge_lists = 0;
+    MetaStatusCode rc = storage.ModifyInodeS3ChunkInfoList(
+        fsId, inodeId, chunkIndex, &lists2add[2], nullptr, logIndex_++);
+    ASSERT_EQ(rc, MetaStatusCode::OK);
+    ASSERT_EQ(getStored(), std::vector<bool>({false, false, true}));
+    CHECK_INODE_S3CHUNKINFOLIST(
+        &storage, fsId, inodeId, std::vector<uint64_t>(3, chunkIndex),
+        lists2add);
+
+    FLAGS_s3chunkinfo_packed = packed;
+    FLAGS_s3chunkinfo_merge_lists = mergeLists;
+}
+
 TEST_F(InodeStorageTest, GetAllS3ChunkInfoList) {
     InodeStorage storage(kvStorage_, nameGenerator_, 0);
     ASSERT_TRUE(storage.Init());
@@ -1438,6 +1438,151 @@ TEST_F(MetastoreTest, testBatchGetInodeAttr) {
     }
 }
 
+TEST_F(MetastoreTest, testBatchUpdateInode) {
+    MetaStoreImpl metastore(copyset_.get(), options_);
+    ASSERT_TRUE(metastore.InitStorage());
+
+    uint32_t poolId = 2;
+    uint32_t copysetId = 3;
+    uint32_t partitionId = 1;
+    uint32_t fsId = 1;
+
+    // create partition1
+    CreatePartitionRequest createPartitionRequest;
+    CreatePartitionResponse createPartitionResponse;
+    PartitionInfo partitionInfo1;
+    partitionInfo1.set_fsid(fsId);
+    partitionInfo1.set_poolid(poolId);
+    partitionInfo1.set_copysetid(copysetId);
+    partitionInfo1.set_partitionid(partitionId);
+    partitionInfo1.set_start(100);
+    partitionInfo1.set_end(1000);
+    createPartitionRequest.mutable_partition()->CopyFrom(partitionInfo1);
+    MetaStatusCode ret = metastore.CreatePartition(
+        &createPartitionRequest, &createPartitionResponse, logIndex_++);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+
+    CreateInodeRequest createRequest;
+    CreateInodeResponse createResponse;
+    createRequest.set_poolid(poolId);
+    createRequest.set_copysetid(copysetId);
+    createRequest.set_partitionid(partitionId);
+    createRequest.set_fsid(fsId);
+    createRequest.set_length(0);
+    createRequest.set_uid(100);
+    createRequest.set_gid(200);
+    createRequest.set_mode(777);
+    createRequest.set_type(FsFileType::TYPE_S3);
+
+    ret = metastore.CreateInode(&createRequest, &createResponse, logIndex_++);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+    uint64_t inodeId1 = createResponse.inode().inodeid();
+    ret = metastore.CreateInode(&createRequest, &createResponse, logIndex_++);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+    uint64_t inodeId2 = createResponse.inode().inodeid();
+
+    // batch update two existing inodes and a missing one
+    BatchUpdateInodeRequest batchRequest;
+    BatchUpdateInodeResponse batchResponse;
+    batchRequest.set_poolid(poolId);
+    batchRequest.set_copysetid(copysetId);
+    batchRequest.set_partitionid(partitionId);
+    batchRequest.set_fsid(fsId);
+    for (auto inodeId : {inodeId1, inodeId2, inodeId2 + 100}) {
+        auto* update = batchRequest.add_updates();
+        update->set_poolid(poolId);
+        update->set_copysetid(copysetId);
+        update->set_partitionid(partitionId);
+        update->set_fsid(fsId);
+        update->set_inodeid(inodeId);
+        update->set_length(inodeId);
+        S3ChunkInfoList list;
+        auto* info = list.add_s3chunks();
+        info->set_chunkid(inodeId);
+        info->set_compaction(0);
+        info->set_offset(0);
+        info->set_len(inodeId);
+        info->set_size(inodeId);
+        info->set_zero(false);
+        (*update->mutable_s3chunkinfoadd())[0] = list;
+    }
+
+    ret = metastore.BatchUpdateInode(&batchRequest, &batchResponse,
+                                     logIndex_++);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+    ASSERT_EQ(batchResponse.statuscode(), MetaStatusCode::OK);
+    ASSERT_EQ(batchResponse.statuses_size(), 3);
+    ASSERT_EQ(batchResponse.statuses(0), MetaStatusCode::OK);
+    ASSERT_EQ(batchResponse.statuses(1), MetaStatusCode::OK);
+    ASSERT_EQ(batchResponse.statuses(2), MetaStatusCode::NOT_FOUND);
+
+    for (auto inodeId : {inodeId1, inodeId2}) {
+        GetInodeRequest getRequest;
+        GetInodeResponse getResponse;
+        getRequest.set_poolid(poolId);
+        getRequest.set_copysetid(copysetId);
+        getRequest.set_partitionid(partitionId);
+        getRequest.set_fsid(fsId);
+        getRequest.set_inodeid(inodeId);
+        getRequest.set_supportstreaming(false);
+        ret = metastore.GetInode(&getRequest, &getResponse, logIndex_++);
+        ASSERT_EQ(ret, MetaStatusCode::OK);
+        ASSERT_EQ(getResponse.inode().length(), inodeId);
+        ASSERT_EQ(getResponse.inode().s3chunkinfomap_size(), 1);
+        ASSERT_EQ(getResponse.inode().s3chunkinfomap().at(0).s3chunks(0)
+                      .chunkid(), inodeId);
+    }
+
+    // the same inode twice in one batch, both updates are applied
+    batchRequest.clear_updates();
+    batchResponse.Clear();
+    for (uint64_t index : {1, 2}) {
+        auto* update = batchRequest.add_updates();
+        update->set_poolid(poolId);
+        update->set_copysetid(copysetId);
+        update->set_partitionid(partitionId);
+        update->set_fsid(fsId);
+        update->set_inodeid(inodeId1);
+        update->set_length(inodeId1 + index);
+        S3ChunkInfoList list;
+        auto* info = list.add_s3chunks();
+        info->set_chunkid(inodeId1 + index);
+        info->set_compaction(0);
+        info->set_offset(0);
+        info->set_len(index);
+        info->set_size(index);
+        info->set_zero(false);
+        (*update->mutable_s3chunkinfoadd())[index] = list;
+    }
+    ret = metastore.BatchUpdateInode(&batchRequest, &batchResponse,
+                                     logIndex_++);
+    ASSERT_EQ(ret, MetaStatusCode::OK);
+    ASSERT_EQ(batchResponse.statuses_size(), 2);
+    ASSERT_EQ(batchResponse.statuses(0), MetaStatusCode::OK);
+    ASSERT_EQ(batchResponse.statuses(1), MetaStatusCode::OK);
+    {
+        GetInodeRequest getRequest;
+        GetInodeResponse getResponse;
+        getRequest.set_poolid(poolId);
+        getRequest.set_copysetid(copysetId);
+        getRequest.set_partitionid(partitionId);
+        getRequest.set_fsid(fsId);
+        getRequest.set_inodeid(inodeId1);
+        getRequest.set_supportstreaming(false);
+        ret = metastore.GetInode(&getRequest, &getResponse, logIndex_++);
+        ASSERT_EQ(ret, MetaStatusCode::OK);
+        ASSERT_EQ(getResponse.inode().length(), inodeId1 + 2);
+        ASSERT_EQ(getResponse.inode().s3chunkinfomap_size(), 3);
+    }
+
+    // partition not found
+    batchRequest.set_partitionid(partitionId + 1);
+    batchResponse.Clear();
+    ret = metastore.BatchUpdateInode(&batchRequest, &batchResponse,
+                                     logIndex_++);
+    ASSERT_EQ(ret, MetaStatusCode::PARTITION_NOT_FOUND);
+}
+
 TEST_F(MetastoreTest, testBatchGetXAttr) {
     MetaStoreImpl metastore(copyset_.get(), options_);
     ASSERT_TRUE(metastore.InitStorage());
@@ -90,6 +90,9 @@ class MockMetaStore : public curvefs::metaserver::MetaStore {
     MOCK_METHOD3(DeleteInode,
                  MetaStatusCode(const DeleteInodeRequest*, DeleteInodeResponse*,
                                 int64_t logIndex));
+    MOCK_METHOD3(BatchUpdateInode,
+                 MetaStatusCode(const BatchUpdateInodeRequest*,
+                                BatchUpdateInodeResponse*, int64_t logIndex));
     MOCK_METHOD3(UpdateInode,
                  MetaStatusCode(const UpdateInodeRequest*, UpdateInodeResponse*,
                                 int64_t logIndex));
@@ -98,6 +101,10 @@ class MockMetaStore : public curvefs::metaserver::MetaStore {
                  MetaStatusCode(const PrepareRenameTxRequest*,
                                 PrepareRenameTxResponse*, int64_t logIndex));
 
+    MOCK_METHOD3(RenameDentry,
+                 MetaStatusCode(const RenameDentryRequest*,
+                                RenameDentryResponse*, int64_t logIndex));
+
     MOCK_METHOD0(GetStreamServer, std::shared_ptr<StreamServer>());
 
     MOCK_METHOD4(GetOrModifyS3ChunkInfo,
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/metaserver/s3chunkinfo_codec.h"
+
+#include <google/protobuf/util/message_differencer.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace curvefs {
+namespace metaserver {
+
+using ::google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+S3ChunkInfoList GenS3ChunkInfoList(uint64_t firstChunkId,
+                                   uint64_t lastChunkId) {
+    S3ChunkInfoList list;
+    for (uint64_t id = firstChunkId; id <= lastChunkId; id++) {
+        auto* info = list.add_s3chunks();
+        info->set_chunkid(id);
+        info->set_compaction(id % 3);
+        info->set_offset(id * 4096);
+        info->set_len(4096);
+        info->set_size(id % 2 == 0 ? 4096 : 1024);
+        info->set_zero(id % 5 == 0);
+    }
+    return list;
+}
+
+}  // namespace
+
+TEST(S3ChunkInfoCodecTest, PackAndUnpack) {
+    for (bool compression : {false, true}) {
+        FLAGS_s3chunkinfo_compression = compression;
+        S3ChunkInfoList list = GenS3ChunkInfoList(100, 1099);
+        // out of order chunk infos, e.g: kept by compaction
+        *list.add_s3chunks() = GenS3ChunkInfoList(1, 1).s3chunks(0);
+
+        PackedS3ChunkInfoList packed;
+        PackS3ChunkInfoList(list, &packed);
+        ASSERT_EQ(packed.count(), list.s3chunks_size());
+        ASSERT_EQ(packed.minoffset(), 4096);
+        ASSERT_EQ(packed.maxend(), 1100 * 4096);
+        ASSERT_EQ(packed.compressed(), compression);
+        ASSERT_LT(packed.ByteSizeLong(), list.ByteSizeLong() / 2);
+
+        std::string value;
+        ASSERT_TRUE(packed.SerializeToString(&value));
+        PackedS3ChunkInfoList parsed;
+        ASSERT_TRUE(parsed.ParseFromString(value));
+
+        S3ChunkInfoList unpacked;
+        ASSERT_TRUE(UnpackS3ChunkInfoList(parsed, &unpacked));
+        ASSERT_TRUE(MessageDifferencer::Equals(list, unpacked));
+    }
+    FLAGS_s3chunkinfo_compression = false;
+}
+
+TEST(S3ChunkInfoCodecTest, UnpackAppend) {
+    PackedS3ChunkInfoList packed;
+    PackS3ChunkInfoList(GenS3ChunkInfoList(3, 4), &packed);
+
+    S3ChunkInfoList list = GenS3ChunkInfoList(1, 2);
+    ASSERT_TRUE(UnpackS3ChunkInfoList(packed, &list));
+    ASSERT_TRUE(MessageDifferencer::Equals(list, GenS3ChunkInfoList(1, 4)));
+}
+
+TEST(S3ChunkInfoCodecTest, UnpackLegacy) {
+    S3ChunkInfoList list = GenS3ChunkInfoList(1, 10);
+    std::string value;
+    ASSERT_TRUE(list.SerializeToString(&value));
+
+    PackedS3ChunkInfoList packed;
+    ASSERT_TRUE(packed.ParseFromString(value));
+    ASSERT_FALSE(packed.has_data());
+    ASSERT_TRUE(MayOverlap(packed, 0, 1));
+
+    S3ChunkInfoList unpacked;
+    ASSERT_TRUE(UnpackS3ChunkInfoList(packed, &unpacked));
+    ASSERT_TRUE(MessageDifferencer::Equals(list, unpacked));
+
+    unpacked.Clear();
+    ASSERT_TRUE(UnpackS3ChunkInfoList(packed, 2 * 4096, 4096, &unpacked));
+    ASSERT_TRUE(MessageDifferencer::Equals(unpacked, GenS3ChunkInfoList(2, 2)));
+}
+
+TEST(S3ChunkInfoCodecTest, UnpackRange) {
+    PackedS3ChunkInfoList packed;
+    PackS3ChunkInfoList(GenS3ChunkInfoList(10, 19), &packed);
+
+    ASSERT_FALSE(MayOverlap(packed, 0, 10 * 4096));
+    ASSERT_FALSE(MayOverlap(packed, 20 * 4096, 4096));
+    ASSERT_TRUE(MayOverlap(packed, 10 * 4096 - 1, 2));
+    ASSERT_TRUE(MayOverlap(packed, 0, UINT64_MAX));
+
+    S3ChunkInfoList list;
+    ASSERT_TRUE(UnpackS3ChunkInfoList(packed, 0, 10 * 4096, &list));
+    ASSERT_EQ(list.s3chunks_size(), 0);
+
+    ASSERT_TRUE(UnpackS3ChunkInfoList(packed, 12 * 4096 + 1, 2 * 4096, &list));
+    ASSERT_TRUE(MessageDifferencer::Equals(list, GenS3ChunkInfoList(12, 14)));
+
+    list.Clear();
+    ASSERT_TRUE(UnpackS3ChunkInfoList(packed, 15 * 4096, UINT64_MAX, &list));
+    ASSERT_TRUE(MessageDifferencer::Equals(list, GenS3ChunkInfoList(15, 19)));
+}
+
+TEST(S3ChunkInfoCodecTest, UnpackCorrupted) {
+    PackedS3ChunkInfoList packed;
+    PackS3ChunkInfoList(GenS3ChunkInfoList(1, 10), &packed);
+    packed.mutable_data()->resize(packed.data().size() / 2);
+
+    S3ChunkInfoList list;
+    ASSERT_FALSE(UnpackS3ChunkInfoList(packed, &list));
+}
+
+}  // namespace metaserver
+}  // namespace curvefs
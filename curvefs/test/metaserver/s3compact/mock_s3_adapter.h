@@ -63,6 +63,8 @@ class MockS3Adapter : public S3Adapter {
     MOCK_METHOD0(GetBucketName, std::string());
     MOCK_METHOD2(PutObject, int(const Aws::String&, const std::string&));
     MOCK_METHOD2(GetObject, int(const Aws::String&, std::string*));
+    MOCK_METHOD1(GetObjectAsync,
+                 void(std::shared_ptr<curve::common::GetObjectAsyncContext>));
     MOCK_METHOD1(DeleteObject, int(const Aws::String&));
 };
 }  // namespace metaserver
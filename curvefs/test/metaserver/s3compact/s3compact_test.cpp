@@ -22,7 +22,12 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "curvefs/src/metaserver/s3compact_manager.h"
 #include "curvefs/src/metaserver/s3compact_worker.h"
@@ -499,12 +504,14 @@ TEST_F(S3CompactTest, test_ReadFullChunk) {
     };
 
     EXPECT_CALL(*s3adapter_, DeleteObject(_)).WillRepeatedly(Return(0));
-    auto mock_getobj = [&](const Aws::String& key, std::string* data) {
-        data->clear();
-        data->append(ctx.blockSize, '\0');
-        return 0;
-    };
-    EXPECT_CALL(*s3adapter_, GetObject(_, _))
+    auto mock_getobj =
+        [&](std::shared_ptr<curve::common::GetObjectAsyncContext> context) {
+            memset(context->buf, 0, context->len);
+            context->retCode = 0;
+            context->actualLen = context->len;
+            context->cb(nullptr, context);
+        };
+    EXPECT_CALL(*s3adapter_, GetObjectAsync(_))
         .WillRepeatedly(testing::Invoke(mock_getobj));
 
     validList.emplace_back(0, 1, 0, 0, 0, 0, true);
@@ -523,8 +530,33 @@ TEST_F(S3CompactTest, test_ReadFullChunk) {
     ASSERT_EQ(newChunkInfo.newCompaction, 1);
     ASSERT_EQ(fullChunk.size(), 14);
 
+    // requests of the same obj are merged into one ranged read
     reset();
-    EXPECT_CALL(*s3adapter_, GetObject(_, _)).WillRepeatedly(Return(-1));
+    std::vector<std::pair<off_t, size_t>> ranges;
+    EXPECT_CALL(*s3adapter_, GetObjectAsync(_))
+        .WillRepeatedly(testing::Invoke(
+            [&](std::shared_ptr<curve::common::GetObjectAsyncContext> context) {
+                ranges.emplace_back(context->offset, context->len);
+                mock_getobj(context);
+            }));
+    validList.emplace_back(0, 0, 1, 0, 0, 4, false);
+    validList.emplace_back(1, 1, 2, 0, 1, 1, false);
+    validList.emplace_back(2, 3, 1, 0, 0, 4, false);
+    ret = impl_->ReadFullChunk(ctx, validList, &fullChunk, &newChunkInfo);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(fullChunk.size(), 4);
+    ASSERT_EQ(ranges.size(), 2);
+    std::sort(ranges.begin(), ranges.end());
+    ASSERT_EQ(ranges[0], std::make_pair(off_t(0), size_t(1)));
+    ASSERT_EQ(ranges[1], std::make_pair(off_t(0), size_t(4)));
+
+    reset();
+    EXPECT_CALL(*s3adapter_, GetObjectAsync(_))
+        .WillRepeatedly(testing::Invoke(
+            [&](std::shared_ptr<curve::common::GetObjectAsyncContext> context) {
+                context->retCode = -1;
+                context->cb(nullptr, context);
+            }));
     validList.emplace_back(0, 1, 1, 1, 0, 0, false);
     ret = impl_->ReadFullChunk(ctx, validList, &fullChunk, &newChunkInfo);
     ASSERT_EQ(ret, -1);
@@ -568,12 +600,14 @@ TEST_F(S3CompactTest, test_CompactChunks) {
         .WillRepeatedly(testing::Invoke(mock_updateinode));
     EXPECT_CALL(*s3adapter_, PutObject(_, _)).WillRepeatedly(Return(0));
     EXPECT_CALL(*s3adapter_, DeleteObject(_)).WillRepeatedly(Return(0));
-    auto mock_getobj = [&](const Aws::String& key, std::string* data) {
-        data->clear();
-        data->append(blockSize, '\0');
-        return 0;
-    };
-    EXPECT_CALL(*s3adapter_, GetObject(_, _))
+    auto mock_getobj =
+        [&](std::shared_ptr<curve::common::GetObjectAsyncContext> context) {
+            memset(context->buf, 0, context->len);
+            context->retCode = 0;
+            context->actualLen = context->len;
+            context->cb(nullptr, context);
+        };
+    EXPECT_CALL(*s3adapter_, GetObjectAsync(_))
         .WillRepeatedly(testing::Invoke(mock_getobj));
 
     auto* mockCopysetNodeWrapper = mockCopysetNodeWrapper_.get();
@@ -669,15 +703,36 @@ TEST_F(S3CompactTest, test_CompactChunks) {
     ASSERT_EQ(inodeStorage_->Update(inode1, logIndex_++), MetaStatusCode::OK);
     mockImpl_->CompactChunks(t);
     ASSERT_EQ(tmp.s3chunkinfomap().size(), 1);
+    // intact blocks are kept, fragments [16-20] and [26-27] are merged
     const auto& l = tmp.s3chunkinfomap().at(0);
-    ASSERT_EQ(l.s3chunks_size(), 1);
-    const auto& s3chunkinfo = l.s3chunks(0);
-    ASSERT_EQ(s3chunkinfo.chunkid(), 21);
-    ASSERT_EQ(s3chunkinfo.compaction(), 1);
-    ASSERT_EQ(s3chunkinfo.offset(), 0);
-    ASSERT_EQ(s3chunkinfo.len(), 60);
-    ASSERT_EQ(s3chunkinfo.size(), 60);
-    ASSERT_EQ(s3chunkinfo.zero(), false);
+    ASSERT_EQ(l.s3chunks_size(), 15);
+    uint64_t totalLen = 0;
+    for (int i = 0; i < l.s3chunks_size(); i++) {
+        totalLen += l.s3chunks(i).len();
+        if (i > 0) {
+            ASSERT_LE(l.s3chunks(i - 1).chunkid(), l.s3chunks(i).chunkid());
+        }
+    }
+    ASSERT_EQ(totalLen, 60);
+    ASSERT_EQ(l.s3chunks(0).chunkid(), 0);
+    ASSERT_EQ(l.s3chunks(4).chunkid(), 7);
+    const auto& kept = l.s3chunks(12);
+    ASSERT_EQ(kept.chunkid(), 21);
+    ASSERT_EQ(kept.compaction(), 0);
+    ASSERT_EQ(kept.offset(), 21);
+    ASSERT_EQ(kept.len(), 5);
+    const auto& merged1 = l.s3chunks(13);
+    ASSERT_EQ(merged1.chunkid(), 21);
+    ASSERT_EQ(merged1.compaction(), 1);
+    ASSERT_EQ(merged1.offset(), 16);
+    ASSERT_EQ(merged1.len(), 5);
+    ASSERT_EQ(merged1.size(), 5);
+    ASSERT_EQ(merged1.zero(), false);
+    const auto& merged2 = l.s3chunks(14);
+    ASSERT_EQ(merged2.chunkid(), 21);
+    ASSERT_EQ(merged2.compaction(), 2);
+    ASSERT_EQ(merged2.offset(), 26);
+    ASSERT_EQ(merged2.len(), 2);
     // inode nlink = 0, deleted
     inode1.set_nlink(0);
     ASSERT_EQ(inodeStorage_->Update(inode1, logIndex_++), MetaStatusCode::OK);
@@ -23,19 +23,29 @@
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/storage/key_migration.h"
+#include "curvefs/src/metaserver/storage/memory_storage.h"
+#include "src/common/string_util.h"
 
 namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+using ::curve::common::StringStartWith;
+
 class ConverterTest : public testing::Test {
  protected:
     void SetUp() override {}
 
-    void TearDown() override {}
+    void TearDown() override { SetKeyFormat(KeyFormat::kText); }
 
  protected:
     Converter conv_;
@@ -111,6 +121,148 @@ TEST_F(ConverterTest, Key4InodeAuxInfo) {
     ASSERT_EQ(out.inodeId, 1);
 }
 
+TEST_F(ConverterTest, BinaryKey) {
+    SetKeyFormat(KeyFormat::kBinary);
+
+    Key4Inode inode(1, 100);
+    std::string skey = conv_.SerializeToString(inode);
+    ASSERT_EQ(skey.size(), 13);
+    ASSERT_EQ(skey[0], kTypeInode);
+    ASSERT_EQ(FormatOfKey(skey), KeyFormat::kBinary);
+    Key4Inode inodeOut;
+    ASSERT_TRUE(conv_.ParseFromString(skey, &inodeOut));
+    ASSERT_EQ(inodeOut.fsId, 1);
+    ASSERT_EQ(inodeOut.inodeId, 100);
+    ASSERT_FALSE(conv_.ParseFromString(skey.substr(0, 12), &inodeOut));
+    ASSERT_FALSE(conv_.ParseFromString(skey + "x", &inodeOut));
+
+    Key4S3ChunkInfoList chunk(1, 2, 3, 4, 5, 6);
+    Key4S3ChunkInfoList chunkOut;
+    ASSERT_TRUE(conv_.ParseFromString(conv_.SerializeToString(chunk),
+                                      &chunkOut));
+    ASSERT_EQ(chunkOut.fsId, 1);
+    ASSERT_EQ(chunkOut.inodeId, 2);
+    ASSERT_EQ(chunkOut.chunkIndex, 3);
+    ASSERT_EQ(chunkOut.firstChunkId, 4);
+    ASSERT_EQ(chunkOut.lastChunkId, 5);
+    ASSERT_EQ(chunkOut.size, 6);
+    ASSERT_TRUE(StringStartWith(
+        conv_.SerializeToString(chunk),
+        conv_.SerializeToString(Prefix4ChunkIndexS3ChunkInfoList(1, 2, 3))));
+    ASSERT_TRUE(StringStartWith(
+        conv_.SerializeToString(chunk),
+        conv_.SerializeToString(Prefix4InodeS3ChunkInfoList(1, 2))));
+
+    // name may contain any bytes
+    std::string name("a:\0b", 4);
+    Key4Dentry dentry(1, 100, name);
+    skey = conv_.SerializeToString(dentry);
+    Key4Dentry dentryOut;
+    ASSERT_TRUE(conv_.ParseFromString(skey, &dentryOut));
+    ASSERT_EQ(dentryOut.fsId, 1);
+    ASSERT_EQ(dentryOut.parentInodeId, 100);
+    ASSERT_EQ(dentryOut.name, name);
+    ASSERT_TRUE(StringStartWith(
+        skey, conv_.SerializeToString(Prefix4SameParentDentry(1, 100))));
+    ASSERT_FALSE(conv_.ParseFromString(skey, &inodeOut));
+}
+
+TEST_F(ConverterTest, BinaryKeyOrder) {
+    SetKeyFormat(KeyFormat::kBinary);
+
+    // keys are ordered numerically, e.g: inode 9 < inode 10
+    std::vector<uint64_t> ids{0, 9, 10, 255, 256, 1ULL << 32,
+                              std::numeric_limits<uint64_t>::max()};
+    std::vector<std::string> keys;
+    for (auto id : ids) {
+        keys.push_back(conv_.SerializeToString(Key4Inode(1, id)));
+    }
+    ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+    keys.clear();
+    for (auto id : ids) {
+        keys.push_back(conv_.SerializeToString(
+            Key4S3ChunkInfoList(1, 1, 0, id, id, 1)));
+    }
+    ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+    // the dentries of a directory are ordered by name
+    ASSERT_LT(conv_.SerializeToString(Key4Dentry(1, 9, "b")),
+              conv_.SerializeToString(Key4Dentry(1, 10, "a")));
+    ASSERT_LT(conv_.SerializeToString(Key4Dentry(1, 10, "a")),
+              conv_.SerializeToString(Key4Dentry(1, 10, "ab")));
+}
+
+TEST_F(ConverterTest, ParseBothFormat) {
+    std::string text = conv_.SerializeToString(Key4InodeAuxInfo(1, 2));
+    ASSERT_EQ(text, "5:1:2");
+    ASSERT_EQ(FormatOfKey(text), KeyFormat::kText);
+
+    SetKeyFormat(KeyFormat::kBinary);
+    std::string binary = conv_.SerializeToString(Key4InodeAuxInfo(1, 2));
+    ASSERT_NE(text, binary);
+
+    Key4InodeAuxInfo out;
+    ASSERT_TRUE(conv_.ParseFromString(text, &out));
+    ASSERT_EQ(out.fsId, 1);
+    ASSERT_EQ(out.inodeId, 2);
+    ASSERT_TRUE(conv_.ParseFromString(binary, &out));
+    ASSERT_EQ(out.fsId, 1);
+    ASSERT_EQ(out.inodeId, 2);
+
+    KeyFormat format;
+    ASSERT_TRUE(StringToKeyFormat("text", &format));
+    ASSERT_EQ(format, KeyFormat::kText);
+    ASSERT_TRUE(StringToKeyFormat("binary", &format));
+    ASSERT_EQ(format, KeyFormat::kBinary);
+    ASSERT_FALSE(StringToKeyFormat("json", &format));
+}
+
+TEST_F(ConverterTest, MigrateKeyFormat) {
+    StorageOptions options;
+    options.compression = false;
+    auto kvStorage = std::make_shared<MemoryStorage>(options);
+    ASSERT_TRUE(kvStorage->Open());
+    const std::string table = "inode";
+
+    // written by older version
+    for (uint64_t id = 1; id <= 2048; id++) {
+        Inode inode;
+        inode.set_inodeid(id);
+        ASSERT_TRUE(kvStorage->HSet(table,
+                                    conv_.SerializeToString(Key4Inode(1, id)),
+                                    inode).ok());
+    }
+
+    uint64_t migrated = 0;
+    SetKeyFormat(KeyFormat::kBinary);
+    auto s = MigrateKeyFormat<Key4Inode, Inode>(kvStorage.get(), table, false,
+                                                &migrated);
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ(migrated, 2048);
+    ASSERT_EQ(kvStorage->HSize(table), 2048);
+
+    Inode inode;
+    ASSERT_TRUE(kvStorage->HGet(table,
+                                conv_.SerializeToString(Key4Inode(1, 100)),
+                                &inode).ok());
+    ASSERT_EQ(inode.inodeid(), 100);
+
+    // nothing to do
+    s = MigrateKeyFormat<Key4Inode, Inode>(kvStorage.get(), table, false,
+                                           &migrated);
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ(migrated, 0);
+
+    // and back to text format
+    SetKeyFormat(KeyFormat::kText);
+    s = MigrateKeyFormat<Key4Inode, Inode>(kvStorage.get(), table, false,
+                                           &migrated);
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ(migrated, 2048);
+    ASSERT_TRUE(kvStorage->HGet(table, "1:1:100", &inode).ok());
+}
+
 TEST_F(ConverterTest, NameGenerator) {
     NameGenerator ng(1);
     ASSERT_EQ(ng.GetFixedLength(), 6);
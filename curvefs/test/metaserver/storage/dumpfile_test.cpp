@@ -28,6 +28,8 @@
 #include <thread>
 #include <unordered_map>
 #include <array>
+#include <fstream>
+#include <vector>
 
 #include "curvefs/src/common/process.h"
 #include "curvefs/src/metaserver/storage/iterator.h"
@@ -264,6 +266,83 @@ TEST_F(DumpFileTest, TestVersion) {
     ASSERT_EQ(file2load->GetVersion(), 1);
 }
 
+TEST_F(DumpFileTest, TestDefaultVersion) {
+    // older versions can't load v5, so it's saved only if enabled
+    ASSERT_EQ(DumpFile(pathname_).GetVersion(), kDumpFileV4);
+    FLAGS_dumpfile_sections = true;
+    ASSERT_EQ(DumpFile(pathname_).GetVersion(), kDumpFileV5);
+    FLAGS_dumpfile_sections = false;
+}
+
+TEST_F(DumpFileTest, TestSaveShards) {
+    std::vector<Hash> hashes(8);
+    std::vector<std::shared_ptr<Iterator>> shards;
+    Hash hash;
+    for (size_t i = 0; i < hashes.size(); i++) {
+        for (uint64_t j = 0; j < 100000; j++) {
+            auto num = std::to_string(i * 100000 + j);
+            hashes[i].emplace(num, num);
+            hash.emplace(num, num);
+        }
+        shards.push_back(std::make_shared<HashIterator>(&hashes[i]));
+    }
+
+    auto file2save = std::make_shared<DumpFile>(pathname_, kDumpFileV5);
+    ASSERT_EQ(file2save->Open(), DUMPFILE_ERROR::OK);
+    for (auto compression : { false, true }) {
+        FLAGS_dumpfile_compression = compression;
+        ASSERT_EQ(file2save->SaveBackground(shards), DUMPFILE_ERROR::OK);
+
+        auto copy = hash;
+        auto iter = dumpfile_->Load();
+        CheckIterator(iter, &copy);
+        ASSERT_EQ(dumpfile_->GetLoadStatus(), DUMPFILE_LOAD_STATUS::COMPLETE);
+        ASSERT_EQ(dumpfile_->GetVersion(), kDumpFileV5);
+        ASSERT_EQ(iter->Size(), hash.size());
+    }
+    FLAGS_dumpfile_compression = false;
+    ASSERT_EQ(file2save->Close(), DUMPFILE_ERROR::OK);
+}
+
+TEST_F(DumpFileTest, TestLoadCorruptedSection) {
+    Hash hash;
+    auto hashIterator = std::make_shared<HashIterator>(&hash);
+    GenHash(&hash, 100);
+    auto file2save = std::make_shared<DumpFile>(pathname_, kDumpFileV5);
+    ASSERT_EQ(file2save->Open(), DUMPFILE_ERROR::OK);
+    ASSERT_EQ(file2save->Save(hashIterator), DUMPFILE_ERROR::OK);
+    ASSERT_EQ(file2save->Close(), DUMPFILE_ERROR::OK);
+
+    // corrupt the first section which follows magic, version and table offset
+    {
+        std::fstream file(pathname_,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(7 + 1 + 8 + 4);
+        file.put('x');
+    }
+
+    auto iter = dumpfile_->Load();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {}
+    ASSERT_EQ(dumpfile_->GetLoadStatus(),
+              DUMPFILE_LOAD_STATUS::INVALID_CHECKSUM);
+}
+
+TEST_F(DumpFileTest, TestLoadOldVersion) {
+    Hash hash;
+    auto hashIterator = std::make_shared<HashIterator>(&hash);
+    GenHash(&hash, 100);
+
+    auto file2save = std::make_shared<DumpFile>(pathname_, kDumpFileV4);
+    ASSERT_EQ(file2save->Open(), DUMPFILE_ERROR::OK);
+    std::vector<std::shared_ptr<Iterator>> shards{ hashIterator };
+    ASSERT_EQ(file2save->Save(shards), DUMPFILE_ERROR::OK);
+    ASSERT_EQ(file2save->Close(), DUMPFILE_ERROR::OK);
+
+    CheckIterator(dumpfile_->Load(), &hash);
+    ASSERT_EQ(dumpfile_->GetLoadStatus(), DUMPFILE_LOAD_STATUS::COMPLETE);
+    ASSERT_EQ(dumpfile_->GetVersion(), kDumpFileV4);
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
@@ -23,10 +23,14 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/memory_storage.h"
 #include "curvefs/test/metaserver/storage/storage_test.h"
+#include "curvefs/test/metaserver/storage/utils.h"
+#include "src/fs/ext4_filesystem_impl.h"
 
 namespace curvefs {
 namespace metaserver {
@@ -89,6 +93,82 @@ TEST_F(MemoryStorageTest, SClearTest) { TestSClear(kvStorage_);
 TEST_F(MemoryStorageTest, MixOperatorTest) { TestMixOperator(kvStorage_);
                                              TestMixOperator(kvStorage2_); }
 
+TEST_F(MemoryStorageTest, ParseAsOtherTypeTest) {
+    Inode inode;
+    inode.set_inodeid(1);
+    inode.set_fsid(2);
+    inode.set_length(3);
+    inode.set_ctime(0);
+    inode.set_ctime_ns(0);
+    inode.set_mtime(0);
+    inode.set_mtime_ns(0);
+    inode.set_atime(0);
+    inode.set_atime_ns(0);
+    inode.set_uid(0);
+    inode.set_gid(0);
+    inode.set_mode(0);
+    inode.set_nlink(1);
+    inode.set_type(FsFileType::TYPE_FILE);
+    ASSERT_TRUE(kvStorage_->HSet("1", "a", inode).ok());
+    ASSERT_TRUE(kvStorage_->SSet("1", "a", inode).ok());
+
+    // the value is converted by its wire format
+    InodeAttr attr;
+    ASSERT_TRUE(kvStorage_->HGet("1", "a", &attr).ok());
+    ASSERT_EQ(attr.inodeid(), 1);
+    ASSERT_EQ(attr.length(), 3);
+
+    attr.Clear();
+    auto iterator = kvStorage_->SSeek("1", "a");
+    iterator->SeekToFirst();
+    ASSERT_TRUE(iterator->Valid());
+    ASSERT_TRUE(iterator->ParseFromValue(&attr));
+    ASSERT_EQ(attr.fsid(), 2);
+    ASSERT_EQ(attr.nlink(), 1);
+}
+
+TEST_F(MemoryStorageTest, CheckpointAndRecoverTest) {
+    auto localfs = curve::fs::Ext4FileSystemImpl::getInstance();
+    std::string dir = RandomStoragePath();
+    ASSERT_EQ(localfs->Mkdir(dir), 0);
+
+    for (bool compression : { false, true }) {
+        options_.compression = compression;
+        auto storage = std::make_shared<MemoryStorage>(options_);
+        ASSERT_TRUE(storage->HSet("1", "a", Value("a")).ok());
+        ASSERT_TRUE(storage->HSet("2", "b", Value("b")).ok());
+        ASSERT_TRUE(storage->SSet("1", "c", Value("c")).ok());
+        ASSERT_TRUE(storage->SSet("1", "d", Value("d")).ok());
+
+        // step1: the checkpoint is forked before modifying
+        std::vector<std::string> files;
+        ASSERT_TRUE(storage->PrepareCheckpoint(dir));
+        ASSERT_TRUE(storage->SDel("1", "d").ok());
+        ASSERT_TRUE(storage->Checkpoint(dir, &files));
+        ASSERT_EQ(files, std::vector<std::string>{"memory_checkpoint"});
+
+        // step2: recover into a storage with stale data
+        auto recovered = std::make_shared<MemoryStorage>(options_);
+        ASSERT_TRUE(recovered->HSet("3", "e", Value("e")).ok());
+        ASSERT_TRUE(recovered->Recover(dir));
+
+        Dentry dentry;
+        ASSERT_TRUE(recovered->HGet("1", "a", &dentry).ok());
+        ASSERT_EQ(dentry, Value("a"));
+        ASSERT_TRUE(recovered->HGet("2", "b", &dentry).ok());
+        ASSERT_EQ(dentry, Value("b"));
+        ASSERT_TRUE(recovered->SGet("1", "c", &dentry).ok());
+        ASSERT_EQ(dentry, Value("c"));
+        ASSERT_TRUE(recovered->SGet("1", "d", &dentry).ok());
+        ASSERT_EQ(dentry, Value("d"));
+        ASSERT_TRUE(recovered->HGet("3", "e", &dentry).IsNotFound());
+        ASSERT_EQ(recovered->HSize("1"), 1);
+        ASSERT_EQ(recovered->SSize("1"), 2);
+    }
+
+    ASSERT_EQ(localfs->Delete(dir), 0);
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
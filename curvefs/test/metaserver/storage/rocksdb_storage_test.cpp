@@ -29,7 +29,11 @@
 #include <unistd.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/storage/rocksdb_options.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/test/metaserver/storage/storage_test.h"
@@ -90,6 +94,36 @@ class RocksDBStorageTest : public testing::Test {
         return true;
     }
 
+    std::string TableName(uint32_t partitionId) {
+        auto ng = std::make_shared<NameGenerator>(partitionId);
+        return ng->GetDentryTableName();
+    }
+
+    // append a put of |key| and then a merge, which isn't supported
+    // by the pending batch
+    Status AppendPutAndMerge(const std::string& name, const std::string& key,
+                             bool ordered) {
+        auto storage = std::dynamic_pointer_cast<RocksDBStorage>(kvStorage_);
+        auto handle = storage->GetColumnFamilyHandle(ordered);
+        std::string ikey = storage->ToInternalKey(name, key, ordered);
+        ROCKSDB_NAMESPACE::WriteBatch batch;
+        batch.Put(handle, ikey, Value("value").SerializeAsString());
+        batch.Merge(handle, ikey, "merge");
+        return storage->AppendPendingBatch(batch);
+    }
+
+    // read key from database directly, skipping the pending write batch
+    ROCKSDB_STATUS GetFromDB(const std::string& name,
+                             const std::string& key,
+                             bool ordered) {
+        auto storage = std::dynamic_pointer_cast<RocksDBStorage>(kvStorage_);
+        std::string svalue;
+        return storage->db_->Get(storage->dbReadOptions_,
+                                 storage->GetColumnFamilyHandle(ordered),
+                                 storage->ToInternalKey(name, key, ordered),
+                                 &svalue);
+    }
+
  protected:
     std::string dirname_;
     std::string dbpath_;
@@ -99,6 +133,19 @@ class RocksDBStorageTest : public testing::Test {
         curve::fs::Ext4FileSystemImpl::getInstance();
 };
 
+class RocksDBStorageWriteBatchTest : public RocksDBStorageTest {
+ protected:
+    void SetUp() override {
+        FLAGS_rocksdb_write_batch_size = 1024;
+        RocksDBStorageTest::SetUp();
+    }
+
+    void TearDown() override {
+        RocksDBStorageTest::TearDown();
+        FLAGS_rocksdb_write_batch_size = 0;
+    }
+};
+
 TEST_F(RocksDBStorageTest, OpenCloseTest) {
     // CASE 1: open twice
     ASSERT_TRUE(kvStorage_->Open());
@@ -176,6 +223,91 @@ TEST_F(RocksDBStorageTest, HClearTestSMixOperator) {
 }
 TEST_F(RocksDBStorageTest, Transaction) { TestTransaction(kvStorage_); }
 
+TEST_F(RocksDBStorageWriteBatchTest, HGetAllTest) {
+    TestHGetAll(kvStorage_);
+}
+TEST_F(RocksDBStorageWriteBatchTest, HClearTest) { TestHClear(kvStorage_); }
+TEST_F(RocksDBStorageWriteBatchTest, SSeekTest) { TestSSeek(kvStorage_); }
+TEST_F(RocksDBStorageWriteBatchTest, MixOperatorTest) {
+    TestMixOperator(kvStorage_);
+}
+TEST_F(RocksDBStorageWriteBatchTest, TransactionTest) {
+    TestTransaction(kvStorage_);
+}
+
+TEST_F(RocksDBStorageWriteBatchTest, PendingMutationTest) {
+    Status s;
+    Dentry value;
+
+    // CASE 1: pending mutations are visible
+    s = kvStorage_->SSet(TableName(1), "1", Value("1"));
+    ASSERT_TRUE(s.ok());
+    s = kvStorage_->SGet(TableName(1), "1", &value);
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ(value, Value("1"));
+
+    // CASE 2: transaction reads its own and pending mutations
+    auto txn = kvStorage_->BeginTransaction();
+    s = txn->SSet(TableName(1), "2", Value("2"));
+    ASSERT_TRUE(s.ok());
+    s = txn->SDel(TableName(1), "1");
+    ASSERT_TRUE(s.ok());
+    s = txn->SGet(TableName(1), "1", &value);
+    ASSERT_TRUE(s.IsNotFound());
+    s = txn->SGet(TableName(1), "2", &value);
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ(value, Value("2"));
+
+    // mutations of transaction are invisible before commit
+    s = kvStorage_->SGet(TableName(1), "1", &value);
+    ASSERT_TRUE(s.ok());
+    s = kvStorage_->SGet(TableName(1), "2", &value);
+    ASSERT_TRUE(s.IsNotFound());
+
+    // CASE 3: iterator in transaction
+    s = kvStorage_->SSet(TableName(1), "3", Value("3"));
+    ASSERT_TRUE(s.ok());
+    std::vector<std::string> keys;
+    auto iterator = txn->SSeek(TableName(1), "");
+    ASSERT_EQ(iterator->Status(), 0);
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        keys.push_back(iterator->Key());
+    }
+    ASSERT_EQ(keys, std::vector<std::string>({"2", "3"}));
+
+    s = txn->Commit();
+    ASSERT_TRUE(s.ok());
+    s = kvStorage_->SGet(TableName(1), "1", &value);
+    ASSERT_TRUE(s.IsNotFound());
+    s = kvStorage_->SGet(TableName(1), "2", &value);
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ(value, Value("2"));
+
+    // CASE 4: iterators see pending mutations without writing them
+    s = kvStorage_->HSet(TableName(2), "0", Value("value"));
+    ASSERT_TRUE(s.ok());
+    iterator = kvStorage_->HGetAll(TableName(2));
+    ASSERT_EQ(iterator->Status(), 0);
+    iterator->SeekToFirst();
+    ASSERT_TRUE(iterator->Valid());
+    ASSERT_EQ(iterator->Key(), "0");
+    ASSERT_TRUE(GetFromDB(TableName(2), "0", false).IsNotFound());
+
+    // CASE 5: mutations are written once their size reach the limit
+    for (int i = 1; i < 100; i++) {
+        s = kvStorage_->HSet(TableName(2), std::to_string(i), Value("value"));
+        ASSERT_TRUE(s.ok());
+    }
+    ASSERT_TRUE(GetFromDB(TableName(2), "0", false).ok());
+    ASSERT_TRUE(GetFromDB(TableName(1), "2", true).ok());
+
+    // CASE 6: mutations are appended all or nothing
+    s = AppendPutAndMerge(TableName(3), "1", true);
+    ASSERT_FALSE(s.ok());
+    s = kvStorage_->SGet(TableName(3), "1", &value);
+    ASSERT_TRUE(s.IsNotFound());
+}
+
 TEST_F(RocksDBStorageTest, TestCleanOpen) {
     ASSERT_TRUE(kvStorage_->Close());
 
@@ -294,6 +426,34 @@ TEST_F(RocksDBStorageTest, TestCheckpointAndRecover) {
     EXPECT_EQ(Value("7"), dummyDentry);
 }
 
+TEST_F(RocksDBStorageTest, TestPrepareCheckpoint) {
+    ASSERT_TRUE(kvStorage_->SSet("1", "1", Value("1")).ok());
+    ASSERT_TRUE(kvStorage_->HSet("2", "2", Value("2")).ok());
+    ASSERT_TRUE(kvStorage_->SSet("3", "3", Value("3")).ok());
+
+    // mutations after preparing are not included by checkpoint
+    ASSERT_TRUE(kvStorage_->PrepareCheckpoint(dirname_));
+    EXPECT_TRUE(localfs_->DirExists(dirname_ + "/rocksdb_checkpoint"));
+    ASSERT_TRUE(kvStorage_->SDel("1", "1").ok());
+    ASSERT_TRUE(kvStorage_->HSet("2", "2", Value("22")).ok());
+    ASSERT_TRUE(kvStorage_->SSet("4", "4", Value("4")).ok());
+
+    std::vector<std::string> files;
+    ASSERT_TRUE(kvStorage_->Checkpoint(dirname_, &files));
+    EXPECT_FALSE(files.empty());
+
+    ASSERT_TRUE(kvStorage_->Recover(dirname_));
+
+    Dentry dummyDentry;
+    ASSERT_TRUE(kvStorage_->SGet("1", "1", &dummyDentry).ok());
+    EXPECT_EQ(Value("1"), dummyDentry);
+    ASSERT_TRUE(kvStorage_->HGet("2", "2", &dummyDentry).ok());
+    EXPECT_EQ(Value("2"), dummyDentry);
+    ASSERT_TRUE(kvStorage_->SGet("3", "3", &dummyDentry).ok());
+    EXPECT_EQ(Value("3"), dummyDentry);
+    EXPECT_TRUE(kvStorage_->SGet("4", "4", &dummyDentry).IsNotFound());
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
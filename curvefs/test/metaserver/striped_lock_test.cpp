@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2026 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: Curve
+ * Created Date: 2026-10-19
+ * Author: agent
+ */
+
+#include "curvefs/src/metaserver/common/striped_lock.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace curvefs {
+namespace metaserver {
+
+TEST(StripedLockTest, Stripe) {
+    StripedRWLock lock(4);
+    ASSERT_EQ(lock.Stripes(), 4);
+    ASSERT_EQ(lock.StripeOf(1), lock.StripeOf(5));
+    ASSERT_NE(lock.StripeOf(1), lock.StripeOf(2));
+
+    StripedRWLock single(0);
+    ASSERT_EQ(single.Stripes(), 1);
+    ASSERT_EQ(single.StripeOf(1), single.StripeOf(2));
+}
+
+TEST(StripedLockTest, ExclusiveOnlyLocksItsStripe) {
+    StripedRWLock lock(4);
+    {
+        StripedLockGuard guard(&lock, 1, true);
+        ASSERT_NE(lock.At(lock.StripeOf(1))->TryRDLock(), 0);
+        ASSERT_EQ(lock.At(lock.StripeOf(2))->TryWRLock(), 0);
+        lock.At(lock.StripeOf(2))->Unlock();
+    }
+    ASSERT_EQ(lock.At(lock.StripeOf(1))->TryWRLock(), 0);
+    lock.At(lock.StripeOf(1))->Unlock();
+}
+
+TEST(StripedLockTest, SharedLock) {
+    StripedRWLock lock(4);
+    StripedLockGuard guard(&lock, 1, false);
+    ASSERT_EQ(lock.At(lock.StripeOf(1))->TryRDLock(), 0);
+    lock.At(lock.StripeOf(1))->Unlock();
+    ASSERT_NE(lock.At(lock.StripeOf(1))->TryWRLock(), 0);
+}
+
+TEST(StripedLockTest, MultiKeys) {
+    StripedRWLock lock(4);
+    {
+        // duplicated stripes are locked only once
+        StripedLockGuard guard(&lock, std::vector<uint64_t>{6, 1, 5, 2}, true);
+        for (auto key : {1, 2}) {
+            ASSERT_NE(lock.At(lock.StripeOf(key))->TryRDLock(), 0);
+        }
+        for (auto key : {3, 4}) {
+            ASSERT_EQ(lock.At(lock.StripeOf(key))->TryWRLock(), 0);
+            lock.At(lock.StripeOf(key))->Unlock();
+        }
+    }
+    for (auto key : {1, 2}) {
+        ASSERT_EQ(lock.At(lock.StripeOf(key))->TryWRLock(), 0);
+        lock.At(lock.StripeOf(key))->Unlock();
+    }
+}
+
+TEST(StripedLockTest, AllStripesAndUnlock) {
+    StripedRWLock lock(4);
+    StripedLockGuard guard(&lock, true);
+    for (size_t i = 0; i < lock.Stripes(); i++) {
+        ASSERT_NE(lock.At(i)->TryRDLock(), 0);
+    }
+
+    guard.Unlock();
+    for (size_t i = 0; i < lock.Stripes(); i++) {
+        ASSERT_EQ(lock.At(i)->TryWRLock(), 0);
+        lock.At(i)->Unlock();
+    }
+}
+
+}  // namespace metaserver
+}  // namespace curvefs
@@ -51,6 +51,22 @@ TEST_F(BitmapAllocatorTest, CommonTest) {
     ASSERT_EQ(opt_.length, allocator_->AvailableSize());
 }
 
+TEST_F(BitmapAllocatorTest, TryAllocTest) {
+    Extents exts;
+    AllocateHint hint;
+
+    // not enough space
+    ASSERT_EQ(0, allocator_->TryAlloc(opt_.length + opt_.sizePerBit, hint,
+                                      &exts));
+    ASSERT_TRUE(exts.empty());
+
+    ASSERT_EQ(opt_.sizePerBit,
+              allocator_->TryAlloc(opt_.sizePerBit, hint, &exts));
+    ASSERT_EQ(opt_.length - opt_.sizePerBit, allocator_->AvailableSize());
+    allocator_->DeAlloc(exts);
+    ASSERT_EQ(opt_.length, allocator_->AvailableSize());
+}
+
 TEST_F(BitmapAllocatorTest, AllocFromSmallExtentTest) {
     uint64_t allocSize = opt_.sizePerBit / 2;
 
@@ -144,5 +144,44 @@ TEST_F(AioTest, AioWrite_IssueUnAlignedError) {
     }
 }
 
+TEST_F(AioTest, AioBatch) {
+    AioBatch batch(3);
+    char buffer[3 * 4096];
+    AioRead read1(0, 4096, buffer, dev_.get(), 0, &batch);
+    AioRead read2(8192, 4096, buffer + 4096, dev_.get(), 0, &batch);
+    AioWrite write(16384, 4096, data_, dev_.get(), 0, &batch);
+
+    auto complete = [](int, CurveAioContext* aio, UserDataType) {
+        std::thread th([aio]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            aio->ret = aio->length;
+            aio->cb(aio);
+        });
+
+        th.detach();
+        return 0;
+    };
+
+    EXPECT_CALL(*dev_, AioRead(_, _, _))
+        .WillOnce(Invoke(complete))
+        .WillOnce(Return(-1));
+    EXPECT_CALL(*dev_, AioWrite(_, _, _))
+        .WillOnce(Invoke(complete));
+
+    read1.Issue();
+    read2.Issue();
+    write.Issue();
+    batch.Wait();
+
+    EXPECT_EQ(4096, read1.Wait());
+    EXPECT_GT(0, read2.Wait());
+    EXPECT_EQ(4096, write.Wait());
+}
+
+TEST_F(AioTest, AioBatch_Empty) {
+    AioBatch batch(0);
+    batch.Wait();
+}
+
 }  // namespace volume
 }  // namespace curvefs
@@ -524,6 +524,33 @@ TEST_F(BlockDeviceClientTest, ReadvTest_PartialFailed) {
 }
 
 
+TEST_F(BlockDeviceClientTest, ReadvTest_CoalesceContinuous) {
+    ON_CALL(*fileClient_, Open(_, _, _))
+        .WillByDefault(Return(1));
+
+    char data[12 * kKiB];
+
+    // first two parts are continuous both on device and in buffer
+    std::vector<ReadPart> iov{
+        { 0 * kKiB, 4 * kKiB, data},
+        { 4 * kKiB, 4 * kKiB, data + 4 * kKiB},
+        {12 * kKiB, 4 * kKiB, data + 8 * kKiB},
+    };
+
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
+        .WillOnce(Invoke([](int, CurveAioContext* aio, UserDataType) {
+            EXPECT_EQ(0, aio->offset);
+            EXPECT_EQ(8 * kKiB, aio->length);
+            aio->ret = aio->length;
+            aio->cb(aio);
+            return 0;
+        }))
+        .WillOnce(Invoke(FakeAioRequest{}));
+
+    ASSERT_TRUE(client_->Open({}, {}));
+    ASSERT_EQ(3 * (4 * kKiB), client_->Readv(iov));
+}
+
 TEST_F(BlockDeviceClientTest, WritevTest_AllSuccess) {
     ON_CALL(*fileClient_, Open(_, _, _))
         .WillByDefault(Return(1));
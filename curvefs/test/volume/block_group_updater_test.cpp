@@ -25,6 +25,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
+#include <thread>
+
 #include "absl/memory/memory.h"
 #include "curvefs/test/volume/mock/mock_block_device_client.h"
 
@@ -107,5 +111,101 @@ TEST_F(BlockGroupBitmapUpdaterTest, SyncTest_WriteFailed) {
     ASSERT_FALSE(updater_->Sync());
 }
 
+TEST_F(BlockGroupBitmapUpdaterTest, SyncTest_RetryAfterWriteFailed) {
+    auto start = kBlockGroupOffset;
+    updater_->Update({start, kBlockSize}, BlockGroupBitmapUpdater::Set);
+
+    EXPECT_CALL(*mockBlockDev_, Write(_, _, _))
+        .WillOnce(Return(-1))
+        .WillOnce(
+            Invoke([](const char*, off_t, size_t length) { return length; }));
+
+    ASSERT_FALSE(updater_->Sync());
+    ASSERT_TRUE(updater_->Sync());
+    ASSERT_TRUE(updater_->Sync());
+}
+
+TEST_F(BlockGroupBitmapUpdaterTest, SyncTest_OnlyDirtyPages) {
+    // 1GiB block group has 8 pages of bitmap
+    constexpr uint64_t kLargeGroupSize = 1 * kGiB;
+    constexpr uint64_t kPageSize = BlockGroupBitmapUpdater::kPageSize;
+    Bitmap bitmap(kLargeGroupSize / kBlockSize);
+    bitmap.Clear();
+    BitmapRange range{
+        kBlockGroupOffset,
+        kLargeGroupSize / kBlockSize / curve::common::BITMAP_UNIT_SIZE};
+    ASSERT_EQ(8 * kPageSize, range.length);
+
+    BlockGroupBitmapUpdater updater(std::move(bitmap), kBlockSize,
+                                    kLargeGroupSize, kBlockGroupOffset, range,
+                                    mockBlockDev_.get());
+
+    // CASE 1: adjacent dirty pages are written by one request
+    auto blocksPerPage = kPageSize * curve::common::BITMAP_UNIT_SIZE;
+    updater.Update({kBlockGroupOffset, kBlockSize},
+                   BlockGroupBitmapUpdater::Set);
+    updater.Update({kBlockGroupOffset + blocksPerPage * kBlockSize, kBlockSize},
+                   BlockGroupBitmapUpdater::Set);
+
+    EXPECT_CALL(*mockBlockDev_, Write(_, _, _))
+        .WillOnce(Invoke([&](const char*, off_t offset, size_t length) {
+            EXPECT_EQ(kBlockGroupOffset, offset);
+            EXPECT_EQ(2 * kPageSize, length);
+            return length;
+        }));
+    ASSERT_TRUE(updater.Sync());
+
+    // CASE 2: non-adjacent dirty pages are written together
+    updater.Update({kBlockGroupOffset, kBlockSize},
+                   BlockGroupBitmapUpdater::Clear);
+    updater.Update({kBlockGroupOffset + kLargeGroupSize - kBlockSize,
+                    kBlockSize},
+                   BlockGroupBitmapUpdater::Set);
+
+    EXPECT_CALL(*mockBlockDev_, Write(_, _, _))
+        .Times(0);
+    EXPECT_CALL(*mockBlockDev_, Writev(_))
+        .WillOnce(Invoke([&](const std::vector<WritePart>& pages) {
+            EXPECT_EQ(2, pages.size());
+            EXPECT_EQ(kBlockGroupOffset, pages[0].offset);
+            EXPECT_EQ(kBlockGroupOffset + 7 * kPageSize, pages[1].offset);
+            return static_cast<ssize_t>(2 * kPageSize);
+        }));
+    ASSERT_TRUE(updater.Sync());
+}
+
+TEST_F(BlockGroupBitmapUpdaterTest, SyncTest_Coalesced) {
+    std::promise<void> writing;
+    std::promise<void> finish;
+    std::shared_future<void> finished(finish.get_future());
+    EXPECT_CALL(*mockBlockDev_, Write(_, _, _))
+        .WillOnce(Invoke([&](const char*, off_t, size_t length) {
+            writing.set_value();
+            finished.wait();
+            return length;
+        }))
+        .WillOnce(
+            Invoke([](const char*, off_t, size_t length) { return length; }));
+
+    // the first sync is writing the updates of both syncs
+    updater_->Update({kBlockGroupOffset, kBlockSize},
+                     BlockGroupBitmapUpdater::Set);
+    auto first = std::async(std::launch::async,
+                            [this]() { return updater_->Sync(); });
+    writing.get_future().wait();
+    auto second = std::async(std::launch::async,
+                             [this]() { return updater_->Sync(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // the second sync needn't write the update after it
+    updater_->Update({kBlockGroupOffset + kBlockSize, kBlockSize},
+                     BlockGroupBitmapUpdater::Set);
+    finish.set_value();
+    ASSERT_TRUE(first.get());
+    ASSERT_TRUE(second.get());
+
+    ASSERT_TRUE(updater_->Sync());
+}
+
 }  // namespace volume
 }  // namespace curvefs
@@ -218,5 +218,87 @@ TEST_F(SpaceManagerImplTest, TestMultiThreadAlloc) {
     ASSERT_TRUE(spaceManager_->Shutdown());
 }
 
+TEST_F(SpaceManagerImplTest, TestAllocFailedIfSyncFailed) {
+    mds::space::BlockGroup group;
+    group.set_offset(0);
+    group.set_size(kBlockGroupSize);
+    group.set_available(kBlockGroupSize / 2);
+    group.set_bitmaplocation(curvefs::common::BitmapLocation::AtStart);
+
+    EXPECT_CALL(*mdsClient_, AllocateVolumeBlockGroup(_, _, _, _))
+        .WillOnce(Invoke(MockAllocateBlockGroup{group}));
+
+    EXPECT_CALL(*devClient_, Read(_, _, _))
+        .WillRepeatedly(Invoke(MockRead));
+
+    EXPECT_CALL(*devClient_, Write(_, _, _))
+        .WillOnce(Return(-1))
+        .WillRepeatedly(Invoke(MockWrite));
+
+    // CASE 1: allocation fails if its bitmap isn't persisted
+    std::vector<Extent> exts;
+    ASSERT_FALSE(spaceManager_->Alloc(kBlockSize, {}, &exts));
+    ASSERT_TRUE(exts.empty());
+
+    // CASE 2: the space is given back, all of it can be allocated
+    //         without fetching another block group
+    int64_t left = opt_.blockGroupManagerOption.blockGroupSize -
+                   opt_.blockGroupManagerOption.blockSize;
+    while (left > 0) {
+        std::vector<Extent> ext;
+        ASSERT_TRUE(spaceManager_->Alloc(kBlockSize, {}, &ext));
+        left -= kBlockSize;
+    }
+
+    EXPECT_CALL(*mdsClient_, ReleaseVolumeBlockGroup(_, _, _))
+        .WillOnce(Return(SpaceErrCode::SpaceOk));
+    ASSERT_TRUE(spaceManager_->Shutdown());
+}
+
+TEST_F(SpaceManagerImplTest, TestPrefetchBlockGroup) {
+    opt_.prefetchWatermark = 1;
+    spaceManager_.reset(new SpaceManagerImpl(opt_, mdsClient_, devClient_));
+
+    mds::space::BlockGroup group;
+    group.set_offset(0);
+    group.set_size(kBlockGroupSize);
+    group.set_available(kBlockGroupSize / 2);
+    group.set_bitmaplocation(curvefs::common::BitmapLocation::AtStart);
+
+    mds::space::BlockGroup group2(group);
+    group2.set_offset(kBlockGroupSize);
+
+    // the second block group is fetched in background, because available
+    // space is below one block group after the first allocation
+    std::atomic<int> fetched(0);
+    EXPECT_CALL(*mdsClient_, AllocateVolumeBlockGroup(_, _, _, _))
+        .WillOnce(Invoke(MockAllocateBlockGroup{group}))
+        .WillOnce(Invoke([&](uint32_t fsId, uint32_t count,
+                             const std::string& owner,
+                             std::vector<mds::space::BlockGroup>* groups) {
+            fetched.store(1);
+            return MockAllocateBlockGroup{group2}(fsId, count, owner, groups);
+        }));
+
+    EXPECT_CALL(*devClient_, Read(_, _, _))
+        .WillRepeatedly(Invoke(MockRead));
+
+    EXPECT_CALL(*devClient_, Write(_, _, _))
+        .WillRepeatedly(Invoke(MockWrite));
+
+    spaceManager_->Run();
+
+    std::vector<Extent> exts;
+    ASSERT_TRUE(spaceManager_->Alloc(kBlockSize, {}, &exts));
+    for (int i = 0; i < 100 && fetched.load() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1, fetched.load());
+
+    EXPECT_CALL(*mdsClient_, ReleaseVolumeBlockGroup(_, _, _))
+        .WillOnce(Return(SpaceErrCode::SpaceOk));
+    ASSERT_TRUE(spaceManager_->Shutdown());
+}
+
 }  // namespace volume
 }  // namespace curvefs
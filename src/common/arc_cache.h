@@ -26,6 +26,7 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <unordered_map>
@@ -71,7 +72,10 @@ class ARCCache : public LRUCacheInterface<K, V> {
 
         BMapVal() {}
         BMapVal(const BMapVal& o) { list_iter = o.list_iter; }
-        BMapVal& operator=(const BMapVal& o) { list_iter = o.list_iter; }
+        BMapVal& operator=(const BMapVal& o) {
+            list_iter = o.list_iter;
+            return *this;
+        }
         BMapVal(const blist_iter& iter)  // NOLINT
             : list_iter(iter) {}
     };
@@ -457,4 +461,259 @@ bool ARCCache<K, V, KeyTraits, ValueTraits>::GetLast(
     return false;
 }
 
+// SglARCCache is a scan-resistant replacement of SglLRUCache.
+//
+// Keys seen only once are kept in t1, keys seen at least twice are kept
+// in t2, the recently evicted keys of them are remembered by ghost list
+// b1 and b2 respectively. A hit in ghost list means the corresponding list
+// is too small, then the target size of t1 (p) is adapted accordingly.
+// A sequential scan only touches every key once, so it can only evict
+// the keys in t1, the working set in t2 survives.
+//
+// Like SglLRUCache, the cache doesn't evict keys if maxCount is 0,
+// the user gets the victim by GetBack() and evicts it by Remove().
+template <typename K, typename KeyTraits = CacheTraits<K>>
+class SglARCCache : public SglLRUCacheInterface<K> {
+ public:
+    explicit SglARCCache(uint64_t maxCount,
+                         std::shared_ptr<CacheMetrics> cacheMetrics = nullptr)
+        : maxCount_(maxCount), peak_(0), p_(0), cacheMetrics_(cacheMetrics) {}
+
+    void Put(const K& key) override;
+
+    bool IsCached(const K& key) override;
+
+    bool Touch(const K& key) override;
+
+    void Remove(const K& key) override;
+
+    bool GetBefore(const K key, K* keyNext) override;
+
+    bool GetBack(K* value) override;
+
+    bool MoveBack(const K& value) override;
+
+    uint64_t Size() override;
+
+    std::shared_ptr<CacheMetrics> GetCacheMetrics() const {
+        return cacheMetrics_;
+    }
+
+ private:
+    // front is MRU, back is LRU
+    struct List {
+        std::list<K> ll;
+        std::unordered_map<K, typename std::list<K>::iterator> map;
+
+        bool Contains(const K& key) const { return map.count(key) != 0; }
+
+        void PushFront(const K& key) {
+            ll.emplace_front(key);
+            map[key] = ll.begin();
+        }
+
+        bool Erase(const K& key) {
+            auto iter = map.find(key);
+            if (iter == map.end()) {
+                return false;
+            }
+            ll.erase(iter->second);
+            map.erase(iter);
+            return true;
+        }
+
+        void PopBack() {
+            map.erase(ll.back());
+            ll.pop_back();
+        }
+
+        uint64_t Size() const { return map.size(); }
+    };
+
+    // without limit, the most keys ever cached is regarded as capacity,
+    // so that the ghost lists are large enough to remember the evicted keys
+    uint64_t Capacity() const {
+        return maxCount_ != 0 ? maxCount_ : peak_;
+    }
+
+    // choose the list which the victim should be evicted from
+    List* Victim() {
+        if (t1_.Size() != 0 && (t1_.Size() > p_ || t2_.Size() == 0)) {
+            return &t1_;
+        }
+        return t2_.Size() != 0 ? &t2_ : nullptr;
+    }
+
+    void Evict(List* t, const K& key);
+
+    void TrimGhost();
+
+    void OnAdd(const K& key) {
+        if (cacheMetrics_ != nullptr) {
+            cacheMetrics_->UpdateAddToCacheCount();
+            cacheMetrics_->UpdateAddToCacheBytes(KeyTraits::CountBytes(key));
+        }
+    }
+
+    void OnRemove(const K& key) {
+        if (cacheMetrics_ != nullptr) {
+            cacheMetrics_->UpdateRemoveFromCacheCount();
+            cacheMetrics_->UpdateRemoveFromCacheBytes(
+                KeyTraits::CountBytes(key));
+        }
+    }
+
+ private:
+    ::curve::common::RWLock lock_;
+    // the maximum number of cached keys, 0 indicates unlimited
+    uint64_t maxCount_;
+    // the most keys ever cached
+    uint64_t peak_;
+    // target size of t1
+    uint64_t p_;
+    List t1_, t2_;
+    List b1_, b2_;
+    std::shared_ptr<CacheMetrics> cacheMetrics_;
+};
+
+template <typename K, typename KeyTraits>
+void SglARCCache<K, KeyTraits>::Put(const K& key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    if (t1_.Erase(key) || t2_.Erase(key)) {
+        t2_.PushFront(key);
+        return;
+    }
+
+    if (b1_.Contains(key)) {
+        // t1 is too small
+        uint64_t delta = std::max<uint64_t>(1, b2_.Size() / b1_.Size());
+        p_ = std::min(p_ + delta, Capacity());
+        b1_.Erase(key);
+        t2_.PushFront(key);
+    } else if (b2_.Contains(key)) {
+        // t2 is too small
+        uint64_t delta = std::max<uint64_t>(1, b1_.Size() / b2_.Size());
+        p_ = p_ > delta ? p_ - delta : 0;
+        b2_.Erase(key);
+        t2_.PushFront(key);
+    } else {
+        t1_.PushFront(key);
+    }
+    OnAdd(key);
+    peak_ = std::max(peak_, t1_.Size() + t2_.Size());
+
+    if (maxCount_ != 0 && t1_.Size() + t2_.Size() > maxCount_) {
+        List* t = Victim();
+        Evict(t, t->ll.back());
+    }
+    TrimGhost();
+}
+
+template <typename K, typename KeyTraits>
+bool SglARCCache<K, KeyTraits>::IsCached(const K& key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    if (t1_.Erase(key) || t2_.Erase(key)) {
+        t2_.PushFront(key);
+        if (cacheMetrics_ != nullptr) {
+            cacheMetrics_->OnCacheHit();
+        }
+        return true;
+    }
+
+    if (cacheMetrics_ != nullptr) {
+        cacheMetrics_->OnCacheMiss();
+    }
+    return false;
+}
+
+template <typename K, typename KeyTraits>
+bool SglARCCache<K, KeyTraits>::Touch(const K& key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    if (t1_.Erase(key) || t2_.Erase(key)) {
+        t2_.PushFront(key);
+        return true;
+    }
+    return false;
+}
+
+template <typename K, typename KeyTraits>
+void SglARCCache<K, KeyTraits>::Remove(const K& key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    if (t1_.Contains(key)) {
+        Evict(&t1_, key);
+    } else if (t2_.Contains(key)) {
+        Evict(&t2_, key);
+    }
+    TrimGhost();
+}
+
+template <typename K, typename KeyTraits>
+bool SglARCCache<K, KeyTraits>::GetBefore(const K key, K* keyNext) {
+    ::curve::common::ReadLockGuard guard(lock_);
+    List* ts[]{&t1_, &t2_};
+    for (auto t : ts) {
+        auto iter = t->map.find(key);
+        if (iter == t->map.end()) {
+            continue;
+        } else if (iter->second == t->ll.begin()) {
+            return false;
+        }
+        *keyNext = *std::prev(iter->second);
+        return true;
+    }
+    return false;
+}
+
+template <typename K, typename KeyTraits>
+bool SglARCCache<K, KeyTraits>::GetBack(K* value) {
+    ::curve::common::ReadLockGuard guard(lock_);
+    List* t = Victim();
+    if (t == nullptr) {
+        return false;
+    }
+    *value = t->ll.back();
+    return true;
+}
+
+template <typename K, typename KeyTraits>
+bool SglARCCache<K, KeyTraits>::MoveBack(const K& key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    List* ts[]{&t1_, &t2_};
+    for (auto t : ts) {
+        auto iter = t->map.find(key);
+        if (iter != t->map.end()) {
+            t->ll.splice(t->ll.end(), t->ll, iter->second);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename K, typename KeyTraits>
+uint64_t SglARCCache<K, KeyTraits>::Size() {
+    ::curve::common::ReadLockGuard guard(lock_);
+    return t1_.Size() + t2_.Size();
+}
+
+template <typename K, typename KeyTraits>
+void SglARCCache<K, KeyTraits>::Evict(List* t, const K& key) {
+    OnRemove(key);
+    List* b = (t == &t1_) ? &b1_ : &b2_;
+    b->PushFront(key);
+    t->Erase(key);
+}
+
+template <typename K, typename KeyTraits>
+void SglARCCache<K, KeyTraits>::TrimGhost() {
+    // |t1| + |b1| <= c and |t1| + |t2| + |b1| + |b2| <= 2c
+    uint64_t c = Capacity();
+    while (b1_.Size() != 0 && t1_.Size() + b1_.Size() > c) {
+        b1_.PopBack();
+    }
+    while (b2_.Size() != 0 &&
+           t1_.Size() + t2_.Size() + b1_.Size() + b2_.Size() > 2 * c) {
+        b2_.PopBack();
+    }
+}
+
 #endif  // SRC_COMMON_ARC_CACHE_H_
@@ -595,6 +595,14 @@ class SglLRUCacheInterface {
      */
     virtual bool IsCached(const K &key) = 0;
 
+    /**
+     * @brief mark the key as used again without counting a cache hit,
+     *        if it has been stored, then move it to list front
+     * @param[in] key
+     * @return whether the key has been stored in cache
+     */
+    virtual bool Touch(const K &key) = 0;
+
     virtual bool GetBefore(const K key, K *keyNext) = 0;
 
     /*
@@ -640,6 +648,8 @@ class SglLRUCache : public SglLRUCacheInterface<K> {
 
     bool IsCached(const K &key) override;
 
+    bool Touch(const K &key) override;
+
     void Remove(const K &key) override;
     bool GetBefore(const K key, K *keyNext) override;
     bool GetBack(K *value) override;
@@ -764,6 +774,17 @@ bool SglLRUCache<K, KeyTraits>::IsCached(const K &key) {
     return true;
 }
 
+template <typename K, typename KeyTraits>
+bool SglLRUCache<K, KeyTraits>::Touch(const K &key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    auto iter = cache_.find(key);
+    if (iter == cache_.end()) {
+        return false;
+    }
+    MoveToFront(iter->second);
+    return true;
+}
+
 template <typename K, typename KeyTraits>
 void SglLRUCache<K, KeyTraits>::Remove(const K &key) {
     ::curve::common::WriteLockGuard guard(lock_);
@@ -302,6 +302,23 @@ TEST(SglCaCheTest, TestCacheHitAndMissMetric) {
     ASSERT_EQ(10, cache->GetCacheMetrics()->cacheMiss.get_value());
 }
 
+TEST(SglCaCheTest, TestTouch) {
+    auto cache = std::make_shared<SglLRUCache<int>>(
+        std::make_shared<CacheMetrics>("LruCache"));
+    for (int i = 1; i <= 3; ++i) {
+        cache->Put(i);
+    }
+
+    // touch moves the key to front without counting a hit
+    int key;
+    ASSERT_TRUE(cache->Touch(1));
+    ASSERT_FALSE(cache->Touch(4));
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(2, key);
+    ASSERT_EQ(0, cache->GetCacheMetrics()->cacheHit.get_value());
+    ASSERT_EQ(0, cache->GetCacheMetrics()->cacheMiss.get_value());
+}
+
 TEST(TimedCaCheTest, test_base) {
     int maxCount = 5;
     int timeOutSec = 0;
@@ -353,7 +370,108 @@ TEST(TimedCaCheTest, test_timeout) {
     ASSERT_EQ(0, cache->Size());
 }
 
-}  // namespace common
-}  // namespace curve
+TEST(SglARCCacheTest, TestScanResistant) {
+    int maxCount = 4;
+    auto cache = std::make_shared<SglARCCache<std::string>>(maxCount,
+        std::make_shared<CacheMetrics>("ArcCache"));
+
+    // 1. hot keys are accessed twice, so they are moved to t2
+    cache->Put("hot1");
+    cache->Put("hot2");
+    ASSERT_TRUE(cache->IsCached("hot1"));
+    ASSERT_TRUE(cache->IsCached("hot2"));
+
+    // 2. scan only evicts the keys seen once
+    for (int i = 0; i < 100; i++) {
+        cache->Put("scan" + std::to_string(i));
+        ASSERT_LE(cache->Size(), maxCount);
+    }
+    ASSERT_EQ(maxCount, cache->Size());
+    ASSERT_EQ(maxCount, cache->GetCacheMetrics()->cacheCount.get_value());
+    ASSERT_TRUE(cache->IsCached("hot1"));
+    ASSERT_TRUE(cache->IsCached("hot2"));
+    ASSERT_TRUE(cache->IsCached("scan99"));
+    ASSERT_FALSE(cache->IsCached("scan0"));
+}
+
+TEST(SglARCCacheTest, TestGetBackAndRemove) {
+    auto cache = std::make_shared<SglARCCache<int>>(0,
+        std::make_shared<CacheMetrics>("ArcCache"));
+
+    for (int i = 1; i <= 5; ++i) {
+        cache->Put(i);
+    }
+    ASSERT_TRUE(cache->IsCached(1));
+    ASSERT_EQ(5, cache->Size());
+
+    // 1. victim is the LRU key of t1, and key 1 is in t2
+    int key;
+    for (int i = 2; i <= 5; ++i) {
+        ASSERT_TRUE(cache->GetBack(&key));
+        ASSERT_EQ(i, key);
+        cache->Remove(key);
+        ASSERT_FALSE(cache->IsCached(key));
+    }
+
+    // 2. t1 is empty, evict from t2
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(1, key);
+
+    // 3. evicted key is put again, it is remembered by ghost list
+    //    and regarded as frequently used, the hit in b1 also enlarges
+    //    the target size of t1, so the victim comes from t2
+    cache->Put(2);
+    cache->Put(6);
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(1, key);
+    cache->Remove(1);
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(2, key);
+    cache->Remove(2);
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(6, key);
+    cache->Remove(6);
+    ASSERT_FALSE(cache->GetBack(&key));
+    ASSERT_EQ(0, cache->Size());
+    ASSERT_EQ(0, cache->GetCacheMetrics()->cacheCount.get_value());
+}
+
+TEST(SglARCCacheTest, TestTouch) {
+    auto cache = std::make_shared<SglARCCache<int>>(0,
+        std::make_shared<CacheMetrics>("ArcCache"));
+    cache->Put(1);
+    cache->Put(2);
+
+    // touched key is moved to t2 without counting a hit, so the victim
+    // comes from t1
+    int key;
+    ASSERT_TRUE(cache->Touch(1));
+    ASSERT_FALSE(cache->Touch(3));
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(2, key);
+    ASSERT_EQ(0, cache->GetCacheMetrics()->cacheHit.get_value());
+    ASSERT_EQ(0, cache->GetCacheMetrics()->cacheMiss.get_value());
+}
+
+TEST(SglARCCacheTest, TestGetBeforeAndMoveBack) {
+    auto cache = std::make_shared<SglARCCache<int>>(0);
+
+    for (int i = 1; i <= 5; ++i) {
+        cache->Put(i);
+    }
+    int keyBefore;
+    for (int i = 1; i < 5; ++i) {
+        ASSERT_TRUE(cache->GetBefore(i, &keyBefore));
+        ASSERT_EQ(i + 1, keyBefore);
+    }
+    ASSERT_FALSE(cache->GetBefore(5, &keyBefore));
 
+    int key;
+    ASSERT_TRUE(cache->MoveBack(5));
+    ASSERT_TRUE(cache->GetBack(&key));
+    ASSERT_EQ(5, key);
+    ASSERT_FALSE(cache->MoveBack(100));
+}
 
+}  // namespace common
+}  // namespace curve